@@ -77,6 +77,35 @@ std::unique_ptr<te::da::DataSource> GetPostGISConnection()
   return ds;
 }
 
+// It streams a dataset through a server-side cursor and checks it against the materialized traversal
+static void StreamingDataSet(te::da::DataSource* ds, const std::string& datasetName)
+{
+  std::size_t nrandom = 0;
+  std::auto_ptr<te::da::DataSet> materialized = ds->getDataSet(datasetName, te::common::RANDOM);
+  while(materialized->moveNext())
+    ++nrandom;
+  materialized.reset();
+
+// the PG_CURSOR_FETCH_SIZE parameter enables the cursors for FORWARDONLY datasets
+  std::string strURI = ds->getConnectionInfo().uri();
+  strURI += ds->getConnectionInfo().query().empty() ? "?" : "&";
+  strURI += "PG_CURSOR_FETCH_SIZE=256";
+
+  std::unique_ptr<te::da::DataSource> cds = te::da::DataSourceFactory::make("POSTGIS", strURI);
+  cds->open();
+
+  std::size_t nstreamed = 0;
+  std::auto_ptr<te::da::DataSet> streamed = cds->getDataSet(datasetName, te::common::FORWARDONLY);
+  while(streamed->moveNext())
+    ++nstreamed;
+  streamed.reset();
+
+  cds->close();
+
+  std::cout << "\nDataset " << datasetName << ": " << nrandom << " materialized row(s), "
+            << nstreamed << " streamed row(s)" << (nrandom == nstreamed ? " - OK" : " - MISMATCH") << std::endl;
+}
+
 void PostGISExample()
 {
   try
@@ -119,6 +148,9 @@ void PostGISExample()
       PrintDataSet(dsets[n-1], ds->getDataSet(dsets[n-1]).get());
     }
 
+// shows how to stream a dataset with a forward-only traversal
+    StreamingDataSet(ds.get(), dsets[0]);
+
 // shows how to use a spatial filter
     std::vector<std::string>::iterator it;
     it = std::find(dsets.begin(),dsets.end(),"public.munic_2001");
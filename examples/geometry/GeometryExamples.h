@@ -168,6 +168,11 @@ te::gm::Geometry* Union(te::gm::Geometry* g1, te::gm::Geometry* g2);
  */
 void readWkts(const std::string& filePath);
 
+/*
+  \brief It compares the time spent decoding a set of Wkb polygons with WKBReader and with a reused WKBView.
+ */
+void wkbViewBenchmark();
+
 //@}
 
 #endif  // __TERRALIB_EXAMPLES_GEOMETRY_INTERNAL_GEOMETRYEXAMPLES_H
@@ -0,0 +1,75 @@
+// Examples
+#include "GeometryExamples.h"
+
+// STL
+#include <cmath>
+#include <cstddef>
+#include <ctime>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+void wkbViewBenchmark()
+{
+  std::cout << "Decoding Wkb with WKBReader and WKBView..." << std::endl;
+
+  const std::size_t ngeoms = 20000;
+  const std::size_t npts = 200;
+
+// create a set of polygons in Wkb, like the rows of a layer being drawn
+  std::vector<std::vector<char> > wkbs(ngeoms);
+
+  for(std::size_t i = 0; i < ngeoms; ++i)
+  {
+    const double xc = static_cast<double>(i % 200) * 10.0;
+    const double yc = static_cast<double>(i / 200) * 10.0;
+
+    te::gm::LinearRing* ring = new te::gm::LinearRing(npts + 1, te::gm::LineStringType);
+
+    for(std::size_t j = 0; j < npts; ++j)
+    {
+      const double a = 6.283185307179586 * static_cast<double>(j) / static_cast<double>(npts);
+      ring->setPoint(j, xc + 4.0 * std::cos(a), yc + 4.0 * std::sin(a));
+    }
+
+    ring->setPoint(npts, ring->getX(0), ring->getY(0));
+
+    te::gm::Polygon poly(0, te::gm::PolygonType);
+    poly.push_back(ring);
+
+    wkbs[i].resize(poly.getWkbSize());
+    te::gm::WKBWriter::write(&poly, &wkbs[i][0]);
+  }
+
+// decode building a geometry for each Wkb
+  std::clock_t start = std::clock();
+
+  double readerArea = 0.0;
+
+  for(std::size_t i = 0; i < ngeoms; ++i)
+  {
+    std::auto_ptr<te::gm::Geometry> g(te::gm::WKBReader::read(&wkbs[i][0]));
+    readerArea += g->getMBR()->getArea();
+  }
+
+  double readerTime = static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+
+// decode reusing the same view
+  te::gm::WKBView view;
+
+  start = std::clock();
+
+  double viewArea = 0.0;
+
+  for(std::size_t i = 0; i < ngeoms; ++i)
+  {
+    view.read(&wkbs[i][0]);
+    viewArea += view.getMBR().getArea();
+  }
+
+  double viewTime = static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+
+  std::cout << "WKBReader: " << readerTime << "s" << std::endl;
+  std::cout << "WKBView:   " << viewTime << "s" << std::endl;
+  std::cout << "Same extents: " << (readerArea == viewArea ? "yes" : "no") << std::endl;
+}
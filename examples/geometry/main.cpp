@@ -250,6 +250,7 @@ int main(int /*argc*/, char** /*argv*/)
   setOperationsExamples();
   wkbConversionExamples();
   readWkts("./geometries.wkt");
+  wkbViewBenchmark();
   //readWkts("./wkt_geom.txt");
 
   deleteGeometries();
@@ -0,0 +1,201 @@
+// Examples
+#include "GraphExamples.h"
+
+// TerraLib
+#include <terralib/graph/cache/AbstractCachePolicy.h>
+#include <terralib/graph/cache/FIFOCachePolicy.h>
+#include <terralib/graph/cache/LRUCachePolicy.h>
+#include <terralib/graph/core/GraphCache.h>
+#include <terralib/graph/core/GraphData.h>
+#include <terralib/graph/core/GraphMetadata.h>
+#include <terralib/graph/core/Vertex.h>
+#include <terralib/graph/graphs/Graph.h>
+#include <terralib/graph/loader/AbstractGraphLoaderStrategy.h>
+
+// STL
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <string>
+
+// Boost
+#include <boost/bind.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/thread/thread.hpp>
+
+namespace
+{
+  /*
+    A loader strategy for a side x side grid of vertices, with an edge to the right
+    and an edge down from each vertex. It loads a sequence of vertices by id and it
+    simulates the latency of a data source in each load and in each save.
+  */
+  class GridLoaderStrategy : public te::graph::AbstractGraphLoaderStrategy
+  {
+    public:
+
+      GridLoaderStrategy(te::graph::GraphMetadata* metadata, int side, int latency)
+        : te::graph::AbstractGraphLoaderStrategy(metadata),
+          m_side(side),
+          m_latency(latency),
+          m_loads(0),
+          m_saves(0)
+      {
+      }
+
+      void loadDataByVertexId(int vertexId, te::graph::AbstractGraph* g, te::graph::GraphCache* gc)
+      {
+        std::auto_ptr<te::graph::GraphData> data(takePrefetchedVertex(vertexId, gc));
+
+        if(data.get() == 0)
+        {
+          data.reset(new te::graph::GraphData(-1));
+
+          loadVertices(vertexId, data.get());
+        }
+
+        if(data->getVertexMap().empty())
+          return;
+
+        int nextId = data->getVertexMap().rbegin()->first + 1;
+
+        addData(data.get(), g, gc);
+
+        prefetch(gc, boost::bind(&GridLoaderStrategy::loadVertices, this, nextId, _1));
+      }
+
+      void loadDataByEdgeId(int /*edgeId*/, te::graph::AbstractGraph* /*g*/, te::graph::GraphCache* /*gc*/)
+      {
+      }
+
+      void saveData(te::graph::GraphData* /*data*/)
+      {
+        boost::this_thread::sleep(boost::posix_time::microseconds(m_latency));
+
+        ++m_saves;
+      }
+
+      void loadVertices(int vertexId, te::graph::GraphData* data)
+      {
+        boost::this_thread::sleep(boost::posix_time::microseconds(m_latency));
+
+        ++m_loads;
+
+        int last = std::min(vertexId + static_cast<int>(m_graphMetadata->m_maxCacheSize), m_side * m_side) - 1;
+
+        for(int id = vertexId; id <= last; ++id)
+        {
+          te::graph::Vertex* v = new te::graph::Vertex(id, false);
+
+          if((id % m_side) + 1 < m_side)
+            v->getSuccessors().insert(2 * id);
+
+          if(id + m_side < m_side * m_side)
+            v->getSuccessors().insert(2 * id + 1);
+
+          data->addVertex(v);
+        }
+      }
+
+      std::size_t getLoads() const { return m_loads; }
+
+      std::size_t getSaves() const { return m_saves; }
+
+    private:
+
+      int m_side;
+      int m_latency;
+      std::size_t m_loads;
+      std::size_t m_saves;
+  };
+
+  double Elapsed(const boost::posix_time::ptime& start)
+  {
+    return static_cast<double>((boost::posix_time::microsec_clock::local_time() - start).total_microseconds()) / 1000000.0;
+  }
+
+  /*
+    It visits the vertices by id and, from each one, its right and down neighbours,
+    marking them as changed. The work is a small computation for each visit.
+  */
+  void Traverse(const std::string& name, te::graph::AbstractCachePolicy* policy, std::size_t maxVecCacheSize,
+                std::size_t maxCacheMemory, bool asyncCache)
+  {
+    const int side = 400;
+    const std::size_t partitionSize = 1000;
+    const int latency = 2000;
+
+    te::graph::GraphMetadata* metadata = new te::graph::GraphMetadata(0);
+    metadata->m_maxCacheSize = partitionSize;
+    metadata->m_maxVecCacheSize = maxVecCacheSize;
+    metadata->m_maxCacheMemory = maxCacheMemory;
+    metadata->m_asyncCache = asyncCache;
+
+    GridLoaderStrategy* loader = new GridLoaderStrategy(metadata, side, latency);
+
+    std::size_t visits = 0;
+    std::size_t missing = 0;
+    double work = 0.;
+
+    boost::posix_time::ptime start = boost::posix_time::microsec_clock::local_time();
+
+    {
+      te::graph::Graph graph(policy, loader);
+
+      for(int id = 0; id < side * side; ++id)
+      {
+        int neighbours[3] = { id, (id % side) + 1 < side ? id + 1 : -1, id + side < side * side ? id + side : -1 };
+
+        for(int i = 0; i < 3; ++i)
+        {
+          if(neighbours[i] == -1)
+            continue;
+
+          te::graph::Vertex* v = graph.getVertex(neighbours[i]);
+
+          if(v == 0)
+          {
+            ++missing;
+            continue;
+          }
+
+          graph.update(v);
+
+          for(int k = 0; k < 200; ++k)
+            work += 1. / static_cast<double>(neighbours[i] + k + 1);
+
+          ++visits;
+        }
+      }
+
+      graph.flush();
+
+      std::cout << "  " << name << ": " << Elapsed(start) << " s, "
+                << loader->getLoads() << " loads, " << loader->getSaves() << " saves, "
+                << visits << " visits";
+
+      if(missing)
+        std::cout << ", " << missing << " MISSING";
+
+      std::cout << std::endl;
+    }
+
+    if(work < 0.)
+      std::cout << work << std::endl;
+  }
+}
+
+void GraphCacheBenchmark()
+{
+  std::cout << "Traversing a paged graph with 400 x 400 vertices, 1000 vertices per graph data and 2 ms of data source latency..." << std::endl;
+
+  // about 330 KB for each graph data
+  const std::size_t maxCacheMemory = 3 * 1024 * 1024;
+
+  Traverse("FIFO, 8 graph data", new te::graph::FIFOCachePolicy, 8, 0, false);
+
+  Traverse("LRU, 3 MB", new te::graph::LRUCachePolicy, 1000, maxCacheMemory, false);
+
+  Traverse("LRU, 3 MB, write back and prefetch in background", new te::graph::LRUCachePolicy, 1000, maxCacheMemory, true);
+}
@@ -47,6 +47,9 @@ void CreateLDDGraph(bool draw);
 /*! \brief Creates a MST GRAPH. */
 void CreateMSTGraph(bool draw);
 
+/*! \brief Compares the traversal of a paged graph with a count bounded FIFO cache and with a memory bounded LRU cache, with and without the background write back and prefetch. */
+void GraphCacheBenchmark();
+
 /*! \brief Auxiliar functions for load a raster. */
 std::auto_ptr<te::rst::Raster> OpenRaster(const std::string& pathName, const int& srid);
 
@@ -31,6 +31,9 @@ int main()
     //load all necessary modules
     LoadModules();
 
+    //-----------------------------------------------------------------------------------------------------
+    GraphCacheBenchmark();
+
     //-----------------------------------------------------------------------------------------------------
     bool draw = true;
 
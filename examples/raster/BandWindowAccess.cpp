@@ -0,0 +1,188 @@
+#include "RasterExamples.h"
+
+// TerraLib
+#include <terralib/memory.h>
+#include <terralib/raster.h>
+#include <terralib/raster/RasterFactory.h>
+
+// STL
+#include <algorithm>
+#include <complex>
+#include <ctime>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <vector>
+
+/*! \brief It computes the band mean as the cell access implementation of te::rst::Band::getMeanValue did. */
+std::complex<double> MeanByCell(const te::rst::Band& band)
+{
+  const unsigned int nrows = band.getRaster()->getNumberOfRows();
+  const unsigned int ncols = band.getRaster()->getNumberOfColumns();
+
+  std::complex<double> pixel;
+  std::complex<double> sum(0.0, 0.0);
+
+  for(unsigned int r = 0; r < nrows; ++r)
+    for(unsigned int c = 0; c < ncols; ++c)
+    {
+      band.getValue(c, r, pixel);
+      sum += pixel;
+    }
+
+  const double n = static_cast<double>(nrows) * ncols;
+
+  return std::complex<double>(sum.real() / n, sum.imag() / n);
+}
+
+/*! \brief It computes a histogram with b bins as the cell access implementation of te::rst::Band::getHistogramR did. */
+std::map<double, unsigned> HistogramByCell(const te::rst::Band& band, unsigned int b)
+{
+  const unsigned int nrows = band.getRaster()->getNumberOfRows();
+  const unsigned int ncols = band.getRaster()->getNumberOfColumns();
+
+  double pixel = 0.0;
+  double pmin = std::numeric_limits<double>::max();
+  double pmax = -1.0 * std::numeric_limits<double>::max();
+
+  for(unsigned int r = 0; r < nrows; ++r)
+    for(unsigned int c = 0; c < ncols; ++c)
+    {
+      band.getValue(c, r, pixel);
+
+      if(pixel > pmax)
+        pmax = pixel;
+
+      if(pixel < pmin)
+        pmin = pixel;
+    }
+
+  const double delta = (pmax * 1.000001 - pmin) / b;
+
+  std::map<double, unsigned> hist;
+  std::map<std::size_t, double> binsLocations;
+  std::size_t location = 0;
+
+  for(double bins = pmin; bins < pmax; bins += delta)
+  {
+    hist[bins] = 0;
+    binsLocations[location++] = bins;
+  }
+
+  for(unsigned int r = 0; r < nrows; ++r)
+    for(unsigned int c = 0; c < ncols; ++c)
+    {
+      band.getValue(c, r, pixel);
+
+      location = (std::size_t) ((pixel - pmin) / delta);
+
+      hist[binsLocations[location]]++;
+    }
+
+  return hist;
+}
+
+/*! \brief It copies the band values to a buffer reading one cell at a time. */
+void CopyByCell(const te::rst::Band& band, std::vector<double>& values)
+{
+  const unsigned int nrows = band.getRaster()->getNumberOfRows();
+  const unsigned int ncols = band.getRaster()->getNumberOfColumns();
+
+  std::size_t i = 0;
+
+  for(unsigned int r = 0; r < nrows; ++r)
+    for(unsigned int c = 0; c < ncols; ++c)
+      band.getValue(c, r, values[i++]);
+}
+
+/*! \brief It copies the band values to a buffer reading a window of rows at a time. */
+void CopyByWindow(const te::rst::Band& band, std::vector<double>& values)
+{
+  const unsigned int nrows = band.getRaster()->getNumberOfRows();
+  const unsigned int ncols = band.getRaster()->getNumberOfColumns();
+  const unsigned int wrows = 16;
+
+  for(unsigned int r = 0; r < nrows; r += wrows)
+    band.getValues(0, r, ncols, std::min(wrows, nrows - r), &values[r * ncols]);
+}
+
+void BandWindowAccess()
+{
+  try
+  {
+    std::cout << "This test compares the cell and window access to raster bands." << std::endl << std::endl;
+
+    const unsigned int nrows = 4000;
+    const unsigned int ncols = 4000;
+
+    std::vector<te::rst::BandProperty*> bprops;
+    bprops.push_back(new te::rst::BandProperty(0, te::dt::UCHAR_TYPE));
+
+    std::auto_ptr<te::rst::Raster> raster(te::rst::RasterFactory::make("MEM", new te::rst::Grid(ncols, nrows), bprops, std::map<std::string, std::string>(), 0, 0));
+
+// fill the band a row at a time
+    std::vector<double> row(ncols);
+
+    for(unsigned int r = 0; r < nrows; ++r)
+    {
+      for(unsigned int c = 0; c < ncols; ++c)
+        row[c] = static_cast<double>((r + c) % 256);
+
+      raster->getBand(0)->setValues(0, r, ncols, 1, &row[0]);
+    }
+
+    te::mem::CachedRaster cached(*raster, 10, 0);
+
+    const te::rst::Band* bands[] = { raster->getBand(0), cached.getBand(0) };
+    const char* names[] = { "in-memory band", "cached band" };
+
+    std::vector<double> values(nrows * ncols);
+
+    for(int b = 0; b < 2; ++b)
+    {
+      std::clock_t start = std::clock();
+      CopyByCell(*bands[b], values);
+      double cellCopyTime = static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+
+      start = std::clock();
+      CopyByWindow(*bands[b], values);
+      double windowCopyTime = static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+
+      start = std::clock();
+      std::complex<double> cellMean = MeanByCell(*bands[b]);
+      double cellMeanTime = static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+
+      start = std::clock();
+      std::complex<double> windowMean = bands[b]->getMeanValue();
+      double windowMeanTime = static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+
+      start = std::clock();
+      std::map<double, unsigned> cellHist = HistogramByCell(*bands[b], 16);
+      double cellHistTime = static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+
+      start = std::clock();
+      std::map<double, unsigned> windowHist = bands[b]->getHistogramR(0, 0, 0, 0, 16);
+      double windowHistTime = static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+
+      const double mpixels = static_cast<double>(nrows) * ncols / 1000000.0;
+
+      std::cout << names[b] << " (Mpixels/s, cell access x window access):" << std::endl;
+      std::cout << "   copy: " << mpixels / cellCopyTime << " x " << mpixels / windowCopyTime << std::endl;
+      std::cout << "   mean: " << mpixels / cellMeanTime << " x " << mpixels / windowMeanTime
+                << " (" << cellMean.real() << " x " << windowMean.real() << ")" << std::endl;
+      std::cout << "   16 bins histogram: " << mpixels / cellHistTime << " x " << mpixels / windowHistTime
+                << " (" << cellHist.size() << " x " << windowHist.size() << " bins)" << std::endl;
+    }
+
+    std::cout << "Done!" << std::endl << std::endl;
+  }
+  catch(const std::exception& e)
+  {
+    std::cout << std::endl << "An exception has occurred in BandWindowAccess(): " << e.what() << std::endl;
+  }
+  catch(...)
+  {
+    std::cout << std::endl << "An unexpected exception has occurred in BandWindowAccess()!" << std::endl;
+  }
+}
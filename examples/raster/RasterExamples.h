@@ -76,4 +76,7 @@ void Raster1Bit();
 /*! \brief This example shows how to use the vectorization method. */
 void VectorizeRaster();
 
+/*! \brief It compares the throughput of the cell and window access to raster bands. */
+void BandWindowAccess();
+
 #endif
@@ -36,6 +36,7 @@ int main()
     // GribPolygonExample();
     Raster1Bit();
     VectorizeRaster();
+    BandWindowAccess();
 
     te::core::PluginManager::instance().clear();
     te::core::plugin::FinalizePluginSystem();
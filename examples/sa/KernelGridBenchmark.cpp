@@ -0,0 +1,129 @@
+// Examples
+#include "SAExamples.h"
+
+// TerraLib
+#include <terralib/geometry/Envelope.h>
+#include <terralib/geometry/Point.h>
+#include <terralib/raster/Grid.h>
+#include <terralib/sa/core/KernelFunctions.h>
+#include <terralib/sa/core/KernelGridEstimator.h>
+
+// STL
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+// Boost
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/normal_distribution.hpp>
+#include <boost/random/uniform_real_distribution.hpp>
+
+namespace
+{
+  double Elapsed(const boost::posix_time::ptime& start)
+  {
+    return static_cast<double>((boost::posix_time::microsec_clock::local_time() - start).total_microseconds()) / 1000000.0;
+  }
+
+  // The largest difference between two kernels, relative to the largest value of the first one.
+  double MaxRelativeDifference(const std::vector<double>& reference, const std::vector<double>& values)
+  {
+    double maxValue = 0.;
+    double maxDifference = 0.;
+
+    for(std::size_t i = 0; i < reference.size(); ++i)
+    {
+      maxValue = std::max(maxValue, std::fabs(reference[i]));
+      maxDifference = std::max(maxDifference, std::fabs(reference[i] - values[i]));
+    }
+
+    return maxValue > 0. ? maxDifference / maxValue : 0.;
+  }
+}
+
+void KernelGridBenchmark()
+{
+  std::cout << "Computing the kernel of a grid..." << std::endl;
+
+  const std::size_t eventsNumber = 5000;
+  const double side = 2000.;
+  const double resolution = 10.;
+  const double radius = 30.;
+
+// clustered events from a fixed seed
+  boost::random::mt19937 gen(42);
+  boost::random::uniform_real_distribution<> position(0., side);
+  boost::random::normal_distribution<> spread(0., 50.);
+
+  te::sa::KernelMap kMap;
+
+  for(std::size_t i = 0; i < eventsNumber; ++i)
+  {
+    double x = position(gen);
+    double y = position(gen);
+
+    if(i % 2)
+    {
+      x = std::min(std::max(side / 3. + spread(gen), 0.), side);
+      y = std::min(std::max(side / 2. + spread(gen), 0.), side);
+    }
+
+    kMap[static_cast<int>(i)] = std::pair<te::gm::Geometry*, double>(new te::gm::Point(x, y), 1.);
+  }
+
+  te::rst::Grid grid(resolution, resolution, new te::gm::Envelope(0., 0., side, side));
+
+  te::sa::KernelInputParams params;
+  params.m_functionType = te::sa::Normal;
+
+// the reference: all events for each cell, one thread
+  params.m_tolerance = 0.;
+  params.m_maxThreads = 1;
+
+  te::sa::KernelGridEstimator referenceEstimator(params, kMap, grid);
+
+  std::vector<double> reference;
+
+  boost::posix_time::ptime start = boost::posix_time::microsec_clock::local_time();
+
+  referenceEstimator.cellKernel(radius, reference);
+
+  double referenceTime = Elapsed(start);
+
+// the truncated kernel, in a pool of threads
+  params.m_tolerance = 1.e-6;
+  params.m_maxThreads = 0;
+
+  te::sa::KernelGridEstimator estimator(params, kMap, grid);
+
+  std::vector<double> cells;
+
+  start = boost::posix_time::microsec_clock::local_time();
+
+  estimator.cellKernel(radius, cells);
+
+  double cellsTime = Elapsed(start);
+
+  std::vector<double> convolution;
+
+  start = boost::posix_time::microsec_clock::local_time();
+
+  estimator.convolutionKernel(radius, convolution);
+
+  double convolutionTime = Elapsed(start);
+
+  std::cout << "  " << grid.getNumberOfColumns() << " x " << grid.getNumberOfRows() << " cells, "
+            << eventsNumber << " events, Normal kernel of radius " << radius << std::endl;
+  std::cout << "  Truncation distance: " << te::sa::KernelSupport(te::sa::Normal, radius, params.m_tolerance) << std::endl;
+  std::cout << "  All events (s): " << referenceTime << std::endl;
+  std::cout << "  Truncated cells, threads (s): " << cellsTime
+            << ", max relative difference: " << MaxRelativeDifference(reference, cells) << std::endl;
+  std::cout << "  Grid convolution, threads (s): " << convolutionTime
+            << ", max relative difference: " << MaxRelativeDifference(reference, convolution) << std::endl;
+
+  for(te::sa::KernelMap::iterator it = kMap.begin(); it != kMap.end(); ++it)
+    delete it->second.first;
+}
@@ -0,0 +1,177 @@
+// Examples
+#include "SAExamples.h"
+
+// TerraLib
+#include <terralib/sa/core/PermutationTest.h>
+#include <terralib/sa/core/SpatialWeightsMatrix.h>
+
+// STL
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+// Boost
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/normal_distribution.hpp>
+
+namespace
+{
+  // It creates the row standardized rook contiguity weights of a grid of side x side cells.
+  void CreateGridWeights(te::sa::SpatialWeightsMatrix& swm, std::size_t side)
+  {
+    std::vector<std::size_t> offsets(1, 0);
+    std::vector<std::size_t> neighbours;
+    std::vector<double> weights;
+
+    for(std::size_t r = 0; r < side; ++r)
+    {
+      for(std::size_t c = 0; c < side; ++c)
+      {
+        std::size_t first = neighbours.size();
+
+        if(r > 0)
+          neighbours.push_back((r - 1) * side + c);
+
+        if(r + 1 < side)
+          neighbours.push_back((r + 1) * side + c);
+
+        if(c > 0)
+          neighbours.push_back(r * side + c - 1);
+
+        if(c + 1 < side)
+          neighbours.push_back(r * side + c + 1);
+
+        std::size_t nNeighbours = neighbours.size() - first;
+
+        weights.insert(weights.end(), nNeighbours, 1.0 / static_cast<double>(nNeighbours));
+
+        offsets.push_back(neighbours.size());
+      }
+    }
+
+    swm.build(offsets, neighbours, weights);
+  }
+
+  double Elapsed(const boost::posix_time::ptime& start)
+  {
+    return static_cast<double>((boost::posix_time::microsec_clock::local_time() - start).total_microseconds()) / 1000000.0;
+  }
+}
+
+void PermutationTestBenchmark()
+{
+  std::cout << "Computing the Moran and LISA permutation tests..." << std::endl;
+
+  const std::size_t side = 200;
+  const std::size_t n = side * side;
+  const int permutationsNumber = 999;
+
+  te::sa::SpatialWeightsMatrix swm;
+
+  CreateGridWeights(swm, side);
+
+// a smooth surface with noise, from a fixed seed: it has a strong positive autocorrelation
+  std::vector<double> values(n);
+
+  boost::random::mt19937 gen(42);
+  boost::random::normal_distribution<> noise;
+
+  for(std::size_t i = 0; i < n; ++i)
+    values[i] = std::sin(static_cast<double>(i / side) * 0.1) + std::cos(static_cast<double>(i % side) * 0.1) + 0.5 * noise(gen);
+
+  double mean = 0.;
+
+  for(std::size_t i = 0; i < n; ++i)
+    mean += values[i];
+
+  mean /= static_cast<double>(n);
+
+  double variance = 0.;
+
+  std::vector<double> z(n);
+
+  for(std::size_t i = 0; i < n; ++i)
+  {
+    z[i] = values[i] - mean;
+    variance += z[i] * z[i];
+  }
+
+  variance /= static_cast<double>(n);
+
+// the observed global and local indexes
+  const std::vector<std::size_t>& offsets = swm.getOffsets();
+  const std::vector<std::size_t>& neighbours = swm.getNeighbours();
+  const std::vector<double>& weights = swm.getWeights();
+
+  std::vector<double> lisa(n);
+
+  double moranIndex = 0.;
+
+  for(std::size_t i = 0; i < n; ++i)
+  {
+    double wz = 0.;
+
+    for(std::size_t k = offsets[i]; k < offsets[i + 1]; ++k)
+      wz += weights[k] * z[neighbours[k]];
+
+    lisa[i] = z[i] * wz / variance;
+
+    moranIndex += z[i] * wz;
+  }
+
+  moranIndex /= variance * static_cast<double>(n - 1);
+
+// the serial path
+  te::sa::PermutationTest serialTest(swm, te::sa::PermutationTest::sm_defaultSeed, 1);
+
+  std::vector<double> serialGlobal;
+  std::vector<double> serialLocal;
+
+  boost::posix_time::ptime start = boost::posix_time::microsec_clock::local_time();
+
+  serialTest.globalMoran(values, mean, variance, permutationsNumber, serialGlobal);
+
+  double serialGlobalTime = Elapsed(start);
+
+  start = boost::posix_time::microsec_clock::local_time();
+
+  serialTest.lisaSignificance(z, variance, lisa, permutationsNumber, serialLocal);
+
+  double serialLocalTime = Elapsed(start);
+
+// the pool of threads, with the same seed
+  te::sa::PermutationTest parallelTest(swm, te::sa::PermutationTest::sm_defaultSeed, 0);
+
+  std::vector<double> parallelGlobal;
+  std::vector<double> parallelLocal;
+
+  start = boost::posix_time::microsec_clock::local_time();
+
+  parallelTest.globalMoran(values, mean, variance, permutationsNumber, parallelGlobal);
+
+  double parallelGlobalTime = Elapsed(start);
+
+  start = boost::posix_time::microsec_clock::local_time();
+
+  parallelTest.lisaSignificance(z, variance, lisa, permutationsNumber, parallelLocal);
+
+  double parallelLocalTime = Elapsed(start);
+
+  std::size_t significant = 0;
+
+  for(std::size_t i = 0; i < n; ++i)
+  {
+    if(serialLocal[i] <= 0.05)
+      ++significant;
+  }
+
+  std::cout << "  " << n << " vertices, " << permutationsNumber << " permutations" << std::endl;
+  std::cout << "  Moran index: " << moranIndex
+            << ", significance: " << te::sa::PermutationTest::GetGlobalSignificance(moranIndex, serialGlobal) << std::endl;
+  std::cout << "  LISA significant at 0.05: " << significant << " vertices" << std::endl;
+  std::cout << "  Global test (s): serial " << serialGlobalTime << ", threads " << parallelGlobalTime << std::endl;
+  std::cout << "  LISA test (s): serial " << serialLocalTime << ", threads " << parallelLocalTime << std::endl;
+  std::cout << "  Same results: " << ((serialGlobal == parallelGlobal && serialLocal == parallelLocal) ? "yes" : "NO") << std::endl;
+}
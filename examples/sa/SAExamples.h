@@ -0,0 +1,37 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+  \file SAExamples.h
+
+  \brief Several examples on how to use the Spatial Analysis module of TerraLib.
+ */
+
+#ifndef __TERRALIB_EXAMPLES_SA_INTERNAL_SAEXAMPLES_H
+#define __TERRALIB_EXAMPLES_SA_INTERNAL_SAEXAMPLES_H
+
+#include "Config.h"
+
+/*! \brief This example compares the Moran and LISA permutation tests computed by one thread and by a pool of threads, with a fixed seed. */
+void PermutationTestBenchmark();
+
+/*! \brief This example compares the kernel of a grid evaluated cell by cell, without truncation, with the truncated cell evaluation in a pool of threads and with the grid convolution. */
+void KernelGridBenchmark();
+
+#endif  // __TERRALIB_EXAMPLES_SA_INTERNAL_SAEXAMPLES_H
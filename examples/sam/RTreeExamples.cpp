@@ -30,6 +30,11 @@
 #include "SAMExamples.h"
 
 // STL
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
 #include <vector>
 
 void IndexPointUsingRTree()
@@ -58,3 +63,114 @@ void IndexPointUsingRTree()
   te::common::FreeContents(pointVec);
 }
 
+bool RTreeBulkLoadBenchmark()
+{
+  const std::size_t nitems = 500000;
+  const std::size_t nqueries = 50000;
+
+  typedef te::sam::rtree::Index<std::size_t, 8> RTree;
+
+// random boxes in a 100000 x 100000 square
+  std::vector<RTree::ItemType> items;
+  items.reserve(nitems);
+
+  std::srand(1);
+
+  for(std::size_t i = 0; i < nitems; ++i)
+  {
+    double x = std::rand() % 100000;
+    double y = std::rand() % 100000;
+
+    items.push_back(RTree::ItemType(te::gm::Envelope(x, y, x + std::rand() % 50, y + std::rand() % 50), i));
+  }
+
+  std::vector<te::gm::Envelope> queries;
+  queries.reserve(nqueries);
+
+  for(std::size_t i = 0; i < nqueries; ++i)
+  {
+    double x = std::rand() % 100000;
+    double y = std::rand() % 100000;
+
+    queries.push_back(te::gm::Envelope(x, y, x + 500, y + 500));
+  }
+
+// incremental build
+  RTree incrementalTree;
+
+  std::clock_t start = std::clock();
+
+  for(std::size_t i = 0; i < nitems; ++i)
+    incrementalTree.insert(items[i].first, items[i].second);
+
+  double incrementalBuild = static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+
+// bulk load
+  RTree bulkTree;
+
+  start = std::clock();
+
+  bulkTree.bulkLoad(items);
+
+  double bulkBuild = static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+
+// queries
+  std::size_t incrementalFound = 0;
+  std::size_t bulkFound = 0;
+
+  start = std::clock();
+
+  for(std::size_t i = 0; i < nqueries; ++i)
+  {
+    std::vector<std::size_t> report;
+    incrementalFound += incrementalTree.search(queries[i], report);
+  }
+
+  double incrementalQuery = static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+
+  start = std::clock();
+
+  for(std::size_t i = 0; i < nqueries; ++i)
+  {
+    std::vector<std::size_t> report;
+    bulkFound += bulkTree.search(queries[i], report);
+  }
+
+  double bulkQuery = static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+
+  std::cout << std::endl << "R-tree with " << nitems << " boxes and " << nqueries << " range queries:" << std::endl;
+
+// the timings are only meaningful if both trees find the same items for each query
+  for(std::size_t i = 0; i < nqueries; ++i)
+  {
+    std::vector<std::size_t> incrementalReport;
+    std::vector<std::size_t> bulkReport;
+
+    incrementalTree.search(queries[i], incrementalReport);
+    bulkTree.search(queries[i], bulkReport);
+
+    std::sort(incrementalReport.begin(), incrementalReport.end());
+    std::sort(bulkReport.begin(), bulkReport.end());
+
+    if(incrementalReport != bulkReport)
+    {
+      std::cout << "  ERROR: the trees found different items for the query " << i << " ("
+                << incrementalReport.size() << " incremental, " << bulkReport.size() << " bulk load)" << std::endl;
+
+      return false;
+    }
+  }
+
+  if(incrementalFound != bulkFound)
+  {
+    std::cout << "  ERROR: the trees found " << incrementalFound << " and " << bulkFound << " items" << std::endl;
+
+    return false;
+  }
+
+  std::cout << "  incremental: build " << incrementalBuild << "s, query " << incrementalQuery << "s, nodes " << incrementalTree.size() << std::endl;
+  std::cout << "  bulk load:   build " << bulkBuild << "s, query " << bulkQuery << "s, nodes " << bulkTree.size() << std::endl;
+  std::cout << "  found items: " << bulkFound << std::endl;
+
+  return true;
+}
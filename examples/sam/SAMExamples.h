@@ -29,6 +29,13 @@
 /*! \brief This example shows how to index a set of points using the R-tree spatial access method. */
 void IndexPointUsingRTree();
 
+/*!
+  \brief This example compares the build and query times of an R-tree built by insertions and by bulk loading.
+
+  \return False if the two trees don't find the same items.
+*/
+bool RTreeBulkLoadBenchmark();
+
 /*! \brief This example shows how to index a set of points using the K-d tree spatial access method. */
 void IndexPointUsingKdTree();
 
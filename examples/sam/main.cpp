@@ -40,6 +40,8 @@
 
 int main(int /*argc*/, char** /*argv*/)
 {
+  bool status = true;
+
   try
   {
     TerraLib::getInstance().initialize();
@@ -47,6 +49,8 @@ int main(int /*argc*/, char** /*argv*/)
 // R-tree examples
     IndexPointUsingRTree();
 
+    status = RTreeBulkLoadBenchmark() && status;
+
 // K-d tree examples
     IndexPointUsingKdTree();
     
@@ -65,5 +69,5 @@ int main(int /*argc*/, char** /*argv*/)
     return EXIT_FAILURE;
   }
 
-  return EXIT_SUCCESS;
+  return status ? EXIT_SUCCESS : EXIT_FAILURE;
 }
@@ -37,5 +37,8 @@ void RecognizeSRIDs();
 /*! \brief This example shows how to transform a geometry from an SRS to another. */
 void ConvertCoordinates();
 
+/*! \brief This example compares the time to transform many geometries with new converters, cached converters and a single batch. */
+void TransformBenchmark();
+
 #endif  // __TERRALIB_EXAMPLES_SRS_INTERNAL_SRSEXAMPLES_H
 
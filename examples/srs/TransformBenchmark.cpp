@@ -0,0 +1,132 @@
+// Examples
+#include "SRSExamples.h"
+
+// TerraLib
+#include <terralib/geometry.h>
+#include <terralib/srs.h>
+
+// STL
+#include <cmath>
+#include <cstddef>
+#include <ctime>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+namespace
+{
+  // It creates a set of polygons around (-45, -23), in WGS84, like the rows of a layer chunk.
+  void CreatePolygons(std::vector<te::gm::Geometry*>& geoms, std::size_t ngeoms, std::size_t npts)
+  {
+    for(std::size_t i = 0; i < ngeoms; ++i)
+    {
+      const double xc = -46.0 + static_cast<double>(i % 100) * 0.02;
+      const double yc = -24.0 + static_cast<double>(i / 100) * 0.02;
+
+      te::gm::LinearRing* ring = new te::gm::LinearRing(npts + 1, te::gm::LineStringType, TE_SRS_WGS84);
+
+      for(std::size_t j = 0; j < npts; ++j)
+      {
+        const double a = 6.283185307179586 * static_cast<double>(j) / static_cast<double>(npts);
+        ring->setPoint(j, xc + 0.008 * std::cos(a), yc + 0.008 * std::sin(a));
+      }
+
+      ring->setPoint(npts, ring->getX(0), ring->getY(0));
+
+      te::gm::Polygon* poly = new te::gm::Polygon(0, te::gm::PolygonType, TE_SRS_WGS84);
+      poly->push_back(ring);
+
+      geoms.push_back(poly);
+    }
+  }
+
+  void DeletePolygons(std::vector<te::gm::Geometry*>& geoms)
+  {
+    for(std::size_t i = 0; i < geoms.size(); ++i)
+      delete geoms[i];
+
+    geoms.clear();
+  }
+}
+
+void TransformBenchmark()
+{
+  std::cout << "Transforming geometries from WGS84 to UTM 23S..." << std::endl;
+
+  const std::size_t ngeoms = 10000;
+  const std::size_t npts = 50;
+
+  std::vector<te::gm::Geometry*> geoms;
+
+// a new converter for each geometry, as the geometries used to do
+  CreatePolygons(geoms, ngeoms, npts);
+
+  std::clock_t start = std::clock();
+
+  for(std::size_t i = 0; i < ngeoms; ++i)
+  {
+    te::gm::LineString* ring = static_cast<te::gm::LineString*>(static_cast<te::gm::Polygon*>(geoms[i])->getRingN(0));
+
+    std::auto_ptr<te::srs::Converter> converter(new te::srs::Converter());
+    converter->setSourceSRID(TE_SRS_WGS84);
+    converter->setTargetSRID(TE_SRS_WGS84_UTM_ZONE_23S);
+
+    double* pt = reinterpret_cast<double*>(ring->getCoordinates());
+    converter->convert(pt, &(pt[1]), static_cast<long>(ring->size()), 2);
+  }
+
+  double newConverterTime = static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+
+  DeletePolygons(geoms);
+
+// one geometry at a time, with the cached converters
+  CreatePolygons(geoms, ngeoms, npts);
+
+  start = std::clock();
+
+  for(std::size_t i = 0; i < ngeoms; ++i)
+    geoms[i]->transform(TE_SRS_WGS84_UTM_ZONE_23S);
+
+  double cachedTime = static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+
+  double cachedX = static_cast<te::gm::Polygon*>(geoms[ngeoms - 1])->getRingN(0)->getMBR()->m_llx;
+
+  DeletePolygons(geoms);
+
+// all geometries in a single call
+  CreatePolygons(geoms, ngeoms, npts);
+
+  start = std::clock();
+
+  te::gm::Transform(geoms, TE_SRS_WGS84_UTM_ZONE_23S);
+
+  double batchTime = static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+
+  double batchX = static_cast<te::gm::Polygon*>(geoms[ngeoms - 1])->getRingN(0)->getMBR()->m_llx;
+
+// the same projection in kilometers: a scale, without PROJ4
+  te::srs::Converter converter;
+  converter.setSourceSRID(TE_SRS_WGS84_UTM_ZONE_23S);
+  converter.setTargetPJ4txt("+proj=utm +zone=23 +south +datum=WGS84 +units=km +no_defs");
+
+  start = std::clock();
+
+  for(std::size_t i = 0; i < ngeoms; ++i)
+  {
+    te::gm::LineString* ring = static_cast<te::gm::LineString*>(static_cast<te::gm::Polygon*>(geoms[i])->getRingN(0));
+
+    double* pt = reinterpret_cast<double*>(ring->getCoordinates());
+    converter.convert(pt, &(pt[1]), static_cast<long>(ring->size()), 2);
+  }
+
+  double affineTime = static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+
+  DeletePolygons(geoms);
+
+  std::cout << "New converter by geometry:    " << newConverterTime << "s" << std::endl;
+  std::cout << "Cached converter by geometry: " << cachedTime << "s" << std::endl;
+  std::cout << "Batch transform:              " << batchTime << "s" << std::endl;
+  std::cout << "Meters to kilometers:         " << affineTime << "s (affine fast path: "
+            << (converter.isAffine() ? "yes" : "no") << ")" << std::endl;
+  std::cout << "Same coordinates: " << (cachedX == batchX ? "yes" : "no") << std::endl;
+}
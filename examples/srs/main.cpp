@@ -47,6 +47,7 @@ int main(int argc, char** argv)
       SpatialReferenceSystemManager();
       RecognizeSRIDs();
       ConvertCoordinates();
+      TransformBenchmark();
 
   
     TerraLib::getInstance().finalize();
@@ -52,11 +52,24 @@
 
 #include "Exception.h"
 #include "RasterToVector.h"
+#include "ZonalStatistics.h"
 
 // Boost
 #include <boost/algorithm/string.hpp>
 #include <boost/lexical_cast.hpp>
 
+// STL
+#include <algorithm>
+
+namespace te
+{
+  namespace attributefill
+  {
+    /*! \brief The maximum number of zone accumulators (zones times bands) in a batch. */
+    static const std::size_t sg_maxAccumulators = 1048576;
+  }
+}
+
 te::attributefill::RasterToVector::RasterToVector()
 {
 }
@@ -109,14 +122,8 @@ bool te::attributefill::RasterToVector::paramsAreValid()
 bool te::attributefill::RasterToVector::run()
 {
   // prepare raster
-  double resX = m_inRaster->getResolutionX();
-  double resY = m_inRaster->getResolutionY();
-
   te::gm::Envelope* env = m_inRaster->getExtent();
 
-  // raster Attributes
-  te::rp::RasterAttributes* rasterAtt = 0;
-
   // prepare vector
   te::gm::GeometryProperty* vectorProp =
       te::da::GetFirstGeomProperty(m_inVectorDsType->getResult());
@@ -158,6 +165,12 @@ bool te::attributefill::RasterToVector::run()
     percentByArea = true;
   }
 
+  // The mode, the median and the percentages need the values distribution
+  bool histogram =
+      mode || percentByArea ||
+      (std::find(m_statSum.begin(), m_statSum.end(), te::stat::MEDIAN) !=
+       m_statSum.end());
+
   // get output DataSetType.
   std::auto_ptr<te::da::DataSetType> outDsType;
   if(percentByArea)
@@ -170,8 +183,7 @@ bool te::attributefill::RasterToVector::run()
 
   // task progress
   te::common::TaskProgress task("Processing Operation...");
-  task.setTotalSteps((int)dsVector->size() * (int)m_statSum.size() *
-                     (int)m_bands.size());
+  task.setTotalSteps((int)dsVector->size());
   task.useTimer(true);
 
   bool remap = false;
@@ -179,6 +191,17 @@ bool te::attributefill::RasterToVector::run()
   if(m_inRaster->getSRID() != vectorProp->getSRID())
     remap = true;
 
+  // The polygons are processed in batches by the zonal statistics engine:
+  // the raster is read once for each batch
+  ZonalStatistics zonalStatistics(m_inRaster, m_bands, histogram);
+
+  const std::size_t zonesPerBatch =
+      std::max(sg_maxAccumulators / std::max(m_bands.size(),
+                                             static_cast<std::size_t>(1)),
+               static_cast<std::size_t>(1));
+
+  std::vector<ZonalFeature> features;
+
   dsVector->moveBeforeFirst();
   while(dsVector->moveNext())
   {
@@ -196,80 +219,65 @@ bool te::attributefill::RasterToVector::run()
     // Geometry
     std::auto_ptr<te::gm::Geometry> geom = dsVector->getGeometry(geomIdx);
     if(!geom->isValid())
+    {
+      delete outDSetItem;
       continue;
+    }
 
     if(remap)
       geom->transform(m_inRaster->getSRID());
 
+    ZonalFeature feature;
+    feature.m_item = outDSetItem;
+    feature.m_hasZone = false;
+    feature.m_zone = 0;
+    feature.m_area = 0;
+    feature.m_contains = true;
+    feature.m_geom = 0;
+
     // Add Item in DataSet if geom does not intersects the raster envelope and
     // continue to the next dataSet item.
     if(!env->intersects(*geom->getMBR()))
     {
-      outDataset->add(outDSetItem);
+      features.push_back(feature);
       continue;
     }
 
-    double area = 0;
-
-    // Values from raster
-    std::vector<std::vector<double> > valuesFromRaster;
-    valuesFromRaster.resize(m_bands.size());
-
-    // Contains
-    bool contains = true;
-    bool isPoint = false;
-
     switch(geom->getGeomTypeId())
     {
       case te::gm::MultiPolygonType:
       {
         te::gm::MultiPolygon* mPolygon =
             dynamic_cast<te::gm::MultiPolygon*>(geom.get());
-        contains = env->contains(*mPolygon->getMBR());
+        feature.m_contains = env->contains(*mPolygon->getMBR());
 
         if(percentByArea)
-          area = mPolygon->getArea();
-
-        std::size_t n_geom = mPolygon->getNumGeometries();
-
-        for(std::size_t n = 0; n < n_geom; ++n)
-        {
-          te::gm::Polygon* polygon =
-              dynamic_cast<te::gm::Polygon*>(mPolygon->getGeometryN(n));
-          std::vector<std::vector<double> > tempValues =
-              rasterAtt->getValuesFromRaster(*m_inRaster, *polygon, m_bands);
-
-          for(std::size_t band = 0; band < tempValues.size(); ++band)
-          {
-            std::vector<double>::iterator it;
-            it = valuesFromRaster[band].end();
+          feature.m_area = mPolygon->getArea();
 
-            valuesFromRaster[band].insert(it, tempValues[band].begin(),
-                                          tempValues[band].end());
-          }
-        }
-
-        isPoint = false;
+        feature.m_hasZone = true;
+        feature.m_zone = zonalStatistics.addZone(mPolygon);
 
         break;
       }
       case te::gm::PolygonType:
       {
         te::gm::Polygon* polygon = dynamic_cast<te::gm::Polygon*>(geom.get());
-        contains = env->contains(*polygon->getMBR());
+        feature.m_contains = env->contains(*polygon->getMBR());
 
         if(percentByArea)
-          area = polygon->getArea();
-
-        valuesFromRaster =
-            rasterAtt->getValuesFromRaster(*m_inRaster, *polygon, m_bands);
+          feature.m_area = polygon->getArea();
 
-        isPoint = false;
+        feature.m_hasZone = true;
+        feature.m_zone = zonalStatistics.addZone(polygon);
 
         break;
       }
       case te::gm::MultiPointType:
       {
+        // Values from raster
+        std::vector<std::vector<double> > valuesFromRaster;
+        valuesFromRaster.resize(m_bands.size());
+
         te::gm::MultiPoint* mPoint =
             dynamic_cast<te::gm::MultiPoint*>(geom.get());
 
@@ -302,204 +310,256 @@ bool te::attributefill::RasterToVector::run()
 
             valuesFromRaster[band].insert(it, values.begin(), values.end());
           }
+        }
 
-          isPoint = true;
+        std::size_t init_index =
+            m_inVectorDsType->getResult()->getProperties().size();
+
+        for(std::size_t i = 0; i < valuesFromRaster.size(); ++i)
+        {
+          for(std::size_t j = 0; j < valuesFromRaster[i].size(); ++j)
+          {
+            outDSetItem->setDouble(init_index, valuesFromRaster[i][j]);
+          }
         }
+
         break;
       }
       default:
+      {
+        delete outDSetItem;
         continue;
+      }
     }
 
-    std::size_t init_index =
-        m_inVectorDsType->getResult()->getProperties().size();
+    // the texture is computed from the polygon itself
+    if(feature.m_hasZone && m_texture)
+      feature.m_geom = geom.release();
 
-    // Statistics set value
-    if(!isPoint)
-    {
-      for(std::size_t band = 0; band < valuesFromRaster.size(); ++band)
-      {
-        te::stat::NumericStatisticalSummary summary;
+    features.push_back(feature);
 
-        te::stat::GetNumericStatisticalSummary(valuesFromRaster[band], summary);
+    if(zonalStatistics.getNumberOfZones() == zonesPerBatch)
+      addFeatures(zonalStatistics, features, outDataset.get(), pixelDistinct,
+                  mode, percentByArea, task);
+  }
 
-        if(mode)
-          te::stat::Mode(valuesFromRaster[band], summary);
+  addFeatures(zonalStatistics, features, outDataset.get(), pixelDistinct,
+              mode, percentByArea, task);
 
-        if(percentByArea)
-          te::stat::GetPercentOfEachClassByArea(valuesFromRaster[band], resX,
-                                                resY, area, summary, contains);
+  return save(outDataset, outDsType);
+}
+
+void te::attributefill::RasterToVector::addFeatures(
+    ZonalStatistics& zonalStatistics, std::vector<ZonalFeature>& features,
+    te::mem::DataSet* outDataset,
+    const std::vector<std::vector<double> >& pixelDistinct, bool mode,
+    bool percentByArea, te::common::TaskProgress& task)
+{
+  bool canceled = !zonalStatistics.compute(&task);
+
+  for(std::size_t f = 0; f < features.size(); ++f)
+  {
+    ZonalFeature& feature = features[f];
+
+    if(!canceled && feature.m_hasZone)
+      setStatistics(feature, zonalStatistics, pixelDistinct, mode,
+                    percentByArea);
+
+    delete feature.m_geom;
+
+    if(canceled)
+      delete feature.m_item;
+    else
+      outDataset->add(feature.m_item);
+
+    task.pulse();
+  }
+
+  features.clear();
+  zonalStatistics.clear();
+
+  if(canceled || task.isActive() == false)
+    throw te::attributefill::Exception(TE_TR("Operation canceled!"));
+}
+
+void te::attributefill::RasterToVector::setStatistics(
+    const ZonalFeature& feature, const ZonalStatistics& zonalStatistics,
+    const std::vector<std::vector<double> >& pixelDistinct, bool mode,
+    bool percentByArea)
+{
+  te::mem::DataSetItem* outDSetItem = feature.m_item;
+
+  double resX = m_inRaster->getResolutionX();
+  double resY = m_inRaster->getResolutionY();
+
+  std::size_t init_index =
+      m_inVectorDsType->getResult()->getProperties().size();
+
+  // Statistics set value
+  for(std::size_t band = 0; band < m_bands.size(); ++band)
+  {
+    te::stat::NumericStatisticalSummary summary;
+
+    zonalStatistics.getSummary(feature.m_zone, band, summary);
+
+    if(mode)
+      zonalStatistics.getMode(feature.m_zone, band, summary);
+
+    if(percentByArea)
+      zonalStatistics.getPercentOfEachClass(feature.m_zone, band, resX, resY,
+                                            feature.m_area, feature.m_contains,
+                                            summary);
 
-        std::size_t current_index = init_index + m_statSum.size();
+    std::size_t current_index = init_index + m_statSum.size();
 
-        for(std::size_t it = 0, i = init_index; i < current_index; ++it, ++i)
+    for(std::size_t it = 0, i = init_index; i < current_index; ++it, ++i)
+    {
+      te::stat::StatisticalSummary ss = m_statSum[it];
+
+      switch(ss)
+      {
+        case te::stat::MIN_VALUE:
+          outDSetItem->setDouble(i, summary.m_minVal);
+          break;
+        case te::stat::MAX_VALUE:
+          outDSetItem->setDouble(i, summary.m_maxVal);
+          break;
+        case te::stat::COUNT:
+          outDSetItem->setDouble(i, summary.m_count);
+          break;
+        case te::stat::VALID_COUNT:
+          outDSetItem->setDouble(i, summary.m_validCount);
+          break;
+        case te::stat::MEAN:
+          outDSetItem->setDouble(i, summary.m_mean);
+          break;
+        case te::stat::SUM:
+          outDSetItem->setDouble(i, summary.m_sum);
+          break;
+        case te::stat::STANDARD_DEVIATION:
+          outDSetItem->setDouble(i, summary.m_stdDeviation);
+          break;
+        case te::stat::VARIANCE:
+          outDSetItem->setDouble(i, summary.m_variance);
+          break;
+        case te::stat::SKEWNESS:
+          outDSetItem->setDouble(i, summary.m_skewness);
+          break;
+        case te::stat::KURTOSIS:
+          outDSetItem->setDouble(i, summary.m_kurtosis);
+          break;
+        case te::stat::AMPLITUDE:
+          outDSetItem->setDouble(i, summary.m_amplitude);
+          break;
+        case te::stat::MEDIAN:
+          outDSetItem->setDouble(i, summary.m_median);
+          break;
+        case te::stat::VAR_COEFF:
+          outDSetItem->setDouble(i, summary.m_varCoeff);
+          break;
+        case te::stat::MODE:
         {
-          te::stat::StatisticalSummary ss = m_statSum[it];
+          std::string mode;
 
-          switch(ss)
+          if(!summary.m_mode.empty())
           {
-            case te::stat::MIN_VALUE:
-              outDSetItem->setDouble(i, summary.m_minVal);
-              break;
-            case te::stat::MAX_VALUE:
-              outDSetItem->setDouble(i, summary.m_maxVal);
-              break;
-            case te::stat::COUNT:
-              outDSetItem->setDouble(i, summary.m_count);
-              break;
-            case te::stat::VALID_COUNT:
-              outDSetItem->setDouble(i, summary.m_validCount);
-              break;
-            case te::stat::MEAN:
-              outDSetItem->setDouble(i, summary.m_mean);
-              break;
-            case te::stat::SUM:
-              outDSetItem->setDouble(i, summary.m_sum);
-              break;
-            case te::stat::STANDARD_DEVIATION:
-              outDSetItem->setDouble(i, summary.m_stdDeviation);
-              break;
-            case te::stat::VARIANCE:
-              outDSetItem->setDouble(i, summary.m_variance);
-              break;
-            case te::stat::SKEWNESS:
-              outDSetItem->setDouble(i, summary.m_skewness);
-              break;
-            case te::stat::KURTOSIS:
-              outDSetItem->setDouble(i, summary.m_kurtosis);
-              break;
-            case te::stat::AMPLITUDE:
-              outDSetItem->setDouble(i, summary.m_amplitude);
-              break;
-            case te::stat::MEDIAN:
-              outDSetItem->setDouble(i, summary.m_median);
-              break;
-            case te::stat::VAR_COEFF:
-              outDSetItem->setDouble(i, summary.m_varCoeff);
-              break;
-            case te::stat::MODE:
+            mode = boost::lexical_cast<std::string>(summary.m_mode[0]);
+            for(std::size_t m = 1; m < summary.m_mode.size(); ++m)
             {
-              std::string mode;
-
-              if(!summary.m_mode.empty())
-              {
-                mode = boost::lexical_cast<std::string>(summary.m_mode[0]);
-                for(std::size_t m = 1; m < summary.m_mode.size(); ++m)
-                {
-                  mode += ",";
-                  mode += boost::lexical_cast<std::string>(summary.m_mode[m]);
-                }
-                outDSetItem->setString(i, mode);
-              }
-              else
-              {
-                outDSetItem->setString(i, "");
-              }
-              break;
-            }
-            case te::stat::PERCENT_EACH_CLASS_BY_AREA:
-            {
-              std::vector<double>::iterator itPixelDistinct =
-                  pixelDistinct[band].begin();
-              std::map<double, double>::iterator itPercent =
-                  summary.m_percentEachClass.begin();
-
-              while(itPixelDistinct != pixelDistinct[band].end())
-              {
-                if(itPercent != summary.m_percentEachClass.end())
-                {
-                  std::string name = outDSetItem->getPropertyName(i);
-                  std::vector<std::string> splitString;
-                  boost::split(splitString, name, boost::is_any_of("_"));
-                  if(splitString[1] ==
-                     boost::lexical_cast<std::string>(itPercent->first))
-                  {
-                    outDSetItem->setDouble(i, itPercent->second);
-                    ++itPercent;
-                  }
-                  else
-                  {
-                    outDSetItem->setDouble(i, 0);
-                  }
-                }
-                else
-                {
-                  outDSetItem->setDouble(i, 0);
-                }
-                ++itPixelDistinct;
-                ++i;
-              }
-              current_index += pixelDistinct[band].size() - 1;
-              break;
+              mode += ",";
+              mode += boost::lexical_cast<std::string>(summary.m_mode[m]);
             }
-            default:
-              continue;
+            outDSetItem->setString(i, mode);
           }
-          task.pulse();
+          else
+          {
+            outDSetItem->setString(i, "");
+          }
+          break;
         }
-
-        // texture
-        std::vector<te::rp::Texture> metrics;
-        init_index = current_index;
-
-        if(m_texture == true)
+        case te::stat::PERCENT_EACH_CLASS_BY_AREA:
         {
-          metrics = getTexture(m_inRaster, geom.get(), band, m_readAll);
-          current_index += 5;
-          for(std::size_t t = 0, i = init_index; i < current_index; ++t, ++i)
+          std::vector<double>::const_iterator itPixelDistinct =
+              pixelDistinct[band].begin();
+          std::map<double, double>::iterator itPercent =
+              summary.m_percentEachClass.begin();
+
+          while(itPixelDistinct != pixelDistinct[band].end())
           {
-            switch(t)
+            if(itPercent != summary.m_percentEachClass.end())
             {
-              case 0:
-              {
-                outDSetItem->setDouble(i, metrics[band].m_contrast);
-                break;
-              }
-              case 1:
+              std::string name = outDSetItem->getPropertyName(i);
+              std::vector<std::string> splitString;
+              boost::split(splitString, name, boost::is_any_of("_"));
+              if(splitString[1] ==
+                 boost::lexical_cast<std::string>(itPercent->first))
               {
-                outDSetItem->setDouble(i, metrics[band].m_dissimilarity);
-                break;
+                outDSetItem->setDouble(i, itPercent->second);
+                ++itPercent;
               }
-              case 2:
-              {
-                outDSetItem->setDouble(i, metrics[band].m_energy);
-                break;
-              }
-              case 3:
-              {
-                outDSetItem->setDouble(i, metrics[band].m_entropy);
-                break;
-              }
-              case 4:
+              else
               {
-                outDSetItem->setDouble(i, metrics[band].m_homogeneity);
-                break;
+                outDSetItem->setDouble(i, 0);
               }
             }
+            else
+            {
+              outDSetItem->setDouble(i, 0);
+            }
+            ++itPixelDistinct;
+            ++i;
           }
+          current_index += pixelDistinct[band].size() - 1;
+          break;
         }
-
-        init_index = current_index;
+        default:
+          continue;
       }
     }
-    else
+
+    // texture
+    std::vector<te::rp::Texture> metrics;
+    init_index = current_index;
+
+    if(m_texture == true)
     {
-      for(std::size_t i = 0; i < valuesFromRaster.size(); ++i)
+      metrics = getTexture(m_inRaster, feature.m_geom, m_bands[band], m_readAll);
+      current_index += 5;
+      for(std::size_t t = 0, i = init_index; i < current_index; ++t, ++i)
       {
-        for(std::size_t j = 0; j < valuesFromRaster[i].size(); ++j)
+        switch(t)
         {
-          outDSetItem->setDouble(init_index, valuesFromRaster[i][j]);
+          case 0:
+          {
+            outDSetItem->setDouble(i, metrics[0].m_contrast);
+            break;
+          }
+          case 1:
+          {
+            outDSetItem->setDouble(i, metrics[0].m_dissimilarity);
+            break;
+          }
+          case 2:
+          {
+            outDSetItem->setDouble(i, metrics[0].m_energy);
+            break;
+          }
+          case 3:
+          {
+            outDSetItem->setDouble(i, metrics[0].m_entropy);
+            break;
+          }
+          case 4:
+          {
+            outDSetItem->setDouble(i, metrics[0].m_homogeneity);
+            break;
+          }
         }
       }
     }
 
-    outDataset->add(outDSetItem);
-
-    if(task.isActive() == false)
-      throw te::attributefill::Exception(TE_TR("Operation canceled!"));
+    init_index = current_index;
   }
-
-  return save(outDataset, outDsType);
 }
 
 void te::attributefill::RasterToVector::getPixelDistinct(
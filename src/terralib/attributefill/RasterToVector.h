@@ -53,8 +53,20 @@
 
 namespace te
 {
+  namespace common
+  {
+    class TaskProgress;
+  }
+
+  namespace mem
+  {
+    class DataSetItem;
+  }
+
   namespace attributefill
   {
+    class ZonalStatistics;
+
     class TEATTRIBUTEFILLEXPORT RasterToVector
     {
      public:
@@ -81,6 +93,36 @@ namespace te
       bool run();
 
      protected:
+      /*! \brief An output item waiting for the zonal statistics of its batch. */
+      struct ZonalFeature
+      {
+        te::mem::DataSetItem* m_item;
+        bool m_hasZone;            //!< True for polygons.
+        std::size_t m_zone;        //!< The zone index in the batch.
+        double m_area;             //!< The polygon area (percentage by area).
+        bool m_contains;           //!< True if the raster contains the polygon.
+        te::gm::Geometry* m_geom;  //!< The polygon, only kept for the texture.
+      };
+
+      /*!
+        \brief It computes the statistics of a batch of polygons and adds the
+               items to the output dataset.
+
+        \exception Exception It throws an exception if the task is canceled.
+       */
+      void addFeatures(ZonalStatistics& zonalStatistics,
+                       std::vector<ZonalFeature>& features,
+                       te::mem::DataSet* outDataset,
+                       const std::vector<std::vector<double> >& pixelDistinct,
+                       bool mode, bool percentByArea,
+                       te::common::TaskProgress& task);
+
+      /*! \brief It sets the statistics (and the texture) of a polygon item. */
+      void setStatistics(const ZonalFeature& feature,
+                         const ZonalStatistics& zonalStatistics,
+                         const std::vector<std::vector<double> >& pixelDistinct,
+                         bool mode, bool percentByArea);
+
       void getPixelDistinct(rst::Raster& inputRaster,
                             unsigned int inputRasterBand,
                             std::vector<double>& values);
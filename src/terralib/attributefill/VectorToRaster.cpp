@@ -38,12 +38,8 @@
 #include "../datatype/Property.h"
 #include "../datatype/StringProperty.h"
 
+#include "../geometry/Geometry.h"
 #include "../geometry/GeometryProperty.h"
-#include "../geometry/Line.h"
-#include "../geometry/LineString.h"
-#include "../geometry/Polygon.h"
-#include "../geometry/Point.h"
-#include "../geometry/Utils.h"
 
 #include "../memory/DataSetItem.h"
 
@@ -51,6 +47,7 @@
 #include "../raster/BandProperty.h"
 #include "../raster/Grid.h"
 #include "../raster/RasterFactory.h"
+#include "../raster/Rasterizer.h"
 
 #include "../rp/RasterAttributes.h"
 
@@ -151,16 +148,15 @@ bool te::attributefill::VectorToRaster::run()
 // create raster
   std::auto_ptr<te::rst::Raster> rst(te::rst::RasterFactory::make("GDAL", grid, vecBandProp, conInfo));
 
-  te::rst::FillRaster(rst.get(), rst->getBand(0)->getProperty()->m_noDataValue);
-
-// get vector data
+// get vector data: the geometries are burned in the dataset order, the last one wins
   std::string geomName = geomProp->getName();
-  std::map<te::gm::Geometry*, std::vector<double> > vectorMap;
+
+  te::rst::Rasterizer rasterizer(*rst->getGrid(), te::rst::Rasterizer::MergeLast);
 
   inDataSet->moveBeforeFirst();
   while(inDataSet->moveNext())
   {
-    te::gm::Geometry* geom = static_cast<te::gm::Geometry*>(inDataSet->getGeometry(geomName)->clone());
+    std::auto_ptr<te::gm::Geometry> geom = inDataSet->getGeometry(geomName);
     std::vector<double> valueVec;
 
     for(std::size_t b = 0; b < m_selectedAttVec.size(); ++b)
@@ -168,136 +164,15 @@ bool te::attributefill::VectorToRaster::run()
       valueVec.push_back(inDataSet->getDouble(m_selectedAttVec[b]));
     }
 
-    vectorMap.insert(std::pair<te::gm::Geometry*, std::vector<double> >(geom, valueVec));
+    rasterizer.add(geom.get(), valueVec);
   }
 
+// the cells not covered by any geometry get the no-data value
   te::common::TaskProgress task("Rasterizing...");
-  task.setTotalSteps((int)(m_selectedAttVec.size() * vectorMap.size()));
   task.useTimer(true);
 
-  for(std::size_t i = 0; i < m_selectedAttVec.size(); ++i)
-  {
-    std::map<te::gm::Geometry*, std::vector<double> >::iterator vectorIt = vectorMap.begin();
-
-    while(vectorIt != vectorMap.end())
-    {
-      switch (vectorIt->first->getGeomTypeId())
-      {
-      case te::gm::PolygonType:
-      case te::gm::MultiPolygonType:
-      {
-                                     std::vector<te::gm::Geometry*> geomVec;
-
-                                     if (vectorIt->first->getGeomTypeId() == te::gm::MultiPolygonType)
-                                       te::gm::Multi2Single(vectorIt->first, geomVec);
-                                     else
-                                       geomVec.push_back(vectorIt->first);
-                                     
-                                     for (std::size_t g = 0; g < geomVec.size(); ++g)
-                                     {
-                                       te::gm::Polygon* polygon = dynamic_cast<te::gm::Polygon*>(geomVec[g]);
-
-                                       if (!polygon)
-                                         continue;
-
-                                       polygon->setSRID(geomProp->getSRID());
-
-                                       te::rst::PolygonIterator<double> it = te::rst::PolygonIterator<double>::begin(rst.get(), polygon);
-                                       te::rst::PolygonIterator<double> itend = te::rst::PolygonIterator<double>::end(rst.get(), polygon);
-
-                                       while (it != itend)
-                                       {
-                                         rst->setValue(it.getColumn(), it.getRow(), vectorIt->second[i], i);
-                                         ++it;
-                                       }
-                                     }
-                                     break;
-      }
-      case te::gm::LineStringType:
-      case te::gm::MultiLineStringType:
-      {
-                                        std::vector<te::gm::Geometry*> geomVec;
-
-                                        if (vectorIt->first->getGeomTypeId() == te::gm::MultiLineStringType)
-                                          te::gm::Multi2Single(vectorIt->first, geomVec);
-                                        else
-                                          geomVec.push_back(vectorIt->first);
-
-
-                                        for (std::size_t g = 0; g < geomVec.size(); ++g)
-                                        {
-                                          te::gm::LineString* lineString = static_cast<te::gm::LineString*>(geomVec[g]);
-
-                                          if (!lineString)
-                                            continue;
-
-                                          std::size_t nPoints = lineString->getNPoints();
-                                          
-                                          for (std::size_t n = 0; n < nPoints - 1; ++n)
-                                          {
-                                            std::auto_ptr<te::gm::Line> line(new te::gm::Line(*lineString->getPointN(n),
-                                                                                              *lineString->getPointN(n + 1),
-                                                                                              te::gm::LineStringType,
-                                                                                              geomProp->getSRID()));
-
-                                            te::rst::LineIterator<double> it = te::rst::LineIterator<double>::begin(rst.get(), line.get());
-                                            te::rst::LineIterator<double> itend = te::rst::LineIterator<double>::end(rst.get(), line.get());
-
-                                            while (it != itend)
-                                            {
-                                              rst->setValue(it.getColumn(), it.getRow(), vectorIt->second[i], i);
-                                              ++it;
-                                            }
-                                          }
-                                        }
-                                        
-                                        break;
-      }
-      case te::gm::PointType:
-      case te::gm::MultiPointType:
-      {
-                                   std::vector<te::gm::Geometry*> geomVec;
-
-                                   if (vectorIt->first->getGeomTypeId() == te::gm::MultiPointType)
-                                     te::gm::Multi2Single(vectorIt->first, geomVec);
-                                   else
-                                     geomVec.push_back(vectorIt->first);
-
-                                   for (std::size_t g = 0; g < geomVec.size(); ++g)
-                                   {
-                                     std::vector<te::gm::Point*> pointVec;
-                                     te::gm::Point* point = static_cast<te::gm::Point*>(geomVec[g]);
-
-                                     if (!point)
-                                       continue;
-
-                                     pointVec.push_back(point);
-
-                                     point->setSRID(geomProp->getSRID());
-
-                                     te::rst::PointSetIterator<double> it = te::rst::PointSetIterator<double>::begin(rst.get(), pointVec);
-                                     te::rst::PointSetIterator<double> itend = te::rst::PointSetIterator<double>::end(rst.get(), pointVec);
-
-                                     while (it != itend)
-                                     {
-                                       rst->setValue(it.getColumn(), it.getRow(), vectorIt->second[i], i);
-                                       ++it;
-                                     }
-                                   }
-                                   
-                                   break;
-      }
-      default:
-        break;
-      }
-      
-      ++vectorIt;
-
-      task.pulse();
-    }
+  if(!rasterizer.rasterize(rst.get(), &task))
+    throw te::attributefill::Exception(TE_TR("Operation canceled!"));
 
-    if (task.isActive() == false)
-      throw te::attributefill::Exception(TE_TR("Operation canceled!"));
-  }
   return true;
 }
\ No newline at end of file
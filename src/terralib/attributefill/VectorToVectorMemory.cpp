@@ -586,17 +586,21 @@ te::sam::rtree::Index<size_t, 8>* te::attributefill::VectorToVectorMemory::getRt
   te::common::FreeContents(m_mapGeom);
   m_mapGeom.clear();
 
+  std::vector<te::sam::rtree::Index<size_t, 8>::ItemType> items;
+
   while(data->moveNext())
   {
     std::auto_ptr<te::gm::Geometry> geom = data->getGeometry(geomPos);
 
-    rtree->insert(*geom->getMBR(), count);
+    items.push_back(te::sam::rtree::Index<size_t, 8>::ItemType(*geom->getMBR(), count));
 
     m_mapGeom.insert(std::map<int, te::gm::Geometry*>::value_type(count, geom.release()));
 
     ++count;
   }
 
+  rtree->bulkLoad(items);
+
   return rtree;
 }
 
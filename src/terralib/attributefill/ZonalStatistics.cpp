@@ -0,0 +1,703 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+ \file ZonalStatistics.cpp
+ */
+
+#include "../common/PlatformUtils.h"
+#include "../common/progress/TaskProgress.h"
+#include "../core/translator/Translator.h"
+
+#include "../geometry/LinearRing.h"
+#include "../geometry/MultiPolygon.h"
+#include "../geometry/Polygon.h"
+
+#include "../raster/Band.h"
+#include "../raster/BandProperty.h"
+#include "../raster/Grid.h"
+#include "../raster/Raster.h"
+
+#include "Exception.h"
+#include "ZonalStatistics.h"
+
+// STL
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+// Boost
+#include <boost/thread.hpp>
+
+namespace te
+{
+  namespace attributefill
+  {
+    /*! \brief The minimum size of a tile, in cells. Tiles are made of whole blocks. */
+    static const unsigned int sg_minTileSize = 256;
+
+    /*! \brief Larger blocks (e.g. strips of whole rows) are split in tiles of this size. */
+    static const unsigned int sg_maxTileSize = 1024;
+
+    /*! \brief The number of locks shared by the zones. */
+    static const std::size_t sg_zoneLocks = 64;
+
+    /*! \brief It returns the size of the tiles in one direction. */
+    static unsigned int GetTileSize(unsigned int blockSize, unsigned int rasterSize)
+    {
+      unsigned int size = std::max(blockSize, 1u);
+
+      if(size > sg_maxTileSize)
+        size = sg_maxTileSize;
+      else
+        size *= std::max(1u, sg_minTileSize / size);
+
+      return std::min(size, rasterSize);
+    }
+
+    struct ZonalStatistics::ThreadParams
+    {
+      ZonalStatistics* m_engine;
+      unsigned int m_tileWidth;
+      unsigned int m_tileHeight;
+      unsigned int m_tilesX;
+      std::vector<std::vector<std::size_t> > m_tileZones;  //!< The zones that may cover each tile.
+      std::vector<std::size_t> m_tiles;                    //!< The tiles covered by some zone, in row-major order.
+      std::size_t m_nextTile;
+      std::size_t m_processedTiles;
+      unsigned int m_runningThreads;
+      bool m_abort;
+      bool m_failed;
+      te::common::TaskProgress* m_task;                    //!< Only informed when there is a single thread.
+      boost::mutex m_mutex;                                //!< It protects the members above.
+      boost::condition_variable m_condVar;
+      boost::mutex m_ioMutex;                              //!< It serializes the raster reads.
+      boost::mutex m_zoneMutexes[sg_zoneLocks];            //!< It serializes the updates of the zone accumulators.
+    };
+  }
+}
+
+te::attributefill::ZonalStatistics::Accumulator::Accumulator()
+  : m_count(0),
+    m_min(0.0),
+    m_max(0.0),
+    m_sum(0.0),
+    m_mean(0.0),
+    m_m2(0.0),
+    m_m3(0.0),
+    m_m4(0.0)
+{
+}
+
+te::attributefill::ZonalStatistics::ZonalStatistics(
+    const te::rst::Raster* raster, const std::vector<unsigned int>& bands,
+    bool histogram, unsigned int maxThreads)
+  : m_raster(raster),
+    m_bands(bands),
+    m_histogram(histogram),
+    m_maxThreads(maxThreads)
+{
+  assert(m_raster);
+}
+
+te::attributefill::ZonalStatistics::~ZonalStatistics()
+{
+}
+
+std::size_t te::attributefill::ZonalStatistics::addZone(
+    const te::gm::Geometry* geom)
+{
+  m_zones.push_back(Zone());
+  m_accumulators.resize(m_accumulators.size() + m_bands.size());
+
+  Zone& zone = m_zones.back();
+  zone.m_firstRow = 0;
+  zone.m_lastRow = -1;
+  zone.m_firstCol = 0;
+  zone.m_lastCol = -1;
+
+  std::vector<const te::gm::Polygon*> polygons;
+
+  if(geom->getGeomTypeId() == te::gm::PolygonType)
+  {
+    polygons.push_back(static_cast<const te::gm::Polygon*>(geom));
+  }
+  else if(geom->getGeomTypeId() == te::gm::MultiPolygonType)
+  {
+    const te::gm::MultiPolygon* mPolygon =
+        static_cast<const te::gm::MultiPolygon*>(geom);
+
+    for(std::size_t i = 0; i < mPolygon->getNumGeometries(); ++i)
+    {
+      const te::gm::Polygon* polygon =
+          dynamic_cast<const te::gm::Polygon*>(mPolygon->getGeometryN(i));
+
+      if(polygon)
+        polygons.push_back(polygon);
+    }
+  }
+
+  const te::rst::Grid* grid = m_raster->getGrid();
+
+  double minCol = std::numeric_limits<double>::max();
+  double maxCol = -std::numeric_limits<double>::max();
+  double minRow = std::numeric_limits<double>::max();
+  double maxRow = -std::numeric_limits<double>::max();
+
+  // the rings of all parts are merged: the scanlines use the even-odd rule
+  for(std::size_t p = 0; p < polygons.size(); ++p)
+  {
+    for(std::size_t r = 0; r < polygons[p]->getNumRings(); ++r)
+    {
+      const te::gm::LinearRing* ring =
+          dynamic_cast<const te::gm::LinearRing*>(polygons[p]->getRingN(r));
+
+      if(ring == 0 || ring->getNPoints() < 2)
+        continue;
+
+      double prevCol = 0.0;
+      double prevRow = 0.0;
+
+      for(std::size_t i = 0; i < ring->getNPoints(); ++i)
+      {
+        double col = 0.0;
+        double row = 0.0;
+
+        grid->geoToGrid(ring->getX(i), ring->getY(i), col, row);
+
+        minCol = std::min(minCol, col);
+        maxCol = std::max(maxCol, col);
+        minRow = std::min(minRow, row);
+        maxRow = std::max(maxRow, row);
+
+        if(i > 0 && row != prevRow)
+        {
+          Edge edge;
+
+          if(prevRow < row)
+          {
+            edge.m_y0 = prevRow;
+            edge.m_y1 = row;
+            edge.m_x0 = prevCol;
+          }
+          else
+          {
+            edge.m_y0 = row;
+            edge.m_y1 = prevRow;
+            edge.m_x0 = col;
+          }
+
+          edge.m_slope = (col - prevCol) / (row - prevRow);
+
+          zone.m_edges.push_back(edge);
+        }
+
+        prevCol = col;
+        prevRow = row;
+      }
+    }
+  }
+
+  // zones smaller than one cell are ignored, as in te::rst::PolygonIterator
+  if(zone.m_edges.empty() || (maxCol - minCol) < 1.0 || (maxRow - minRow) < 1.0)
+  {
+    zone.m_edges.clear();
+    return m_zones.size() - 1;
+  }
+
+  const double nCols = static_cast<double>(m_raster->getNumberOfColumns());
+  const double nRows = static_cast<double>(m_raster->getNumberOfRows());
+
+  zone.m_firstRow = static_cast<int>(std::ceil(std::max(minRow, 0.0)));
+  zone.m_lastRow = static_cast<int>(std::floor(std::min(maxRow, nRows - 1.0)));
+  zone.m_firstCol = static_cast<int>(std::ceil(std::max(minCol, 0.0)));
+  zone.m_lastCol = static_cast<int>(std::floor(std::min(maxCol, nCols - 1.0)));
+
+  std::sort(zone.m_edges.begin(), zone.m_edges.end(), EdgeLess);
+
+  return m_zones.size() - 1;
+}
+
+bool te::attributefill::ZonalStatistics::EdgeLess(const Edge& lhs, const Edge& rhs)
+{
+  return lhs.m_y0 < rhs.m_y0;
+}
+
+std::size_t te::attributefill::ZonalStatistics::getNumberOfZones() const
+{
+  return m_zones.size();
+}
+
+bool te::attributefill::ZonalStatistics::compute(te::common::TaskProgress* task)
+{
+  if(m_zones.empty() || m_bands.empty())
+    return true;
+
+  const unsigned int nCols = m_raster->getNumberOfColumns();
+  const unsigned int nRows = m_raster->getNumberOfRows();
+
+  const te::rst::BandProperty* bandProp =
+      m_raster->getBand(m_bands[0])->getProperty();
+
+  ThreadParams params;
+  params.m_engine = this;
+  params.m_tileWidth = GetTileSize(bandProp->m_blkw, nCols);
+  params.m_tileHeight = GetTileSize(bandProp->m_blkh, nRows);
+  params.m_tilesX = (nCols + params.m_tileWidth - 1) / params.m_tileWidth;
+  params.m_nextTile = 0;
+  params.m_processedTiles = 0;
+  params.m_runningThreads = 0;
+  params.m_abort = false;
+  params.m_failed = false;
+  params.m_task = 0;
+
+  const unsigned int tilesY =
+      (nRows + params.m_tileHeight - 1) / params.m_tileHeight;
+
+  // the zones are distributed to the tiles they may cover
+  params.m_tileZones.resize(params.m_tilesX * tilesY);
+
+  for(std::size_t z = 0; z < m_zones.size(); ++z)
+  {
+    const Zone& zone = m_zones[z];
+
+    if(zone.m_firstRow > zone.m_lastRow || zone.m_firstCol > zone.m_lastCol)
+      continue;
+
+    const unsigned int firstTileX = zone.m_firstCol / params.m_tileWidth;
+    const unsigned int lastTileX = zone.m_lastCol / params.m_tileWidth;
+    const unsigned int firstTileY = zone.m_firstRow / params.m_tileHeight;
+    const unsigned int lastTileY = zone.m_lastRow / params.m_tileHeight;
+
+    for(unsigned int ty = firstTileY; ty <= lastTileY; ++ty)
+    {
+      for(unsigned int tx = firstTileX; tx <= lastTileX; ++tx)
+        params.m_tileZones[ty * params.m_tilesX + tx].push_back(z);
+    }
+  }
+
+  for(std::size_t t = 0; t < params.m_tileZones.size(); ++t)
+  {
+    if(!params.m_tileZones[t].empty())
+      params.m_tiles.push_back(t);
+  }
+
+  unsigned int threadsNumber =
+      m_maxThreads ? m_maxThreads : te::common::GetPhysProcNumber();
+  threadsNumber = std::max(threadsNumber, 1u);
+  threadsNumber = std::min(
+      threadsNumber,
+      static_cast<unsigned int>(std::max(params.m_tiles.size(),
+                                         static_cast<std::size_t>(1))));
+
+  if(threadsNumber == 1)
+  {
+    params.m_task = task;
+    params.m_runningThreads = 1;
+
+    ThreadEntry(&params);
+  }
+  else
+  {
+    params.m_runningThreads = threadsNumber;
+
+    boost::thread_group threads;
+
+    for(unsigned int i = 0; i < threadsNumber; ++i)
+      threads.add_thread(new boost::thread(ThreadEntry, &params));
+
+    // the task is only used by this thread
+    {
+      boost::unique_lock<boost::mutex> lock(params.m_mutex);
+
+      while(params.m_runningThreads)
+      {
+        params.m_condVar.wait(lock);
+
+        if(task && !task->isActive())
+          params.m_abort = true;
+      }
+    }
+
+    threads.join_all();
+  }
+
+  if(params.m_failed)
+    throw te::attributefill::Exception(
+        TE_TR("Could not read the raster values!"));
+
+  return !params.m_abort;
+}
+
+void te::attributefill::ZonalStatistics::getSummary(
+    std::size_t zone, std::size_t band,
+    te::stat::NumericStatisticalSummary& ss) const
+{
+  const Accumulator& acc = m_accumulators[zone * m_bands.size() + band];
+
+  if(acc.m_count == 0)
+    return;
+
+  const double n = static_cast<double>(acc.m_count);
+
+  ss.m_minVal = acc.m_min;
+  ss.m_maxVal = acc.m_max;
+  ss.m_count = static_cast<int>(acc.m_count);
+  ss.m_validCount = static_cast<int>(acc.m_count);
+  ss.m_sum = acc.m_sum;
+  ss.m_mean = acc.m_sum / n;
+
+  if(acc.m_count > 1)
+  {
+    ss.m_variance = acc.m_m2 / (n - 1.0);
+    ss.m_stdDeviation = std::sqrt(ss.m_variance);
+  }
+  else
+  {
+    ss.m_variance = 0.0;
+    ss.m_stdDeviation = 0.0;
+  }
+
+  if(acc.m_count > 2)
+    ss.m_skewness = acc.m_m3 / std::pow(acc.m_m2, 1.5) * (n * std::sqrt(n - 1.0)) / (n - 2.0);
+  else
+    ss.m_skewness = 0.0;
+
+  if(acc.m_count > 3)
+    ss.m_kurtosis = acc.m_m4 / (acc.m_m2 * acc.m_m2) * (n * (n + 1.0) * (n - 1.0)) / ((n - 2.0) * (n - 3.0));
+  else
+    ss.m_kurtosis = 0.0;
+
+  ss.m_varCoeff = (100 * ss.m_stdDeviation) / ss.m_mean;
+  ss.m_amplitude = ss.m_maxVal - ss.m_minVal;
+
+  if(!m_histogram)
+    return;
+
+  // the median is the middle value (or the mean of the two middle values) of the sorted values
+  const std::size_t lower = (acc.m_count - 1) / 2;
+  const std::size_t upper = acc.m_count / 2;
+
+  double lowerValue = 0.0;
+  std::size_t cumulative = 0;
+
+  for(std::map<double, std::size_t>::const_iterator it = acc.m_histogram.begin();
+      it != acc.m_histogram.end(); ++it)
+  {
+    if(cumulative <= lower && lower < cumulative + it->second)
+      lowerValue = it->first;
+
+    cumulative += it->second;
+
+    if(upper < cumulative)
+    {
+      ss.m_median = (lowerValue + it->first) / 2.0;
+      break;
+    }
+  }
+}
+
+void te::attributefill::ZonalStatistics::getMode(
+    std::size_t zone, std::size_t band,
+    te::stat::NumericStatisticalSummary& ss) const
+{
+  assert(m_histogram);
+
+  const Accumulator& acc = m_accumulators[zone * m_bands.size() + band];
+
+  if(acc.m_count == 0)
+    return;
+
+  std::vector<double> mode;
+  std::size_t repeat = 0;
+
+  for(std::map<double, std::size_t>::const_iterator it = acc.m_histogram.begin();
+      it != acc.m_histogram.end(); ++it)
+  {
+    if(it->second < 2)
+      continue;
+
+    if(repeat < it->second)
+    {
+      repeat = it->second;
+      mode.clear();
+      mode.push_back(it->first);
+    }
+    else if(repeat == it->second)
+    {
+      mode.push_back(it->first);
+    }
+  }
+
+  ss.m_mode = mode;
+}
+
+void te::attributefill::ZonalStatistics::getPercentOfEachClass(
+    std::size_t zone, std::size_t band, double resX, double resY, double area,
+    bool fullIntersection, te::stat::NumericStatisticalSummary& ss) const
+{
+  assert(m_histogram);
+
+  const Accumulator& acc = m_accumulators[zone * m_bands.size() + band];
+
+  if(acc.m_count == 0)
+    return;
+
+  std::map<double, double> percentMap;
+
+  for(std::map<double, std::size_t>::const_iterator it = acc.m_histogram.begin();
+      it != acc.m_histogram.end(); ++it)
+  {
+    double percent = 0.0;
+
+    if(fullIntersection)
+      percent = (it->second * 100) / static_cast<double>(acc.m_count);
+    else
+      percent = ((it->second * (resX * resY)) / area) * 100;
+
+    percentMap.insert(std::pair<double, double>(it->first, percent));
+  }
+
+  ss.m_percentEachClass = percentMap;
+}
+
+void te::attributefill::ZonalStatistics::clear()
+{
+  m_zones.clear();
+  m_accumulators.clear();
+}
+
+void te::attributefill::ZonalStatistics::rasterize(
+    const Zone& zone, int firstRow, int lastRow, int firstCol, int lastCol,
+    std::vector<Span>& spans) const
+{
+  std::vector<const Edge*> active;
+  std::vector<double> crossings;
+
+  std::size_t nextEdge = 0;
+
+  for(int row = firstRow; row <= lastRow; ++row)
+  {
+    const double y = static_cast<double>(row);
+
+    // an edge crosses the row center when m_y0 <= y < m_y1
+    while(nextEdge < zone.m_edges.size() && zone.m_edges[nextEdge].m_y0 <= y)
+      active.push_back(&zone.m_edges[nextEdge++]);
+
+    crossings.clear();
+
+    std::size_t nActive = 0;
+
+    for(std::size_t i = 0; i < active.size(); ++i)
+    {
+      const Edge* edge = active[i];
+
+      if(edge->m_y1 <= y)
+        continue;
+
+      active[nActive++] = edge;
+
+      crossings.push_back(edge->m_x0 + (y - edge->m_y0) * edge->m_slope);
+    }
+
+    active.resize(nActive);
+
+    std::sort(crossings.begin(), crossings.end());
+
+    for(std::size_t i = 0; i + 1 < crossings.size(); i += 2)
+    {
+      const double first = std::max(std::ceil(crossings[i]), static_cast<double>(firstCol));
+      const double last = std::min(std::floor(crossings[i + 1]), static_cast<double>(lastCol));
+
+      if(first > last)
+        continue;
+
+      Span span;
+      span.m_row = static_cast<unsigned int>(row);
+      span.m_firstCol = static_cast<unsigned int>(first);
+      span.m_lastCol = static_cast<unsigned int>(last);
+
+      spans.push_back(span);
+    }
+  }
+}
+
+void te::attributefill::ZonalStatistics::accumulate(
+    Accumulator& acc, const std::vector<Span>& spans, std::size_t first,
+    std::size_t last, const double* values, unsigned int tileRow,
+    unsigned int tileCol, unsigned int tileWidth) const
+{
+  for(std::size_t s = first; s < last; ++s)
+  {
+    const Span& span = spans[s];
+
+    const double* rowValues =
+        values + (span.m_row - tileRow) * tileWidth - tileCol;
+
+    for(unsigned int c = span.m_firstCol; c <= span.m_lastCol; ++c)
+    {
+      const double value = rowValues[c];
+
+      if(acc.m_count == 0)
+      {
+        acc.m_min = value;
+        acc.m_max = value;
+      }
+      else if(value < acc.m_min)
+      {
+        acc.m_min = value;
+      }
+      else if(value > acc.m_max)
+      {
+        acc.m_max = value;
+      }
+
+      ++acc.m_count;
+
+      acc.m_sum += value;
+
+      // Welford updates of the central moments (used to variance, std deviation, skewness and kurtosis)
+      const double n = static_cast<double>(acc.m_count);
+      const double delta = value - acc.m_mean;
+      const double deltaN = delta / n;
+      const double deltaN2 = deltaN * deltaN;
+      const double term1 = delta * deltaN * (n - 1.0);
+
+      acc.m_mean += deltaN;
+      acc.m_m4 += term1 * deltaN2 * (n * n - 3.0 * n + 3.0) + 6.0 * deltaN2 * acc.m_m2 - 4.0 * deltaN * acc.m_m3;
+      acc.m_m3 += term1 * deltaN * (n - 2.0) - 3.0 * deltaN * acc.m_m2;
+      acc.m_m2 += term1;
+
+      if(m_histogram)
+        ++acc.m_histogram[value];
+    }
+  }
+}
+
+void te::attributefill::ZonalStatistics::ThreadEntry(ThreadParams* params)
+{
+  ZonalStatistics* engine = params->m_engine;
+
+  const std::size_t nBands = engine->m_bands.size();
+  const unsigned int nCols = engine->m_raster->getNumberOfColumns();
+  const unsigned int nRows = engine->m_raster->getNumberOfRows();
+
+  std::vector<Span> spans;
+  std::vector<std::size_t> zoneSpans;
+  std::vector<double> values;
+
+  try
+  {
+    while(true)
+    {
+      std::size_t tile = 0;
+
+      {
+        boost::lock_guard<boost::mutex> lock(params->m_mutex);
+
+        if(params->m_task && !params->m_task->isActive())
+          params->m_abort = true;
+
+        if(params->m_abort || params->m_nextTile >= params->m_tiles.size())
+          break;
+
+        tile = params->m_tiles[params->m_nextTile++];
+      }
+
+      const unsigned int tileCol = (tile % params->m_tilesX) * params->m_tileWidth;
+      const unsigned int tileRow = (tile / params->m_tilesX) * params->m_tileHeight;
+      const unsigned int tileWidth = std::min(params->m_tileWidth, nCols - tileCol);
+      const unsigned int tileHeight = std::min(params->m_tileHeight, nRows - tileRow);
+
+      const std::vector<std::size_t>& zones = params->m_tileZones[tile];
+
+      // the spans of all zones are computed before reading the tile
+      spans.clear();
+      zoneSpans.clear();
+
+      for(std::size_t i = 0; i < zones.size(); ++i)
+      {
+        const Zone& zone = engine->m_zones[zones[i]];
+
+        zoneSpans.push_back(spans.size());
+
+        engine->rasterize(zone,
+                          std::max(zone.m_firstRow, static_cast<int>(tileRow)),
+                          std::min(zone.m_lastRow, static_cast<int>(tileRow + tileHeight - 1)),
+                          std::max(zone.m_firstCol, static_cast<int>(tileCol)),
+                          std::min(zone.m_lastCol, static_cast<int>(tileCol + tileWidth - 1)),
+                          spans);
+      }
+
+      zoneSpans.push_back(spans.size());
+
+      if(!spans.empty())
+      {
+        values.resize(static_cast<std::size_t>(tileWidth) * tileHeight);
+
+        for(std::size_t b = 0; b < nBands; ++b)
+        {
+          {
+            boost::lock_guard<boost::mutex> lock(params->m_ioMutex);
+
+            engine->m_raster->getBand(engine->m_bands[b])->getValues(
+                tileCol, tileRow, tileWidth, tileHeight, &values[0]);
+          }
+
+          for(std::size_t i = 0; i < zones.size(); ++i)
+          {
+            if(zoneSpans[i] == zoneSpans[i + 1])
+              continue;
+
+            boost::lock_guard<boost::mutex> lock(
+                params->m_zoneMutexes[zones[i] % sg_zoneLocks]);
+
+            engine->accumulate(engine->m_accumulators[zones[i] * nBands + b],
+                               spans, zoneSpans[i], zoneSpans[i + 1],
+                               &values[0], tileRow, tileCol, tileWidth);
+          }
+        }
+      }
+
+      {
+        boost::lock_guard<boost::mutex> lock(params->m_mutex);
+
+        ++params->m_processedTiles;
+      }
+
+      params->m_condVar.notify_one();
+    }
+  }
+  catch(...)
+  {
+    boost::lock_guard<boost::mutex> lock(params->m_mutex);
+
+    params->m_abort = true;
+    params->m_failed = true;
+  }
+
+  {
+    boost::lock_guard<boost::mutex> lock(params->m_mutex);
+
+    --params->m_runningThreads;
+  }
+
+  params->m_condVar.notify_one();
+}
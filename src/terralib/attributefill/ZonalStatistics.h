@@ -0,0 +1,246 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+ \file ZonalStatistics.h
+
+ \brief A streaming engine for the statistics of the raster cells covered by polygons.
+
+ \ingroup attributefill
+ */
+
+#ifndef __TERRALIB_ATTRIBUTEFILL_INTERNAL_ZONAL_STATISTICS_H
+#define __TERRALIB_ATTRIBUTEFILL_INTERNAL_ZONAL_STATISTICS_H
+
+// Terralib
+#include "../statistics/core/NumericStatisticalSummary.h"
+
+#include "Config.h"
+
+// STL
+#include <cstddef>
+#include <map>
+#include <vector>
+
+// Boost
+#include <boost/noncopyable.hpp>
+
+namespace te
+{
+  namespace common
+  {
+    class TaskProgress;
+  }
+
+  namespace gm
+  {
+    class Geometry;
+  }
+
+  namespace rst
+  {
+    class Raster;
+  }
+
+  namespace attributefill
+  {
+    /*!
+      \class ZonalStatistics
+
+      \brief A streaming engine for the statistics of the raster cells covered
+             by polygons (zones).
+
+      A cell belongs to a zone when its center is inside the zone, the same
+      rule used by te::rst::PolygonIterator. Instead of iterating each polygon
+      separately, the zones are rasterized with scanline edge lists, tile by
+      tile, over block aligned tiles of the raster. Each tile of each band is
+      read once, with a single window read, and its values are accumulated
+      into every zone that covers it.
+
+      The statistics are computed in a single pass (Welford updates of the
+      central moments). Modes, medians and the class percentages need the
+      distribution of the values: a histogram of the distinct values of each
+      zone is only kept when it is requested.
+
+      Tiles are processed by a pool of threads. The raster is only accessed by
+      one thread at a time because the raster drivers are not thread safe.
+
+      \note Like te::rst::PolygonIterator, zones smaller than one cell in any
+            direction do not cover any cell.
+
+      \note No-data values are accumulated as any other value.
+     */
+    class TEATTRIBUTEFILLEXPORT ZonalStatistics : public boost::noncopyable
+    {
+     public:
+      /*!
+        \brief Constructor.
+
+        \param raster     The input raster.
+        \param bands      The bands whose statistics will be computed.
+        \param histogram  If true, the distribution of the values is kept to
+                          compute modes, medians and class percentages.
+        \param maxThreads The maximum number of threads (0: the number of
+                          processors).
+       */
+      ZonalStatistics(const te::rst::Raster* raster,
+                      const std::vector<unsigned int>& bands, bool histogram,
+                      unsigned int maxThreads = 0);
+
+      ~ZonalStatistics();
+
+      /*!
+        \brief It adds a zone.
+
+        \param geom A polygon or a multipolygon in the raster SRS. Other
+                    geometries are added as empty zones.
+
+        \return The zone index.
+       */
+      std::size_t addZone(const te::gm::Geometry* geom);
+
+      /*! \brief It returns the number of zones. */
+      std::size_t getNumberOfZones() const;
+
+      /*!
+        \brief It computes the statistics of all zones.
+
+        \param task An optional task used to cancel the computation.
+
+        \return False if the computation was canceled.
+       */
+      bool compute(te::common::TaskProgress* task = 0);
+
+      /*!
+        \brief It returns the statistics of a zone: minimum, maximum, count,
+               sum, mean, variance, standard deviation, skewness, kurtosis,
+               amplitude, coefficient of variation and, if there is a
+               histogram, the median.
+
+        \param zone The zone index.
+        \param band The band index (in the bands given to the constructor).
+        \param ss   The summary to be filled. It is not changed if the zone
+                    doesn't cover any cell.
+       */
+      void getSummary(std::size_t zone, std::size_t band,
+                      te::stat::NumericStatisticalSummary& ss) const;
+
+      /*!
+        \brief It computes the modes of a zone, as te::stat::Mode: the most
+               frequent values that occur more than once.
+
+        \note It requires the histogram.
+       */
+      void getMode(std::size_t zone, std::size_t band,
+                   te::stat::NumericStatisticalSummary& ss) const;
+
+      /*!
+        \brief It computes the percentage of each class in a zone, as
+               te::stat::GetPercentOfEachClassByArea.
+
+        \param zone             The zone index.
+        \param band             The band index.
+        \param resX             The cell width.
+        \param resY             The cell height.
+        \param area             The zone area.
+        \param fullIntersection If true, the percentages are relative to the
+                                number of cells of the zone. Otherwise, to the
+                                zone area.
+        \param ss               The summary to be filled.
+
+        \note It requires the histogram.
+       */
+      void getPercentOfEachClass(std::size_t zone, std::size_t band,
+                                 double resX, double resY, double area,
+                                 bool fullIntersection,
+                                 te::stat::NumericStatisticalSummary& ss) const;
+
+      /*! \brief It removes all zones, to reuse the engine for another batch. */
+      void clear();
+
+     private:
+      /*! \brief A zone edge, in grid coordinates, with m_y0 < m_y1. */
+      struct Edge
+      {
+        double m_y0;
+        double m_y1;
+        double m_x0;     //!< The column at m_y0.
+        double m_slope;  //!< The column increment by row.
+      };
+
+      /*! \brief A zone: its edges sorted by m_y0 and the cells it may cover. */
+      struct Zone
+      {
+        std::vector<Edge> m_edges;
+        int m_firstRow;
+        int m_lastRow;
+        int m_firstCol;
+        int m_lastCol;
+      };
+
+      /*! \brief The running statistics of a band in a zone. */
+      struct Accumulator
+      {
+        Accumulator();
+
+        std::size_t m_count;
+        double m_min;
+        double m_max;
+        double m_sum;
+        double m_mean;
+        double m_m2;
+        double m_m3;
+        double m_m4;
+        std::map<double, std::size_t> m_histogram;
+      };
+
+      /*! \brief A horizontal run of cells covered by a zone. */
+      struct Span
+      {
+        unsigned int m_row;
+        unsigned int m_firstCol;
+        unsigned int m_lastCol;
+      };
+
+      struct ThreadParams;
+
+      /*! \brief It computes the spans of a zone inside the tile. */
+      void rasterize(const Zone& zone, int firstRow, int lastRow, int firstCol,
+                     int lastCol, std::vector<Span>& spans) const;
+
+      /*! \brief It accumulates the values of the tile cells covered by spans. */
+      void accumulate(Accumulator& acc, const std::vector<Span>& spans,
+                      std::size_t first, std::size_t last, const double* values,
+                      unsigned int tileRow, unsigned int tileCol,
+                      unsigned int tileWidth) const;
+
+      static bool EdgeLess(const Edge& lhs, const Edge& rhs);
+
+      static void ThreadEntry(ThreadParams* params);
+
+      const te::rst::Raster* m_raster;
+      std::vector<unsigned int> m_bands;
+      bool m_histogram;
+      unsigned int m_maxThreads;
+      std::vector<Zone> m_zones;
+      std::vector<Accumulator> m_accumulators;  //!< The accumulators of each zone, band by band.
+    };
+  }
+}
+#endif  // __TERRALIB_ATTRIBUTEFILL_INTERNAL_ZONAL_STATISTICS_H
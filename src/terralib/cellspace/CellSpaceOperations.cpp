@@ -25,23 +25,83 @@
 
 // Terralib
 #include "../common/progress/TaskProgress.h"
+#include "../core/translator/Translator.h"
 #include "../dataaccess.h"
 #include "../datatype/SimpleProperty.h"
 #include "../datatype/StringProperty.h"
 #include "../geometry/Envelope.h"
 #include "../geometry/GeometryProperty.h"
+#include "../geometry/MultiSurface.h"
 #include "../geometry/Point.h"
 #include "../geometry/Polygon.h"
+#include "../geometry/Surface.h"
+#include "../geometry/Utils.h"
 #include "../maptools/DataSetLayer.h"
 #include "../memory/DataSet.h"
 #include "../memory/DataSetItem.h"
-#include "../raster.h"
-#include "../sam.h"
+#include "../raster/Grid.h"
+#include "../raster/Rasterizer.h"
+#include "../sam/rtree/Index.h"
 #include "CellSpaceOperations.h"
 
 #include <stdio.h>
 
-const int BLOCKSIZE = 10000;
+#include <algorithm>
+
+// Boost
+#include <boost/ptr_container/ptr_vector.hpp>
+
+const std::size_t BLOCKSIZE = 10000;
+
+const int MASKSTRIPROWS = 256;
+
+struct te::cellspace::CellularSpacesOperations::Mask
+{
+  std::auto_ptr<te::rst::Rasterizer> m_touched;  //!< It counts the geometries that touch each cell.
+  std::auto_ptr<te::rst::Rasterizer> m_centers;  //!< It counts the polygons that contain each cell center (point cells only).
+  boost::ptr_vector<te::gm::Geometry> m_geoms;   //!< The layer geometries, in the cell space SRS.
+  te::sam::rtree::Index<std::size_t, 8> m_rtree; //!< The index of the layer geometries.
+};
+
+namespace
+{
+  /*!
+    \brief It classifies a cell by the mask values of its 3x3 neighborhood.
+
+    \param touched The strip of touched cells counts.
+    \param inside  The strip of counts that tells if the cell is inside the geometries.
+    \param row     The cell row in the strip.
+    \param col     The cell column in the strip.
+    \param ncols   The number of columns of the strip.
+
+    \return 1 if the cell intersects the geometries, 0 if it doesn't and -1 if it must be tested.
+  */
+  int ClassifyCell(const std::vector<double>& touched, const std::vector<double>& inside,
+                   int row, int col, int ncols)
+  {
+    bool any = false;
+    bool all = true;
+
+    for(int r = row - 1; r <= row + 1; ++r)
+    {
+      for(int c = col - 1; c <= col + 1; ++c)
+      {
+        if(touched[(std::size_t)r * ncols + c] != 0.0)
+          any = true;
+        else
+          all = false;
+      }
+    }
+
+    if(!any)
+      return 0;
+
+    if(all && inside[(std::size_t)row * ncols + col] != 0.0)
+      return 1;
+
+    return -1;
+  }
+}
 
 te::cellspace::CellularSpacesOperations::CellularSpacesOperations()
 {
@@ -65,10 +125,8 @@ void te::cellspace::CellularSpacesOperations::createCellSpace(te::da::DataSource
       maxrows = (int)ceil((env.m_ury-env.m_lly)/resY);
 
   bool useMask = false;
-  std::auto_ptr<te::da::DataSet> refDs;
   if(layerBase.get())
   {
-    refDs = layerBase->getData();
     useMask=true;
 
     if (layerBase->getSchema()->hasRaster())
@@ -79,9 +137,13 @@ void te::cellspace::CellularSpacesOperations::createCellSpace(te::da::DataSource
 
   std::auto_ptr<te::da::DataSetType> outputDataSetType(createCellularDataSetType(name, srid, type));
 
-  std::auto_ptr<te::sam::rtree::Index<size_t, 8> > rtree;
+  // A cell is kept when its geometry intersects the mask geometries. The mask is rasterized
+  // on the cells grid: a cell far from the geometries boundaries is decided by the mask
+  // values of its neighborhood, the other ones are tested against the geometries.
+  // The grid rows grow to south, the cell space lines grow to north.
+  Mask mask;
   if(useMask)
-    rtree.reset(getRtree(layerBase));
+    getMask(layerBase, resX, resY, env, maxcols, maxrows, srid, type, mask);
 
   te::common::TaskProgress task("Processing Cellular Spaces...");
   task.setTotalSteps(maxrows);
@@ -95,7 +157,14 @@ void te::cellspace::CellularSpacesOperations::createCellSpace(te::da::DataSource
 
   std::map<std::string, std::string> options;
 
-  std::size_t count = 0;
+  source->createDataSet(outputDataSetType.get(), options);
+
+  const int maskCols = maxcols + 2;
+
+  std::vector<double> touchedValues;
+  std::vector<double> centerValues;
+  std::vector<double*> maskBuffers;
+  int firstMaskRow = 0;
 
   double x, y;
   for(int lin = 0; lin < maxrows; ++lin)
@@ -105,65 +174,66 @@ void te::cellspace::CellularSpacesOperations::createCellSpace(te::da::DataSource
       throw te::common::Exception(TE_TR("Operation canceled!"));
     }
 
+    // Rasterize the mask strip that starts at the current line, plus the rows around it
+    if(useMask && (lin % MASKSTRIPROWS) == 0)
+    {
+      const int maskLines = std::min(MASKSTRIPROWS, maxrows - lin) + 2;
+
+      firstMaskRow = maxrows - lin - maskLines + 2;
+
+      touchedValues.resize((std::size_t)maskLines * maskCols);
+      maskBuffers.assign(1, &touchedValues[0]);
+
+      if(!mask.m_touched->rasterize(firstMaskRow, maskLines, maskBuffers, 0.0, &task))
+        throw te::common::Exception(TE_TR("Operation canceled!"));
+
+      if(type == CELLSPACE_POINTS)
+      {
+        centerValues.resize((std::size_t)maskLines * maskCols);
+        maskBuffers.assign(1, &centerValues[0]);
+
+        if(!mask.m_centers->rasterize(firstMaskRow, maskLines, maskBuffers, 0.0, &task))
+          throw te::common::Exception(TE_TR("Operation canceled!"));
+      }
+    }
+
+    const int maskRow = maxrows - lin - firstMaskRow;
+
     y = env.m_lly+(lin*resY);
     for(int col = 0; col < maxcols; ++col)
     {
+      int status = 1;
+      if(useMask)
+      {
+        status = ClassifyCell(touchedValues, (type == CELLSPACE_POINTS) ? centerValues : touchedValues,
+                              maskRow, col + 1, maskCols);
+
+        if(status == 0)
+          continue;
+      }
+
       x = env.m_llx+(col*resX);
 
-      te::gm::Envelope* env = new te::gm::Envelope(x, y, x+resX, y+resY);
+      te::gm::Envelope cell(x, y, x+resX, y+resY);
 
       std::auto_ptr<te::gm::Geometry> geom;
       if(type == CELLSPACE_POLYGONS)
       {
-        geom.reset(te::gm::GetGeomFromEnvelope(env, srid));
+        geom.reset(te::gm::GetGeomFromEnvelope(&cell, srid));
       }
       else if(type == CELLSPACE_POINTS)
       {
-        double pX = env->m_llx +( (env->m_urx - env->m_llx) / 2);
-        double pY = env->m_lly +( (env->m_ury - env->m_lly) / 2);
+        double pX = cell.m_llx +( (cell.m_urx - cell.m_llx) / 2);
+        double pY = cell.m_lly +( (cell.m_ury - cell.m_lly) / 2);
         geom.reset(new te::gm::Point(pX, pY, srid));
       }
-      
-      if(useMask)
-      {
-        std::vector<size_t> report;
-        rtree->search(*geom->getMBR(), report);
-
-        std::size_t geomPos = te::da::GetFirstSpatialPropertyPos(refDs.get());
-
-        if(!report.empty())
-        {
-          for(std::size_t i = 0; i < report.size(); ++i)
-          {
-            refDs->move(report[i]);
-
-            std::auto_ptr<te::gm::Geometry> g = refDs->getGeometry(geomPos);
-            g->setSRID(srid);
-
-            if(geom->intersects(g.get()))
-            {
-              addCell(outputDataSet, col, lin, geom.release());
-              break;
-            }
-          }
-        }
-      }
-      else
-      {
-        addCell(outputDataSet, col, lin, geom.release());
-      }
 
-      if (count == 0)
-      {
-        source->createDataSet(outputDataSetType.get(), options);
-        source->add(outputDataSetType->getName(), outputDataSet, options);
-
-        delete outputDataSet;
+      if(status < 0 && !intersects(mask, geom.get()))
+        continue;
 
-        outputDataSet = new te::mem::DataSet(outputDataSetType.get());
-      }
+      addCell(outputDataSet, col, lin, geom.release());
 
-      if ((count / BLOCKSIZE) >= 1)
+      if (outputDataSet->size() >= BLOCKSIZE)
       {
         source->add(outputDataSetType->getName(), outputDataSet, options);
 
@@ -171,8 +241,6 @@ void te::cellspace::CellularSpacesOperations::createCellSpace(te::da::DataSource
 
         outputDataSet = new te::mem::DataSet(outputDataSetType.get());
       }
-
-      ++count;
     }
 
     task.pulse();
@@ -201,9 +269,22 @@ void te::cellspace::CellularSpacesOperations::addCell(te::mem::DataSet* ds, int
   ds->add(item);
 }
 
-te::sam::rtree::Index<size_t, 8>* te::cellspace::CellularSpacesOperations::getRtree(te::map::AbstractLayerPtr layerBase)
+void te::cellspace::CellularSpacesOperations::getMask(te::map::AbstractLayerPtr layerBase,
+                                                      double resX, double resY,
+                                                      const te::gm::Envelope& env,
+                                                      int maxcols, int maxrows,
+                                                      int srid, CellSpaceType type,
+                                                      Mask& mask)
 {
-  te::sam::rtree::Index<size_t, 8>* rtree = new te::sam::rtree::Index<size_t, 8>;
+  // The cells grid plus a border of one cell
+  te::gm::Coord2D ulc(env.m_llx - resX, env.m_lly + (maxrows + 1) * resY);
+
+  te::rst::Grid grid((unsigned int)maxcols + 2, (unsigned int)maxrows + 2, resX, resY, &ulc, srid);
+
+  mask.m_touched.reset(new te::rst::Rasterizer(grid, te::rst::Rasterizer::MergeCount, true));
+
+  if(type == CELLSPACE_POINTS)
+    mask.m_centers.reset(new te::rst::Rasterizer(grid, te::rst::Rasterizer::MergeCount, false));
 
   std::auto_ptr<te::da::DataSet> ds = layerBase->getData();
 
@@ -211,18 +292,36 @@ te::sam::rtree::Index<size_t, 8>* te::cellspace::CellularSpacesOperations::getRt
 
   ds->moveBeforeFirst();
 
-  int count = 0;
-
   while(ds->moveNext())
   {
     std::auto_ptr<te::gm::Geometry> geom = ds->getGeometry(geomPos);
+    geom->setSRID(srid);
+
+    mask.m_touched->add(geom.get(), 1.0);
 
-    rtree->insert(*geom->getMBR(), count);
+    // Lines and points rarely contain a cell center: the point cells near them are always tested
+    if(mask.m_centers.get() &&
+       (dynamic_cast<te::gm::Surface*>(geom.get()) || dynamic_cast<te::gm::MultiSurface*>(geom.get())))
+      mask.m_centers->add(geom.get(), 1.0);
 
-    ++count;
+    mask.m_rtree.insert(*geom->getMBR(), mask.m_geoms.size());
+
+    mask.m_geoms.push_back(geom.release());
+  }
+}
+
+bool te::cellspace::CellularSpacesOperations::intersects(const Mask& mask, const te::gm::Geometry* cell)
+{
+  std::vector<std::size_t> report;
+  mask.m_rtree.search(*cell->getMBR(), report);
+
+  for(std::size_t i = 0; i < report.size(); ++i)
+  {
+    if(cell->intersects(&mask.m_geoms[report[i]]))
+      return true;
   }
 
-  return rtree;
+  return false;
 }
 
 te::da::DataSetType* te::cellspace::CellularSpacesOperations::createCellularDataSetType(const std::string& name, int srid, CellSpaceType type)
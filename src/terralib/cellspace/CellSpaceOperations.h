@@ -88,6 +88,9 @@ namespace te
           \param env       The bouding box of the cell space.
           \param srid      The spatial reference for the bouding box.
           \param type      The type of cell space to be created.
+          \param layerBase An optional mask layer: if informed, only the cells that intersect
+                           its geometries are created (the cell polygons or the cell centers,
+                           boundaries included).
         */
         void createCellSpace(te::da::DataSourceInfoPtr outputSource,
                              const std::string& name,
@@ -109,14 +112,41 @@ namespace te
         */
         void addCell(te::mem::DataSet* ds, int col, int row, te::gm::Geometry* geom);
 
+        /*! \brief The layer geometries, indexed and rasterized on the cells grid. */
+        struct Mask;
+
         /*!
-          \brief Get a RTree with the geometries envelopes of layer.
+          \brief Get the mask of the layer geometries on the cells grid.
+
+          The geometries are rasterized on the cells grid plus a border of one cell,
+          so that the cells near the geometries boundaries can be found.
 
           \param layerBase Layer base.
+          \param resX      Cells resolution in X-dimension.
+          \param resY      Cells resolution in Y-dimension.
+          \param env       The bouding box of the cell space.
+          \param maxcols   The number of columns of the cell space.
+          \param maxrows   The number of lines of the cell space.
+          \param srid      The spatial reference for the bouding box.
+          \param type      The type of cell space to be created.
+          \param mask      The mask to be filled.
+        */
+        void getMask(te::map::AbstractLayerPtr layerBase,
+                     double resX, double resY,
+                     const te::gm::Envelope& env,
+                     int maxcols, int maxrows,
+                     int srid, CellSpaceType type,
+                     Mask& mask);
+
+        /*!
+          \brief It tells if a cell geometry intersects any of the mask geometries.
+
+          \param mask The mask.
+          \param cell The cell geometry.
 
-          \return The RTree created.
+          \return True if the cell geometry intersects any of the mask geometries.
         */
-        te::sam::rtree::Index<size_t, 8>* getRtree(te::map::AbstractLayerPtr layerBase);
+        bool intersects(const Mask& mask, const te::gm::Geometry* cell);
 
         /*!
           \brief Create the DataSetType of the cellular space.
@@ -63,6 +63,13 @@
 */
 #define TERRALIB_POOL_DEFAULT_MONITORING_TIME 60
 
+/*!
+  \def TERRALIB_BULK_INSERT_MIN_SIZE
+
+  \brief This sets the minimum number of items for te::da::Create to ask the data source driver for its bulk insert path (BULK_INSERT option).
+*/
+#define TERRALIB_BULK_INSERT_MIN_SIZE 10000
+
 //@}
 
 /** @name DLL/LIB Module
@@ -127,6 +127,11 @@ std::auto_ptr<te::gm::Geometry> te::da::DataSet::getGeometry(const std::string&
   return getGeometry(i);
 }
 
+bool te::da::DataSet::getGeometryView(std::size_t /*i*/, te::gm::WKBView& /*view*/) const
+{
+  return false;
+}
+
 std::auto_ptr<te::rst::Raster> te::da::DataSet::getRaster(const std::string& name) const
 {
   std::size_t i = GetPropertyPos(this, name);
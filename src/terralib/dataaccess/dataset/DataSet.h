@@ -58,6 +58,7 @@ namespace te
   {
     class Envelope;
     class Geometry;
+    class WKBView;
   }
 
   namespace da
@@ -532,6 +533,22 @@ namespace te
         */
         virtual std::auto_ptr<te::gm::Geometry> getGeometry(const std::string& name) const;
 
+        /*!
+          \brief Method for decoding a geometric attribute value into a lightweight view.
+
+          Drivers that keep geometries as WKB (or EWKB) can implement this method
+          to avoid building a te::gm::Geometry for each row. The view contents are
+          replaced, so the same view can be reused during the whole traversal.
+
+          \param i    The attribute index.
+          \param view The view that will receive the geometry coordinates. If the value is null the view is cleared.
+
+          \return True if the driver filled the view, false if the caller must use getGeometry instead.
+
+          \note The default implementation returns false.
+        */
+        virtual bool getGeometryView(std::size_t i, te::gm::WKBView& view) const;
+
         /*!
           \brief Method for retrieving a raster attribute value.
 
@@ -641,6 +641,30 @@ void te::da::Create(DataSource* ds,
 {
   ds->createDataSet(dt, options);
 
+// large datasets are loaded through the driver bulk insert path, if it has one.
+// The size is only asked to random datasets, where it is already known: a forward-only one
+// (e.g. a server-side cursor) may have to scan or count the whole source to answer it.
+  std::size_t nitems = std::string::npos;
+
+  if(d->getTraverseType() == te::common::RANDOM)
+  {
+    nitems = d->size();
+
+    if((limit != 0) && (limit < nitems))
+      nitems = limit;
+  }
+
+  if((nitems != std::string::npos) && (nitems >= TERRALIB_BULK_INSERT_MIN_SIZE) && (options.find("BULK_INSERT") == options.end()))
+  {
+    std::map<std::string, std::string> bulkOptions(options);
+
+    bulkOptions["BULK_INSERT"] = "TRUE";
+
+    ds->add(dt->getName(), d, bulkOptions, limit);
+
+    return;
+  }
+
   ds->add(dt->getName(), d, options, limit);
 }
 
@@ -273,6 +273,11 @@ namespace te
       \note DataSetPersistence will start reading the dataset 'd' in the
             current position. So, keep in mind that it is the caller responsability
             to inform the dataset 'd' in the right position (and a valid one) to start processing it.
+
+      \note If the dataset 'd' has a random traversal and the number of items to be saved reaches
+            TERRALIB_BULK_INSERT_MIN_SIZE, the BULK_INSERT option is set to "TRUE" (unless already informed),
+            so that drivers with a bulk load path (e.g. PostGIS COPY) can use it. For forward-only datasets
+            the size is not queried and the bulk path is left to the given options.
     */
     TEDATAACCESSEXPORT void Create(DataSource* ds,
                                    DataSetType* dt,
@@ -87,31 +87,29 @@ bool te::edit::SnapVertex::search(const te::gm::Envelope& e, te::gm::Coord2D& re
 {
   assert(e.isValid());
 
-  std::vector<std::size_t> report;
-  m_rtree.search(e, report);
-
-  if(report.empty())
-    return false;
+  // Finds the coordinates around the envelope center, sorted by distance
+  te::gm::Coord2D center = e.getCenter();
+  double maxDistance = GetDistance(center, e.getUpperRight());
 
-  std::size_t snappedPos = report[0];
+  std::vector<std::size_t> report;
+  std::vector<double> distances;
+  m_rtree.withinDistanceSearch(te::gm::Envelope(center.x, center.y, center.x, center.y), maxDistance, report, distances);
 
-  if(report.size() > 1)
+  // The nearest coordinate inside the search envelope
+  std::size_t i = 0;
+  for(; i < report.size(); ++i)
   {
-    // Finds the nearest coordinate
-    te::gm::Coord2D center = e.getCenter();
-    double minDistance = std::numeric_limits<double>::max();
-    for(std::size_t i = 1; i < report.size(); ++i)
-    {
-      const te::gm::Coord2D& foundCoord = m_coords[report[i]];
-      double distance = GetDistance(center, foundCoord);
-      if(distance < minDistance)
-      {
-        minDistance = distance;
-        snappedPos = report[i];
-      }
-    }
+    const te::gm::Coord2D& foundCoord = m_coords[report[i]];
+
+    if(foundCoord.x >= e.m_llx && foundCoord.x <= e.m_urx && foundCoord.y >= e.m_lly && foundCoord.y <= e.m_ury)
+      break;
   }
 
+  if(i == report.size())
+    return false;
+
+  std::size_t snappedPos = report[i];
+
   assert(snappedPos < m_coords.size());
 
   // Gets the snapped coordinate
@@ -35,6 +35,7 @@
 // STL
 #include <cassert>
 #include <limits>
+#include <vector>
 
 // GDAL
 #include <gdal_priv.h>
@@ -192,6 +193,61 @@ void te::gdal::Band::write(int x, int y, void* buffer)
   m_rasterBand->WriteBlock(x, y, buffer);
 }
 
+void te::gdal::Band::getValues(unsigned int c, unsigned int r, unsigned int ncols, unsigned int nrows, double* values) const
+{
+  if (m_update_buffer)
+  {
+    m_rasterBand->WriteBlock(m_x, m_y, m_buffer);
+
+    m_update_buffer = false;
+  }
+
+// GDAL reads the window in the band data type and the values are converted as in getValue
+  const std::size_t npixels = static_cast<std::size_t>(ncols) * nrows;
+
+  std::vector<unsigned char> buffer(npixels * (GDALGetDataTypeSize(m_gdaltype) / 8));
+
+  if (m_rasterBand->RasterIO(GF_Read, (int)c, (int)r, (int)ncols, (int)nrows,
+                             buffer.data(), (int)ncols, (int)nrows, m_gdaltype, 0, 0) != CE_None)
+    throw Exception(TE_TR("Could not read the band window!"));
+
+  for (std::size_t i = 0; i < npixels; ++i)
+    m_getBuff((int)i, buffer.data(), &values[i]);
+}
+
+void te::gdal::Band::setValues(unsigned int c, unsigned int r, unsigned int ncols, unsigned int nrows, const double* values)
+{
+  if (m_update_buffer)
+  {
+    m_rasterBand->WriteBlock(m_x, m_y, m_buffer);
+
+    m_update_buffer = false;
+  }
+
+// the values are converted as in setValue and GDAL writes the window in the band data type
+  const std::size_t npixels = static_cast<std::size_t>(ncols) * nrows;
+
+  std::vector<unsigned char> buffer(npixels * (GDALGetDataTypeSize(m_gdaltype) / 8));
+
+// only the real parts are set: the imaginary parts of complex bands are preserved
+  if (GDALDataTypeIsComplex(m_gdaltype) &&
+      m_rasterBand->RasterIO(GF_Read, (int)c, (int)r, (int)ncols, (int)nrows,
+                             buffer.data(), (int)ncols, (int)nrows, m_gdaltype, 0, 0) != CE_None)
+    throw Exception(TE_TR("Could not read the band window!"));
+
+  for (std::size_t i = 0; i < npixels; ++i)
+    m_setBuff((int)i, buffer.data(), &values[i]);
+
+  if (m_rasterBand->RasterIO(GF_Write, (int)c, (int)r, (int)ncols, (int)nrows,
+                             buffer.data(), (int)ncols, (int)nrows, m_gdaltype, 0, 0) != CE_None)
+    throw Exception(TE_TR("Could not write the band window!"));
+
+// the buffered block may be out of date now
+  m_x = std::numeric_limits<int>::max();
+
+  m_y = std::numeric_limits<int>::max();
+}
+
 int te::gdal::Band::placeBuffer(unsigned c, unsigned r) const
 {
   assert(c >= 0 && c < m_raster->getNumberOfColumns());
@@ -102,6 +102,10 @@ namespace te
       
       void write(int x, int y, void* buffer);
       
+      void getValues(unsigned int c, unsigned int r, unsigned int ncols, unsigned int nrows, double* values) const;
+      
+      void setValues(unsigned int c, unsigned int r, unsigned int ncols, unsigned int nrows, const double* values);
+      
       void getValueFromBlock(void* block, unsigned int pos, std::complex<double>& value) const;
       
       void getValueFromBlock(void* block, unsigned int pos, double& value) const;
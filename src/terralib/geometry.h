@@ -80,6 +80,7 @@
 #include "geometry/Visitor.h"
 #include "geometry/WKBReader.h"
 #include "geometry/WKBSize.h"
+#include "geometry/WKBView.h"
 #include "geometry/WKBWriter.h"
 #include "geometry/WKTReader.h"
 #include "geometry/WKTWriter.h"
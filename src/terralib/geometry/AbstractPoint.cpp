@@ -28,6 +28,7 @@
 #include "../Defines.h"
 #include "../core/translator/Translator.h"
 #include "../srs/Converter.h"
+#include "../srs/ConverterCache.h"
 #include "AbstractPoint.h"
 #include "Envelope.h"
 #include "Exception.h"
@@ -77,10 +78,7 @@ void te::gm::AbstractPoint::transform(int srid) throw(te::common::Exception)
   if(srid == m_srid)
     return;
 
-  std::auto_ptr<te::srs::Converter> converter(new te::srs::Converter());
-
-  converter->setSourceSRID(m_srid);
-  converter->setTargetSRID(srid);
+  boost::shared_ptr<te::srs::Converter> converter = te::srs::ConverterCache::getInstance().get(m_srid, srid);
 
   double x = getX();
   double y = getY();
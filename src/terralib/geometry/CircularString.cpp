@@ -27,6 +27,7 @@
 #include "../BuildConfig.h"
 #include "../core/translator/Translator.h"
 #include "../srs/Converter.h"
+#include "../srs/ConverterCache.h"
 #include "Coord2D.h"
 #include "Envelope.h"
 #include "Exception.h"
@@ -112,15 +113,14 @@ void te::gm::CircularString::transform(int srid) throw(te::common::Exception)
   if(srid == m_srid)
     return;
 
-  std::auto_ptr<te::srs::Converter> converter(new te::srs::Converter());
+  boost::shared_ptr<te::srs::Converter> converter = te::srs::ConverterCache::getInstance().get(getSRID(), srid);
 
-  converter->setSourceSRID(getSRID());
-
-  converter->setTargetSRID(srid);
-
-  double* pt = (double*)(&m_coords);
+  if(!m_coords.empty())
+  {
+    double* pt = (double*)(&m_coords[0]);
 
-  converter->convert(pt, &(pt[1]), static_cast<long>(size()), 2);
+    converter->convert(pt, &(pt[1]), static_cast<long>(size()), 2);
+  }
 
   if(m_mbr)
     computeMBR(false);
@@ -34,6 +34,7 @@
 #include "Envelope.h"
 #include "GEOSWriter.h"
 #include "Point.h"
+#include "Utils.h"
 
 #ifdef TERRALIB_GEOS_ENABLED
 // GEOS
@@ -243,15 +244,8 @@ void te::gm::CurvePolygon::transform(int srid) throw(te::common::Exception)
   if(srid == m_srid)
     return;
 
-  std::size_t n = m_rings.size();
-
-  for(std::size_t i = 0; i < n; ++i)
-    m_rings[i]->transform(srid);
-
-  if(m_mbr)
-    computeMBR(true);  // just update the polygon MBR
-
-  m_srid = srid;
+// the coordinates of all rings are converted together
+  Transform(std::vector<Geometry*>(1, this), srid);
 #else
   throw Exception(TE_TR("transform method is not supported!"));
 #endif // TERRALIB_MOD_SRS_ENABLED
@@ -28,6 +28,7 @@
 #include "../common/Exception.h"
 #include "../core/translator/Translator.h"
 #include "../srs/Converter.h"
+#include "../srs/ConverterCache.h"
 #include "Coord2D.h"
 #include "Envelope.h"
 #include "Exception.h"
@@ -95,12 +96,11 @@ void te::gm::Envelope::transform(int oldsrid, int newsrid)
   if(oldsrid == newsrid)
     return;
 
-  std::auto_ptr<te::srs::Converter> converter(new te::srs::Converter());
+  boost::shared_ptr<te::srs::Converter> converter;
   
   try
   {
-    converter->setSourceSRID(oldsrid);
-    converter->setTargetSRID(newsrid);
+    converter = te::srs::ConverterCache::getInstance().get(oldsrid, newsrid);
   }
   catch (te::common::Exception& /* ex */)
   {
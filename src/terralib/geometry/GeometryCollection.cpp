@@ -30,6 +30,7 @@
 #include "Envelope.h"
 #include "Exception.h"
 #include "GeometryCollection.h"
+#include "Utils.h"
 
 // STL
 #include <cassert>
@@ -110,15 +111,8 @@ void te::gm::GeometryCollection::transform(int srid) throw(te::common::Exception
   if(srid == m_srid)
     return;
 
-  std::size_t nGeoms = m_geometries.size();
-
-  for(std::size_t i = 0; i < nGeoms; ++i)
-    m_geometries[i]->transform(srid);
-
-  m_srid = srid;
-
-  if(m_mbr)
-    computeMBR(false);  // the above transform will do the job for the parts, so don't compute mbr again!
+// the coordinates of all parts are converted together
+  Transform(std::vector<Geometry*>(1, this), srid);
 #else
   throw Exception(TE_TR("transform method is not supported!"));
 #endif // TERRALIB_MOD_SRS_ENABLED
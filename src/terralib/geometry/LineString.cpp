@@ -27,6 +27,7 @@
 #include "../BuildConfig.h"
 #include "../core/translator/Translator.h"
 #include "../srs/Converter.h"
+#include "../srs/ConverterCache.h"
 #include "Config.h"
 #include "Coord2D.h"
 #include "Envelope.h"
@@ -184,11 +185,7 @@ void te::gm::LineString::transform(int srid) throw(te::common::Exception)
   if(srid == m_srid)
     return;
 
-  std::auto_ptr<te::srs::Converter> converter(new te::srs::Converter());
-
-  converter->setSourceSRID(getSRID());
-
-  converter->setTargetSRID(srid);
+  boost::shared_ptr<te::srs::Converter> converter = te::srs::ConverterCache::getInstance().get(getSRID(), srid);
 
   double* pt = (double*)(m_coords);
 
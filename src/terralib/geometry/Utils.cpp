@@ -24,7 +24,12 @@
 */
 
 // TerraLib
+#include "../BuildConfig.h"
 #include "../core/translator/Translator.h"
+#include "../srs/Converter.h"
+#include "../srs/ConverterCache.h"
+#include "AbstractPoint.h"
+#include "CurvePolygon.h"
 #include "Envelope.h"
 #include "Exception.h"
 #include "Geometry.h"
@@ -41,7 +46,9 @@
 #include "Utils.h"
 
 // STL
+#include <algorithm>
 #include <cmath>
+#include <map>
 
 #ifdef TERRALIB_GEOS_ENABLED
 // GEOS
@@ -707,3 +714,223 @@ te::gm::Geometry* te::gm::SnapToSelf( const te::gm::Geometry* g,
   throw Exception(TE_TR("SnapToSelf routine is supported by GEOS! Please, enable the GEOS support."));
 #endif
 }
+
+std::size_t te::gm::Decimate(Coord2D* coords, std::size_t n, double tolerance)
+{
+  if(n < 3)
+    return n;
+
+  const double tol2 = tolerance * tolerance;
+
+  std::size_t kept = 1;
+
+  for(std::size_t i = 1; i < n - 1; ++i)
+  {
+    const double dx = coords[i].x - coords[kept - 1].x;
+    const double dy = coords[i].y - coords[kept - 1].y;
+
+    if(dx * dx + dy * dy >= tol2)
+      coords[kept++] = coords[i];
+  }
+
+// the last coordinate replaces the last kept one if they are too close
+  if(kept > 1)
+  {
+    const double dx = coords[n - 1].x - coords[kept - 1].x;
+    const double dy = coords[n - 1].y - coords[kept - 1].y;
+
+    if(dx * dx + dy * dy < tol2)
+      --kept;
+  }
+
+  coords[kept++] = coords[n - 1];
+
+  return kept;
+}
+
+void te::gm::Decimate(Geometry* g, double tolerance)
+{
+  LineString* l = dynamic_cast<LineString*>(g);
+
+  if(l != 0)
+  {
+    if(l->getZ() != 0 || l->getM() != 0)
+      return;
+
+    l->setNumCoordinates(Decimate(l->getCoordinates(), l->getNPoints(), tolerance));
+
+    return;
+  }
+
+  Polygon* p = dynamic_cast<Polygon*>(g);
+
+  if(p != 0)
+  {
+    const std::size_t nRings = p->getNumRings();
+
+    for(std::size_t i = 0; i < nRings; ++i)
+      Decimate(p->getRingN(i), tolerance);
+
+    return;
+  }
+
+  GeometryCollection* gc = dynamic_cast<GeometryCollection*>(g);
+
+  if(gc != 0)
+  {
+    const std::size_t nGeoms = gc->getNumGeometries();
+
+    for(std::size_t i = 0; i < nGeoms; ++i)
+      Decimate(gc->getGeometryN(i), tolerance);
+  }
+}
+
+namespace
+{
+  /*! \brief The parts of the geometries with the same SRS, whose coordinates are converted together. */
+  struct TransformGroup
+  {
+    std::vector<te::gm::Geometry*> m_geoms;         //!< The geometries.
+    std::vector<te::gm::LineString*> m_lines;       //!< Their lines and rings.
+    std::vector<te::gm::AbstractPoint*> m_points;   //!< Their points.
+    std::vector<te::gm::Geometry*> m_others;        //!< Their parts that are converted one by one.
+    std::size_t m_nCoords;                          //!< The number of coordinates of lines and points.
+  };
+
+  void GatherParts(te::gm::Geometry* g, TransformGroup& group)
+  {
+    te::gm::LineString* l = dynamic_cast<te::gm::LineString*>(g);
+
+    if(l != 0)
+    {
+      group.m_lines.push_back(l);
+      group.m_nCoords += l->size();
+      return;
+    }
+
+    te::gm::AbstractPoint* pt = dynamic_cast<te::gm::AbstractPoint*>(g);
+
+    if(pt != 0)
+    {
+      group.m_points.push_back(pt);
+      ++group.m_nCoords;
+      return;
+    }
+
+    te::gm::CurvePolygon* p = dynamic_cast<te::gm::CurvePolygon*>(g);
+
+    if(p != 0)
+    {
+      const std::size_t nRings = p->getNumRings();
+
+      for(std::size_t i = 0; i < nRings; ++i)
+        GatherParts(p->getRingN(i), group);
+
+      return;
+    }
+
+    te::gm::GeometryCollection* gc = dynamic_cast<te::gm::GeometryCollection*>(g);
+
+    if(gc != 0)
+    {
+      const std::size_t nGeoms = gc->getNumGeometries();
+
+      for(std::size_t i = 0; i < nGeoms; ++i)
+        GatherParts(gc->getGeometryN(i), group);
+
+      return;
+    }
+
+    group.m_others.push_back(g);
+  }
+}
+
+void te::gm::Transform(const std::vector<Geometry*>& geoms, int srid)
+{
+#ifdef TERRALIB_MOD_SRS_ENABLED
+  std::map<int, TransformGroup> groups;
+
+  for(std::size_t i = 0; i < geoms.size(); ++i)
+  {
+    if(geoms[i] == 0 || geoms[i]->getSRID() == srid)
+      continue;
+
+    std::map<int, TransformGroup>::iterator it = groups.find(geoms[i]->getSRID());
+
+    if(it == groups.end())
+    {
+      it = groups.insert(std::make_pair(geoms[i]->getSRID(), TransformGroup())).first;
+      it->second.m_nCoords = 0;
+    }
+
+    it->second.m_geoms.push_back(geoms[i]);
+
+    GatherParts(geoms[i], it->second);
+  }
+
+  std::vector<Coord2D> coords;
+
+  for(std::map<int, TransformGroup>::iterator it = groups.begin(); it != groups.end(); ++it)
+  {
+    TransformGroup& group = it->second;
+
+    if(group.m_nCoords != 0)
+    {
+      boost::shared_ptr<te::srs::Converter> converter = te::srs::ConverterCache::getInstance().get(it->first, srid);
+
+// pack the coordinates of all lines and points
+      coords.resize(group.m_nCoords);
+
+      Coord2D* c = &coords[0];
+
+      for(std::size_t i = 0; i < group.m_lines.size(); ++i)
+      {
+        const std::size_t n = group.m_lines[i]->size();
+
+        if(n != 0)
+          std::copy(group.m_lines[i]->getCoordinates(), group.m_lines[i]->getCoordinates() + n, c);
+
+        c += n;
+      }
+
+      for(std::size_t i = 0; i < group.m_points.size(); ++i, ++c)
+      {
+        c->x = group.m_points[i]->getX();
+        c->y = group.m_points[i]->getY();
+      }
+
+      converter->convert(&(coords[0].x), &(coords[0].y), static_cast<long>(group.m_nCoords), 2);
+
+// and scatter them back
+      c = &coords[0];
+
+      for(std::size_t i = 0; i < group.m_lines.size(); ++i)
+      {
+        const std::size_t n = group.m_lines[i]->size();
+
+        if(n != 0)
+          std::copy(c, c + n, group.m_lines[i]->getCoordinates());
+
+        c += n;
+      }
+
+      for(std::size_t i = 0; i < group.m_points.size(); ++i, ++c)
+      {
+        group.m_points[i]->setX(c->x);
+        group.m_points[i]->setY(c->y);
+      }
+    }
+
+    for(std::size_t i = 0; i < group.m_others.size(); ++i)
+      group.m_others[i]->transform(srid);
+
+    for(std::size_t i = 0; i < group.m_geoms.size(); ++i)
+    {
+      group.m_geoms[i]->setSRID(srid);
+      group.m_geoms[i]->computeMBR(true);
+    }
+  }
+#else
+  throw Exception(TE_TR("transform method is not supported!"));
+#endif // TERRALIB_MOD_SRS_ENABLED
+}
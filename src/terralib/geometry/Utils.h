@@ -252,6 +252,49 @@ namespace te
      */
     TEGEOMEXPORT te::gm::Geometry* SnapToSelf(const te::gm::Geometry* g, const double& snapTolerance, const bool& cleanResult);
 
+    /*!
+      \brief It removes, in place, the coordinates closer than the tolerance to the previously kept coordinate (radial distance simplification).
+
+      The first and the last coordinates are always kept, so closed rings remain closed.
+
+      \param coords    The sequence of coordinates.
+      \param n         The number of coordinates.
+      \param tolerance The minimum distance between two kept coordinates.
+
+      \return The number of kept coordinates, that are moved to the beginning of the sequence.
+    */
+    TEGEOMEXPORT std::size_t Decimate(Coord2D* coords, std::size_t n, double tolerance);
+
+    /*!
+      \brief It removes, in place, the vertices of the lines and rings of a geometry that are closer than the tolerance to the previously kept vertex.
+
+      \param g         The geometry to be simplified.
+      \param tolerance The minimum distance between two kept vertices.
+
+      \note Points and lines with z or m values are not changed.
+
+      \note It is meant for drawing: rings may end up with less than four vertices.
+    */
+    TEGEOMEXPORT void Decimate(Geometry* g, double tolerance);
+
+    /*!
+      \brief It converts the coordinates of a set of geometries to another SRS.
+
+      The coordinates of all lines, rings and points with the same SRS are
+      packed and converted by a single call to a cached converter, instead
+      of one converter and one call for each part of each geometry.
+
+      \param geoms The geometries to be converted. They may have different SRS.
+      \param srid  The target SRS.
+
+      \exception Exception It throws an exception if a SRS is not known.
+
+      \note Curves other than line strings are converted one by one.
+
+      \note The MBRs of the converted geometries (and of their parts) are recomputed.
+    */
+    TEGEOMEXPORT void Transform(const std::vector<Geometry*>& geoms, int srid);
+
   } // end namespace gm
 }   // end namespace te
 
@@ -0,0 +1,342 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+  \file terralib/geometry/WKBView.cpp
+
+  \brief A lightweight read-only view of a WKB (or PostGIS EWKB) geometry.
+*/
+
+// TerraLib
+#include "../common/ByteSwapUtils.h"
+#include "../common/Globals.h"
+#include "../core/translator/Translator.h"
+#include "Exception.h"
+#include "Utils.h"
+#include "WKBView.h"
+
+// STL
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+// Boost
+#include <boost/cstdint.hpp>
+
+namespace te
+{
+  namespace gm
+  {
+    /*! \brief PostGIS EWKB flags. */
+    static const unsigned int sg_ewkbZFlag    = 0x80000000;
+    static const unsigned int sg_ewkbMFlag    = 0x40000000;
+    static const unsigned int sg_ewkbSRIDFlag = 0x20000000;
+
+    /*! \brief It reads an unsigned 32-bit integer, swapping its bytes if needed. */
+    inline boost::uint32_t ReadUInt32(const char* wkb, bool swap)
+    {
+      boost::uint32_t v;
+
+      memcpy(&v, wkb, 4);
+
+      if(swap)
+        te::common::SwapBytes(v);
+
+      return v;
+    }
+
+    /*! \brief It reads a double, swapping its bytes if needed. */
+    inline double ReadDouble(const char* wkb, bool swap)
+    {
+      char v[8];
+
+      memcpy(v, wkb, 8);
+
+      if(swap)
+        te::common::Swap8Bytes(v);
+
+      double d;
+
+      memcpy(&d, v, 8);
+
+      return d;
+    }
+
+  } // end namespace gm
+}   // end namespace te
+
+te::gm::WKBView::WKBView()
+  : m_gType(te::gm::UnknownGeometryType),
+    m_srid(0)
+{
+  clear();
+}
+
+const char* te::gm::WKBView::read(const char* wkb)
+{
+  assert(wkb);
+
+  clear();
+
+  const char* end = readGeometry(wkb);
+
+  computeMBR();
+
+  return end;
+}
+
+void te::gm::WKBView::clear()
+{
+  m_gType = te::gm::UnknownGeometryType;
+  m_srid = 0;
+  m_mbr.makeInvalid();
+
+  m_coords.clear();
+
+  m_rings.clear();
+  m_rings.push_back(0);
+
+  m_partRings.clear();
+  m_partRings.push_back(0);
+
+  m_partTypes.clear();
+}
+
+void te::gm::WKBView::computeMBR()
+{
+  m_mbr.makeInvalid();
+
+  const std::size_t n = m_coords.size();
+
+  if(n == 0)
+    return;
+
+  const Coord2D* c = &m_coords[0];
+
+  double llx = c[0].x;
+  double lly = c[0].y;
+  double urx = c[0].x;
+  double ury = c[0].y;
+
+  for(std::size_t i = 1; i < n; ++i)
+  {
+    if(c[i].x < llx)
+      llx = c[i].x;
+    else if(c[i].x > urx)
+      urx = c[i].x;
+
+    if(c[i].y < lly)
+      lly = c[i].y;
+    else if(c[i].y > ury)
+      ury = c[i].y;
+  }
+
+  m_mbr.init(llx, lly, urx, ury);
+}
+
+te::gm::Envelope te::gm::WKBView::getPartMBR(std::size_t p) const
+{
+  Envelope e;
+
+  const std::size_t first = m_rings[m_partRings[p]];
+  const std::size_t last = m_rings[m_partRings[p + 1]];
+
+  for(std::size_t i = first; i < last; ++i)
+  {
+    const Coord2D& c = m_coords[i];
+
+    e.Union(Envelope(c.x, c.y, c.x, c.y));
+  }
+
+  return e;
+}
+
+void te::gm::WKBView::decimate(double tolerance)
+{
+  const std::size_t nRings = m_rings.size() - 1;
+
+// the kept coordinates of each ring are moved to the end of the previous ring
+  std::size_t begin = 0;
+  std::size_t first = 0;
+
+  for(std::size_t r = 0; r < nRings; ++r)
+  {
+    const std::size_t end = m_rings[r + 1];
+    const std::size_t n = end - begin;
+
+    if(begin != first)
+      std::copy(m_coords.begin() + begin, m_coords.begin() + end, m_coords.begin() + first);
+
+    m_rings[r] = first;
+
+    first += Decimate(&m_coords[first], n, tolerance);
+
+    begin = end;
+  }
+
+  m_rings[nRings] = first;
+
+  m_coords.resize(first);
+}
+
+const char* te::gm::WKBView::readGeometry(const char* wkb)
+{
+  const bool swap = te::common::Globals::sm_machineByteOrder != static_cast<te::common::MachineByteOrder>(*wkb);
+
+  unsigned int gType = ReadUInt32(wkb + 1, swap);
+
+  wkb += 5;
+
+// PostGIS EWKB flags
+  std::size_t dims = 2;
+
+  if(gType & sg_ewkbZFlag)
+    ++dims;
+
+  if(gType & sg_ewkbMFlag)
+    ++dims;
+
+  if(gType & sg_ewkbSRIDFlag)
+  {
+    if(m_gType == te::gm::UnknownGeometryType)
+      m_srid = static_cast<int>(ReadUInt32(wkb, swap));
+
+    wkb += 4;
+  }
+
+  const unsigned int ewkbFlags = gType & 0xF0000000;
+
+  gType &= 0x0FFFFFFF;
+
+// OGC (ISO) dimension codes: 1000 for z, 2000 for m and 3000 for zm
+  if(ewkbFlags == 0)
+    dims += (gType / 1000 == 3) ? 2 : ((gType / 1000) != 0 ? 1 : 0);
+
+  const unsigned int baseType = gType % 1000;
+
+  if(m_gType == te::gm::UnknownGeometryType)
+  {
+    unsigned int ogcType = baseType;
+
+    if(dims == 4)
+      ogcType += 3000;
+    else if(dims == 3)
+      ogcType += ((ewkbFlags & sg_ewkbMFlag) || (gType / 1000 == 2)) ? 2000 : 1000;
+
+    m_gType = static_cast<GeomType>(ogcType);
+  }
+
+  switch(baseType)
+  {
+    case te::gm::PointType:
+      {
+        Coord2D c(ReadDouble(wkb, swap), ReadDouble(wkb + 8, swap));
+
+        wkb += 8 * dims;
+
+        m_coords.push_back(c);
+        m_rings.push_back(m_coords.size());
+
+        endPart(te::gm::PointType);
+      }
+    break;
+
+    case te::gm::LineStringType:
+      wkb = readRing(wkb, swap, dims);
+      endPart(te::gm::LineStringType);
+    break;
+
+    case te::gm::PolygonType:
+    case te::gm::TriangleType:
+      {
+        const unsigned int nRings = ReadUInt32(wkb, swap);
+
+        wkb += 4;
+
+        for(unsigned int i = 0; i < nRings; ++i)
+          wkb = readRing(wkb, swap, dims);
+
+        endPart(te::gm::PolygonType);
+      }
+    break;
+
+    case te::gm::MultiPointType:
+    case te::gm::MultiLineStringType:
+    case te::gm::MultiPolygonType:
+    case te::gm::MultiSurfaceType:
+    case te::gm::GeometryCollectionType:
+    case te::gm::PolyhedralSurfaceType:
+    case te::gm::TINType:
+      {
+        const unsigned int nGeoms = ReadUInt32(wkb, swap);
+
+        wkb += 4;
+
+        for(unsigned int i = 0; i < nGeoms; ++i)
+          wkb = readGeometry(wkb);
+      }
+    break;
+
+    default:
+      throw Exception(TE_TR("Could not read WKB due to an invalid or not supported geometry type!"));
+  }
+
+  return wkb;
+}
+
+const char* te::gm::WKBView::readRing(const char* wkb, bool swap, std::size_t dims)
+{
+  const std::size_t nPts = ReadUInt32(wkb, swap);
+
+  wkb += 4;
+
+  const std::size_t first = m_coords.size();
+
+  m_coords.resize(first + nPts);
+
+  Coord2D* c = m_coords.data() + first;
+
+  if(!swap && (dims == 2))
+  {
+// the coordinates have the same layout of the arena (pairs of doubles): a single block copy
+    memcpy(reinterpret_cast<double*>(c), wkb, 16 * nPts);
+  }
+  else
+  {
+    const std::size_t stride = 8 * dims;
+
+    for(std::size_t i = 0; i < nPts; ++i)
+    {
+      c[i].x = ReadDouble(wkb + i * stride, swap);
+      c[i].y = ReadDouble(wkb + i * stride + 8, swap);
+    }
+  }
+
+  wkb += 8 * dims * nPts;
+
+  m_rings.push_back(m_coords.size());
+
+  return wkb;
+}
+
+void te::gm::WKBView::endPart(GeomType t)
+{
+  m_partTypes.push_back(t);
+  m_partRings.push_back(m_rings.size() - 1);
+}
@@ -0,0 +1,234 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+  \file terralib/geometry/WKBView.h
+
+  \brief A lightweight read-only view of a WKB (or PostGIS EWKB) geometry.
+*/
+
+#ifndef __TERRALIB_GEOMETRY_INTERNAL_WKBVIEW_H
+#define __TERRALIB_GEOMETRY_INTERNAL_WKBVIEW_H
+
+// TerraLib
+#include "Config.h"
+#include "Coord2D.h"
+#include "Enums.h"
+#include "Envelope.h"
+
+// STL
+#include <cstddef>
+#include <vector>
+
+namespace te
+{
+  namespace gm
+  {
+    /*!
+      \class WKBView
+
+      \brief A lightweight read-only view of a WKB (or PostGIS EWKB) geometry.
+
+      Instead of building a te::gm::Geometry tree, the view decodes the
+      coordinates of the WKB into a flat coordinate arena and keeps, for each
+      primitive part (point, line or polygon), the spans of its rings in
+      that arena. Multi-geometries and collections are flattened into their
+      primitive parts.
+
+      The arena is reused by successive calls to read: a view kept for
+      a whole dataset traversal doesn't allocate memory once it has grown to the
+      size of the largest geometry.
+
+      Bytes are only swapped when the WKB byte order differs from the machine
+      one; otherwise the coordinates of 2D rings are copied in a single block.
+
+      \ingroup geometry
+
+      \note Only x and y values are kept: z and m values are skipped.
+
+      \note Curve types (CircularString, CompoundCurve, CurvePolygon, ...) are not supported.
+
+      \sa WKBReader
+    */
+    class TEGEOMEXPORT WKBView
+    {
+      public:
+
+        /*! \brief It creates an empty view. */
+        WKBView();
+
+        /*!
+          \brief It decodes the given WKB (or EWKB) replacing the current view contents.
+
+          \param wkb A valid WKB or PostGIS EWKB geometry.
+
+          \return A pointer to the first byte after the geometry.
+
+          \exception Exception It throws an exception if the geometry type is not supported.
+        */
+        const char* read(const char* wkb);
+
+        /*! \brief It clears the view contents keeping the memory allocated for the arena. */
+        void clear();
+
+        /*! \brief It returns the geometry type of the WKB, using the OGC codes. */
+        GeomType getGeomTypeId() const
+        {
+          return m_gType;
+        }
+
+        /*! \brief It returns the SRID informed by an EWKB, or 0 if it is not informed. */
+        int getSRID() const
+        {
+          return m_srid;
+        }
+
+        /*! \brief It returns the bounding box of all coordinates in the view. */
+        const Envelope& getMBR() const
+        {
+          return m_mbr;
+        }
+
+        /*!
+          \brief It recomputes the bounding box.
+
+          \note Call it after changing the coordinates in place (e.g. after a SRS transformation).
+        */
+        void computeMBR();
+
+        /*! \brief It returns true if the view has no coordinates. */
+        bool isEmpty() const
+        {
+          return m_coords.empty();
+        }
+
+        /*! \brief It returns the number of coordinates in the arena. */
+        std::size_t getNumCoords() const
+        {
+          return m_coords.size();
+        }
+
+        /*!
+          \brief It returns the coordinate arena.
+
+          The coordinates may be changed in place, for instance to transform them to another SRS.
+        */
+        Coord2D* getCoords()
+        {
+          return m_coords.data();
+        }
+
+        /*! \brief It returns the coordinate arena. */
+        const Coord2D* getCoords() const
+        {
+          return m_coords.data();
+        }
+
+        /*! \brief It returns the number of primitive parts (points, lines or polygons). */
+        std::size_t getNumParts() const
+        {
+          return m_partTypes.size();
+        }
+
+        /*!
+          \brief It returns the 2D type of the given part: PointType, LineStringType or PolygonType.
+
+          \param p The part index.
+        */
+        GeomType getPartType(std::size_t p) const
+        {
+          return m_partTypes[p];
+        }
+
+        /*!
+          \brief It returns the number of rings of the given part.
+
+          Points and lines have a single ring. The first ring of a polygon is its exterior ring.
+
+          \param p The part index.
+        */
+        std::size_t getNumRings(std::size_t p) const
+        {
+          return m_partRings[p + 1] - m_partRings[p];
+        }
+
+        /*!
+          \brief It returns the coordinates of a ring of a part.
+
+          \param p    The part index.
+          \param r    The ring index inside the part.
+          \param npts The number of coordinates of the ring.
+
+          \return A pointer to the first coordinate of the ring in the arena.
+        */
+        const Coord2D* getRing(std::size_t p, std::size_t r, std::size_t& npts) const
+        {
+          const std::size_t ring = m_partRings[p] + r;
+
+          npts = m_rings[ring + 1] - m_rings[ring];
+
+          return m_coords.data() + m_rings[ring];
+        }
+
+        /*!
+          \brief It computes the bounding box of a single part.
+
+          \param p The part index.
+
+          \return The part bounding box.
+        */
+        Envelope getPartMBR(std::size_t p) const;
+
+        /*!
+          \brief It removes, in place, the coordinates of each ring that are closer than the tolerance to the previously kept coordinate.
+
+          \param tolerance The minimum distance between two kept coordinates.
+
+          \note The bounding box is not recomputed: it still contains all the kept coordinates.
+
+          \sa te::gm::Decimate
+        */
+        void decimate(double tolerance);
+
+      private:
+
+        /*! \brief It decodes a geometry and its children, appending them to the view. */
+        const char* readGeometry(const char* wkb);
+
+        /*! \brief It decodes a sequence of coordinates as a new ring. */
+        const char* readRing(const char* wkb, bool swap, std::size_t dims);
+
+        /*! \brief It closes the current part. */
+        void endPart(GeomType t);
+
+      private:
+
+        GeomType m_gType;                     //!< The type of the geometry.
+        int m_srid;                           //!< The SRID informed by an EWKB.
+        Envelope m_mbr;                       //!< The bounding box of the geometry.
+        std::vector<Coord2D> m_coords;        //!< The coordinate arena.
+        std::vector<std::size_t> m_rings;     //!< The first coordinate of each ring plus a sentinel.
+        std::vector<std::size_t> m_partRings; //!< The first ring of each part plus a sentinel.
+        std::vector<GeomType> m_partTypes;    //!< The 2D type of each part.
+    };
+
+  } // end namespace gm
+}   // end namespace te
+
+#endif  // __TERRALIB_GEOMETRY_INTERNAL_WKBVIEW_H
@@ -52,7 +52,7 @@
 
   \brief This definition is used to set the default cache policy.
  */
-#define TE_DEFAULT_CACHE_POLICY_TYPE TE_GRAPH_FACTORY_CACHEPOLICY_TYPE_FIFO
+#define TE_DEFAULT_CACHE_POLICY_TYPE TE_GRAPH_FACTORY_CACHEPOLICY_TYPE_LRU
 
 /*!
   \def TE_DEFAULT_GRAPH_LOADER_STRATEGY_TYPE
@@ -75,6 +75,20 @@
  */
 #define TE_GRAPH_DEFAULT_MAX_VEC_CACHE_SIZE 5
 
+/*!
+  \def TE_GRAPH_DEFAULT_MAX_CACHE_MEMORY
+
+  \brief This definition is used to set the max graph cache memory in bytes (0 means that only the vector size is used).
+ */
+#define TE_GRAPH_DEFAULT_MAX_CACHE_MEMORY 0
+
+/*!
+  \def TE_GRAPH_DEFAULT_ASYNC_CACHE
+
+  \brief This definition is used to set if the graph cache writes back and prefetches the graph data in a background thread.
+ */
+#define TE_GRAPH_DEFAULT_ASYNC_CACHE false
+
 /*!
   \def TE_GRAPH_DEFAULT_BOX_STRATEGY_LOADER_SIZE
 
@@ -109,6 +123,7 @@
 
 #define TE_GRAPH_FACTORY_CACHEPOLICY_TYPE_FIFO "FIFO"
 #define TE_GRAPH_FACTORY_CACHEPOLICY_TYPE_LFU "LFU"
+#define TE_GRAPH_FACTORY_CACHEPOLICY_TYPE_LRU "LRU"
 
 #define TE_GRAPH_FACTORY_LOADERSTRATEGY_TYPE_BOX "BOX_LOADER_STRATEGY"
 #define TE_GRAPH_FACTORY_LOADERSTRATEGY_TYPE_SEQUENCE "SEQUENCE_LOADER_STRATEGY"
@@ -35,6 +35,7 @@ const std::string te::graph::Globals::sm_factoryGraphTypeUndirectedGraph(TE_GRAP
 
 const std::string te::graph::Globals::sm_factoryCachePolicyTypeFIFO(TE_GRAPH_FACTORY_CACHEPOLICY_TYPE_FIFO);
 const std::string te::graph::Globals::sm_factoryCachePolicyTypeLFU(TE_GRAPH_FACTORY_CACHEPOLICY_TYPE_LFU);
+const std::string te::graph::Globals::sm_factoryCachePolicyTypeLRU(TE_GRAPH_FACTORY_CACHEPOLICY_TYPE_LRU);
 
 const std::string te::graph::Globals::sm_factoryLoaderStrategyTypeBox(TE_GRAPH_FACTORY_LOADERSTRATEGY_TYPE_BOX);
 const std::string te::graph::Globals::sm_factoryLoaderStrategyTypeSequence(TE_GRAPH_FACTORY_LOADERSTRATEGY_TYPE_SEQUENCE);
@@ -45,6 +46,8 @@ const std::string te::graph::Globals::sm_loaderStrategyFactoryDefaultObject(TE_D
 
 const int te::graph::Globals::sm_graphCacheDefaultMaxSize(TE_GRAPH_DEFAULT_MAX_CACHE_SIZE);
 const int te::graph::Globals::sm_graphVecCacheDefaultMaxSize(TE_GRAPH_DEFAULT_MAX_VEC_CACHE_SIZE);
+const std::size_t te::graph::Globals::sm_graphCacheDefaultMaxMemory(TE_GRAPH_DEFAULT_MAX_CACHE_MEMORY);
+const bool te::graph::Globals::sm_graphCacheDefaultAsync(TE_GRAPH_DEFAULT_ASYNC_CACHE);
 const int te::graph::Globals::sm_boxLoaderStrategyDefaultSize(TE_GRAPH_DEFAULT_BOX_STRATEGY_LOADER_SIZE);
 
 const std::string te::graph::Globals::sm_vertexStorageMode(TE_GRAPH_STORAGE_MODE_BY_VERTEX);
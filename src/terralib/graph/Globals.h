@@ -31,6 +31,7 @@
 #include "Config.h"
 
 // STL
+#include <cstddef>
 #include <string>
 
 namespace te
@@ -56,6 +57,7 @@ namespace te
 
         static const std::string sm_factoryCachePolicyTypeFIFO;             //!< FIFO Cache Policy Factory Name.
         static const std::string sm_factoryCachePolicyTypeLFU;              //!< LFU Cache Policy Factory Name.
+        static const std::string sm_factoryCachePolicyTypeLRU;              //!< LRU Cache Policy Factory Name.
 
         static const std::string sm_factoryLoaderStrategyTypeBox;           //!< Box Loader Strategy Factory Name.
         static const std::string sm_factoryLoaderStrategyTypeSequence;      //!< Sequence Loader Strategy Factory Name.
@@ -66,6 +68,8 @@ namespace te
 
         static const int sm_graphCacheDefaultMaxSize;                       //!< This definition is used to set the max graph cache size.
         static const int sm_graphVecCacheDefaultMaxSize;                    //!< This definition is used to set the max graph cache vector size.
+        static const std::size_t sm_graphCacheDefaultMaxMemory;             //!< This definition is used to set the max graph cache memory in bytes.
+        static const bool sm_graphCacheDefaultAsync;                        //!< This definition is used to set if the graph cache works in a background thread.
         static const int sm_boxLoaderStrategyDefaultSize;                   //!< This definition is used to set the default box strategy loader box size.
 
         static const std::string sm_vertexStorageMode;                      //!< This definition is used to set the vertex storage mode.
@@ -29,6 +29,7 @@
 #include "../core/translator/Translator.h"
 #include "cache/FIFOCachePolicyFactory.h"
 #include "cache/LFUCachePolicyFactory.h"
+#include "cache/LRUCachePolicyFactory.h"
 #include "graphs/BidirectionalGraphFactory.h"
 #include "graphs/DirectedGraphFactory.h"
 #include "graphs/GraphFactory.h"
@@ -61,6 +62,7 @@ void te::graph::Module::initialize()
   // cache factories
   FIFOCachePolicyFactory::initialize();
   LFUCachePolicyFactory::initialize();
+  LRUCachePolicyFactory::initialize();
 
   // loader strategy factories
   BoxLoaderStrategyFactory::initialize();
@@ -80,6 +82,7 @@ void te::graph::Module::finalize()
   // cache factories
   FIFOCachePolicyFactory::finalize();
   LFUCachePolicyFactory::finalize();
+  LRUCachePolicyFactory::finalize();
 
   // loader strategy factories
   BoxLoaderStrategyFactory::finalize();
@@ -57,6 +57,9 @@ void te::graph::FIFOCachePolicy::update(int value)
 
 void te::graph::FIFOCachePolicy::toRemove(int& value)
 {
+  if(m_FIFO.empty())
+    return;
+
   value = *m_FIFO.begin();
 
   m_FIFO.erase(m_FIFO.begin());
@@ -0,0 +1,71 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+  \file LRUCachePolicy.cpp
+
+  \brief This class is used to implement the LRU cache policy.
+*/
+
+#include "LRUCachePolicy.h"
+
+te::graph::LRUCachePolicy::LRUCachePolicy()
+{
+}
+
+te::graph::LRUCachePolicy::~LRUCachePolicy()
+{
+  m_LRU.clear();
+  m_position.clear();
+}
+
+void te::graph::LRUCachePolicy::added(int value)
+{
+  if(m_position.find(value) != m_position.end())
+  {
+    accessed(value);
+    return;
+  }
+
+  m_position[value] = m_LRU.insert(m_LRU.end(), value);
+}
+
+void te::graph::LRUCachePolicy::update(int value)
+{
+  accessed(value);
+}
+
+void te::graph::LRUCachePolicy::toRemove(int& value)
+{
+  if(m_LRU.empty())
+    return;
+
+  value = m_LRU.front();
+
+  m_position.erase(value);
+  m_LRU.pop_front();
+}
+
+void te::graph::LRUCachePolicy::accessed(int value)
+{
+  boost::unordered_map<int, std::list<int>::iterator>::iterator it = m_position.find(value);
+
+  if(it != m_position.end())
+    m_LRU.splice(m_LRU.end(), m_LRU, it->second);
+}
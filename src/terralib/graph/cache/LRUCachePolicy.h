@@ -0,0 +1,115 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+  \file LRUCachePolicy.h
+
+  \brief This class is used to implement the LRU cache policy.
+*/
+
+#ifndef __TERRALIB_GRAPH_INTERNAL_LRUCACHEPOLICY_H
+#define __TERRALIB_GRAPH_INTERNAL_LRUCACHEPOLICY_H
+
+// Terralib Includes
+#include "../Config.h"
+#include "AbstractCachePolicy.h"
+
+// STL Includes
+#include <list>
+
+// Boost Includes
+#include <boost/unordered_map.hpp>
+
+namespace te
+{
+  namespace graph
+  {
+    /*!
+      \class LRUCachePolicy
+
+      \brief This class is used to implement the LRU cache policy.
+
+             The indexes are kept in a list ordered by the last access,
+             with a map from each index to its position in the list, so
+             all the operations have a constant cost.
+
+      \sa AbstractCachePolicy
+    */
+
+    class TEGRAPHEXPORT LRUCachePolicy : public AbstractCachePolicy
+    {
+      public:
+
+        /*! \brief Default constructor. */
+        LRUCachePolicy();
+
+        /*! \brief Virtual destructor. */
+        virtual ~LRUCachePolicy();
+
+        
+        /** @name Access Methods
+         *  Method used to access the cache policy
+         */
+        //@{
+
+        /*!
+          \brief Function used to add a new index to be controlled.
+
+          \param value  Object index attribute
+
+         */
+        virtual void added(int value);
+
+        /*!
+          \brief Function used to inform that an index must be updated
+
+          \param value  Object index attribute
+
+         */
+        virtual void update(int value);
+
+        /*!
+          \brief Function used to check what index has to be removed from the cache
+
+          \param value  Object index attribute
+
+         */
+        virtual void toRemove(int& value);
+
+        /*!
+          \brief Function used to inform that an index was accessed.
+
+          \param value  Object index attribute
+
+         */
+        virtual void accessed(int value);
+
+        //@}
+
+      protected:
+
+        std::list<int> m_LRU;                                           // This list keeps the indexes from the least to the most recently used - LRU policy
+
+        boost::unordered_map<int, std::list<int>::iterator> m_position; // This map keeps the position of each index in the list
+    };
+
+  } // end namespace graph
+} // end namespace te
+
+#endif // __TERRALIB_GRAPH_INTERNAL_LRUCACHEPOLICY_H
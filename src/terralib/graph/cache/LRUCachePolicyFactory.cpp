@@ -0,0 +1,61 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+  \file LRUCachePolicyFactory.cpp
+
+  \brief This is the concrete factory for the LRU cache policy
+*/
+
+// TerraLib
+#include "../Globals.h"
+#include "LRUCachePolicy.h"
+#include "LRUCachePolicyFactory.h"
+
+// STL
+#include <memory>
+
+te::graph::LRUCachePolicyFactory* te::graph::LRUCachePolicyFactory::sm_factory(0);
+
+const std::string& te::graph::LRUCachePolicyFactory::getType() const
+{
+  return Globals::sm_factoryCachePolicyTypeLRU;
+}
+
+void te::graph::LRUCachePolicyFactory::initialize()
+{
+  finalize();
+  sm_factory = new LRUCachePolicyFactory;
+}
+
+void te::graph::LRUCachePolicyFactory::finalize()
+{
+  delete sm_factory;
+  sm_factory = 0;
+}
+
+te::graph::LRUCachePolicyFactory::LRUCachePolicyFactory()
+  : te::graph::AbstractCachePolicyFactory(Globals::sm_factoryCachePolicyTypeLRU)
+{
+}
+
+te::graph::AbstractCachePolicy* te::graph::LRUCachePolicyFactory::build()
+{
+  return new LRUCachePolicy;
+}
\ No newline at end of file
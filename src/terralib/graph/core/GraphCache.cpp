@@ -28,17 +28,29 @@
 
 // Terralib Includes
 #include "../../common/STLUtils.h"
+#include "../../core/logger/Logger.h"
+#include "../../core/translator/Translator.h"
 #include "../cache/AbstractCachePolicy.h"
 #include "../cache/AbstractCachePolicyFactory.h"
 #include "../loader/AbstractGraphLoaderStrategy.h"
+#include "../Exception.h"
 #include "GraphCache.h"
 #include "GraphData.h"
 #include "GraphDataManager.h"
+#include "GraphMetadata.h"
 
 // STL Includes
+#include <exception>
 #include <iostream>
+#include <memory>
 
-te::graph::GraphCache::GraphCache(AbstractCachePolicy* cp, GraphDataManager* dm): m_policy(cp),m_dataManager(dm)
+// Boost Includes
+#include <boost/bind.hpp>
+
+te::graph::GraphCache::GraphCache(AbstractCachePolicy* cp, GraphDataManager* dm): m_policy(cp),m_dataManager(dm),
+  m_taskThread(0),
+  m_taskRunning(false),
+  m_stopTasks(false)
 {
   m_graphDataCounter = 0; // initializate the graph data counter
 
@@ -52,7 +64,31 @@ te::graph::GraphCache::GraphCache(AbstractCachePolicy* cp, GraphDataManager* dm)
 
 te::graph::GraphCache::~GraphCache()
 {
-  clearCache();
+  //a destructor must not throw: the errors of the background tasks and of the last saves are logged
+  std::string error = finishTasks();
+
+  if(!error.empty())
+    TE_LOG_ERROR(error);
+
+  try
+  {
+    clearCache();
+  }
+  catch(const std::exception& e)
+  {
+    TE_LOG_ERROR(std::string(e.what()));
+  }
+  catch(...)
+  {
+    TE_LOG_ERROR(std::string(TE_TR("Unexpected error saving the graph cache.")));
+  }
+
+  //the graph data left by a failed save
+  te::common::FreeContents(m_graphDataMap);
+
+  m_graphDataMap.clear();
+
+  stopTasks();
 
   delete m_policy;
 }
@@ -60,27 +96,17 @@ te::graph::GraphCache::~GraphCache()
 te::graph::GraphData* te::graph::GraphCache::getGraphDataByVertexId(int id)
 {
   //check local cache
-  std::map<int, GraphData*>::iterator itMap = m_graphDataMap.begin();
-
-  while(itMap != m_graphDataMap.end())
-  {
-    te::graph::GraphData* d = itMap->second;
-
-    te::graph::GraphData::VertexMap::iterator it = d->getVertexMap().find(id);
-
-    if(it != d->getVertexMap().end())
-    {
-      m_policy->accessed(d->getId());
-
-      return d;
-    }
+  te::graph::GraphData* d = checkCacheByVertexId(id);
 
-    ++itMap;
-  }
+  if(d)
+    return d;
 
   //if not found
   if(m_dataManager != 0)
   {
+    //the data source may not have the released graph data yet
+    waitTasks();
+
     m_dataManager->loadGraphDataByVertexId(id, this);
 
     return checkCacheByVertexId(id);
@@ -92,27 +118,17 @@ te::graph::GraphData* te::graph::GraphCache::getGraphDataByVertexId(int id)
 te::graph::GraphData* te::graph::GraphCache::getGraphDataByEdgeId(int id)
 {
   //check local cache
-  std::map<int, GraphData*>::iterator itMap = m_graphDataMap.begin();
-
-  while(itMap != m_graphDataMap.end())
-  {
-    te::graph::GraphData* d = itMap->second;
+  te::graph::GraphData* d = checkCacheByEdgeId(id);
 
-    te::graph::GraphData::EdgeMap::iterator it = d->getEdgeMap().find(id);
-
-    if(it != d->getEdgeMap().end())
-    {
-      m_policy->accessed(d->getId());
-
-      return d;
-    }
-
-    ++itMap;
-  }
+  if(d)
+    return d;
 
   //if not found
   if(m_dataManager != 0)
   {
+    //the data source may not have the released graph data yet
+    waitTasks();
+
     m_dataManager->loadGraphDataByEdgeId(id, this);
 
     return checkCacheByEdgeId(id);
@@ -123,6 +139,13 @@ te::graph::GraphData* te::graph::GraphCache::getGraphDataByEdgeId(int id)
 
 te::graph::GraphData* te::graph::GraphCache::getGraphData()
 {
+  //release graph data following the cache policy while the memory limit is exceeded
+  while(m_graphDataMap.size() > 1 && isMemoryExceeded())
+  {
+    if(!releaseGraphData())
+      break;
+  }
+
   //cache is empty, return a new graph data
   if(m_graphDataMap.empty())
   {
@@ -155,29 +178,14 @@ te::graph::GraphData* te::graph::GraphCache::getGraphData()
     return m_graphDataMap[gdId];
   }
 
-  //if cache is not full create a new graph data... add to cache and return
-  if(m_graphDataMap.size() < m_metadata->m_maxVecCacheSize)
-  {
-    return createGraphData();
-  }
-
-  //remove the a graph data following the cache policy and create a new graph data
-  if(m_graphDataMap.size() == m_metadata->m_maxVecCacheSize)
+  //remove graph data following the cache policy until a new graph data can be created
+  while(m_graphDataMap.size() >= m_metadata->m_maxVecCacheSize)
   {
-    int idxToRemove = 0;
-
-    m_policy->toRemove(idxToRemove);
-
-    te::graph::GraphData* d = m_graphDataMap[idxToRemove];
-
-    saveGraphData(d);
-
-    removeGraphData(d->getId());
-
-    return createGraphData();
+    if(!releaseGraphData())
+      return 0;
   }
 
-  return 0;
+  return createGraphData();
 }
 
 te::graph::GraphData* te::graph::GraphCache::createGraphData()
@@ -187,7 +195,7 @@ te::graph::GraphData* te::graph::GraphCache::createGraphData()
     return 0;
   }
 
-  te::graph::GraphData* d = new te::graph::GraphData(getGraphDataId());
+  te::graph::GraphData* d = new te::graph::GraphData(getGraphDataId(), this);
 
   m_graphDataMap.insert(std::map<int, GraphData*>::value_type(d->getId(), d));
 
@@ -206,6 +214,9 @@ void te::graph::GraphCache::removeGraphData(int idx)
   }
 
   te::graph::GraphData* data =it->second;
+
+  unindexGraphData(data);
+
   delete data;
 
   m_graphDataMap.erase(it);
@@ -215,12 +226,16 @@ void te::graph::GraphCache::saveGraphData(GraphData* data)
 {
   if(m_dataManager)
   {
+    waitTasks();
+
     m_dataManager->saveGraphData(data);
   }
 }
 
 void te::graph::GraphCache::clearCache()
 {
+  waitTasks();
+
   std::map<int, GraphData*>::iterator it = m_graphDataMap.begin();
 
   while(it != m_graphDataMap.end())
@@ -241,54 +256,86 @@ void te::graph::GraphCache::clearCache()
   te::common::FreeContents(m_graphDataMap);
 
   m_graphDataMap.clear();
+
+  m_vertexIndex.clear();
+  m_edgeIndex.clear();
 }
 
 te::graph::GraphData* te::graph::GraphCache::checkCacheByVertexId(int id)
 {
-  //if not found check in cache
-  std::map<int, GraphData*>::iterator itMap = m_graphDataMap.begin();
+  IndexMap::iterator it = m_vertexIndex.find(id);
 
-  while(itMap != m_graphDataMap.end())
-  {
-    te::graph::GraphData* d = itMap->second;
+  if(it == m_vertexIndex.end())
+    return 0;
 
-    te::graph::GraphData::VertexMap::iterator it = d->getVertexMap().find(id);
+  m_policy->accessed(it->second->getId());
 
-    if(it != d->getVertexMap().end())
-    {
-      m_policy->accessed(d->getId());
+  return it->second;
+}
 
-      return d;
-    }
+te::graph::GraphData* te::graph::GraphCache::checkCacheByEdgeId(int id)
+{
+  IndexMap::iterator it = m_edgeIndex.find(id);
 
-    ++itMap;
-  }
+  if(it == m_edgeIndex.end())
+    return 0;
 
-  return 0;
+  m_policy->accessed(it->second->getId());
+
+  return it->second;
 }
 
-te::graph::GraphData* te::graph::GraphCache::checkCacheByEdgeId(int id)
+std::size_t te::graph::GraphCache::getMemorySize()
 {
-  //if not found check in cache
-  std::map<int, GraphData*>::iterator itMap = m_graphDataMap.begin();
+  std::size_t size = 0;
 
-  while(itMap != m_graphDataMap.end())
-  {
-    te::graph::GraphData* d = itMap->second;
+  for(std::map<int, GraphData*>::iterator it = m_graphDataMap.begin(); it != m_graphDataMap.end(); ++it)
+    size += it->second->getMemorySize();
 
-    te::graph::GraphData::EdgeMap::iterator it = d->getEdgeMap().find(id);
+  return size;
+}
 
-    if(it != d->getEdgeMap().end())
-    {
-      m_policy->accessed(d->getId());
+bool te::graph::GraphCache::addTask(const boost::function<void()>& task)
+{
+  if(!m_metadata->m_asyncCache)
+    return false;
 
-      return d;
-    }
+  boost::mutex::scoped_lock lock(m_taskMutex);
 
-    ++itMap;
+  if(m_taskThread == 0)
+  {
+    m_stopTasks = false;
+
+    m_taskThread = new boost::thread(boost::bind(&GraphCache::runTasks, this));
   }
 
-  return 0;
+  m_tasks.push_back(task);
+
+  m_taskCondition.notify_all();
+
+  return true;
+}
+
+void te::graph::GraphCache::waitTasks()
+{
+  std::string error = finishTasks();
+
+  if(!error.empty())
+    throw Exception(error);
+}
+
+std::string te::graph::GraphCache::finishTasks()
+{
+  boost::mutex::scoped_lock lock(m_taskMutex);
+
+  while(!m_tasks.empty() || m_taskRunning)
+    m_taskCondition.wait(lock);
+
+  std::string error = m_taskError;
+
+  m_taskError.clear();
+
+  return error;
 }
 
 int te::graph::GraphCache::getGraphDataId()
@@ -299,3 +346,159 @@ int te::graph::GraphCache::getGraphDataId()
 
   return id;
 }
+
+bool te::graph::GraphCache::releaseGraphData()
+{
+  std::map<int, GraphData*>::iterator it = m_graphDataMap.end();
+
+  //the policy may still have graph data removed from the cache by clearCache or removeGraphData
+  while(it == m_graphDataMap.end())
+  {
+    if(m_graphDataMap.empty())
+      return false;
+
+    int idxToRemove = -1;
+
+    m_policy->toRemove(idxToRemove);
+
+    if(idxToRemove == -1)
+      return false;
+
+    it = m_graphDataMap.find(idxToRemove);
+  }
+
+  te::graph::GraphData* d = it->second;
+
+  m_graphDataMap.erase(it);
+
+  unindexGraphData(d);
+
+  if(d->isDirty() && m_dataManager)
+  {
+    if(addTask(boost::bind(&GraphCache::writeBack, this, d)))
+      return true;
+
+    std::auto_ptr<te::graph::GraphData> data(d);
+
+    m_dataManager->saveGraphData(d);
+  }
+  else
+  {
+    delete d;
+  }
+
+  return true;
+}
+
+bool te::graph::GraphCache::isMemoryExceeded()
+{
+  return m_metadata->m_maxCacheMemory != 0 && getMemorySize() > m_metadata->m_maxCacheMemory;
+}
+
+void te::graph::GraphCache::writeBack(GraphData* data)
+{
+  std::auto_ptr<te::graph::GraphData> d(data);
+
+  m_dataManager->saveGraphData(d.get());
+}
+
+void te::graph::GraphCache::runTasks()
+{
+  boost::mutex::scoped_lock lock(m_taskMutex);
+
+  while(true)
+  {
+    while(m_tasks.empty() && !m_stopTasks)
+      m_taskCondition.wait(lock);
+
+    if(m_tasks.empty())
+      return;
+
+    boost::function<void()> task = m_tasks.front();
+
+    m_tasks.pop_front();
+
+    m_taskRunning = true;
+
+    lock.unlock();
+
+    std::string error;
+
+    try
+    {
+      task();
+    }
+    catch(const std::exception& e)
+    {
+      error = e.what();
+    }
+    catch(...)
+    {
+      error = TE_TR("Unexpected error in a graph cache background task.");
+    }
+
+    lock.lock();
+
+    if(m_taskError.empty())
+      m_taskError = error;
+
+    m_taskRunning = false;
+
+    m_taskCondition.notify_all();
+  }
+}
+
+void te::graph::GraphCache::stopTasks()
+{
+  {
+    boost::mutex::scoped_lock lock(m_taskMutex);
+
+    m_stopTasks = true;
+
+    m_taskCondition.notify_all();
+  }
+
+  if(m_taskThread)
+  {
+    m_taskThread->join();
+
+    delete m_taskThread;
+
+    m_taskThread = 0;
+  }
+}
+
+void te::graph::GraphCache::indexVertex(int id, GraphData* data)
+{
+  m_vertexIndex[id] = data;
+}
+
+void te::graph::GraphCache::unindexVertex(int id, GraphData* data)
+{
+  IndexMap::iterator it = m_vertexIndex.find(id);
+
+  if(it != m_vertexIndex.end() && it->second == data)
+    m_vertexIndex.erase(it);
+}
+
+void te::graph::GraphCache::indexEdge(int id, GraphData* data)
+{
+  m_edgeIndex[id] = data;
+}
+
+void te::graph::GraphCache::unindexEdge(int id, GraphData* data)
+{
+  IndexMap::iterator it = m_edgeIndex.find(id);
+
+  if(it != m_edgeIndex.end() && it->second == data)
+    m_edgeIndex.erase(it);
+}
+
+void te::graph::GraphCache::unindexGraphData(GraphData* data)
+{
+  for(te::graph::GraphData::VertexMap::iterator it = data->getVertexMap().begin(); it != data->getVertexMap().end(); ++it)
+    unindexVertex(it->first, data);
+
+  for(te::graph::GraphData::EdgeMap::iterator it = data->getEdgeMap().begin(); it != data->getEdgeMap().end(); ++it)
+    unindexEdge(it->first, data);
+}
\ No newline at end of file
@@ -33,7 +33,17 @@
 #include "../Config.h"
 
 // STL Includes
+#include <cstddef>
+#include <deque>
 #include <map>
+#include <string>
+
+// Boost Includes
+#include <boost/function.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/unordered_map.hpp>
 
 namespace te
 {
@@ -54,6 +64,19 @@ namespace te
             If a element was requested and not found  in cache, the 
             GraphDataManager is used to loaded a new GraphData.
 
+            The cache keeps an index from each vertex and edge identifier
+            to the graph data that contains it, so an element is found
+            in constant time. A graph data is released, following the
+            cache policy, when the number of graph data reaches the
+            max vector cache size or when the estimate of the memory
+            used by them exceeds the max cache memory of the metadata.
+
+            If the metadata enables the asynchronous cache, the released
+            graph data that were changed are saved in a background thread,
+            that also runs the prefetching of the loader strategy. The
+            data source is only accessed by the calling thread after all
+            the background tasks are finished.
+
       \sa GraphDataManager, GraphData
     */
 
@@ -161,6 +184,36 @@ namespace te
         */
         GraphData* checkCacheByEdgeId(int id);
 
+        /*!
+          \brief It returns an estimate of the memory used by the graph data in cache
+
+          \return The estimate in bytes
+        */
+        std::size_t getMemorySize();
+
+        //@}
+
+         /** @name Graph Cache Background Methods
+        *  Method used to run tasks in the background thread of the cache
+        */
+        //@{
+
+        /*!
+          \brief It adds a task to the background thread, if the metadata enables the asynchronous cache.
+
+          \param task The task to be run. The tasks are run one at a time, in the order that they were added.
+
+          \return True if the task was added and false if the asynchronous cache is disabled.
+        */
+        bool addTask(const boost::function<void()>& task);
+
+        /*!
+          \brief It waits for all the background tasks to finish.
+
+          \exception Exception It throws an exception if a background task has failed.
+        */
+        void waitTasks();
+
         //@}
 
       protected:
@@ -172,10 +225,63 @@ namespace te
         */
         int getGraphDataId();
 
+        /*!
+          \brief It releases a graph data following the cache policy. If it was changed it is saved, in the background if enabled.
+
+          \return False if there is no graph data to be released.
+        */
+        bool releaseGraphData();
+
+        /*! \brief It returns true if the estimate of the memory used by the graph data exceeds the max cache memory. */
+        bool isMemoryExceeded();
+
+        /*! \brief It saves and deletes a released graph data, in the background thread. */
+        void writeBack(GraphData* data);
+
+        /*! \brief The background thread loop. */
+        void runTasks();
+
+        /*!
+          \brief It waits for all the background tasks to finish, without throwing.
+
+          \return The error message of the first failed task, or an empty string. The error is cleared.
+        */
+        std::string finishTasks();
+
+        /*! \brief It waits for the background tasks and stops the background thread. */
+        void stopTasks();
+
+      private:
+
+        friend class GraphData;
+
+        /** @name Graph Cache Index Methods
+        *  Method used by the graph data to keep the index of its elements
+        */
+        //@{
+
+        void indexVertex(int id, GraphData* data);
+
+        void unindexVertex(int id, GraphData* data);
+
+        void indexEdge(int id, GraphData* data);
+
+        void unindexEdge(int id, GraphData* data);
+
+        void unindexGraphData(GraphData* data);
+
+        //@}
+
       private:
 
+        typedef boost::unordered_map<int, GraphData*> IndexMap;
+
         std::map<int, GraphData*> m_graphDataMap;   //!< This map represents all data loaded in cache
 
+        IndexMap m_vertexIndex;                     //!< The graph data that contains each vertex in cache
+
+        IndexMap m_edgeIndex;                       //!< The graph data that contains each edge in cache
+
         AbstractCachePolicy* m_policy;              //!< Cache policy to control the cache in memory
 
         GraphDataManager* m_dataManager;            //!< Used to load and save GraphData information from a DataSource
@@ -183,6 +289,20 @@ namespace te
         GraphMetadata* m_metadata;                  //!< Graph metadata information.
 
         int m_graphDataCounter;                     //!< Graph data identifier counter
+
+        std::deque<boost::function<void()> > m_tasks; //!< The tasks waiting for the background thread
+
+        boost::thread* m_taskThread;                //!< The background thread, created by the first task
+
+        boost::mutex m_taskMutex;                   //!< Mutex used to access the tasks
+
+        boost::condition_variable m_taskCondition;  //!< Used to signal new and finished tasks
+
+        bool m_taskRunning;                         //!< Flag used to indicate that a task is running
+
+        bool m_stopTasks;                           //!< Flag used to stop the background thread
+
+        std::string m_taskError;                    //!< The error message of the first failed task
     };
   } // end namespace graph
 } // end namespace te
@@ -29,12 +29,40 @@
 #include "../../common/STLUtils.h"
 #include "../core/Edge.h"
 #include "../core/Vertex.h"
+#include "GraphCache.h"
 #include "GraphData.h"
 
+namespace
+{
+  const std::size_t sm_treeNodeSize = 4 * sizeof(void*);       // approximate size of a node of std::map and std::set, without its value
+  const std::size_t sm_attributeSize = 5 * sizeof(void*);      // approximate size of an attribute and of its pointer
+
+  std::size_t GetVertexSize(te::graph::Vertex* v)
+  {
+    std::size_t adjacency = v->getPredecessors().size() + v->getSuccessors().size() + v->getNeighborhood().size();
 
-te::graph::GraphData::GraphData(int id): 
+    return sm_treeNodeSize + sizeof(int) + sizeof(te::graph::Vertex*) + sizeof(te::graph::Vertex) +
+           adjacency * (sm_treeNodeSize + sizeof(int)) +
+           v->getAttributes().size() * sm_attributeSize;
+  }
+
+  std::size_t GetEdgeSize(te::graph::Edge* e)
+  {
+    return sm_treeNodeSize + sizeof(int) + sizeof(te::graph::Edge*) + sizeof(te::graph::Edge) +
+           e->getAttributes().size() * sm_attributeSize;
+  }
+
+  std::size_t Subtract(std::size_t total, std::size_t size)
+  {
+    return total > size ? total - size : 0;
+  }
+}
+
+te::graph::GraphData::GraphData(int id, GraphCache* cache): 
   m_id(id),
-  m_dirty(false)
+  m_dirty(false),
+  m_cache(cache),
+  m_memorySize(0)
 {
 }
 
@@ -54,7 +82,13 @@ int te::graph::GraphData::getId()
 
 void te::graph::GraphData::addVertex(Vertex* v)
 {
-  m_vertexMap.insert(te::graph::GraphData::VertexMap::value_type(v->getId(), v));
+  if(m_vertexMap.insert(te::graph::GraphData::VertexMap::value_type(v->getId(), v)).second)
+  {
+    m_memorySize += GetVertexSize(v);
+
+    if(m_cache)
+      m_cache->indexVertex(v->getId(), this);
+  }
 
   if(v->isDirty() || v->isNew())
   {
@@ -69,6 +103,11 @@ bool te::graph::GraphData::removeVertex(int id)
   if(it == m_vertexMap.end())
     return false;
 
+  m_memorySize = Subtract(m_memorySize, GetVertexSize(it->second));
+
+  if(m_cache)
+    m_cache->unindexVertex(id, this);
+
   m_vertexMap.erase(it);
 
   return true;
@@ -93,12 +132,34 @@ te::graph::GraphData::VertexMap& te::graph::GraphData::getVertexMap()
 
 void te::graph::GraphData::setVertexMap(const VertexMap& map)
 {
+  for(VertexMap::iterator it = m_vertexMap.begin(); it != m_vertexMap.end(); ++it)
+  {
+    m_memorySize = Subtract(m_memorySize, GetVertexSize(it->second));
+
+    if(m_cache)
+      m_cache->unindexVertex(it->first, this);
+  }
+
   m_vertexMap = map;
+
+  for(VertexMap::iterator it = m_vertexMap.begin(); it != m_vertexMap.end(); ++it)
+  {
+    m_memorySize += GetVertexSize(it->second);
+
+    if(m_cache)
+      m_cache->indexVertex(it->first, this);
+  }
 }
 
 void te::graph::GraphData::addEdge(Edge* e)
 {
-  m_edgeMap.insert(te::graph::GraphData::EdgeMap::value_type(e->getId(), e));
+  if(m_edgeMap.insert(te::graph::GraphData::EdgeMap::value_type(e->getId(), e)).second)
+  {
+    m_memorySize += GetEdgeSize(e);
+
+    if(m_cache)
+      m_cache->indexEdge(e->getId(), this);
+  }
 
   if(e->isDirty() || e->isNew())
   {
@@ -113,6 +174,11 @@ bool te::graph::GraphData::removeEdge(int id)
   if(it == m_edgeMap.end())
     return false;
 
+  m_memorySize = Subtract(m_memorySize, GetEdgeSize(it->second));
+
+  if(m_cache)
+    m_cache->unindexEdge(id, this);
+
   m_edgeMap.erase(it);
 
   return true;
@@ -137,7 +203,23 @@ te::graph::GraphData::EdgeMap& te::graph::GraphData::getEdgeMap()
 
 void te::graph::GraphData::setEdgeMap(const EdgeMap& map)
 {
+  for(EdgeMap::iterator it = m_edgeMap.begin(); it != m_edgeMap.end(); ++it)
+  {
+    m_memorySize = Subtract(m_memorySize, GetEdgeSize(it->second));
+
+    if(m_cache)
+      m_cache->unindexEdge(it->first, this);
+  }
+
   m_edgeMap = map;
+
+  for(EdgeMap::iterator it = m_edgeMap.begin(); it != m_edgeMap.end(); ++it)
+  {
+    m_memorySize += GetEdgeSize(it->second);
+
+    if(m_cache)
+      m_cache->indexEdge(it->first, this);
+  }
 }
 
 void te::graph::GraphData::setDirty(bool status)
@@ -149,3 +231,8 @@ bool te::graph::GraphData::isDirty()
 {
   return m_dirty;
 }
+
+std::size_t te::graph::GraphData::getMemorySize()
+{
+  return m_memorySize;
+}
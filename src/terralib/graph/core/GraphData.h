@@ -32,6 +32,7 @@
 #include "../Config.h"
 
 // STL Includes
+#include <cstddef>
 #include <map>
 
 namespace te
@@ -41,6 +42,7 @@ namespace te
     //forward declarations
     class Vertex;
     class Edge;
+    class GraphCache;
     
     /*!
       \class GraphData
@@ -49,6 +51,11 @@ namespace te
          a map of vertex and edges. A flag is used to indicate
          if any element of this group was changed.
 
+         A graph data owned by a graph cache informs the cache
+         about the elements added and removed, so the cache keeps
+         an index of the graph data that contains each element.
+         It also keeps an estimate of the memory used by its elements.
+
       \sa GraphCache
     */
 
@@ -56,8 +63,14 @@ namespace te
     {
       public:
 
-        /*! \brief Default constructor. */
-        GraphData(int id);
+        /*!
+          \brief Default constructor.
+
+          \param id    The graph data identifier.
+
+          \param cache The graph cache that owns this graph data, if any.
+        */
+        GraphData(int id, GraphCache* cache = 0);
 
         /*! \brief Default destructor. */
         ~GraphData();
@@ -140,10 +153,23 @@ namespace te
         */
         bool isDirty();
 
+        /*!
+        \brief Used to get an estimate of the memory used by the elements
+
+        \note The estimate of an element is computed when it is added,
+              so its attributes and adjacency must be set before.
+
+        \return The estimate in bytes
+
+        */
+        std::size_t getMemorySize();
+
       private:
 
         int             m_id;      //!< Data identifier
         bool            m_dirty;        //!< Flag used to indicate that a element was changed
+        GraphCache*     m_cache;        //!< The graph cache informed about the elements added and removed
+        std::size_t     m_memorySize;   //!< Estimate of the memory used by the elements
 
         VertexMap       m_vertexMap;    //!< This map contains all vertexs from this graph.
         EdgeMap         m_edgeMap;      //!< This map contains all edges from this graph.
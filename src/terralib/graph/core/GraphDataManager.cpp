@@ -76,6 +76,9 @@ void te::graph::GraphDataManager::saveGraphData(GraphData* data)
 {
   if(m_loadStrategy)
   {
+    //the prefetched elements may be older than the data source
+    m_loadStrategy->discardPrefetch();
+
     m_loadStrategy->saveData(data);
   }
 }
@@ -84,6 +87,9 @@ void te::graph::GraphDataManager::removeEdge(int id)
 {
   if(m_loadStrategy)
   {
+    //the prefetched elements may be older than the data source
+    m_loadStrategy->discardPrefetch();
+
     m_loadStrategy->removeEdge(id);
   }
 }
@@ -92,6 +98,9 @@ void te::graph::GraphDataManager::removeVertex(int id)
 {
   if(m_loadStrategy)
   {
+    //the prefetched elements may be older than the data source
+    m_loadStrategy->discardPrefetch();
+
     m_loadStrategy->removeVertex(id);
   }
 }
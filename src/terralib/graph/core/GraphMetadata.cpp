@@ -44,6 +44,8 @@ te::graph::GraphMetadata::GraphMetadata(te::da::DataSource* ds) :
 {
   m_maxCacheSize = te::graph::Globals::sm_graphCacheDefaultMaxSize;
   m_maxVecCacheSize = te::graph::Globals::sm_graphVecCacheDefaultMaxSize;
+  m_maxCacheMemory = te::graph::Globals::sm_graphCacheDefaultMaxMemory;
+  m_asyncCache = te::graph::Globals::sm_graphCacheDefaultAsync;
   m_boxPercentSize = te::graph::Globals::sm_boxLoaderStrategyDefaultSize;
   m_memoryGraph = false;
 }
@@ -318,6 +318,8 @@ namespace te
 
         size_t m_maxCacheSize;          //!< Attribute used to set the max cache size
         size_t m_maxVecCacheSize;       //!< Attribute used to set the max vector cache size
+        size_t m_maxCacheMemory;        //!< Attribute used to set the max cache memory in bytes (0 means no memory limit)
+        bool m_asyncCache;              //!< Flag used to write back and prefetch the graph data in a background thread
         double m_boxPercentSize;        //!< Attribute used to box percent size used in loader strategy
 
         bool m_memoryGraph;             //!< Flag used to indicate if the graph is a memory graph
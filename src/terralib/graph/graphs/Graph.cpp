@@ -131,6 +131,9 @@ void te::graph::Graph::removeVertex(int id)
 
   if(m_dataManager)
   {
+    //the released graph data must be saved before
+    m_graphCache->waitTasks();
+
     m_dataManager->removeVertex(id);
   }
 }
@@ -227,6 +230,9 @@ void te::graph::Graph::removeEdge(int id)
 
   if(m_dataManager)
   {
+    //the released graph data must be saved before
+    m_graphCache->waitTasks();
+
     m_dataManager->removeEdge(id);
   }
 }
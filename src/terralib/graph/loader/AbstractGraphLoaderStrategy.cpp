@@ -49,13 +49,23 @@
 #include "../Exception.h"
 #include "AbstractGraphLoaderStrategy.h"
 
+// STL Includes
+#include <memory>
 
-te::graph::AbstractGraphLoaderStrategy::AbstractGraphLoaderStrategy(te::graph::GraphMetadata* metadata) : m_graphMetadata(metadata)
+// Boost Includes
+#include <boost/bind.hpp>
+
+
+te::graph::AbstractGraphLoaderStrategy::AbstractGraphLoaderStrategy(te::graph::GraphMetadata* metadata) : m_graphMetadata(metadata),
+  m_prefetchData(0),
+  m_prefetchValid(false)
 {
 }
 
 te::graph::AbstractGraphLoaderStrategy::~AbstractGraphLoaderStrategy()
 {
+  delete m_prefetchData;
+
   delete m_graphMetadata;
 }
 
@@ -64,6 +74,111 @@ te::graph::GraphMetadata* te::graph::AbstractGraphLoaderStrategy::getMetadata()
   return m_graphMetadata;
 }
 
+void te::graph::AbstractGraphLoaderStrategy::discardPrefetch()
+{
+  m_prefetchValid = false;
+}
+
+void te::graph::AbstractGraphLoaderStrategy::prefetch(te::graph::GraphCache* gc, const boost::function<void(GraphData*)>& load)
+{
+  if(gc == 0)
+    return;
+
+  gc->addTask(boost::bind(&AbstractGraphLoaderStrategy::runPrefetch, this, load));
+}
+
+te::graph::GraphData* te::graph::AbstractGraphLoaderStrategy::takePrefetchedVertex(int vertexId, te::graph::GraphCache* gc)
+{
+  std::auto_ptr<te::graph::GraphData> data(takePrefetchedData(gc));
+
+  if(data.get() == 0 || data->getVertex(vertexId) == 0)
+    return 0;
+
+  return data.release();
+}
+
+te::graph::GraphData* te::graph::AbstractGraphLoaderStrategy::takePrefetchedEdge(int edgeId, te::graph::GraphCache* gc)
+{
+  std::auto_ptr<te::graph::GraphData> data(takePrefetchedData(gc));
+
+  if(data.get() == 0 || data->getEdge(edgeId) == 0)
+    return 0;
+
+  return data.release();
+}
+
+void te::graph::AbstractGraphLoaderStrategy::addData(GraphData* data, te::graph::AbstractGraph* g, te::graph::GraphCache* gc)
+{
+  te::graph::GraphData::VertexMap::iterator itVertex = data->getVertexMap().begin();
+
+  while(itVertex != data->getVertexMap().end())
+  {
+    //verify if its already in cache
+    if(gc && gc->checkCacheByVertexId(itVertex->first))
+      delete itVertex->second;
+    else
+      g->add(itVertex->second);
+
+    ++itVertex;
+  }
+
+  data->getVertexMap().clear();
+
+  te::graph::GraphData::EdgeMap::iterator itEdge = data->getEdgeMap().begin();
+
+  while(itEdge != data->getEdgeMap().end())
+  {
+    //verify if its already in cache
+    if(gc && gc->checkCacheByEdgeId(itEdge->first))
+      delete itEdge->second;
+    else
+      g->add(itEdge->second);
+
+    ++itEdge;
+  }
+
+  data->getEdgeMap().clear();
+}
+
+void te::graph::AbstractGraphLoaderStrategy::runPrefetch(const boost::function<void(GraphData*)>& load)
+{
+  std::auto_ptr<te::graph::GraphData> data(new te::graph::GraphData(-1));
+
+  //a failed prefetch is ignored, the elements will be loaded when requested
+  try
+  {
+    load(data.get());
+  }
+  catch(...)
+  {
+    return;
+  }
+
+  delete m_prefetchData;
+
+  m_prefetchData = data.release();
+
+  m_prefetchValid = true;
+}
+
+te::graph::GraphData* te::graph::AbstractGraphLoaderStrategy::takePrefetchedData(te::graph::GraphCache* gc)
+{
+  //the prefetch is only accessed when the background thread is idle
+  if(gc)
+    gc->waitTasks();
+
+  std::auto_ptr<te::graph::GraphData> data(m_prefetchData);
+
+  m_prefetchData = 0;
+
+  if(!m_prefetchValid)
+    return 0;
+
+  m_prefetchValid = false;
+
+  return data.release();
+}
+
 void te::graph::AbstractGraphLoaderStrategy::saveData(GraphData* data)
 {
   if(m_graphMetadata == 0 || m_graphMetadata->getDataSource() == 0)
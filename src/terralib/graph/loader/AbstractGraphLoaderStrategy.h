@@ -32,6 +32,9 @@
 #include "../core/GraphMetadata.h"
 #include "../Config.h"
 
+// Boost Includes
+#include <boost/function.hpp>
+
 namespace te
 {
   namespace graph
@@ -49,6 +52,11 @@ namespace te
         save and load the graph data and metadata information
         using the Graph Cache conception.
 
+        A strategy may prefetch, in the background thread of an
+        asynchronous graph cache, the group of elements that is likely
+        to be requested next. The prefetched elements are discarded
+        when the data source is changed.
+
       \sa AbstractGraph, GraphMetadata, GraphCache
     */
 
@@ -122,6 +130,11 @@ namespace te
         */
         te::graph::GraphMetadata* getMetadata();
 
+        /*!
+          \brief It discards the prefetched elements, because the data source may have changed.
+        */
+        void discardPrefetch();
+
       protected:
 
         /*!
@@ -196,11 +209,63 @@ namespace te
         */
         Edge* loadEdgeAttrs(int id);
 
+        /*!
+          \brief Function used to load a group of elements in the background thread of the graph cache.
+
+          \param gc   The graph cache, the elements are only prefetched if it is asynchronous
+          \param load Function that loads the elements in a graph data that does not belong to a cache
+
+          \note The load function must only access the data source and the metadata.
+        */
+        void prefetch(te::graph::GraphCache* gc, const boost::function<void(GraphData*)>& load);
+
+        /*!
+          \brief Function used to get the prefetched elements if they contain a vertex
+
+          \param vertexId  The vertex identifier
+          \param gc        The graph cache that runs the prefetch
+
+          \return The prefetched elements, the caller takes their ownership, or a null pointer. The prefetched elements are always consumed.
+        */
+        GraphData* takePrefetchedVertex(int vertexId, te::graph::GraphCache* gc);
+
+        /*!
+          \brief Function used to get the prefetched elements if they contain an edge
+
+          \param edgeId  The edge identifier
+          \param gc      The graph cache that runs the prefetch
+
+          \return The prefetched elements, the caller takes their ownership, or a null pointer. The prefetched elements are always consumed.
+        */
+        GraphData* takePrefetchedEdge(int edgeId, te::graph::GraphCache* gc);
+
+        /*!
+          \brief Function used to add to a graph the elements of a graph data that does not belong to a cache
+
+          \param data  The graph data, it will be empty
+          \param g     Pointer to a graph
+          \param gc    If present, the elements already in cache are deleted instead of added
+        */
+        void addData(GraphData* data, te::graph::AbstractGraph* g, te::graph::GraphCache* gc);
+
         //@}
 
+      private:
+
+        /*! \brief It runs a prefetch in the background thread. */
+        void runPrefetch(const boost::function<void(GraphData*)>& load);
+
+        /*! \brief It returns the valid prefetched elements, waiting for the background thread. */
+        GraphData* takePrefetchedData(te::graph::GraphCache* gc);
+
        protected:
 
         te::graph::GraphMetadata* m_graphMetadata; //!< Graph metadata attribute
+
+      private:
+
+        GraphData* m_prefetchData;                 //!< The elements loaded in the background
+        bool m_prefetchValid;                      //!< Flag used to indicate that the data source was not changed after the prefetch
     };
   } // end namespace graph
 } // end namespace te
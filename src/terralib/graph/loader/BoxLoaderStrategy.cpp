@@ -49,6 +49,13 @@
 #include "../Exception.h"
 #include "BoxLoaderStrategy.h"
 
+// STL Includes
+#include <cmath>
+#include <memory>
+
+// Boost Includes
+#include <boost/bind.hpp>
+
 
 te::graph::BoxLoaderStrategy::BoxLoaderStrategy(te::graph::GraphMetadata* metadata) : AbstractGraphLoaderStrategy(metadata)
 {
@@ -113,6 +120,42 @@ void te::graph::BoxLoaderStrategy::loadDataByVertexId(int vertexId, te::graph::A
   //calculate box
   te::gm::Envelope* envelope = calculateBox(point, vertexAttrTable);
 
+  int srid = point->getSRID();
+
+  std::string graphType = g->getMetadata()->getType();
+
+  std::auto_ptr<te::graph::GraphData> data(takePrefetchedVertex(vertexId, gc));
+
+  if(data.get() != 0)
+  {
+    *envelope = m_prefetchBox;
+  }
+  else
+  {
+    data.reset(new te::graph::GraphData(-1));
+
+    loadBoxVertices(*envelope, srid, geometryAttrName, graphType, data.get());
+  }
+
+  addData(data.get(), g, gc);
+
+  //prefetch the adjacent box in the direction of travel
+  if(calculateNextBox(*envelope, m_prefetchBox))
+    prefetch(gc, boost::bind(&BoxLoaderStrategy::loadBoxVertices, this, m_prefetchBox, srid, geometryAttrName, graphType, _1));
+
+  m_lastBox = *envelope;
+
+  delete vAux;
+  delete envelope;
+}
+
+
+void te::graph::BoxLoaderStrategy::loadBoxVertices(const te::gm::Envelope& box, int srid, const std::string& geometryAttrName, const std::string& graphType, GraphData* data)
+{
+  //get the tables names
+  std::string vertexAttrTable = m_graphMetadata->getVertexTableName();
+  std::string edgeAttrTable = m_graphMetadata->getEdgeTableName();
+
   //get all id's from vertex and edges that is inside that box
   
   //filds
@@ -151,8 +194,7 @@ void te::graph::BoxLoaderStrategy::loadDataByVertexId(int vertexId, te::graph::A
   
   std::string vEttr = "vertex." + geometryAttrName;
 
-  int srid = point->getSRID();
-  te::da::LiteralEnvelope* lenv = new te::da::LiteralEnvelope(*envelope, srid);
+  te::da::LiteralEnvelope* lenv = new te::da::LiteralEnvelope(box, srid);
   te::da::Field* fvattr = new te::da::Field(vEttr);
   te::da::ST_Intersects* intersects = new te::da::ST_Intersects(fvattr->getExpression(), lenv);
 
@@ -170,8 +212,6 @@ void te::graph::BoxLoaderStrategy::loadDataByVertexId(int vertexId, te::graph::A
 
   int vertexProperties = vertexDsType->getProperties().size();
 
-  std::string graphType = g->getMetadata()->getType();
-
   te::graph::Vertex* v = 0;
 
   int currentId = -1;
@@ -186,8 +226,9 @@ void te::graph::BoxLoaderStrategy::loadDataByVertexId(int vertexId, te::graph::A
 
     if(currentId != vId)
     {
-      //verify if its already in cache
-      if(gc->checkCacheByVertexId(vId) == nullptr)
+      v = data->getVertex(vId);
+
+      if(v == 0)
       {
         v = new te::graph::Vertex(vId, false);
 
@@ -198,7 +239,7 @@ void te::graph::BoxLoaderStrategy::loadDataByVertexId(int vertexId, te::graph::A
           v->addAttribute(i - 1, dataset->getValue(i).release());
         }
 
-        g->add(v);
+        data->addVertex(v);
       }
 
       currentId = vId;
@@ -217,9 +258,6 @@ void te::graph::BoxLoaderStrategy::loadDataByVertexId(int vertexId, te::graph::A
       //TODO for other graph types
     }
   }
-
-  delete vAux;
-  delete envelope;
 }
 
 
@@ -297,6 +335,40 @@ void te::graph::BoxLoaderStrategy::loadDataByEdgeId(int edgeId, te::graph::Abstr
   //calculate box
   te::gm::Envelope* envelope = calculateBox(point, vertexAttrTable);
 
+  int srid = point->getSRID();
+
+  std::auto_ptr<te::graph::GraphData> data(takePrefetchedEdge(edgeId, gc));
+
+  if(data.get() != 0)
+  {
+    *envelope = m_prefetchBox;
+  }
+  else
+  {
+    data.reset(new te::graph::GraphData(-1));
+
+    loadBoxEdges(*envelope, srid, geometryAttrName, data.get());
+  }
+
+  addData(data.get(), g, gc);
+
+  //prefetch the adjacent box in the direction of travel
+  if(calculateNextBox(*envelope, m_prefetchBox))
+    prefetch(gc, boost::bind(&BoxLoaderStrategy::loadBoxEdges, this, m_prefetchBox, srid, geometryAttrName, _1));
+
+  m_lastBox = *envelope;
+
+  delete vAux;
+  delete envelope;
+}
+
+
+void te::graph::BoxLoaderStrategy::loadBoxEdges(const te::gm::Envelope& box, int srid, const std::string& geometryAttrName, GraphData* data)
+{
+  //get the tables names
+  std::string vertexAttrTable = m_graphMetadata->getVertexTableName();
+  std::string edgeAttrTable = m_graphMetadata->getEdgeTableName();
+
   //get all id's from vertex and edges that is inside that box
   
   //filds
@@ -335,8 +407,7 @@ void te::graph::BoxLoaderStrategy::loadDataByEdgeId(int edgeId, te::graph::Abstr
   
   std::string vEttr = "vertex." + geometryAttrName;
 
-  int srid = point->getSRID();
-  te::da::LiteralEnvelope* lenv = new te::da::LiteralEnvelope(*envelope, srid);
+  te::da::LiteralEnvelope* lenv = new te::da::LiteralEnvelope(box, srid);
   te::da::Field* fvattr = new te::da::Field(vEttr);
   te::da::ST_Intersects* intersects = new te::da::ST_Intersects(fvattr->getExpression(), lenv);
 
@@ -356,8 +427,6 @@ void te::graph::BoxLoaderStrategy::loadDataByEdgeId(int edgeId, te::graph::Abstr
   int vertexProperties = vertexDsType->getProperties().size();
   int edgeProperties = edgeDsType->getProperties().size();
 
-  std::string graphType = g->getMetadata()->getType();
-
   int currentId = -1;
 
   //list of all attributes: edge table + vertex table + vertex table
@@ -369,27 +438,23 @@ void te::graph::BoxLoaderStrategy::loadDataByEdgeId(int edgeId, te::graph::Abstr
 
     if(currentId != eId)
     {
-      //verify if its already in cache
-      if(gc->checkCacheByEdgeId(eId) == 0)
-      {
-        te::graph::Edge* e = new te::graph::Edge(eId, vFrom, vTo, false);
+      te::graph::Edge* e = new te::graph::Edge(eId, vFrom, vTo, false);
 
-        e->setAttributeVecSize(edgeProperties - 3);
+      e->setAttributeVecSize(edgeProperties - 3);
 
-        for(int i = 3; i < edgeProperties; ++i)
-        {
-          e->addAttribute(i - 3, dataset->getValue(i + vertexProperties).release());
-        };
+      for(int i = 3; i < edgeProperties; ++i)
+      {
+        e->addAttribute(i - 3, dataset->getValue(i + vertexProperties).release());
+      };
 
-        g->add(e);
-      }
+      if(!data->getEdge(eId))
+        data->addEdge(e);
+      else
+        delete e;
 
       currentId = eId;
     }
   }
-
-  delete vAux;
-  delete envelope;
 }
 
 
@@ -416,6 +481,47 @@ te::gm::Envelope* te::graph::BoxLoaderStrategy::calculateBox(te::gm::Point* p, s
 }
 
 
+bool te::graph::BoxLoaderStrategy::calculateNextBox(const te::gm::Envelope& box, te::gm::Envelope& nextBox)
+{
+  if(!m_lastBox.isValid())
+    return false;
+
+  te::gm::Coord2D center = box.getCenter();
+  te::gm::Coord2D lastCenter = m_lastBox.getCenter();
+
+  double dx = center.x - lastCenter.x;
+  double dy = center.y - lastCenter.y;
+
+  double w = box.getWidth();
+  double h = box.getHeight();
+
+  if((dx == 0. && dy == 0.) || w <= 0. || h <= 0.)
+    return false;
+
+  nextBox = box;
+
+  //move along the main direction, relative to the box size
+  if(std::fabs(dx) * h >= std::fabs(dy) * w)
+  {
+    double shift = dx > 0. ? w : -w;
+
+    nextBox.m_llx += shift;
+    nextBox.m_urx += shift;
+  }
+  else
+  {
+    double shift = dy > 0. ? h : -h;
+
+    nextBox.m_lly += shift;
+    nextBox.m_ury += shift;
+  }
+
+  te::gm::Envelope* extent = getMetadata()->getEnvelope();
+
+  return extent == 0 || nextBox.intersects(*extent);
+}
+
+
 /*
 void te::graph::BoxLoaderStrategy::loadDataByVertexId(int vertexId, te::graph::AbstractGraph* g, te::graph::GraphCache* gc)
 {
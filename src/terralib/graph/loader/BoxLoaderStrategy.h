@@ -30,6 +30,7 @@
 #define __TERRALIB_GRAPH_INTERNAL_BOXLOADERSTRATEGY_H
 
 // Terralib Includes
+#include "../../geometry/Envelope.h"
 #include "../Config.h"
 #include "../Enums.h"
 #include "AbstractGraphLoaderStrategy.h"
@@ -68,6 +69,10 @@ namespace te
             using as strategy a bounding box to create a region
             that defines a group of elements.
 
+            With an asynchronous graph cache, the box adjacent to the
+            last loaded box, in the direction of travel from the previous
+            one, is prefetched after each load.
+
       \sa AbstractGraphLoaderStrategy
     */
 
@@ -124,6 +129,42 @@ namespace te
           \return Terralib object that defines geometric region.
         */
         te::gm::Envelope* calculateBox(te::gm::Point* p, std::string tableName);
+
+        /*!
+          \brief Generate the box adjacent to a box, in the direction of travel from the last loaded box.
+
+          \param box     The loaded box.
+          \param nextBox The adjacent box.
+
+          \return False if there is no direction of travel or if the adjacent box is outside the graph extent.
+        */
+        bool calculateNextBox(const te::gm::Envelope& box, te::gm::Envelope& nextBox);
+
+        /*!
+          \brief Function used to load the vertex elements inside a box, and their adjacency
+
+          \param box               The box.
+          \param srid              The box SRID.
+          \param geometryAttrName  The name of the vertex geometry attribute.
+          \param graphType         The graph type, used to set the vertex adjacency.
+          \param data              The graph data that receives the vertex elements.
+        */
+        void loadBoxVertices(const te::gm::Envelope& box, int srid, const std::string& geometryAttrName, const std::string& graphType, GraphData* data);
+
+        /*!
+          \brief Function used to load the edge elements with a vertex inside a box
+
+          \param box               The box.
+          \param srid              The box SRID.
+          \param geometryAttrName  The name of the vertex geometry attribute.
+          \param data              The graph data that receives the edge elements.
+        */
+        void loadBoxEdges(const te::gm::Envelope& box, int srid, const std::string& geometryAttrName, GraphData* data);
+
+      private:
+
+        te::gm::Envelope m_lastBox;       //!< The last loaded box.
+        te::gm::Envelope m_prefetchBox;   //!< The box of the prefetched elements.
     };
   } // end namespace graph
 } // end namespace te
@@ -47,6 +47,12 @@
 #include "../Exception.h"
 #include "SequenceLoaderStrategy.h"
 
+// STL Includes
+#include <memory>
+
+// Boost Includes
+#include <boost/bind.hpp>
+
 
 te::graph::SequenceLoaderStrategy::SequenceLoaderStrategy(te::graph::GraphMetadata* metadata) : AbstractGraphLoaderStrategy(metadata)
 {
@@ -70,6 +76,31 @@ void te::graph::SequenceLoaderStrategy::loadDataByVertexId(int vertexId, te::gra
     throw Exception(TE_TR("TO DO"));
   }
 
+  std::string graphType = g->getMetadata()->getType();
+
+  std::auto_ptr<te::graph::GraphData> data(takePrefetchedVertex(vertexId, gc));
+
+  if(data.get() == 0)
+  {
+    data.reset(new te::graph::GraphData(-1));
+
+    loadVertices(vertexId, graphType, data.get());
+  }
+
+  if(data->getVertexMap().empty())
+    return;
+
+  int nextId = data->getVertexMap().rbegin()->first + 1;
+
+  addData(data.get(), g, gc);
+
+  //prefetch the next sequence
+  prefetch(gc, boost::bind(&SequenceLoaderStrategy::loadVertices, this, nextId, graphType, _1));
+}
+
+
+void te::graph::SequenceLoaderStrategy::loadVertices(int vertexId, const std::string& graphType, GraphData* data)
+{
   //get the table names
   std::string vertexAttrTable = m_graphMetadata->getVertexTableName();
   std::string edgeAttrTable = m_graphMetadata->getEdgeTableName();
@@ -136,8 +167,6 @@ void te::graph::SequenceLoaderStrategy::loadDataByVertexId(int vertexId, te::gra
 
   int vertexProperties = vertexDsType->getProperties().size();
 
-  std::string graphType = g->getMetadata()->getType();
-
   te::graph::Vertex* v = 0;
 
   int currentId = -1;
@@ -152,8 +181,9 @@ void te::graph::SequenceLoaderStrategy::loadDataByVertexId(int vertexId, te::gra
 
     if(currentId != vId)
     {
-      //verify if its already in cache
-      if(gc->checkCacheByVertexId(vId) == nullptr)
+      v = data->getVertex(vId);
+
+      if(v == 0)
       {
         v = new te::graph::Vertex(vId, false);
 
@@ -164,7 +194,7 @@ void te::graph::SequenceLoaderStrategy::loadDataByVertexId(int vertexId, te::gra
           v->addAttribute(i - 1, dataset->getValue(i).release());
         }
 
-        g->add(v);
+        data->addVertex(v);
       }
 
       currentId = vId;
@@ -199,6 +229,29 @@ void te::graph::SequenceLoaderStrategy::loadDataByEdgeId(int edgeId, te::graph::
     throw Exception(TE_TR("TO DO"));
   }
 
+  std::auto_ptr<te::graph::GraphData> data(takePrefetchedEdge(edgeId, gc));
+
+  if(data.get() == 0)
+  {
+    data.reset(new te::graph::GraphData(-1));
+
+    loadEdges(edgeId, data.get());
+  }
+
+  if(data->getEdgeMap().empty())
+    return;
+
+  int nextId = data->getEdgeMap().rbegin()->first + 1;
+
+  addData(data.get(), g, gc);
+
+  //prefetch the next sequence
+  prefetch(gc, boost::bind(&SequenceLoaderStrategy::loadEdges, this, nextId, _1));
+}
+
+
+void te::graph::SequenceLoaderStrategy::loadEdges(int edgeId, GraphData* data)
+{
   //get the tables names
   std::string edgeTable = m_graphMetadata->getEdgeTableName();
 
@@ -247,19 +300,15 @@ void te::graph::SequenceLoaderStrategy::loadDataByEdgeId(int edgeId, te::graph::
     int vFromId = dataset->getInt32(1);   //second item is the vertefFrom id
     int vToId = dataset->getInt32(2);     //third item is the verteTo id
     
-    //verify if its already in cache
-    if(gc->checkCacheByEdgeId(edgeId) == 0)
-    {
-      te::graph::Edge* e = new te::graph::Edge(edgeId, vFromId, vToId, false);
+    te::graph::Edge* e = new te::graph::Edge(edgeId, vFromId, vToId, false);
 
-      e->setAttributeVecSize(edgeProperties - 3);
+    e->setAttributeVecSize(edgeProperties - 3);
 
-      for(int i = 3; i < edgeProperties; ++i)
-      {
-        e->addAttribute(i - 3, dataset->getValue(i).release());
-      };
+    for(int i = 3; i < edgeProperties; ++i)
+    {
+      e->addAttribute(i - 3, dataset->getValue(i).release());
+    };
 
-      g->add(e);
-    }
+    data->addEdge(e);
   }
 }
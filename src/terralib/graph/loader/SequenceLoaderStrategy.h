@@ -61,6 +61,9 @@ namespace te
         using as strategy a "order by" to create a sequence
         of objects.
 
+        With an asynchronous graph cache, the next sequence of
+        objects is prefetched after each load.
+
       \sa AbstractGraphLoaderStrategy
     */
 
@@ -104,6 +107,25 @@ namespace te
         virtual void loadDataByEdgeId(int edgeId, te::graph::AbstractGraph* g, te::graph::GraphCache* gc = 0);
 
         //@}
+
+      protected:
+
+        /*!
+          \brief Function used to load the vertex elements with identifier from vertexId to vertexId plus the max cache size
+
+          \param vertexId  The first vertex identifier
+          \param graphType The graph type, used to set the vertex adjacency
+          \param data      The graph data that receives the vertex elements
+        */
+        void loadVertices(int vertexId, const std::string& graphType, GraphData* data);
+
+        /*!
+          \brief Function used to load the edge elements with identifier from edgeId to edgeId plus the max cache size
+
+          \param edgeId  The first edge identifier
+          \param data    The graph data that receives the edge elements
+        */
+        void loadEdges(int edgeId, GraphData* data);
     };
   } // end namespace graph
 } // end namespace te
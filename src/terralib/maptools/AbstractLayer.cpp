@@ -41,7 +41,9 @@ te::map::AbstractLayer::AbstractLayer(AbstractLayer* parent)
     m_grouping(0),
     m_chart(0),
     m_compositionMode(te::map::SourceOver),
-    m_encoding(te::core::EncodingType::UTF8)
+    m_encoding(te::core::EncodingType::UTF8),
+    m_lodEnabled(false),
+    m_lodCacheEnabled(false)
 {
 }
 
@@ -56,7 +58,9 @@ te::map::AbstractLayer::AbstractLayer(const std::string& id, AbstractLayer* pare
     m_grouping(0),
     m_chart(0),
     m_compositionMode(te::map::SourceOver),
-    m_encoding(te::core::EncodingType::UTF8)
+    m_encoding(te::core::EncodingType::UTF8),
+    m_lodEnabled(false),
+    m_lodCacheEnabled(false)
 {
 }
 
@@ -74,7 +78,9 @@ te::map::AbstractLayer::AbstractLayer(const std::string& id,
     m_grouping(0),
     m_chart(0),
     m_compositionMode(te::map::SourceOver),
-    m_encoding(te::core::EncodingType::UTF8)
+    m_encoding(te::core::EncodingType::UTF8),
+    m_lodEnabled(false),
+    m_lodCacheEnabled(false)
 {
 }
 
@@ -344,6 +350,26 @@ void te::map::AbstractLayer::setEncoding(te::core::EncodingType et)
   m_encoding = et;
 }
 
+bool te::map::AbstractLayer::isLODEnabled() const
+{
+  return m_lodEnabled;
+}
+
+void te::map::AbstractLayer::setLODEnabled(bool on)
+{
+  m_lodEnabled = on;
+}
+
+bool te::map::AbstractLayer::isLODCacheEnabled() const
+{
+  return m_lodCacheEnabled;
+}
+
+void te::map::AbstractLayer::setLODCacheEnabled(bool on)
+{
+  m_lodCacheEnabled = on;
+}
+
 void te::map::AbstractLayer::setOutOfDate()
 {
 }
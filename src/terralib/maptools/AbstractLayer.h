@@ -517,6 +517,41 @@ namespace te
         */
         void setEncoding(te::core::EncodingType et);
 
+        /*!
+          \brief It returns true if the level of detail drawing mode is enabled.
+
+          In this mode, the features smaller than a pixel are not drawn and the
+          vertices of the geometries are decimated to the pixel size before drawing.
+
+          \return True if the level of detail drawing mode is enabled.
+        */
+        bool isLODEnabled() const;
+
+        /*!
+          \brief It enables or disables the level of detail drawing mode.
+
+          \param on True to enable the level of detail drawing mode.
+        */
+        void setLODEnabled(bool on);
+
+        /*!
+          \brief It returns true if a multi-resolution geometry cache is used in the level of detail drawing mode.
+
+          \return True if the layer uses a multi-resolution geometry cache.
+
+          \sa GeometryLODCache
+        */
+        bool isLODCacheEnabled() const;
+
+        /*!
+          \brief It enables or disables the use of a multi-resolution geometry cache in the level of detail drawing mode.
+
+          The cache is built in background the first time the layer is drawn.
+
+          \param on True to use a multi-resolution geometry cache.
+        */
+        void setLODCacheEnabled(bool on);
+
         /*!
           \brief Its indicate that the layer schema is out of date.
         */
@@ -567,6 +602,8 @@ namespace te
         std::string m_datasetName;                   //!< The dataset name where we will retrieve the layer objects.
         std::string m_datasourceId;                  //!< DataSource id.
         te::core::EncodingType m_encoding;           //!< The char encoding of the layer;
+        bool m_lodEnabled;                           //!< It indicates if the level of detail drawing mode is enabled.
+        bool m_lodCacheEnabled;                      //!< It indicates if a multi-resolution geometry cache is used in the level of detail drawing mode.
     };
 
     typedef boost::intrusive_ptr<AbstractLayer> AbstractLayerPtr;
@@ -72,6 +72,8 @@
 #include "Chart.h"
 #include "ChartRendererManager.h"
 #include "Exception.h"
+#include "GeometryLODCache.h"
+#include "GeometryLODCacheManager.h"
 #include "Grouping.h"
 #include "GroupingItem.h"
 #include "QueryEncoder.h"
@@ -90,7 +92,9 @@
 
 
 te::map::AbstractLayerRenderer::AbstractLayerRenderer()
-  : m_index(0)
+  : m_index(0),
+    m_lodTolerance(0.0),
+    m_lodCacheTolerance(0.0)
 {
 }
 
@@ -140,6 +144,10 @@ void te::map::AbstractLayerRenderer::draw(AbstractLayer* layer,
 
   assert(ibbox.isValid());
 
+  // The size of a pixel, in the map and in the layer SRS, used to generalize the geometries
+  m_lodTolerance = layer->isLODEnabled() ? bbox.getWidth() / canvas->getWidth() : 0.0;
+  m_lodCacheTolerance = layer->isLODCacheEnabled() ? reprojectedBBOX.getWidth() / canvas->getWidth() : 0.0;
+
   // Gets the layer schema
   std::auto_ptr<LayerSchema> schema(layer->getSchema());
   assert(schema.get());
@@ -267,6 +275,10 @@ void te::map::AbstractLayerRenderer::drawLayerGeometries(AbstractLayer* layer,
     // Gets the rule filter
     const te::fe::Filter* filter = rule->getFilter();
 
+    // Without a filter, the generalized geometries may be drawn from the layer LOD cache
+    if(!filter && m_lodCacheTolerance > 0.0 && drawLayerGeometriesFromCache(layer, rule, canvas, bbox, srid, cancel))
+      continue;
+
     // Let's retrieve the correct dataset
     std::auto_ptr<te::da::DataSet> dataset;
 
@@ -382,6 +394,50 @@ void te::map::AbstractLayerRenderer::drawLayerGeometries(AbstractLayer* layer,
   }   // end for each <Rule>
 }
 
+bool te::map::AbstractLayerRenderer::drawLayerGeometriesFromCache(AbstractLayer* layer,
+                                                                  te::se::Rule* rule,
+                                                                  Canvas* canvas,
+                                                                  const te::gm::Envelope& bbox,
+                                                                  int srid,
+                                                                  bool* cancel)
+{
+  // Charts and texts need the attributes of the data set
+  if(layer->getChart() != 0)
+    return false;
+
+  const std::vector<te::se::Symbolizer*>& symbolizers = rule->getSymbolizers();
+
+  if(symbolizers.empty())
+    return false;
+
+  for(std::size_t i = 0; i < symbolizers.size(); ++i)
+  {
+    if(symbolizers[i]->getType() == "TextSymbolizer")
+      return false;
+  }
+
+  boost::shared_ptr<GeometryLODCache> cache = GeometryLODCacheManager::getInstance().get(layer);
+
+  // The cache may still be in construction
+  if(!cache->isReady())
+    return false;
+
+  CanvasConfigurer cc(canvas);
+
+  for(std::size_t i = 0; i < symbolizers.size(); ++i)
+  {
+    cc.config(symbolizers[i]);
+
+    if(!cache->draw(canvas, bbox, srid, m_lodCacheTolerance, cancel))
+      return false;
+
+    if(cancel != 0 && (*cancel))
+      return true;
+  }
+
+  return true;
+}
+
 void te::map::AbstractLayerRenderer::drawLayerGrouping(AbstractLayer* layer,
                                                        const std::string& geomPropertyName,
                                                        Canvas* canvas,
@@ -709,6 +765,10 @@ void te::map::AbstractLayerRenderer::drawLayerGroupingMem(AbstractLayer* layer,
         geom->transform(srid);
       }
 
+      // Skips the geometries smaller than a pixel
+      if(m_lodTolerance > 0.0 && !Generalize(geom.get(), m_lodTolerance))
+        break;
+
       canvas->draw(geom.get());
 
       if(chart && j == nSymbolizers - 1)
@@ -778,6 +838,10 @@ void te::map::AbstractLayerRenderer::drawDatSetGeometries(te::da::DataSet* datas
       geom->transform(toSRID);
     }
 
+    // Skips the geometries smaller than a pixel
+    if(m_lodTolerance > 0.0 && !Generalize(geom.get(), m_lodTolerance))
+      continue;
+
     canvas->draw(geom.get());
 
     if(chart)
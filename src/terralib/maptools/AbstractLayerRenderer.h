@@ -58,6 +58,7 @@ namespace te
   namespace se
   {
     class FeatureTypeStyle;
+    class Rule;
     class TextSymbolizer;
   }
 
@@ -89,6 +90,27 @@ namespace te
 
       protected:
 
+        /*!
+          \brief It draws the geometries of a rule from the layer LOD cache.
+
+          \param layer  The layer that will be drawn.
+          \param rule   The rule, without a filter, that will be drawn.
+          \param canvas The canvas were the layer objects will be drawn.
+          \param bbox   The interest area to render the map, in the layer SRS.
+          \param srid   The SRID to be used to draw the layer objects.
+          \param cancel The cancel flag of the drawing.
+
+          \return False if the rule can not be drawn from the cache (e.g. it has texts or the cache is not ready).
+
+          \sa GeometryLODCache
+        */
+        virtual bool drawLayerGeometriesFromCache(AbstractLayer* layer,
+                                                  te::se::Rule* rule,
+                                                  Canvas* canvas,
+                                                  const te::gm::Envelope& bbox,
+                                                  int srid,
+                                                  bool* cancel);
+
         /*!
           \brief It draws the abstract layer in the given canvas using the SRS informed.
 
@@ -186,6 +208,8 @@ namespace te
         std::size_t m_index;                               // Unsigned int used as r-Tree index.
         std::vector<te::color::RGBAColor**> m_chartImages; // The generated chart images.
         std::vector<te::gm::Coord2D> m_chartCoordinates;   // The generated chart coordinates.
+        double m_lodTolerance;                             // The size of a pixel in the map SRS, if the layer is drawn with LOD. Otherwise 0.
+        double m_lodCacheTolerance;                        // The size of a pixel in the layer SRS, if the layer is drawn from the LOD cache. Otherwise 0.
     };
 
   } // end namespace map
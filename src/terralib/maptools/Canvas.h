@@ -58,6 +58,7 @@ namespace te
     class PointZM;
     class Polygon;
     class MultiSurface;
+    class WKBView;
   }
 
   namespace rst
@@ -266,6 +267,16 @@ namespace te
         \param g The MultiSurface.
         */
         virtual void draw(const te::gm::MultiSurface* g) = 0;
+
+        /*!
+          \brief It draws the geometry decoded in the given view.
+
+          This is a faster path for drivers that expose their geometries as WKB:
+          no te::gm::Geometry needs to be built for each feature.
+
+          \param view A view of a geometry already in the canvas SRS.
+        */
+        virtual void draw(const te::gm::WKBView& view) = 0;
         //@}
 
         /** @name Image Handling
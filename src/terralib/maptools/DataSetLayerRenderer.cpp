@@ -105,6 +105,9 @@ void te::map::DataSetLayerRenderer::draw(AbstractLayer* layer,
 
   te::gm::Envelope ibbox = reprojectedBBOX.intersection(dlayer->getExtent());
 
+// the size of a pixel in the map SRS, used to generalize the geometries
+  const double lodTolerance = dlayer->isLODEnabled() ? bbox.getWidth() / canvas->getWidth() : 0.0;
+
 // retrieve the associated data source
   te::da::DataSourcePtr ds = te::da::GetDataSource(dlayer->getDataSourceId(), true);
 
@@ -122,7 +125,7 @@ void te::map::DataSetLayerRenderer::draw(AbstractLayer* layer,
     Grouping* grouping = dlayer->getGrouping();
     if(grouping && grouping->isVisible())
     {
-      drawGrouping(dlayer, ds, canvas, ibbox, srid);
+      drawGrouping(dlayer, ds, canvas, ibbox, srid, lodTolerance);
       return;
     }
 
@@ -147,7 +150,7 @@ void te::map::DataSetLayerRenderer::draw(AbstractLayer* layer,
     if(fts == 0)
       throw Exception(TE_TR("The layer style is not a Feature Type Style!"));
 
-    DrawGeometries(dstype.get(), ds, canvas, ibbox, dlayer->getSRID(), srid, fts);
+    DrawGeometries(dstype.get(), ds, canvas, ibbox, dlayer->getSRID(), srid, fts, lodTolerance);
   }
   else if(dstype->hasRaster())
   {
@@ -180,7 +183,7 @@ void te::map::DataSetLayerRenderer::draw(AbstractLayer* layer,
   }
 }
 
-void te::map::DataSetLayerRenderer::drawGrouping(DataSetLayer* layer, te::da::DataSourcePtr ds, Canvas* canvas, const te::gm::Envelope& bbox, int srid)
+void te::map::DataSetLayerRenderer::drawGrouping(DataSetLayer* layer, te::da::DataSourcePtr ds, Canvas* canvas, const te::gm::Envelope& bbox, int srid, double lodTolerance)
 {
   std::string dsname = layer->getDataSetName();
 
@@ -342,6 +345,10 @@ void te::map::DataSetLayerRenderer::drawGrouping(DataSetLayer* layer, te::da::Da
           geom->transform(srid);
         }
 
+// skip the geometries smaller than a pixel
+        if(lodTolerance > 0.0 && !Generalize(geom.get(), lodTolerance))
+          continue;
+
         canvas->draw(geom.get());
 
       }while(dataset->moveNext()); // next geometry!
@@ -65,7 +65,7 @@ namespace te
 
       private:
 
-        void drawGrouping(DataSetLayer* layer, te::da::DataSourcePtr ds, Canvas* canvas, const te::gm::Envelope& bbox, int srid);
+        void drawGrouping(DataSetLayer* layer, te::da::DataSourcePtr ds, Canvas* canvas, const te::gm::Envelope& bbox, int srid, double lodTolerance);
     };
 
   } // end namespace map
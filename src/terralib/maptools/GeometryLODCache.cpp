@@ -0,0 +1,280 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+  \file terralib/maptools/GeometryLODCache.cpp
+
+  \brief A multi-resolution cache of the geometries of a layer.
+*/
+
+// TerraLib
+#include "../common/Globals.h"
+#include "../common/STLUtils.h"
+#include "../dataaccess/dataset/DataSet.h"
+#include "../dataaccess/utils/Utils.h"
+#include "../geometry/Geometry.h"
+#include "../geometry/GeometryProperty.h"
+#include "../geometry/Utils.h"
+#include "../geometry/WKBView.h"
+#include "../srs/Config.h"
+#include "../srs/Converter.h"
+#include "Canvas.h"
+#include "GeometryLODCache.h"
+
+// STL
+#include <algorithm>
+#include <cassert>
+#include <memory>
+
+namespace te
+{
+  namespace map
+  {
+    /*! \brief The number of levels of detail. */
+    static const std::size_t sg_numLevels = 5;
+
+    /*! \brief The tolerance of the finest level, as a fraction of the largest dimension of the layer extent. */
+    static const double sg_finestTolerance = 1.0 / 16384.0;
+
+    /*! \brief The ratio between the tolerances of two consecutive levels. */
+    static const double sg_levelRatio = 4.0;
+
+  } // end namespace map
+}   // end namespace te
+
+te::map::GeometryLODCache::GeometryLODCache(const AbstractLayerPtr& layer)
+  : m_layer(layer),
+    m_srid(layer->getSRID()),
+    m_ready(false),
+    m_cancel(false)
+{
+  m_thread = boost::thread(&GeometryLODCache::build, this);
+}
+
+te::map::GeometryLODCache::~GeometryLODCache()
+{
+  {
+    boost::lock_guard<boost::mutex> lock(m_mtx);
+
+    m_cancel = true;
+  }
+
+  m_thread.join();
+
+  te::common::FreeContents(m_levels);
+}
+
+bool te::map::GeometryLODCache::isReady() const
+{
+  boost::lock_guard<boost::mutex> lock(m_mtx);
+
+  return m_ready;
+}
+
+bool te::map::GeometryLODCache::draw(Canvas* canvas, const te::gm::Envelope& bbox, int srid, double tolerance, bool* cancel) const
+{
+  assert(canvas);
+
+  if(!isReady())
+    return false;
+
+  const int l = getLevel(tolerance);
+
+  if(l < 0)
+    return false;
+
+  const Level& level = *m_levels[l];
+
+  std::vector<std::size_t> report;
+
+  level.m_rtree.search(bbox, report);
+
+// keep the drawing order of the data source
+  std::sort(report.begin(), report.end());
+
+  std::auto_ptr<te::srs::Converter> converter;
+
+  if((m_srid != TE_UNKNOWN_SRS) && (srid != TE_UNKNOWN_SRS) && (m_srid != srid))
+    converter.reset(new te::srs::Converter(m_srid, srid));
+
+  te::gm::WKBView view;
+
+  for(std::size_t i = 0; i < report.size(); ++i)
+  {
+    if(cancel != 0 && (*cancel))
+      return true;
+
+    view.read(&level.m_wkbs[level.m_offsets[report[i]]]);
+
+// the geometries between the level tolerance and the given one are also smaller than a pixel
+    const te::gm::Envelope& mbr = view.getMBR();
+
+    if(mbr.getWidth() < tolerance && mbr.getHeight() < tolerance && view.getPartType(0) != te::gm::PointType)
+      continue;
+
+    if(converter.get())
+    {
+      te::gm::Coord2D* coords = view.getCoords();
+
+      if(!converter->convert(&(coords[0].x), &(coords[0].y), static_cast<long>(view.getNumCoords()), 2))
+        continue;
+
+      view.computeMBR();
+    }
+
+    canvas->draw(view);
+  }
+
+  return true;
+}
+
+void te::map::GeometryLODCache::build()
+{
+  try
+  {
+    std::string geomPropertyName = m_layer->getGeomPropertyName();
+
+    std::auto_ptr<LayerSchema> schema(m_layer->getSchema());
+
+    te::gm::GeometryProperty* geomProperty = 0;
+
+    if(geomPropertyName.empty())
+      geomProperty = te::da::GetFirstGeomProperty(schema.get());
+    else
+      geomProperty = dynamic_cast<te::gm::GeometryProperty*>(schema->getProperty(geomPropertyName));
+
+    const te::gm::Envelope& extent = m_layer->getExtent();
+
+    const double maxDim = std::max(extent.getWidth(), extent.getHeight());
+
+// points can not be generalized: there is nothing to cache
+    if(geomProperty == 0 || !extent.isValid() || maxDim <= 0.0 ||
+       geomProperty->getGeometryType() == te::gm::PointType || geomProperty->getGeometryType() == te::gm::MultiPointType)
+    {
+      boost::lock_guard<boost::mutex> lock(m_mtx);
+
+      m_ready = true;
+
+      return;
+    }
+
+    geomPropertyName = geomProperty->getName();
+
+    std::vector<Level*> levels;
+
+    std::vector<std::vector<te::sam::rtree::Index<std::size_t, 8>::ItemType> > items(sg_numLevels);
+
+    double tolerance = maxDim * sg_finestTolerance;
+
+    for(std::size_t l = 0; l < sg_numLevels; ++l)
+    {
+      Level* level = new Level;
+      level->m_tolerance = tolerance;
+
+      levels.push_back(level);
+
+      tolerance *= sg_levelRatio;
+    }
+
+    std::auto_ptr<te::da::DataSet> dataset = m_layer->getData(geomPropertyName, &extent);
+
+    const std::size_t gpos = te::da::GetPropertyPos(dataset.get(), geomPropertyName);
+
+    std::size_t nRows = 0;
+
+    while(dataset->moveNext())
+    {
+      if((++nRows % 1024) == 0)
+      {
+        boost::lock_guard<boost::mutex> lock(m_mtx);
+
+        if(m_cancel)
+        {
+          te::common::FreeContents(levels);
+          return;
+        }
+      }
+
+      std::auto_ptr<te::gm::Geometry> geom;
+
+      try
+      {
+        geom = dataset->getGeometry(gpos);
+      }
+      catch(std::exception& /*e*/)
+      {
+        continue;
+      }
+
+      if(geom.get() == 0)
+        continue;
+
+      const bool isPoint = (geom->getDimension() == te::gm::P);
+
+// each level decimates the geometry of the previous one
+      for(std::size_t l = 0; l < sg_numLevels; ++l)
+      {
+        Level* level = levels[l];
+
+        te::gm::Decimate(geom.get(), level->m_tolerance);
+
+        geom->computeMBR(true);
+
+        const te::gm::Envelope& mbr = *geom->getMBR();
+
+        if(!isPoint && mbr.getWidth() < level->m_tolerance && mbr.getHeight() < level->m_tolerance)
+          break;
+
+        const std::size_t offset = level->m_wkbs.size();
+
+        level->m_wkbs.resize(offset + geom->getWkbSize());
+
+        geom->getWkb(&level->m_wkbs[offset], te::common::Globals::sm_machineByteOrder);
+
+        items[l].push_back(std::make_pair(mbr, level->m_offsets.size()));
+
+        level->m_offsets.push_back(offset);
+      }
+    }
+
+    for(std::size_t l = 0; l < sg_numLevels; ++l)
+      levels[l]->m_rtree.bulkLoad(items[l]);
+
+    boost::lock_guard<boost::mutex> lock(m_mtx);
+
+    m_levels.swap(levels);
+
+    m_ready = true;
+  }
+  catch(...)
+  {
+// the layer will be drawn from its data source
+  }
+}
+
+int te::map::GeometryLODCache::getLevel(double tolerance) const
+{
+  for(int l = static_cast<int>(m_levels.size()) - 1; l >= 0; --l)
+  {
+    if(m_levels[l]->m_tolerance <= tolerance)
+      return l;
+  }
+
+  return -1;
+}
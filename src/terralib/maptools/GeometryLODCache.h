@@ -0,0 +1,132 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+  \file terralib/maptools/GeometryLODCache.h
+
+  \brief A multi-resolution cache of the geometries of a layer.
+*/
+
+#ifndef __TERRALIB_MAPTOOLS_INTERNAL_GEOMETRYLODCACHE_H
+#define __TERRALIB_MAPTOOLS_INTERNAL_GEOMETRYLODCACHE_H
+
+// TerraLib
+#include "../geometry/Envelope.h"
+#include "../sam/rtree/Index.h"
+#include "AbstractLayer.h"
+#include "Config.h"
+
+// STL
+#include <cstddef>
+#include <vector>
+
+// Boost
+#include <boost/noncopyable.hpp>
+#include <boost/thread.hpp>
+
+namespace te
+{
+  namespace map
+  {
+// Forward declaration
+    class Canvas;
+
+    /*!
+      \class GeometryLODCache
+
+      \brief A multi-resolution cache of the geometries of a layer.
+
+      The cache keeps some levels of detail of the layer geometries. Each level
+      is built by decimating the geometries of the previous one to a tolerance
+      four times larger, and the lines and polygons smaller than the tolerance
+      are left out. The geometries of a level are kept as WKB in a single
+      buffer, indexed by an R-tree.
+
+      The levels are built once, in background, by reading the whole layer data.
+      Meanwhile, and when the map is zoomed in beyond the finest level, the layer
+      must be drawn from its data source.
+
+      \sa GeometryLODCacheManager, AbstractLayer::setLODCacheEnabled
+    */
+    class TEMAPEXPORT GeometryLODCache : public boost::noncopyable
+    {
+      public:
+
+        /*!
+          \brief It starts building the cache of the given layer in background.
+
+          \param layer The layer whose geometries will be cached.
+        */
+        GeometryLODCache(const AbstractLayerPtr& layer);
+
+        /*! \brief Destructor. If the cache is still being built, the building is canceled. */
+        ~GeometryLODCache();
+
+        /*! \brief It returns true if the cache was built and can be used. */
+        bool isReady() const;
+
+        /*!
+          \brief It draws the cached geometries that intersect the given box.
+
+          \param canvas    The canvas were the geometries will be drawn.
+          \param bbox      The interest area, in the layer SRS.
+          \param srid      The SRS of the canvas.
+          \param tolerance The size of a pixel in the layer SRS.
+          \param cancel    A flag that can be used to cancel the drawing.
+
+          \return False if the cache is not ready or has no level coarse enough for the tolerance. In this case nothing is drawn.
+        */
+        bool draw(Canvas* canvas, const te::gm::Envelope& bbox, int srid, double tolerance, bool* cancel) const;
+
+      private:
+
+        /*! \brief It reads the layer geometries and builds the levels. */
+        void build();
+
+        /*! \brief It returns the coarsest level whose tolerance is not greater than the given one, or -1 if there is none. */
+        int getLevel(double tolerance) const;
+
+      private:
+
+        /*!
+          \struct Level
+
+          \brief The geometries of a level of detail.
+        */
+        struct Level
+        {
+          double m_tolerance;                              //!< The decimation tolerance.
+          std::vector<char> m_wkbs;                        //!< The WKB of the geometries, one after another.
+          std::vector<std::size_t> m_offsets;              //!< The offset of each geometry in the WKB buffer.
+          te::sam::rtree::Index<std::size_t, 8> m_rtree;   //!< An index from the geometry boxes to their positions in m_offsets.
+        };
+
+        AbstractLayerPtr m_layer;           //!< The cached layer.
+        int m_srid;                         //!< The layer SRS.
+        std::vector<Level*> m_levels;       //!< The levels of detail, from the finest to the coarsest one.
+        bool m_ready;                       //!< It indicates that the levels were built.
+        bool m_cancel;                      //!< It asks the building thread to stop.
+        mutable boost::mutex m_mtx;         //!< It protects the flags shared with the building thread.
+        boost::thread m_thread;             //!< The building thread.
+    };
+
+  } // end namespace map
+}   // end namespace te
+
+#endif  // __TERRALIB_MAPTOOLS_INTERNAL_GEOMETRYLODCACHE_H
@@ -0,0 +1,68 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+  \file terralib/maptools/GeometryLODCacheManager.cpp
+
+  \brief This is a singleton for managing the geometry LOD caches of the layers.
+*/
+
+// TerraLib
+#include "AbstractLayer.h"
+#include "GeometryLODCache.h"
+#include "GeometryLODCacheManager.h"
+
+// STL
+#include <cassert>
+
+te::map::GeometryLODCacheManager::GeometryLODCacheManager()
+{
+}
+
+te::map::GeometryLODCacheManager::~GeometryLODCacheManager()
+{
+}
+
+boost::shared_ptr<te::map::GeometryLODCache> te::map::GeometryLODCacheManager::get(AbstractLayer* layer)
+{
+  assert(layer);
+
+  LockWrite l;
+
+  boost::shared_ptr<GeometryLODCache>& cache = m_caches[layer->getId()];
+
+  if(cache.get() == 0)
+    cache.reset(new GeometryLODCache(AbstractLayerPtr(layer)));
+
+  return cache;
+}
+
+void te::map::GeometryLODCacheManager::remove(const std::string& layerId)
+{
+  LockWrite l;
+
+  m_caches.erase(layerId);
+}
+
+void te::map::GeometryLODCacheManager::clear()
+{
+  LockWrite l;
+
+  m_caches.clear();
+}
@@ -0,0 +1,106 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+  \file terralib/maptools/GeometryLODCacheManager.h
+
+  \brief This is a singleton for managing the geometry LOD caches of the layers.
+*/
+
+#ifndef __TERRALIB_MAPTOOLS_INTERNAL_GEOMETRYLODCACHEMANAGER_H
+#define __TERRALIB_MAPTOOLS_INTERNAL_GEOMETRYLODCACHEMANAGER_H
+
+// TerraLib
+#include "../common/Singleton.h"
+#include "../common/ThreadingPolicies.h"
+#include "Config.h"
+
+// STL
+#include <map>
+#include <string>
+
+// Boost
+#include <boost/shared_ptr.hpp>
+
+namespace te
+{
+  namespace map
+  {
+// Forward declarations
+    class AbstractLayer;
+    class GeometryLODCache;
+
+    /*!
+      \class GeometryLODCacheManager
+
+      \brief This is a singleton for managing the geometry LOD caches of the layers.
+
+      A cache is created, and starts to be built in background, the first time it is requested for a layer.
+      Remove the cache of a layer when its data changes.
+
+      \sa GeometryLODCache, AbstractLayer::isLODCacheEnabled
+    */
+    class TEMAPEXPORT GeometryLODCacheManager : public te::common::ClassLevelLockable<GeometryLODCacheManager,
+                                                                                     ::boost::recursive_mutex,
+                                                                                     ::boost::lock_guard< ::boost::recursive_mutex>,
+                                                                                     ::boost::lock_guard< ::boost::recursive_mutex> >,
+                                               public te::common::Singleton<GeometryLODCacheManager>
+    {
+      friend class te::common::Singleton<GeometryLODCacheManager>;
+
+      public:
+
+        /*!
+          \brief It returns the cache of the given layer, creating it if needed.
+
+          \param layer The layer.
+
+          \return The cache of the layer. It may not be ready yet.
+        */
+        boost::shared_ptr<GeometryLODCache> get(AbstractLayer* layer);
+
+        /*!
+          \brief It removes the cache of a layer.
+
+          \param layerId The layer id.
+
+          \note A cache in use by a renderer is only released when the drawing is finished.
+        */
+        void remove(const std::string& layerId);
+
+        /*! \brief It removes all the caches. */
+        void clear();
+
+     protected:
+
+        /*! \brief It initializes the singleton instance of the geometry LOD cache manager. */
+        GeometryLODCacheManager();
+
+        /*! \brief Singleton destructor. */
+        ~GeometryLODCacheManager();
+
+      private:
+
+        std::map<std::string, boost::shared_ptr<GeometryLODCache> > m_caches; //!< The caches indexed by layer id.
+    };
+
+  } // end namespace map
+}   // end namespace te
+
+#endif  // __TERRALIB_MAPTOOLS_INTERNAL_GEOMETRYLODCACHEMANAGER_H
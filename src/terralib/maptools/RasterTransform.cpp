@@ -34,6 +34,8 @@
 #include <boost/math/special_functions/fpclassify.hpp>
 
 // STL
+#include <algorithm>
+#include <cassert>
 #include <limits>
 
 te::map::RasterTransform::RasterTransform(te::rst::Raster* input, te::rst::Raster* output) :
@@ -49,7 +51,8 @@ te::map::RasterTransform::RasterTransform(te::rst::Raster* input, te::rst::Raste
   m_monoBand(0),
   m_monoBandOut(0),
   m_transfFuncPtr(&RasterTransform::setExtractRGB),
-  m_RGBAFuncPtr(&RasterTransform::getExtractRGB)
+  m_RGBAFuncPtr(&RasterTransform::getExtractRGB),
+  m_lutsUpdated(false)
 {
   m_rstMinValue = -std::numeric_limits<double>::max();
   m_rstMaxValue = std::numeric_limits<double>::max();
@@ -65,6 +68,8 @@ te::map::RasterTransform::~RasterTransform()
 
 void te::map::RasterTransform::setRGBMap(std::map<RGBChannels, short>& rgbMap)
 {
+  m_lutsUpdated = false;
+
   m_rgbMap.clear();
   m_rgbMap[RED_CHANNEL] = -1;
   m_rgbMap[GREEN_CHANNEL] = -1;
@@ -88,6 +93,8 @@ void te::map::RasterTransform::setRGBMap(std::map<RGBChannels, short>& rgbMap)
 
 void te::map::RasterTransform::setLinearTransfParameters(double vmin, double vmax, double rmin, double rmax)
 {
+  m_lutsUpdated = false;
+
   m_rstMinValue = rmin;
   m_rstMaxValue = rmax;
 
@@ -168,6 +175,8 @@ te::map::RasterTransform::RasterTransfFunctions te::map::RasterTransform::getTra
 
 void te::map::RasterTransform::setTransfFunction(RasterTransfFunctions func)
 {
+  m_lutsUpdated = false;
+
   if (func == MONO2THREE_TRANSF)
   {
     m_transfFuncPtr = &RasterTransform::setMono2ThreeBand;
@@ -700,4 +709,313 @@ te::color::RGBAColor te::map::RasterTransform::getCategorizedColor(double value)
 te::color::RGBAColor te::map::RasterTransform::getRecodedColor(double value)
 {
   return m_recodeMap[(int)value];
-}
\ No newline at end of file
+}
+void te::map::RasterTransform::apply(const int* icols, const int* ilins, std::size_t n, te::color::RGBAColor* colors)
+{
+  assert(m_rasterIn);
+
+  const bool rgb = (m_RGBAFuncPtr == &RasterTransform::getExtractRGB);
+  const bool rgba = (m_RGBAFuncPtr == &RasterTransform::getExtractRGBA);
+  const int valueBand = getValueBand();
+
+// unknown transformation: pixel by pixel
+  if(!rgb && !rgba && valueBand < 0)
+  {
+    for(std::size_t i = 0; i < n; ++i)
+      colors[i] = (icols[i] < 0) ? te::color::RGBAColor() : apply(icols[i], ilins[i]);
+
+    return;
+  }
+
+  if(!m_lutsUpdated)
+    updateLUTs();
+
+  if(valueBand >= 0)
+  {
+    std::vector<double> values(n);
+
+    getValues(valueBand, icols, ilins, n, &values[0]);
+
+    const bool useLUT = !m_colorLUT.empty();
+
+    for(std::size_t i = 0; i < n; ++i)
+    {
+      if(icols[i] < 0)
+        colors[i] = te::color::RGBAColor();
+      else if(useLUT)
+        colors[i] = m_colorLUT[static_cast<int>(values[i]) - m_lutMinValues[0]];
+      else
+        colors[i] = getValueColor(values[i]);
+    }
+
+    return;
+  }
+
+// RGB(A): the pixel is transparent only if all bands have no data
+  const int nChannels = rgba ? 4 : 3;
+
+  std::vector<double> values[4];
+  double noDataValues[4];
+
+  for(int ch = 0; ch < nChannels; ++ch)
+  {
+    const short band = m_rgbMap[static_cast<RGBChannels>(ch)];
+
+    values[ch].resize(n);
+
+    getValues(band, icols, ilins, n, &values[ch][0]);
+
+    noDataValues[ch] = m_rasterIn->getBand(band)->getProperty()->m_noDataValue;
+  }
+
+  int channels[4];
+
+  for(std::size_t i = 0; i < n; ++i)
+  {
+    if(icols[i] < 0)
+    {
+      colors[i] = te::color::RGBAColor();
+      continue;
+    }
+
+    bool hasData = false;
+
+    for(int ch = 0; ch < nChannels; ++ch)
+    {
+      const double value = values[ch][i];
+
+      hasData = hasData || (value != noDataValues[ch]);
+
+      channels[ch] = m_channelLUTs[ch].empty() ? getChannelValue(value, static_cast<RGBChannels>(ch)) :
+                     m_channelLUTs[ch][static_cast<int>(value) - m_lutMinValues[ch]];
+    }
+
+    if(!hasData)
+      colors[i] = te::color::RGBAColor();
+    else
+      colors[i] = te::color::RGBAColor(channels[RED_CHANNEL], channels[GREEN_CHANNEL], channels[BLUE_CHANNEL], rgba ? channels[ALPHA_CHANNEL] : static_cast<int>(m_transp));
+  }
+}
+
+int te::map::RasterTransform::getValueBand()
+{
+  if(m_RGBAFuncPtr == &RasterTransform::getMono2ThreeBand ||
+     m_RGBAFuncPtr == &RasterTransform::getCategorize ||
+     m_RGBAFuncPtr == &RasterTransform::getInterpolate ||
+     m_RGBAFuncPtr == &RasterTransform::getRecode)
+    return m_monoBand;
+
+  if(m_RGBAFuncPtr == &RasterTransform::getRed2ThreeBand)
+    return m_rgbMap[RED_CHANNEL];
+
+  if(m_RGBAFuncPtr == &RasterTransform::getGreen2ThreeBand)
+    return m_rgbMap[GREEN_CHANNEL];
+
+  if(m_RGBAFuncPtr == &RasterTransform::getBlue2ThreeBand)
+    return m_rgbMap[BLUE_CHANNEL];
+
+  return -1;
+}
+
+te::color::RGBAColor te::map::RasterTransform::getValueColor(double value)
+{
+  const int band = getValueBand();
+
+  if(checkNoValue(value, band))
+    return te::color::RGBAColor();
+
+  if(m_RGBAFuncPtr == &RasterTransform::getCategorize)
+    return getCategorizedColor(value);
+
+  if(m_RGBAFuncPtr == &RasterTransform::getInterpolate)
+    return getInterpolatedColor(value);
+
+  if(m_RGBAFuncPtr == &RasterTransform::getRecode)
+  {
+    RecodedMap::const_iterator it = m_recodeMap.find(static_cast<int>(value));
+
+    return (it != m_recodeMap.end()) ? it->second : te::color::RGBAColor();
+  }
+
+  if(m_RGBAFuncPtr == &RasterTransform::getMono2ThreeBand)
+  {
+    value = (value * m_gain + m_offset) * m_mContrast;
+
+    fixValue(value);
+
+    if(boost::math::isnan(value))
+      return te::color::RGBAColor();
+
+    return te::color::RGBAColor(static_cast<int>(value), static_cast<int>(value), static_cast<int>(value), static_cast<int>(m_transp));
+  }
+
+  if(m_RGBAFuncPtr == &RasterTransform::getRed2ThreeBand)
+    return te::color::RGBAColor(getChannelValue(value, RED_CHANNEL), 0, 0, static_cast<int>(m_transp));
+
+  if(m_RGBAFuncPtr == &RasterTransform::getGreen2ThreeBand)
+    return te::color::RGBAColor(0, getChannelValue(value, GREEN_CHANNEL), 0, static_cast<int>(m_transp));
+
+  return te::color::RGBAColor(0, 0, getChannelValue(value, BLUE_CHANNEL), static_cast<int>(m_transp));
+}
+
+int te::map::RasterTransform::getChannelValue(double value, RGBChannels channel)
+{
+  switch(channel)
+  {
+    case RED_CHANNEL:
+      value = (value * m_gain + m_offset) * m_rContrast;
+    break;
+
+    case GREEN_CHANNEL:
+      value = (value * m_gain + m_offset) * m_gContrast;
+    break;
+
+    case BLUE_CHANNEL:
+      value = (value * m_gain + m_offset) * m_bContrast;
+    break;
+
+    default:
+    {
+// the alpha channel is not stretched, but limited by the transparency
+      fixValue(value);
+
+      return (value < m_transp) ? static_cast<int>(value) : static_cast<int>(m_transp);
+    }
+  }
+
+  fixValue(value);
+
+  return static_cast<int>(value);
+}
+
+void te::map::RasterTransform::getValues(int band, const int* icols, const int* ilins, std::size_t n, double* values)
+{
+  const te::rst::Band* b = m_rasterIn->getBand(band);
+
+  std::vector<double> buffer;
+
+  std::size_t i = 0;
+
+  while(i < n)
+  {
+    if(icols[i] < 0)
+    {
+      ++i;
+      continue;
+    }
+
+// the run of pixels over the same line
+    const int lin = ilins[i];
+
+    int minCol = icols[i];
+    int maxCol = icols[i];
+
+    std::size_t end = i + 1;
+
+    for(; end < n; ++end)
+    {
+      if(icols[end] < 0)
+        continue;
+
+      if(ilins[end] != lin)
+        break;
+
+      minCol = std::min(minCol, icols[end]);
+      maxCol = std::max(maxCol, icols[end]);
+    }
+
+    buffer.resize(maxCol - minCol + 1);
+
+    b->getValues(minCol, lin, maxCol - minCol + 1, 1, &buffer[0]);
+
+    for(; i < end; ++i)
+    {
+      if(icols[i] >= 0)
+        values[i] = buffer[icols[i] - minCol];
+    }
+  }
+}
+
+void te::map::RasterTransform::updateLUTs()
+{
+  m_colorLUT.clear();
+
+  for(int ch = 0; ch < 4; ++ch)
+  {
+    m_channelLUTs[ch].clear();
+    m_lutMinValues[ch] = 0;
+  }
+
+  m_lutsUpdated = true;
+
+  const bool rgb = (m_RGBAFuncPtr == &RasterTransform::getExtractRGB);
+  const bool rgba = (m_RGBAFuncPtr == &RasterTransform::getExtractRGBA);
+  const int valueBand = getValueBand();
+
+  const int nLUTs = (valueBand >= 0) ? 1 : (rgba ? 4 : (rgb ? 3 : 0));
+
+  for(int l = 0; l < nLUTs; ++l)
+  {
+    const int band = (valueBand >= 0) ? valueBand : m_rgbMap[static_cast<RGBChannels>(l)];
+
+    if(band < 0 || band >= static_cast<int>(m_rasterIn->getNumberOfBands()))
+      continue;
+
+// only bands with integer values of up to 16 bits have a lookup table
+    int minValue = 0;
+    int maxValue = 0;
+
+    switch(m_rasterIn->getBand(band)->getProperty()->getType())
+    {
+      case te::dt::R1BIT_TYPE:
+        maxValue = 1;
+      break;
+
+      case te::dt::R2BITS_TYPE:
+        maxValue = 3;
+      break;
+
+      case te::dt::R4BITS_TYPE:
+        maxValue = 15;
+      break;
+
+      case te::dt::UCHAR_TYPE:
+        maxValue = 255;
+      break;
+
+      case te::dt::CHAR_TYPE:
+        minValue = -128;
+        maxValue = 127;
+      break;
+
+      case te::dt::UINT16_TYPE:
+        maxValue = 65535;
+      break;
+
+      case te::dt::INT16_TYPE:
+        minValue = -32768;
+        maxValue = 32767;
+      break;
+
+      default:
+        continue;
+    }
+
+    m_lutMinValues[l] = minValue;
+
+    if(valueBand >= 0)
+    {
+      m_colorLUT.resize(maxValue - minValue + 1);
+
+      for(int v = minValue; v <= maxValue; ++v)
+        m_colorLUT[v - minValue] = getValueColor(v);
+    }
+    else
+    {
+      m_channelLUTs[l].resize(maxValue - minValue + 1);
+
+      for(int v = minValue; v <= maxValue; ++v)
+        m_channelLUTs[l][v - minValue] = getChannelValue(v, static_cast<RGBChannels>(l));
+    }
+  }
+}
@@ -32,7 +32,9 @@
 #include "../color/ColorBar.h"
 
 // STL
+#include <cstddef>
 #include <map>
+#include <vector>
 
 namespace te
 {
@@ -119,43 +121,43 @@ namespace te
         te::rst::Raster* getOutputRaster() { return m_rasterOut; }
 
         /*! \brief Sets the transparency. */
-        void setTransparency(double value) { m_transp = value; }
+        void setTransparency(double value) { m_transp = value; m_lutsUpdated = false; }
 
         /*! \brief Gets the transparency. */
         double getTransparency() { return m_transp; }
 
         /*! \brief Sets the gain. */
-        void setGain(double value) { m_gain = value; }
+        void setGain(double value) { m_gain = value; m_lutsUpdated = false; }
 
         /*! \brief Gets the gain. */
         double getGain() { return m_gain; }
 
         /*! \brief Sets the offset. */
-        void setOffset(double value) { m_offset = value; }
+        void setOffset(double value) { m_offset = value; m_lutsUpdated = false; }
 
         /*! \brief Gets the offset. */
         double getOffset() { return m_offset; }
 
         /*! \brief Sets the constrast value for red band. */
-        void setContrastR(double value) { m_rContrast = value; }
+        void setContrastR(double value) { m_rContrast = value; m_lutsUpdated = false; }
 
         /*! \brief Gets the constrast value for red band. */
         double getContrastR() { return m_rContrast; }
 
         /*! \brief Sets the constrast value for green band. */
-        void setContrastG(double value) { m_gContrast = value; }
+        void setContrastG(double value) { m_gContrast = value; m_lutsUpdated = false; }
 
         /*! \brief Gets the constrast value for green band. */
         double getContrastG() { return m_gContrast; }
 
         /*! \brief Sets the constrast value for blue band. */
-        void setContrastB(double value) { m_bContrast = value; }
+        void setContrastB(double value) { m_bContrast = value; m_lutsUpdated = false; }
 
         /*! \brief Gets the constrast value for blue band. */
         double getContrastB() { return m_bContrast; }
 
         /*! \brief Sets the constrast value for gray band. */
-        void setContrastM(double value) { m_mContrast = value; }
+        void setContrastM(double value) { m_mContrast = value; m_lutsUpdated = false; }
 
         /*! \brief Gets the constrast value for gray band. */
         double getContrastM() { return m_mContrast; }
@@ -164,16 +166,16 @@ namespace te
         void setRGBMap(std::map<RGBChannels, short>& rgbMap);
 
         /*! Sets the mapping from a particular input band to a particular output channel */
-        void setBChannelMapping(short bIn, RGBChannels bOut) { m_rgbMap[bOut] = bIn; }
+        void setBChannelMapping(short bIn, RGBChannels bOut) { m_rgbMap[bOut] = bIn; m_lutsUpdated = false; }
 
         /*! Clears current mapping from bands to channel */
-        void clearRGBMap() { m_rgbMap.clear(); }
+        void clearRGBMap() { m_rgbMap.clear(); m_lutsUpdated = false; }
 
         /*! Returns the mapping from a particular input band to a particular output channel */
-        std::map<RGBChannels, short>& getRGBMap() { return m_rgbMap; }
+        std::map<RGBChannels, short>& getRGBMap() { m_lutsUpdated = false; return m_rgbMap; }
 
         /*! Sets the mono band to be transformed */
-        void setSrcBand(short n) { m_monoBand = n; }
+        void setSrcBand(short n) { m_monoBand = n; m_lutsUpdated = false; }
 
         /*! Gets the mono band to be transformed */
         short getSrcBand() { return m_monoBand; }
@@ -185,22 +187,22 @@ namespace te
         short getDestBand() { return m_monoBandOut; }
 
         /*! Sets the categorize map information */
-        void setCategorizedMap(CategorizedMap map) { m_categorizeMap = map; }
+        void setCategorizedMap(CategorizedMap map) { m_categorizeMap = map; m_lutsUpdated = false; }
 
         /*! Gets the categorize map information */
-        CategorizedMap& getCategorizedMap() { return m_categorizeMap; }
+        CategorizedMap& getCategorizedMap() { m_lutsUpdated = false; return m_categorizeMap; }
 
         /*! Sets the interpolate map information */
-        void setInterpolatedMap(InterpolatedMap map) { m_interpolateMap = map; }
+        void setInterpolatedMap(InterpolatedMap map) { m_interpolateMap = map; m_lutsUpdated = false; }
 
         /*! Gets the categorize map information */
-        InterpolatedMap& getInterpolatedMap() { return m_interpolateMap; }
+        InterpolatedMap& getInterpolatedMap() { m_lutsUpdated = false; return m_interpolateMap; }
 
         /*! Sets the recode map information */
-        void setRecodedMap(RecodedMap map) { m_recodeMap = map; }
+        void setRecodedMap(RecodedMap map) { m_recodeMap = map; m_lutsUpdated = false; }
 
         /*! Gets the recode map information */
-        RecodedMap& getRecodedMap() { return m_recodeMap; }
+        RecodedMap& getRecodedMap() { m_lutsUpdated = false; return m_recodeMap; }
 
         /*! 
           \brief Set parameters of linear transformation
@@ -220,16 +222,32 @@ namespace te
         void setTransfFunction(RasterTransfFunctions func);
 
         /*! Sets the transformation method to be used */
-        void setTransfFunction(RasterTransform::TransformFunction transfFuncPtr) { m_transfFuncPtr = transfFuncPtr; }
+        void setTransfFunction(RasterTransform::TransformFunction transfFuncPtr) { m_transfFuncPtr = transfFuncPtr; m_lutsUpdated = false; }
 
         /*! Sets the transformation method to be used */
-        void setRGBAFunction(RasterTransform::RGBAFunction transfFuncPtr) { m_RGBAFuncPtr = transfFuncPtr; }
+        void setRGBAFunction(RasterTransform::RGBAFunction transfFuncPtr) { m_RGBAFuncPtr = transfFuncPtr; m_lutsUpdated = false; }
 
         /*! Applies the selected transformation method */
         void apply(double icol, double ilin, double ocol, double olin) {(this->*m_transfFuncPtr)(icol,ilin,ocol,olin); }
 
         te::color::RGBAColor apply(double icol, double ilin){return (this->*m_RGBAFuncPtr)(icol,ilin); }
 
+        /*!
+          \brief Applies the selected transformation method over a sequence of pixels (e.g. a canvas row).
+
+          The values of consecutive pixels in the same input line are read with a single band access.
+          For bands with integer values of up to 16 bits the colors are taken from lookup tables,
+          built on the first call and rebuilt after a change of the transformation parameters.
+
+          \param icols  The input column of each pixel. A negative column means the pixel is outside the input raster.
+          \param ilins  The input line of each pixel.
+          \param n      The number of pixels.
+          \param colors The resulting colors; pixels outside the input raster are transparent.
+
+          \note The result is the same of calling apply(icol, ilin) for each pixel.
+        */
+        void apply(const int* icols, const int* ilins, std::size_t n, te::color::RGBAColor* colors);
+
       protected:
 
         /*! This transformation repeats the value of the first band in input three bands of the output */
@@ -309,6 +327,25 @@ namespace te
         /*! Function used to get the recoded color given a pixel value */
         te::color::RGBAColor getRecodedColor(double value);
 
+        /*! Returns the input band used by the current single band transformation or -1 for multiple bands transformations. */
+        int getValueBand();
+
+        /*! Returns the color of a value of the band used by the current single band transformation. */
+        te::color::RGBAColor getValueColor(double value);
+
+        /*! Returns the value of a channel of a RGB(A) transformation given a band value */
+        int getChannelValue(double value, RGBChannels channel);
+
+        /*!
+          \brief Reads the values of a band for a sequence of pixels.
+
+          Consecutive pixels over the same input line are read by a single band access.
+        */
+        void getValues(int band, const int* icols, const int* ilins, std::size_t n, double* values);
+
+        /*! Rebuilds the lookup tables used by the pixel sequence transformation. */
+        void updateLUTs();
+
       private:
 
         te::rst::Raster* m_rasterIn;              //!< Pointer to a input raster.
@@ -334,6 +371,11 @@ namespace te
         CategorizedMap m_categorizeMap;           //!< Attribute to define the categorized transformation.
         InterpolatedMap m_interpolateMap;         //!< Attribute to define the interpolated transformation.
         RecodedMap m_recodeMap;                  //!< Attribute to define the recoded transformation.
+
+        bool m_lutsUpdated;                       //!< It indicates if the lookup tables reflect the current parameters.
+        std::vector<te::color::RGBAColor> m_colorLUT;   //!< Colors of the single band transformations, indexed by the band value minus m_lutMinValues[0].
+        std::vector<int> m_channelLUTs[4];        //!< Values of each RGB(A) channel, indexed by the band value minus m_lutMinValues[channel].
+        int m_lutMinValues[4];                    //!< The band value of the first entry of each lookup table.
     };
 
   } // end namespace map
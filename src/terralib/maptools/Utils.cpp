@@ -41,6 +41,7 @@
 #include "../fe/Literal.h"
 #include "../geometry/GeometryProperty.h"
 #include "../geometry/Utils.h"
+#include "../geometry/WKBView.h"
 #include "../memory/DataSet.h"
 #include "../raster/Grid.h"
 #include "../raster/Raster.h"
@@ -74,9 +75,12 @@
 #include <boost/lexical_cast.hpp>
 
 // STL
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <cstdlib>
 #include <memory>
+#include <vector>
 
 #ifndef TeCDR
 #define TeCDR 0.01745329251994329576    //!< Conversion factor: degrees to radians
@@ -302,7 +306,7 @@ te::da::DataSet* te::map::DataSet2Memory(te::da::DataSet* dataset)
 
 void te::map::DrawGeometries(te::da::DataSetType* type, te::da::DataSourcePtr ds,
                              Canvas* canvas, const te::gm::Envelope& bbox, int bboxSRID,
-                             int srid, te::se::FeatureTypeStyle* style)
+                             int srid, te::se::FeatureTypeStyle* style, double lodTolerance)
 {
   assert(type);
   assert(type->hasGeom());
@@ -412,7 +416,7 @@ void te::map::DrawGeometries(te::da::DataSetType* type, te::da::DataSourcePtr ds
       std::size_t gpos = te::da::GetFirstPropertyPos(dataset.get(), te::dt::GEOMETRY_TYPE);
 
 // let's draw! for each data set geometry...
-      DrawGeometries(dataset.get(), gpos, canvas, bboxSRID, srid, &task);
+      DrawGeometries(dataset.get(), gpos, canvas, bboxSRID, srid, &task, lodTolerance);
 
 // prepare to draw the other symbolizer
       dataset->moveFirst();
@@ -422,7 +426,8 @@ void te::map::DrawGeometries(te::da::DataSetType* type, te::da::DataSourcePtr ds
   }   // end for each <Rule>
 }
 
-void te::map::DrawGeometries(te::da::DataSet* dataset, const std::size_t& gpos, Canvas* canvas, int fromSRID, int toSRID, te::common::TaskProgress* task)
+void te::map::DrawGeometries(te::da::DataSet* dataset, const std::size_t& gpos, Canvas* canvas, int fromSRID, int toSRID, te::common::TaskProgress* task,
+                             double lodTolerance)
 {
   assert(dataset);
   assert(canvas);
@@ -432,6 +437,14 @@ void te::map::DrawGeometries(te::da::DataSet* dataset, const std::size_t& gpos,
   if((fromSRID != TE_UNKNOWN_SRS) && (toSRID != TE_UNKNOWN_SRS) && (fromSRID != toSRID))
     needRemap = true;
 
+// a single view and converter are reused for the whole traversal
+  te::gm::WKBView view;
+
+  std::auto_ptr<te::srs::Converter> converter;
+
+  if(needRemap)
+    converter.reset(new te::srs::Converter(fromSRID, toSRID));
+
   do
   {
     if(task)
@@ -443,6 +456,41 @@ void te::map::DrawGeometries(te::da::DataSet* dataset, const std::size_t& gpos,
       task->pulse();
     }
 
+// fast path: drivers that keep WKB decode only the coordinates
+    bool hasView = false;
+
+    try
+    {
+      hasView = dataset->getGeometryView(gpos, view);
+    }
+    catch(std::exception& /*e*/)
+    {
+      continue;
+    }
+
+    if(hasView)
+    {
+      if(view.isEmpty())
+        continue;
+
+      if(needRemap)
+      {
+        te::gm::Coord2D* coords = view.getCoords();
+
+        if(!converter->convert(&(coords[0].x), &(coords[0].y), static_cast<long>(view.getNumCoords()), 2))
+          continue;
+
+        view.computeMBR();
+      }
+
+      if(lodTolerance > 0.0 && !Generalize(view, lodTolerance))
+        continue;
+
+      canvas->draw(view);
+
+      continue;
+    }
+
     std::auto_ptr<te::gm::Geometry> geom(0);
     try
     {
@@ -462,11 +510,54 @@ void te::map::DrawGeometries(te::da::DataSet* dataset, const std::size_t& gpos,
       geom->transform(toSRID);
     }
 
+    if(lodTolerance > 0.0 && !Generalize(geom.get(), lodTolerance))
+      continue;
+
     canvas->draw(geom.get());
 
   }while(dataset->moveNext()); // next geometry!
 }
 
+bool te::map::Generalize(te::gm::Geometry* g, double tolerance)
+{
+  assert(g);
+
+  if(g->getDimension() == te::gm::P)
+    return true;
+
+  const te::gm::Envelope* mbr = g->getMBR();
+
+  if(mbr->getWidth() < tolerance && mbr->getHeight() < tolerance)
+    return false;
+
+  te::gm::Decimate(g, tolerance);
+
+  return true;
+}
+
+bool te::map::Generalize(te::gm::WKBView& view, double tolerance)
+{
+  const te::gm::Envelope& mbr = view.getMBR();
+
+  if(mbr.getWidth() < tolerance && mbr.getHeight() < tolerance)
+  {
+// points are never left out
+    const std::size_t nParts = view.getNumParts();
+
+    for(std::size_t p = 0; p < nParts; ++p)
+    {
+      if(view.getPartType(p) != te::gm::PointType)
+        return false;
+    }
+
+    return true;
+  }
+
+  view.decimate(tolerance);
+
+  return true;
+}
+
 void te::map::DrawRaster(te::da::DataSetType* type, te::da::DataSourcePtr ds, Canvas* canvas,
   const te::gm::Envelope& bbox, int bboxSRID, const te::gm::Envelope& visibleArea, int srid, te::se::CoverageStyle* style, const double& scale)
 {
@@ -610,13 +701,23 @@ void te::map::DrawRaster(te::rst::Raster* raster, Canvas* canvas, const te::gm::
 // create the draw task
   te::common::TaskProgress task(message, te::common::TaskProgress::DRAW, gridCanvas->getNumberOfRows());
 
-// create a RGBA array that will be drawn in the canvas. i.e. This array is the result of the render process.
-  //te::color::RGBAColor** rgba = new te::color::RGBAColor*[gridCanvas->getNumberOfRows()];
+// the canvas is rendered by blocks of rows
+  const int width = static_cast<int>(gridCanvas->getNumberOfColumns());
+  const int height = static_cast<int>(gridCanvas->getNumberOfRows());
+  const int blockHeight = std::min(height, 16);
+
+  te::color::RGBAColor** rows = new te::color::RGBAColor*[blockHeight];
+
+  for(int i = 0; i < blockHeight; ++i)
+    rows[i] = new te::color::RGBAColor[width];
+
+// the raster position of each pixel of a canvas row: negative columns are outside the raster
+  std::vector<int> icols(width);
+  std::vector<int> ilins(width);
 
-// create a RGBA array that will be drawn in the canvas. i.e. This array represents a row of the render process.
-  te::color::RGBAColor** row = new te::color::RGBAColor*[1];
-  te::color::RGBAColor* columns = new te::color::RGBAColor[gridCanvas->getNumberOfColumns()];
-  row[0] = columns;
+  const te::rst::Grid* overviewGrid = overview->getGrid();
+  const int overviewColumns = static_cast<int>(overview->getNumberOfColumns());
+  const int overviewRows = static_cast<int>(overview->getNumberOfRows());
 
 // create a SRS converter
   std::auto_ptr<te::srs::Converter> converter(new te::srs::Converter());
@@ -627,47 +728,166 @@ void te::map::DrawRaster(te::rst::Raster* raster, Canvas* canvas, const te::gm::
     converter->setTargetSRID(bboxSRID);
   }
 
+// when reprojecting, only the nodes of a sparse control grid are converted and
+// the raster positions of the other pixels are bilinearly interpolated between them.
+// Cells whose center is not well approximated are converted pixel by pixel.
+  const int step = 16;
+  const int nodeColumns = needRemap ? std::max((width + step - 2) / step + 1, 2) : 0;
+  const int nodeRows = needRemap ? std::max((height + step - 2) / step + 1, 2) : 0;
+
+  std::vector<te::gm::Coord2D> nodes(nodeColumns * nodeRows);
+  std::vector<bool> exactCells(std::max(nodeColumns - 1, 0) * std::max(nodeRows - 1, 0), false);
+  std::vector<te::gm::Coord2D> rowNodes(nodeColumns);
+
+  if(needRemap)
+  {
+    std::vector<double> xs(nodes.size());
+    std::vector<double> ys(nodes.size());
+
+    for(int j = 0; j < nodeRows; ++j)
+    {
+      for(int i = 0; i < nodeColumns; ++i)
+      {
+        te::gm::Coord2D geo = gridCanvas->gridToGeo(std::min(i * step, width - 1), std::min(j * step, height - 1));
+
+        xs[j * nodeColumns + i] = geo.x;
+        ys[j * nodeColumns + i] = geo.y;
+      }
+    }
+
+    const bool nodesConverted = converter->convert(&xs[0], &ys[0], static_cast<long>(nodes.size()));
+
+    for(std::size_t n = 0; n < nodes.size(); ++n)
+      nodes[n] = overviewGrid->geoToGrid(xs[n], ys[n]);
+
+    for(int j = 0; j < nodeRows - 1; ++j)
+    {
+      const int r0 = j * step;
+      const int r1 = std::min(r0 + step, height - 1);
+
+      for(int i = 0; i < nodeColumns - 1; ++i)
+      {
+        const int c0 = i * step;
+        const int c1 = std::min(c0 + step, width - 1);
+
+        const te::gm::Coord2D& n00 = nodes[j * nodeColumns + i];
+        const te::gm::Coord2D& n01 = nodes[j * nodeColumns + i + 1];
+        const te::gm::Coord2D& n10 = nodes[(j + 1) * nodeColumns + i];
+        const te::gm::Coord2D& n11 = nodes[(j + 1) * nodeColumns + i + 1];
+
+        const double cm = 0.5 * (c0 + c1);
+        const double rm = 0.5 * (r0 + r1);
+
+        double x = 0.0;
+        double y = 0.0;
+
+        te::gm::Coord2D geo = gridCanvas->gridToGeo(cm, rm);
+
+        bool exact = !nodesConverted || !converter->convert(geo.x, geo.y, x, y);
+
+        if(!exact)
+        {
+          te::gm::Coord2D center = overviewGrid->geoToGrid(x, y);
+
+          const double ix = 0.25 * (n00.x + n01.x + n10.x + n11.x);
+          const double iy = 0.25 * (n00.y + n01.y + n10.y + n11.y);
+
+// the comparisons are false for NaN values
+          exact = !(std::abs(ix - center.x) < 0.25 && std::abs(iy - center.y) < 0.25);
+        }
+
+        exactCells[j * (nodeColumns - 1) + i] = exact;
+      }
+    }
+  }
+
 // fill the result RGBA array
-  for(unsigned int r = 0; r < gridCanvas->getNumberOfRows(); ++r)
+  for(int r = 0; r < height; ++r)
   {
-    for(unsigned int c = 0; c < gridCanvas->getNumberOfColumns(); ++c)
+    if(needRemap)
     {
-      te::gm::Coord2D inputGeo = gridCanvas->gridToGeo(c, r);
+      const int j = std::min(r / step, nodeRows - 2);
+      const int r0 = j * step;
+      const int r1 = std::min(r0 + step, height - 1);
+      const double tr = (r1 > r0) ? static_cast<double>(r - r0) / (r1 - r0) : 0.0;
 
-      if(needRemap)
-        converter->convert(inputGeo.x, inputGeo.y, inputGeo.x, inputGeo.y);
+      for(int i = 0; i < nodeColumns; ++i)
+      {
+        const te::gm::Coord2D& n0 = nodes[j * nodeColumns + i];
+        const te::gm::Coord2D& n1 = nodes[(j + 1) * nodeColumns + i];
 
-      te::gm::Coord2D outputGrid = overview->getGrid()->geoToGrid(inputGeo.x, inputGeo.y);
+        rowNodes[i].x = n0.x + (n1.x - n0.x) * tr;
+        rowNodes[i].y = n0.y + (n1.y - n0.y) * tr;
+      }
 
-// TODO: round or truncate?
-      int x = te::rst::Round(outputGrid.x);
-      int y = te::rst::Round(outputGrid.y);
+      for(int c = 0; c < width; ++c)
+      {
+        const int i = std::min(c / step, nodeColumns - 2);
+
+        te::gm::Coord2D outputGrid;
+
+        if(exactCells[j * (nodeColumns - 1) + i])
+        {
+          te::gm::Coord2D inputGeo = gridCanvas->gridToGeo(c, r);
+
+          converter->convert(inputGeo.x, inputGeo.y, inputGeo.x, inputGeo.y);
+
+          outputGrid = overviewGrid->geoToGrid(inputGeo.x, inputGeo.y);
+        }
+        else
+        {
+          const int c0 = i * step;
+          const int c1 = std::min(c0 + step, width - 1);
+          const double tc = (c1 > c0) ? static_cast<double>(c - c0) / (c1 - c0) : 0.0;
 
-      te::color::RGBAColor color(0, 0, 0, 0);
+          outputGrid.x = rowNodes[i].x + (rowNodes[i + 1].x - rowNodes[i].x) * tc;
+          outputGrid.y = rowNodes[i].y + (rowNodes[i + 1].y - rowNodes[i].y) * tc;
+        }
 
-      if((x >= 0 && x < (int)(overview->getNumberOfColumns())) &&
-         (y >= 0 && y < (int)(overview->getNumberOfRows())))
-           color = rasterTransform.apply(x, y);
+        icols[c] = te::rst::Round(outputGrid.x);
+        ilins[c] = te::rst::Round(outputGrid.y);
+      }
+    }
+    else
+    {
+      for(int c = 0; c < width; ++c)
+      {
+        te::gm::Coord2D inputGeo = gridCanvas->gridToGeo(c, r);
+
+        te::gm::Coord2D outputGrid = overviewGrid->geoToGrid(inputGeo.x, inputGeo.y);
+
+// TODO: round or truncate?
+        icols[c] = te::rst::Round(outputGrid.x);
+        ilins[c] = te::rst::Round(outputGrid.y);
+      }
+    }
 
-      columns[c] = color;
+    for(int c = 0; c < width; ++c)
+    {
+      if(icols[c] < 0 || icols[c] >= overviewColumns || ilins[c] < 0 || ilins[c] >= overviewRows)
+        icols[c] = -1;
     }
 
-    //rgba[r] = columns;
+    const int blockRow = r % blockHeight;
+
+    rasterTransform.apply(&icols[0], &ilins[0], width, rows[blockRow]);
 
     if(!task.isActive())
     {
 // draw the part of result
-      //canvas->drawImage(0, 0, rgba, canvas->getWidth(), r + 1);
-      canvas->drawImage(0, r, row, canvas->getWidth(), 1);
+      canvas->drawImage(0, r - blockRow, rows, canvas->getWidth(), blockRow + 1);
 
 // free memory
-      //te::common::Free(rgba, r + 1);
-      te::common::Free(row, 1);
+      te::common::Free(rows, blockHeight);
+
+      if(needDelete)
+        delete overview;
 
       return;
     }
 
-    canvas->drawImage(0, r, row, canvas->getWidth(), 1);
+    if(blockRow == blockHeight - 1 || r == height - 1)
+      canvas->drawImage(0, r - blockRow, rows, canvas->getWidth(), blockRow + 1);
 
     task.pulse();
   }
@@ -675,12 +895,8 @@ void te::map::DrawRaster(te::rst::Raster* raster, Canvas* canvas, const te::gm::
   if(needDelete)
     delete overview;
 
-// put the result in the canvas
-  //canvas->drawImage(0, 0, rgba, canvas->getWidth(), canvas->getHeight());
-
 // free memory
-  //te::common::Free(rgba, gridCanvas->getNumberOfRows());
-  te::common::Free(row, 1);
+  te::common::Free(rows, blockHeight);
 
 // image outline
   if(rasterSymbolizer->getImageOutline() == 0)
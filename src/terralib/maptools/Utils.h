@@ -56,6 +56,12 @@ namespace te
     class DataSetType;
   }
 
+  namespace gm
+  {
+    class Geometry;
+    class WKBView;
+  }
+
   namespace rst
   {
     class RasterProperty;
@@ -209,10 +215,11 @@ namespace te
       \param bboxSRID    The SRID of interest area.
       \param srid        The SRID to be used to draw the data set geometries.
       \param style       The style that will be used.
+      \param lodTolerance The size of a pixel in the SRS given by srid, used to generalize the geometries, or 0 to draw them with full detail.
     */
     TEMAPEXPORT void DrawGeometries(te::da::DataSetType* type, te::da::DataSourcePtr ds, Canvas* canvas,
                                     const te::gm::Envelope& bbox, int bboxSRID,
-                                    int srid, te::se::FeatureTypeStyle* style);
+                                    int srid, te::se::FeatureTypeStyle* style, double lodTolerance = 0.0);
 
     /*!
       \brief It draws the data set geometries in the given canvas using the informed SRS.
@@ -223,9 +230,36 @@ namespace te
       \param fromSRID    The SRID of data set geometries.
       \param srid        The SRID to be used to draw the data set geometries.
       \param task        An optional task that can be used cancel the draw process.
+      \param lodTolerance The size of a pixel in the SRS given by toSRID, used to generalize the geometries, or 0 to draw them with full detail.
     */
     TEMAPEXPORT void DrawGeometries(te::da::DataSet* dataset, const std::size_t& gpos,
-                                    Canvas* canvas, int fromSRID, int toSRID, te::common::TaskProgress* task = 0);
+                                    Canvas* canvas, int fromSRID, int toSRID, te::common::TaskProgress* task = 0,
+                                    double lodTolerance = 0.0);
+
+    /*!
+      \brief It prepares a geometry to be drawn in the level of detail mode.
+
+      Lines and polygons smaller than the tolerance should not be drawn. The vertices
+      of the other geometries are decimated to the tolerance.
+
+      \param g         The geometry to be drawn. Its vertices may be removed.
+      \param tolerance The size of a pixel in the geometry SRS.
+
+      \return False if the geometry is smaller than the tolerance and should not be drawn.
+
+      \sa te::gm::Decimate
+    */
+    TEMAPEXPORT bool Generalize(te::gm::Geometry* g, double tolerance);
+
+    /*!
+      \brief It prepares a geometry view to be drawn in the level of detail mode.
+
+      \param view      The geometry to be drawn. Its vertices may be removed.
+      \param tolerance The size of a pixel in the geometry SRS.
+
+      \return False if the geometry is smaller than the tolerance and should not be drawn.
+    */
+    TEMAPEXPORT bool Generalize(te::gm::WKBView& view, double tolerance);
 
     TEMAPEXPORT void DrawRaster(te::da::DataSetType* type, te::da::DataSourcePtr ds, Canvas* canvas,
                                 const te::gm::Envelope& bbox, int bboxSRID, const te::gm::Envelope& visibleArea, int srid, te::se::CoverageStyle* style, const double& scale);
@@ -174,6 +174,22 @@ void te::mem::Band::write(int x, int y, void* buffer)
   memcpy(m_buff, buffer, m_blksize);
 }
 
+void te::mem::Band::getValues(unsigned int c, unsigned int r, unsigned int ncols, unsigned int nrows, double* values) const
+{
+  const int type = m_property->getType();
+
+  for(unsigned int j = 0; j < nrows; ++j)
+    te::rst::GetBufferValues(type, c + (r + j) * m_ncols, ncols, m_buff, values + j * ncols);
+}
+
+void te::mem::Band::setValues(unsigned int c, unsigned int r, unsigned int ncols, unsigned int nrows, const double* values)
+{
+  const int type = m_property->getType();
+
+  for(unsigned int j = 0; j < nrows; ++j)
+    te::rst::SetBufferValues(type, c + (r + j) * m_ncols, ncols, m_buff, values + j * ncols);
+}
+
 void te::mem::Band::setRaster(Raster* r)
 {
   m_raster = r;
@@ -28,6 +28,7 @@
 #include "CachedBand.h"
 
 // STL
+#include <algorithm>
 #include <cstring>
 
 te::mem::CachedBandBlocksManager te::mem::CachedBand::dummyBlocksManager;
@@ -69,7 +70,7 @@ void te::mem::CachedBand::getValue(unsigned int c, unsigned int r, double& value
   m_setGetPos = c % m_blkWidth + ((r % m_blkHeight) * m_blkWidth);
   assert(m_setGetPos < ( m_blkWidth * m_blkHeight ) );
   m_setGetBufPtr = m_blocksManager.getBlockPointer( m_idx, m_setGetBlkX, 
-    m_setGetBlkY );
+    m_setGetBlkY, false );
   m_getBuff(m_setGetPos, m_setGetBufPtr, &value );
 }
 
@@ -91,7 +92,7 @@ void te::mem::CachedBand::getIValue(unsigned int c, unsigned int r, double& valu
   m_setGetPos = c % m_blkWidth + ((r % m_blkHeight) * m_blkWidth);
   assert(m_setGetPos < ( m_blkWidth * m_blkHeight ) );
   m_setGetBufPtr = m_blocksManager.getBlockPointer( m_idx, m_setGetBlkX, 
-    m_setGetBlkY );
+    m_setGetBlkY, false );
   m_getBuffI(m_setGetPos, m_setGetBufPtr, &value );
 }
 
@@ -109,7 +110,7 @@ void te::mem::CachedBand::setIValue(unsigned int c, unsigned int r, const double
 void te::mem::CachedBand::read(int x, int y, void* buffer) const
 {
   assert( m_blocksManager.isInitialized() );
-  memcpy( buffer, m_blocksManager.getBlockPointer( m_idx, x, y ),
+  memcpy( buffer, m_blocksManager.getBlockPointer( m_idx, x, y, false ),
     m_blkSizeBytes );
 }
 
@@ -120,4 +121,59 @@ void te::mem::CachedBand::write(int x, int y, void* buffer)
           m_blkSizeBytes );
 }
 
+void te::mem::CachedBand::getValues(unsigned int c, unsigned int r, unsigned int ncols, unsigned int nrows, double* values) const
+{
+  assert( m_blocksManager.isInitialized() );
+
+  const int type = m_property->getType();
+  const unsigned int cf = c + ncols;
+
+  for( unsigned int row = r; row < r + nrows; ++row )
+  {
+    const unsigned int blkY = row / m_blkHeight;
+    const unsigned int blkRowPos = ( row % m_blkHeight ) * m_blkWidth;
+
+// one conversion call for each block span of the row
+    for( unsigned int col = c; col < cf; )
+    {
+      const unsigned int blkCol = col % m_blkWidth;
+      const unsigned int count = std::min( m_blkWidth - blkCol, cf - col );
+
+      te::rst::GetBufferValues( type, (int)( blkRowPos + blkCol ), (int)count,
+        m_blocksManager.getBlockPointer( (unsigned int)m_idx, col / m_blkWidth, blkY, false ),
+        values + ( col - c ) );
+
+      col += count;
+    }
+
+    values += ncols;
+  }
+}
+
+void te::mem::CachedBand::setValues(unsigned int c, unsigned int r, unsigned int ncols, unsigned int nrows, const double* values)
+{
+  assert( m_blocksManager.isInitialized() );
+
+  const int type = m_property->getType();
+  const unsigned int cf = c + ncols;
 
+  for( unsigned int row = r; row < r + nrows; ++row )
+  {
+    const unsigned int blkY = row / m_blkHeight;
+    const unsigned int blkRowPos = ( row % m_blkHeight ) * m_blkWidth;
+
+    for( unsigned int col = c; col < cf; )
+    {
+      const unsigned int blkCol = col % m_blkWidth;
+      const unsigned int count = std::min( m_blkWidth - blkCol, cf - col );
+
+      te::rst::SetBufferValues( type, (int)( blkRowPos + blkCol ), (int)count,
+        m_blocksManager.getBlockPointer( (unsigned int)m_idx, col / m_blkWidth, blkY ),
+        values + ( col - c ) );
+
+      col += count;
+    }
+
+    values += ncols;
+  }
+}
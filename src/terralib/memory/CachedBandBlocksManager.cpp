@@ -31,17 +31,37 @@
 
 // STL
 #include <algorithm>
+#include <cmath>
+
+// Boost
+#include <boost/bind.hpp>
 
 void te::mem::CachedBandBlocksManager::initState()
 {
   m_rasterPtr = 0;
+  m_rasterWriteAccess = false;
   m_dataPrefetchThreshold = 0;
+  m_ioThreadsNumber = 0;
   m_globalBlocksNumberX = 0;
   m_globalBlocksNumberY = 0;
   m_globalBlockSizeBytes = 0;
   m_maxNumberOfCacheBlocks = 0;
-  m_blocksFifoNextSwapBlockIndex = 0;
-  m_getBlockPointer_BlkPtr = 0;
+  m_usedCacheBlocksNumber = 0;
+  m_clockHandIndex = 0;
+  m_maxPendingReadsNumber = 0;
+  m_pendingReadsNumber = 0;
+  m_maxWriteBlocksNumber = 0;
+  m_writeBlocksNumber = 0;
+  m_stopThreads = false;
+  m_lastBlockIndex = NoBlockIndex;
+  m_lastBlockB = 0;
+  m_lastBlockX = 0;
+  m_lastBlockY = 0;
+  m_lineSequenceLength = 0;
+  m_columnSequenceLength = 0;
+  m_bandSequenceLength = 0;
+  
+  resetCounters();
 }
 
 te::mem::CachedBandBlocksManager::CachedBandBlocksManager()
@@ -56,7 +76,7 @@ te::mem::CachedBandBlocksManager::~CachedBandBlocksManager()
 
 bool te::mem::CachedBandBlocksManager::initialize( 
   const te::rst::Raster& externalRaster, const unsigned char maxMemPercentUsed, 
-  const unsigned int dataPrefetchThreshold)
+  const unsigned int dataPrefetchThreshold, const unsigned int ioThreadsNumber )
 {
   free();
   
@@ -79,13 +99,15 @@ bool te::mem::CachedBandBlocksManager::initialize(
   const unsigned int maxNumberOfCacheBlocks = (unsigned int)
     std::max( 1.0, std::ceil( freeVMem / ((double)maxBlockSizeBytes) ) );
     
-  return initialize( maxNumberOfCacheBlocks, externalRaster, dataPrefetchThreshold );
+  return initialize( maxNumberOfCacheBlocks, externalRaster, dataPrefetchThreshold,
+    ioThreadsNumber );
 }
 
 bool te::mem::CachedBandBlocksManager::initialize( 
   const unsigned int maxNumberOfCacheBlocks, 
   const te::rst::Raster& externalRaster, 
-  const unsigned int dataPrefetchThreshold)
+  const unsigned int dataPrefetchThreshold,
+  const unsigned int ioThreadsNumber )
 {
   free();
   
@@ -93,60 +115,65 @@ bool te::mem::CachedBandBlocksManager::initialize(
   
   unsigned int numberOfRasterBlocks = 0;
   
+  m_bandsBlocksNumberX.resize( externalRaster.getNumberOfBands(), 0 );
+  m_bandsBlocksNumberY.resize( externalRaster.getNumberOfBands(), 0 );
+  
   for( unsigned int bandIdx = 0 ; bandIdx < externalRaster.getNumberOfBands() ;
     ++bandIdx )
   {
-    if( m_globalBlocksNumberX < (unsigned int)externalRaster.getBand( bandIdx )->getProperty()->m_nblocksx )
-      m_globalBlocksNumberX = (unsigned int)externalRaster.getBand( bandIdx )->getProperty()->m_nblocksx;
+    m_bandsBlocksNumberX[ bandIdx ] = (unsigned int)externalRaster.getBand( bandIdx )->getProperty()->m_nblocksx;
+    m_bandsBlocksNumberY[ bandIdx ] = (unsigned int)externalRaster.getBand( bandIdx )->getProperty()->m_nblocksy;
+    
+    if( m_globalBlocksNumberX < m_bandsBlocksNumberX[ bandIdx ] )
+      m_globalBlocksNumberX = m_bandsBlocksNumberX[ bandIdx ];
       
-    if( m_globalBlocksNumberY < (unsigned int)externalRaster.getBand( bandIdx )->getProperty()->m_nblocksy )
-      m_globalBlocksNumberY = (unsigned int)externalRaster.getBand( bandIdx )->getProperty()->m_nblocksy;
+    if( m_globalBlocksNumberY < m_bandsBlocksNumberY[ bandIdx ] )
+      m_globalBlocksNumberY = m_bandsBlocksNumberY[ bandIdx ];
       
     if( m_globalBlockSizeBytes < (unsigned int)externalRaster.getBand( bandIdx )->getBlockSize() )
       m_globalBlockSizeBytes = (unsigned int)externalRaster.getBand( bandIdx )->getBlockSize();
     
     numberOfRasterBlocks +=
-      ( externalRaster.getBand( bandIdx )->getProperty()->m_nblocksx *
-      externalRaster.getBand( bandIdx )->getProperty()->m_nblocksy );    
+      ( m_bandsBlocksNumberX[ bandIdx ] * m_bandsBlocksNumberY[ bandIdx ] );    
   }
     
   // Allocating the internal structures
   
   m_rasterPtr = (te::rst::Raster*)&externalRaster;
+  m_rasterWriteAccess = ( externalRaster.getAccessPolicy() & te::common::WAccess ) ? 
+    true : false;
   m_dataPrefetchThreshold = dataPrefetchThreshold;
   
   m_maxNumberOfCacheBlocks = std::min( maxNumberOfCacheBlocks, numberOfRasterBlocks );
   m_maxNumberOfCacheBlocks = std::max( m_maxNumberOfCacheBlocks, (unsigned int)1 );
   
-  unsigned int blockBIdx = 0;  
-  m_blocksPointers.resize( externalRaster.getNumberOfBands() );
+  const unsigned int blocksNumber = ((unsigned int)externalRaster.getNumberOfBands()) *
+    m_globalBlocksNumberY * m_globalBlocksNumberX;
+  
+  m_blocksCacheIndexes.resize( blocksNumber, -1 );
+  m_blocksWriteStatus.resize( blocksNumber, NoWriteS );
   
-  for( blockBIdx = 0 ; blockBIdx < m_blocksPointers.size() ;  ++blockBIdx )
+  m_cacheBlocks.resize( m_maxNumberOfCacheBlocks );
+  
+  for( unsigned int cacheBlockIdx = 0 ; cacheBlockIdx < m_maxNumberOfCacheBlocks ;
+    ++cacheBlockIdx )
   {
-    m_blocksPointers[ blockBIdx ].resize( m_globalBlocksNumberY );
-    
-    for( unsigned int blockYIdx = 0 ; blockYIdx < m_globalBlocksNumberY ;
-      ++blockYIdx )
-    {
-      m_blocksPointers[ blockBIdx ][ blockYIdx ].resize( m_globalBlocksNumberX, 0 );
-    }
+    m_cacheBlocks[ cacheBlockIdx ].m_blockIndex = NoBlockIndex;
   }
   
+  // Starting the I/O threads
+  
   if( m_dataPrefetchThreshold )
   {
-    m_threadParams.m_rasterPtr = (te::rst::Raster*)&externalRaster;
-    m_threadParams.m_dataPrefetchThreshold = dataPrefetchThreshold;
-    m_threadParams.m_taskFinished = false;
-    m_threadParams.m_task = ThreadParameters::InvalidTaskT;
-    m_threadParams.m_blockPtr= 0;
-    m_threadParams.m_exchangeBlockPtr= 0;
-    m_threadParams.m_blockB = 0;
-    m_threadParams.m_blockX = 0;
-    m_threadParams.m_blockY = 0;
-    m_threadParams.m_threadDataBlockHandler.reset( new unsigned char[
-      m_globalBlockSizeBytes ] );
-    
-    m_threadHandler.reset( new boost::thread( threadEntry, &m_threadParams ) );
+    m_ioThreadsNumber = std::max( ioThreadsNumber, (unsigned int)1 );
+    m_maxPendingReadsNumber = m_maxNumberOfCacheBlocks / 2;
+    m_maxWriteBlocksNumber = m_ioThreadsNumber + 1;
+    
+    for( unsigned int threadIdx = 0 ; threadIdx < m_ioThreadsNumber ; ++threadIdx )
+    {
+      m_threads.create_thread( boost::bind( &CachedBandBlocksManager::threadEntry,
+        this ) );
+    }
   }
   
   return true;
@@ -154,426 +181,581 @@ bool te::mem::CachedBandBlocksManager::initialize(
 
 void te::mem::CachedBandBlocksManager::free()
 {
-  // Stopping the thread
+  // Stopping the threads after all pending tasks are done
   
-  if( m_dataPrefetchThreshold )
+  if( m_ioThreadsNumber )
   {
     {
-      boost::lock_guard<boost::mutex> lock(m_threadParams.m_doTaskMutex);
-      m_threadParams.m_task = ThreadParameters::SuicideTastT;
-      m_threadParams.m_doTaskCondVar.notify_one();
+      boost::lock_guard<boost::mutex> lock( m_tasksMutex );
+      m_stopThreads = true;
     }
     
-    m_threadHandler->join();
-    m_threadHandler.reset();
+    m_taskAvailableCondVar.notify_all();
+    
+    m_threads.join_all();
   }  
   
+  assert( m_tasks.empty() );
+  
   // flushing the ram data, if necessary
   
-  if( ( m_rasterPtr != 0 ) &&
-    ( m_rasterPtr->getAccessPolicy() & te::common::WAccess ) )
+  unsigned char* blockPtr = 0;
+  
+  for( std::vector< CacheBlock >::size_type cacheBlockIdx = 0 ; 
+    cacheBlockIdx < m_cacheBlocks.size() ; ++cacheBlockIdx )
   {
-    unsigned int blockBIdx = 0;
-    unsigned int blockYIdx = 0;
-    unsigned int blockXIdx = 0;
-    void* blockPtr = 0;
+    CacheBlock& cacheBlock = m_cacheBlocks[ cacheBlockIdx ];
     
-    for( blockBIdx = 0 ; blockBIdx < m_blocksPointers.size() ;  ++blockBIdx )
+    if( cacheBlock.m_dirty && m_rasterWriteAccess )
     {
-      for( blockYIdx = 0 ; blockYIdx < m_globalBlocksNumberY ;
-        ++blockYIdx )
-      {
-        for( blockXIdx = 0 ; blockXIdx < m_globalBlocksNumberX ;
-          ++blockXIdx )
-        {
-          blockPtr = m_blocksPointers[ blockBIdx ][ blockYIdx ][ blockXIdx ];
-          
-          if( blockPtr )
-          {
-            m_rasterPtr->getBand( blockBIdx )->write( blockXIdx, blockYIdx,
-              blockPtr );
-          }
-        }
-      }
+      assert( cacheBlock.m_blockIndex != NoBlockIndex );
+      rasterIO( false, cacheBlock.m_blockIndex, cacheBlock.m_dataPtr );
     }
-  }
-  
-  m_blocksPointers.clear();
-  
-  unsigned char* blockPtr = 0;
-  for( std::vector< unsigned char* >::size_type blocksHandlerIdx = 0 ; 
-    blocksHandlerIdx < m_blocksHandler.size() ; ++blocksHandlerIdx )
-  {
-    blockPtr = m_blocksHandler[ blocksHandlerIdx ];
+    
+    blockPtr = cacheBlock.m_dataPtr;
     if( blockPtr )
     {
       delete[]( blockPtr );
     }
   }
-  m_blocksHandler.clear();
   
-  m_blocksFifo.clear();
-  m_threadHandler.reset();
-  m_threadParams.m_threadDataBlockHandler.reset();
+  for( std::vector< unsigned char* >::size_type freeBlocksIdx = 0 ; 
+    freeBlocksIdx < m_freeWriteBlocks.size() ; ++freeBlocksIdx )
+  {
+    delete[]( m_freeWriteBlocks[ freeBlocksIdx ] );
+  }
+  
+  m_bandsBlocksNumberX.clear();
+  m_bandsBlocksNumberY.clear();
+  m_blocksCacheIndexes.clear();
+  m_blocksWriteStatus.clear();
+  m_cacheBlocks.clear();
+  m_freeWriteBlocks.clear();
   
   initState();
 }
 
 void* te::mem::CachedBandBlocksManager::getBlockPointer(unsigned int band, 
-  unsigned int x, unsigned int y )
+  unsigned int x, unsigned int y, const bool forWriting )
 {
   assert( m_rasterPtr );
   assert( band < m_rasterPtr->getNumberOfBands() );
   assert( x < m_globalBlocksNumberX );
   assert( y < m_globalBlocksNumberY );
-  assert( x < (unsigned int)m_rasterPtr->getBand( band )->getProperty()->m_nblocksx );
-  assert( y < (unsigned int)m_rasterPtr->getBand( band )->getProperty()->m_nblocksy );
+  assert( x < m_bandsBlocksNumberX[ band ] );
+  assert( y < m_bandsBlocksNumberY[ band ] );
+  
+  const unsigned int blockIndex = getBlockIndex( band, x, y );
   
-  m_getBlockPointer_BlkPtr = m_blocksPointers[ band ][ y ][ x ];
+  int cacheBlockIndex = m_blocksCacheIndexes[ blockIndex ];
   
-  if( m_getBlockPointer_BlkPtr == 0 )
+  if( cacheBlockIndex < 0 )
   {
-    // Is swapp necessary ?
-    if( m_blocksHandler.size() < m_maxNumberOfCacheBlocks )
+    ++m_missesCount;
+    
+    cacheBlockIndex = (int)acquireCacheBlock();
+    loadCacheBlock( (unsigned int)cacheBlockIndex, blockIndex );
+  }
+  else
+  {
+    ++m_hitsCount;
+    
+    if( m_cacheBlocks[ cacheBlockIndex ].m_pending )
+    {
+      collectPrefetchedBlock( (unsigned int)cacheBlockIndex, true );
+    }
+    
+    if( m_cacheBlocks[ cacheBlockIndex ].m_prefetched )
+    {
+      ++m_prefetchHitsCount;
+      m_cacheBlocks[ cacheBlockIndex ].m_prefetched = false;
+    }
+  }
+  
+  CacheBlock& cacheBlock = m_cacheBlocks[ cacheBlockIndex ];
+  
+  cacheBlock.m_referenced = true;
+  
+  if( forWriting )
+  {
+    cacheBlock.m_dirty = true;
+  }
+  
+  if( blockIndex != m_lastBlockIndex )
+  {
+    if( m_ioThreadsNumber )
     {
-      m_getBlockPointer_BlkPtr = new unsigned char[ m_globalBlockSizeBytes ];
-      m_blocksHandler.push_back( m_getBlockPointer_BlkPtr );
+      updateAccessPattern( band, x, y );
+    }
+    
+    // from now on the required block is kept in cache by acquireCacheBlock
+    m_lastBlockIndex = blockIndex;
+    m_lastBlockB = band;
+    m_lastBlockX = x;
+    m_lastBlockY = y;
+    
+    if( m_ioThreadsNumber )
+    {
+      readAhead( band, x, y );
+    }
+  }
+  
+  return cacheBlock.m_dataPtr;
+}
+
+void te::mem::CachedBandBlocksManager::resetCounters()
+{
+  m_hitsCount = 0;
+  m_missesCount = 0;
+  m_evictionsCount = 0;
+  m_writeBacksCount = 0;
+  m_prefetchesCount = 0;
+  m_prefetchHitsCount = 0;
+}
+
+unsigned int te::mem::CachedBandBlocksManager::acquireCacheBlock()
+{
+  if( m_usedCacheBlocksNumber < m_maxNumberOfCacheBlocks )
+  {
+    m_cacheBlocks[ m_usedCacheBlocksNumber ].m_dataPtr = 
+      new unsigned char[ m_globalBlockSizeBytes ];
+    
+    return m_usedCacheBlocksNumber++;
+  }
+  
+  // CLOCK replacement - the last required block is kept (when possible) since
+  // the caller may still be using it
+  
+  const unsigned int cacheBlocksNumber = (unsigned int)m_cacheBlocks.size();
+  unsigned int visitedBlocksNumber = 0;
+  unsigned int cacheBlockIndex = 0;
+  
+  while( true )
+  {
+    cacheBlockIndex = m_clockHandIndex;
+    m_clockHandIndex = ( m_clockHandIndex + 1 ) % cacheBlocksNumber;
+    
+    CacheBlock& cacheBlock = m_cacheBlocks[ cacheBlockIndex ];
+    
+    if( ( cacheBlocksNumber > 1 ) && ( cacheBlock.m_blockIndex == m_lastBlockIndex ) )
+    {
+      continue;
+    }
+    
+    ++visitedBlocksNumber;
+    
+    // read-ahead blocks still being read are skipped while there are other 
+    // candidates
+    if( cacheBlock.m_pending && ( ! collectPrefetchedBlock( cacheBlockIndex,
+      visitedBlocksNumber > 2 * cacheBlocksNumber ) ) )
+    {
+      continue;
+    }
+    
+    if( cacheBlock.m_referenced )
+    {
+      cacheBlock.m_referenced = false;
+      continue;
+    }
+    
+    evictCacheBlock( cacheBlockIndex );
+    
+    return cacheBlockIndex;
+  }
+}
+
+void te::mem::CachedBandBlocksManager::evictCacheBlock( 
+  const unsigned int cacheBlockIndex )
+{
+  CacheBlock& cacheBlock = m_cacheBlocks[ cacheBlockIndex ];
+  
+  if( cacheBlock.m_blockIndex == NoBlockIndex )
+  {
+    return;
+  }
+  
+  assert( ! cacheBlock.m_pending );
+  
+  ++m_evictionsCount;
+  
+  m_blocksCacheIndexes[ cacheBlock.m_blockIndex ] = -1;
+  
+  // writing the block, if necessary
+  
+  if( cacheBlock.m_dirty && m_rasterWriteAccess )
+  {
+    ++m_writeBacksCount;
+    
+    if( m_ioThreadsNumber )
+    {
+      // the block data goes to an I/O thread and the cache block receives 
+      // an extra block
+      
+      boost::unique_lock<boost::mutex> lock( m_tasksMutex );
+      
+      while( m_freeWriteBlocks.empty() && 
+        ( m_writeBlocksNumber >= m_maxWriteBlocksNumber ) )
+      {
+        m_taskFinishedCondVar.wait( lock );
+      }
       
-      // add FIFO information of the new block
-      BlockIndex newBlockFifoIndex;
-      newBlockFifoIndex.m_b = band;
-      newBlockFifoIndex.m_y = y;
-      newBlockFifoIndex.m_x = x; 
-      m_blocksFifo.push_back( newBlockFifoIndex );
+      IOTask task;
+      task.m_task = IOTask::WriteTaskT;
+      task.m_blockIndex = cacheBlock.m_blockIndex;
+      task.m_dataPtr = cacheBlock.m_dataPtr;
+      
+      m_tasks.push_back( task );
+      m_blocksWriteStatus[ cacheBlock.m_blockIndex ] = QueuedWriteS;
+      
+      if( m_freeWriteBlocks.empty() )
+      {
+        cacheBlock.m_dataPtr = new unsigned char[ m_globalBlockSizeBytes ];
+        ++m_writeBlocksNumber;
+      }
+      else
+      {
+        cacheBlock.m_dataPtr = m_freeWriteBlocks.back();
+        m_freeWriteBlocks.pop_back();
+      }
+      
+      m_taskAvailableCondVar.notify_one();
     }
     else
     {
-      BlockIndex& choosedSwapBlockIndex = m_blocksFifo[ 
-        m_blocksFifoNextSwapBlockIndex ];   
+      rasterIO( false, cacheBlock.m_blockIndex, cacheBlock.m_dataPtr );
+    }
+  }
+  
+  cacheBlock.m_blockIndex = NoBlockIndex;
+  cacheBlock.m_referenced = false;
+  cacheBlock.m_dirty = false;
+  cacheBlock.m_prefetched = false;
+}
+
+void te::mem::CachedBandBlocksManager::loadCacheBlock( 
+  const unsigned int cacheBlockIndex, const unsigned int blockIndex )
+{
+  CacheBlock& cacheBlock = m_cacheBlocks[ cacheBlockIndex ];
+  
+  assert( cacheBlock.m_blockIndex == NoBlockIndex );
+  
+  cacheBlock.m_blockIndex = blockIndex;
+  cacheBlock.m_referenced = false;
+  cacheBlock.m_dirty = false;
+  cacheBlock.m_prefetched = false;
+  
+  m_blocksCacheIndexes[ blockIndex ] = (int)cacheBlockIndex;
+  
+  if( m_ioThreadsNumber )
+  {
+    // The block may have been removed from the cache and not written yet
+    
+    boost::unique_lock<boost::mutex> lock( m_tasksMutex );
+    
+    if( m_blocksWriteStatus[ blockIndex ] == QueuedWriteS )
+    {
+      // the write-back task is cancelled and its data goes back to the cache
       
-      m_getBlockPointer_BlkPtr = m_blocksPointers[ choosedSwapBlockIndex.m_b ][ 
-        choosedSwapBlockIndex.m_y ][ choosedSwapBlockIndex.m_x ];
-      assert( m_getBlockPointer_BlkPtr );
-      m_blocksPointers[ choosedSwapBlockIndex.m_b ][ 
-        choosedSwapBlockIndex.m_y ][ choosedSwapBlockIndex.m_x ] = 0;
-        
-      // writing the block choosed for swap, if necessary
-      if( m_rasterPtr->getAccessPolicy() & te::common::WAccess )
+      for( std::deque< IOTask >::iterator it = m_tasks.begin() ; 
+        it != m_tasks.end() ; ++it )
       {
-        if( m_dataPrefetchThreshold )
+        if( ( it->m_task == IOTask::WriteTaskT ) && ( it->m_blockIndex == blockIndex ) )
         {
-          // request a block writing to the thread
-          {
-            boost::lock_guard<boost::mutex> lock(m_threadParams.m_doTaskMutex);
-            
-            m_threadParams.m_blockB = choosedSwapBlockIndex.m_b;
-            m_threadParams.m_blockX = choosedSwapBlockIndex.m_x;
-            m_threadParams.m_blockY = choosedSwapBlockIndex.m_y;
-            m_threadParams.m_blockPtr = m_getBlockPointer_BlkPtr;             
-            m_threadParams.m_exchangeBlockPtr = 0;
-            m_threadParams.m_task = ThreadParameters::WriteTaskT;
-            m_threadParams.m_taskFinished = false;
-          }
+          m_freeWriteBlocks.push_back( cacheBlock.m_dataPtr );
+          cacheBlock.m_dataPtr = it->m_dataPtr;
+          cacheBlock.m_dirty = true;
           
-          m_threadParams.m_doTaskCondVar.notify_one();
+          m_tasks.erase( it );
+          m_blocksWriteStatus[ blockIndex ] = NoWriteS;
           
-          // wait for the block writing request to finish
-          while( ! m_threadParams.m_taskFinished )
-          {
-            boost::unique_lock<boost::mutex> lock(
-              m_threadParams.m_taskFinishedMutex);
-              
-            while( ! m_threadParams.m_taskFinished )
-            {
-              m_threadParams.m_taskFinishedCondVar.wait( lock );
-            }
-          }
-        }
-        else
-        {
-          m_rasterPtr->getBand( choosedSwapBlockIndex.m_b )->write( 
-            choosedSwapBlockIndex.m_x, choosedSwapBlockIndex.m_y,
-            m_getBlockPointer_BlkPtr );
+          m_taskFinishedCondVar.notify_all();
+          
+          return;
         }
       }
-      
-      // advances the next swap block fifo index
-      choosedSwapBlockIndex.m_b = band;
-      choosedSwapBlockIndex.m_y = y;
-      choosedSwapBlockIndex.m_x = x;    
-      m_blocksFifoNextSwapBlockIndex = ( m_blocksFifoNextSwapBlockIndex + 1 ) % 
-        ((unsigned int)m_blocksFifo.size());        
     }
     
-    // reading the required block
-    if( m_dataPrefetchThreshold )
+    while( m_blocksWriteStatus[ blockIndex ] != NoWriteS )
     {
-      // request a block reading to the thread
+      m_taskFinishedCondVar.wait( lock );
+    }
+  }
+  
+  rasterIO( true, blockIndex, cacheBlock.m_dataPtr );
+}
+
+bool te::mem::CachedBandBlocksManager::collectPrefetchedBlock( 
+  const unsigned int cacheBlockIndex, const bool wait )
+{
+  CacheBlock& cacheBlock = m_cacheBlocks[ cacheBlockIndex ];
+  
+  assert( cacheBlock.m_pending );
+  
+  {
+    boost::unique_lock<boost::mutex> lock( m_tasksMutex );
+    
+    if( ! cacheBlock.m_loaded )
+    {
+      if( ! wait )
       {
-        boost::lock_guard<boost::mutex> lock(m_threadParams.m_doTaskMutex);
-        
-        m_threadParams.m_blockB = band;
-        m_threadParams.m_blockX = x;
-        m_threadParams.m_blockY = y;
-        m_threadParams.m_blockPtr = 0;
-        m_threadParams.m_exchangeBlockPtr = m_getBlockPointer_BlkPtr;
-        m_threadParams.m_task = ThreadParameters::ReadTaskT;
-        m_threadParams.m_taskFinished = false;
-        
-        m_threadParams.m_doTaskCondVar.notify_one();
+        return false;
       }
       
-      // wait for the block reading request to finish
+      // if no I/O thread started the read-ahead, the block is read here
+      
+      bool readHere = false;
+      
+      for( std::deque< IOTask >::iterator it = m_tasks.begin() ; 
+        it != m_tasks.end() ; ++it )
       {
-        boost::unique_lock<boost::mutex> lock(
-          m_threadParams.m_taskFinishedMutex);
-          
-        while( ! m_threadParams.m_taskFinished )
+        if( ( it->m_task == IOTask::ReadTaskT ) && 
+          ( it->m_cacheBlockIndex == cacheBlockIndex ) )
         {
-          m_threadParams.m_taskFinishedCondVar.wait( lock );
+          m_tasks.erase( it );
+          readHere = true;
+          break;
         }
       }
       
-      m_threadParams.m_taskFinished = false;
-      
-      m_blocksPointers[ band ][ y ][ x ] = m_threadParams.m_blockPtr;
-      m_getBlockPointer_BlkPtr = m_threadParams.m_blockPtr;
+      if( readHere )
+      {
+        lock.unlock();
+        rasterIO( true, cacheBlock.m_blockIndex, cacheBlock.m_dataPtr );
+      }
+      else
+      {
+        while( ! cacheBlock.m_loaded )
+        {
+          m_taskFinishedCondVar.wait( lock );
+        }
+      }
+    }
+  }
+  
+  cacheBlock.m_loaded = false;
+  cacheBlock.m_pending = false;
+  --m_pendingReadsNumber;
+  
+  return true;
+}
+
+void te::mem::CachedBandBlocksManager::updateAccessPattern( const unsigned int band, 
+  const unsigned int x, const unsigned int y )
+{
+  if( m_lastBlockIndex != NoBlockIndex )
+  {
+    if( ( band == m_lastBlockB ) && ( y == m_lastBlockY ) && ( x == m_lastBlockX + 1 ) )
+    {
+      ++m_lineSequenceLength;
+      m_columnSequenceLength = 0;
+      m_bandSequenceLength = 0;
+    }
+    else if( ( band == m_lastBlockB ) && ( x == 0 ) && ( ( y == m_lastBlockY ) || 
+      ( y == m_lastBlockY + 1 ) ) )
+    {
+      // going back to the line start (the next line of pixels or the 
+      // next line of blocks) keeps the line sequence
+      m_columnSequenceLength = 0;
+      m_bandSequenceLength = 0;
+    }
+    else if( ( band == m_lastBlockB ) && ( x == m_lastBlockX ) && ( y == m_lastBlockY + 1 ) )
+    {
+      m_lineSequenceLength = 0;
+      ++m_columnSequenceLength;
+      m_bandSequenceLength = 0;
+    }
+    else if( ( band == m_lastBlockB + 1 ) && ( x == m_lastBlockX ) && ( y == m_lastBlockY ) )
+    {
+      m_lineSequenceLength = 0;
+      m_columnSequenceLength = 0;
+      ++m_bandSequenceLength;
     }
     else
-    {    
-      m_rasterPtr->getBand( band )->read( x, y, m_getBlockPointer_BlkPtr );
-      m_blocksPointers[ band ][ y ][ x ] = m_getBlockPointer_BlkPtr;
+    {
+      m_lineSequenceLength = 0;
+      m_columnSequenceLength = 0;
+      m_bandSequenceLength = 0;
     }
-    
-      
   }
-  
-  return m_getBlockPointer_BlkPtr;  
 }
 
-void te::mem::CachedBandBlocksManager::threadEntry(ThreadParameters* paramsPtr)
+void te::mem::CachedBandBlocksManager::readAhead( const unsigned int band, 
+  const unsigned int x, const unsigned int y )
 {
-//  std::cout << std::endl << "Thread started" << std::endl;
-  
-  assert( paramsPtr );
-  assert( paramsPtr->m_rasterPtr );
-  
-  // internal data block to exchange
-  unsigned char* internalExchangeBlockPtr = paramsPtr->m_threadDataBlockHandler.get();
-  assert( internalExchangeBlockPtr );
-  
-  int globalReadAheadDirectionVectorX = 0;
-  int globalReadAheadDirectionVectorY = 0;
-  int globalReadAheadDirectionVectorB = 0;
-  bool globalReadAheadBlockReady = false;
-  int globalReadAheadBlockB = 0;
-  int globalReadAheadBlockX = 0;
-  int globalReadAheadBlockY = 0;  
-  int lastReadBlockX = 0;
-  int lastReadBlockY = 0;
-  int lastReadBlockB = 0;
-  
-  int currentReadDirectionVectorX = 0;
-  int currentReadDirectionVectorY = 0;
-  int currentReadDirectionVectorB = 0;
-  int nextReadAheadBlkB = 0;
-  int nextReadAheadBlkX = 0;
-  int nextReadAheadBlkY = 0;
-  bool doReadAhead = false;
+  const unsigned int blocksNumberX = m_bandsBlocksNumberX[ band ];
+  const unsigned int blocksNumberY = m_bandsBlocksNumberY[ band ];
   
-  while( true )
+  if( m_lineSequenceLength >= m_dataPrefetchThreshold )
   {
-    // wait for a task
-    boost::unique_lock<boost::mutex> lock( paramsPtr->m_doTaskMutex );
-    while( paramsPtr->m_task == ThreadParameters::InvalidTaskT )
+    if( x + 1 < blocksNumberX )
     {
-      paramsPtr->m_doTaskCondVar.wait( lock );
+      prefetchBlock( band, x + 1, y );
     }
-    
-    if( paramsPtr->m_task == ThreadParameters::ReadTaskT )
+    else if( y + 1 < blocksNumberY )
     {
-//      std::cout << std::endl << "Starting a read task" << std::endl;
-      
-      assert( paramsPtr->m_blockPtr == 0 );
-      assert( paramsPtr->m_exchangeBlockPtr );
+      // at the end of a line of blocks the next line is read when it fits 
+      // into the cache with the current one
       
-      if( globalReadAheadBlockReady 
-        && ( globalReadAheadBlockB == (int)paramsPtr->m_blockB )
-        && ( globalReadAheadBlockX == (int)paramsPtr->m_blockX )
-        && ( globalReadAheadBlockY == (int)paramsPtr->m_blockY ) )
-      { 
-//        std::cout << std::endl << "Read-ahead block is avaliable, it will be used" << std::endl;
-        
-        // use the read-ahed block
-        paramsPtr->m_blockPtr = internalExchangeBlockPtr;
-        globalReadAheadBlockReady = false;
-        internalExchangeBlockPtr = paramsPtr->m_exchangeBlockPtr;
-        
-//        std::cout << std::endl << "Read-ahead block used." << std::endl;
+      if( m_maxNumberOfCacheBlocks > 2 * blocksNumberX )
+      {
+        for( unsigned int nextX = 0 ; nextX < blocksNumberX ; ++nextX )
+        {
+          if( ! prefetchBlock( band, nextX, y + 1 ) )
+          {
+            break;
+          }
+        }
       }
       else
-      { 
-//        std::cout << std::endl << "Read-ahead block not avaliable, block will be read from raster" << std::endl;
-        
-        // read from the external raster
-        paramsPtr->m_rasterPtr->getBand( paramsPtr->m_blockB )->read( paramsPtr->m_blockX, 
-          paramsPtr->m_blockY, paramsPtr->m_exchangeBlockPtr );
-        paramsPtr->m_blockPtr = paramsPtr->m_exchangeBlockPtr;
-          
-//        std::cout << std::endl << "Block readed from raster." << std::endl;
+      {
+        prefetchBlock( band, 0, y + 1 );
       }
+    }
+  }
+  
+  if( ( m_columnSequenceLength >= m_dataPrefetchThreshold ) &&
+    ( y + 1 < blocksNumberY ) )
+  {
+    prefetchBlock( band, x, y + 1 );
+  }
+  
+  if( ( m_bandSequenceLength >= m_dataPrefetchThreshold ) &&
+    ( band + 1 < m_bandsBlocksNumberX.size() ) &&
+    ( x < m_bandsBlocksNumberX[ band + 1 ] ) &&
+    ( y < m_bandsBlocksNumberY[ band + 1 ] ) )
+  {
+    prefetchBlock( band + 1, x, y );
+  }
+}
+
+bool te::mem::CachedBandBlocksManager::prefetchBlock( const unsigned int band, 
+  const unsigned int x, const unsigned int y )
+{
+  if( m_pendingReadsNumber >= m_maxPendingReadsNumber )
+  {
+    return false;
+  }
+  
+  const unsigned int blockIndex = getBlockIndex( band, x, y );
+  
+  if( m_blocksCacheIndexes[ blockIndex ] >= 0 )
+  {
+    return true;
+  }
+  
+  {
+    boost::lock_guard<boost::mutex> lock( m_tasksMutex );
+    
+    if( m_blocksWriteStatus[ blockIndex ] != NoWriteS )
+    {
+      return true;
+    }
+  }
+  
+  const unsigned int cacheBlockIndex = acquireCacheBlock();
+  
+  CacheBlock& cacheBlock = m_cacheBlocks[ cacheBlockIndex ];
+  
+  cacheBlock.m_blockIndex = blockIndex;
+  cacheBlock.m_referenced = true;
+  cacheBlock.m_dirty = false;
+  cacheBlock.m_prefetched = true;
+  cacheBlock.m_pending = true;
+  cacheBlock.m_loaded = false;
+  
+  m_blocksCacheIndexes[ blockIndex ] = (int)cacheBlockIndex;
+  
+  ++m_pendingReadsNumber;
+  ++m_prefetchesCount;
+  
+  IOTask task;
+  task.m_task = IOTask::ReadTaskT;
+  task.m_blockIndex = blockIndex;
+  task.m_cacheBlockIndex = cacheBlockIndex;
+  task.m_dataPtr = cacheBlock.m_dataPtr;
+  
+  {
+    boost::lock_guard<boost::mutex> lock( m_tasksMutex );
+    
+    m_tasks.push_back( task );
+  }
+  
+  m_taskAvailableCondVar.notify_one();
+  
+  return true;
+}
+
+void te::mem::CachedBandBlocksManager::rasterIO( const bool read, 
+  const unsigned int blockIndex, unsigned char* dataPtr )
+{
+  const unsigned int x = blockIndex % m_globalBlocksNumberX;
+  const unsigned int y = ( blockIndex / m_globalBlocksNumberX ) % m_globalBlocksNumberY;
+  const unsigned int band = blockIndex / ( m_globalBlocksNumberX * m_globalBlocksNumberY );
+  
+  boost::lock_guard<boost::mutex> lock( m_rasterMutex );
+  
+  if( read )
+  {
+    m_rasterPtr->getBand( band )->read( (int)x, (int)y, dataPtr );
+  }
+  else
+  {
+    m_rasterPtr->getBand( band )->write( (int)x, (int)y, dataPtr );
+  }
+}
+
+void te::mem::CachedBandBlocksManager::threadEntry(CachedBandBlocksManager* managerPtr)
+{
+  assert( managerPtr );
+  assert( managerPtr->m_rasterPtr );
+  
+  IOTask task;
+  
+  while( true )
+  {
+    // wait for a task
+    
+    {
+      boost::unique_lock<boost::mutex> lock( managerPtr->m_tasksMutex );
       
-      // notifying the task finishment
+      while( managerPtr->m_tasks.empty() && ( ! managerPtr->m_stopThreads ) )
+      {
+        managerPtr->m_taskAvailableCondVar.wait( lock );
+      }
       
+      if( managerPtr->m_tasks.empty() )
       {
-        boost::lock_guard<boost::mutex> lock( paramsPtr->m_taskFinishedMutex );
-        
-        paramsPtr->m_taskFinished = true;
-        paramsPtr->m_task = ThreadParameters::InvalidTaskT;
-        
-        paramsPtr->m_taskFinishedCondVar.notify_one();
+        return;
       }
       
-      // defining if read-ahed must be done
+      task = managerPtr->m_tasks.front();
+      managerPtr->m_tasks.pop_front();
       
-      if( paramsPtr->m_dataPrefetchThreshold )
+      if( task.m_task == IOTask::WriteTaskT )
       {
-        currentReadDirectionVectorX = ( ((int)paramsPtr->m_blockX) - lastReadBlockX );
-        currentReadDirectionVectorY = ( ((int)paramsPtr->m_blockY) - lastReadBlockY );
-        currentReadDirectionVectorB = ( ((int)paramsPtr->m_blockB) - lastReadBlockB );
-        
-        doReadAhead = false;
-        
-        if( ( std::abs( currentReadDirectionVectorX ) < 2 ) && 
-          ( std::abs( currentReadDirectionVectorY ) < 2 )
-          && ( std::abs( currentReadDirectionVectorB ) < 2 ) )
-        {
-          globalReadAheadDirectionVectorX += currentReadDirectionVectorX;
-          globalReadAheadDirectionVectorY += currentReadDirectionVectorY;
-          globalReadAheadDirectionVectorB += currentReadDirectionVectorB;
-          
-          if( ((unsigned int)std::abs( globalReadAheadDirectionVectorB ))  > 
-            paramsPtr->m_dataPrefetchThreshold )
-          {
-            if( globalReadAheadDirectionVectorB > 0 )
-            {
-              nextReadAheadBlkB = ((int)paramsPtr->m_blockB) + 1;
-              --globalReadAheadDirectionVectorB;
-            }
-            else
-            {
-              nextReadAheadBlkB = ((int)paramsPtr->m_blockB) - 1;
-              ++globalReadAheadDirectionVectorB;
-            }
-              
-            if( ( nextReadAheadBlkB >= 0 ) &&
-              ( nextReadAheadBlkB < (int)paramsPtr->m_rasterPtr->getNumberOfBands() ) )
-              doReadAhead = true;
-            else
-              nextReadAheadBlkB = ((int)paramsPtr->m_blockB);
-          }           
-          
-          if( ((unsigned int)std::abs( globalReadAheadDirectionVectorX ))  > 
-            paramsPtr->m_dataPrefetchThreshold )
-          {
-            if( globalReadAheadDirectionVectorX > 0 )
-            {
-              nextReadAheadBlkX = ((int)paramsPtr->m_blockX) + 1;
-              --globalReadAheadDirectionVectorX;
-            }
-            else
-            {
-              nextReadAheadBlkX = ((int)paramsPtr->m_blockX) - 1;
-              ++globalReadAheadDirectionVectorX;
-            }
-              
-            if( ( nextReadAheadBlkX >= 0 ) &&
-              ( nextReadAheadBlkX < 
-              paramsPtr->m_rasterPtr->getBand( nextReadAheadBlkB )->getProperty()->m_nblocksx ) )
-              doReadAhead = true;
-            else
-              nextReadAheadBlkX = ((int)paramsPtr->m_blockX);
-          }
-                    
-          if( ((unsigned int)std::abs( globalReadAheadDirectionVectorY ))  > 
-            paramsPtr->m_dataPrefetchThreshold )
-          {
-            if( globalReadAheadDirectionVectorY > 0 )
-            {
-              nextReadAheadBlkY = ((int)paramsPtr->m_blockY) + 1;
-              --globalReadAheadDirectionVectorY;
-            }
-            else
-            {
-              nextReadAheadBlkY = ((int)paramsPtr->m_blockY) - 1;
-              ++globalReadAheadDirectionVectorY;
-            }
-              
-            if( ( nextReadAheadBlkY >= 0 ) &&
-              ( nextReadAheadBlkY < 
-              paramsPtr->m_rasterPtr->getBand( nextReadAheadBlkB )->getProperty()->m_nblocksy ) )
-              doReadAhead = true;
-            else
-              nextReadAheadBlkY = ((int)paramsPtr->m_blockY);
-          }
-        }
-        else
-        {
-          globalReadAheadDirectionVectorX = 0;
-          globalReadAheadDirectionVectorY = 0;
-          globalReadAheadDirectionVectorB = 0;
-        }
-    
-        if( doReadAhead )
-        {
-//          std::cout << std::endl << "Reading-ahead a new block" << std::endl;
-
-          assert( nextReadAheadBlkB < (int)paramsPtr->m_rasterPtr->getNumberOfBands() );
-          assert( nextReadAheadBlkX < 
-            paramsPtr->m_rasterPtr->getBand( nextReadAheadBlkB )->getProperty()->m_nblocksx );
-          assert( nextReadAheadBlkY < 
-            paramsPtr->m_rasterPtr->getBand( nextReadAheadBlkB )->getProperty()->m_nblocksy );
-          
-          paramsPtr->m_rasterPtr->getBand( nextReadAheadBlkB )->read( nextReadAheadBlkX, 
-            nextReadAheadBlkY, internalExchangeBlockPtr );      
-          
-          globalReadAheadBlockX = nextReadAheadBlkX;
-          globalReadAheadBlockY = nextReadAheadBlkY;
-          globalReadAheadBlockB = nextReadAheadBlkB;
-          globalReadAheadBlockReady = true;
-          
-//          std::cout << std::endl << "Read-ahead block reading completed." << std::endl;
-        }
+        managerPtr->m_blocksWriteStatus[ task.m_blockIndex ] = ActiveWriteS;
       }
-      
-      lastReadBlockX = (int)paramsPtr->m_blockX;
-      lastReadBlockY = (int)paramsPtr->m_blockY;
-      lastReadBlockB = (int)paramsPtr->m_blockB;         
     }
-    else if( paramsPtr->m_task == ThreadParameters::WriteTaskT )
+    
+    managerPtr->rasterIO( task.m_task == IOTask::ReadTaskT, task.m_blockIndex,
+      task.m_dataPtr );
+    
+    // notifying the task finishment
+    
     {
-//      std::cout << std::endl << "Starting a write task" << std::endl;
-      
-      assert( paramsPtr->m_blockPtr );
-      assert( paramsPtr->m_exchangeBlockPtr == 0 );
-      
-      paramsPtr->m_rasterPtr->getBand( paramsPtr->m_blockB )->write( paramsPtr->m_blockX, 
-        paramsPtr->m_blockY, paramsPtr->m_blockPtr );
-        
-      // notifying the task finishment
+      boost::lock_guard<boost::mutex> lock( managerPtr->m_tasksMutex );
       
-      paramsPtr->m_taskFinished = true;
-      paramsPtr->m_task = ThreadParameters::InvalidTaskT;
-      paramsPtr->m_taskFinishedCondVar.notify_one();          
-    }
-    else if( paramsPtr->m_task == ThreadParameters::SuicideTastT )
-    {
-//      std::cout << std::endl << "Thread ending" << std::endl;
-      return;
+      if( task.m_task == IOTask::ReadTaskT )
+      {
+        managerPtr->m_cacheBlocks[ task.m_cacheBlockIndex ].m_loaded = true;
+      }
+      else
+      {
+        managerPtr->m_blocksWriteStatus[ task.m_blockIndex ] = NoWriteS;
+        managerPtr->m_freeWriteBlocks.push_back( task.m_dataPtr );
+      }
     }
     
-//    std::cout << std::endl << "Task ended" << std::endl;
+    managerPtr->m_taskFinishedCondVar.notify_all();
   }
 }
-        
-
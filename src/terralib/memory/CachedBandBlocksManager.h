@@ -31,13 +31,12 @@
 #include "Config.h"
 
 // STL
-#include <memory>
+#include <deque>
 #include <vector>
 
 // Boost
 #include <boost/noncopyable.hpp>
 #include <boost/thread.hpp>
-#include <boost/scoped_array.hpp>
 
 namespace te
 {
@@ -47,6 +46,20 @@ namespace te
       \class CachedBandBlocksManager
 
       \brief RAM cached and tiled raster band blocks manager.
+
+      \details The cache blocks are replaced following the CLOCK (second chance)
+      policy. When the read-ahead is enabled a pool of I/O threads reads the
+      blocks that will probably be required next (the next block over the
+      current raster line of blocks, the next line of blocks, the next block
+      over the Y axis or the next band block, following the detected access 
+      pattern) and writes back the changed blocks removed from the cache without 
+      blocking the caller.
+
+      \note The access to the external raster is serialized since the raster
+      drivers are not thread-safe.
+
+      \note When the I/O threads are enabled up to ioThreadsNumber + 1 extra 
+      blocks may be allocated for the pending write-back requests.
     */
     class TEMEMORYEXPORT CachedBandBlocksManager : public boost::noncopyable
     {
@@ -65,11 +78,14 @@ namespace te
 
           \param dataPrefetchThreshold The read-ahead data prefetch threshold (0-will disable prefetch, 1-data always prefetched, higher values will do prefetch when necessary).
 
+          \param ioThreadsNumber The number of I/O threads used for read-ahead and write-back when the prefetch is enabled.
+
           \return true if OK, false on errors.
         */
         bool initialize( const te::rst::Raster& externalRaster,
                           const unsigned char maxMemPercentUsed,
-                          const unsigned int dataPrefetchThreshold );
+                          const unsigned int dataPrefetchThreshold,
+                          const unsigned int ioThreadsNumber = 1 );
 
         /*!
           \brief Initialize this instance to an initial state.
@@ -80,11 +96,14 @@ namespace te
 
           \param dataPrefetchThreshold The read-ahead data prefetch threshold (0-will disable prefetch, 1-data always prefetched, higher values will do prefetch when necessary).
 
+          \param ioThreadsNumber The number of I/O threads used for read-ahead and write-back when the prefetch is enabled.
+
           \return true if OK, false on errors.
         */
         bool initialize( const unsigned int maxNumberOfCacheBlocks, 
                           const te::rst::Raster& externalRaster, 
-                          const unsigned int dataPrefetchThreshold );
+                          const unsigned int dataPrefetchThreshold,
+                          const unsigned int ioThreadsNumber = 1 );
 
         /*!
           \brief Returns true if this instance is initialized.
@@ -107,11 +126,14 @@ namespace te
           \param band The band index.
           \param x    The block-id in x (or x-offset).
           \param y    The block-id in y (or y-offset).
+          \param forWriting If false, the block data will not be changed and it will not be written back when removed from the cache.
 
           \return Pointer to the required data block.
-        */
-        void* getBlockPointer(unsigned int band, unsigned int x, unsigned int y );
 
+          \note This method is not thread-safe.
+        */
+        void* getBlockPointer(unsigned int band, unsigned int x, unsigned int y,
+          const bool forWriting = true );
 
         /*! \brief Returns the associated raster. */
         te::rst::Raster* getRaster() const
@@ -131,125 +153,285 @@ namespace te
           return m_dataPrefetchThreshold;
         };
 
+        /*! \brief The number of I/O threads. */
+        unsigned int getIOThreadsNumber() const
+        {
+          return m_ioThreadsNumber;
+        };
+
+        /*! \brief The number of block requests served from the cache. */
+        unsigned long int getHitsCount() const
+        {
+          return m_hitsCount;
+        };
+
+        /*! \brief The number of block requests that required a read from the external raster. */
+        unsigned long int getMissesCount() const
+        {
+          return m_missesCount;
+        };
+
+        /*! \brief The number of blocks removed from the cache. */
+        unsigned long int getEvictionsCount() const
+        {
+          return m_evictionsCount;
+        };
+
+        /*! \brief The number of blocks written back to the external raster. */
+        unsigned long int getWriteBacksCount() const
+        {
+          return m_writeBacksCount;
+        };
+
+        /*! \brief The number of read-ahead requests. */
+        unsigned long int getPrefetchesCount() const
+        {
+          return m_prefetchesCount;
+        };
+
+        /*! \brief The number of read-ahead blocks that were requested before being removed from the cache. */
+        unsigned long int getPrefetchHitsCount() const
+        {
+          return m_prefetchHitsCount;
+        };
+
+        /*! \brief Reset all the cache counters. */
+        void resetCounters();
+
       protected :
 
         /*!
-          \class BlockIndex
+          \class CacheBlock
 
-          \brief Internal blocks indexes.
+          \brief Internal cache block.
         */
-        class BlockIndex
+        class CacheBlock
         {
           public :
 
-            unsigned int m_b; //!< Block band index
-            unsigned int m_y; //!< Block index over the Y axis.
-            unsigned int m_x; //!< Block index over the X axis.
-
-            BlockIndex()
-              : m_b( 0 ), m_y( 0 ), m_x( 0 )
+            unsigned char* m_dataPtr; //!< Block data.
+            unsigned int m_blockIndex; //!< The linear index of the cached raster block (NoBlockIndex if the cache block is free).
+            bool m_referenced; //!< The CLOCK reference bit.
+            bool m_dirty; //!< true if the block was requested for writing.
+            bool m_prefetched; //!< true if the block was read ahead and not requested yet.
+            bool m_pending; //!< true if the block read-ahead was not collected yet.
+            bool m_loaded; //!< true when the block read-ahead was performed (guarded by m_tasksMutex).
+
+            CacheBlock()
+              : m_dataPtr( 0 ), m_blockIndex( 0 ), m_referenced( false ), 
+                m_dirty( false ), m_prefetched( false ), m_pending( false ),
+                m_loaded( false )
             {
             }
 
-            ~BlockIndex()
+            ~CacheBlock()
             {
             }
         };
 
         /*!
-          \class ThreadParameters
+          \class IOTask
 
-          \brief Internal read/write thread execution parameters.
+          \brief Internal I/O thread task.
         */
-        class ThreadParameters
+        class IOTask
         {
           public :
             
             enum TaskType
             {
               InvalidTaskT = 0,
-              ReadTaskT = 1,      //!< m_exchangeBlockPtr must point to a valid exchange block (it will be keept inside the thread for further use), m_blockPtr must be zero and will be updated to point to the read block.
-              WriteTaskT = 2,     //!< m_blockPtr must point to the block to be written, m_exchangeBlockPtr must be zero.
-              SuicideTastT = 3    //!< The thread will finish the main loop and exit.
+              ReadTaskT = 1,      //!< Read the raster block into the data of the cache block m_cacheBlockIndex.
+              WriteTaskT = 2      //!< Write m_dataPtr to the raster block, m_dataPtr will be released to the free blocks list.
             };
 
-            te::rst::Raster* m_rasterPtr; //!< External raster pointer.
+            TaskType m_task; //!< The required task.
 
-            unsigned int m_dataPrefetchThreshold; //!< The user defined read-ahead threshold.
+            unsigned int m_blockIndex; //!< The raster block linear index.
 
-            bool m_taskFinished; //!< true when the thread has finished the required task.
+            unsigned int m_cacheBlockIndex; //!< The cache block index (read tasks).
 
-            TaskType m_task; //!< The required task to be performed (read/write/exit).
+            unsigned char* m_dataPtr; //!< The block data.
 
-            unsigned char* m_blockPtr; //!< Input block pointer.
+            IOTask()
+              : m_task( InvalidTaskT ), m_blockIndex( 0 ), 
+                m_cacheBlockIndex( 0 ), m_dataPtr( 0 )
+            {
+            };
 
-            unsigned char* m_exchangeBlockPtr; //!< Exchange block pointer.
+            ~IOTask() {};
+        };
 
-            unsigned int m_blockB; //!< Raster block band index.
+        /*! \brief Raster block write-back status. */
+        enum WriteStatus
+        {
+          NoWriteS = 0,     //!< No pending write-back.
+          QueuedWriteS = 1, //!< A write-back task is waiting for an I/O thread.
+          ActiveWriteS = 2  //!< The block is being written by an I/O thread.
+        };
 
-            unsigned int m_blockX; //!< Raster block X index
+        static const unsigned int NoBlockIndex = (unsigned int)( -1 ); //!< Invalid raster block linear index.
 
-            unsigned int m_blockY; //!< Raster block Y index
+        te::rst::Raster* m_rasterPtr; //!< External raster pointer.
 
-            boost::mutex m_doTaskMutex; //!< Used when wakenning the thread to perform some task.
+        bool m_rasterWriteAccess; //!< true if the external raster can be written.
 
-            boost::mutex m_taskFinishedMutex; //!< used by the thread to inform a task finishment.
+        unsigned int m_dataPrefetchThreshold; //!< The read-ahead data prefetch threshold (0-will disable prefetch, 1-data always prefetched, higher values will do prefetch when necessary).
 
-            boost::condition_variable m_doTaskCondVar; //!< Used by the thread when awakenning to perform some task.
+        unsigned int m_ioThreadsNumber; //!< The number of I/O threads (zero if the read-ahead is disabled).
 
-            boost::condition_variable m_taskFinishedCondVar; //!< Used to wait for the required task finishment.
+        unsigned int m_globalBlocksNumberX; //!< The maximum number of blocks (X axis) for all bands.
 
-            boost::scoped_array< unsigned char > m_threadDataBlockHandler; //!< A extra block used in exchange when a read-ahead task is performed.
+        unsigned int m_globalBlocksNumberY; //!< The maximum number of blocks (Y axis) for all bands.
 
-            ThreadParameters()
-              : m_rasterPtr( 0 ),
-                m_dataPrefetchThreshold( 0 ),
-                m_taskFinished( false ),
-                m_task( InvalidTaskT ), 
-                m_blockPtr( 0 ),
-                m_exchangeBlockPtr( 0 ),
-                m_blockB( 0 ),
-                m_blockX( 0 ),
-                m_blockY( 0 )
-            {
-            };
+        unsigned int m_globalBlockSizeBytes; //!< The maximum block size for all bands.
+
+        unsigned int m_maxNumberOfCacheBlocks; //!< The maximum number of cache blocks.
+
+        unsigned int m_usedCacheBlocksNumber; //!< The number of cache blocks with allocated data.
+
+        unsigned int m_clockHandIndex; //!< The CLOCK hand position over m_cacheBlocks.
+
+        unsigned int m_maxPendingReadsNumber; //!< The maximum number of not collected read-ahead blocks.
 
-            ~ThreadParameters() {};
+        unsigned int m_pendingReadsNumber; //!< The number of not collected read-ahead blocks.
+
+        unsigned int m_maxWriteBlocksNumber; //!< The maximum number of extra blocks used by write-back tasks.
+
+        unsigned int m_writeBlocksNumber; //!< The number of allocated extra blocks used by write-back tasks (guarded by m_tasksMutex).
+
+        bool m_stopThreads; //!< true when the I/O threads must finish the pending tasks and exit (guarded by m_tasksMutex).
+
+        std::vector< unsigned int > m_bandsBlocksNumberX; //!< The number of blocks (X axis) of each band.
+
+        std::vector< unsigned int > m_bandsBlocksNumberY; //!< The number of blocks (Y axis) of each band.
+
+        std::vector< int > m_blocksCacheIndexes; //!< The cache block index of each raster block (-1 if not cached) indexed by the block linear index.
+
+        std::vector< unsigned char > m_blocksWriteStatus; //!< The write-back status of each raster block indexed by the block linear index (guarded by m_tasksMutex).
+
+        std::vector< CacheBlock > m_cacheBlocks; //!< The cache blocks.
+
+        std::vector< unsigned char* > m_freeWriteBlocks; //!< The extra blocks not used by write-back tasks (guarded by m_tasksMutex).
+
+        std::deque< IOTask > m_tasks; //!< The I/O tasks queue (guarded by m_tasksMutex).
+
+        boost::mutex m_tasksMutex; //!< Guards the I/O tasks queue and the data shared with the I/O threads.
+
+        boost::mutex m_rasterMutex; //!< Serializes the access to the external raster.
+
+        boost::condition_variable m_taskAvailableCondVar; //!< Used to awake the I/O threads.
+
+        boost::condition_variable m_taskFinishedCondVar; //!< Used to wait for tasks finishment.
+
+        boost::thread_group m_threads; //!< The I/O threads.
+
+// read-ahead access pattern
+        unsigned int m_lastBlockIndex; //!< The last required raster block linear index.
+        unsigned int m_lastBlockB; //!< The last required block band index.
+        unsigned int m_lastBlockX; //!< The last required block X index.
+        unsigned int m_lastBlockY; //!< The last required block Y index.
+        unsigned int m_lineSequenceLength; //!< The number of consecutive requests following the blocks lines.
+        unsigned int m_columnSequenceLength; //!< The number of consecutive requests following the blocks columns.
+        unsigned int m_bandSequenceLength; //!< The number of consecutive requests following the bands.
+
+// counters
+        unsigned long int m_hitsCount;
+        unsigned long int m_missesCount;
+        unsigned long int m_evictionsCount;
+        unsigned long int m_writeBacksCount;
+        unsigned long int m_prefetchesCount;
+        unsigned long int m_prefetchHitsCount;
+
+        /*! \brief Returns the linear index of a raster block. */
+        unsigned int getBlockIndex( const unsigned int band, const unsigned int x,
+          const unsigned int y ) const
+        {
+          return ( ( band * m_globalBlocksNumberY ) + y ) * m_globalBlocksNumberX + x;
         };
 
-        te::rst::Raster* m_rasterPtr; //!< External raster pointer.
+        /*!
+          \brief Returns a cache block ready to receive a new raster block, removing its current block from the cache if necessary.
 
-        unsigned int m_dataPrefetchThreshold; //!< The read-ahead data prefetch threshold (0-will disable prefetch, 1-data always prefetched, higher values will do prefetch when necessary).
+          \return The cache block index.
+        */
+        unsigned int acquireCacheBlock();
 
-        unsigned int m_globalBlocksNumberX; //!< The maximum number of blocks (X axis) for all bands.
+        /*!
+          \brief Remove the block from the cache, writing it back if necessary.
 
-        unsigned int m_globalBlocksNumberY; //!< The maximum number of blocks (Y axis) for all bands.
+          \param cacheBlockIndex The cache block index.
+        */
+        void evictCacheBlock( const unsigned int cacheBlockIndex );
 
-        unsigned int m_globalBlockSizeBytes; //!< The maximum block size for all bands.
+        /*!
+          \brief Read a raster block into a cache block.
 
-        unsigned int m_maxNumberOfCacheBlocks; //!< The maximum number of cache blocks.
+          \param cacheBlockIndex The cache block index.
+          \param blockIndex The raster block linear index.
+        */
+        void loadCacheBlock( const unsigned int cacheBlockIndex, 
+          const unsigned int blockIndex );
 
-        unsigned int m_blocksFifoNextSwapBlockIndex; //!< The next block swapp index over m_blocksFifo.
+        /*!
+          \brief Collect a read-ahead block.
 
-// variables used by internal methods
-        unsigned char* m_getBlockPointer_BlkPtr;
+          \param cacheBlockIndex The cache block index.
+          \param wait If true, wait for the read-ahead to finish.
 
-        std::vector< std::vector< std::vector< unsigned char* > > > m_blocksPointers; //!< 3D Matrix of block pointers indexed as [band][blockYIndex][blockXIndex].
+          \return true if the block was collected.
+        */
+        bool collectPrefetchedBlock( const unsigned int cacheBlockIndex, 
+          const bool wait );
 
-        std::vector< unsigned char* > m_blocksHandler; //!< Cache blocks handler.
+        /*!
+          \brief Update the access pattern with a new required block.
 
-        std::vector< BlockIndex > m_blocksFifo; //!< blocks swap FIFO.
+          \param band The required block band index.
+          \param x    The required block X index.
+          \param y    The required block Y index.
+        */
+        void updateAccessPattern( const unsigned int band, const unsigned int x,
+          const unsigned int y );
 
-        ThreadParameters m_threadParams; //!< The internal thread execution parameters.
+        /*!
+          \brief Request the read-ahead of the blocks that will probably be required next.
+
+          \param band The required block band index.
+          \param x    The required block X index.
+          \param y    The required block Y index.
+        */
+        void readAhead( const unsigned int band, const unsigned int x,
+          const unsigned int y );
+
+        /*!
+          \brief Request the read-ahead of a raster block.
+
+          \param band The block band index.
+          \param x    The block X index.
+          \param y    The block Y index.
 
-        std::auto_ptr< boost::thread > m_threadHandler; //!< The internal thread handler.
+          \return false if no more read-ahead requests can be done now.
+        */
+        bool prefetchBlock( const unsigned int band, const unsigned int x,
+          const unsigned int y );
+
+        /*!
+          \brief Read or write a raster block.
+
+          \param read true for reading, false for writing.
+          \param blockIndex The raster block linear index.
+          \param dataPtr The block data.
+        */
+        void rasterIO( const bool read, const unsigned int blockIndex, 
+          unsigned char* dataPtr );
 
         /*! 
-          \brief Thread entry.
+          \brief I/O thread entry.
 
-          \param paramsPtr A pointer to the thread parameters.
+          \param managerPtr A pointer to the blocks manager.
         */
-        static void threadEntry(ThreadParameters* paramsPtr);
+        static void threadEntry(CachedBandBlocksManager* managerPtr);
 
       private :
 
@@ -41,10 +41,11 @@ te::mem::CachedRaster::CachedRaster( te::rst::Grid* grid, te::common::AccessPoli
 
 te::mem::CachedRaster::CachedRaster( const te::rst::Raster& rhs, 
   const unsigned char maxMemPercentUsed, 
-  const unsigned int dataPrefetchThreshold )
+  const unsigned int dataPrefetchThreshold, const unsigned int ioThreadsNumber )
 : te::rst::Raster( new te::rst::Grid( *rhs.getGrid() ), rhs.getAccessPolicy() )
 {
-  if( ! m_blocksManager.initialize( rhs, maxMemPercentUsed, dataPrefetchThreshold) )
+  if( ! m_blocksManager.initialize( rhs, maxMemPercentUsed, dataPrefetchThreshold,
+    ioThreadsNumber ) )
     throw Exception(TE_TR("Cannot initialize the blocks menager") );
   
   for( unsigned int bandsIdx = 0 ; bandsIdx < rhs.getNumberOfBands() ; 
@@ -54,11 +55,11 @@ te::mem::CachedRaster::CachedRaster( const te::rst::Raster& rhs,
 
 te::mem::CachedRaster::CachedRaster( const unsigned int maxNumberOfCacheBlocks,
   const te::rst::Raster& rhs, 
-  const unsigned int dataPrefetchThreshold )
+  const unsigned int dataPrefetchThreshold, const unsigned int ioThreadsNumber )
 : te::rst::Raster( new te::rst::Grid( *rhs.getGrid() ), rhs.getAccessPolicy() )
 {
   if( ! m_blocksManager.initialize( maxNumberOfCacheBlocks, rhs, 
-    dataPrefetchThreshold) )
+    dataPrefetchThreshold, ioThreadsNumber ) )
     throw Exception(TE_TR("Cannot initialize the blocks menager") );
   
   for( unsigned int bandsIdx = 0 ; bandsIdx < rhs.getNumberOfBands() ; 
@@ -80,7 +81,8 @@ te::dt::AbstractData* te::mem::CachedRaster::clone() const
 {
   assert( m_blocksManager.isInitialized() );
   return new CachedRaster( m_blocksManager.getMaxNumberOfCacheBlocks(),
-    *m_blocksManager.getRaster(), m_blocksManager.getDataPrefetchThreshold() );
+    *m_blocksManager.getRaster(), m_blocksManager.getDataPrefetchThreshold(),
+    m_blocksManager.getIOThreadsNumber() );
 }
 
 void te::mem::CachedRaster::free()
@@ -61,9 +61,12 @@ namespace te
           \param maxMemPercentUsed The maximum free memory percentual to use valid range: [1:100].
 
           \param dataPrefetchThreshold The read-ahead data prefetch threshold (0-will disable prefetch, 1-data always prefetched, higher values will do prefetch when necessary).
+
+          \param ioThreadsNumber The number of I/O threads used for read-ahead and write-back when the prefetch is enabled.
         */
         CachedRaster( const te::rst::Raster& rhs, const unsigned char maxMemPercentUsed, 
-                      const unsigned int dataPrefetchThreshold );
+                      const unsigned int dataPrefetchThreshold,
+                      const unsigned int ioThreadsNumber = 1 );
 
         /*!
           \brief Constructor.
@@ -73,9 +76,12 @@ namespace te
           \param maxNumberOfCacheBlocks The maximum number of cache blocks.
 
           \param dataPrefetchThreshold The read-ahead data prefetch threshold (0-will disable prefetch, 1-data always prefetched, higher values will do prefetch when necessary).
+
+          \param ioThreadsNumber The number of I/O threads used for read-ahead and write-back when the prefetch is enabled.
         */
         CachedRaster( const unsigned int maxNumberOfCacheBlocks, const te::rst::Raster& rhs, 
-                      const unsigned int dataPrefetchThreshold );
+                      const unsigned int dataPrefetchThreshold,
+                      const unsigned int ioThreadsNumber = 1 );
 
         ~CachedRaster();
 
@@ -130,6 +136,12 @@ namespace te
         };
         
         bool removeMultiResolution() { return false; }; 
+
+        /*! \brief Returns the internal blocks manager (cache counters and settings). */
+        const CachedBandBlocksManager& getBlocksManager() const
+        {
+          return m_blocksManager;
+        };
         
         unsigned int getMultiResLevelsCount() const
         {
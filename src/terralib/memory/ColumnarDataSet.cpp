@@ -0,0 +1,974 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+  \file terralib/memory/ColumnarDataSet.cpp
+
+  \brief A random-access dataset that keeps its values in typed column buffers.
+*/
+
+// TerraLib
+#include "../common/Globals.h"
+#include "../core/translator/Translator.h"
+#include "../dataaccess/utils/Utils.h"
+#include "../datatype/AbstractData.h"
+#include "../datatype/Array.h"
+#include "../datatype/ByteArray.h"
+#include "../datatype/DateTime.h"
+#include "../datatype/SimpleData.h"
+#include "../geometry/Envelope.h"
+#include "../geometry/Geometry.h"
+#include "../geometry/WKBReader.h"
+#include "../geometry/WKBView.h"
+#include "../geometry/WKBWriter.h"
+#include "../raster/Raster.h"
+#include "ColumnarDataSet.h"
+#include "Exception.h"
+
+// STL
+#include <cassert>
+#include <cstring>
+#include <limits>
+
+// Boost
+#include <boost/dynamic_bitset.hpp>
+#include <boost/ptr_container/ptr_vector.hpp>
+
+namespace te
+{
+  namespace mem
+  {
+    /*! \brief How the values of a column are stored. */
+    enum ColumnStorage
+    {
+      FIXED_STORAGE,    //!< Values of fixed size packed in a contiguous array.
+      ARENA_STORAGE,    //!< Values of variable size appended to an arena of bytes.
+      OBJECT_STORAGE    //!< Values kept as te::dt::AbstractData objects.
+    };
+
+    /*! \brief It returns the number of bytes of a value of the given type or 0 for types of variable size. */
+    inline std::size_t GetFixedSize(int type)
+    {
+      switch(type)
+      {
+        case te::dt::CHAR_TYPE:
+        case te::dt::UCHAR_TYPE:
+        case te::dt::BOOLEAN_TYPE:
+          return 1;
+
+        case te::dt::INT16_TYPE:
+        case te::dt::UINT16_TYPE:
+          return 2;
+
+        case te::dt::INT32_TYPE:
+        case te::dt::UINT32_TYPE:
+        case te::dt::FLOAT_TYPE:
+          return 4;
+
+        case te::dt::INT64_TYPE:
+        case te::dt::UINT64_TYPE:
+        case te::dt::DOUBLE_TYPE:
+          return 8;
+
+        default:
+          return 0;
+      }
+    }
+
+    /*! \brief It returns how the values of the given type are stored. */
+    inline ColumnStorage GetColumnStorage(int type)
+    {
+      if(GetFixedSize(type) != 0)
+        return FIXED_STORAGE;
+
+      switch(type)
+      {
+        case te::dt::NUMERIC_TYPE:
+        case te::dt::STRING_TYPE:
+        case te::dt::BYTE_ARRAY_TYPE:
+        case te::dt::GEOMETRY_TYPE:
+          return ARENA_STORAGE;
+
+        default:
+          return OBJECT_STORAGE;
+      }
+    }
+
+    /*! \brief It reads a value of type V from the buffer and converts it to T. */
+    template<class T, class V> inline T ReadAs(const char* p)
+    {
+      V v;
+      memcpy(&v, p, sizeof(V));
+      return static_cast<T>(v);
+    }
+
+    /*! \brief It converts the value to type V and writes it in the buffer. */
+    template<class V, class T> inline void WriteAs(char* p, const T& value)
+    {
+      const V v = static_cast<V>(value);
+      memcpy(p, &v, sizeof(V));
+    }
+
+  } // end namespace mem
+}   // end namespace te
+
+struct te::mem::ColumnarDataSet::Column
+{
+  Column(const std::string& name, int type)
+    : m_name(name),
+      m_type(type),
+      m_storage(GetColumnStorage(type)),
+      m_width(GetFixedSize(type))
+  {
+  }
+
+  /*! \brief It appends a null value. */
+  void push_back()
+  {
+    m_valid.push_back(false);
+
+    switch(m_storage)
+    {
+      case FIXED_STORAGE:
+        m_values.resize(m_values.size() + m_width, 0);
+      break;
+
+      case ARENA_STORAGE:
+        m_offsets.push_back(0);
+        m_sizes.push_back(0);
+
+        if(m_type == te::dt::GEOMETRY_TYPE)
+          m_srids.push_back(0);
+      break;
+
+      default:
+        m_objects.push_back(0);
+    }
+  }
+
+  void reserve(std::size_t n)
+  {
+    m_valid.reserve(n);
+
+    if(m_storage == FIXED_STORAGE)
+    {
+      m_values.reserve(n * m_width);
+    }
+    else if(m_storage == ARENA_STORAGE)
+    {
+      m_offsets.reserve(n);
+      m_sizes.reserve(n);
+
+      if(m_type == te::dt::GEOMETRY_TYPE)
+        m_srids.reserve(n);
+    }
+    else
+    {
+      m_objects.reserve(n);
+    }
+  }
+
+  void clear()
+  {
+    m_valid.clear();
+    m_values.clear();
+    m_offsets.clear();
+    m_sizes.clear();
+    m_srids.clear();
+    m_objects.clear();
+  }
+
+  /*! \brief It reads the value in the given row converting it to T. */
+  template<class T> T get(std::size_t row) const
+  {
+    if(m_storage != FIXED_STORAGE)
+      throw Exception(TE_TR("The property doesn't have a numeric type!"));
+
+    const char* p = &m_values[row * m_width];
+
+    switch(m_type)
+    {
+      case te::dt::CHAR_TYPE:
+        return ReadAs<T, char>(p);
+
+      case te::dt::UCHAR_TYPE:
+        return ReadAs<T, unsigned char>(p);
+
+      case te::dt::BOOLEAN_TYPE:
+        return ReadAs<T, bool>(p);
+
+      case te::dt::INT16_TYPE:
+        return ReadAs<T, boost::int16_t>(p);
+
+      case te::dt::UINT16_TYPE:
+        return ReadAs<T, boost::uint16_t>(p);
+
+      case te::dt::INT32_TYPE:
+        return ReadAs<T, boost::int32_t>(p);
+
+      case te::dt::UINT32_TYPE:
+        return ReadAs<T, boost::uint32_t>(p);
+
+      case te::dt::FLOAT_TYPE:
+        return ReadAs<T, float>(p);
+
+      case te::dt::INT64_TYPE:
+        return ReadAs<T, boost::int64_t>(p);
+
+      case te::dt::UINT64_TYPE:
+        return ReadAs<T, boost::uint64_t>(p);
+
+      default:
+        return ReadAs<T, double>(p);
+    }
+  }
+
+  /*! \brief It writes the value in the given row converting it to the column type. */
+  template<class T> void set(std::size_t row, const T& value)
+  {
+    if(m_storage != FIXED_STORAGE)
+      throw Exception(TE_TR("The property doesn't have a numeric type!"));
+
+    char* p = &m_values[row * m_width];
+
+    switch(m_type)
+    {
+      case te::dt::CHAR_TYPE:
+        WriteAs<char>(p, value);
+      break;
+
+      case te::dt::UCHAR_TYPE:
+        WriteAs<unsigned char>(p, value);
+      break;
+
+      case te::dt::BOOLEAN_TYPE:
+        WriteAs<bool>(p, value);
+      break;
+
+      case te::dt::INT16_TYPE:
+        WriteAs<boost::int16_t>(p, value);
+      break;
+
+      case te::dt::UINT16_TYPE:
+        WriteAs<boost::uint16_t>(p, value);
+      break;
+
+      case te::dt::INT32_TYPE:
+        WriteAs<boost::int32_t>(p, value);
+      break;
+
+      case te::dt::UINT32_TYPE:
+        WriteAs<boost::uint32_t>(p, value);
+      break;
+
+      case te::dt::FLOAT_TYPE:
+        WriteAs<float>(p, value);
+      break;
+
+      case te::dt::INT64_TYPE:
+        WriteAs<boost::int64_t>(p, value);
+      break;
+
+      case te::dt::UINT64_TYPE:
+        WriteAs<boost::uint64_t>(p, value);
+      break;
+
+      default:
+        WriteAs<double>(p, value);
+    }
+
+    m_valid[row] = true;
+  }
+
+  /*! \brief It returns a pointer to the bytes of the value in the given row. */
+  const char* getBytes(std::size_t row, std::size_t& size) const
+  {
+    if(m_storage != ARENA_STORAGE)
+      throw Exception(TE_TR("The property doesn't have a string, byte array or geometry type!"));
+
+    size = m_sizes[row];
+
+    return m_arena.empty() ? 0 : &m_arena[m_offsets[row]];
+  }
+
+  /*! \brief It appends the bytes to the arena and makes them the value of the given row. */
+  void setBytes(std::size_t row, const char* data, std::size_t size)
+  {
+    if(m_storage != ARENA_STORAGE)
+      throw Exception(TE_TR("The property doesn't have a string, byte array or geometry type!"));
+
+    m_offsets[row] = m_arena.size();
+    m_sizes[row] = size;
+
+    m_arena.insert(m_arena.end(), data, data + size);
+
+    m_valid[row] = true;
+  }
+
+  /*! \brief It encodes the geometry as WKB at the end of the arena and makes it the value of the given row. */
+  void setGeometry(std::size_t row, const te::gm::Geometry& g)
+  {
+    if(m_type != te::dt::GEOMETRY_TYPE)
+      throw Exception(TE_TR("The property doesn't have a geometry type!"));
+
+    const std::size_t size = g.getWkbSize();
+
+    m_offsets[row] = m_arena.size();
+    m_sizes[row] = size;
+    m_srids[row] = g.getSRID();
+
+    m_arena.resize(m_arena.size() + size);
+
+    te::gm::WKBWriter::write(&g, &m_arena[m_offsets[row]], te::common::Globals::sm_machineByteOrder);
+
+    m_valid[row] = true;
+  }
+
+  std::string m_name;                                                   //!< The property name.
+  int m_type;                                                           //!< The property data type.
+  ColumnStorage m_storage;                                              //!< How the values are stored.
+  std::size_t m_width;                                                  //!< The size of a value in a fixed storage.
+  boost::dynamic_bitset<> m_valid;                                      //!< The validity bitmap: a bit is off for null values.
+  std::vector<char> m_values;                                           //!< The packed values in a fixed storage.
+  std::vector<char> m_arena;                                            //!< The bytes of the values in an arena storage.
+  std::vector<std::size_t> m_offsets;                                   //!< The offset in the arena of each value.
+  std::vector<std::size_t> m_sizes;                                     //!< The number of bytes of each value in the arena.
+  std::vector<int> m_srids;                                             //!< The SRID of each geometry.
+  boost::ptr_vector<boost::nullable<te::dt::AbstractData> > m_objects;  //!< The values in an object storage.
+};
+
+struct te::mem::ColumnarDataSet::Table
+{
+  Table() : m_size(0) {}
+
+  boost::ptr_vector<Column> m_columns;  //!< The dataset columns.
+  std::size_t m_size;                   //!< The number of items.
+};
+
+te::mem::ColumnarDataSet::ColumnarDataSet(const te::da::DataSetType* const dt)
+  : m_table(new Table),
+    m_i(-1)
+{
+  std::vector<std::string> pnames;
+  std::vector<int> ptypes;
+
+  te::da::GetPropertyInfo(dt, pnames, ptypes);
+
+  for(std::size_t i = 0; i != pnames.size(); ++i)
+  {
+    m_table->m_columns.push_back(new Column(pnames[i], ptypes[i]));
+    m_columns.push_back(i);
+  }
+}
+
+te::mem::ColumnarDataSet::ColumnarDataSet(te::da::DataSet& rhs, std::size_t limit)
+  : m_table(new Table),
+    m_i(-1)
+{
+  std::vector<std::string> pnames;
+  std::vector<int> ptypes;
+
+  te::da::GetPropertyInfo(&rhs, pnames, ptypes);
+
+  for(std::size_t i = 0; i != pnames.size(); ++i)
+  {
+    m_table->m_columns.push_back(new Column(pnames[i], ptypes[i]));
+    m_columns.push_back(i);
+  }
+
+  copy(rhs, limit);
+}
+
+te::mem::ColumnarDataSet::ColumnarDataSet(const ColumnarDataSet& rhs)
+  : te::da::DataSet(),
+    m_table(rhs.m_table),
+    m_columns(rhs.m_columns),
+    m_i(-1)
+{
+}
+
+te::mem::ColumnarDataSet::ColumnarDataSet(const ColumnarDataSet& rhs, const std::vector<std::size_t>& properties)
+  : m_table(rhs.m_table),
+    m_i(-1)
+{
+  for(std::size_t i = 0; i != properties.size(); ++i)
+    m_columns.push_back(rhs.m_columns[properties[i]]);
+}
+
+te::mem::ColumnarDataSet::~ColumnarDataSet()
+{
+}
+
+void te::mem::ColumnarDataSet::copy(te::da::DataSet& src, std::size_t limit)
+{
+  bool unlimited = true;
+
+  if(limit == 0)
+  {
+    limit = std::numeric_limits<std::size_t>::max();
+  }
+  else
+  {
+    reserve(m_table->m_size + limit);
+    unlimited = false;
+  }
+
+  const std::size_t nproperties = m_columns.size();
+
+  std::size_t n = 0;
+
+  while((n < limit) && src.moveNext())
+  {
+    add();
+
+    const std::size_t row = static_cast<std::size_t>(m_i);
+
+    for(std::size_t i = 0; i != nproperties; ++i)
+    {
+      if(src.isNull(i))
+        continue;
+
+      Column& c = getColumn(i);
+
+// typed reads: no te::dt::AbstractData is created for numbers and strings
+      switch(c.m_type)
+      {
+        case te::dt::CHAR_TYPE:
+          c.set(row, src.getChar(i));
+        break;
+
+        case te::dt::UCHAR_TYPE:
+          c.set(row, src.getUChar(i));
+        break;
+
+        case te::dt::BOOLEAN_TYPE:
+          c.set(row, src.getBool(i));
+        break;
+
+        case te::dt::INT16_TYPE:
+        case te::dt::UINT16_TYPE:
+          c.set(row, src.getInt16(i));
+        break;
+
+        case te::dt::INT32_TYPE:
+        case te::dt::UINT32_TYPE:
+          c.set(row, src.getInt32(i));
+        break;
+
+        case te::dt::INT64_TYPE:
+        case te::dt::UINT64_TYPE:
+          c.set(row, src.getInt64(i));
+        break;
+
+        case te::dt::FLOAT_TYPE:
+          c.set(row, src.getFloat(i));
+        break;
+
+        case te::dt::DOUBLE_TYPE:
+          c.set(row, src.getDouble(i));
+        break;
+
+        case te::dt::NUMERIC_TYPE:
+          setNumeric(i, src.getNumeric(i));
+        break;
+
+        case te::dt::STRING_TYPE:
+          setString(i, src.getString(i));
+        break;
+
+        default:
+          setValue(i, src.getValue(i).release());
+      }
+    }
+
+    ++n;
+  }
+
+  if(!unlimited && (n < limit))
+    throw Exception(TE_TR("The source dataset has few items than requested copy limit!"));
+}
+
+void te::mem::ColumnarDataSet::reserve(std::size_t nitems)
+{
+  const std::size_t ncols = m_table->m_columns.size();
+
+  for(std::size_t i = 0; i != ncols; ++i)
+    m_table->m_columns[i].reserve(nitems);
+}
+
+void te::mem::ColumnarDataSet::add()
+{
+  const std::size_t ncols = m_table->m_columns.size();
+
+  for(std::size_t i = 0; i != ncols; ++i)
+    m_table->m_columns[i].push_back();
+
+  m_i = static_cast<int>(m_table->m_size);
+
+  ++(m_table->m_size);
+}
+
+void te::mem::ColumnarDataSet::clear()
+{
+  const std::size_t ncols = m_table->m_columns.size();
+
+  for(std::size_t i = 0; i != ncols; ++i)
+    m_table->m_columns[i].clear();
+
+  m_table->m_size = 0;
+
+  m_i = -1;
+}
+
+te::common::TraverseType te::mem::ColumnarDataSet::getTraverseType() const
+{
+  return te::common::RANDOM;
+}
+
+te::common::AccessPolicy te::mem::ColumnarDataSet::getAccessPolicy() const
+{
+  return te::common::RWAccess;
+}
+
+std::size_t te::mem::ColumnarDataSet::getNumProperties() const
+{
+  return m_columns.size();
+}
+
+int te::mem::ColumnarDataSet::getPropertyDataType(std::size_t i) const
+{
+  return getColumn(i).m_type;
+}
+
+std::string te::mem::ColumnarDataSet::getPropertyName(std::size_t i) const
+{
+  return getColumn(i).m_name;
+}
+
+std::string te::mem::ColumnarDataSet::getDatasetNameOfProperty(std::size_t /*i*/) const
+{
+  throw Exception(TE_TR("Not implemented yet!"));
+}
+
+bool te::mem::ColumnarDataSet::isEmpty() const
+{
+  return m_table->m_size == 0;
+}
+
+bool te::mem::ColumnarDataSet::isConnected() const
+{
+  return false;
+}
+
+std::size_t te::mem::ColumnarDataSet::size() const
+{
+  return m_table->m_size;
+}
+
+std::auto_ptr<te::gm::Envelope> te::mem::ColumnarDataSet::getExtent(std::size_t i)
+{
+  const Column& c = getColumn(i);
+
+  if(c.m_type != te::dt::GEOMETRY_TYPE)
+    throw Exception(TE_TR("The property doesn't have a geometry type!"));
+
+  std::auto_ptr<te::gm::Envelope> mbr(new te::gm::Envelope);
+
+// only the coordinates are decoded
+  te::gm::WKBView view;
+
+  const std::size_t nitems = m_table->m_size;
+
+  for(std::size_t row = 0; row != nitems; ++row)
+  {
+    if(!c.m_valid[row])
+      continue;
+
+    view.read(&c.m_arena[c.m_offsets[row]]);
+
+    if(!view.isEmpty())
+      mbr->Union(view.getMBR());
+  }
+
+  return mbr;
+}
+
+bool te::mem::ColumnarDataSet::moveNext()
+{
+  ++m_i;
+  return m_i < static_cast<int>(m_table->m_size);
+}
+
+bool te::mem::ColumnarDataSet::movePrevious()
+{
+  --m_i;
+  return m_i >= 0;
+}
+
+bool te::mem::ColumnarDataSet::moveBeforeFirst()
+{
+  m_i = -1;
+  return true;
+}
+
+bool te::mem::ColumnarDataSet::moveFirst()
+{
+  m_i = 0;
+  return m_table->m_size != 0;
+}
+
+bool te::mem::ColumnarDataSet::moveLast()
+{
+  m_i = static_cast<int>(m_table->m_size) - 1;
+  return m_i >= 0;
+}
+
+bool te::mem::ColumnarDataSet::move(std::size_t i)
+{
+  m_i = static_cast<int>(i);
+  return i < m_table->m_size;
+}
+
+bool te::mem::ColumnarDataSet::isAtBegin() const
+{
+  return m_i == 0;
+}
+
+bool te::mem::ColumnarDataSet::isBeforeBegin() const
+{
+  return m_i < 0;
+}
+
+bool te::mem::ColumnarDataSet::isAtEnd() const
+{
+  return m_i == (static_cast<int>(m_table->m_size) - 1);
+}
+
+bool te::mem::ColumnarDataSet::isAfterEnd() const
+{
+  return m_i >= static_cast<int>(m_table->m_size);
+}
+
+char te::mem::ColumnarDataSet::getChar(std::size_t i) const
+{
+  return getColumn(i).get<char>(m_i);
+}
+
+unsigned char te::mem::ColumnarDataSet::getUChar(std::size_t i) const
+{
+  return getColumn(i).get<unsigned char>(m_i);
+}
+
+boost::int16_t te::mem::ColumnarDataSet::getInt16(std::size_t i) const
+{
+  return getColumn(i).get<boost::int16_t>(m_i);
+}
+
+boost::int32_t te::mem::ColumnarDataSet::getInt32(std::size_t i) const
+{
+  return getColumn(i).get<boost::int32_t>(m_i);
+}
+
+boost::int64_t te::mem::ColumnarDataSet::getInt64(std::size_t i) const
+{
+  return getColumn(i).get<boost::int64_t>(m_i);
+}
+
+bool te::mem::ColumnarDataSet::getBool(std::size_t i) const
+{
+  return getColumn(i).get<bool>(m_i);
+}
+
+float te::mem::ColumnarDataSet::getFloat(std::size_t i) const
+{
+  return getColumn(i).get<float>(m_i);
+}
+
+double te::mem::ColumnarDataSet::getDouble(std::size_t i) const
+{
+  return getColumn(i).get<double>(m_i);
+}
+
+std::string te::mem::ColumnarDataSet::getNumeric(std::size_t i) const
+{
+  return getString(i);
+}
+
+std::string te::mem::ColumnarDataSet::getString(std::size_t i) const
+{
+  std::size_t size = 0;
+
+  const char* data = getColumn(i).getBytes(m_i, size);
+
+  return size == 0 ? std::string() : std::string(data, size);
+}
+
+std::auto_ptr<te::dt::ByteArray> te::mem::ColumnarDataSet::getByteArray(std::size_t i) const
+{
+  std::size_t size = 0;
+
+  const char* data = getColumn(i).getBytes(m_i, size);
+
+  std::auto_ptr<te::dt::ByteArray> b(new te::dt::ByteArray(size));
+
+  if(size != 0)
+    b->copy(const_cast<char*>(data), size);
+
+  return b;
+}
+
+std::auto_ptr<te::gm::Geometry> te::mem::ColumnarDataSet::getGeometry(std::size_t i) const
+{
+  const Column& c = getColumn(i);
+
+  if((c.m_type != te::dt::GEOMETRY_TYPE) || !c.m_valid[m_i])
+    return std::auto_ptr<te::gm::Geometry>(0);
+
+  std::auto_ptr<te::gm::Geometry> g(te::gm::WKBReader::read(&c.m_arena[c.m_offsets[m_i]]));
+
+  g->setSRID(c.m_srids[m_i]);
+
+  return g;
+}
+
+bool te::mem::ColumnarDataSet::getGeometryView(std::size_t i, te::gm::WKBView& view) const
+{
+  const Column& c = getColumn(i);
+
+  if(c.m_type != te::dt::GEOMETRY_TYPE)
+    return false;
+
+  if(c.m_valid[m_i])
+    view.read(&c.m_arena[c.m_offsets[m_i]]);
+  else
+    view.clear();
+
+  return true;
+}
+
+std::auto_ptr<te::rst::Raster> te::mem::ColumnarDataSet::getRaster(std::size_t i) const
+{
+  return std::auto_ptr<te::rst::Raster>(static_cast<te::rst::Raster*>(getValue(i).release()));
+}
+
+std::auto_ptr<te::dt::DateTime> te::mem::ColumnarDataSet::getDateTime(std::size_t i) const
+{
+  return std::auto_ptr<te::dt::DateTime>(static_cast<te::dt::DateTime*>(getValue(i).release()));
+}
+
+std::auto_ptr<te::dt::Array> te::mem::ColumnarDataSet::getArray(std::size_t i) const
+{
+  return std::auto_ptr<te::dt::Array>(static_cast<te::dt::Array*>(getValue(i).release()));
+}
+
+std::auto_ptr<te::dt::AbstractData> te::mem::ColumnarDataSet::getValue(std::size_t i) const
+{
+  const Column& c = getColumn(i);
+
+  if(c.m_storage != OBJECT_STORAGE)
+    return te::da::DataSet::getValue(i);
+
+  if(c.m_objects.is_null(m_i))
+    return std::auto_ptr<te::dt::AbstractData>(0);
+
+  return std::auto_ptr<te::dt::AbstractData>(c.m_objects[m_i].clone());
+}
+
+bool te::mem::ColumnarDataSet::isNull(std::size_t i) const
+{
+  return !getColumn(i).m_valid[m_i];
+}
+
+void te::mem::ColumnarDataSet::setChar(std::size_t i, char value)
+{
+  getColumn(i).set(m_i, value);
+}
+
+void te::mem::ColumnarDataSet::setUChar(std::size_t i, unsigned char value)
+{
+  getColumn(i).set(m_i, value);
+}
+
+void te::mem::ColumnarDataSet::setInt16(std::size_t i, boost::int16_t value)
+{
+  getColumn(i).set(m_i, value);
+}
+
+void te::mem::ColumnarDataSet::setInt32(std::size_t i, boost::int32_t value)
+{
+  getColumn(i).set(m_i, value);
+}
+
+void te::mem::ColumnarDataSet::setInt64(std::size_t i, boost::int64_t value)
+{
+  getColumn(i).set(m_i, value);
+}
+
+void te::mem::ColumnarDataSet::setBool(std::size_t i, bool value)
+{
+  getColumn(i).set(m_i, value);
+}
+
+void te::mem::ColumnarDataSet::setFloat(std::size_t i, float value)
+{
+  getColumn(i).set(m_i, value);
+}
+
+void te::mem::ColumnarDataSet::setDouble(std::size_t i, double value)
+{
+  getColumn(i).set(m_i, value);
+}
+
+void te::mem::ColumnarDataSet::setNumeric(std::size_t i, const std::string& value)
+{
+  getColumn(i).setBytes(m_i, value.c_str(), value.size());
+}
+
+void te::mem::ColumnarDataSet::setString(std::size_t i, const std::string& value)
+{
+  getColumn(i).setBytes(m_i, value.c_str(), value.size());
+}
+
+void te::mem::ColumnarDataSet::setByteArray(std::size_t i, te::dt::ByteArray* value)
+{
+  std::auto_ptr<te::dt::ByteArray> b(value);
+
+  if(b.get() == 0)
+    setNull(i);
+  else
+    getColumn(i).setBytes(m_i, b->getData(), b->bytesUsed());
+}
+
+void te::mem::ColumnarDataSet::setGeometry(std::size_t i, te::gm::Geometry* value)
+{
+  std::auto_ptr<te::gm::Geometry> g(value);
+
+  if(g.get() == 0)
+    setNull(i);
+  else
+    getColumn(i).setGeometry(m_i, *g);
+}
+
+void te::mem::ColumnarDataSet::setDateTime(std::size_t i, te::dt::DateTime* value)
+{
+  setValue(i, value);
+}
+
+void te::mem::ColumnarDataSet::setValue(std::size_t i, te::dt::AbstractData* value)
+{
+  std::auto_ptr<te::dt::AbstractData> v(value);
+
+  if(v.get() == 0)
+  {
+    setNull(i);
+    return;
+  }
+
+  Column& c = getColumn(i);
+
+  if(c.m_storage == OBJECT_STORAGE)
+  {
+    c.m_objects.replace(m_i, v.release());
+    c.m_valid[m_i] = true;
+    return;
+  }
+
+// decode the value according to its own type: the column converts it to the property type
+  switch(v->getTypeCode())
+  {
+    case te::dt::CHAR_TYPE:
+      c.set(m_i, static_cast<te::dt::Char*>(v.get())->getValue());
+    break;
+
+    case te::dt::UCHAR_TYPE:
+      c.set(m_i, static_cast<te::dt::UChar*>(v.get())->getValue());
+    break;
+
+    case te::dt::INT16_TYPE:
+      c.set(m_i, static_cast<te::dt::Int16*>(v.get())->getValue());
+    break;
+
+    case te::dt::UINT16_TYPE:
+      c.set(m_i, static_cast<te::dt::UInt16*>(v.get())->getValue());
+    break;
+
+    case te::dt::INT32_TYPE:
+      c.set(m_i, static_cast<te::dt::Int32*>(v.get())->getValue());
+    break;
+
+    case te::dt::UINT32_TYPE:
+      c.set(m_i, static_cast<te::dt::UInt32*>(v.get())->getValue());
+    break;
+
+    case te::dt::INT64_TYPE:
+      c.set(m_i, static_cast<te::dt::Int64*>(v.get())->getValue());
+    break;
+
+    case te::dt::UINT64_TYPE:
+      c.set(m_i, static_cast<te::dt::UInt64*>(v.get())->getValue());
+    break;
+
+    case te::dt::BOOLEAN_TYPE:
+      c.set(m_i, static_cast<te::dt::Boolean*>(v.get())->getValue());
+    break;
+
+    case te::dt::FLOAT_TYPE:
+      c.set(m_i, static_cast<te::dt::Float*>(v.get())->getValue());
+    break;
+
+    case te::dt::DOUBLE_TYPE:
+      c.set(m_i, static_cast<te::dt::Double*>(v.get())->getValue());
+    break;
+
+    case te::dt::BYTE_ARRAY_TYPE:
+      setByteArray(i, static_cast<te::dt::ByteArray*>(v.release()));
+    break;
+
+    case te::dt::GEOMETRY_TYPE:
+      setGeometry(i, static_cast<te::gm::Geometry*>(v.release()));
+    break;
+
+    default:
+      setString(i, v->toString());
+  }
+}
+
+void te::mem::ColumnarDataSet::setNull(std::size_t i)
+{
+  Column& c = getColumn(i);
+
+  c.m_valid[m_i] = false;
+
+  if(c.m_storage == OBJECT_STORAGE)
+    c.m_objects.replace(m_i, 0);
+}
+
+const te::mem::ColumnarDataSet::Column& te::mem::ColumnarDataSet::getColumn(std::size_t i) const
+{
+  assert(i < m_columns.size());
+
+  return m_table->m_columns[m_columns[i]];
+}
+
+te::mem::ColumnarDataSet::Column& te::mem::ColumnarDataSet::getColumn(std::size_t i)
+{
+  assert(i < m_columns.size());
+
+  return m_table->m_columns[m_columns[i]];
+}
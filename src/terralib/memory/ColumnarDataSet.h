@@ -0,0 +1,292 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+  \file terralib/memory/ColumnarDataSet.h
+
+  \brief A random-access dataset that keeps its values in typed column buffers.
+*/
+
+#ifndef __TERRALIB_MEMORY_INTERNAL_COLUMNARDATASET_H
+#define __TERRALIB_MEMORY_INTERNAL_COLUMNARDATASET_H
+
+// TerraLib
+#include "../dataaccess/dataset/DataSet.h"
+#include "Config.h"
+
+// STL
+#include <memory>
+#include <string>
+#include <vector>
+
+// Boost
+#include <boost/shared_ptr.hpp>
+
+namespace te
+{
+  namespace da
+  {
+    class DataSetType;
+  }
+
+  namespace mem
+  {
+    /*!
+      \class ColumnarDataSet
+
+      \brief A random-access dataset that keeps its values in typed column buffers.
+
+      Unlike te::mem::DataSet, where each value is a separately allocated
+      te::dt::AbstractData, this dataset stores each property in a single buffer:
+
+      <ul>
+      <li>numeric and boolean values are packed in a contiguous array of their native type;</li>
+      <li>strings, numeric strings and byte arrays are appended to an arena of bytes;</li>
+      <li>geometries are packed as WKB in an arena of bytes;</li>
+      <li>null values are kept in a validity bitmap for each column;</li>
+      <li>other types (date and time, arrays, rasters) are kept as objects.</li>
+      </ul>
+
+      The columns are shared between copies of the dataset: the copy constructor
+      creates a new cursor over the same data without copying it, and a copy can
+      be restricted to a subset of the properties. This allows handing the data
+      to algorithms written for te::da::DataSet without any conversion.
+
+      \note Setting a new value to a string, byte array or geometry appends it
+            to the column arena: the space used by the old value is not reclaimed.
+
+      \note Copies share the data but not the cursor. Adding items through one of
+            them makes the new items visible to all of them.
+
+      \sa te::da::DataSet, te::mem::DataSet
+    */
+    class TEMEMORYEXPORT ColumnarDataSet : public te::da::DataSet
+    {
+      public:
+
+        /*!
+          \brief It constructs an empty dataset having the schema dt.
+
+          \param dt The DataSetType associated to the dataset.
+
+          \note The dataset will NOT take the ownership of the given DataSetType.
+        */
+        explicit ColumnarDataSet(const te::da::DataSetType* const dt);
+
+        /*!
+          \brief It creates a new dataset with the items from the rhs dataset.
+
+          \param rhs   The dataset which will provide the items.
+          \param limit The number of items to be copied. Use 0 to copy all items.
+
+          \note This constructor will use the method "moveNext()" of the source dataset (rhs)
+                in order to read its dataset items. It will start reading the given 
+                dataset in the current position. So, the caller is responsible for
+                informing the dataset in the right position to start processing it.
+        */
+        explicit ColumnarDataSet(te::da::DataSet& rhs, std::size_t limit = 0);
+
+        /*!
+          \brief It creates a new cursor over the columns of the rhs dataset.
+
+          \param rhs The dataset whose columns will be shared.
+
+          \note No data is copied.
+        */
+        ColumnarDataSet(const ColumnarDataSet& rhs);
+
+        /*!
+          \brief It creates a new cursor over some of the columns of the rhs dataset.
+
+          \param rhs        The dataset whose columns will be shared.
+          \param properties The positions, in the rhs dataset, of the properties exposed by the new dataset.
+
+          \note No data is copied.
+        */
+        ColumnarDataSet(const ColumnarDataSet& rhs, const std::vector<std::size_t>& properties);
+
+        /*! \brief Destructor. */
+        ~ColumnarDataSet();
+
+        /*!
+          \brief It copies up to limit items from the source dataset.
+
+          \param src   The source dataset with the items that will be copied. It must have the same properties of this dataset.
+          \param limit The number of items to be copied. Use 0 to copy all items.
+
+          \note This method will call moveNext() for the source dataset
+                in order to read its items. It will start reading the given 
+                dataset in the current position. So, the caller is responsible for
+                informing the dataset in the right position to start processing it.
+        */
+        void copy(te::da::DataSet& src, std::size_t limit = 0);
+
+        /*!
+          \brief It reserves memory in all column buffers for the given number of items.
+
+          \param nitems The expected number of items.
+        */
+        void reserve(std::size_t nitems);
+
+        /*! \brief It appends a new item with null values to the dataset and moves the dataset to it. */
+        void add();
+
+        /*! \brief It clears all the dataset items keeping the schema. */
+        void clear();
+
+        /*! \name DataSet inherited methods */
+        //@{
+        te::common::TraverseType getTraverseType() const;
+
+        te::common::AccessPolicy getAccessPolicy() const;
+
+        std::size_t getNumProperties() const;
+
+        int getPropertyDataType(std::size_t i) const;
+
+        std::string getPropertyName(std::size_t i) const;
+
+        std::string getDatasetNameOfProperty(std::size_t i) const;
+
+        bool isEmpty() const;
+
+        bool isConnected() const;
+
+        std::size_t size() const;
+
+        std::auto_ptr<te::gm::Envelope> getExtent(std::size_t i);
+
+        bool moveNext();
+
+        bool movePrevious();
+
+        bool moveBeforeFirst();
+
+        bool moveFirst();
+
+        bool moveLast();
+
+        bool move(std::size_t i);
+
+        bool isAtBegin() const;
+
+        bool isBeforeBegin() const;
+
+        bool isAtEnd() const;
+
+        bool isAfterEnd() const;
+
+        char getChar(std::size_t i) const;
+
+        unsigned char getUChar(std::size_t i) const;
+
+        boost::int16_t getInt16(std::size_t i) const;
+
+        boost::int32_t getInt32(std::size_t i) const;
+
+        boost::int64_t getInt64(std::size_t i) const;
+
+        bool getBool(std::size_t i) const;
+
+        float getFloat(std::size_t i) const;
+
+        double getDouble(std::size_t i) const;
+
+        std::string getNumeric(std::size_t i) const;
+
+        std::string getString(std::size_t i) const;
+
+        std::auto_ptr<te::dt::ByteArray> getByteArray(std::size_t i) const;
+
+        std::auto_ptr<te::gm::Geometry> getGeometry(std::size_t i) const;
+
+        bool getGeometryView(std::size_t i, te::gm::WKBView& view) const;
+
+        std::auto_ptr<te::rst::Raster> getRaster(std::size_t i) const;
+
+        std::auto_ptr<te::dt::DateTime> getDateTime(std::size_t i) const;
+
+        std::auto_ptr<te::dt::Array> getArray(std::size_t i) const;
+
+        std::auto_ptr<te::dt::AbstractData> getValue(std::size_t i) const;
+
+        bool isNull(std::size_t i) const;
+        //@}
+
+        /*! \name Methods to set values to the current item
+
+            \note The methods receiving pointers take their ownership.
+        */
+        //@{
+        void setChar(std::size_t i, char value);
+
+        void setUChar(std::size_t i, unsigned char value);
+
+        void setInt16(std::size_t i, boost::int16_t value);
+
+        void setInt32(std::size_t i, boost::int32_t value);
+
+        void setInt64(std::size_t i, boost::int64_t value);
+
+        void setBool(std::size_t i, bool value);
+
+        void setFloat(std::size_t i, float value);
+
+        void setDouble(std::size_t i, double value);
+
+        void setNumeric(std::size_t i, const std::string& value);
+
+        void setString(std::size_t i, const std::string& value);
+
+        void setByteArray(std::size_t i, te::dt::ByteArray* value);
+
+        void setGeometry(std::size_t i, te::gm::Geometry* value);
+
+        void setDateTime(std::size_t i, te::dt::DateTime* value);
+
+        void setValue(std::size_t i, te::dt::AbstractData* value);
+
+        void setNull(std::size_t i);
+        //@}
+
+      private:
+
+        /*! \brief No assignment operator allowed. */
+        ColumnarDataSet& operator=(const ColumnarDataSet& rhs);
+
+        struct Column;
+        struct Table;
+
+        /*! \brief It returns the column of the given property. */
+        const Column& getColumn(std::size_t i) const;
+
+        /*! \brief It returns the column of the given property. */
+        Column& getColumn(std::size_t i);
+
+      private:
+
+        boost::shared_ptr<Table> m_table;     //!< The columns, shared by all copies of the dataset.
+        std::vector<std::size_t> m_columns;   //!< The table column of each property of this dataset.
+        int m_i;                              //!< The index of the current item.
+    };
+
+  } // end namespace mem
+}   // end namespace te
+
+#endif  // __TERRALIB_MEMORY_INTERNAL_COLUMNARDATASET_H
@@ -31,6 +31,7 @@ namespace te
   namespace mem
   {
     class CachedRaster;
+    class ColumnarDataSet;
     class ExpansibleBandBlocksManager;
     class ExpansibleRaster;
   }
@@ -33,6 +33,7 @@
 #include "../geometry/Envelope.h"
 #include "../geometry/Geometry.h"
 #include "../geometry/WKBReader.h"
+#include "../geometry/WKBView.h"
 #include "../srs/Config.h"
 #include "DataSource.h"
 #include "DataSet.h"
@@ -275,6 +276,38 @@ std::auto_ptr<te::gm::Geometry> te::ogr::DataSet::getGeometry(std::size_t /*i*/)
   return std::auto_ptr<te::gm::Geometry>(geom);
 }
 
+bool te::ogr::DataSet::getGeometryView(std::size_t /*i*/, te::gm::WKBView& view) const
+{
+  // The OGR library supports only one geometry field
+  OGRGeometry* geom = m_currentFeature->GetGeometryRef();
+
+  if(geom == 0)
+  {
+    view.clear();
+    return true;
+  }
+
+  // curves are not supported by the view
+  if(geom->hasCurveGeometry())
+    return false;
+
+  // the view flattens multi-geometries: no need to clone and promote the geometry as in getWKB
+  int wkbSize = geom->WkbSize();
+
+  if(wkbSize > m_wkbArraySize)
+  {
+    m_wkbArraySize = wkbSize;
+    delete [] m_wkbArray;
+    m_wkbArray = new unsigned char[m_wkbArraySize];
+  }
+
+  geom->exportToWkb(wkbNDR, m_wkbArray, wkbVariantIso);
+
+  view.read((const char*)m_wkbArray);
+
+  return true;
+}
+
 std::auto_ptr<te::rst::Raster> te::ogr::DataSet::getRaster(std::size_t /*i*/) const
 {
   throw te::common::Exception(TE_TR("OGR driver: getRaster not supported."));
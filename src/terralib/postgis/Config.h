@@ -59,6 +59,24 @@
  */
 #define PGIS_DEFAULT_MAX_IDLE_TIME       10
 
+/*!
+  \def PGIS_DEFAULT_CURSOR_FETCH_SIZE
+
+  \brief This sets the default number of rows retrieved by each fetch of a forward-only dataset.
+
+  \note A value of 0 disables the server-side cursors: forward-only datasets are fully materialized as the random ones.
+        The cursors are opt-in (PG_CURSOR_FETCH_SIZE or DataSource::setCursorFetchSize) because a cursor dataset
+        can't move backward and, outside a transaction, holds a pooled connection while it is open.
+ */
+#define PGIS_DEFAULT_CURSOR_FETCH_SIZE   0
+
+/*!
+  \def PGIS_DEFAULT_COPY_BUFFER_SIZE
+
+  \brief This sets the default number of bytes accumulated by a COPY before sending data to the server.
+ */
+#define PGIS_DEFAULT_COPY_BUFFER_SIZE    1048576
+
 /*!
   \def PGIS_DEFAULT_PORT
 
@@ -0,0 +1,436 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+  \file terralib/postgis/CopyWriter.cpp
+
+  \brief An utility class for streaming dataset rows to PostgreSQL through COPY in binary format.
+*/
+
+// TerraLib
+#include "../Defines.h"
+#include "../common/ByteSwapUtils.h"
+#include "../core/translator/Translator.h"
+#include "../dataaccess/dataset/DataSet.h"
+#include "../dataaccess/utils/Utils.h"
+#include "../datatype/ByteArray.h"
+#include "../datatype/Enums.h"
+#include "../geometry/Geometry.h"
+#include "Connection.h"
+#include "CopyWriter.h"
+#include "EWKBWriter.h"
+#include "Exception.h"
+
+// STL
+#include <cassert>
+#include <cstring>
+#include <memory>
+
+// Boost
+#include <boost/cstdint.hpp>
+#include <boost/format.hpp>
+
+// libpq
+#include <libpq-fe.h>
+
+namespace te
+{
+  namespace pgis
+  {
+    /*! \brief The signature of a binary COPY: "PGCOPY\n\377\r\n\0", followed by the flags field and the header extension length. */
+    static const char sg_copyHeader[19] = { 'P', 'G', 'C', 'O', 'P', 'Y', '\n', '\377', '\r', '\n', '\0',
+                                            '\0', '\0', '\0', '\0',
+                                            '\0', '\0', '\0', '\0' };
+
+    /*! \brief It appends a 2 bytes value to the buffer in network byte order. */
+    inline void AppendInt16(std::vector<char>& buffer, boost::int16_t value)
+    {
+      char* v = reinterpret_cast<char*>(&value);
+
+#if TE_MACHINE_BYTE_ORDER == TE_NDR
+      te::common::Swap2Bytes(v);
+#endif
+
+      buffer.insert(buffer.end(), v, v + sizeof(boost::int16_t));
+    }
+
+    /*! \brief It appends a 4 bytes value to the buffer in network byte order. */
+    inline void AppendInt32(std::vector<char>& buffer, boost::int32_t value)
+    {
+      char* v = reinterpret_cast<char*>(&value);
+
+#if TE_MACHINE_BYTE_ORDER == TE_NDR
+      te::common::Swap4Bytes(v);
+#endif
+
+      buffer.insert(buffer.end(), v, v + sizeof(boost::int32_t));
+    }
+
+    /*! \brief It appends a 8 bytes value to the buffer in network byte order. */
+    inline void AppendInt64(std::vector<char>& buffer, boost::int64_t value)
+    {
+      char* v = reinterpret_cast<char*>(&value);
+
+#if TE_MACHINE_BYTE_ORDER == TE_NDR
+      te::common::Swap8Bytes(v);
+#endif
+
+      buffer.insert(buffer.end(), v, v + sizeof(boost::int64_t));
+    }
+
+    /*! \brief It appends a float value to the buffer in network byte order. */
+    inline void AppendFloat(std::vector<char>& buffer, float value)
+    {
+      boost::int32_t ivalue;
+      memcpy(&ivalue, &value, sizeof(float));
+      AppendInt32(buffer, ivalue);
+    }
+
+    /*! \brief It appends a double value to the buffer in network byte order. */
+    inline void AppendDouble(std::vector<char>& buffer, double value)
+    {
+      boost::int64_t ivalue;
+      memcpy(&ivalue, &value, sizeof(double));
+      AppendInt64(buffer, ivalue);
+    }
+
+    /*! \brief It tells if the TerraLib data type can be read as an integer. */
+    inline bool IsIntegerType(int teType)
+    {
+      return (teType == te::dt::CHAR_TYPE) || (teType == te::dt::INT16_TYPE) ||
+             (teType == te::dt::INT32_TYPE) || (teType == te::dt::INT64_TYPE) ||
+             (teType == te::dt::BOOLEAN_TYPE);
+    }
+
+    /*! \brief It reads an integer value from the dataset, whatever its integer data type. */
+    inline boost::int64_t GetInteger(te::da::DataSet* d, std::size_t i)
+    {
+      switch(d->getPropertyDataType(i))
+      {
+        case te::dt::CHAR_TYPE :
+          return d->getChar(i);
+
+        case te::dt::INT16_TYPE :
+          return d->getInt16(i);
+
+        case te::dt::INT32_TYPE :
+          return d->getInt32(i);
+
+        case te::dt::BOOLEAN_TYPE :
+          return d->getBool(i) ? 1 : 0;
+
+        default :
+          return d->getInt64(i);
+      }
+    }
+
+    /*! \brief It reads a real value from the dataset, whatever its numeric data type. */
+    inline double GetReal(te::da::DataSet* d, std::size_t i)
+    {
+      switch(d->getPropertyDataType(i))
+      {
+        case te::dt::FLOAT_TYPE :
+          return d->getFloat(i);
+
+        case te::dt::DOUBLE_TYPE :
+          return d->getDouble(i);
+
+        default :
+          return static_cast<double>(GetInteger(d, i));
+      }
+    }
+
+    /*! \brief It appends the value of the given property to the buffer as a binary COPY field. */
+    inline void EncodeValue(te::da::DataSet* d, std::size_t i, unsigned int columnType, unsigned int geomTypeOid, std::vector<char>& buffer)
+    {
+      if(d->isNull(i))
+      {
+        AppendInt32(buffer, -1);
+        return;
+      }
+
+      switch(columnType)
+      {
+        case PG_INT2_TYPE :
+          AppendInt32(buffer, sizeof(boost::int16_t));
+          AppendInt16(buffer, static_cast<boost::int16_t>(GetInteger(d, i)));
+        break;
+
+        case PG_INT4_TYPE :
+          AppendInt32(buffer, sizeof(boost::int32_t));
+          AppendInt32(buffer, static_cast<boost::int32_t>(GetInteger(d, i)));
+        break;
+
+        case PG_INT8_TYPE :
+          AppendInt32(buffer, sizeof(boost::int64_t));
+          AppendInt64(buffer, GetInteger(d, i));
+        break;
+
+        case PG_FLOAT4_TYPE :
+          AppendInt32(buffer, sizeof(float));
+          AppendFloat(buffer, static_cast<float>(GetReal(d, i)));
+        break;
+
+        case PG_FLOAT8_TYPE :
+          AppendInt32(buffer, sizeof(double));
+          AppendDouble(buffer, GetReal(d, i));
+        break;
+
+        case PG_BOOL_TYPE :
+          AppendInt32(buffer, 1);
+          buffer.push_back(d->getBool(i) ? 1 : 0);
+        break;
+
+        case PG_CHAR_TYPE :
+          AppendInt32(buffer, 1);
+          buffer.push_back(d->getChar(i));
+        break;
+
+        case PG_TEXT_TYPE :
+        case PG_VARCHAR_TYPE :
+        case PG_CHARACTER_TYPE :
+          {
+            std::string value = d->getString(i);
+            AppendInt32(buffer, static_cast<boost::int32_t>(value.size()));
+            buffer.insert(buffer.end(), value.begin(), value.end());
+          }
+        break;
+
+        case PG_BYTEA_TYPE :
+          {
+            std::auto_ptr<te::dt::ByteArray> ba(d->getByteArray(i));
+            AppendInt32(buffer, static_cast<boost::int32_t>(ba->bytesUsed()));
+            buffer.insert(buffer.end(), ba->getData(), ba->getData() + ba->bytesUsed());
+          }
+        break;
+
+        default :
+          {
+            assert(columnType == geomTypeOid);
+
+            std::auto_ptr<te::gm::Geometry> geom(d->getGeometry(i));
+
+            const std::size_t ewkbsize = geom->getWkbSize() + 4;
+
+            AppendInt32(buffer, static_cast<boost::int32_t>(ewkbsize));
+
+// the EWKB is written straight into the COPY buffer
+            const std::size_t pos = buffer.size();
+            buffer.resize(pos + ewkbsize);
+
+            EWKBWriter::write(geom.get(), &buffer[pos]);
+          }
+      }
+    }
+
+  } // end namespace pgis
+}   // end namespace te
+
+te::pgis::CopyWriter::CopyWriter(Connection* conn, unsigned int geomTypeOid, std::size_t bufferSize)
+  : m_conn(conn),
+    m_geomTypeOid(geomTypeOid),
+    m_bufferSize(bufferSize),
+    m_inCopy(false)
+{
+  assert(m_conn);
+
+  m_buffer.reserve(m_bufferSize + 1024);
+}
+
+te::pgis::CopyWriter::~CopyWriter()
+{
+  if(!m_inCopy)
+    return;
+
+  PQputCopyEnd(m_conn->getConn(), "COPY aborted by the client");
+
+  PGresult* result = 0;
+
+  while((result = PQgetResult(m_conn->getConn())) != 0)
+    PQclear(result);
+}
+
+bool te::pgis::CopyWriter::isSupported(te::da::DataSet* d, const std::vector<unsigned int>& columnTypes, unsigned int geomTypeOid)
+{
+  const std::size_t np = d->getNumProperties();
+
+  if(columnTypes.size() != np)
+    return false;
+
+  for(std::size_t i = 0; i != np; ++i)
+  {
+    const int teType = d->getPropertyDataType(i);
+
+    const unsigned int oid = columnTypes[i];
+
+    bool ok = false;
+
+    switch(oid)
+    {
+      case PG_INT2_TYPE :
+      case PG_INT4_TYPE :
+      case PG_INT8_TYPE :
+        ok = IsIntegerType(teType);
+      break;
+
+      case PG_FLOAT4_TYPE :
+      case PG_FLOAT8_TYPE :
+        ok = IsIntegerType(teType) || (teType == te::dt::FLOAT_TYPE) || (teType == te::dt::DOUBLE_TYPE);
+      break;
+
+      case PG_BOOL_TYPE :
+        ok = (teType == te::dt::BOOLEAN_TYPE);
+      break;
+
+      case PG_CHAR_TYPE :
+        ok = (teType == te::dt::CHAR_TYPE);
+      break;
+
+      case PG_TEXT_TYPE :
+      case PG_VARCHAR_TYPE :
+      case PG_CHARACTER_TYPE :
+        ok = (teType == te::dt::STRING_TYPE);
+      break;
+
+      case PG_BYTEA_TYPE :
+        ok = (teType == te::dt::BYTE_ARRAY_TYPE);
+      break;
+
+      default :
+        ok = (oid == geomTypeOid) && (teType == te::dt::GEOMETRY_TYPE);
+    }
+
+    if(!ok)
+      return false;
+  }
+
+  return true;
+}
+
+void te::pgis::CopyWriter::encode(te::da::DataSet* d, const std::vector<unsigned int>& columnTypes, unsigned int geomTypeOid, std::vector<char>& buffer)
+{
+  const std::size_t np = columnTypes.size();
+
+  AppendInt16(buffer, static_cast<boost::int16_t>(np));
+
+  for(std::size_t i = 0; i != np; ++i)
+    EncodeValue(d, i, columnTypes[i], geomTypeOid, buffer);
+}
+
+void te::pgis::CopyWriter::begin(const std::string& datasetName, te::da::DataSet* d, const std::vector<unsigned int>& columnTypes)
+{
+  assert(!m_inCopy);
+
+  std::string sql  = "COPY ";
+              sql += datasetName;
+              sql += te::da::GetSQLValueNames(d);
+              sql += " FROM STDIN WITH BINARY";
+
+  PGresult* result = PQexec(m_conn->getConn(), sql.c_str());
+
+  if(PQresultStatus(result) != PGRES_COPY_IN)
+  {
+    boost::format errmsg(TE_TR("Could not start the COPY command due to the following error: %1%."));
+
+    errmsg = errmsg % PQerrorMessage(m_conn->getConn());
+
+    PQclear(result);
+
+    throw Exception(errmsg.str());
+  }
+
+  PQclear(result);
+
+  m_inCopy = true;
+
+  m_columnTypes = columnTypes;
+
+  m_buffer.clear();
+  m_buffer.insert(m_buffer.end(), sg_copyHeader, sg_copyHeader + sizeof(sg_copyHeader));
+}
+
+void te::pgis::CopyWriter::write(te::da::DataSet* d)
+{
+  assert(m_inCopy);
+
+  encode(d, m_columnTypes, m_geomTypeOid, m_buffer);
+
+  if(m_buffer.size() >= m_bufferSize)
+    flush();
+}
+
+void te::pgis::CopyWriter::end()
+{
+  assert(m_inCopy);
+
+// the file trailer
+  AppendInt16(m_buffer, -1);
+
+  flush();
+
+  m_inCopy = false;
+
+  if(PQputCopyEnd(m_conn->getConn(), 0) != 1)
+  {
+    boost::format errmsg(TE_TR("Could not finish the COPY command due to the following error: %1%."));
+
+    errmsg = errmsg % PQerrorMessage(m_conn->getConn());
+
+    throw Exception(errmsg.str());
+  }
+
+// the server reports data errors only when the COPY is finished
+  std::string error;
+
+  PGresult* result = 0;
+
+  while((result = PQgetResult(m_conn->getConn())) != 0)
+  {
+    if(error.empty() && (PQresultStatus(result) != PGRES_COMMAND_OK))
+      error = PQresultErrorMessage(result);
+
+    PQclear(result);
+  }
+
+  if(!error.empty())
+  {
+    boost::format errmsg(TE_TR("Could not copy the data due to the following error: %1%."));
+
+    errmsg = errmsg % error;
+
+    throw Exception(errmsg.str());
+  }
+}
+
+void te::pgis::CopyWriter::flush()
+{
+  if(m_buffer.empty())
+    return;
+
+  if(PQputCopyData(m_conn->getConn(), &m_buffer[0], static_cast<int>(m_buffer.size())) != 1)
+  {
+    boost::format errmsg(TE_TR("Could not send the COPY data due to the following error: %1%."));
+
+    errmsg = errmsg % PQerrorMessage(m_conn->getConn());
+
+    throw Exception(errmsg.str());
+  }
+
+  m_buffer.clear();
+}
@@ -0,0 +1,151 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+  \file terralib/postgis/CopyWriter.h
+
+  \brief An utility class for streaming dataset rows to PostgreSQL through COPY in binary format.
+*/
+
+#ifndef __TERRALIB_POSTGIS_INTERNAL_COPYWRITER_H
+#define __TERRALIB_POSTGIS_INTERNAL_COPYWRITER_H
+
+// TerraLib
+#include "Config.h"
+
+// STL
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Boost
+#include <boost/noncopyable.hpp>
+
+namespace te
+{
+// Forward declarations
+  namespace da { class DataSet; }
+
+  namespace pgis
+  {
+// Forward declarations
+    class Connection;
+
+    /*!
+      \class CopyWriter
+
+      \brief An utility class for streaming dataset rows to PostgreSQL through COPY in binary format.
+
+      Each row of the dataset is encoded directly in the COPY buffer: numeric values
+      are written in network byte order, strings and byte arrays as raw bytes
+      and geometries as EWKB. The buffer is sent to the server whenever it
+      grows beyond the configured size, so there is one round trip per buffer
+      instead of one per row.
+
+      \note The binary COPY format requires the values to match the target column
+            types. Use isSupported to check the dataset against the table columns
+            before starting the COPY.
+
+      \sa Transactor, EWKBWriter
+    */
+    class TEPGISEXPORT CopyWriter : public boost::noncopyable
+    {
+      public:
+
+        /*!
+          \brief Constructor.
+
+          \param conn        The connection used to run the COPY command.
+          \param geomTypeOid The PostGIS geometry type OID.
+          \param bufferSize  The number of bytes accumulated before sending data to the server.
+        */
+        CopyWriter(Connection* conn, unsigned int geomTypeOid, std::size_t bufferSize = PGIS_DEFAULT_COPY_BUFFER_SIZE);
+
+        /*! \brief Destructor. If the COPY was not finished, it is aborted. */
+        ~CopyWriter();
+
+        /*!
+          \brief It checks if the properties of the dataset can be encoded into the given column types.
+
+          \param d           The dataset to be copied.
+          \param columnTypes The OIDs of the target columns, one for each dataset property.
+          \param geomTypeOid The PostGIS geometry type OID.
+
+          \return True if all properties can be written in binary format to their columns.
+        */
+        static bool isSupported(te::da::DataSet* d, const std::vector<unsigned int>& columnTypes, unsigned int geomTypeOid);
+
+        /*!
+          \brief It appends the current row of the dataset to the buffer as a binary COPY tuple.
+
+          \param d           The dataset, positioned at a valid row.
+          \param columnTypes The OIDs of the target columns, one for each dataset property.
+          \param geomTypeOid The PostGIS geometry type OID.
+          \param buffer      The buffer where the tuple will be appended.
+
+          \pre The column types must have been checked with isSupported.
+        */
+        static void encode(te::da::DataSet* d, const std::vector<unsigned int>& columnTypes, unsigned int geomTypeOid, std::vector<char>& buffer);
+
+        /*!
+          \brief It starts the COPY command.
+
+          \param datasetName The target dataset name.
+          \param d           The dataset to be copied. Its property names are used as the column list.
+          \param columnTypes The OIDs of the target columns, one for each dataset property.
+
+          \exception Exception It throws an exception if the COPY command can not be started.
+        */
+        void begin(const std::string& datasetName, te::da::DataSet* d, const std::vector<unsigned int>& columnTypes);
+
+        /*!
+          \brief It encodes the current row of the dataset.
+
+          \param d The dataset being copied, positioned at a valid row.
+
+          \exception Exception It throws an exception if the data can not be sent to the server.
+        */
+        void write(te::da::DataSet* d);
+
+        /*!
+          \brief It sends the remaining data and finishes the COPY command.
+
+          \exception Exception It throws an exception if the server rejects the data.
+        */
+        void end();
+
+      private:
+
+        /*! \brief It sends the buffer contents to the server. */
+        void flush();
+
+      private:
+
+        Connection* m_conn;                       //!< The connection used to run the COPY command.
+        unsigned int m_geomTypeOid;               //!< The PostGIS geometry type OID.
+        std::size_t m_bufferSize;                 //!< The number of bytes accumulated before sending data to the server.
+        std::vector<char> m_buffer;               //!< The COPY buffer.
+        std::vector<unsigned int> m_columnTypes;  //!< The OIDs of the target columns.
+        bool m_inCopy;                            //!< It indicates if there is a COPY in progress.
+    };
+
+  } // end namespace pgis
+}   // end namespace te
+
+#endif  // __TERRALIB_POSTGIS_INTERNAL_COPYWRITER_H
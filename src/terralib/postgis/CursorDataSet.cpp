@@ -0,0 +1,373 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+  \file terralib/postgis/CursorDataSet.cpp
+
+  \brief A forward-only dataset that streams the rows of a query through a server-side cursor.
+*/
+
+// TerraLib
+#include "../core/translator/Translator.h"
+#include "../datatype/Enums.h"
+#include "../geometry/Envelope.h"
+#include "Connection.h"
+#include "ConnectionPool.h"
+#include "CursorDataSet.h"
+#include "DataSource.h"
+#include "Exception.h"
+#include "Utils.h"
+
+// STL
+#include <cassert>
+#include <string>
+
+// Boost
+#include <boost/format.hpp>
+#include <boost/lexical_cast.hpp>
+
+// libpq
+#include <libpq-fe.h>
+
+te::pgis::CursorDataSet::CursorDataSet(DataSource* ds,
+                                       Connection* conn,
+                                       bool ownConn,
+                                       const std::string& sql,
+                                       std::size_t fetchSize)
+  : te::pgis::DataSet(0, std::vector<int>(), ds->isTimeAnInteger()),
+    m_ds(ds),
+    m_conn(conn),
+    m_ownConn(ownConn),
+    m_cursorName("te_cursor_" + boost::lexical_cast<std::string>((intptr_t)(this))),
+    m_sql(sql),
+    m_fetchSize(fetchSize == 0 ? 1 : fetchSize),
+    m_offset(0),
+    m_count(std::string::npos),
+    m_next(0),
+    m_pending(false),
+    m_empty(true),
+    m_eof(false)
+{
+  assert(m_conn);
+
+  try
+  {
+    if(m_ownConn)
+      m_conn->execute("BEGIN");
+
+    m_conn->execute("DECLARE " + m_cursorName + " NO SCROLL CURSOR FOR " + m_sql);
+
+    fetch();
+
+    m_empty = (m_size == 0);
+
+    Convert2TerraLib(m_result, m_ds->getGeomTypeId(), m_ds->getRasterTypeId(), m_ptypes);
+  }
+  catch(...)
+  {
+    close();
+    throw;
+  }
+}
+
+te::pgis::CursorDataSet::~CursorDataSet()
+{
+  close();
+}
+
+te::common::TraverseType te::pgis::CursorDataSet::getTraverseType() const
+{
+  return te::common::FORWARDONLY;
+}
+
+bool te::pgis::CursorDataSet::isEmpty() const
+{
+  return m_empty;
+}
+
+bool te::pgis::CursorDataSet::isConnected() const
+{
+  return true;
+}
+
+std::size_t te::pgis::CursorDataSet::size() const
+{
+  if(m_count != std::string::npos)
+    return m_count;
+
+  if(m_eof)
+    return m_offset + static_cast<std::size_t>(m_size);
+
+  CursorDataSet* self = const_cast<CursorDataSet*>(this);
+
+  self->wait();
+
+  std::string sql("SELECT COUNT(*) FROM (");
+              sql += m_sql;
+              sql += ") AS te_cursor_count";
+
+  PGresult* result = PQexec(m_conn->getConn(), sql.c_str());
+
+  if(PQresultStatus(result) != PGRES_TUPLES_OK)
+  {
+    std::string errmsg(TE_TR("Could not count the rows of the dataset due to the following error: "));
+    errmsg += PQerrorMessage(m_conn->getConn());
+
+    PQclear(result);
+
+    throw Exception(errmsg);
+  }
+
+  self->m_count = boost::lexical_cast<std::size_t>(PQgetvalue(result, 0, 0));
+
+  PQclear(result);
+
+  return m_count;
+}
+
+std::auto_ptr<te::gm::Envelope> te::pgis::CursorDataSet::getExtent(std::size_t i)
+{
+  if(m_ptypes[i] != te::dt::GEOMETRY_TYPE)
+    throw Exception(TE_TR("This driver only supports the getExtent method over a geometry column!"));
+
+// the rows are not consumed: the extent is computed by the server
+  wait();
+
+  std::string sql("SELECT ST_Extent(\"");
+              sql += PQfname(m_result, static_cast<int>(i));
+              sql += "\") FROM (";
+              sql += m_sql;
+              sql += ") AS te_cursor_extent";
+
+  PGresult* result = PQexec(m_conn->getConn(), sql.c_str());
+
+  if(PQresultStatus(result) != PGRES_TUPLES_OK)
+  {
+    std::string errmsg(TE_TR("Could not find the envelope for the given geometry property due to the following error: "));
+    errmsg += PQerrorMessage(m_conn->getConn());
+
+    PQclear(result);
+
+    throw Exception(errmsg);
+  }
+
+  const char* boxStr = PQgetvalue(result, 0, 0);
+
+  te::gm::Envelope* mbr = (*boxStr != '\0') ? GetEnvelope(boxStr) : new te::gm::Envelope;
+
+  PQclear(result);
+
+  return std::auto_ptr<te::gm::Envelope>(mbr);
+}
+
+bool te::pgis::CursorDataSet::moveNext()
+{
+  if(m_i < m_size)
+    ++m_i;
+
+  if(m_i < m_size)
+    return true;
+
+  if(m_eof)
+    return false;
+
+  fetch();
+
+  m_i = 0;
+
+  return m_i < m_size;
+}
+
+bool te::pgis::CursorDataSet::movePrevious()
+{
+  throw Exception(TE_TR("This operation is not supported by forward-only datasets!"));
+}
+
+bool te::pgis::CursorDataSet::moveBeforeFirst()
+{
+  if(m_offset != 0)
+    restart();
+
+  m_i = -1;
+
+  return !m_empty;
+}
+
+bool te::pgis::CursorDataSet::moveFirst()
+{
+  if(m_offset != 0)
+    restart();
+
+  m_i = 0;
+
+  return !m_empty;
+}
+
+bool te::pgis::CursorDataSet::moveLast()
+{
+  throw Exception(TE_TR("This operation is not supported by forward-only datasets!"));
+}
+
+bool te::pgis::CursorDataSet::move(std::size_t i)
+{
+  if(i < m_offset + static_cast<std::size_t>(m_i < 0 ? 0 : m_i))
+    throw Exception(TE_TR("A forward-only dataset can not move to a previous position!"));
+
+  while((m_i < 0) || (m_offset + static_cast<std::size_t>(m_i) < i))
+  {
+    if(!moveNext())
+      return false;
+  }
+
+  return m_i < m_size;
+}
+
+bool te::pgis::CursorDataSet::isAtBegin() const
+{
+  return (m_offset == 0) && (m_i == 0);
+}
+
+bool te::pgis::CursorDataSet::isBeforeBegin() const
+{
+  return (m_offset == 0) && (m_i < 0);
+}
+
+bool te::pgis::CursorDataSet::isAtEnd() const
+{
+  return m_eof && (m_i == (m_size - 1));
+}
+
+bool te::pgis::CursorDataSet::isAfterEnd() const
+{
+  return m_eof && (m_i >= m_size);
+}
+
+void te::pgis::CursorDataSet::fetch()
+{
+  wait();
+
+  PGresult* result = m_next ? m_next : m_conn->query(getFetchCommand());
+
+  m_next = 0;
+
+  m_offset += static_cast<std::size_t>(m_size);
+
+  PQclear(m_result);
+
+  m_result = result;
+  m_size = PQntuples(m_result);
+  m_eof = static_cast<std::size_t>(m_size) < m_fetchSize;
+
+// the connection belongs to the dataset: the next chunk travels while this one is consumed
+  if(m_ownConn && !m_eof)
+  {
+    if(PQsendQueryParams(m_conn->getConn(), getFetchCommand().c_str(), 0, 0, 0, 0, 0, 1) == 0)
+    {
+      boost::format errmsg(TE_TR("Could not retrieve the dataset due to the following error: %1%."));
+                    errmsg = errmsg % PQerrorMessage(m_conn->getConn());
+
+      throw Exception(errmsg.str());
+    }
+
+    m_pending = true;
+  }
+}
+
+void te::pgis::CursorDataSet::wait()
+{
+  if(!m_pending)
+    return;
+
+  m_pending = false;
+
+  PGresult* result = PQgetResult(m_conn->getConn());
+
+// the connection is ready for the next command only after all the results were read
+  for(PGresult* r = PQgetResult(m_conn->getConn()); r != 0; r = PQgetResult(m_conn->getConn()))
+    PQclear(r);
+
+  if(PQresultStatus(result) != PGRES_TUPLES_OK)
+  {
+    boost::format errmsg(TE_TR("Could not retrieve the dataset due to the following error: %1%."));
+                  errmsg = errmsg % PQerrorMessage(m_conn->getConn());
+
+    PQclear(result);
+
+    throw Exception(errmsg.str());
+  }
+
+  m_next = result;
+}
+
+void te::pgis::CursorDataSet::restart()
+{
+  wait();
+
+  PQclear(m_next);
+
+  m_next = 0;
+
+  m_conn->execute("CLOSE " + m_cursorName);
+  m_conn->execute("DECLARE " + m_cursorName + " NO SCROLL CURSOR FOR " + m_sql);
+
+  m_offset = 0;
+  m_size = 0;
+
+  fetch();
+}
+
+std::string te::pgis::CursorDataSet::getFetchCommand() const
+{
+  std::string sql("FETCH FORWARD ");
+              sql += boost::lexical_cast<std::string>(m_fetchSize);
+              sql += " FROM ";
+              sql += m_cursorName;
+
+  return sql;
+}
+
+void te::pgis::CursorDataSet::close()
+{
+  if(m_conn == 0)
+    return;
+
+// the dataset may outlive the transaction it was created in: errors here must not escape
+  if(m_pending)
+  {
+    for(PGresult* r = PQgetResult(m_conn->getConn()); r != 0; r = PQgetResult(m_conn->getConn()))
+      PQclear(r);
+
+    m_pending = false;
+  }
+
+  PQclear(m_next);
+
+  m_next = 0;
+
+  PQclear(PQexec(m_conn->getConn(), ("CLOSE " + m_cursorName).c_str()));
+
+  if(m_ownConn)
+  {
+    PQclear(PQexec(m_conn->getConn(), "COMMIT"));
+
+    m_ds->getConnPool()->release(m_conn);
+  }
+
+  m_conn = 0;
+}
@@ -0,0 +1,171 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+  \file terralib/postgis/CursorDataSet.h
+
+  \brief A forward-only dataset that streams the rows of a query through a server-side cursor.
+*/
+
+#ifndef __TERRALIB_POSTGIS_INTERNAL_CURSORDATASET_H
+#define __TERRALIB_POSTGIS_INTERNAL_CURSORDATASET_H
+
+// TerraLib
+#include "DataSet.h"
+
+namespace te
+{
+  namespace pgis
+  {
+// Forward declarations
+    class Connection;
+    class DataSource;
+
+    /*!
+      \class CursorDataSet
+
+      \brief A forward-only dataset that streams the rows of a query through a server-side cursor.
+
+      Instead of materializing the whole query result in the client memory,
+      this dataset declares a server-side cursor and fetches its rows
+      in chunks of a configurable size. Only the current chunk is kept
+      in memory, so the memory footprint doesn't depend on the number of rows.
+
+      If the given connection is already inside a transaction the cursor
+      lives in that transaction and the dataset must be released before it ends.
+      Otherwise the dataset takes the ownership of the connection, opens its own
+      transaction and gives the connection back to the pool when it is destroyed.
+      In this case, the next chunk is requested as soon as the current one
+      arrives, so the server and the network work while the rows are consumed.
+
+      \note The dataset size is not known in advance: size() counts the rows
+            of the query in the server the first time it is called.
+
+      \note Backward movement is not supported. The methods moveFirst and moveBeforeFirst
+            declare the cursor again when the first chunk is no longer in memory.
+
+      \sa te::pgis::DataSet, te::pgis::Transactor
+    */
+    class TEPGISEXPORT CursorDataSet : public te::pgis::DataSet
+    {
+      public:
+
+        /*!
+          \brief Constructor.
+
+          It declares the cursor and fetches the first chunk of rows.
+
+          \param ds        The data source.
+          \param conn      The connection used to declare the cursor.
+          \param ownConn   If true, the dataset will run the cursor in its own transaction and will release the connection to the pool.
+          \param sql       The SQL query whose rows will be streamed.
+          \param fetchSize The number of rows retrieved by each round trip to the server.
+
+          \exception Exception It throws an exception if the cursor can not be declared.
+        */
+        CursorDataSet(DataSource* ds,
+                      Connection* conn,
+                      bool ownConn,
+                      const std::string& sql,
+                      std::size_t fetchSize);
+
+        /*! \brief The destructor will close the cursor and release the connection if the dataset owns it. */
+        ~CursorDataSet();
+
+        te::common::TraverseType getTraverseType() const;
+
+        bool isEmpty() const;
+
+        bool isConnected() const;
+
+        std::size_t size() const;
+
+        std::auto_ptr<te::gm::Envelope> getExtent(std::size_t i);
+
+        bool moveNext();
+
+        bool movePrevious();
+
+        bool moveBeforeFirst();
+
+        bool moveFirst();
+
+        bool moveLast();
+
+        bool move(std::size_t i);
+
+        bool isAtBegin() const;
+
+        bool isBeforeBegin() const;
+
+        bool isAtEnd() const;
+
+        bool isAfterEnd() const;
+
+      protected:
+
+        /*!
+          \brief It replaces the current chunk by the next rows of the cursor.
+
+          If the dataset owns the connection, it also requests the following chunk without waiting for it.
+
+          \exception Exception It throws an exception if the rows can not be fetched.
+        */
+        void fetch();
+
+        /*!
+          \brief It waits for the chunk requested in advance, if any, so the connection can run other commands.
+
+          \exception Exception It throws an exception if the rows can not be fetched.
+        */
+        void wait();
+
+        /*!
+          \brief It declares the cursor again and fetches its first chunk.
+
+          \exception Exception It throws an exception if the cursor can not be declared.
+        */
+        void restart();
+
+        /*! \brief It returns the SQL command that fetches the next chunk. */
+        std::string getFetchCommand() const;
+
+        /*! \brief It closes the cursor and finishes the transaction opened by the dataset, if any. */
+        void close();
+
+      private:
+
+        DataSource* m_ds;           //!< The data source.
+        Connection* m_conn;         //!< The connection where the cursor lives.
+        bool m_ownConn;             //!< It indicates if the dataset owns the connection and its transaction.
+        std::string m_cursorName;   //!< The cursor name.
+        std::string m_sql;          //!< The SQL query whose rows are streamed.
+        std::size_t m_fetchSize;    //!< The number of rows retrieved by each fetch.
+        std::size_t m_offset;       //!< The position of the first row of the current chunk.
+        std::size_t m_count;        //!< The number of rows of the query, counted on demand (std::string::npos if unknown).
+        PGresult* m_next;           //!< The next chunk, when it has already arrived.
+        bool m_pending;             //!< It indicates if the next chunk was requested and has not arrived yet.
+        bool m_empty;               //!< It indicates if the query returned no rows.
+        bool m_eof;                 //!< It indicates if the current chunk is the last one.
+    };
+
+  } // end namespace pgis
+}   // end namespace te
+
+#endif  // __TERRALIB_POSTGIS_INTERNAL_CURSORDATASET_H
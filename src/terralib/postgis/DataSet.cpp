@@ -35,6 +35,7 @@
 #include "../datatype/DateTime.h"
 #include "../datatype/SimpleData.h"
 #include "../geometry/Geometry.h"
+#include "../geometry/WKBView.h"
 #include "Connection.h"
 #include "ConnectionPool.h"
 //#include "CatalogLoader.h"
@@ -198,11 +199,16 @@ std::auto_ptr<te::gm::Envelope> te::pgis::DataSet::getExtent(std::size_t i)
 
     m_mbr = new te::gm::Envelope;
 
+// decode only the coordinates: no geometry is built for computing the extent
+    te::gm::WKBView view;
+
     m_i = -1;
     while(moveNext())
     {
-      std::auto_ptr<te::gm::Geometry> geom(getGeometry(i));
-      m_mbr->Union(*(geom->getMBR()));
+      getGeometryView(i, view);
+
+      if(!view.isEmpty())
+        m_mbr->Union(view.getMBR());
     }
   }
 
@@ -472,6 +478,16 @@ std::auto_ptr<te::gm::Geometry> te::pgis::DataSet::getGeometry(std::size_t i) co
   return std::auto_ptr<te::gm::Geometry>(EWKBReader::read(PQgetvalue(m_result, m_i, (int)i)));
 }
 
+bool te::pgis::DataSet::getGeometryView(std::size_t i, te::gm::WKBView& view) const
+{
+  if(PQgetisnull(m_result, m_i, (int)i) == 1)
+    view.clear();
+  else
+    view.read(PQgetvalue(m_result, m_i, (int)i));
+
+  return true;
+}
+
 std::auto_ptr<te::rst::Raster> te::pgis::DataSet::getRaster(std::size_t /*i*/) const
 {
   return std::auto_ptr<te::rst::Raster>(0);
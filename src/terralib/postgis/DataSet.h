@@ -140,6 +140,8 @@ namespace te
 
         std::auto_ptr<te::gm::Geometry> getGeometry(std::size_t i) const;
 
+        bool getGeometryView(std::size_t i, te::gm::WKBView& view) const;
+
         std::auto_ptr<te::rst::Raster> getRaster(std::size_t i) const;
 
         std::auto_ptr<te::dt::DateTime> getDateTime(std::size_t i) const; 
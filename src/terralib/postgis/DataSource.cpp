@@ -61,6 +61,8 @@
 
 // STL
 #include <cassert>
+#include <cstdlib>
+#include <map>
 #include <memory>
 
 // Boost
@@ -75,7 +77,8 @@ te::pgis::DataSource::DataSource(const std::string& connInfo)
   m_pool(0),
   m_geomTypeOid(0),
   m_rasterTypeOid(0),
-  m_timeIsInteger(true)
+  m_timeIsInteger(true),
+  m_cursorFetchSize(PGIS_DEFAULT_CURSOR_FETCH_SIZE)
 {
   m_pool = new ConnectionPool(this);
 }
@@ -85,7 +88,8 @@ te::pgis::DataSource::DataSource(const te::core::URI& uri)
     m_pool(0),
     m_geomTypeOid(0),
     m_rasterTypeOid(0),
-    m_timeIsInteger(true)
+    m_timeIsInteger(true),
+    m_cursorFetchSize(PGIS_DEFAULT_CURSOR_FETCH_SIZE)
 {
   m_pool = new ConnectionPool(this);
 }
@@ -127,6 +131,16 @@ void te::pgis::DataSource::setTimeAsInteger(bool timeIsInteger)
   m_timeIsInteger = timeIsInteger;
 }
 
+std::size_t te::pgis::DataSource::getCursorFetchSize() const
+{
+  return m_cursorFetchSize;
+}
+
+void te::pgis::DataSource::setCursorFetchSize(std::size_t size)
+{
+  m_cursorFetchSize = size;
+}
+
 void te::pgis::DataSource::open()
 {
   // Assure we are in a closed state
@@ -134,6 +148,10 @@ void te::pgis::DataSource::open()
 
   m_pool->initialize();
 
+  std::map<std::string, std::string> kvp = te::core::Expand(getConnectionInfo().query());
+  std::map<std::string, std::string>::const_iterator it = kvp.find("PG_CURSOR_FETCH_SIZE");
+  m_cursorFetchSize = (it != kvp.end() && !it->second.empty()) ? atoi(it->second.c_str()) : PGIS_DEFAULT_CURSOR_FETCH_SIZE;
+
   std::auto_ptr<te::da::DataSourceTransactor> t = getTransactor();
   te::pgis::Transactor* pgt = static_cast<te::pgis::Transactor*>(t.get());
 
@@ -230,7 +248,7 @@ void te::pgis::DataSource::create(const std::string& connInfo)
   dsPGIS->execute(sql);
   
   // check if new database has postgis extension enabled
-  std::auto_ptr<te::da::DataSet> result(dsPGIS->query("SELECT extname, extversion FROM pg_extension WHERE extname = 'postgis'"));
+  std::auto_ptr<te::da::DataSet> result(dsPGIS->query("SELECT extname, extversion FROM pg_extension WHERE extname = 'postgis'", te::common::RANDOM));
 
   if (!result->moveNext())
   {
@@ -287,7 +305,7 @@ bool te::pgis::DataSource::exists(const std::string& connInfo)
   sql += it->second;
   sql += "'";
 
-  std::auto_ptr<te::da::DataSet> database(ds->query(sql));
+  std::auto_ptr<te::da::DataSet> database(ds->query(sql, te::common::RANDOM));
 
   ds->close();
 
@@ -302,7 +320,7 @@ std::vector<std::string> te::pgis::DataSource::getDataSourceNames(const std::str
 
   std::string sql("SELECT datname FROM pg_database");
 
-  std::auto_ptr<te::da::DataSet> dataset(ds->query(sql));
+  std::auto_ptr<te::da::DataSet> dataset(ds->query(sql, te::common::RANDOM));
 
   std::vector<std::string> dataSourceNames;
 
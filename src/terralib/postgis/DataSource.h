@@ -78,6 +78,26 @@ namespace te
 
         void setTimeAsInteger(bool timeIsInteger);
 
+        /*!
+          \brief It returns the number of rows retrieved by each fetch of a forward-only dataset.
+
+          \return The cursor fetch size. If 0, forward-only datasets are not streamed.
+
+          \note PostGIS driver extended method.
+        */
+        std::size_t getCursorFetchSize() const;
+
+        /*!
+          \brief It sets the number of rows retrieved by each fetch of a forward-only dataset.
+
+          \param size The cursor fetch size. If 0 (the default), forward-only datasets will be fully materialized.
+
+          \note The value informed by the PG_CURSOR_FETCH_SIZE connection parameter is reloaded when the data source is opened.
+
+          \note PostGIS driver extended method.
+        */
+        void setCursorFetchSize(std::size_t size);
+
         /*!
           \brief It opens the connection(s) to the PostgreSQL database server.
 
@@ -162,6 +182,7 @@ namespace te
         unsigned int                        m_rasterTypeOid;  //!< PostGIS Raster type OID.
         std::string                         m_currentSchema;  //!< The default schema used when no one is provided.
         bool                                m_timeIsInteger;  //!< It indicates if the postgis stores, internally, time and timestamp as an integer.
+        std::size_t                         m_cursorFetchSize;  //!< The number of rows retrieved by each fetch of a forward-only dataset (0 disables the cursors).
 
         static te::da::DataSourceCapabilities sm_capabilities;  //!< PostGIS capabilities.
         static te::da::SQLDialect* sm_dialect;                  //!< PostGIS SQL dialect.
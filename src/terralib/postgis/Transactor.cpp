@@ -50,6 +50,8 @@
 #include "../geometry/Geometry.h"
 #include "Connection.h"
 #include "ConnectionPool.h"
+#include "CopyWriter.h"
+#include "CursorDataSet.h"
 #include "DataSource.h"
 #include "DataSet.h"
 #include "Exception.h"
@@ -134,12 +136,7 @@ std::auto_ptr<te::da::DataSet> te::pgis::Transactor::getDataSet(const std::strin
    std::auto_ptr<std::string> sql(new std::string("SELECT * FROM "));
    *sql += name;
 
-  PGresult* result = m_conn->query(*sql);
-
-  std::vector<int> ptypes;
-  Convert2TerraLib(result, m_ds->getGeomTypeId(), m_ds->getRasterTypeId(), ptypes);
-
-  return std::auto_ptr<te::da::DataSet>(new DataSet(result, ptypes, m_ds->isTimeAnInteger()));
+  return createDataSet(*sql, travType);
 }
 
 std::auto_ptr<te::da::DataSet> te::pgis::Transactor::getDataSet(const std::string& name,
@@ -167,12 +164,7 @@ std::auto_ptr<te::da::DataSet> te::pgis::Transactor::getDataSet(const std::strin
 
   Convert2PostGIS(e, gp->getSRID(), sql);
 
-  PGresult* result = m_conn->query(sql);
-
-  std::vector<int> ptypes;
-  Convert2TerraLib(result, m_ds->getGeomTypeId(), m_ds->getRasterTypeId(), ptypes);
-
-  return std::auto_ptr<te::da::DataSet>(new DataSet(result, ptypes, m_ds->isTimeAnInteger()));
+  return createDataSet(sql, travType);
 }
 
 std::auto_ptr<te::da::DataSet> te::pgis::Transactor::getDataSet(const std::string& name,
@@ -200,12 +192,7 @@ std::auto_ptr<te::da::DataSet> te::pgis::Transactor::getDataSet(const std::strin
   sql += propertyName;
   sql += ")";
 
-  PGresult* result = m_conn->query(sql);
-
-  std::vector<int> ptypes;
-  Convert2TerraLib(result, m_ds->getGeomTypeId(), m_ds->getRasterTypeId(), ptypes);
-
-  return std::auto_ptr<te::da::DataSet>(new DataSet(result, ptypes, m_ds->isTimeAnInteger()));
+  return createDataSet(sql, travType);
 }
 
 std::auto_ptr<te::da::DataSet> te::pgis::Transactor::query(const te::da::Select& q,
@@ -226,7 +213,24 @@ std::auto_ptr<te::da::DataSet> te::pgis::Transactor::query(const std::string& qu
                                                            bool isConnected,
                                                            const te::common::AccessPolicy)
 {
-  PGresult* result = m_conn->query(query);
+  return createDataSet(query, travType);
+}
+
+std::auto_ptr<te::da::DataSet> te::pgis::Transactor::createDataSet(const std::string& sql,
+                                                                   te::common::TraverseType travType)
+{
+  if((travType == te::common::FORWARDONLY) && (m_ds->getCursorFetchSize() != 0))
+  {
+// inside a transaction the cursor must see its changes: otherwise it runs in a connection of its own
+    if(m_isInTransaction)
+      return std::auto_ptr<te::da::DataSet>(new CursorDataSet(m_ds, m_conn, false, sql, m_ds->getCursorFetchSize()));
+
+    Connection* conn = m_ds->getConnPool()->getConnection();
+
+    return std::auto_ptr<te::da::DataSet>(new CursorDataSet(m_ds, conn, true, sql, m_ds->getCursorFetchSize()));
+  }
+
+  PGresult* result = m_conn->query(sql);
 
   std::vector<int> ptypes;
   Convert2TerraLib(result, m_ds->getGeomTypeId(), m_ds->getRasterTypeId(), ptypes);
@@ -267,7 +271,7 @@ boost::int64_t te::pgis::Transactor::getLastGeneratedId()
 {
   std::string sql("SELECT lastval()");
 
-  std::auto_ptr<te::da::DataSet> dataset = query(sql);
+  std::auto_ptr<te::da::DataSet> dataset = query(sql, te::common::RANDOM);
 
   if (dataset->size() != 1)
     throw Exception(TE_TR("Error getting last generated id."));
@@ -298,7 +302,7 @@ std::vector<std::string> te::pgis::Transactor::getDataSetNames()
                   "ORDER BY pg_class.relname"
                   );
 
-  std::auto_ptr<te::da::DataSet> datasetInfo = query(sql);
+  std::auto_ptr<te::da::DataSet> datasetInfo = query(sql, te::common::RANDOM);
 
   while(datasetInfo->moveNext())
   {
@@ -1164,7 +1168,7 @@ std::auto_ptr<te::da::Index> te::pgis::Transactor::getIndex(const std::string& d
                   "AND pg_index.indrelid = ");
   sql += te::common::Convert2String(dtid);
 
-  std::auto_ptr<te::da::DataSet> idxInfo = query(sql);
+  std::auto_ptr<te::da::DataSet> idxInfo = query(sql, te::common::RANDOM);
 
   while(idxInfo->moveNext())
   {
@@ -1216,7 +1220,7 @@ std::vector<std::string> te::pgis::Transactor::getIndexNames(const std::string&
                   "AND pg_index.indrelid = ");
   sql += te::common::Convert2String(dtid);
 
-  std::auto_ptr<te::da::DataSet> idxInfo = query(sql);
+  std::auto_ptr<te::da::DataSet> idxInfo = query(sql, te::common::RANDOM);
 
   while(idxInfo->moveNext())
   {
@@ -1313,7 +1317,7 @@ std::auto_ptr<te::da::Sequence> te::pgis::Transactor::getSequence(const std::str
                   "AND c.relnamespace = n.oid "
                   "AND n.nspname NOT IN ('information_schema', 'pg_toast', 'pg_temp_1', 'pg_catalog')");
 
-  std::auto_ptr<te::da::DataSet> seqNamesInfo = query(sql);
+  std::auto_ptr<te::da::DataSet> seqNamesInfo = query(sql, te::common::RANDOM);
 
   while(seqNamesInfo->moveNext())
   {
@@ -1325,7 +1329,7 @@ std::auto_ptr<te::da::Sequence> te::pgis::Transactor::getSequence(const std::str
     std::string sql("SELECT * FROM ");
     sql += seqName;
 
-    std::auto_ptr<te::da::DataSet> result(query(sql));
+    std::auto_ptr<te::da::DataSet> result(query(sql, te::common::RANDOM));
 
     if(result->moveNext())
     {
@@ -1360,7 +1364,7 @@ std::vector<std::string> te::pgis::Transactor::getSequenceNames()
                   "AND c.relnamespace = n.oid "
                   "AND n.nspname NOT IN ('information_schema', 'pg_toast', 'pg_temp_1', 'pg_catalog')");
 
-  std::auto_ptr<te::da::DataSet> seqNamesInfo = query(sql);
+  std::auto_ptr<te::da::DataSet> seqNamesInfo = query(sql, te::common::RANDOM);
 
   while(seqNamesInfo->moveNext())
   {
@@ -1492,7 +1496,7 @@ std::auto_ptr<te::gm::Envelope> te::pgis::Transactor::getExtent(const std::strin
 
 std::size_t te::pgis::Transactor::getNumberOfItems(const std::string& datasetName)
 {
-  std::auto_ptr<te::da::DataSet> result = getDataSet(datasetName);
+  std::auto_ptr<te::da::DataSet> result = getDataSet(datasetName, te::common::RANDOM);
   return result->size();
 }
 
@@ -1672,6 +1676,53 @@ void te::pgis::Transactor::add(const std::string& datasetName,
   if(limit == 0)
     limit = std::string::npos;
 
+// the bulk insert path streams the rows through a binary COPY, when the column types allow it
+  std::map<std::string, std::string>::const_iterator itBulk = options.find("BULK_INSERT");
+
+  if((itBulk != options.end()) && (te::common::Convert2UCase(itBulk->second) == "TRUE"))
+  {
+    std::string names = te::da::GetSQLValueNames(d);
+
+    std::string sql  = "SELECT ";
+                sql += names.substr(1, names.length() - 2);
+                sql += " FROM ";
+                sql += datasetName;
+                sql += " LIMIT 0";
+
+    PGresult* result = m_conn->query(sql);
+
+    std::vector<unsigned int> columnTypes;
+
+    for(int i = 0; i < PQnfields(result); ++i)
+      columnTypes.push_back(PQftype(result, i));
+
+    PQclear(result);
+
+    if(CopyWriter::isSupported(d, columnTypes, m_ds->getGeomTypeId()))
+    {
+      te::da::ScopedTransaction st(*this);
+
+      CopyWriter writer(m_conn, m_ds->getGeomTypeId());
+
+      writer.begin(datasetName, d, columnTypes);
+
+      std::size_t nProcessedRows = 0;
+
+      while(d->moveNext() && (nProcessedRows != limit))
+      {
+        writer.write(d);
+
+        ++nProcessedRows;
+      }
+
+      writer.end();
+
+      st.commit();
+
+      return;
+    }
+  }
+
 // create a prepared statement
   std::string sql  = "INSERT INTO ";
               sql += datasetName;
@@ -1883,7 +1934,7 @@ unsigned int te::pgis::Transactor::getGeomTypeId()
 {
   std::string sql("SELECT oid FROM pg_type WHERE typname = 'geometry'");
 
-  std::auto_ptr<te::da::DataSet> result(query(sql));
+  std::auto_ptr<te::da::DataSet> result(query(sql, te::common::RANDOM));
 
   unsigned int id = 0;
 
@@ -1897,7 +1948,7 @@ unsigned int te::pgis::Transactor::getRasterTypeId()
 {
   std::string sql("SELECT oid FROM pg_type WHERE typname = 'raster'");
 
-  std::auto_ptr<te::da::DataSet> result(query(sql));
+  std::auto_ptr<te::da::DataSet> result(query(sql, te::common::RANDOM));
 
   unsigned int id = 0;
 
@@ -1911,7 +1962,7 @@ void te::pgis::Transactor::getDatabaseInfo(std::string& currentSchema)
 {
   std::string sql("SELECT current_schema()");
 
-  std::auto_ptr<te::da::DataSet> result(query(sql));
+  std::auto_ptr<te::da::DataSet> result(query(sql, te::common::RANDOM));
 
   if(!result->moveNext())
     Exception(TE_TR("Could not get information about PostgreSQL database backend!"));
@@ -1936,7 +1987,7 @@ void te::pgis::Transactor::getGeometryInfo(const std::string& datasetName, te::g
   sql += gp->getName();
   sql += "'";
 
-  std::auto_ptr<te::da::DataSet> result(query(sql));
+  std::auto_ptr<te::da::DataSet> result(query(sql, te::common::RANDOM));
 
   if(result->moveNext())
   {
@@ -1974,7 +2025,7 @@ void te::pgis::Transactor::getRasterInfo(const std::string& datasetName, te::rst
   sql += rp->getName();
   sql += "'";
 
-  std::auto_ptr<te::da::DataSet> result(query(sql));
+  std::auto_ptr<te::da::DataSet> result(query(sql, te::common::RANDOM));
 
   if(result->moveNext())
   {
@@ -2082,7 +2133,7 @@ unsigned int te::pgis::Transactor::getDataSetId(const std::string& tableName)
   sql += te::common::Convert2LCase(sname);
   sql += "'";
 
-  std::auto_ptr<te::da::DataSet> result(query(sql));
+  std::auto_ptr<te::da::DataSet> result(query(sql, te::common::RANDOM));
 
   if(result->moveNext() == false)
     throw Exception(TE_TR("Could not find the table oid!"));
@@ -2101,7 +2152,7 @@ std::string te::pgis::Transactor::getDataSetName(unsigned int id)
 
   sql += te::common::Convert2String(id);
 
-  std::auto_ptr<te::da::DataSet> result(query(sql));
+  std::auto_ptr<te::da::DataSet> result(query(sql, te::common::RANDOM));
 
   if(result->moveNext() == false)
     throw Exception(TE_TR("Could not find the dataset name!"));
@@ -2127,7 +2178,7 @@ std::auto_ptr<te::da::DataSet> te::pgis::Transactor::getPropertiesInfo(const std
          " AND a.attnum > 0"
          " ORDER BY a.attnum";
 
-  return query(sql);
+  return query(sql, te::common::RANDOM);
 }
 
 void te::pgis::Transactor::getPropertyId(te::dt::Property* p)
@@ -2143,7 +2194,7 @@ void te::pgis::Transactor::getPropertyId(te::dt::Property* p)
   sql += te::common::Convert2LCase(p->getName());
   sql += "' ";
 
-  std::auto_ptr<te::da::DataSet> result(query(sql));
+  std::auto_ptr<te::da::DataSet> result(query(sql, te::common::RANDOM));
 
   if(result->moveNext() == false)
     throw Exception(TE_TR("Could not find the property ID!"));
@@ -2165,7 +2216,7 @@ std::auto_ptr<te::dt::Property> te::pgis::Transactor::getProperty(unsigned int p
               sql += " AND a.attisdropped = false"
                      " AND a.attnum > 0";
 
-  std::auto_ptr<te::da::DataSet> result(query(sql));
+  std::auto_ptr<te::da::DataSet> result(query(sql, te::common::RANDOM));
 
   std::auto_ptr<te::dt::Property> p(0);
 
@@ -2207,7 +2258,7 @@ std::auto_ptr<te::da::DataSet> te::pgis::Transactor::getConstraints(const std::s
     sql += "'";
   }
 
-  return query(sql);
+  return query(sql, te::common::RANDOM);
 }
 
 void te::pgis::Transactor::getConstraints(te::da::DataSetType* dt)
@@ -2221,7 +2272,7 @@ void te::pgis::Transactor::getConstraints(te::da::DataSetType* dt)
                   "AND c.conrelid = ");
   sql += te::common::Convert2String(dtid);
 
-  std::auto_ptr<te::da::DataSet> cInfo = query(sql);
+  std::auto_ptr<te::da::DataSet> cInfo = query(sql, te::common::RANDOM);
 
   while(cInfo->moveNext())
   {
@@ -2383,7 +2434,7 @@ void te::pgis::Transactor::getIndexes(te::da::DataSetType* dt)
                   "AND pg_index.indrelid = ");
   sql += te::common::Convert2String(dtid);
 
-  std::auto_ptr<te::da::DataSet> idxInfo = query(sql);
+  std::auto_ptr<te::da::DataSet> idxInfo = query(sql, te::common::RANDOM);
 
   while(idxInfo->moveNext())
   {
@@ -2441,7 +2492,7 @@ std::vector<te::da::Sequence*> te::pgis::Transactor::getSequences()
                   "AND c.relnamespace = n.oid "
                   "AND n.nspname NOT IN ('information_schema', 'pg_toast', 'pg_temp_1', 'pg_catalog')");
 
-  std::auto_ptr<te::da::DataSet> seqNamesInfo = query(sql);
+  std::auto_ptr<te::da::DataSet> seqNamesInfo = query(sql, te::common::RANDOM);
 
   while(seqNamesInfo->moveNext())
   {
@@ -2456,7 +2507,7 @@ std::vector<te::da::Sequence*> te::pgis::Transactor::getSequences()
     std::string sql("SELECT * FROM ");
     sql += seqName;
 
-    std::auto_ptr<te::da::DataSet> result(query(sql));
+    std::auto_ptr<te::da::DataSet> result(query(sql, te::common::RANDOM));
 
     if(result->moveNext() == false)
       throw Exception((boost::format(TE_TR("There is no information about the sequence \"%1%\"!")) % seqName).str());
@@ -463,6 +463,25 @@ namespace te
         */
         std::vector<te::da::Sequence*> getSequences();
 
+        /*!
+          \brief It runs the given query and wraps its result in a dataset.
+
+          If the traverse type is FORWARDONLY and the data source has a cursor fetch size
+          the rows are streamed through a server-side cursor (see CursorDataSet).
+          Otherwise the whole result is materialized in a random access dataset.
+
+          \param sql      The SQL query.
+          \param travType The traverse type requested by the caller.
+
+          \return The dataset. The caller will take its ownership.
+
+          \exception Exception It throws an exception if the query execution fails.
+
+          \note PostGIS driver extended method.
+        */
+        std::auto_ptr<te::da::DataSet> createDataSet(const std::string& sql,
+                                                     te::common::TraverseType travType);
+
       private:
 
         DataSource* m_ds;       //!< The PostGIS data source associated to this transactor.
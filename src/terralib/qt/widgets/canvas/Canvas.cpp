@@ -410,8 +410,13 @@ void te::qt::widgets::Canvas::draw(const te::gm::Geometry* geom)
 
 void te::qt::widgets::Canvas::draw(const te::gm::Point* point)
 {
-  m_pt.setX(point->getX());
-  m_pt.setY(point->getY());
+  drawPoint(point->getX(), point->getY());
+}
+
+void te::qt::widgets::Canvas::drawPoint(const double& x, const double& y)
+{
+  m_pt.setX(x);
+  m_pt.setY(y);
 
   if(m_ptImg != 0)
   {
@@ -656,6 +661,19 @@ void te::qt::widgets::Canvas::draw(const te::gm::Polygon* poly)
     path.addPolygon(qpol);
   }
 
+  fillPath(path, *poly->getMBR());
+
+  // draw contour
+  if(!m_erase && m_polyContourPen.brush().style() == Qt::TexturePattern)
+  {
+    std::vector<te::gm::LinearRing*>::iterator it;
+    for(it = rings.begin(); it != rings.end(); ++it)
+      drawContour(*it);
+  }
+}
+
+void te::qt::widgets::Canvas::fillPath(const QPainterPath& path, const te::gm::Envelope& mbr)
+{
   if(m_erase)
   {
     m_painter->setPen(Qt::NoPen);
@@ -668,8 +686,7 @@ void te::qt::widgets::Canvas::draw(const te::gm::Polygon* poly)
     m_painter->setPen(Qt::NoPen);
     if(m_polyImage && m_polyColor.alpha() != 255)
     {
-      const te::gm::Envelope* envelope = poly->getMBR();
-      QRectF recf(envelope->m_llx, envelope->m_lly, envelope->getWidth(), envelope->getHeight());
+      QRectF recf(mbr.m_llx, mbr.m_lly, mbr.getWidth(), mbr.getHeight());
       QPointF pc = m_matrix.map(recf.center());
       int transx = pc.toPoint().x();
       int transy = pc.toPoint().y();
@@ -713,14 +730,6 @@ void te::qt::widgets::Canvas::draw(const te::gm::Polygon* poly)
       m_painter->setPen(m_polyContourPen);
 
     m_painter->drawPath(path);
-
-    // draw contour
-    if(m_polyContourPen.brush().style() == Qt::TexturePattern)
-    {
-      std::vector<te::gm::LinearRing*>::iterator it;
-      for(it = rings.begin(); it != rings.end(); ++it)
-        drawContour(*it);
-    }
   }
 }
 
@@ -938,6 +947,94 @@ void te::qt::widgets::Canvas::draw(const te::gm::MultiSurface* g)
     draw(g->getGeometryN(i));
 }
 
+void te::qt::widgets::Canvas::draw(const te::gm::WKBView& view)
+{
+  const std::size_t nParts = view.getNumParts();
+
+  for(std::size_t p = 0; p != nParts; ++p)
+  {
+    const std::size_t nRings = view.getNumRings(p);
+
+    std::size_t nPoints = 0;
+
+    switch(view.getPartType(p))
+    {
+      case te::gm::PointType:
+        {
+          const te::gm::Coord2D* c = view.getRing(p, 0, nPoints);
+          drawPoint(c->x, c->y);
+        }
+      break;
+
+      case te::gm::LineStringType:
+        {
+          const te::gm::Coord2D* coords = view.getRing(p, 0, nPoints);
+
+          if(nPoints == 0)
+            break;
+
+          if(m_lnPen.brush().style() != Qt::TexturePattern)
+          {
+            QPolygonF qpol(static_cast<int>(nPoints));
+            memcpy(&(qpol[0]), coords, 16 * nPoints);
+            QPen pen(m_lnPen);
+            pen.setColor(m_lnColor);
+            m_painter->setPen(pen);
+            m_painter->setBrush(Qt::NoBrush);
+            m_painter->drawPolyline(qpol);
+          }
+          else
+          {
+            // line patterns are drawn segment by segment: reuse the geometry code
+            te::gm::LineString line(nPoints, te::gm::LineStringType);
+            memcpy(line.getCoordinates(), coords, 16 * nPoints);
+            draw(&line);
+          }
+        }
+      break;
+
+      case te::gm::PolygonType:
+        {
+          if(nRings == 0)
+            break;
+
+          QPainterPath path;
+
+          for(std::size_t r = 0; r != nRings; ++r)
+          {
+            const te::gm::Coord2D* coords = view.getRing(p, r, nPoints);
+
+            if(nPoints == 0)
+              continue;
+
+            QPolygonF qpol(static_cast<int>(nPoints));
+            memcpy(&(qpol[0]), coords, 16 * nPoints);
+            path.addPolygon(qpol);
+          }
+
+          fillPath(path, view.getPartMBR(p));
+
+          // draw contour
+          if(!m_erase && m_polyContourPen.brush().style() == Qt::TexturePattern)
+          {
+            for(std::size_t r = 0; r != nRings; ++r)
+            {
+              const te::gm::Coord2D* coords = view.getRing(p, r, nPoints);
+
+              te::gm::LineString ring(nPoints, te::gm::LineStringType);
+              memcpy(ring.getCoordinates(), coords, 16 * nPoints);
+              drawContour(&ring);
+            }
+          }
+        }
+      break;
+
+      default:
+      break;
+    }
+  }
+}
+
 void te::qt::widgets::Canvas::save(const char* fileName, te::map::ImageType t, int quality, int /*fg*/) const
 {
   int devType = m_painter->device()->devType();
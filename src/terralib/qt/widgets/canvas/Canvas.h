@@ -137,6 +137,8 @@ namespace te
 
           void draw(const te::gm::MultiSurface* g);
 
+          void draw(const te::gm::WKBView& view);
+
           void save(const char* fileName, te::map::ImageType t, int quality = 75, int fg = 0) const;
 
           char* getImage(te::map::ImageType t, std::size_t& size, int quality = 75, int fg = 0) const;
@@ -481,6 +483,19 @@ namespace te
            */
           void drawContour(const te::gm::LineString* line);
 
+          /*!
+            \brief It draws a point using the current point style.
+           */
+          void drawPoint(const double& x, const double& y);
+
+          /*!
+            \brief It fills the polygon given by the path using the current polygon style.
+
+            \param path The polygon rings.
+            \param mbr  The polygon bounding box, used to align the fill pattern.
+           */
+          void fillPath(const QPainterPath& path, const te::gm::Envelope& mbr);
+
 
           //@}
 
@@ -30,6 +30,13 @@ te::qt::widgets::DrawThread::~DrawThread()
 }
 
 void te::qt::widgets::DrawThread::run()
+{
+  draw();
+
+  emit finished();
+}
+
+void te::qt::widgets::DrawThread::draw()
 {
   m_finished = false;
 
@@ -61,8 +68,6 @@ void te::qt::widgets::DrawThread::run()
   {
     m_errorMessage = QString(tr("The layer") + " %1 " + tr("could not be drawn!")).arg(m_layer->getTitle().c_str());
   }
-
-  emit finished();
 }
 
 bool te::qt::widgets::DrawThread::hasFinished() const
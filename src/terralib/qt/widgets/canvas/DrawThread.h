@@ -76,6 +76,11 @@ namespace te
 
         void finished();
 
+      protected:
+
+        /*! \brief It draws the layer in the paint device, without emitting the finished signal. */
+        void draw();
+
       protected:
 
         QPaintDevice* m_device;
@@ -27,17 +27,25 @@
 #include "../../../common/STLUtils.h"
 #include "../../../maptools/Utils.h"
 #include "../../../maptools/AbstractLayer.h"
+#include "../../../maptools/GeometryLODCacheManager.h"
 #include "../../../se/Style.h"
 #include "MultiThreadMapDisplay.h"
 #include "Canvas.h"
 #include "DrawThread.h"
 #include "ThreadManager.h"
+#include "TileCache.h"
+#include "TileDrawThread.h"
 
 // Qt
 #include <QApplication>
 #include <QImage>
 #include <QPainter>
 
+// STL
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
 void RemoveImage(const std::string lId, std::map<std::string, QImage*>& imgs)
 {
   std::map<std::string, QImage*>::iterator it = imgs.find(lId);
@@ -59,7 +67,8 @@ te::qt::widgets::MultiThreadMapDisplay::MultiThreadMapDisplay(const QSize& size,
   : te::qt::widgets::MapDisplay(size, parent, f),
     m_showFeedback(showFeedback),
     m_synchronous(false),
-    m_tmger(0)
+    m_tmger(0),
+    m_tileCache(0)
 {
   setAttribute(Qt::WA_OpaquePaintEvent, true);
 }
@@ -68,7 +77,8 @@ te::qt::widgets::MultiThreadMapDisplay::MultiThreadMapDisplay(QWidget* parent, c
 : te::qt::widgets::MapDisplay(parent, f),
 m_showFeedback(showFeedback),
 m_synchronous(false),
-m_tmger(0)
+m_tmger(0),
+m_tileCache(0)
 {
   setAttribute(Qt::WA_OpaquePaintEvent, true);
 }
@@ -167,6 +177,9 @@ void te::qt::widgets::MultiThreadMapDisplay::refresh(bool redraw)
       QImage* img = new QImage(size(), QImage::Format_ARGB32_Premultiplied);
       imgs[lId] = img;
 
+      if(m_tileCache != 0 && drawTiles((*it).get(), img, scale))
+        continue;
+
       DrawThread* thread = new DrawThread(imgs[lId], (*it).get(), &m_extent, m_backgroundColor, m_srid, scale, m_hAlign, m_vAlign);
       m_threads.push_back(thread);
     }
@@ -197,6 +210,10 @@ void te::qt::widgets::MultiThreadMapDisplay::refresh(bool redraw)
 
     connect(m_tmger, SIGNAL(finished()), SLOT(onRenderingFinished()));
 
+    // show the cached tiles while the missing ones are drawn
+    if(m_tileCache != 0)
+      showFeedback();
+
     m_tmger->run();
   }
   else
@@ -218,6 +235,16 @@ void te::qt::widgets::MultiThreadMapDisplay::setSynchronous(bool on)
 
 void te::qt::widgets::MultiThreadMapDisplay::updateLayer(te::map::AbstractLayerPtr layer, bool redraw)
 {
+  if(m_tileCache != 0)
+  {
+    if(m_isDrawing)
+      onDrawCanceled();
+
+    m_tileCache->invalidate(layer->getId());
+  }
+
+  te::map::GeometryLODCacheManager::getInstance().remove(layer->getId());
+
   RemoveImage(layer.get(), m_images);
 
   if(redraw)
@@ -226,8 +253,16 @@ void te::qt::widgets::MultiThreadMapDisplay::updateLayer(te::map::AbstractLayerP
 
 void te::qt::widgets::MultiThreadMapDisplay::updateLayer(std::vector<te::map::AbstractLayerPtr> layers, bool redraw)
 {
+  if(m_tileCache != 0 && m_isDrawing)
+    onDrawCanceled();
+
   for (std::size_t i = 0; i < layers.size(); ++i)
   {
+    if(m_tileCache != 0)
+      m_tileCache->invalidate(layers[i]->getId());
+
+    te::map::GeometryLODCacheManager::getInstance().remove(layers[i]->getId());
+
     RemoveImage(layers[i].get(), m_images);
   }
 
@@ -249,6 +284,19 @@ void te::qt::widgets::MultiThreadMapDisplay::resizeEvent(QResizeEvent* e)
   MapDisplay::resizeEvent(e);
 }
 
+void te::qt::widgets::MultiThreadMapDisplay::setTileCache(TileCache* cache)
+{
+  if(m_isDrawing)
+    onDrawCanceled();
+
+  m_tileCache = cache;
+}
+
+te::qt::widgets::TileCache* te::qt::widgets::MultiThreadMapDisplay::getTileCache() const
+{
+  return m_tileCache;
+}
+
 
 void te::qt::widgets::MultiThreadMapDisplay::updateTransform()
 {
@@ -284,6 +332,92 @@ void te::qt::widgets::MultiThreadMapDisplay::updateTransform()
   m_matrix.translate(-m_extent.m_llx, -m_extent.m_ury);
 }
 
+bool te::qt::widgets::MultiThreadMapDisplay::drawTiles(te::map::AbstractLayer* layer, QImage* img, double scale)
+{
+  if(!m_extent.isValid() || width() <= 0)
+    return false;
+
+  const double res = (m_extent.m_urx - m_extent.m_llx) / static_cast<double>(width());
+
+  if(res <= 0.0)
+    return false;
+
+  const int tileSize = TileCache::GetTileSize();
+
+  TileKey key;
+  key.m_layerId = layer->getId();
+  key.m_styleHash = TileCache::GetStyleHash(layer);
+  key.m_srid = m_srid;
+  key.m_zoom = TileCache::GetZoomLevel(res);
+
+  const double tileWidth = TileCache::GetResolution(key.m_zoom) * tileSize;
+
+  const double fx0 = std::floor(m_extent.m_llx / tileWidth);
+  const double fy0 = std::floor(m_extent.m_lly / tileWidth);
+  const double fx1 = std::ceil(m_extent.m_urx / tileWidth) - 1.0;
+  const double fy1 = std::ceil(m_extent.m_ury / tileWidth) - 1.0;
+
+  // the tile indexes must fit in an int
+  if(fx0 < INT_MIN || fy0 < INT_MIN || fx1 > INT_MAX || fy1 > INT_MAX)
+    return false;
+
+  const int x0 = static_cast<int>(fx0);
+  const int y0 = static_cast<int>(fy0);
+  const int x1 = static_cast<int>(fx1);
+  const int y1 = static_cast<int>(fy1);
+
+  img->fill(Qt::transparent);
+
+  QPainter painter(img);
+
+  painter.setCompositionMode(QPainter::CompositionMode_Source);
+
+  // the bounds of the missing tiles
+  int mx0 = INT_MAX;
+  int my0 = INT_MAX;
+  int mx1 = INT_MIN;
+  int my1 = INT_MIN;
+
+  QImage tile;
+
+  for(int y = y0; y <= y1; ++y)
+  {
+    key.m_y = y;
+
+    for(int x = x0; x <= x1; ++x)
+    {
+      key.m_x = x;
+
+      if(m_tileCache->get(key, tile))
+      {
+        painter.drawImage(qRound((x * tileWidth - m_extent.m_llx) / res), qRound((m_extent.m_ury - (y + 1) * tileWidth) / res), tile);
+
+        continue;
+      }
+
+      mx0 = std::min(mx0, x);
+      my0 = std::min(my0, y);
+      mx1 = std::max(mx1, x);
+      my1 = std::max(my1, y);
+    }
+  }
+
+  if(mx0 > mx1)
+    return true;
+
+  key.m_x = mx0;
+  key.m_y = my0;
+
+  QPoint pos(qRound((mx0 * tileWidth - m_extent.m_llx) / res), qRound((m_extent.m_ury - (my1 + 1) * tileWidth) / res));
+
+  TileDrawThread* thread = new TileDrawThread(m_tileCache, layer, key, mx1 - mx0 + 1, my1 - my0 + 1, img, pos,
+                                              m_backgroundColor, scale, m_hAlign, m_vAlign);
+
+  m_threads.push_back(thread);
+
+  return true;
+}
+
 void te::qt::widgets::MultiThreadMapDisplay::showFeedback()
 {
   m_displayPixmap->fill(m_backgroundColor);
@@ -313,6 +447,15 @@ void te::qt::widgets::MultiThreadMapDisplay::onDrawLayerFinished(const int& inde
 
 void te::qt::widgets::MultiThreadMapDisplay::onRenderingFinished()
 {
+  // fill the holes left by the missing tiles
+  for(std::vector<QRunnable*>::iterator it = m_threads.begin(); it != m_threads.end(); ++it)
+  {
+    TileDrawThread* th = dynamic_cast<TileDrawThread*>((DrawThread*)*it);
+
+    if(th != 0 && th->hasFinished())
+      th->compose();
+  }
+
   showFeedback();
 
   m_isDrawing = false;
@@ -47,6 +47,7 @@ namespace te
     namespace widgets
     {
       class ThreadManager;
+      class TileCache;
 //      class ScopedCursor;
 
       /*!
@@ -115,10 +116,36 @@ namespace te
 
           void resizeEvent(QResizeEvent* e);
 
+          /*!
+            \brief It sets the cache of rendered tiles used to draw the layers.
+
+            When there is a tile cache, each layer is drawn by composing its cached tiles,
+            which is done immediately, and the missing tiles are drawn in background and stored in the cache.
+
+            \param cache The tile cache, or NULL to draw the whole map area of the layers. The map display does not take its ownership.
+
+            \note The tiles of a layer are invalidated when it is updated (see updateLayer).
+          */
+          void setTileCache(TileCache* cache);
+
+          /*! \brief It returns the cache of rendered tiles used to draw the layers, or NULL if there is no one. */
+          TileCache* getTileCache() const;
+
         private:
 
           void updateTransform();
 
+          /*!
+            \brief It composes the cached tiles of a layer and creates a thread to draw the missing ones.
+
+            \param layer The layer to be drawn.
+            \param img   The image where the layer will be drawn.
+            \param scale The map scale.
+
+            \return False if the map extent can not be split in tiles.
+          */
+          bool drawTiles(te::map::AbstractLayer* layer, QImage* img, double scale);
+
         protected slots:
 
           void showFeedback(const QImage&) { }
@@ -179,6 +206,7 @@ namespace te
           bool m_synchronous;                                   //!< A flag that indicates if the map display is  synchronous or asynchronous.
           
           ThreadManager* m_tmger;
+          TileCache* m_tileCache;                               //!< The cache of rendered tiles, if any.
           QCursor m_oldCursor;
 //          std::auto_ptr<ScopedCursor> m_cursor;
       };
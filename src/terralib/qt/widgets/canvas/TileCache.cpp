@@ -0,0 +1,347 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+  \file terralib/qt/widgets/canvas/TileCache.cpp
+
+  \brief A two level (memory and disk) cache of rendered layer tiles.
+*/
+
+// TerraLib
+#include "../../../maptools/AbstractLayer.h"
+#include "../../../maptools/serialization/xml/Utils.h"
+#include "../../../se/serialization/xml/Style.h"
+#include "../../../xml/AbstractWriter.h"
+#include "TileCache.h"
+
+// Qt
+#include <QMutexLocker>
+#include <QString>
+
+// STL
+#include <cmath>
+#include <cstdio>
+
+// Boost
+#include <boost/filesystem.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost/lexical_cast.hpp>
+
+namespace te
+{
+  namespace qt
+  {
+    namespace widgets
+    {
+      /*! \brief The size of the tiles in pixels. */
+      static const int sg_tileSize = 256;
+
+      /*! \brief The number of zoom levels in a binary order of magnitude. */
+      static const double sg_zoomLevelsPerOctave = 65536.0;
+
+      /*!
+        \class StyleHashWriter
+
+        \brief A XML writer that, instead of writing a document, combines everything written into a hash.
+      */
+      class StyleHashWriter : public te::xml::AbstractWriter
+      {
+        public:
+
+          StyleHashWriter() : m_hash(0) { }
+
+          void writeStartDocument(const std::string& encoding, const std::string& standalone) { }
+
+          void writeStartElement(const std::string& qName) { combine(qName); }
+
+          void writeElement(const std::string& qName, const std::string& value) { combine(qName); combine(value); }
+
+          void writeElement(const std::string& qName, const double& value) { combine(qName); combine(value); }
+
+          void writeElement(const std::string& qName, boost::int32_t value) { combine(qName); combine(value); }
+
+          void writeElement(const std::string& qName, boost::uint32_t value) { combine(qName); combine(value); }
+
+          void writeElement(const std::string& qName, boost::int64_t value) { combine(qName); combine(value); }
+
+          void writeElement(const std::string& qName, boost::uint64_t value) { combine(qName); combine(value); }
+
+          void writeAttribute(const std::string& attName, const std::string& value) { combine(attName); combine(value); }
+
+          void writeAttribute(const std::string& attName, const double& value) { combine(attName); combine(value); }
+
+          void writeAttribute(const std::string& attName, boost::int32_t value) { combine(attName); combine(value); }
+
+          void writeAttribute(const std::string& attName, boost::uint32_t value) { combine(attName); combine(value); }
+
+          void writeAttribute(const std::string& attName, boost::int64_t value) { combine(attName); combine(value); }
+
+          void writeAttribute(const std::string& attName, boost::uint64_t value) { combine(attName); combine(value); }
+
+          void writeValue(const std::string& value) { combine(value); }
+
+          void writeValue(const double& value) { combine(value); }
+
+          void writeValue(boost::int32_t value) { combine(value); }
+
+          void writeValue(boost::uint32_t value) { combine(value); }
+
+          void writeValue(boost::int64_t value) { combine(value); }
+
+          void writeValue(boost::uint64_t value) { combine(value); }
+
+          void writeEndElement(const std::string& qName) { combine(qName); }
+
+          void writeToFile() { }
+
+          std::size_t getHash() const { return m_hash; }
+
+        private:
+
+          template<class T> void combine(const T& v) { boost::hash_combine(m_hash, v); }
+
+        private:
+
+          std::size_t m_hash;
+      };
+
+      /*! \brief It replaces the characters of a layer id that are not safe in a file name. */
+      std::string GetSafeFileName(const std::string& name)
+      {
+        std::string safe(name);
+
+        for(std::size_t i = 0; i < safe.size(); ++i)
+        {
+          const char c = safe[i];
+
+          if(!((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-' || c == '.'))
+            safe[i] = '_';
+        }
+
+        return safe;
+      }
+
+    } // end namespace widgets
+  }   // end namespace qt
+}     // end namespace te
+
+bool te::qt::widgets::TileKey::operator<(const TileKey& rhs) const
+{
+  if(m_x != rhs.m_x)
+    return m_x < rhs.m_x;
+
+  if(m_y != rhs.m_y)
+    return m_y < rhs.m_y;
+
+  if(m_zoom != rhs.m_zoom)
+    return m_zoom < rhs.m_zoom;
+
+  if(m_srid != rhs.m_srid)
+    return m_srid < rhs.m_srid;
+
+  if(m_styleHash != rhs.m_styleHash)
+    return m_styleHash < rhs.m_styleHash;
+
+  return m_layerId < rhs.m_layerId;
+}
+
+te::qt::widgets::TileCache::TileCache(const std::string& dir, std::size_t maxMemoryTiles)
+  : m_dir(dir),
+    m_maxMemoryTiles(maxMemoryTiles)
+{
+}
+
+te::qt::widgets::TileCache::~TileCache()
+{
+}
+
+bool te::qt::widgets::TileCache::get(const TileKey& key, QImage& tile)
+{
+  QMutexLocker locker(&m_mtx);
+
+  TileMap::iterator it = m_tiles.find(key);
+
+  if(it != m_tiles.end())
+  {
+    m_lru.splice(m_lru.begin(), m_lru, it->second.second);
+
+    tile = it->second.first;
+
+    return true;
+  }
+
+  if(m_dir.empty())
+    return false;
+
+  if(!tile.load(QString::fromUtf8(getTilePath(key).c_str()), "PNG"))
+    return false;
+
+  tile = tile.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+  putInMemory(key, tile);
+
+  return true;
+}
+
+void te::qt::widgets::TileCache::put(const TileKey& key, const QImage& tile)
+{
+  QMutexLocker locker(&m_mtx);
+
+  putInMemory(key, tile);
+
+  if(m_dir.empty())
+    return;
+
+  std::string path = getTilePath(key);
+
+  try
+  {
+    boost::filesystem::create_directories(boost::filesystem::path(path).parent_path());
+  }
+  catch(...)
+  {
+    return;
+  }
+
+  tile.save(QString::fromUtf8(path.c_str()), "PNG");
+}
+
+void te::qt::widgets::TileCache::invalidate(const std::string& layerId)
+{
+  QMutexLocker locker(&m_mtx);
+
+  for(TileMap::iterator it = m_tiles.begin(); it != m_tiles.end();)
+  {
+    if(it->first.m_layerId == layerId)
+    {
+      m_lru.erase(it->second.second);
+      m_tiles.erase(it++);
+    }
+    else
+      ++it;
+  }
+
+  if(m_dir.empty())
+    return;
+
+  boost::system::error_code ec;
+
+  boost::filesystem::remove_all(boost::filesystem::path(m_dir) / GetSafeFileName(layerId), ec);
+}
+
+void te::qt::widgets::TileCache::clear()
+{
+  QMutexLocker locker(&m_mtx);
+
+  m_tiles.clear();
+  m_lru.clear();
+
+  if(m_dir.empty())
+    return;
+
+  boost::system::error_code ec;
+
+  boost::filesystem::directory_iterator end;
+
+  for(boost::filesystem::directory_iterator it(m_dir, ec); !ec && it != end; it.increment(ec))
+    boost::filesystem::remove_all(it->path(), ec);
+}
+
+const std::string& te::qt::widgets::TileCache::getDirectory() const
+{
+  return m_dir;
+}
+
+int te::qt::widgets::TileCache::GetTileSize()
+{
+  return sg_tileSize;
+}
+
+int te::qt::widgets::TileCache::GetZoomLevel(double resolution)
+{
+  return static_cast<int>(std::floor(std::log(resolution) / std::log(2.0) * sg_zoomLevelsPerOctave + 0.5));
+}
+
+double te::qt::widgets::TileCache::GetResolution(int zoom)
+{
+  return std::pow(2.0, static_cast<double>(zoom) / sg_zoomLevelsPerOctave);
+}
+
+std::size_t te::qt::widgets::TileCache::GetStyleHash(const te::map::AbstractLayer* layer)
+{
+  StyleHashWriter writer;
+
+  writer.writeElement("LayerType", layer->getType());
+
+  if(layer->getStyle())
+    te::se::serialize::Style::getInstance().write(layer->getStyle(), writer);
+
+  if(layer->getGrouping())
+    te::map::serialize::WriteLayerGrouping(layer->getGrouping(), writer);
+
+  if(layer->getChart())
+    te::map::serialize::WriteLayerChart(layer->getChart(), writer);
+
+  return writer.getHash();
+}
+
+std::string te::qt::widgets::TileCache::getTilePath(const TileKey& key) const
+{
+  char tile[64];
+
+  sprintf(tile, "%d_%d.png", key.m_x, key.m_y);
+
+  char style[32];
+
+  sprintf(style, "%llx", static_cast<unsigned long long>(key.m_styleHash));
+
+  boost::filesystem::path path(m_dir);
+
+  path /= GetSafeFileName(key.m_layerId);
+  path /= style;
+  path /= boost::lexical_cast<std::string>(key.m_srid);
+  path /= boost::lexical_cast<std::string>(key.m_zoom);
+  path /= tile;
+
+  return path.string();
+}
+
+void te::qt::widgets::TileCache::putInMemory(const TileKey& key, const QImage& tile)
+{
+  TileMap::iterator it = m_tiles.find(key);
+
+  if(it != m_tiles.end())
+  {
+    it->second.first = tile;
+
+    m_lru.splice(m_lru.begin(), m_lru, it->second.second);
+
+    return;
+  }
+
+  m_lru.push_front(key);
+
+  m_tiles[key] = std::make_pair(tile, m_lru.begin());
+
+  while(m_tiles.size() > m_maxMemoryTiles)
+  {
+    m_tiles.erase(m_lru.back());
+    m_lru.pop_back();
+  }
+}
@@ -0,0 +1,192 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+  \file terralib/qt/widgets/canvas/TileCache.h
+
+  \brief A two level (memory and disk) cache of rendered layer tiles.
+*/
+
+#ifndef __TERRALIB_QT_WIDGETS_INTERNAL_TILECACHE_H
+#define __TERRALIB_QT_WIDGETS_INTERNAL_TILECACHE_H
+
+// TerraLib
+#include "../Config.h"
+
+// Qt
+#include <QImage>
+#include <QMutex>
+
+// STL
+#include <cstddef>
+#include <list>
+#include <map>
+#include <string>
+
+namespace te
+{
+  namespace map { class AbstractLayer; }
+
+  namespace qt
+  {
+    namespace widgets
+    {
+      /*!
+        \struct TileKey
+
+        \brief The key of a rendered tile.
+
+        The zoom level is the map resolution quantized to 1/65536 of a binary order
+        of magnitude: a tile is reused only when the map is drawn at (virtually) the
+        same resolution, so cached tiles are composed without being resampled.
+
+        Tiles are aligned to a grid whose origin is the SRS origin. The tile (x, y)
+        covers the box [x * w, y * w, (x + 1) * w, (y + 1) * w] where w is the tile
+        size in world units at the zoom level.
+      */
+      struct TileKey
+      {
+        std::string m_layerId;   //!< The layer id.
+        std::size_t m_styleHash; //!< The hash of the layer rendering state (see TileCache::GetStyleHash).
+        int m_srid;              //!< The SRS of the map.
+        int m_zoom;              //!< The zoom level.
+        int m_x;                 //!< The tile column.
+        int m_y;                 //!< The tile row (growing to north).
+
+        bool operator<(const TileKey& rhs) const;
+      };
+
+      /*!
+        \class TileCache
+
+        \brief A two level (memory and disk) cache of rendered layer tiles.
+
+        The most recently used tiles are kept in memory. When a cache directory is
+        informed, every tile is also saved as a PNG file in the path
+        <dir>/<layer id>/<style hash>/<srid>/<zoom>/<x>_<y>.png, so the cache
+        outlives the application and can be shared by many map displays.
+
+        All methods are thread-safe: tiles are stored by the threads that render them.
+
+        \ingroup widgets
+
+        \sa MultiThreadMapDisplay, TileDrawThread
+
+        \note The cache can not detect changes made to the data source by other
+              applications. Call invalidate (or clear) when the data of a layer changes.
+      */
+      class TEQTWIDGETSEXPORT TileCache
+      {
+        public:
+
+          /*!
+            \brief Constructor.
+
+            \param dir            The directory where the tiles are persisted. If empty, tiles are only kept in memory.
+            \param maxMemoryTiles The maximum number of tiles kept in memory.
+          */
+          TileCache(const std::string& dir = "", std::size_t maxMemoryTiles = 1024);
+
+          /*! \brief Destructor. */
+          ~TileCache();
+
+          /*!
+            \brief It searches a tile in memory and then on disk.
+
+            \param key  The tile key.
+            \param tile The tile image, if found.
+
+            \return True if the tile was found.
+          */
+          bool get(const TileKey& key, QImage& tile);
+
+          /*!
+            \brief It stores a tile in memory and, if there is a cache directory, on disk.
+
+            \param key  The tile key.
+            \param tile The tile image.
+          */
+          void put(const TileKey& key, const QImage& tile);
+
+          /*!
+            \brief It removes all the tiles of a layer, for any style, SRS or zoom level.
+
+            \param layerId The layer id.
+          */
+          void invalidate(const std::string& layerId);
+
+          /*! \brief It removes all the tiles. */
+          void clear();
+
+          /*! \brief It returns the directory where the tiles are persisted. */
+          const std::string& getDirectory() const;
+
+          /*! \brief It returns the size of the tiles in pixels. */
+          static int GetTileSize();
+
+          /*!
+            \brief It returns the zoom level of the given resolution.
+
+            \param resolution The size of a pixel in world units.
+          */
+          static int GetZoomLevel(double resolution);
+
+          /*!
+            \brief It returns the resolution of a zoom level.
+
+            \param zoom The zoom level.
+
+            \return The size of a pixel in world units.
+          */
+          static double GetResolution(int zoom);
+
+          /*!
+            \brief It computes a hash of everything that changes the way a layer is rendered: type, style, grouping and chart.
+
+            \param layer The layer.
+
+            \return The hash of the layer rendering state.
+          */
+          static std::size_t GetStyleHash(const te::map::AbstractLayer* layer);
+
+        private:
+
+          /*! \brief It returns the path of the tile file. */
+          std::string getTilePath(const TileKey& key) const;
+
+          /*! \brief It stores a tile in memory, evicting the least recently used tiles. */
+          void putInMemory(const TileKey& key, const QImage& tile);
+
+        private:
+
+          typedef std::list<TileKey> LRUList;
+          typedef std::map<TileKey, std::pair<QImage, LRUList::iterator> > TileMap;
+
+          std::string m_dir;              //!< The directory where the tiles are persisted.
+          std::size_t m_maxMemoryTiles;   //!< The maximum number of tiles kept in memory.
+          LRUList m_lru;                  //!< The tiles in memory, from the most to the least recently used.
+          TileMap m_tiles;                //!< The tiles in memory.
+          QMutex m_mtx;                   //!< Serializes the access to the cache.
+      };
+
+    } // end namespace widgets
+  }   // end namespace qt
+}     // end namespace te
+
+#endif  // __TERRALIB_QT_WIDGETS_INTERNAL_TILECACHE_H
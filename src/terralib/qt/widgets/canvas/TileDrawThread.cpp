@@ -0,0 +1,102 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+TerraLib is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License,
+or (at your option) any later version.
+
+TerraLib is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with TerraLib. See COPYING. If not, write to
+TerraLib Team at <terralib-team@terralib.org>.
+*/
+
+/*!
+\file terralib/qt/widgets/canvas/TileDrawThread.cpp
+
+\brief Thread to draw a block of tiles of a Layer and store them in a tile cache.
+*/
+
+#include "TileDrawThread.h"
+
+// Qt
+#include <QPainter>
+
+/*! \brief The margin, in pixels, drawn around a block of tiles. */
+static const int sg_blockMargin = 32;
+
+te::qt::widgets::TileDrawThread::TileDrawThread(TileCache* cache, te::map::AbstractLayer* layer, const TileKey& first, int nCols, int nRows,
+                                                QImage* target, const QPoint& targetPos, const QColor& bckGround, double scale,
+                                                te::map::AlignType hAlign, te::map::AlignType vAlign):
+DrawThread(&m_block, layer, &m_blockBox, bckGround, first.m_srid, scale, hAlign, vAlign),
+m_cache(cache),
+m_first(first),
+m_nCols(nCols),
+m_nRows(nRows),
+m_target(target),
+m_targetPos(targetPos)
+{
+  const int tileSize = TileCache::GetTileSize();
+
+  m_block = QImage(m_nCols * tileSize + 2 * sg_blockMargin, m_nRows * tileSize + 2 * sg_blockMargin, QImage::Format_ARGB32_Premultiplied);
+
+  const double res = TileCache::GetResolution(m_first.m_zoom);
+  const double tileWidth = res * tileSize;
+  const double margin = res * sg_blockMargin;
+
+  m_blockBox.init(m_first.m_x * tileWidth - margin,
+                  m_first.m_y * tileWidth - margin,
+                  (m_first.m_x + m_nCols) * tileWidth + margin,
+                  (m_first.m_y + m_nRows) * tileWidth + margin);
+}
+
+te::qt::widgets::TileDrawThread::~TileDrawThread()
+{
+}
+
+void te::qt::widgets::TileDrawThread::run()
+{
+  draw();
+
+// the tiles are in the cache before the listeners of finished() look for them
+  if(m_finished)
+    putTiles();
+
+  emit finished();
+}
+
+void te::qt::widgets::TileDrawThread::putTiles()
+{
+  const int tileSize = TileCache::GetTileSize();
+
+  TileKey key = m_first;
+
+  for(int r = 0; r < m_nRows; ++r)
+  {
+    key.m_y = m_first.m_y + r;
+
+    for(int c = 0; c < m_nCols; ++c)
+    {
+      key.m_x = m_first.m_x + c;
+
+      m_cache->put(key, m_block.copy(sg_blockMargin + c * tileSize, sg_blockMargin + (m_nRows - 1 - r) * tileSize, tileSize, tileSize));
+    }
+  }
+}
+
+void te::qt::widgets::TileDrawThread::compose()
+{
+  const int tileSize = TileCache::GetTileSize();
+
+  QPainter painter(m_target);
+
+  painter.setCompositionMode(QPainter::CompositionMode_Source);
+
+  painter.drawImage(m_targetPos, m_block, QRect(sg_blockMargin, sg_blockMargin, m_nCols * tileSize, m_nRows * tileSize));
+}
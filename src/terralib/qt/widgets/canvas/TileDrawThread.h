@@ -0,0 +1,116 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+TerraLib is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License,
+or (at your option) any later version.
+
+TerraLib is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with TerraLib. See COPYING. If not, write to
+TerraLib Team at <terralib-team@terralib.org>.
+*/
+
+/*!
+\file terralib/qt/widgets/canvas/TileDrawThread.h
+
+\brief Thread to draw a block of tiles of a Layer and store them in a tile cache.
+*/
+
+#ifndef __TERRALIB_QT_WIDGETS_INTERNAL_TILEDRAWTHREAD_H
+#define __TERRALIB_QT_WIDGETS_INTERNAL_TILEDRAWTHREAD_H
+
+//TerraLib
+#include "../../../geometry/Envelope.h"
+#include "DrawThread.h"
+#include "TileCache.h"
+
+// Qt
+#include <QImage>
+#include <QPoint>
+
+namespace te
+{
+  namespace qt
+  {
+    namespace widgets
+    {
+      /*!
+        \class TileDrawThread
+
+        \brief Thread to draw a block of tiles of a Layer and store them in a tile cache.
+
+        The whole block is drawn in a single image, so the layer data is queried once
+        per block instead of once per tile. The image has a margin around the tiles,
+        so symbols and labels of features that are close to the tiles borders are drawn
+        in the same way in neighbour tiles.
+
+        \sa TileCache, MultiThreadMapDisplay
+      */
+      class TileDrawThread : public DrawThread
+      {
+        Q_OBJECT
+
+      public:
+
+        /*!
+          \brief Constructor.
+
+          \param cache     The cache where the tiles will be stored.
+          \param layer     The layer to be drawn.
+          \param first     The key of the south-west tile of the block.
+          \param nCols     The number of tile columns of the block.
+          \param nRows     The number of tile rows of the block.
+          \param target    The image where the block will be composed.
+          \param targetPos The position in the target of the north-west corner of the block.
+          \param bckGround The background color.
+          \param scale     The map scale.
+          \param hAlign    The display horizontal align.
+          \param vAlign    The display vertical align.
+        */
+        TileDrawThread(TileCache* cache, te::map::AbstractLayer* layer, const TileKey& first, int nCols, int nRows,
+                       QImage* target, const QPoint& targetPos, const QColor& bckGround, double scale,
+                       te::map::AlignType hAlign, te::map::AlignType vAlign);
+
+        ~TileDrawThread();
+
+        /*! \brief It draws the block and, if it was not canceled, stores its tiles in the cache before emitting the finished signal. */
+        void run();
+
+        /*! \brief It composes the drawn block into the target image. It must be called by the thread that owns the target. */
+        void compose();
+
+      protected:
+
+        /*! \brief It stores the tiles of the drawn block in the cache. */
+        void putTiles();
+
+      protected:
+
+        TileCache* m_cache;             //!< The cache where the tiles will be stored.
+
+        TileKey m_first;                //!< The key of the south-west tile of the block.
+
+        int m_nCols;                    //!< The number of tile columns of the block.
+
+        int m_nRows;                    //!< The number of tile rows of the block.
+
+        QImage m_block;                 //!< The image of the block, with a margin.
+
+        te::gm::Envelope m_blockBox;    //!< The box of the block image.
+
+        QImage* m_target;               //!< The image where the block will be composed.
+
+        QPoint m_targetPos;             //!< The position in the target of the north-west corner of the block.
+      };
+    }
+  }
+}
+
+#endif //__TERRALIB_QT_WIDGETS_INTERNAL_TILEDRAWTHREAD_H
@@ -44,9 +44,11 @@
 #include "raster/RasterFactory.h"
 #include "raster/RasterIterator.h"
 #include "raster/RasterProperty.h"
+#include "raster/RasterStatistics.h"
 #include "raster/RasterSummary.h"
 #include "raster/RasterSummaryManager.h"
 #include "raster/RasterSynchronizer.h"
+#include "raster/Rasterizer.h"
 #include "raster/Reprojection.h"
 #include "raster/SynchronizedBand.h"
 #include "raster/SynchronizedBandBlocksManager.h"
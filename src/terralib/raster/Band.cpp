@@ -31,8 +31,102 @@
 #include "Utils.h"
 
 // STL
+#include <algorithm>
 #include <cassert>
 #include <limits>
+#include <vector>
+
+namespace te
+{
+  namespace rst
+  {
+    /*!
+      \class BandStripReader
+
+      \brief It reads a window of a band in horizontal strips, using the block access of the band.
+
+      The strips have the height of a band block, limited so that a strip never holds
+      more than sm_maxStripValues values.
+    */
+    class BandStripReader
+    {
+      public:
+
+        BandStripReader(const Band& band, bool readImag, unsigned int rs, unsigned int cs, unsigned int rf, unsigned int cf)
+          : m_band(band),
+            m_readImag(readImag && band.getProperty()->isComplex()),
+            m_cs(cs),
+            m_rf(rf),
+            m_ncols(cf - cs + 1),
+            m_row(rs),
+            m_nrows(0)
+        {
+          m_stripRows = static_cast<unsigned int>(band.getProperty()->m_blkh);
+
+          if(m_stripRows * m_ncols > sm_maxStripValues)
+            m_stripRows = sm_maxStripValues / m_ncols;
+
+          if(m_stripRows == 0)
+            m_stripRows = 1;
+
+          m_real.resize(m_stripRows * m_ncols);
+
+// the imaginary part of non complex bands is always zero
+          m_imag.resize(m_stripRows * m_ncols, 0.0);
+        }
+
+        /*! \brief It reads the next strip, returning false after the last row of the window. */
+        bool next()
+        {
+          m_row += m_nrows;
+
+          if(m_row > m_rf)
+            return false;
+
+          m_nrows = std::min(m_stripRows, m_rf - m_row + 1);
+
+          m_band.getValues(m_cs, m_row, m_ncols, m_nrows, &m_real[0]);
+
+          if(m_readImag)
+            m_band.getIValues(m_cs, m_row, m_ncols, m_nrows, &m_imag[0]);
+
+          return true;
+        }
+
+        /*! \brief The number of values in the current strip. */
+        std::size_t size() const
+        {
+          return m_nrows * m_ncols;
+        }
+
+        const double* real() const
+        {
+          return &m_real[0];
+        }
+
+        const double* imag() const
+        {
+          return &m_imag[0];
+        }
+
+      private:
+
+        static const unsigned int sm_maxStripValues = 65536;  //!< The maximum number of values in a strip (512 KB).
+
+        const Band& m_band;           //!< The band being read.
+        bool m_readImag;              //!< It indicates if the imaginary values must be read.
+        unsigned int m_cs;            //!< The first column of the window.
+        unsigned int m_rf;            //!< The last row of the window.
+        unsigned int m_ncols;         //!< The number of columns of the window.
+        unsigned int m_stripRows;     //!< The maximum number of rows in a strip.
+        unsigned int m_row;           //!< The first row of the current strip.
+        unsigned int m_nrows;         //!< The number of rows of the current strip.
+        std::vector<double> m_real;   //!< The real values of the current strip.
+        std::vector<double> m_imag;   //!< The imaginary values of the current strip.
+    };
+
+  } // end namespace rst
+}   // end namespace te
 
 te::rst::Band::Band(BandProperty* p, std::size_t idx)
   : m_property(p),
@@ -79,6 +173,27 @@ void te::rst::Band::setValue(unsigned int c, unsigned int r, const std::complex<
   setIValue(c, r, value.imag());
 }
 
+void te::rst::Band::getValues(unsigned int c, unsigned int r, unsigned int ncols, unsigned int nrows, double* values) const
+{
+  for(unsigned int j = 0; j < nrows; ++j)
+    for(unsigned int i = 0; i < ncols; ++i)
+      getValue(c + i, r + j, *values++);
+}
+
+void te::rst::Band::setValues(unsigned int c, unsigned int r, unsigned int ncols, unsigned int nrows, const double* values)
+{
+  for(unsigned int j = 0; j < nrows; ++j)
+    for(unsigned int i = 0; i < ncols; ++i)
+      setValue(c + i, r + j, *values++);
+}
+
+void te::rst::Band::getIValues(unsigned int c, unsigned int r, unsigned int ncols, unsigned int nrows, double* values) const
+{
+  for(unsigned int j = 0; j < nrows; ++j)
+    for(unsigned int i = 0; i < ncols; ++i)
+      getIValue(c + i, r + j, *values++);
+}
+
 std::complex<double> te::rst::Band::getMinValue(bool readall, unsigned int rs, unsigned int cs, unsigned int rf, unsigned int cf) const
 {
   std::complex<double> pixel;
@@ -118,20 +233,25 @@ std::complex<double> te::rst::Band::getMinValue(bool readall, unsigned int rs, u
   }
   
 // read all pixels in range
-  for (unsigned r = rs; r <= rf; r++)
-    for (unsigned c = cs; c <= cf; c++)
-    {
-      getValue(c, r, pixel);
+  BandStripReader strips(*this, true, rs, cs, rf, cf);
 
-      if(pixel.real() == no_data)
+  while(strips.next())
+  {
+    const double* real = strips.real();
+    const double* imag = strips.imag();
+
+    for(std::size_t i = 0; i < strips.size(); ++i)
+    {
+      if(real[i] == no_data)
         continue;
 
-      if (pixel.real() < min_real)
-        min_real = pixel.real();
+      if (real[i] < min_real)
+        min_real = real[i];
 
-      if (pixel.imag() < min_img)
-        min_img = pixel.imag();
+      if (imag[i] < min_img)
+        min_img = imag[i];
     }
+  }
 
   return std::complex<double>(min_real, min_img);
 }
@@ -175,20 +295,25 @@ std::complex<double> te::rst::Band::getMaxValue(bool readall, unsigned int rs, u
   }
   
 // read all pixels in range
-  for (unsigned r = rs; r <= rf; r++)
-    for (unsigned c = cs; c <= cf; c++)
-    {
-      getValue(c, r, pixel);
+  BandStripReader strips(*this, true, rs, cs, rf, cf);
+
+  while(strips.next())
+  {
+    const double* real = strips.real();
+    const double* imag = strips.imag();
 
-      if(pixel.real() == no_data)
+    for(std::size_t i = 0; i < strips.size(); ++i)
+    {
+      if(real[i] == no_data)
         continue;
 
-      if (pixel.real() > max_real)
-        max_real = pixel.real();
+      if (real[i] > max_real)
+        max_real = real[i];
 
-      if (pixel.imag() > max_img)
-        max_img = pixel.imag();
+      if (imag[i] > max_img)
+        max_img = imag[i];
     }
+  }
 
   return std::complex<double>(max_real, max_img);
 }
@@ -202,30 +327,37 @@ std::complex<double> te::rst::Band::getStdValue(unsigned int rs, unsigned int cs
     cf = getRaster()->getNumberOfColumns() - 1;
   }
 
-  std::complex<double> pixel;
-
   std::complex<double> mean = getMeanValue(rs, cs, rf, cf);
 
-  std::complex<double> diff;
+  double sumDiffsReal = 0.0;
 
-  std::complex<double> sumDiffs(0.0, 0.0);
+  double sumDiffsImag = 0.0;
 
   unsigned n = (rf-rs+1) * (cf-cs+1) - 1;
 
   if (n == 0)
     return std::complex<double> (1.0, 1.0);
 
-  for (unsigned r = rs; r <= rf; r++)
-    for (unsigned c = cs; c <= cf; c++)
+  BandStripReader strips(*this, true, rs, cs, rf, cf);
+
+  while(strips.next())
+  {
+    const double* real = strips.real();
+    const double* imag = strips.imag();
+
+    for(std::size_t i = 0; i < strips.size(); ++i)
     {
-      getValue(c, r, pixel);
+      const std::complex<double> diff = std::complex<double>(real[i], imag[i]) - mean;
 
-      diff = pixel - mean;
+      const std::complex<double> diff2 = diff * diff;
 
-      sumDiffs += diff * diff;
+      sumDiffsReal += diff2.real();
+
+      sumDiffsImag += diff2.imag();
     }
+  }
 
-  return std::complex<double> (std::sqrt(sumDiffs.real() / n), std::sqrt(sumDiffs.imag() / n));
+  return std::complex<double> (std::sqrt(sumDiffsReal / n), std::sqrt(sumDiffsImag / n));
 }
 
 std::complex<double> te::rst::Band::getMeanValue(unsigned int rs, unsigned int cs, unsigned int rf, unsigned int cf) const
@@ -237,24 +369,31 @@ std::complex<double> te::rst::Band::getMeanValue(unsigned int rs, unsigned int c
     cf = getRaster()->getNumberOfColumns() - 1;
   }
 
-  std::complex<double> pixel;
+  double sumReal = 0.0;
 
-  std::complex<double> sumValue(0.0, 0.0);
+  double sumImag = 0.0;
 
   unsigned int n = (rf-rs+1) * (cf-cs+1);
 
-  for (unsigned r = rs; r <= rf; r++)
-    for (unsigned c = cs; c <= cf; c++)
+  BandStripReader strips(*this, true, rs, cs, rf, cf);
+
+  while(strips.next())
+  {
+    const double* real = strips.real();
+    const double* imag = strips.imag();
+
+    for(std::size_t i = 0; i < strips.size(); ++i)
     {
-      getValue(c, r, pixel);
+      sumReal += real[i];
 
-      sumValue += pixel;
+      sumImag += imag[i];
     }
+  }
 
   if (n == 0)
     return std::complex<double> (0.0, 0.0);
 
-  return std::complex<double> (sumValue.real() / n, sumValue.imag() / n);
+  return std::complex<double> (sumReal / n, sumImag / n);
 }
 
 std::map<double, unsigned> te::rst::Band::getHistogramR(unsigned int rs, unsigned int cs, unsigned int rf, unsigned int cf, unsigned int b) const
@@ -268,67 +407,93 @@ std::map<double, unsigned> te::rst::Band::getHistogramR(unsigned int rs, unsigne
 
   std::map<double, unsigned> hist;
 
-  double pixel;
+  const double no_data = m_property->m_noDataValue;
 
   if (b == 0)
-    for (unsigned r = rs; r <= rf; r++)
-      for (unsigned c = cs; c <= cf; c++)
-      {
-        getValue(c, r, pixel);
+  {
+    BandStripReader strips(*this, false, rs, cs, rf, cf);
+
+    while(strips.next())
+    {
+      const double* real = strips.real();
 
-        if (pixel == m_property->m_noDataValue)
+      for(std::size_t i = 0; i < strips.size(); ++i)
+      {
+        if (real[i] == no_data)
           continue;
 
-        hist[pixel]++;
+        hist[real[i]]++;
       }
+    }
+  }
   else
   {
 // find limits to divide into bins
     double pmin = std::numeric_limits<double>::max();
     double pmax = -1.0 * std::numeric_limits<double>::max();
 
-    for (unsigned r = rs; r <= rf; r++)
-      for (unsigned c = cs; c <= cf; c++)
-      {
-        getValue(c, r, pixel);
+    BandStripReader limits(*this, false, rs, cs, rf, cf);
+
+    while(limits.next())
+    {
+      const double* real = limits.real();
 
-        if (pixel == m_property->m_noDataValue)
+      for(std::size_t i = 0; i < limits.size(); ++i)
+      {
+        if (real[i] == no_data)
           continue;
 
-        if (pixel > pmax)
-          pmax = pixel;
+        if (real[i] > pmax)
+          pmax = real[i];
 
-        if (pixel < pmin)
-          pmin = pixel;
+        if (real[i] < pmin)
+          pmin = real[i];
       }
+    }
 
 // create histogram with bins
     double delta = (pmax * 1.000001 - pmin) / b;
 
-    std::map<std::size_t, double> binsLocations;
-
-    std::size_t location = 0;
+    std::vector<double> binsLocations;
 
     for (double bins = pmin; bins < pmax; bins += delta)
     {
       hist[bins] = 0;
 
-      binsLocations[location++] = bins;
+      binsLocations.push_back(bins);
     }
 
-// fill histogram
-    for (unsigned r = rs; r <= rf; r++)
-      for (unsigned c = cs; c <= cf; c++)
-      {
-        getValue(c, r, pixel);
+// fill histogram, counting by bin index and adding the counts to the map at the end
+    std::vector<unsigned> counts(binsLocations.size() + 1, 0);
+
+    std::size_t location = 0;
+
+    BandStripReader strips(*this, false, rs, cs, rf, cf);
 
-        if (pixel == m_property->m_noDataValue)
+    while(strips.next())
+    {
+      const double* real = strips.real();
+
+      for(std::size_t i = 0; i < strips.size(); ++i)
+      {
+        if (real[i] == no_data)
           continue;
 
-        location = (std::size_t) ((pixel - pmin) / delta);
+        location = (std::size_t) ((real[i] - pmin) / delta);
 
-        hist[binsLocations[location]]++;
+        if (location >= binsLocations.size())
+          location = binsLocations.size();
+
+        counts[location]++;
       }
+    }
+
+    for (std::size_t i = 0; i < binsLocations.size(); ++i)
+      hist[binsLocations[i]] += counts[i];
+
+// values beyond the last bin location are kept under the 0.0 key
+    if (counts.back() != 0)
+      hist[0.0] += counts.back();
 
 // removing empty bins from histogram
     for (double bins = pmin; bins < pmax; bins += delta)
@@ -351,58 +516,80 @@ std::map<double, unsigned> te::rst::Band::getHistogramI(unsigned int rs, unsigne
 
   std::map<double, unsigned> hist;
 
-  double pixel;
-
   if (b == 0)
-    for (unsigned r = rs; r <= rf; r++)
-      for (unsigned c = cs; c <= cf; c++)
-      {
-        getIValue(c, r, pixel);
+  {
+    BandStripReader strips(*this, true, rs, cs, rf, cf);
 
-        hist[pixel]++;
-      }
+    while(strips.next())
+    {
+      const double* imag = strips.imag();
+
+      for(std::size_t i = 0; i < strips.size(); ++i)
+        hist[imag[i]]++;
+    }
+  }
   else
   {
 // find limits to divide into bins
     double pmin = std::numeric_limits<double>::max();
     double pmax = -1.0 * std::numeric_limits<double>::max();
 
-    for (unsigned r = rs; r <= rf; r++)
-      for (unsigned c = cs; c <= cf; c++)
-      {
-        getIValue(c, r, pixel);
+    BandStripReader limits(*this, true, rs, cs, rf, cf);
+
+    while(limits.next())
+    {
+      const double* imag = limits.imag();
 
-        if (pixel > pmax)
-          pmax = pixel;
+      for(std::size_t i = 0; i < limits.size(); ++i)
+      {
+        if (imag[i] > pmax)
+          pmax = imag[i];
 
-        if (pixel < pmin)
-          pmin = pixel;
+        if (imag[i] < pmin)
+          pmin = imag[i];
       }
+    }
 
 // create histogram with bins
     double delta = (pmax * 1.000001 - pmin) / b;
 
-    std::map<std::size_t, double> binsLocations;
-
-    std::size_t location = 0;
+    std::vector<double> binsLocations;
 
     for (double bins = pmin; bins < pmax; bins += delta)
     {
       hist[bins] = 0;
 
-      binsLocations[location++] = bins;
+      binsLocations.push_back(bins);
     }
 
-// fill histogram
-    for (unsigned r = rs; r <= rf; r++)
-      for (unsigned c = cs; c <= cf; c++)
+// fill histogram, counting by bin index and adding the counts to the map at the end
+    std::vector<unsigned> counts(binsLocations.size() + 1, 0);
+
+    std::size_t location = 0;
+
+    BandStripReader strips(*this, true, rs, cs, rf, cf);
+
+    while(strips.next())
+    {
+      const double* imag = strips.imag();
+
+      for(std::size_t i = 0; i < strips.size(); ++i)
       {
-        getIValue(c, r, pixel);
+        location = (std::size_t) ((imag[i] - pmin) / delta);
 
-        location = (std::size_t) ((pixel - pmin) / delta);
+        if (location >= binsLocations.size())
+          location = binsLocations.size();
 
-        hist[binsLocations[location]]++;
+        counts[location]++;
       }
+    }
+
+    for (std::size_t i = 0; i < binsLocations.size(); ++i)
+      hist[binsLocations[i]] += counts[i];
+
+// values beyond the last bin location are kept under the 0.0 key
+    if (counts.back() != 0)
+      hist[0.0] += counts.back();
 
 // removing empty bins from histogram
     for (double bins = pmin; bins < pmax; bins += delta)
@@ -205,6 +205,60 @@ namespace te
         */
         virtual void write(int x, int y, void* buffer) = 0;
 
+        /*!
+          \brief It reads the attribute values (real part) of a window of the band.
+
+          The values are returned in row-major order: the value of the cell (c + i, r + j)
+          is stored in values[i + j * ncols].
+
+          \param c      The first column of the window.
+          \param r      The first row of the window.
+          \param ncols  The number of columns of the window.
+          \param nrows  The number of rows of the window.
+          \param values A buffer with room for ncols * nrows values.
+
+          \note The default implementation calls getValue for each cell. Drivers should
+                override it to copy the values directly from their blocks, converting
+                them from the band data type with a single type dispatch per block row.
+
+          \warning The caller is responsible for providing a window inside the band.
+
+          \exception Exception Subclasses may throw an exception if the data values can not be read.
+        */
+        virtual void getValues(unsigned int c, unsigned int r, unsigned int ncols, unsigned int nrows, double* values) const;
+
+        /*!
+          \brief It sets the attribute values (real part) of a window of the band.
+
+          \param c      The first column of the window.
+          \param r      The first row of the window.
+          \param ncols  The number of columns of the window.
+          \param nrows  The number of rows of the window.
+          \param values The ncols * nrows values to be assigned, in row-major order.
+
+          \note The default implementation calls setValue for each cell.
+
+          \warning The caller is responsible for providing a window inside the band.
+
+          \exception Exception Subclasses may throw an exception if the data values can not be written.
+        */
+        virtual void setValues(unsigned int c, unsigned int r, unsigned int ncols, unsigned int nrows, const double* values);
+
+        /*!
+          \brief It reads the imaginary attribute values of a window of a complex band.
+
+          \param c      The first column of the window.
+          \param r      The first row of the window.
+          \param ncols  The number of columns of the window.
+          \param nrows  The number of rows of the window.
+          \param values A buffer with room for ncols * nrows values.
+
+          \warning The caller is responsible for providing a window inside the band.
+
+          \exception Exception Subclasses may throw an exception if the data values can not be read.
+        */
+        virtual void getIValues(unsigned int c, unsigned int r, unsigned int ncols, unsigned int nrows, double* values) const;
+
         /*!
           \brief It computes and returns the minimum occurring value in a window of the band.
 
@@ -406,3 +406,130 @@ void te::rst::SetBlockFunctions(GetBufferValueFPtr *gb, GetBufferValueFPtr *gbi,
       throw te::rst::Exception("Invalid data type");
   }
 }
+
+namespace te
+{
+  namespace rst
+  {
+    template<class T> inline void GetTypedValues(int index, int count, void* buffer, double* values)
+    {
+      const T* b = static_cast<const T*>(buffer) + index;
+
+      for(int i = 0; i < count; ++i)
+        values[i] = (double)b[i];
+    }
+
+    template<class T> inline void SetTypedValues(int index, int count, void* buffer, const double* values)
+    {
+      T* b = static_cast<T*>(buffer) + index;
+
+      for(int i = 0; i < count; ++i)
+        b[i] = (T)values[i];
+    }
+
+  } // end namespace rst
+}   // end namespace te
+
+void te::rst::GetBufferValues(int type, int index, int count, void* buffer, double* values)
+{
+  switch(type)
+  {
+    case te::dt::UCHAR_TYPE:
+      GetTypedValues<unsigned char>(index, count, buffer, values);
+    break;
+
+    case te::dt::CHAR_TYPE:
+      GetTypedValues<char>(index, count, buffer, values);
+    break;
+
+    case te::dt::UINT16_TYPE:
+      GetTypedValues<unsigned short>(index, count, buffer, values);
+    break;
+
+    case te::dt::INT16_TYPE:
+      GetTypedValues<short>(index, count, buffer, values);
+    break;
+
+    case te::dt::UINT32_TYPE:
+      GetTypedValues<unsigned int>(index, count, buffer, values);
+    break;
+
+    case te::dt::INT32_TYPE:
+      GetTypedValues<int>(index, count, buffer, values);
+    break;
+
+    case te::dt::FLOAT_TYPE:
+      GetTypedValues<float>(index, count, buffer, values);
+    break;
+
+    case te::dt::DOUBLE_TYPE:
+      GetTypedValues<double>(index, count, buffer, values);
+    break;
+
+    default:
+    {
+// packed bits and complex types: one call per value
+      GetBufferValueFPtr gb = 0;
+      GetBufferValueFPtr gbi = 0;
+      SetBufferValueFPtr sb = 0;
+      SetBufferValueFPtr sbi = 0;
+
+      SetBlockFunctions(&gb, &gbi, &sb, &sbi, type);
+
+      for(int i = 0; i < count; ++i)
+        gb(index + i, buffer, values + i);
+    }
+  }
+}
+
+void te::rst::SetBufferValues(int type, int index, int count, void* buffer, const double* values)
+{
+  switch(type)
+  {
+    case te::dt::UCHAR_TYPE:
+      SetTypedValues<unsigned char>(index, count, buffer, values);
+    break;
+
+    case te::dt::CHAR_TYPE:
+      SetTypedValues<char>(index, count, buffer, values);
+    break;
+
+    case te::dt::UINT16_TYPE:
+      SetTypedValues<unsigned short>(index, count, buffer, values);
+    break;
+
+    case te::dt::INT16_TYPE:
+      SetTypedValues<short>(index, count, buffer, values);
+    break;
+
+    case te::dt::UINT32_TYPE:
+      SetTypedValues<unsigned int>(index, count, buffer, values);
+    break;
+
+    case te::dt::INT32_TYPE:
+      SetTypedValues<int>(index, count, buffer, values);
+    break;
+
+    case te::dt::FLOAT_TYPE:
+      SetTypedValues<float>(index, count, buffer, values);
+    break;
+
+    case te::dt::DOUBLE_TYPE:
+      SetTypedValues<double>(index, count, buffer, values);
+    break;
+
+    default:
+    {
+// packed bits and complex types: one call per value
+      GetBufferValueFPtr gb = 0;
+      GetBufferValueFPtr gbi = 0;
+      SetBufferValueFPtr sb = 0;
+      SetBufferValueFPtr sbi = 0;
+
+      SetBlockFunctions(&gb, &gbi, &sb, &sbi, type);
+
+      for(int i = 0; i < count; ++i)
+        sb(index + i, buffer, values + i);
+    }
+  }
+}
@@ -131,6 +131,35 @@ namespace te
     TERASTEREXPORT void SetBlockFunctions(GetBufferValueFPtr* gb, GetBufferValueFPtr* gbi,
                                           SetBufferValueFPtr* sb, SetBufferValueFPtr* sbi, int type);
 
+    /*!
+      \brief It extracts a sequence of real values from a block buffer.
+
+      The data type is dispatched once for the whole sequence, instead of
+      once per value as with the GetBufferValueFPtr functions.
+
+      \param type    The block data type.
+      \param index   The index of the first value in the buffer.
+      \param count   The number of values to be extracted.
+      \param buffer  The block buffer.
+      \param values  A buffer with room for count values.
+
+      \note For complex data types the real part is extracted.
+    */
+    TERASTEREXPORT void GetBufferValues(int type, int index, int count, void* buffer, double* values);
+
+    /*!
+      \brief It inserts a sequence of real values into a block buffer.
+
+      \param type    The block data type.
+      \param index   The index of the first value in the buffer.
+      \param count   The number of values to be inserted.
+      \param buffer  The block buffer.
+      \param values  The values to be inserted.
+
+      \note For complex data types the real part is set.
+    */
+    TERASTEREXPORT void SetBufferValues(int type, int index, int count, void* buffer, const double* values);
+
   } // end namespace rst
 }   // end namespace te
 
@@ -0,0 +1,739 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+  \file terralib/raster/RasterStatistics.cpp
+
+  \brief A single pass, multi-threaded engine for the summaries of the raster bands.
+*/
+
+// TerraLib
+#include "../common/PlatformUtils.h"
+#include "../common/progress/TaskProgress.h"
+#include "../core/translator/Translator.h"
+#include "../datatype/Enums.h"
+#include "Band.h"
+#include "BandProperty.h"
+#include "Enums.h"
+#include "Exception.h"
+#include "Raster.h"
+#include "RasterStatistics.h"
+#include "Utils.h"
+
+// STL
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <memory>
+
+// Boost
+#include <boost/thread.hpp>
+
+namespace te
+{
+  namespace rst
+  {
+    /*! \brief The minimum number of values of a strip, for rasters with short blocks. */
+    static const std::size_t sg_minStripValues = 65536;
+
+    /*! \brief The maximum number of values of a strip, for rasters with tall blocks. */
+    static const std::size_t sg_maxStripValues = 1048576;
+
+    /*! \brief The maximum size of the array histograms (16 bits data types). */
+    static const double sg_maxLookupSize = 65536.0;
+
+    /*! \brief The maximum number of values kept before they are counted in a map histogram. */
+    static const std::size_t sg_maxPendingValues = 1048576;
+
+    /*! \brief It merges the central moments of a set of values into a band state (Chan et al.). */
+    static void MergeMoments(RasterStatistics::BandState& s, std::size_t n, double meanReal, double meanImag,
+                             double m2Real, double m2Imag, double coMoment)
+    {
+      if(n == 0)
+        return;
+
+      if(s.m_count == 0)
+      {
+        s.m_meanReal = meanReal;
+        s.m_meanImag = meanImag;
+        s.m_m2Real = m2Real;
+        s.m_m2Imag = m2Imag;
+        s.m_coMoment = coMoment;
+
+        return;
+      }
+
+      const double na = static_cast<double>(s.m_count);
+      const double nb = static_cast<double>(n);
+      const double nt = na + nb;
+
+      const double dr = meanReal - s.m_meanReal;
+      const double di = meanImag - s.m_meanImag;
+      const double w = na * nb / nt;
+
+      s.m_meanReal += dr * nb / nt;
+      s.m_meanImag += di * nb / nt;
+      s.m_m2Real += m2Real + dr * dr * w;
+      s.m_m2Imag += m2Imag + di * di * w;
+      s.m_coMoment += coMoment + dr * di * w;
+    }
+
+    /*! \brief It adds the counts of a histogram to other one, in a single sorted sweep. */
+    static void MergeHistograms(std::map<double, unsigned int>& lhs, const std::map<double, unsigned int>& rhs)
+    {
+      if(lhs.empty())
+      {
+        lhs = rhs;
+
+        return;
+      }
+
+      std::map<double, unsigned int>::iterator hint = lhs.begin();
+
+      for(std::map<double, unsigned int>::const_iterator it = rhs.begin(); it != rhs.end(); ++it)
+      {
+        std::map<double, unsigned int>::iterator pos = lhs.insert(hint, std::map<double, unsigned int>::value_type(it->first, 0));
+
+        pos->second += it->second;
+
+        hint = ++pos;
+      }
+    }
+
+    /*! \brief It counts a set of values in a histogram, sorting them first to insert each distinct value once. */
+    static void FlushValues(std::vector<double>& values, std::map<double, unsigned int>& hist)
+    {
+      if(values.empty())
+        return;
+
+      std::sort(values.begin(), values.end());
+
+      std::map<double, unsigned int>::iterator hint = hist.begin();
+
+      for(std::size_t i = 0; i < values.size();)
+      {
+        std::size_t j = i + 1;
+
+        while((j < values.size()) && (values[j] == values[i]))
+          ++j;
+
+        std::map<double, unsigned int>::iterator pos = hist.insert(hint, std::map<double, unsigned int>::value_type(values[i], 0));
+
+        pos->second += static_cast<unsigned int>(j - i);
+
+        hint = ++pos;
+
+        i = j;
+      }
+
+      values.clear();
+    }
+
+  } // end namespace rst
+}   // end namespace te
+
+struct te::rst::RasterStatistics::ThreadParams
+{
+  RasterStatistics* m_engine;
+  const Raster* m_raster;                //!< The raster being read (the input raster or an overview).
+  unsigned int m_stripRows;
+  std::size_t m_nStrips;
+  std::size_t m_nextStrip;
+  std::size_t m_processedStrips;
+  unsigned int m_runningThreads;
+  bool m_abort;
+  bool m_failed;
+  te::common::TaskProgress* m_task;      //!< Only informed when there is a single thread.
+  boost::mutex m_mutex;                  //!< It protects the members above and the engine states.
+  boost::condition_variable m_condVar;
+  boost::mutex m_ioMutex;                //!< It serializes the raster reads.
+};
+
+te::rst::RasterStatistics::BandState::BandState()
+  : m_types(0),
+    m_noData(std::numeric_limits<double>::max()),
+    m_complex(false),
+    m_count(0),
+    m_validCount(0),
+    m_minReal(std::numeric_limits<double>::max()),
+    m_minImag(std::numeric_limits<double>::max()),
+    m_maxReal(-std::numeric_limits<double>::max()),
+    m_maxImag(-std::numeric_limits<double>::max()),
+    m_meanReal(0.0),
+    m_meanImag(0.0),
+    m_m2Real(0.0),
+    m_m2Imag(0.0),
+    m_coMoment(0.0),
+    m_lookupMin(0.0)
+{
+}
+
+void te::rst::RasterStatistics::BandState::reset(const BandProperty& prop, int types)
+{
+  *this = BandState();
+
+  m_types = types;
+  m_noData = prop.m_noDataValue;
+  m_complex = prop.isComplex();
+
+  if(!(types & SUMMARY_R_HISTOGRAM))
+    return;
+
+// small integer data types are counted in an array
+  switch(prop.getType())
+  {
+    case te::dt::R1BIT_TYPE:
+    case te::dt::R2BITS_TYPE:
+    case te::dt::R4BITS_TYPE:
+    case te::dt::CHAR_TYPE:
+    case te::dt::UCHAR_TYPE:
+    case te::dt::INT16_TYPE:
+    case te::dt::UINT16_TYPE:
+    {
+      double tmin = 0.0;
+      double tmax = 0.0;
+
+      GetDataTypeRanges(prop.getType(), tmin, tmax);
+
+// the range of CHAR_TYPE starts at -127
+      if(prop.getType() == te::dt::CHAR_TYPE)
+        tmin = -128.0;
+
+      if(tmax - tmin + 1.0 <= sg_maxLookupSize)
+      {
+        m_lookupMin = tmin;
+        m_lookup.resize(static_cast<std::size_t>(tmax - tmin + 1.0), 0);
+      }
+    }
+    break;
+
+    default:
+    break;
+  }
+}
+
+void te::rst::RasterStatistics::BandState::add(const double* real, const double* imag, std::size_t n)
+{
+  if(n == 0)
+    return;
+
+  if(!m_complex)
+    imag = 0;
+
+// the extrema and the histograms ignore the no-data values
+  if(m_types & (SUMMARY_MIN | SUMMARY_MAX | SUMMARY_R_HISTOGRAM))
+  {
+    const bool histogram = (m_types & SUMMARY_R_HISTOGRAM) != 0;
+    const double lookupSize = static_cast<double>(m_lookup.size());
+
+    for(std::size_t i = 0; i < n; ++i)
+    {
+      const double v = real[i];
+
+      if(v == m_noData)
+        continue;
+
+      ++m_validCount;
+
+      if(v < m_minReal)
+        m_minReal = v;
+
+      if(v > m_maxReal)
+        m_maxReal = v;
+
+      if(imag)
+      {
+        if(imag[i] < m_minImag)
+          m_minImag = imag[i];
+
+        if(imag[i] > m_maxImag)
+          m_maxImag = imag[i];
+      }
+
+      if(!histogram)
+        continue;
+
+      const double k = v - m_lookupMin;
+
+      if((k >= 0.0) && (k < lookupSize))
+      {
+        const std::size_t idx = static_cast<std::size_t>(k);
+
+        if(static_cast<double>(idx) == k)
+        {
+          ++m_lookup[idx];
+
+          continue;
+        }
+      }
+
+// the values are only sorted and counted when there are many of them (NaN values are not counted)
+      if(v == v)
+        m_pendingR.push_back(v);
+    }
+
+    if(m_pendingR.size() >= sg_maxPendingValues)
+      FlushValues(m_pendingR, m_histogramR);
+  }
+
+  if(imag && (m_types & SUMMARY_I_HISTOGRAM))
+  {
+    for(std::size_t i = 0; i < n; ++i)
+    {
+      if(imag[i] == imag[i])
+        m_pendingI.push_back(imag[i]);
+    }
+
+    if(m_pendingI.size() >= sg_maxPendingValues)
+      FlushValues(m_pendingI, m_histogramI);
+  }
+
+// the moments include all values: the mean and the deviations of this set are merged into the state
+  if(m_types & (SUMMARY_MEAN | SUMMARY_STD))
+  {
+    double sumReal = 0.0;
+    double sumImag = 0.0;
+
+    for(std::size_t i = 0; i < n; ++i)
+      sumReal += real[i];
+
+    if(imag)
+    {
+      for(std::size_t i = 0; i < n; ++i)
+        sumImag += imag[i];
+    }
+
+    const double meanReal = sumReal / static_cast<double>(n);
+    const double meanImag = sumImag / static_cast<double>(n);
+
+    double m2Real = 0.0;
+    double m2Imag = 0.0;
+    double coMoment = 0.0;
+
+    if(imag)
+    {
+      for(std::size_t i = 0; i < n; ++i)
+      {
+        const double dr = real[i] - meanReal;
+        const double di = imag[i] - meanImag;
+
+        m2Real += dr * dr;
+        m2Imag += di * di;
+        coMoment += dr * di;
+      }
+    }
+    else
+    {
+      for(std::size_t i = 0; i < n; ++i)
+      {
+        const double dr = real[i] - meanReal;
+
+        m2Real += dr * dr;
+      }
+    }
+
+    MergeMoments(*this, n, meanReal, meanImag, m2Real, m2Imag, coMoment);
+  }
+
+  m_count += n;
+}
+
+void te::rst::RasterStatistics::BandState::flush()
+{
+  FlushValues(m_pendingR, m_histogramR);
+
+  FlushValues(m_pendingI, m_histogramI);
+}
+
+void te::rst::RasterStatistics::BandState::merge(const BandState& rhs)
+{
+  MergeMoments(*this, rhs.m_count, rhs.m_meanReal, rhs.m_meanImag, rhs.m_m2Real, rhs.m_m2Imag, rhs.m_coMoment);
+
+  m_count += rhs.m_count;
+  m_validCount += rhs.m_validCount;
+
+  m_minReal = std::min(m_minReal, rhs.m_minReal);
+  m_minImag = std::min(m_minImag, rhs.m_minImag);
+  m_maxReal = std::max(m_maxReal, rhs.m_maxReal);
+  m_maxImag = std::max(m_maxImag, rhs.m_maxImag);
+
+  assert(m_lookup.size() == rhs.m_lookup.size());
+
+  for(std::size_t i = 0; i < rhs.m_lookup.size(); ++i)
+    m_lookup[i] += rhs.m_lookup[i];
+
+  MergeHistograms(m_histogramR, rhs.m_histogramR);
+
+  MergeHistograms(m_histogramI, rhs.m_histogramI);
+
+  m_pendingR.insert(m_pendingR.end(), rhs.m_pendingR.begin(), rhs.m_pendingR.end());
+
+  m_pendingI.insert(m_pendingI.end(), rhs.m_pendingI.begin(), rhs.m_pendingI.end());
+
+  flush();
+}
+
+void te::rst::RasterStatistics::BandState::fill(int types, BandSummary& bs) const
+{
+  assert(m_pendingR.empty() && m_pendingI.empty());
+
+  types &= m_types;
+
+// the imaginary part of non complex bands is always zero
+  const bool valid = m_validCount != 0;
+
+  if((types & SUMMARY_MIN) && (bs.m_minVal == 0))
+    bs.m_minVal = new std::complex<double>(m_minReal, (valid && !m_complex) ? 0.0 : m_minImag);
+
+  if((types & SUMMARY_MAX) && (bs.m_maxVal == 0))
+    bs.m_maxVal = new std::complex<double>(m_maxReal, (valid && !m_complex) ? 0.0 : m_maxImag);
+
+  if((types & SUMMARY_MEAN) && (bs.m_meanVal == 0))
+    bs.m_meanVal = new std::complex<double>(m_meanReal, m_meanImag);
+
+  if((types & SUMMARY_STD) && (bs.m_stdVal == 0))
+  {
+    if(m_count <= 1)
+    {
+      bs.m_stdVal = new std::complex<double>(1.0, 1.0);
+    }
+    else
+    {
+// the real and imaginary parts of the sum of the squared complex deviations
+      const double n = static_cast<double>(m_count - 1);
+
+      bs.m_stdVal = new std::complex<double>(std::sqrt((m_m2Real - m_m2Imag) / n), std::sqrt(2.0 * m_coMoment / n));
+    }
+  }
+
+  if((types & SUMMARY_R_HISTOGRAM) && (bs.m_histogramR == 0))
+  {
+    bs.m_histogramR = new std::map<double, unsigned int>(m_histogramR);
+
+    for(std::size_t i = 0; i < m_lookup.size(); ++i)
+    {
+      if(m_lookup[i] != 0)
+        (*bs.m_histogramR)[m_lookupMin + static_cast<double>(i)] += m_lookup[i];
+    }
+  }
+
+  if((types & SUMMARY_I_HISTOGRAM) && (bs.m_histogramI == 0))
+  {
+    if(m_complex)
+    {
+      bs.m_histogramI = new std::map<double, unsigned int>(m_histogramI);
+    }
+    else
+    {
+      bs.m_histogramI = new std::map<double, unsigned int>();
+
+      if(m_count != 0)
+        (*bs.m_histogramI)[0.0] = static_cast<unsigned int>(m_count);
+    }
+  }
+}
+
+te::rst::RasterStatistics::RasterStatistics(const Raster* raster, int types, bool approximate, unsigned int maxThreads)
+  : m_raster(raster),
+    m_types(types),
+    m_approximate(approximate),
+    m_usedOverview(false),
+    m_maxThreads(maxThreads)
+{
+  assert(raster);
+}
+
+te::rst::RasterStatistics::~RasterStatistics()
+{
+}
+
+bool te::rst::RasterStatistics::compute(te::common::TaskProgress* task)
+{
+  std::auto_ptr<Raster> overview;
+
+  m_usedOverview = false;
+
+  if(m_approximate)
+    overview.reset(GetApproximationRaster(*m_raster));
+
+  const Raster* raster = m_raster;
+
+  if(overview.get())
+  {
+    raster = overview.get();
+
+    m_usedOverview = true;
+  }
+
+  const std::size_t nBands = raster->getNumberOfBands();
+  const unsigned int nRows = raster->getNumberOfRows();
+  const unsigned int nCols = raster->getNumberOfColumns();
+
+  m_states.resize(nBands);
+
+  for(std::size_t b = 0; b < nBands; ++b)
+    m_states[b].reset(*raster->getBand(b)->getProperty(), m_types);
+
+  if((nBands == 0) || (nRows == 0) || (nCols == 0))
+    return true;
+
+// the strips have whole blocks of rows, taller for short blocks and shorter for very wide rasters
+  unsigned int stripRows = static_cast<unsigned int>(std::max(raster->getBand(0)->getProperty()->m_blkh, 1));
+
+  const std::size_t stripValues = static_cast<std::size_t>(stripRows) * nCols;
+
+  if(stripValues < sg_minStripValues)
+    stripRows *= static_cast<unsigned int>(sg_minStripValues / stripValues);
+  else if(stripValues > sg_maxStripValues)
+    stripRows = std::max(static_cast<unsigned int>(sg_maxStripValues / nCols), 1u);
+
+  stripRows = std::min(stripRows, nRows);
+
+  ThreadParams params;
+  params.m_engine = this;
+  params.m_raster = raster;
+  params.m_stripRows = stripRows;
+  params.m_nStrips = (nRows + stripRows - 1) / stripRows;
+  params.m_nextStrip = 0;
+  params.m_processedStrips = 0;
+  params.m_runningThreads = 0;
+  params.m_abort = false;
+  params.m_failed = false;
+  params.m_task = 0;
+
+  if(task)
+    task->setTotalSteps(static_cast<int>(params.m_nStrips));
+
+  unsigned int threadsNumber = m_maxThreads ? m_maxThreads : te::common::GetPhysProcNumber();
+  threadsNumber = std::max(threadsNumber, 1u);
+  threadsNumber = static_cast<unsigned int>(std::min(static_cast<std::size_t>(threadsNumber), params.m_nStrips));
+
+  if(threadsNumber == 1)
+  {
+    params.m_task = task;
+    params.m_runningThreads = 1;
+
+    ThreadEntry(&params);
+  }
+  else
+  {
+    params.m_runningThreads = threadsNumber;
+
+    boost::thread_group threads;
+
+    for(unsigned int i = 0; i < threadsNumber; ++i)
+      threads.add_thread(new boost::thread(ThreadEntry, &params));
+
+// the task is only used by this thread
+    {
+      boost::unique_lock<boost::mutex> lock(params.m_mutex);
+
+      std::size_t pulsedStrips = 0;
+
+      while(params.m_runningThreads)
+      {
+        params.m_condVar.wait(lock);
+
+        if(task)
+        {
+          for(; pulsedStrips < params.m_processedStrips; ++pulsedStrips)
+            task->pulse();
+
+          if(!task->isActive())
+            params.m_abort = true;
+        }
+      }
+    }
+
+    threads.join_all();
+  }
+
+  if(params.m_failed)
+    throw Exception(TE_TR("Could not read the raster values!"));
+
+  return !params.m_abort;
+}
+
+bool te::rst::RasterStatistics::isApproximate() const
+{
+  return m_usedOverview;
+}
+
+const te::rst::RasterStatistics::BandState& te::rst::RasterStatistics::getBandState(std::size_t band) const
+{
+  assert(band < m_states.size());
+
+  return m_states[band];
+}
+
+void te::rst::RasterStatistics::fill(RasterSummary& rs) const
+{
+  const std::size_t nBands = std::min(rs.size(), m_states.size());
+
+  for(std::size_t b = 0; b < nBands; ++b)
+    m_states[b].fill(m_types, rs[b]);
+}
+
+te::rst::RasterSummary* te::rst::RasterStatistics::getSummary() const
+{
+  RasterSummary* rs = new RasterSummary(m_states.size());
+
+  for(std::size_t b = 0; b < m_states.size(); ++b)
+    rs->push_back(new BandSummary());
+
+  fill(*rs);
+
+  return rs;
+}
+
+te::rst::Raster* te::rst::RasterStatistics::GetApproximationRaster(const Raster& raster)
+{
+  const unsigned int levels = raster.getMultiResLevelsCount();
+
+// the overviews are sorted from the finest to the coarsest
+  for(unsigned int level = levels; level > 0; --level)
+  {
+    std::auto_ptr<Raster> overview(raster.getMultiResLevel(level - 1));
+
+    if(overview.get() == 0)
+      continue;
+
+    const std::size_t nPixels = static_cast<std::size_t>(overview->getNumberOfRows()) * overview->getNumberOfColumns();
+
+    if((nPixels >= sm_minApproximationPixels) || (level == 1))
+      return overview.release();
+  }
+
+  return 0;
+}
+
+void te::rst::RasterStatistics::ThreadEntry(ThreadParams* params)
+{
+  RasterStatistics* engine = params->m_engine;
+  const Raster* raster = params->m_raster;
+
+  const std::size_t nBands = raster->getNumberOfBands();
+  const unsigned int nRows = raster->getNumberOfRows();
+  const unsigned int nCols = raster->getNumberOfColumns();
+  const std::size_t stripSize = static_cast<std::size_t>(params->m_stripRows) * nCols;
+
+// each thread accumulates its own partial states, merged at the end
+  std::vector<BandState> states(nBands);
+
+  {
+    boost::lock_guard<boost::mutex> lock(params->m_ioMutex);
+
+    for(std::size_t b = 0; b < nBands; ++b)
+      states[b].reset(*raster->getBand(b)->getProperty(), engine->m_types);
+  }
+
+  std::vector<double> real;
+  std::vector<double> imag;
+
+  try
+  {
+    real.resize(stripSize * nBands);
+
+    for(std::size_t b = 0; b < nBands; ++b)
+    {
+      if(states[b].m_complex)
+      {
+        imag.resize(stripSize * nBands, 0.0);
+
+        break;
+      }
+    }
+
+    while(true)
+    {
+      std::size_t strip = 0;
+
+      {
+        boost::lock_guard<boost::mutex> lock(params->m_mutex);
+
+        if(params->m_task && !params->m_task->isActive())
+          params->m_abort = true;
+
+        if(params->m_abort || (params->m_nextStrip >= params->m_nStrips))
+          break;
+
+        strip = params->m_nextStrip++;
+      }
+
+      const unsigned int row = static_cast<unsigned int>(strip) * params->m_stripRows;
+      const unsigned int stripRows = std::min(params->m_stripRows, nRows - row);
+
+// all bands of the strip are read at once
+      {
+        boost::lock_guard<boost::mutex> lock(params->m_ioMutex);
+
+        for(std::size_t b = 0; b < nBands; ++b)
+        {
+          const Band* band = raster->getBand(b);
+
+          band->getValues(0, row, nCols, stripRows, &real[b * stripSize]);
+
+          if(states[b].m_complex)
+            band->getIValues(0, row, nCols, stripRows, &imag[b * stripSize]);
+        }
+      }
+
+      for(std::size_t b = 0; b < nBands; ++b)
+        states[b].add(&real[b * stripSize], states[b].m_complex ? &imag[b * stripSize] : 0,
+                      static_cast<std::size_t>(stripRows) * nCols);
+
+      {
+        boost::lock_guard<boost::mutex> lock(params->m_mutex);
+
+        ++params->m_processedStrips;
+      }
+
+      if(params->m_task)
+        params->m_task->pulse();
+
+      params->m_condVar.notify_one();
+    }
+
+    boost::lock_guard<boost::mutex> lock(params->m_mutex);
+
+    for(std::size_t b = 0; b < nBands; ++b)
+    {
+      states[b].flush();
+
+      engine->m_states[b].merge(states[b]);
+    }
+  }
+  catch(...)
+  {
+    boost::lock_guard<boost::mutex> lock(params->m_mutex);
+
+    params->m_abort = true;
+    params->m_failed = true;
+  }
+
+  {
+    boost::lock_guard<boost::mutex> lock(params->m_mutex);
+
+    --params->m_runningThreads;
+  }
+
+  params->m_condVar.notify_one();
+}
@@ -0,0 +1,235 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+  \file terralib/raster/RasterStatistics.h
+
+  \brief A single pass, multi-threaded engine for the summaries of the raster bands.
+*/
+
+#ifndef __TERRALIB_RASTER_INTERNAL_RASTERSTATISTICS_H
+#define __TERRALIB_RASTER_INTERNAL_RASTERSTATISTICS_H
+
+// TerraLib
+#include "Config.h"
+#include "RasterSummary.h"
+
+// STL
+#include <cstddef>
+#include <map>
+#include <vector>
+
+// Boost
+#include <boost/noncopyable.hpp>
+
+namespace te
+{
+  namespace common { class TaskProgress; }
+
+  namespace rst
+  {
+// Forward declarations
+    class BandProperty;
+    class Raster;
+
+    /*!
+      \class RasterStatistics
+
+      \brief A single pass, multi-threaded engine for the summaries of the raster bands.
+
+      All bands are read together, in strips of rows aligned to the raster
+      blocks, and every requested statistic is computed from the same read.
+      The strips are processed by a pool of threads, each one accumulating
+      its own partial states, which are merged at the end. The raster is only
+      accessed by one thread at a time because the raster drivers are not
+      thread safe.
+
+      The statistics follow the conventions of te::rst::Band:
+
+      <ul>
+      <li>The minimum, the maximum and the real histogram ignore the no-data
+          values (by their real part).</li>
+      <li>The mean, the standard deviation and the imaginary histogram
+          include all values.</li>
+      <li>The standard deviation of a complex band is computed from the
+          squares of the complex deviations, as Band::getStdValue.</li>
+      </ul>
+
+      The histograms of bands with small integer data types (up to 16 bits)
+      are accumulated in arrays. The values of other bands are buffered and
+      sorted, so that each distinct value is inserted once in the map of the
+      occurring values.
+
+      In the approximate mode, the statistics are computed from the coarsest
+      raster overview with at least sm_minApproximationPixels pixels. It
+      behaves as the exact mode when the raster has no overviews.
+
+      \ingroup rst
+
+      \sa RasterSummaryManager, RasterSummary, BandSummary
+    */
+    class TERASTEREXPORT RasterStatistics : public boost::noncopyable
+    {
+      public:
+
+        /*!
+          \struct BandState
+
+          \brief The partial statistics of a band, that can be merged with the
+                 partial statistics of other parts of the same band.
+        */
+        struct TERASTEREXPORT BandState
+        {
+          /*! \brief Constructor. */
+          BandState();
+
+          /*!
+            \brief It clears the state, preparing it for the values of a band.
+
+            \param prop  The band property.
+            \param types The requested summary types (a combination of SummaryTypes).
+          */
+          void reset(const BandProperty& prop, int types);
+
+          /*!
+            \brief It adds a set of values.
+
+            \param real The real values.
+            \param imag The imaginary values (it may be null for non complex bands).
+            \param n    The number of values.
+          */
+          void add(const double* real, const double* imag, std::size_t n);
+
+          /*! \brief It counts the values that are still pending in the map histograms. */
+          void flush();
+
+          /*! \brief It merges the partial statistics of other part of the band. */
+          void merge(const BandState& rhs);
+
+          /*!
+            \brief It fills the requested statistics that are still missing in a band summary.
+
+            \note The state must be flushed.
+
+            \param types The summary types to be filled (a combination of SummaryTypes).
+            \param bs    The band summary.
+          */
+          void fill(int types, BandSummary& bs) const;
+
+          int m_types;                                 //!< The requested summary types.
+          double m_noData;                             //!< The no-data value of the band.
+          bool m_complex;                              //!< True for complex bands.
+          std::size_t m_count;                         //!< The number of values.
+          std::size_t m_validCount;                    //!< The number of values that are not no-data.
+          double m_minReal;                            //!< The minimum real value.
+          double m_minImag;                            //!< The minimum imaginary value.
+          double m_maxReal;                            //!< The maximum real value.
+          double m_maxImag;                            //!< The maximum imaginary value.
+          double m_meanReal;                           //!< The mean of the real values.
+          double m_meanImag;                           //!< The mean of the imaginary values.
+          double m_m2Real;                             //!< The sum of the squared deviations of the real values.
+          double m_m2Imag;                             //!< The sum of the squared deviations of the imaginary values.
+          double m_coMoment;                           //!< The sum of the products of the real and imaginary deviations.
+          double m_lookupMin;                          //!< The value of the first entry of the array histogram.
+          std::vector<unsigned int> m_lookup;          //!< The array histogram of the real values (small integer data types).
+          std::map<double, unsigned int> m_histogramR; //!< The histogram of the real values (other data types).
+          std::map<double, unsigned int> m_histogramI; //!< The histogram of the imaginary values (complex bands).
+          std::vector<double> m_pendingR;              //!< The real values not yet counted in m_histogramR.
+          std::vector<double> m_pendingI;              //!< The imaginary values not yet counted in m_histogramI.
+        };
+
+        /*!
+          \brief Constructor.
+
+          \param raster      The input raster.
+          \param types       The summary types to be computed (a combination of SummaryTypes).
+          \param approximate If true, the statistics may be computed from a raster overview.
+          \param maxThreads  The maximum number of threads (0: the number of processors).
+        */
+        RasterStatistics(const Raster* raster, int types, bool approximate = false,
+                         unsigned int maxThreads = 0);
+
+        /*! \brief Destructor. */
+        ~RasterStatistics();
+
+        /*!
+          \brief It computes the statistics of all bands.
+
+          \param task An optional task: its total steps are set to the number
+                      of strips and it is pulsed for each processed strip.
+
+          \return False if the task was canceled.
+
+          \exception Exception It throws an exception if the raster can not be read.
+        */
+        bool compute(te::common::TaskProgress* task = 0);
+
+        /*! \brief It returns true if the last computation used a raster overview. */
+        bool isApproximate() const;
+
+        /*! \brief It returns the partial statistics of a band. */
+        const BandState& getBandState(std::size_t band) const;
+
+        /*!
+          \brief It fills the requested statistics that are still missing in a raster summary.
+
+          \param rs A summary with one band summary for each raster band.
+        */
+        void fill(RasterSummary& rs) const;
+
+        /*!
+          \brief It creates a raster summary with the computed statistics.
+
+          \return A new summary. The caller takes its ownership.
+        */
+        RasterSummary* getSummary() const;
+
+        /*!
+          \brief It returns the overview used in the approximate mode.
+
+          \param raster The input raster.
+
+          \return The coarsest overview with at least sm_minApproximationPixels
+                  pixels (or the finest one if none has), or null if the
+                  raster has no overviews. The caller takes its ownership.
+        */
+        static Raster* GetApproximationRaster(const Raster& raster);
+
+        static const std::size_t sm_minApproximationPixels = 262144;  //!< The minimum number of pixels of the overview used in the approximate mode (512 x 512).
+
+      private:
+
+        struct ThreadParams;
+
+        static void ThreadEntry(ThreadParams* params);
+
+      private:
+
+        const Raster* m_raster;            //!< The input raster.
+        int m_types;                       //!< The summary types to be computed.
+        bool m_approximate;                //!< If true, an overview may be used.
+        bool m_usedOverview;               //!< True if the last computation used an overview.
+        unsigned int m_maxThreads;         //!< The maximum number of threads.
+        std::vector<BandState> m_states;   //!< The statistics of each band.
+    };
+
+  } // end namespace rst
+}   // end namespace te
+
+#endif  // __TERRALIB_RASTER_INTERNAL_RASTERSTATISTICS_H
@@ -27,14 +27,106 @@
 #include "../common/STLUtils.h"
 #include "Band.h"
 #include "Raster.h"
+#include "RasterStatistics.h"
 #include "RasterSummary.h"
 #include "RasterSummaryManager.h"
 
 // STL
 #include <complex>
+#include <ctime>
+#include <fstream>
+#include <locale>
+
+// Boost
+#include <boost/cstdint.hpp>
+#include <boost/filesystem.hpp>
 
 std::string getConnInfoStr(const te::rst::Raster* raster);
 
+namespace te
+{
+  namespace rst
+  {
+    /*! \brief The first line of the sidecar files. */
+    static const char* sg_summaryFileHeader = "TerraLib raster summary 1";
+
+    /*! \brief It returns the size and the modification time of a file. */
+    static bool GetFileStamp(const std::string& fileName, boost::uintmax_t& size, std::time_t& mtime)
+    {
+      try
+      {
+        size = boost::filesystem::file_size(fileName);
+
+        mtime = boost::filesystem::last_write_time(fileName);
+      }
+      catch(...)
+      {
+        return false;
+      }
+
+      return true;
+    }
+
+    static void WriteComplex(std::ostream& out, const char* key, const std::complex<double>* value)
+    {
+      if(value)
+        out << key << " " << value->real() << " " << value->imag() << "\n";
+    }
+
+    static void WriteHistogram(std::ostream& out, const char* key, const std::map<double, unsigned int>* hist)
+    {
+      if(hist == 0)
+        return;
+
+      out << key << " " << hist->size() << "\n";
+
+      for(std::map<double, unsigned int>::const_iterator it = hist->begin(); it != hist->end(); ++it)
+        out << it->first << " " << it->second << "\n";
+    }
+
+    static bool ReadComplex(std::istream& in, std::complex<double>*& value)
+    {
+      double real = 0.0;
+      double imag = 0.0;
+
+      if(!(in >> real >> imag))
+        return false;
+
+      delete value;
+
+      value = new std::complex<double>(real, imag);
+
+      return true;
+    }
+
+    static bool ReadHistogram(std::istream& in, std::map<double, unsigned int>*& hist)
+    {
+      std::size_t n = 0;
+
+      if(!(in >> n))
+        return false;
+
+      delete hist;
+
+      hist = new std::map<double, unsigned int>();
+
+      for(std::size_t i = 0; i < n; ++i)
+      {
+        double value = 0.0;
+        unsigned int count = 0;
+
+        if(!(in >> value >> count))
+          return false;
+
+        (*hist)[value] = count;
+      }
+
+      return true;
+    }
+
+  } // end namespace rst
+}   // end namespace te
+
 void te::rst::RasterSummaryManager::add(const Raster* raster, RasterSummary* summary)
 {
   std::string connInfoStr = getConnInfoStr(raster);
@@ -42,6 +134,8 @@ void te::rst::RasterSummaryManager::add(const Raster* raster, RasterSummary* sum
   if(m_rasterSummaries.find(connInfoStr) != m_rasterSummaries.end())
     m_rasterSummaries.erase(connInfoStr);
 
+  m_approximateTypes.erase(connInfoStr);
+
   if(!connInfoStr.empty())
     m_rasterSummaries.insert(std::map<std::string, RasterSummary*>::value_type(connInfoStr, summary));
 }
@@ -63,6 +157,8 @@ void te::rst::RasterSummaryManager::remove(const Raster* raster)
   std::string connInfoStr = getConnInfoStr(raster);
 
   m_rasterSummaries.erase(connInfoStr);
+
+  m_approximateTypes.erase(connInfoStr);
 }
 
 const te::rst::RasterSummary* te::rst::RasterSummaryManager::get(const Raster* raster, const SummaryTypes types, bool readall)
@@ -81,66 +177,284 @@ const te::rst::RasterSummary* te::rst::RasterSummaryManager::get(const Raster* r
       rs->push_back(new te::rst::BandSummary());
 
     add(raster, rs);
+
+// the summary computed in a previous session
+    if(m_persistenceEnabled)
+      load(raster, *rs);
   }
   else
     rs = it->second;
 
-  for (std::size_t b = 0; b < raster->getNumberOfBands(); b++)
+// the requested statistics that are still missing
+  int missing = 0;
+
+  for (std::size_t b = 0; b < rs->size(); b++)
   {
-    te::rst::BandSummary& bs = (*rs)[b];
+    const te::rst::BandSummary& bs = (*rs)[b];
+
+    if ((types & te::rst::SUMMARY_MIN) && bs.m_minVal == 0)
+      missing |= te::rst::SUMMARY_MIN;
+
+    if ((types & te::rst::SUMMARY_MAX) && bs.m_maxVal == 0)
+      missing |= te::rst::SUMMARY_MAX;
 
-    if (types & te::rst::SUMMARY_R_HISTOGRAM && bs.m_histogramR == 0)
+    if ((types & te::rst::SUMMARY_STD) && bs.m_stdVal == 0)
+      missing |= te::rst::SUMMARY_STD;
+
+    if ((types & te::rst::SUMMARY_MEAN) && bs.m_meanVal == 0)
+      missing |= te::rst::SUMMARY_MEAN;
+
+    if ((types & te::rst::SUMMARY_R_HISTOGRAM) && bs.m_histogramR == 0)
+      missing |= te::rst::SUMMARY_R_HISTOGRAM;
+
+    if ((types & te::rst::SUMMARY_I_HISTOGRAM) && bs.m_histogramI == 0)
+      missing |= te::rst::SUMMARY_I_HISTOGRAM;
+  }
+
+  if (missing == 0)
+    return rs;
+
+// only the min and max values: approximated from an overview or from random samples
+  if (!readall && (missing & ~(te::rst::SUMMARY_MIN | te::rst::SUMMARY_MAX)) == 0)
+  {
+    if (raster->getMultiResLevelsCount() != 0)
     {
-      bs.m_histogramR = new std::map<double, unsigned>(raster->getBand(b)->getHistogramR());
+      te::rst::RasterStatistics stats(raster, missing, true);
 
-      std::map<double, unsigned>::iterator it = bs.m_histogramR->begin();
+      stats.compute();
 
-      if (!bs.m_minVal)
-        bs.m_minVal = new std::complex<double>(it->first, 0.0);
-      else
-        bs.m_minVal = new std::complex<double>(it->first, bs.m_minVal->imag());
+      stats.fill(*rs);
+    }
+    else
+    {
+      for (std::size_t b = 0; b < rs->size(); b++)
+      {
+        te::rst::BandSummary& bs = (*rs)[b];
 
-      it = bs.m_histogramR->end();
+        if ((missing & te::rst::SUMMARY_MIN) && bs.m_minVal == 0)
+          bs.m_minVal = new std::complex<double>(raster->getBand(b)->getMinValue(false));
 
-      if (!bs.m_maxVal)
-        bs.m_maxVal = new std::complex<double>((--it)->first, 0.0);
-      else
-        bs.m_maxVal = new std::complex<double>((--it)->first, bs.m_maxVal->imag());
+        if ((missing & te::rst::SUMMARY_MAX) && bs.m_maxVal == 0)
+          bs.m_maxVal = new std::complex<double>(raster->getBand(b)->getMaxValue(false));
+      }
     }
 
-    if (types & te::rst::SUMMARY_I_HISTOGRAM && bs.m_histogramI == 0)
+    if (!connInfoStr.empty())
+      m_approximateTypes[connInfoStr] |= missing;
+
+    return rs;
+  }
+
+// all missing statistics in a single pass, also replacing the approximated min and max values
+  std::map<std::string, int>::iterator ait = m_approximateTypes.find(connInfoStr);
+
+  if (ait != m_approximateTypes.end())
+  {
+    for (std::size_t b = 0; b < rs->size(); b++)
     {
-      bs.m_histogramI = new std::map<double, unsigned>(raster->getBand(b)->getHistogramI());
+      te::rst::BandSummary& bs = (*rs)[b];
+
+      if (ait->second & te::rst::SUMMARY_MIN)
+      {
+        delete bs.m_minVal;
+        bs.m_minVal = 0;
+      }
+
+      if (ait->second & te::rst::SUMMARY_MAX)
+      {
+        delete bs.m_maxVal;
+        bs.m_maxVal = 0;
+      }
+    }
+
+    m_approximateTypes.erase(ait);
+  }
+
+  te::rst::RasterStatistics stats(raster, missing | te::rst::SUMMARY_MIN | te::rst::SUMMARY_MAX);
+
+  stats.compute();
+
+  stats.fill(*rs);
+
+  if (m_persistenceEnabled)
+    save(raster, *rs);
+
+  return rs;
+}
+
+void te::rst::RasterSummaryManager::setPersistenceEnabled(bool enabled)
+{
+  m_persistenceEnabled = enabled;
+}
+
+bool te::rst::RasterSummaryManager::isPersistenceEnabled() const
+{
+  return m_persistenceEnabled;
+}
+
+std::string te::rst::RasterSummaryManager::GetSummaryFileName(const Raster* raster)
+{
+  std::map<std::string, std::string> info = raster->getInfo();
+
+  std::map<std::string, std::string>::const_iterator it = info.find("URI");
+
+  if (it == info.end() || it->second.empty())
+    return "";
+
+  try
+  {
+    if (!boost::filesystem::is_regular_file(it->second))
+      return "";
+  }
+  catch(...)
+  {
+    return "";
+  }
+
+  return it->second + ".tesummary";
+}
+
+bool te::rst::RasterSummaryManager::load(const Raster* raster, RasterSummary& summary) const
+{
+  const std::string fileName = GetSummaryFileName(raster);
+
+  if (fileName.empty())
+    return false;
+
+  std::ifstream in(fileName.c_str());
+
+  if (!in.is_open())
+    return false;
+
+  in.imbue(std::locale::classic());
+
+// a summary of other version of the raster file is ignored
+  std::string line;
+
+  if (!std::getline(in, line) || line != sg_summaryFileHeader)
+    return false;
+
+  boost::uintmax_t size = 0;
+  std::time_t mtime = 0;
+
+  if (!GetFileStamp(raster->getInfo()["URI"], size, mtime))
+    return false;
+
+  std::string key;
+  boost::uintmax_t fileSize = 0;
+  std::time_t fileTime = 0;
+
+  if (!(in >> key >> fileSize >> fileTime) || key != "source" || fileSize != size || fileTime != mtime)
+    return false;
 
-      std::map<double, unsigned>::iterator it = bs.m_histogramI->begin();
+  std::size_t nBands = 0;
+  unsigned int nRows = 0;
+  unsigned int nCols = 0;
 
-      if (!bs.m_minVal)
-        bs.m_minVal = new std::complex<double>(0.0, it->first);
-      else
-        bs.m_minVal = new std::complex<double>(bs.m_minVal->real(), it->first);
+  if (!(in >> key >> nBands >> nRows >> nCols) || key != "raster" ||
+      nBands != summary.size() || nBands != raster->getNumberOfBands() ||
+      nRows != raster->getNumberOfRows() || nCols != raster->getNumberOfColumns())
+    return false;
 
-      it = bs.m_histogramI->end();
+// the summary is only changed if the whole file is valid
+  RasterSummary loaded(nBands);
 
-      if (!bs.m_maxVal)
-        bs.m_maxVal = new std::complex<double>(0.0, (--it)->first);
-      else
-        bs.m_maxVal = new std::complex<double>(bs.m_maxVal->real(), (--it)->first);
+  for (std::size_t b = 0; b < nBands; b++)
+    loaded.push_back(new BandSummary());
+
+  std::size_t band = nBands;
+
+  while (in >> key)
+  {
+    if (key == "end")
+    {
+      for (std::size_t b = 0; b < nBands; b++)
+        summary[b] = loaded[b];
+
+      return true;
     }
 
-    if (types & te::rst::SUMMARY_MIN && bs.m_minVal == 0)
-      bs.m_minVal = new std::complex<double>(raster->getBand(b)->getMinValue(readall));
+    bool ok = false;
+
+    if (key == "band")
+    {
+      ok = (in >> band) && band < nBands;
+    }
+    else if (band < nBands)
+    {
+      BandSummary& bs = loaded[band];
+
+      if (key == "min")
+        ok = ReadComplex(in, bs.m_minVal);
+      else if (key == "max")
+        ok = ReadComplex(in, bs.m_maxVal);
+      else if (key == "std")
+        ok = ReadComplex(in, bs.m_stdVal);
+      else if (key == "mean")
+        ok = ReadComplex(in, bs.m_meanVal);
+      else if (key == "histogramR")
+        ok = ReadHistogram(in, bs.m_histogramR);
+      else if (key == "histogramI")
+        ok = ReadHistogram(in, bs.m_histogramI);
+    }
+
+    if (!ok)
+      return false;
+  }
+
+  return false;
+}
+
+void te::rst::RasterSummaryManager::save(const Raster* raster, const RasterSummary& summary) const
+{
+  const std::string fileName = GetSummaryFileName(raster);
+
+  if (fileName.empty())
+    return;
+
+  boost::uintmax_t size = 0;
+  std::time_t mtime = 0;
+
+  if (!GetFileStamp(raster->getInfo()["URI"], size, mtime))
+    return;
 
-    if (types & te::rst::SUMMARY_MAX && bs.m_maxVal == 0)
-      bs.m_maxVal = new std::complex<double>(raster->getBand(b)->getMaxValue(readall));
+// the raster may be in a read only location: the summary is just not kept
+  std::ofstream out(fileName.c_str());
 
-    if (types & te::rst::SUMMARY_STD && bs.m_stdVal == 0)
-      bs.m_stdVal = new std::complex<double>(raster->getBand(b)->getStdValue());
+  if (!out.is_open())
+    return;
+
+  out.imbue(std::locale::classic());
+  out.precision(17);
+
+  out << sg_summaryFileHeader << "\n";
+  out << "source " << size << " " << mtime << "\n";
+  out << "raster " << summary.size() << " " << raster->getNumberOfRows() << " " << raster->getNumberOfColumns() << "\n";
+
+  for (std::size_t b = 0; b < summary.size(); b++)
+  {
+    const BandSummary& bs = summary[b];
 
-    if (types & te::rst::SUMMARY_MEAN && bs.m_meanVal == 0)
-      bs.m_meanVal = new std::complex<double>(raster->getBand(b)->getMeanValue());
+    out << "band " << b << "\n";
+
+    WriteComplex(out, "min", bs.m_minVal);
+    WriteComplex(out, "max", bs.m_maxVal);
+    WriteComplex(out, "std", bs.m_stdVal);
+    WriteComplex(out, "mean", bs.m_meanVal);
+    WriteHistogram(out, "histogramR", bs.m_histogramR);
+    WriteHistogram(out, "histogramI", bs.m_histogramI);
   }
 
-  return rs;
+  out << "end\n";
+
+  out.close();
+
+  if (out.fail())
+  {
+    boost::system::error_code ec;
+
+    boost::filesystem::remove(fileName, ec);
+  }
 }
 
 te::rst::RasterSummaryManager::~RasterSummaryManager()
@@ -151,6 +465,7 @@ te::rst::RasterSummaryManager::~RasterSummaryManager()
 }
 
 te::rst::RasterSummaryManager::RasterSummaryManager()
+  : m_persistenceEnabled(true)
 {
 }
 
@@ -34,6 +34,7 @@
 
 //STL
 #include <map>
+#include <string>
 
 namespace te
 {
@@ -49,6 +50,13 @@ namespace te
              It stores an internal map of raster conn info str and their
              respective summaries.
 
+      The summaries are computed by RasterStatistics, in a single pass over
+      the raster for all requested statistics. The summaries of rasters
+      stored in files are kept in a sidecar file (the raster file name plus
+      the ".tesummary" extension), loaded the next time the summary of the
+      same raster is requested. A sidecar file is ignored when the raster
+      file was modified after it was written.
+
       \ingroup rst
 
       \sa RasterSummary, BandSummary.
@@ -94,9 +102,33 @@ namespace te
           \param readall     Force the reading the entire image (can be slow) for computing min and max values.
 
           \return The calculated raster summary.
+
+          \note When only the min and max values are missing and readall is false, they are
+                approximated from a raster overview or, if there is none, from random samples.
+                The approximated values are replaced by exact ones in the next full computation
+                and they are never saved in the sidecar file.
         */
         const RasterSummary* get(const Raster* raster, const SummaryTypes st, bool readall = false);
 
+        /*!
+          \brief It enables or disables the sidecar files of the raster summaries.
+
+          \param enabled If false, the summaries are neither loaded from nor saved to sidecar files.
+        */
+        void setPersistenceEnabled(bool enabled);
+
+        /*! \brief It returns true if the sidecar files of the raster summaries are enabled. */
+        bool isPersistenceEnabled() const;
+
+        /*!
+          \brief It returns the name of the sidecar file of a raster summary.
+
+          \param raster The raster.
+
+          \return The sidecar file name, or an empty string if the raster is not stored in a file.
+        */
+        static std::string GetSummaryFileName(const Raster* raster);
+
         /*! \brief Destructor. */
         ~RasterSummaryManager();
 
@@ -105,9 +137,19 @@ namespace te
         /*! \brief Constructor. */
         RasterSummaryManager();
 
+      private:
+
+        /*! \brief It loads the summary of a raster from its sidecar file, returning false if there is no valid one. */
+        bool load(const Raster* raster, RasterSummary& summary) const;
+
+        /*! \brief It saves a raster summary to its sidecar file. */
+        void save(const Raster* raster, const RasterSummary& summary) const;
+
       private:
 
         std::map<std::string, RasterSummary*> m_rasterSummaries;    //!< A map of rasters conn info and their respective summaries.
+        std::map<std::string, int> m_approximateTypes;              //!< The summary types of each raster that were approximated.
+        bool m_persistenceEnabled;                                  //!< If true, the summaries are kept in sidecar files.
     };
 
   } // end namespace rst
@@ -0,0 +1,1158 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+  \file terralib/raster/Rasterizer.cpp
+
+  \brief A tile-parallel scanline rasterizer of vector geometries.
+*/
+
+// TerraLib
+#include "../common/PlatformUtils.h"
+#include "../common/progress/TaskProgress.h"
+#include "../core/translator/Translator.h"
+#include "../geometry/AbstractPoint.h"
+#include "../geometry/GeometryCollection.h"
+#include "../geometry/LineString.h"
+#include "../geometry/Polygon.h"
+#include "Band.h"
+#include "BandProperty.h"
+#include "BlockUtils.h"
+#include "Exception.h"
+#include "Raster.h"
+#include "Rasterizer.h"
+
+// STL
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+// Boost
+#include <boost/thread.hpp>
+
+namespace
+{
+  /*! \brief The minimum size of a tile, in cells. Tiles are made of whole blocks. */
+  const unsigned int sg_minTileSize = 256;
+
+  /*! \brief Larger blocks (e.g. strips of whole rows) are split in tiles of this size. */
+  const unsigned int sg_maxTileSize = 1024;
+
+  /*! \brief The number of rows of each strip of the shapes index. */
+  const unsigned int sg_indexRows = 256;
+
+  /*! \brief The covered fraction of a cell below which it is not touched (round-off errors). */
+  const double sg_minCoverage = 1.0e-9;
+
+  /*! \brief It returns the size of the tiles in one direction. */
+  unsigned int GetTileSize(unsigned int blockSize, unsigned int rasterSize)
+  {
+    unsigned int size = std::max(blockSize, 1u);
+
+    if(size > sg_maxTileSize)
+      size = sg_maxTileSize;
+    else
+      size *= std::max(1u, sg_minTileSize / size);
+
+    return std::max(std::min(size, rasterSize), 1u);
+  }
+
+  /*! \brief A polygon edge, in grid coordinates, with m_y0 < m_y1. */
+  struct Edge
+  {
+    double m_y0;
+    double m_y1;
+    double m_x0;     //!< The column at m_y0.
+    double m_slope;  //!< The column increment by row.
+
+    bool operator<(const Edge& rhs) const
+    {
+      return m_y0 < rhs.m_y0;
+    }
+  };
+
+  /*!
+    \brief It accumulates the signed area of an edge into the cells of the rows it crosses.
+
+    The cell i of a row covers [i, i + 1] and the edge must be inside [0, width].
+    After all edges of a polygon are accumulated, the covered fraction of each
+    cell is the sum of the accumulated values of the cells up to it.
+  */
+  void AccumulateEdge(double* acc, std::size_t stride, double height,
+                      double x0, double y0, double x1, double y1)
+  {
+    if(y0 == y1)
+      return;
+
+    double dir = 1.0;
+
+    if(y0 > y1)
+    {
+      std::swap(x0, x1);
+      std::swap(y0, y1);
+      dir = -1.0;
+    }
+
+    const double yStart = std::max(y0, 0.0);
+    const double yEnd = std::min(y1, height);
+
+    if(yStart >= yEnd)
+      return;
+
+    const double dxdy = (x1 - x0) / (y1 - y0);
+
+    double x = x0 + (yStart - y0) * dxdy;
+
+    for(int row = static_cast<int>(std::floor(yStart)); row < yEnd; ++row)
+    {
+      const double dy = std::min(row + 1.0, yEnd) - std::max(static_cast<double>(row), yStart);
+      const double xNext = x + dxdy * dy;
+      const double d = dy * dir;
+
+      double* line = acc + row * stride;
+
+      const double xa = std::min(x, xNext);
+      const double xb = std::max(x, xNext);
+      const double xaFloor = std::floor(xa);
+      const double xbCeil = std::ceil(xb);
+      const int ia = static_cast<int>(xaFloor);
+      const int ib = static_cast<int>(xbCeil);
+
+      if(ib <= ia + 1)
+      {
+// the edge crosses a single cell: the area at its right is a trapezoid
+        const double xm = 0.5 * (x + xNext) - xaFloor;
+
+        line[ia] += d - d * xm;
+        line[ia + 1] += d * xm;
+      }
+      else
+      {
+        const double s = 1.0 / (xb - xa);
+        const double xaf = xa - xaFloor;
+        const double a0 = 0.5 * s * (1.0 - xaf) * (1.0 - xaf);
+        const double xbf = xb - xbCeil + 1.0;
+        const double am = 0.5 * s * xbf * xbf;
+
+        line[ia] += d * a0;
+
+        if(ib == ia + 2)
+        {
+          line[ia + 1] += d * (1.0 - a0 - am);
+        }
+        else
+        {
+          const double a1 = s * (1.5 - xaf);
+
+          line[ia + 1] += d * (a1 - a0);
+
+          for(int i = ia + 2; i < ib - 1; ++i)
+            line[i] += d * s;
+
+          const double a2 = a1 + (ib - ia - 3) * s;
+
+          line[ib - 1] += d * (1.0 - a2 - am);
+        }
+
+        line[ib] += d * am;
+      }
+
+      x = xNext;
+    }
+  }
+
+  /*!
+    \brief It accumulates an edge that may cross the left or the right border of the cells.
+
+    The parts outside [0, width] are projected on the borders: they still
+    change the winding of the cells at their right.
+  */
+  void AccumulateClippedEdge(double* acc, std::size_t stride, double width, double height,
+                             const te::gm::Coord2D& a, const te::gm::Coord2D& b)
+  {
+    if(a.y == b.y)
+      return;
+
+    double t[4];
+    std::size_t n = 0;
+
+    t[n++] = 0.0;
+
+    if((a.x < 0.0) != (b.x < 0.0))
+      t[n++] = (0.0 - a.x) / (b.x - a.x);
+
+    if((a.x > width) != (b.x > width))
+      t[n++] = (width - a.x) / (b.x - a.x);
+
+    t[n++] = 1.0;
+
+    std::sort(t, t + n);
+
+    const double dx = b.x - a.x;
+    const double dy = b.y - a.y;
+
+    for(std::size_t i = 0; i + 1 < n; ++i)
+    {
+      const double x0 = std::min(std::max(a.x + t[i] * dx, 0.0), width);
+      const double y0 = a.y + t[i] * dy;
+      const double x1 = std::min(std::max(a.x + t[i + 1] * dx, 0.0), width);
+      const double y1 = (i + 2 == n) ? b.y : a.y + t[i + 1] * dy;
+
+      AccumulateEdge(acc, stride, height, x0, y0, x1, y1);
+    }
+  }
+
+  /*! \brief It returns the index of the cell that contains the given grid coordinate. */
+  inline int GetCell(double v)
+  {
+    return static_cast<int>(std::floor(v + 0.5));
+  }
+}
+
+struct te::rst::Rasterizer::Span
+{
+  int m_row;
+  int m_firstCol;
+  int m_lastCol;
+
+  bool operator<(const Span& rhs) const
+  {
+    return (m_row < rhs.m_row) || ((m_row == rhs.m_row) && (m_firstCol < rhs.m_firstCol));
+  }
+};
+
+struct te::rst::Rasterizer::Tile
+{
+  unsigned int m_row;
+  unsigned int m_col;
+  unsigned int m_width;
+  unsigned int m_height;
+  std::vector<double> m_values;        //!< The cell values, band by band.
+  std::vector<unsigned int> m_counts;  //!< The number of geometries that burned each cell.
+  std::vector<Span> m_spans;           //!< The spans of the current shape.
+  std::vector<double> m_coverage;      //!< The covered fractions of the current shape.
+};
+
+struct te::rst::Rasterizer::ThreadParams
+{
+  Rasterizer* m_rasterizer;
+  Raster* m_raster;                                   //!< The output raster, or null to write to m_buffers.
+  std::vector<double*> m_buffers;                     //!< The output buffers of a strip.
+  std::vector<double> m_background;                   //!< The value of the cells not burned, for each band.
+  std::size_t m_nBands;
+  unsigned int m_firstRow;
+  unsigned int m_nRows;
+  unsigned int m_tileWidth;
+  unsigned int m_tileHeight;
+  unsigned int m_tilesX;
+  std::vector<std::vector<std::size_t> > m_tileShapes; //!< The shapes that may burn each tile.
+  std::size_t m_nextTile;
+  std::size_t m_processedTiles;
+  unsigned int m_runningThreads;
+  bool m_pulse;                                       //!< If true, the task is pulsed for each tile.
+  bool m_abort;
+  bool m_failed;
+  te::common::TaskProgress* m_task;                   //!< Only informed when there is a single thread.
+  boost::mutex m_mutex;                               //!< It protects the members above.
+  boost::condition_variable m_condVar;
+  boost::mutex m_ioMutex;                             //!< It serializes the raster writes.
+};
+
+te::rst::Rasterizer::Rasterizer(const Grid& grid, MergeRule rule, bool allTouched, unsigned int maxThreads)
+  : m_grid(grid),
+    m_rule(rule),
+    m_allTouched(allTouched),
+    m_maxThreads(maxThreads),
+    m_nValues(0),
+    m_nGeometries(0),
+    m_indexValid(false)
+{
+  m_rings.push_back(0);
+}
+
+te::rst::Rasterizer::~Rasterizer()
+{
+}
+
+const te::rst::Grid& te::rst::Rasterizer::getGrid() const
+{
+  return m_grid;
+}
+
+void te::rst::Rasterizer::add(const te::gm::Geometry* geom, const std::vector<double>& values)
+{
+  assert(geom);
+  assert((m_nGeometries == 0) || (values.size() == m_nValues));
+
+  if(m_nGeometries == 0)
+    m_nValues = values.size();
+
+  ++m_nGeometries;
+
+  m_indexValid = false;
+
+  const std::size_t value = m_values.size();
+
+  m_values.insert(m_values.end(), values.begin(), values.end());
+
+// a collection may have parts of each dimension: they are burned as different shapes
+  const te::gm::GeomType types[] = { te::gm::PolygonType, te::gm::LineStringType, te::gm::PointType };
+
+  bool added = false;
+
+  for(std::size_t i = 0; i < 3; ++i)
+  {
+    Shape shape;
+    shape.m_type = types[i];
+    shape.m_firstRing = m_rings.size() - 1;
+    shape.m_value = value;
+
+    addParts(geom, types[i], shape);
+
+    shape.m_nRings = m_rings.size() - 1 - shape.m_firstRing;
+
+    if(shape.m_nRings && addShape(shape))
+      added = true;
+  }
+
+  if(!added)
+    m_values.resize(value);
+}
+
+void te::rst::Rasterizer::add(const te::gm::Geometry* geom, double value)
+{
+  add(geom, std::vector<double>(1, value));
+}
+
+std::size_t te::rst::Rasterizer::getNumberOfGeometries() const
+{
+  return m_nGeometries;
+}
+
+void te::rst::Rasterizer::clear()
+{
+  m_nValues = 0;
+  m_nGeometries = 0;
+  m_shapes.clear();
+  m_coords.clear();
+  m_rings.clear();
+  m_rings.push_back(0);
+  m_values.clear();
+  m_index.clear();
+  m_indexValid = false;
+}
+
+void te::rst::Rasterizer::addParts(const te::gm::Geometry* geom, te::gm::GeomType type, Shape& shape)
+{
+  const te::gm::GeometryCollection* collection = dynamic_cast<const te::gm::GeometryCollection*>(geom);
+
+  if(collection)
+  {
+    for(std::size_t i = 0; i < collection->getNumGeometries(); ++i)
+      addParts(collection->getGeometryN(i), type, shape);
+
+    return;
+  }
+
+  switch(type)
+  {
+    case te::gm::PolygonType:
+    {
+      const te::gm::Polygon* polygon = dynamic_cast<const te::gm::Polygon*>(geom);
+
+      if(polygon == 0)
+        return;
+
+      for(std::size_t r = 0; r < polygon->getNumRings(); ++r)
+      {
+        const te::gm::LineString* ring = dynamic_cast<const te::gm::LineString*>(polygon->getRingN(r));
+
+        if(ring && (ring->getNPoints() > 2))
+          addRing(ring->getCoordinates(), ring->getNPoints(), true, r != 0);
+      }
+    }
+    break;
+
+    case te::gm::LineStringType:
+    {
+      const te::gm::LineString* line = dynamic_cast<const te::gm::LineString*>(geom);
+
+      if(line && line->getNPoints())
+        addRing(line->getCoordinates(), line->getNPoints(), false, false);
+    }
+    break;
+
+    case te::gm::PointType:
+    {
+      const te::gm::AbstractPoint* point = dynamic_cast<const te::gm::AbstractPoint*>(geom);
+
+      if(point == 0)
+        return;
+
+      te::gm::Coord2D c(point->getX(), point->getY());
+
+      addRing(&c, 1, false, false);
+    }
+    break;
+
+    default:
+    break;
+  }
+}
+
+void te::rst::Rasterizer::addRing(const te::gm::Coord2D* coords, std::size_t npts, bool polygon, bool hole)
+{
+  const std::size_t first = m_coords.size();
+
+  m_coords.resize(first + npts);
+
+  te::gm::Coord2D* c = &m_coords[first];
+
+  for(std::size_t i = 0; i < npts; ++i)
+    m_grid.geoToGrid(coords[i].x, coords[i].y, c[i].x, c[i].y);
+
+  if(polygon)
+  {
+// the area coverage needs exterior rings and holes with opposite orientations
+    double area = 0.0;
+
+    for(std::size_t i = 0; i < npts; ++i)
+    {
+      const te::gm::Coord2D& a = c[i];
+      const te::gm::Coord2D& b = c[(i + 1) % npts];
+
+      area += a.x * b.y - b.x * a.y;
+    }
+
+    if((area < 0.0) != hole)
+      std::reverse(c, c + npts);
+  }
+
+  m_rings.push_back(m_coords.size());
+}
+
+bool te::rst::Rasterizer::addShape(Shape& shape)
+{
+  double minX = std::numeric_limits<double>::max();
+  double maxX = -std::numeric_limits<double>::max();
+  double minY = std::numeric_limits<double>::max();
+  double maxY = -std::numeric_limits<double>::max();
+
+  for(std::size_t i = m_rings[shape.m_firstRing]; i < m_coords.size(); ++i)
+  {
+    minX = std::min(minX, m_coords[i].x);
+    maxX = std::max(maxX, m_coords[i].x);
+    minY = std::min(minY, m_coords[i].y);
+    maxY = std::max(maxY, m_coords[i].y);
+  }
+
+  const int nCols = static_cast<int>(m_grid.getNumberOfColumns());
+  const int nRows = static_cast<int>(m_grid.getNumberOfRows());
+
+// the cells that contain the bounding box corners
+  shape.m_firstCol = std::max(GetCell(minX), 0);
+  shape.m_lastCol = std::min(GetCell(maxX), nCols - 1);
+  shape.m_firstRow = std::max(GetCell(minY), 0);
+  shape.m_lastRow = std::min(GetCell(maxY), nRows - 1);
+
+  if((shape.m_firstCol > shape.m_lastCol) || (shape.m_firstRow > shape.m_lastRow))
+  {
+    m_coords.resize(m_rings[shape.m_firstRing]);
+    m_rings.resize(shape.m_firstRing + 1);
+
+    return false;
+  }
+
+  m_shapes.push_back(shape);
+
+  return true;
+}
+
+void te::rst::Rasterizer::buildIndex()
+{
+  m_index.clear();
+  m_index.resize((m_grid.getNumberOfRows() + sg_indexRows - 1) / sg_indexRows);
+
+  for(std::size_t s = 0; s < m_shapes.size(); ++s)
+  {
+    const Shape& shape = m_shapes[s];
+
+    for(int k = shape.m_firstRow / sg_indexRows; k <= shape.m_lastRow / static_cast<int>(sg_indexRows); ++k)
+      m_index[k].push_back(s);
+  }
+
+  m_indexValid = true;
+}
+
+bool te::rst::Rasterizer::rasterize(Raster* raster, te::common::TaskProgress* task)
+{
+  assert(raster);
+
+  if((raster->getNumberOfColumns() != m_grid.getNumberOfColumns()) ||
+     (raster->getNumberOfRows() != m_grid.getNumberOfRows()))
+    throw Exception(TE_TR("The raster and the rasterizer grids don't match!"));
+
+  if(raster->getNumberOfBands() < m_nValues)
+    throw Exception(TE_TR("The raster doesn't have a band for each geometry value!"));
+
+  ThreadParams params;
+  params.m_raster = raster;
+  params.m_nBands = m_nGeometries ? m_nValues : raster->getNumberOfBands();
+  params.m_firstRow = 0;
+  params.m_nRows = m_grid.getNumberOfRows();
+  params.m_pulse = true;
+
+  for(std::size_t b = 0; b < params.m_nBands; ++b)
+    params.m_background.push_back(raster->getBand(b)->getProperty()->m_noDataValue);
+
+// the tiles are aligned to the blocks of the first band
+  const BandProperty* bandProp = raster->getBand(0)->getProperty();
+
+  params.m_tileWidth = GetTileSize(static_cast<unsigned int>(bandProp->m_blkw), m_grid.getNumberOfColumns());
+  params.m_tileHeight = GetTileSize(static_cast<unsigned int>(bandProp->m_blkh), m_grid.getNumberOfRows());
+
+  return run(params, task);
+}
+
+bool te::rst::Rasterizer::rasterize(unsigned int firstRow, unsigned int nRows,
+                                    const std::vector<double*>& buffers, double background,
+                                    te::common::TaskProgress* task)
+{
+  assert(firstRow + nRows <= m_grid.getNumberOfRows());
+  assert((m_nGeometries == 0) || (buffers.size() == m_nValues));
+
+  ThreadParams params;
+  params.m_raster = 0;
+  params.m_buffers = buffers;
+  params.m_nBands = buffers.size();
+  params.m_background.assign(buffers.size(), background);
+  params.m_firstRow = firstRow;
+  params.m_nRows = nRows;
+  params.m_pulse = false;
+  params.m_tileWidth = GetTileSize(sg_minTileSize, m_grid.getNumberOfColumns());
+  params.m_tileHeight = GetTileSize(sg_minTileSize, nRows);
+
+  return run(params, task);
+}
+
+bool te::rst::Rasterizer::run(ThreadParams& params, te::common::TaskProgress* task)
+{
+  if((params.m_nRows == 0) || (params.m_nBands == 0))
+    return true;
+
+  params.m_rasterizer = this;
+  params.m_tilesX = (m_grid.getNumberOfColumns() + params.m_tileWidth - 1) / params.m_tileWidth;
+  params.m_nextTile = 0;
+  params.m_processedTiles = 0;
+  params.m_runningThreads = 0;
+  params.m_abort = false;
+  params.m_failed = false;
+  params.m_task = 0;
+
+  const unsigned int tilesY = (params.m_nRows + params.m_tileHeight - 1) / params.m_tileHeight;
+
+  params.m_tileShapes.resize(params.m_tilesX * tilesY);
+
+// the shapes are distributed to the tiles they may burn
+  if(!m_indexValid)
+    buildIndex();
+
+  const int firstRow = static_cast<int>(params.m_firstRow);
+  const int lastRow = static_cast<int>(params.m_firstRow + params.m_nRows) - 1;
+
+  for(int k = firstRow / sg_indexRows; k <= lastRow / static_cast<int>(sg_indexRows); ++k)
+  {
+    const std::vector<std::size_t>& shapes = m_index[k];
+
+    for(std::size_t i = 0; i < shapes.size(); ++i)
+    {
+      const Shape& shape = m_shapes[shapes[i]];
+
+      const int r0 = std::max(shape.m_firstRow, firstRow);
+      const int r1 = std::min(shape.m_lastRow, lastRow);
+
+// a shape is listed in all index strips it crosses: it is only taken from the first one in the rows
+      if((r0 > r1) || (r0 / static_cast<int>(sg_indexRows) != k))
+        continue;
+
+      const unsigned int firstTileY = static_cast<unsigned int>(r0 - firstRow) / params.m_tileHeight;
+      const unsigned int lastTileY = static_cast<unsigned int>(r1 - firstRow) / params.m_tileHeight;
+      const unsigned int firstTileX = static_cast<unsigned int>(shape.m_firstCol) / params.m_tileWidth;
+      const unsigned int lastTileX = static_cast<unsigned int>(shape.m_lastCol) / params.m_tileWidth;
+
+      for(unsigned int ty = firstTileY; ty <= lastTileY; ++ty)
+      {
+        for(unsigned int tx = firstTileX; tx <= lastTileX; ++tx)
+          params.m_tileShapes[ty * params.m_tilesX + tx].push_back(shapes[i]);
+      }
+    }
+  }
+
+// the shapes are burned in the order they were added
+  for(std::size_t t = 0; t < params.m_tileShapes.size(); ++t)
+    std::sort(params.m_tileShapes[t].begin(), params.m_tileShapes[t].end());
+
+  const std::size_t nTiles = params.m_tileShapes.size();
+
+  if(task && params.m_pulse)
+    task->setTotalSteps(static_cast<int>(nTiles));
+
+  unsigned int threadsNumber = m_maxThreads ? m_maxThreads : te::common::GetPhysProcNumber();
+  threadsNumber = std::max(threadsNumber, 1u);
+  threadsNumber = static_cast<unsigned int>(std::min(static_cast<std::size_t>(threadsNumber), nTiles));
+
+  if(threadsNumber == 1)
+  {
+    params.m_task = task;
+    params.m_runningThreads = 1;
+
+    ThreadEntry(&params);
+  }
+  else
+  {
+    params.m_runningThreads = threadsNumber;
+
+    boost::thread_group threads;
+
+    for(unsigned int i = 0; i < threadsNumber; ++i)
+      threads.add_thread(new boost::thread(ThreadEntry, &params));
+
+// the task is only used by this thread
+    {
+      boost::unique_lock<boost::mutex> lock(params.m_mutex);
+
+      std::size_t pulsedTiles = 0;
+
+      while(params.m_runningThreads)
+      {
+        params.m_condVar.wait(lock);
+
+        if(task)
+        {
+          for(; params.m_pulse && (pulsedTiles < params.m_processedTiles); ++pulsedTiles)
+            task->pulse();
+
+          if(!task->isActive())
+            params.m_abort = true;
+        }
+      }
+    }
+
+    threads.join_all();
+  }
+
+  if(params.m_failed)
+    throw Exception(TE_TR("Could not write the rasterized values!"));
+
+  return !params.m_abort;
+}
+
+void te::rst::Rasterizer::burn(const Shape& shape, Tile& tile) const
+{
+  const int firstRow = std::max(shape.m_firstRow, static_cast<int>(tile.m_row));
+  const int lastRow = std::min(shape.m_lastRow, static_cast<int>(tile.m_row + tile.m_height) - 1);
+  const int firstCol = std::max(shape.m_firstCol, static_cast<int>(tile.m_col));
+  const int lastCol = std::min(shape.m_lastCol, static_cast<int>(tile.m_col + tile.m_width) - 1);
+
+  if((firstRow > lastRow) || (firstCol > lastCol))
+    return;
+
+  if((shape.m_type == te::gm::PolygonType) && (m_allTouched || (m_rule == MergeAreaFraction)))
+  {
+    coverPolygon(shape, firstRow, lastRow, firstCol, lastCol, tile.m_coverage);
+
+    const std::size_t stride = static_cast<std::size_t>(lastCol - firstCol) + 3;
+
+    for(int r = firstRow; r <= lastRow; ++r)
+    {
+      const double* coverage = &tile.m_coverage[(r - firstRow) * stride];
+
+      for(int c = firstCol; c <= lastCol; ++c)
+      {
+        const double weight = coverage[c - firstCol];
+
+        if(weight > sg_minCoverage)
+          merge(shape, tile, r, c, (m_rule == MergeAreaFraction) ? weight : 1.0);
+      }
+    }
+
+    return;
+  }
+
+  std::vector<Span>& spans = tile.m_spans;
+
+  spans.clear();
+
+  if(shape.m_type == te::gm::PolygonType)
+    fillPolygon(shape, firstRow, lastRow, firstCol, lastCol, spans);
+  else if(shape.m_type == te::gm::LineStringType)
+    drawLines(shape, firstRow, lastRow, firstCol, lastCol, spans);
+  else
+    drawPoints(shape, firstRow, lastRow, firstCol, lastCol, spans);
+
+  if(spans.empty())
+    return;
+
+// a shape burns each cell only once, even where its parts overlap
+  std::sort(spans.begin(), spans.end());
+
+  std::size_t n = 0;
+
+  for(std::size_t i = 1; i < spans.size(); ++i)
+  {
+    Span& last = spans[n];
+
+    if((spans[i].m_row == last.m_row) && (spans[i].m_firstCol <= last.m_lastCol + 1))
+      last.m_lastCol = std::max(last.m_lastCol, spans[i].m_lastCol);
+    else
+      spans[++n] = spans[i];
+  }
+
+  spans.resize(n + 1);
+
+  for(std::size_t i = 0; i < spans.size(); ++i)
+  {
+    for(int c = spans[i].m_firstCol; c <= spans[i].m_lastCol; ++c)
+      merge(shape, tile, spans[i].m_row, c, 1.0);
+  }
+}
+
+void te::rst::Rasterizer::fillPolygon(const Shape& shape, int firstRow, int lastRow,
+                                      int firstCol, int lastCol, std::vector<Span>& spans) const
+{
+  std::vector<Edge> edges;
+
+  for(std::size_t r = shape.m_firstRing; r < shape.m_firstRing + shape.m_nRings; ++r)
+  {
+    const te::gm::Coord2D* c = &m_coords[m_rings[r]];
+    const std::size_t npts = m_rings[r + 1] - m_rings[r];
+
+    for(std::size_t i = 0; i < npts; ++i)
+    {
+      const te::gm::Coord2D& a = c[i];
+      const te::gm::Coord2D& b = c[(i + 1) % npts];
+
+      if(a.y == b.y)
+        continue;
+
+      Edge edge;
+
+      if(a.y < b.y)
+      {
+        edge.m_y0 = a.y;
+        edge.m_y1 = b.y;
+        edge.m_x0 = a.x;
+      }
+      else
+      {
+        edge.m_y0 = b.y;
+        edge.m_y1 = a.y;
+        edge.m_x0 = b.x;
+      }
+
+// an edge crosses the row center when m_y0 <= y < m_y1
+      if((edge.m_y1 <= firstRow) || (edge.m_y0 > lastRow))
+        continue;
+
+      edge.m_slope = (b.x - a.x) / (b.y - a.y);
+
+      edges.push_back(edge);
+    }
+  }
+
+  std::sort(edges.begin(), edges.end());
+
+  std::vector<const Edge*> active;
+  std::vector<double> crossings;
+
+  std::size_t nextEdge = 0;
+
+  for(int row = firstRow; row <= lastRow; ++row)
+  {
+    const double y = static_cast<double>(row);
+
+    while((nextEdge < edges.size()) && (edges[nextEdge].m_y0 <= y))
+      active.push_back(&edges[nextEdge++]);
+
+    crossings.clear();
+
+    std::size_t nActive = 0;
+
+    for(std::size_t i = 0; i < active.size(); ++i)
+    {
+      const Edge* edge = active[i];
+
+      if(edge->m_y1 <= y)
+        continue;
+
+      active[nActive++] = edge;
+
+      crossings.push_back(edge->m_x0 + (y - edge->m_y0) * edge->m_slope);
+    }
+
+    active.resize(nActive);
+
+    std::sort(crossings.begin(), crossings.end());
+
+    for(std::size_t i = 0; i + 1 < crossings.size(); i += 2)
+    {
+      const double first = std::max(std::ceil(crossings[i]), static_cast<double>(firstCol));
+      const double last = std::min(std::floor(crossings[i + 1]), static_cast<double>(lastCol));
+
+      if(first > last)
+        continue;
+
+      Span span;
+      span.m_row = row;
+      span.m_firstCol = static_cast<int>(first);
+      span.m_lastCol = static_cast<int>(last);
+
+      spans.push_back(span);
+    }
+  }
+}
+
+void te::rst::Rasterizer::coverPolygon(const Shape& shape, int firstRow, int lastRow,
+                                       int firstCol, int lastCol, std::vector<double>& coverage) const
+{
+  const std::size_t width = static_cast<std::size_t>(lastCol - firstCol) + 1;
+  const std::size_t height = static_cast<std::size_t>(lastRow - firstRow) + 1;
+  const std::size_t stride = width + 2;
+
+  coverage.assign(stride * height, 0.0);
+
+// the cell (firstCol, firstRow) covers [0, 1] x [0, 1]
+  const double dx = 0.5 - firstCol;
+  const double dy = 0.5 - firstRow;
+
+  for(std::size_t r = shape.m_firstRing; r < shape.m_firstRing + shape.m_nRings; ++r)
+  {
+    const te::gm::Coord2D* c = &m_coords[m_rings[r]];
+    const std::size_t npts = m_rings[r + 1] - m_rings[r];
+
+    for(std::size_t i = 0; i < npts; ++i)
+    {
+      const te::gm::Coord2D& a = c[i];
+      const te::gm::Coord2D& b = c[(i + 1) % npts];
+
+      AccumulateClippedEdge(&coverage[0], stride, static_cast<double>(width), static_cast<double>(height),
+                            te::gm::Coord2D(a.x + dx, a.y + dy), te::gm::Coord2D(b.x + dx, b.y + dy));
+    }
+  }
+
+  for(std::size_t r = 0; r < height; ++r)
+  {
+    double* line = &coverage[r * stride];
+    double sum = 0.0;
+
+    for(std::size_t i = 0; i < width; ++i)
+    {
+      sum += line[i];
+      line[i] = std::min(std::abs(sum), 1.0);
+    }
+  }
+}
+
+void te::rst::Rasterizer::drawLines(const Shape& shape, int firstRow, int lastRow,
+                                    int firstCol, int lastCol, std::vector<Span>& spans) const
+{
+  Span span;
+
+  for(std::size_t r = shape.m_firstRing; r < shape.m_firstRing + shape.m_nRings; ++r)
+  {
+    const te::gm::Coord2D* c = &m_coords[m_rings[r]];
+    const std::size_t npts = m_rings[r + 1] - m_rings[r];
+
+// a line with a single point is a segment of length zero
+    const std::size_t nSegments = (npts > 1) ? npts - 1 : 1;
+
+    for(std::size_t i = 0; i < nSegments; ++i)
+    {
+      te::gm::Coord2D a = c[i];
+      te::gm::Coord2D b = c[std::min(i + 1, npts - 1)];
+
+      const double dx = b.x - a.x;
+      const double dy = b.y - a.y;
+
+      if(m_allTouched)
+      {
+// every cell crossed by the segment: the segment x range inside each row
+        if(a.y > b.y)
+          std::swap(a, b);
+
+        const int r0 = std::max(GetCell(a.y), firstRow);
+        const int r1 = std::min(GetCell(b.y), lastRow);
+
+        for(int row = r0; row <= r1; ++row)
+        {
+          double xa = a.x;
+          double xb = b.x;
+
+          if(dy != 0.0)
+          {
+            xa = a.x + (std::max(a.y, row - 0.5) - a.y) * dx / dy;
+            xb = a.x + (std::min(b.y, row + 0.5) - a.y) * dx / dy;
+          }
+
+          if(xa > xb)
+            std::swap(xa, xb);
+
+          span.m_row = row;
+          span.m_firstCol = std::max(GetCell(xa), firstCol);
+          span.m_lastCol = std::min(GetCell(xb), lastCol);
+
+          if(span.m_firstCol <= span.m_lastCol)
+            spans.push_back(span);
+        }
+      }
+      else if(std::abs(dx) >= std::abs(dy))
+      {
+// one cell for each column: the cells only depend on the segment, not on the tile
+        if(a.x > b.x)
+          std::swap(a, b);
+
+        const int c0 = std::max(GetCell(a.x), firstCol);
+        const int c1 = std::min(GetCell(b.x), lastCol);
+
+        for(int col = c0; col <= c1; ++col)
+        {
+          const double x = std::min(std::max(static_cast<double>(col), a.x), b.x);
+          const int row = (dx != 0.0) ? GetCell(a.y + (x - a.x) * dy / dx) : GetCell(a.y);
+
+          if((row < firstRow) || (row > lastRow))
+            continue;
+
+          span.m_row = row;
+          span.m_firstCol = col;
+          span.m_lastCol = col;
+
+          spans.push_back(span);
+        }
+      }
+      else
+      {
+// one cell for each row
+        if(a.y > b.y)
+          std::swap(a, b);
+
+        const int r0 = std::max(GetCell(a.y), firstRow);
+        const int r1 = std::min(GetCell(b.y), lastRow);
+
+        for(int row = r0; row <= r1; ++row)
+        {
+          const double y = std::min(std::max(static_cast<double>(row), a.y), b.y);
+          const int col = GetCell(a.x + (y - a.y) * dx / dy);
+
+          if((col < firstCol) || (col > lastCol))
+            continue;
+
+          span.m_row = row;
+          span.m_firstCol = col;
+          span.m_lastCol = col;
+
+          spans.push_back(span);
+        }
+      }
+    }
+  }
+}
+
+void te::rst::Rasterizer::drawPoints(const Shape& shape, int firstRow, int lastRow,
+                                     int firstCol, int lastCol, std::vector<Span>& spans) const
+{
+  for(std::size_t r = shape.m_firstRing; r < shape.m_firstRing + shape.m_nRings; ++r)
+  {
+    const te::gm::Coord2D& c = m_coords[m_rings[r]];
+
+    Span span;
+    span.m_row = GetCell(c.y);
+    span.m_firstCol = GetCell(c.x);
+    span.m_lastCol = span.m_firstCol;
+
+    if((span.m_row >= firstRow) && (span.m_row <= lastRow) &&
+       (span.m_firstCol >= firstCol) && (span.m_firstCol <= lastCol))
+      spans.push_back(span);
+  }
+}
+
+void te::rst::Rasterizer::merge(const Shape& shape, Tile& tile, unsigned int row, unsigned int col,
+                                double weight) const
+{
+  const std::size_t nCells = static_cast<std::size_t>(tile.m_width) * tile.m_height;
+  const std::size_t idx = static_cast<std::size_t>(row - tile.m_row) * tile.m_width + (col - tile.m_col);
+
+  unsigned int& count = tile.m_counts[idx];
+
+  const double* values = m_nValues ? &m_values[shape.m_value] : 0;
+
+  for(std::size_t b = 0; b < m_nValues; ++b)
+  {
+    double& v = tile.m_values[b * nCells + idx];
+
+    switch(m_rule)
+    {
+      case MergeFirst:
+        if(count == 0)
+          v = values[b];
+      break;
+
+      case MergeLast:
+        v = values[b];
+      break;
+
+      case MergeSum:
+      case MergeAreaFraction:
+        v = (count ? v : 0.0) + values[b] * weight;
+      break;
+
+      case MergeMax:
+        if((count == 0) || (values[b] > v))
+          v = values[b];
+      break;
+
+      default:
+      break;
+    }
+  }
+
+  ++count;
+}
+
+void te::rst::Rasterizer::ThreadEntry(ThreadParams* params)
+{
+  const Rasterizer* rasterizer = params->m_rasterizer;
+
+  const unsigned int nCols = rasterizer->m_grid.getNumberOfColumns();
+  const unsigned int endRow = params->m_firstRow + params->m_nRows;
+  const std::size_t nBands = params->m_nBands;
+
+  Tile tile;
+
+  std::vector<unsigned char> block;
+
+  try
+  {
+    while(true)
+    {
+      std::size_t t = 0;
+
+      {
+        boost::lock_guard<boost::mutex> lock(params->m_mutex);
+
+        if(params->m_task && !params->m_task->isActive())
+          params->m_abort = true;
+
+        if(params->m_abort || (params->m_nextTile >= params->m_tileShapes.size()))
+          break;
+
+        t = params->m_nextTile++;
+      }
+
+      tile.m_col = static_cast<unsigned int>(t % params->m_tilesX) * params->m_tileWidth;
+      tile.m_row = params->m_firstRow + static_cast<unsigned int>(t / params->m_tilesX) * params->m_tileHeight;
+      tile.m_width = std::min(params->m_tileWidth, nCols - tile.m_col);
+      tile.m_height = std::min(params->m_tileHeight, endRow - tile.m_row);
+
+      const std::size_t nCells = static_cast<std::size_t>(tile.m_width) * tile.m_height;
+
+      tile.m_values.resize(nBands * nCells);
+      tile.m_counts.assign(nCells, 0);
+
+      const std::vector<std::size_t>& shapes = params->m_tileShapes[t];
+
+      for(std::size_t s = 0; s < shapes.size(); ++s)
+        rasterizer->burn(rasterizer->m_shapes[shapes[s]], tile);
+
+      for(std::size_t b = 0; b < nBands; ++b)
+      {
+        double* values = &tile.m_values[b * nCells];
+
+        for(std::size_t i = 0; i < nCells; ++i)
+        {
+          if(tile.m_counts[i] == 0)
+            values[i] = params->m_background[b];
+          else if(rasterizer->m_rule == MergeCount)
+            values[i] = static_cast<double>(tile.m_counts[i]);
+        }
+
+        if(params->m_raster == 0)
+        {
+          double* buffer = params->m_buffers[b] + static_cast<std::size_t>(tile.m_row - params->m_firstRow) * nCols + tile.m_col;
+
+          for(unsigned int r = 0; r < tile.m_height; ++r)
+            std::copy(values + r * tile.m_width, values + (r + 1) * tile.m_width, buffer + static_cast<std::size_t>(r) * nCols);
+
+          continue;
+        }
+
+        Band* band = params->m_raster->getBand(b);
+
+        const BandProperty* bandProp = band->getProperty();
+
+        if((bandProp->m_blkw == static_cast<int>(params->m_tileWidth)) &&
+           (bandProp->m_blkh == static_cast<int>(params->m_tileHeight)))
+        {
+// the tile is a block: it is converted to the band data type and written at once
+          block.resize(band->getBlockSize());
+
+          for(unsigned int r = 0; r < tile.m_height; ++r)
+            SetBufferValues(bandProp->getType(), static_cast<int>(r * params->m_tileWidth), static_cast<int>(tile.m_width),
+                            &block[0], values + r * tile.m_width);
+
+          boost::lock_guard<boost::mutex> lock(params->m_ioMutex);
+
+          band->write(static_cast<int>(tile.m_col / params->m_tileWidth), static_cast<int>(tile.m_row / params->m_tileHeight), &block[0]);
+        }
+        else
+        {
+          boost::lock_guard<boost::mutex> lock(params->m_ioMutex);
+
+          band->setValues(tile.m_col, tile.m_row, tile.m_width, tile.m_height, values);
+        }
+      }
+
+      {
+        boost::lock_guard<boost::mutex> lock(params->m_mutex);
+
+        ++params->m_processedTiles;
+
+        if(params->m_task && params->m_pulse)
+          params->m_task->pulse();
+      }
+
+      params->m_condVar.notify_one();
+    }
+  }
+  catch(...)
+  {
+    boost::lock_guard<boost::mutex> lock(params->m_mutex);
+
+    params->m_abort = true;
+    params->m_failed = true;
+  }
+
+  {
+    boost::lock_guard<boost::mutex> lock(params->m_mutex);
+
+    --params->m_runningThreads;
+  }
+
+  params->m_condVar.notify_one();
+}
@@ -0,0 +1,259 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+  \file terralib/raster/Rasterizer.h
+
+  \brief A tile-parallel scanline rasterizer of vector geometries.
+*/
+
+#ifndef __TERRALIB_RASTER_INTERNAL_RASTERIZER_H
+#define __TERRALIB_RASTER_INTERNAL_RASTERIZER_H
+
+// TerraLib
+#include "../geometry/Coord2D.h"
+#include "../geometry/Enums.h"
+#include "Config.h"
+#include "Grid.h"
+
+// STL
+#include <cstddef>
+#include <vector>
+
+// Boost
+#include <boost/noncopyable.hpp>
+
+namespace te
+{
+  namespace common { class TaskProgress; }
+
+  namespace gm { class Geometry; }
+
+  namespace rst
+  {
+// Forward declaration.
+    class Raster;
+
+    /*!
+      \class Rasterizer
+
+      \brief A tile-parallel scanline rasterizer of vector geometries.
+
+      It burns the values of polygons, lines and points (and their multi
+      versions) into the cells of a grid:
+
+      <ul>
+      <li>Polygons are filled with scanlines and active edge lists: a cell is
+          burned when its center is inside the polygon (boundary included),
+          the same rule used by PolygonIterator. In the all touched mode,
+          every cell whose interior intersects the polygon is burned.</li>
+      <li>Lines burn one cell for each step along their major axis. In the
+          all touched mode, every cell crossed by the line is burned.</li>
+      <li>Points burn the cell that contains them.</li>
+      </ul>
+
+      A geometry burns each cell at most once, even if its parts overlap.
+      When many geometries burn the same cell, the merge rule defines the
+      cell value. Cells that are not burned get the background value.
+
+      The geometries are converted to grid coordinates when they are added.
+      The grid is then split into tiles, aligned to the raster blocks, and
+      the tiles are rasterized by a pool of threads. Each tile is written to
+      the raster with a single block (or window) write.
+
+      \ingroup rst
+
+      \sa PolygonIterator, Vectorizer
+    */
+    class TERASTEREXPORT Rasterizer : public boost::noncopyable
+    {
+      public:
+
+        /*! \brief How the values of the geometries that burn the same cell are merged. */
+        enum MergeRule
+        {
+          MergeFirst,         //!< The value of the first added geometry.
+          MergeLast,          //!< The value of the last added geometry.
+          MergeSum,           //!< The sum of the values.
+          MergeMax,           //!< The maximum value.
+          MergeCount,         //!< The number of geometries (the values are ignored).
+          MergeAreaFraction   //!< The sum of the values weighted by the fraction of the cell area covered by each polygon.
+        };
+
+        /*!
+          \brief Constructor.
+
+          \param grid       The grid where the geometries will be burned.
+          \param rule       The merge rule.
+          \param allTouched If true, all cells touched by polygons and lines are burned.
+          \param maxThreads The maximum number of threads (0: the number of processors).
+
+          \note In the MergeAreaFraction rule, polygons burn every cell they cover,
+                with its covered fraction, and lines and points burn their cells with weight 1.
+        */
+        Rasterizer(const Grid& grid, MergeRule rule = MergeLast, bool allTouched = false,
+                   unsigned int maxThreads = 0);
+
+        /*! \brief Destructor. */
+        ~Rasterizer();
+
+        /*! \brief It returns the grid where the geometries are burned. */
+        const Grid& getGrid() const;
+
+        /*!
+          \brief It adds a geometry to be burned.
+
+          \param geom   A geometry in the grid SRS.
+          \param values The values burned by the geometry, one for each band.
+
+          \note All geometries must have the same number of values.
+
+          \note Curves other than line strings are ignored.
+        */
+        void add(const te::gm::Geometry* geom, const std::vector<double>& values);
+
+        /*!
+          \brief It adds a geometry to be burned in a single band.
+
+          \param geom  A geometry in the grid SRS.
+          \param value The value burned by the geometry.
+        */
+        void add(const te::gm::Geometry* geom, double value);
+
+        /*! \brief It returns the number of added geometries. */
+        std::size_t getNumberOfGeometries() const;
+
+        /*! \brief It removes all geometries. */
+        void clear();
+
+        /*!
+          \brief It burns the geometries in the first bands of a raster.
+
+          All cells of the raster are written: the cells that are not burned
+          get the no-data value of their band.
+
+          \param raster A raster with the grid given to the constructor and
+                        (at least) one band for each geometry value.
+          \param task   An optional task: its total steps are set to the number
+                        of tiles and it is pulsed for each rasterized tile.
+
+          \return False if the task was canceled.
+
+          \exception Exception It throws an exception if the raster can not be written.
+        */
+        bool rasterize(Raster* raster, te::common::TaskProgress* task = 0);
+
+        /*!
+          \brief It burns the geometries in a strip of rows of the grid.
+
+          \param firstRow   The first row of the strip.
+          \param nRows      The number of rows of the strip.
+          \param buffers    One buffer for each geometry value, with room for
+                            nRows times the number of grid columns values, in
+                            row-major order.
+          \param background The value of the cells that are not burned.
+          \param task       An optional task, only used to cancel the rasterization.
+
+          \return False if the task was canceled.
+        */
+        bool rasterize(unsigned int firstRow, unsigned int nRows,
+                       const std::vector<double*>& buffers, double background = 0.0,
+                       te::common::TaskProgress* task = 0);
+
+      private:
+
+        /*! \brief A primitive geometry (or a multi geometry) in grid coordinates. */
+        struct Shape
+        {
+          te::gm::GeomType m_type;   //!< PolygonType, LineStringType or PointType.
+          std::size_t m_firstRing;   //!< The first ring (line or point) of the shape.
+          std::size_t m_nRings;      //!< The number of rings.
+          std::size_t m_value;       //!< The index of the first value of the shape.
+          int m_firstRow;            //!< The first row the shape may burn.
+          int m_lastRow;             //!< The last row the shape may burn.
+          int m_firstCol;            //!< The first column the shape may burn.
+          int m_lastCol;             //!< The last column the shape may burn.
+        };
+
+        struct Span;
+
+        struct Tile;
+
+        struct ThreadParams;
+
+        /*! \brief It appends the parts of a geometry of the given dimension to a shape. */
+        void addParts(const te::gm::Geometry* geom, te::gm::GeomType type, Shape& shape);
+
+        /*! \brief It appends a sequence of coordinates as a new ring. */
+        void addRing(const te::gm::Coord2D* coords, std::size_t npts, bool polygon, bool hole);
+
+        /*! \brief It adds a shape if it may burn some cell, otherwise its rings are removed. */
+        bool addShape(Shape& shape);
+
+        /*! \brief It builds the index of the shapes by rows. */
+        void buildIndex();
+
+        /*! \brief It rasterizes the tiles of a strip of rows. */
+        bool run(ThreadParams& params, te::common::TaskProgress* task);
+
+        /*! \brief It burns a shape in a tile. */
+        void burn(const Shape& shape, Tile& tile) const;
+
+        /*! \brief It computes the spans of the cells whose centers are inside a polygon. */
+        void fillPolygon(const Shape& shape, int firstRow, int lastRow,
+                         int firstCol, int lastCol, std::vector<Span>& spans) const;
+
+        /*! \brief It computes the fraction of each cell covered by a polygon. */
+        void coverPolygon(const Shape& shape, int firstRow, int lastRow,
+                          int firstCol, int lastCol, std::vector<double>& coverage) const;
+
+        /*! \brief It computes the cells burned by the lines of a shape. */
+        void drawLines(const Shape& shape, int firstRow, int lastRow,
+                       int firstCol, int lastCol, std::vector<Span>& spans) const;
+
+        /*! \brief It computes the cells burned by the points of a shape. */
+        void drawPoints(const Shape& shape, int firstRow, int lastRow,
+                        int firstCol, int lastCol, std::vector<Span>& spans) const;
+
+        /*! \brief It merges the values of a shape into the cells of a tile. */
+        void merge(const Shape& shape, Tile& tile, unsigned int row, unsigned int col,
+                   double weight) const;
+
+        static void ThreadEntry(ThreadParams* params);
+
+      private:
+
+        Grid m_grid;                                     //!< The grid where the geometries are burned.
+        MergeRule m_rule;                                //!< The merge rule.
+        bool m_allTouched;                               //!< If true, all touched cells are burned.
+        unsigned int m_maxThreads;                       //!< The maximum number of threads.
+        std::size_t m_nValues;                           //!< The number of values of each geometry.
+        std::size_t m_nGeometries;                       //!< The number of added geometries.
+        std::vector<Shape> m_shapes;                     //!< The shapes, in the order they were added.
+        std::vector<te::gm::Coord2D> m_coords;           //!< The coordinates of all rings, in grid coordinates.
+        std::vector<std::size_t> m_rings;                //!< The first coordinate of each ring plus a sentinel.
+        std::vector<double> m_values;                    //!< The values of all geometries.
+        std::vector<std::vector<std::size_t> > m_index;  //!< The shapes that may burn each strip of sg_indexRows rows.
+        bool m_indexValid;                               //!< False if geometries were added after the index was built.
+    };
+
+  } // end namespace rst
+}   // end namespace te
+
+#endif  // __TERRALIB_RASTER_INTERNAL_RASTERIZER_H
@@ -24,27 +24,37 @@
 */
 
 // TerraLib
+#include "../common/PlatformUtils.h"
 #include "../common/STLUtils.h"
 #include "../geometry/Coord2D.h"
 #include "../geometry/Envelope.h"
 #include "../srs/Converter.h"
 #include "Band.h"
 #include "BandProperty.h"
+#include "BlockUtils.h"
 #include "Exception.h"
 #include "Grid.h"
 #include "Interpolator.h"
 #include "Raster.h"
 #include "RasterFactory.h"
+#include "RasterSynchronizer.h"
 #include "Reprojection.h"
+#include "SynchronizedRaster.h"
 
 // STL
 #include <algorithm>  // for max and min
 #include <cstdlib>    // for abs
+#include <vector>
+
+// Boost
+#include <boost/thread.hpp>
 
 bool IsPointOnLine(te::gm::Coord2D& p, te::gm::Coord2D& q, te::gm::Coord2D& t, double tol);
 
 bool InterpolateIn(te::rst::Raster const * const rin, te::rst::Raster* rout, te::gm::Envelope* box, te::srs::Converter* conv, int m = te::rst::NearestNeighbor);
 
+bool InterpolateInParallel(te::rst::Raster const * const rin, te::rst::Raster* rout, te::gm::Envelope* box, te::srs::Converter* conv, int m, const unsigned int maxThreads);
+
 te::rst::Raster* te::rst::Reproject(te::rst::Raster const * const rin, int srid, const std::map<std::string, std::string>& routinfo, int m)
 {
   return te::rst::Reproject(rin, srid, 1, 1, -1, -1, 0, 0, routinfo, m);
@@ -56,6 +66,16 @@ te::rst::Raster* te::rst::Reproject(te::rst::Raster const * const rin, int srid,
 }
 
 te::rst::Raster* te::rst::Reproject(te::rst::Raster const * const rin, int srid, double llx, double lly, double urx, double ury, double resx, double resy, const std::map<std::string, std::string>& routinfo, int m)
+{
+  return te::rst::Reproject(rin, srid, llx, lly, urx, ury, resx, resy, routinfo, m, 1);
+}
+
+te::rst::Raster* te::rst::Reproject(te::rst::Raster const * const rin, int srid, const std::map<std::string, std::string>& routinfo, int m, const unsigned int maxThreads)
+{
+  return te::rst::Reproject(rin, srid, 1, 1, -1, -1, 0, 0, routinfo, m, maxThreads);
+}
+
+te::rst::Raster* te::rst::Reproject(te::rst::Raster const * const rin, int srid, double llx, double lly, double urx, double ury, double resx, double resy, const std::map<std::string, std::string>& routinfo, int m, const unsigned int maxThreads)
 {
   if (srid == rin->getSRID())
     return 0;
@@ -114,7 +134,8 @@ te::rst::Raster* te::rst::Reproject(te::rst::Raster const * const rin, int srid,
 // create output raster
   te::rst::Raster* rout = te::rst::RasterFactory::make(g, bands, routinfo);
 
-  bool res = InterpolateIn(rin, rout, env, converter, m);
+  bool res = (maxThreads == 1) ? InterpolateIn(rin, rout, env, converter, m) :
+                                 InterpolateInParallel(rin, rout, env, converter, m, maxThreads);
 
   if (!res)
   {
@@ -125,40 +146,72 @@ te::rst::Raster* te::rst::Reproject(te::rst::Raster const * const rin, int srid,
   return rout;
 }
 
-bool InterpolateIn(te::rst::Raster const * const rin, te::rst::Raster* rout, te::gm::Envelope* box, te::srs::Converter* conv, int m)
+namespace
 {
-  te::gm::Coord2D poll = box->getLowerLeft();
-  te::gm::Coord2D pour = box->getUpperRight();
+  /*!
+    \brief An output area where the coordinate transformation is linearly interpolated.
+
+    It keeps the input positions at the beginning and at the end of the first line
+    of the area and their increments from one line to the next.
+  */
+  struct InterpolationArea
+  {
+    int m_x1;       //!< The first output column.
+    int m_y1;       //!< The first output row.
+    int m_x2;       //!< The last output column.
+    int m_y2;       //!< The last output row.
+    double m_xl;    //!< The input x at the beginning of the first line.
+    double m_yl;    //!< The input y at the beginning of the first line.
+    double m_xr;    //!< The input x at the end of the first line.
+    double m_yr;    //!< The input y at the end of the first line.
+    double m_dxl;   //!< The x increment at the beginning of line.
+    double m_dyl;   //!< The y increment at the beginning of line.
+    double m_dxr;   //!< The x increment at the end of line.
+    double m_dyr;   //!< The y increment at the end of line.
+    int m_method;   //!< The interpolation method.
+  };
+
+  /*!
+    \brief Splits an output box in the areas where a linear interpolation may be performed on input raster.
+
+    The areas are returned in the order they must be interpolated: when two areas
+    overlap, the pixels of the last one prevail.
+  */
+  void GetInterpolationAreas(te::rst::Raster const * const rin, te::rst::Raster* rout, te::gm::Envelope* box,
+                             te::srs::Converter* conv, int m, std::vector<InterpolationArea>& areas)
+  {
+    te::gm::Coord2D poll = box->getLowerLeft();
+    te::gm::Coord2D pour = box->getUpperRight();
 
 // Bring output coordinates to output line/column domain
-  te::gm::Coord2D pxoll = rout->getGrid()->geoToGrid(poll.x, poll.y);
-  te::gm::Coord2D pxour = rout->getGrid()->geoToGrid(pour.x, pour.y);
+    te::gm::Coord2D pxoll = rout->getGrid()->geoToGrid(poll.x, poll.y);
+    te::gm::Coord2D pxour = rout->getGrid()->geoToGrid(pour.x, pour.y);
 
 // Round output coordinates to nearest exact pixel
-  int x1 = (int) (pxoll.x-0.5);
-  int y1 = (int) (pxoll.y+0.5);
-  pxoll = te::gm::Coord2D(x1, y1);
+    int x1 = (int) (pxoll.x-0.5);
+    int y1 = (int) (pxoll.y+0.5);
+    pxoll = te::gm::Coord2D(x1, y1);
 
-  int x2 = (int)(pxour.x+0.5);
-  int y2 = (int)(pxour.y-0.5);
-  pxour = te::gm::Coord2D(x2, y2);
+    int x2 = (int)(pxour.x+0.5);
+    int y2 = (int)(pxour.y-0.5);
+    pxour = te::gm::Coord2D(x2, y2);
 
-  poll = rout->getGrid()->gridToGeo((int)pxoll.x, (int)pxoll.y);
+    poll = rout->getGrid()->gridToGeo((int)pxoll.x, (int)pxoll.y);
 
-  te::gm::Coord2D poul = te::gm::Coord2D(poll.x, pour.y);
-  te::gm::Coord2D polr = te::gm::Coord2D(pour.x, poll.y);
+    te::gm::Coord2D poul = te::gm::Coord2D(poll.x, pour.y);
+    te::gm::Coord2D polr = te::gm::Coord2D(pour.x, poll.y);
 
 // Bring coordinates of box four corners to input raster projection
 
-  te::gm::Coord2D pill(poll);
-  te::gm::Coord2D piur(pour);
-  te::gm::Coord2D piul(poul);
-  te::gm::Coord2D pilr(polr);
+    te::gm::Coord2D pill(poll);
+    te::gm::Coord2D piur(pour);
+    te::gm::Coord2D piul(poul);
+    te::gm::Coord2D pilr(polr);
 
-  conv->invert(pill.x,pill.y);
-  conv->invert(piur.x,piur.y);
-  conv->invert(piul.x,piul.y);
-  conv->invert(pilr.x,pilr.y);
+    conv->invert(pill.x,pill.y);
+    conv->invert(piur.x,piur.y);
+    conv->invert(piul.x,piul.y);
+    conv->invert(pilr.x,pilr.y);
 
 // Check if linear interpolation may be performed on input raster
 // Evaluate point at middle of the edges in output domain and check if their
@@ -166,118 +219,171 @@ bool InterpolateIn(te::rst::Raster const * const rin, te::rst::Raster* rout, te:
 // a linear interpolation may be performed, else divide output image
 // in four quadrants and try interpolating again.
 
-  te::gm::Coord2D pou((pour.x-poul.x)/2.+poul.x, poul.y), // upper edge
-                  pob((polr.x-poll.x)/2.+poll.x, poll.y), // bottom edge
-                  pol(poll.x, (poul.y-poll.y)/2.+poll.y), // left edge
-                  por(polr.x, (pour.y-polr.y)/2.+polr.y); // right edge
+    te::gm::Coord2D pou((pour.x-poul.x)/2.+poul.x, poul.y), // upper edge
+                    pob((polr.x-poll.x)/2.+poll.x, poll.y), // bottom edge
+                    pol(poll.x, (poul.y-poll.y)/2.+poll.y), // left edge
+                    por(polr.x, (pour.y-polr.y)/2.+polr.y); // right edge
 
 // Evaluate corresponding points in input raster domain
-  te::gm::Coord2D piu(pou); conv->invert(piu.x, piu.y);
-  te::gm::Coord2D pib(pob); conv->invert(pib.x, pib.y);
-  te::gm::Coord2D pil(pol); conv->invert(pil.x, pil.y);
-  te::gm::Coord2D pir(por); conv->invert(pir.x, pir.y);
+    te::gm::Coord2D piu(pou); conv->invert(piu.x, piu.y);
+    te::gm::Coord2D pib(pob); conv->invert(pib.x, pib.y);
+    te::gm::Coord2D pil(pol); conv->invert(pil.x, pil.y);
+    te::gm::Coord2D pir(por); conv->invert(pir.x, pir.y);
 
 // Check if middle points belong to the edges
 // If one of them does not belong to corresponding edge, divide output in four quadrants
-  double tol = std::max(rin->getResolutionX(), rin->getResolutionY());
+    double tol = std::max(rin->getResolutionX(), rin->getResolutionY());
 
-  if (!IsPointOnLine(piul, piur, piu, tol) ||
-      !IsPointOnLine(pilr, piur, pir, tol) ||
-      !IsPointOnLine(pill, pilr, pib, tol) ||
-      !IsPointOnLine(pill, piul, pil, tol))
-  {
+    if (!IsPointOnLine(piul, piur, piu, tol) ||
+        !IsPointOnLine(pilr, piur, pir, tol) ||
+        !IsPointOnLine(pill, pilr, pib, tol) ||
+        !IsPointOnLine(pill, piul, pil, tol))
+    {
 // center point
-    te::gm::Coord2D pom((por.x-pol.x)/2.+pol.x, (pou.y-pob.y)/2.+pob.y);
+      te::gm::Coord2D pom((por.x-pol.x)/2.+pol.x, (pou.y-pob.y)/2.+pob.y);
 
-    te::gm::Envelope quadrantul(pol.x, pol.y, pou.x, pou.y);
-    if(!InterpolateIn(rin,rout,&quadrantul,conv))
-      return false;
+// the quadrants have always been interpolated with the nearest neighbor method
+      te::gm::Envelope quadrantul(pol.x, pol.y, pou.x, pou.y);
+      GetInterpolationAreas(rin, rout, &quadrantul, conv, te::rst::NearestNeighbor, areas);
 
-    te::gm::Envelope quadrantur(pom.x, pom.y, pour.x, pour.y);
-    if(!InterpolateIn(rin, rout, &quadrantur, conv))
-      return false;
+      te::gm::Envelope quadrantur(pom.x, pom.y, pour.x, pour.y);
+      GetInterpolationAreas(rin, rout, &quadrantur, conv, te::rst::NearestNeighbor, areas);
 
-    te::gm::Envelope quadrantll(poll.x, poll.y, pom.x, pom.y);
-    if(!InterpolateIn(rin, rout, &quadrantll, conv))
-      return false;
+      te::gm::Envelope quadrantll(poll.x, poll.y, pom.x, pom.y);
+      GetInterpolationAreas(rin, rout, &quadrantll, conv, te::rst::NearestNeighbor, areas);
 
-    te::gm::Envelope quadrantlr(pob.x, pob.y, por.x, por.y);
-    if(!InterpolateIn(rin, rout, &quadrantlr, conv))
-      return false;
+      te::gm::Envelope quadrantlr(pob.x, pob.y, por.x, por.y);
+      GetInterpolationAreas(rin, rout, &quadrantlr, conv, te::rst::NearestNeighbor, areas);
 
-    return true;
-  }
+      return;
+    }
 
 // Start linear interpolation on input image.
-  te::gm::Coord2D pxill = rin->getGrid()->geoToGrid(pill.x, pill.y);
-  te::gm::Coord2D pxiul = rin->getGrid()->geoToGrid(piul.x, piul.y);
-  te::gm::Coord2D pxilr = rin->getGrid()->geoToGrid(pilr.x, pilr.y);
-  te::gm::Coord2D pxiur = rin->getGrid()->geoToGrid(piur.x, piur.y);
+    te::gm::Coord2D pxill = rin->getGrid()->geoToGrid(pill.x, pill.y);
+    te::gm::Coord2D pxiul = rin->getGrid()->geoToGrid(piul.x, piul.y);
+    te::gm::Coord2D pxilr = rin->getGrid()->geoToGrid(pilr.x, pilr.y);
+    te::gm::Coord2D pxiur = rin->getGrid()->geoToGrid(piur.x, piur.y);
+
+    InterpolationArea area;
 
 // Evaluate the increments in x and y on both sides of input image
-  x1 = (int)pxoll.x-1;
-  y1 = (int)pxour.y-1;
+    area.m_x1 = (int)pxoll.x-1;
+    area.m_y1 = (int)pxour.y-1;
 
-  x2 = (int)pxour.x+1;
-  y2 = (int)pxoll.y+1;
+    area.m_x2 = (int)pxour.x+1;
+    area.m_y2 = (int)pxoll.y+1;
 
-  double dxl((pxill.x-pxiul.x)/(y2-y1)); // x increment at the beginning of line
-  double dyl((pxill.y-pxiul.y)/(y2-y1)); // y increment at the beginning of line
-  double dxr((pxilr.x-pxiur.x)/(y2-y1)); // x increment at the end of line
-  double dyr((pxilr.y-pxiur.y)/(y2-y1)); // Y increment at the end of line
+    area.m_dxl = (pxill.x-pxiul.x)/(area.m_y2-area.m_y1); // x increment at the beginning of line
+    area.m_dyl = (pxill.y-pxiul.y)/(area.m_y2-area.m_y1); // y increment at the beginning of line
+    area.m_dxr = (pxilr.x-pxiur.x)/(area.m_y2-area.m_y1); // x increment at the end of line
+    area.m_dyr = (pxilr.y-pxiur.y)/(area.m_y2-area.m_y1); // Y increment at the end of line
 
-  // Set initial values for x and y at beginning point on input image
-  double xl = pxiul.x-1;                 // x at the beginning of the line
-  double yl = pxiul.y-1;                 // y at the beginning of the line
+// Set initial values for x and y at beginning point on input image
+    area.m_xl = pxiul.x-1;                                // x at the beginning of the line
+    area.m_yl = pxiul.y-1;                                // y at the beginning of the line
 
-  // Set initial values for x and y at end point on input image
-  double xr = pxiur.x+1;                 // x at the end of the line
-  double yr = pxiur.y+1;                 // y at the end of the line
+// Set initial values for x and y at end point on input image
+    area.m_xr = pxiur.x+1;                                // x at the end of the line
+    area.m_yr = pxiur.y+1;                                // y at the end of the line
 
-  // Evaluate increments for the first line
-  double dx = (xr-xl)/(x2-x1);           // inner loop x increment
-  double dy = (yr-yl)/(x2-x1);           // inner loop y increment
+    area.m_method = m;
 
-  double x = xl; // round to left pixel
-  double y = yl; // round to left pixel
+    areas.push_back(area);
+  }
+
+  /*!
+    \brief Interpolates the rows of an area that lie in [firstRow, lastRow].
 
-  // Create the interpolator
-  te::rst::Interpolator* interpolator = new te::rst::Interpolator(rin, m);
+    The input positions are accumulated line by line and pixel by pixel, in the same
+    order for any range of rows, so that a pixel always gets the same input position.
 
-  int i, j;
-  std::complex<double> value;
-  for (j = y1; j <= y2; ++j)
+    \param writer A functor called as writer(col, row, value, band) for each output pixel.
+  */
+  template<class PixelWriter>
+  void InterpolateArea(const InterpolationArea& area, te::rst::Interpolator& interpolator, const std::size_t nbands,
+                       const te::rst::Grid& outGrid, const int firstRow, const int lastRow, PixelWriter& writer)
   {
-    for (i = x1; i <= x2; ++i)
+    double xl = area.m_xl;
+    double yl = area.m_yl;
+    double xr = area.m_xr;
+    double yr = area.m_yr;
+
+// Evaluate increments for the first line
+    double dx = (xr-xl)/(area.m_x2-area.m_x1);  // inner loop x increment
+    double dy = (yr-yl)/(area.m_x2-area.m_x1);  // inner loop y increment
+
+    double x = xl;
+    double y = yl;
+
+    std::complex<double> value;
+
+    for(int j = area.m_y1; (j <= area.m_y2) && (j <= lastRow); ++j)
     {
-      if( rout->getGrid()->isPointInGrid(i, j) )
+      if(j >= firstRow)
       {
-        for (std::size_t b = 0; b < rin->getNumberOfBands(); ++b)
+        for(int i = area.m_x1; i <= area.m_x2; ++i)
         {
-          //rin->getValue((int)(x+0.5), (int)(y+0.5), value, b);
-          interpolator->getValue(x, y, value, b);
-          rout->setValue(i, j, value, b);
+          if(outGrid.isPointInGrid(i, j))
+          {
+            for(std::size_t b = 0; b < nbands; ++b)
+            {
+              interpolator.getValue(x, y, value, b);
+              writer(i, j, value, b);
+            }
+          }
+          x += dx;
+          y += dy;
         }
       }
-      x += dx;
-      y += dy;
+
+      xl += area.m_dxl;
+      yl += area.m_dyl;
+
+      xr += area.m_dxr;
+      yr += area.m_dyr;
+
+      x = xl;
+      y = yl;
+
+      dx = (xr-xl)/(area.m_x2-area.m_x1);
+      dy = (yr-yl)/(area.m_x2-area.m_x1);
     }
-    xl += dxl;
-    yl += dyl;
+  }
+
+  /*! \brief Writes the interpolated pixels directly to the output raster. */
+  struct RasterPixelWriter
+  {
+    te::rst::Raster* m_raster;
+
+    void operator()(const int i, const int j, const std::complex<double>& value, const std::size_t b)
+    {
+      m_raster->setValue(i, j, value, b);
+    }
+  };
+}
 
-    xr += dxr;
-    yr += dyr;
+bool InterpolateIn(te::rst::Raster const * const rin, te::rst::Raster* rout, te::gm::Envelope* box, te::srs::Converter* conv, int m)
+{
+  std::vector<InterpolationArea> areas;
+
+  GetInterpolationAreas(rin, rout, box, conv, m, areas);
+
+  te::rst::Interpolator interpolator(rin, m);
+  te::rst::Interpolator nnInterpolator(rin, te::rst::NearestNeighbor);
 
-    x = xl;
-    y = yl;
+  RasterPixelWriter writer;
+  writer.m_raster = rout;
 
-    dx = (xr-xl)/(x2-x1);
-    dy = (yr-yl)/(x2-x1);
+  for(std::size_t a = 0; a < areas.size(); ++a)
+  {
+    te::rst::Interpolator& areaInterpolator = (areas[a].m_method == m) ? interpolator : nnInterpolator;
+
+    InterpolateArea(areas[a], areaInterpolator, rin->getNumberOfBands(), *rout->getGrid(), areas[a].m_y1, areas[a].m_y2, writer);
   }
+
   return true;
 }
 
-
 bool IsPointOnLine(te::gm::Coord2D& p, te::gm::Coord2D& q, te::gm::Coord2D& t, double tol)
 {
   int px = (int)(p.x/tol);
@@ -308,3 +414,195 @@ bool IsPointOnLine(te::gm::Coord2D& p, te::gm::Coord2D& q, te::gm::Coord2D& t, d
 
   return true;
 }
+
+namespace
+{
+  /*! \brief The number of input raster blocks cached by each reprojection thread. */
+  const unsigned int ReprojectInputCacheBlocks = 16;
+
+  /*! \brief The parameters shared by all parallel reprojection threads. */
+  struct ReprojectThreadParams
+  {
+    te::rst::RasterSynchronizer* m_inputSyncPtr;                        //!< The input raster synchronizer.
+    te::rst::Raster* m_outputRasterPtr;                                 //!< The output raster.
+    const std::vector< InterpolationArea >* m_areasPtr;                 //!< The interpolation areas, in the serial order.
+    int m_method;                                                       //!< The interpolation method.
+    std::vector< std::complex<double> > m_noDataValues;                 //!< The input raster no-data values.
+    std::vector< te::rst::SetBufferValueFPtr > m_setBuff;               //!< The output bands set buffer of real values functions.
+    std::vector< te::rst::SetBufferValueFPtr > m_setBuffI;              //!< The output bands set buffer of imaginary values functions.
+    std::vector< int > m_blockSizes;                                    //!< The output bands block size (bytes).
+    unsigned int m_blkw;                                                //!< The output blocks width.
+    unsigned int m_blkh;                                                //!< The output blocks height.
+    unsigned int m_nblocksx;                                            //!< The number of output blocks in x.
+    unsigned int m_stripsNumber;                                        //!< The total number of strips (rows of output blocks).
+    unsigned int m_nextStrip;                                           //!< The next strip to be processed.
+    bool m_returnStatus;                                                //!< The threads execution status.
+    boost::mutex* m_mutexPtr;                                           //!< Strips counter and output raster access mutex.
+  };
+
+  /*! \brief Writes the interpolated pixels to the buffers of a row of output blocks. */
+  struct BlockRowPixelWriter
+  {
+    ReprojectThreadParams* m_paramsPtr;
+    std::vector< std::vector< unsigned char > >* m_buffersPtr;  //!< The blocks of each band, side by side.
+    int m_row0;                                                 //!< The first row of the strip.
+
+    void operator()(const int i, const int j, const std::complex<double>& value, const std::size_t b)
+    {
+      const int blkw = static_cast<int>(m_paramsPtr->m_blkw);
+      const int index = (j - m_row0) * blkw + (i % blkw);
+
+      unsigned char* block = &(*m_buffersPtr)[b][(i / blkw) * m_paramsPtr->m_blockSizes[b]];
+
+      double real = value.real();
+      double imag = value.imag();
+
+      m_paramsPtr->m_setBuff[b](index, block, &real);
+      m_paramsPtr->m_setBuffI[b](index, block, &imag);
+    }
+  };
+
+  void ReprojectThread(ReprojectThreadParams* paramsPtr)
+  {
+    try
+    {
+      te::rst::SynchronizedRaster inRaster(ReprojectInputCacheBlocks, *paramsPtr->m_inputSyncPtr);
+
+      te::rst::Interpolator interpolator(&inRaster, paramsPtr->m_method, paramsPtr->m_noDataValues);
+      te::rst::Interpolator nnInterpolator(&inRaster, te::rst::NearestNeighbor, paramsPtr->m_noDataValues);
+
+      te::rst::Raster* outRaster = paramsPtr->m_outputRasterPtr;
+
+      const te::rst::Grid& outGrid = *outRaster->getGrid();
+      const std::vector< InterpolationArea >& areas = *paramsPtr->m_areasPtr;
+
+      const int nrows = static_cast<int>(outGrid.getNumberOfRows());
+      const int blkh = static_cast<int>(paramsPtr->m_blkh);
+      const std::size_t nbands = paramsPtr->m_blockSizes.size();
+
+      std::vector< std::vector< unsigned char > > buffers(nbands);
+      for(std::size_t b = 0; b < nbands; ++b)
+        buffers[b].resize(paramsPtr->m_nblocksx * paramsPtr->m_blockSizes[b]);
+
+      BlockRowPixelWriter writer;
+      writer.m_paramsPtr = paramsPtr;
+      writer.m_buffersPtr = &buffers;
+
+      while(true)
+      {
+        paramsPtr->m_mutexPtr->lock();
+
+        if(!paramsPtr->m_returnStatus || (paramsPtr->m_nextStrip >= paramsPtr->m_stripsNumber))
+        {
+          paramsPtr->m_mutexPtr->unlock();
+          return;
+        }
+
+        const unsigned int strip = paramsPtr->m_nextStrip++;
+
+// the pixels not covered by any area keep the output raster values, as in the serial path
+        for(std::size_t b = 0; b < nbands; ++b)
+          for(unsigned int blkX = 0; blkX < paramsPtr->m_nblocksx; ++blkX)
+            outRaster->getBand(b)->read(static_cast<int>(blkX), static_cast<int>(strip), &buffers[b][blkX * paramsPtr->m_blockSizes[b]]);
+
+        paramsPtr->m_mutexPtr->unlock();
+
+        const int row0 = static_cast<int>(strip) * blkh;
+        const int lastRow = std::min(row0 + blkh, nrows) - 1;
+
+        writer.m_row0 = row0;
+
+        for(std::size_t a = 0; a < areas.size(); ++a)
+        {
+          if((areas[a].m_y2 < row0) || (areas[a].m_y1 > lastRow))
+            continue;
+
+          te::rst::Interpolator& areaInterpolator = (areas[a].m_method == paramsPtr->m_method) ? interpolator : nnInterpolator;
+
+          InterpolateArea(areas[a], areaInterpolator, nbands, outGrid, row0, lastRow, writer);
+        }
+
+        paramsPtr->m_mutexPtr->lock();
+
+        for(std::size_t b = 0; b < nbands; ++b)
+          for(unsigned int blkX = 0; blkX < paramsPtr->m_nblocksx; ++blkX)
+            outRaster->getBand(b)->write(static_cast<int>(blkX), static_cast<int>(strip), &buffers[b][blkX * paramsPtr->m_blockSizes[b]]);
+
+        paramsPtr->m_mutexPtr->unlock();
+      }
+    }
+    catch(...)
+    {
+      paramsPtr->m_mutexPtr->lock();
+      paramsPtr->m_returnStatus = false;
+      paramsPtr->m_mutexPtr->unlock();
+    }
+  }
+}
+
+bool InterpolateInParallel(te::rst::Raster const * const rin, te::rst::Raster* rout, te::gm::Envelope* box, te::srs::Converter* conv, int m, const unsigned int maxThreads)
+{
+  const te::rst::BandProperty* bprop = rout->getBand(0)->getProperty();
+
+// strips are rows of output blocks, so all output bands must share the same block layout
+  bool blocksMatch = (bprop->m_blkw > 0) && (bprop->m_blkh > 0) && (bprop->m_nblocksx > 0) && (bprop->m_nblocksy > 0) &&
+                     (rin->getNumberOfBands() == rout->getNumberOfBands());
+
+  for(std::size_t b = 1; blocksMatch && (b < rout->getNumberOfBands()); ++b)
+  {
+    const te::rst::BandProperty* p = rout->getBand(b)->getProperty();
+
+    blocksMatch = (p->m_blkw == bprop->m_blkw) && (p->m_blkh == bprop->m_blkh);
+  }
+
+  if(!blocksMatch)
+    return InterpolateIn(rin, rout, box, conv, m);
+
+// the areas are computed as in the serial path, so both paths produce the same pixels
+  std::vector<InterpolationArea> areas;
+
+  GetInterpolationAreas(rin, rout, box, conv, m, areas);
+
+  const unsigned int threadsNumber = maxThreads ? maxThreads : te::common::GetPhysProcNumber();
+
+  te::rst::RasterSynchronizer sync(const_cast<te::rst::Raster&>(*rin), te::common::RAccess);
+
+  boost::mutex mutex;
+
+  ReprojectThreadParams params;
+  params.m_inputSyncPtr = &sync;
+  params.m_outputRasterPtr = rout;
+  params.m_areasPtr = &areas;
+  params.m_method = m;
+  params.m_blkw = static_cast<unsigned int>(bprop->m_blkw);
+  params.m_blkh = static_cast<unsigned int>(bprop->m_blkh);
+  params.m_nblocksx = static_cast<unsigned int>(bprop->m_nblocksx);
+  params.m_stripsNumber = static_cast<unsigned int>(bprop->m_nblocksy);
+  params.m_nextStrip = 0;
+  params.m_returnStatus = true;
+  params.m_mutexPtr = &mutex;
+
+  for(std::size_t b = 0; b < rin->getNumberOfBands(); ++b)
+    params.m_noDataValues.push_back(std::complex<double>(rin->getBand(b)->getProperty()->m_noDataValue, 0.0));
+
+  for(std::size_t b = 0; b < rout->getNumberOfBands(); ++b)
+  {
+    te::rst::GetBufferValueFPtr gb, gbi;
+    te::rst::SetBufferValueFPtr sb, sbi;
+
+    te::rst::SetBlockFunctions(&gb, &gbi, &sb, &sbi, rout->getBand(b)->getProperty()->getType());
+
+    params.m_setBuff.push_back(sb);
+    params.m_setBuffI.push_back(sbi);
+    params.m_blockSizes.push_back(rout->getBand(b)->getBlockSize());
+  }
+
+  boost::thread_group threads;
+
+  for(unsigned int t = 0; t < threadsNumber; ++t)
+    threads.add_thread(new boost::thread(ReprojectThread, &params));
+
+  threads.join_all();
+
+  return params.m_returnStatus;
+}
@@ -101,6 +101,53 @@ namespace te
       \note The caller will take the ownership of the returned pointer.
     */
     TERASTEREXPORT te::rst::Raster* Reproject(te::rst::Raster const * const rin, int srid, double llx, double lly, double urx, double ury, double resx, double resy, const std::map<std::string, std::string>& routinfo, int m = te::rst::NearestNeighbor);
+
+    /*!
+      \brief Reprojects a raster to another SRS using multiple threads.
+
+      \param rin        The input raster file. Do not pass a null pointer.
+      \param srid       The target SRID for the reprojection.
+      \param routinfo   The basic parameters necessary to create the reprojected raster.
+      \param m          The method of interpolation to apply. \sa te::rst::Interpolator
+      \param maxThreads The maximum number of threads to use (0-auto, 1-single thread used).
+
+      \return A pointer to the raster reprojected if success or a null pointer otherwise.
+
+      \exception Exception This function might through an exception if the coordinate conversion fails.
+
+      \note The caller will take the ownership of the returned pointer.
+    */
+    TERASTEREXPORT te::rst::Raster* Reproject(te::rst::Raster const * const rin, int srid, const std::map<std::string, std::string>& routinfo, int m, const unsigned int maxThreads);
+
+    /*!
+      \brief Reprojects a portion of a raster to another SRS, maintaining a given resolution and using multiple threads.
+
+      The output box is split in the same linear interpolation areas used by the single
+      threaded algorithm. The rows of output blocks are resampled into block buffers by
+      a pool of worker threads, each one accumulating the input positions of an area as
+      the single threaded algorithm does, so both produce the same pixels.
+
+      \param rin        The input raster file. Do not pass a null pointer.
+      \param srid       The target SRID for the reprojection.
+      \param llx        Lower-left X-coordinate of the portion to be reprojected (in the original SRS).
+      \param lly        Lower-left Y-coordinate of the portion to be reprojected (in the original SRS).
+      \param urx        Upper-Right X-coordinate of the portion to be reprojected (in the original SRS).
+      \param ury        Upper-Right Y-coordinate of the portion to be reprojected (in the original SRS).
+      \param resx       The output x resolution (in units of the target SRS - if resx=0 the number of columns will be kept the same).
+      \param resy       The output y resolution (in units of the target SRS - if resy=0 the number of rows will be kept the same).
+      \param routinfo   The basic parameters necessary to create the reprojected raster.
+      \param m          The method of interpolation to apply. \sa te::rst::Interpolator
+      \param maxThreads The maximum number of threads to use (0-auto, 1-single thread used).
+
+      \return A pointer to the raster reprojected if success or a null pointer otherwise.
+
+      \exception Exception This function might through an exception if the coordinate conversion fails.
+
+      \note The caller will take the ownership of the returned pointer.
+
+      \note When maxThreads is 1, or when the output bands do not share the same block layout, the single threaded algorithm is used.
+    */
+    TERASTEREXPORT te::rst::Raster* Reproject(te::rst::Raster const * const rin, int srid, double llx, double lly, double urx, double ury, double resx, double resy, const std::map<std::string, std::string>& routinfo, int m, const unsigned int maxThreads);
   }
 }
 
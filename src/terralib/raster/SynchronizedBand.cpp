@@ -28,6 +28,7 @@
 #include "SynchronizedBand.h"
 
 // STL
+#include <algorithm>
 #include <cstring>
 
 // initiating the dummy blocks manager
@@ -137,4 +138,59 @@ void te::rst::SynchronizedBand::write(int x, int y, void* buffer)
           m_blkSizeBytes );
 }
 
+void te::rst::SynchronizedBand::getValues(unsigned int c, unsigned int r, unsigned int ncols, unsigned int nrows, double* values) const
+{
+  assert( m_blocksManager.isInitialized() );
+
+  const int type = m_property->getType();
+  const unsigned int cf = c + ncols;
+
+  for( unsigned int row = r; row < r + nrows; ++row )
+  {
+    const unsigned int blkY = row / m_blkHeight;
+    const unsigned int blkRowPos = ( row % m_blkHeight ) * m_blkWidth;
+
+// one conversion call for each block span of the row
+    for( unsigned int col = c; col < cf; )
+    {
+      const unsigned int blkCol = col % m_blkWidth;
+      const unsigned int count = std::min( m_blkWidth - blkCol, cf - col );
+
+      te::rst::GetBufferValues( type, (int)( blkRowPos + blkCol ), (int)count,
+        m_blocksManager.getBlockPointer( (unsigned int)m_idx, col / m_blkWidth, blkY ),
+        values + ( col - c ) );
+
+      col += count;
+    }
+
+    values += ncols;
+  }
+}
 
+void te::rst::SynchronizedBand::setValues(unsigned int c, unsigned int r, unsigned int ncols, unsigned int nrows, const double* values)
+{
+  assert( m_blocksManager.isInitialized() );
+
+  const int type = m_property->getType();
+  const unsigned int cf = c + ncols;
+
+  for( unsigned int row = r; row < r + nrows; ++row )
+  {
+    const unsigned int blkY = row / m_blkHeight;
+    const unsigned int blkRowPos = ( row % m_blkHeight ) * m_blkWidth;
+
+    for( unsigned int col = c; col < cf; )
+    {
+      const unsigned int blkCol = col % m_blkWidth;
+      const unsigned int count = std::min( m_blkWidth - blkCol, cf - col );
+
+      te::rst::SetBufferValues( type, (int)( blkRowPos + blkCol ), (int)count,
+        m_blocksManager.getBlockPointer( (unsigned int)m_idx, col / m_blkWidth, blkY ),
+        values + ( col - c ) );
+
+      col += count;
+    }
+
+    values += ncols;
+  }
+}
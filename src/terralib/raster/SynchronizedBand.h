@@ -82,6 +82,10 @@ namespace te
 
         void write(int x, int y, void* buffer);
 
+        void getValues(unsigned int c, unsigned int r, unsigned int ncols, unsigned int nrows, double* values) const;
+
+        void setValues(unsigned int c, unsigned int r, unsigned int ncols, unsigned int nrows, const double* values);
+
       private:
 
         SynchronizedBand();
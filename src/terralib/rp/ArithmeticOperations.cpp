@@ -28,18 +28,157 @@
 #include "Macros.h"
 
 #include "../common/progress/TaskProgress.h"
+#include "../common/PlatformUtils.h"
 #include "../common/StringUtils.h"
 #include "../raster/Raster.h"
 #include "../raster/Band.h"
+#include "../raster/BandProperty.h"
+#include "../raster/RasterFactory.h"
 #include "../memory/ExpansibleRaster.h"
 #include "../srs/Converter.h"
 
+#include <algorithm>
 #include <cfloat>
+#include <cmath>
+#include <cstring>
+
+// The number of values evaluated at once by the fused program instructions
+// (the intermediate results of each chunk stay in the processor cache)
+#define FUSEDCHUNKSIZE 1024
 
 namespace te
 {
   namespace rp
   {
+    namespace
+    {
+      // Fused operators: the same results of the binary and unary operator functions
+
+      struct AdditionFunctor
+      {
+        inline double operator()( const double v1, const double v2 ) const { return v1 + v2; }
+      };
+
+      struct SubtractionFunctor
+      {
+        inline double operator()( const double v1, const double v2 ) const { return v1 - v2; }
+      };
+
+      struct MultiplicationFunctor
+      {
+        inline double operator()( const double v1, const double v2 ) const { return v1 * v2; }
+      };
+
+      struct DivisionFunctor
+      {
+        inline double operator()( const double v1, const double v2 ) const
+        {
+          return ( v2 == 0.0 ) ? 0.0 : ( v1 / v2 );
+        }
+      };
+
+      struct ExponencialFunctor
+      {
+        inline double operator()( const double v1, const double v2 ) const { return pow( v1, v2 ); }
+      };
+
+      struct SqrtFunctor
+      {
+        inline double operator()( const double v ) const { return sqrt( v ); }
+      };
+
+      struct SinFunctor
+      {
+        inline double operator()( const double v ) const { return sin( v ); }
+      };
+
+      struct AsinFunctor
+      {
+        inline double operator()( const double v ) const { return asin( v ); }
+      };
+
+      struct CosFunctor
+      {
+        inline double operator()( const double v ) const { return cos( v ); }
+      };
+
+      struct AcosFunctor
+      {
+        inline double operator()( const double v ) const { return acos( v ); }
+      };
+
+      struct LogFunctor
+      {
+        inline double operator()( const double v ) const { return log10( v ); }
+      };
+
+      struct TanFunctor
+      {
+        inline double operator()( const double v ) const { return tan( v ); }
+      };
+
+      struct AtanFunctor
+      {
+        inline double operator()( const double v ) const { return atan( v ); }
+      };
+
+      struct LnFunctor
+      {
+        inline double operator()( const double v ) const { return log( v ); }
+      };
+
+      // Fused kernels: the no-data values (DBL_MAX) are propagated with
+      // selections instead of branches, allowing the compiler to vectorize
+      // the simple operators
+
+      template< typename OperatorT >
+      void FusedBinaryKernel( const double* src1, const double* src2,
+        const double realValue, double* dst, const unsigned int valuesNumber )
+      {
+        const OperatorT op = OperatorT();
+        unsigned int idx = 0;
+
+        if( src1 == 0 )
+        {
+          for( idx = 0 ; idx < valuesNumber ; ++idx )
+          {
+            const double v2 = src2[ idx ];
+            dst[ idx ] = ( v2 == DBL_MAX ) ? DBL_MAX : op( realValue, v2 );
+          }
+        }
+        else if( src2 == 0 )
+        {
+          for( idx = 0 ; idx < valuesNumber ; ++idx )
+          {
+            const double v1 = src1[ idx ];
+            dst[ idx ] = ( v1 == DBL_MAX ) ? DBL_MAX : op( v1, realValue );
+          }
+        }
+        else
+        {
+          for( idx = 0 ; idx < valuesNumber ; ++idx )
+          {
+            const double v1 = src1[ idx ];
+            const double v2 = src2[ idx ];
+            dst[ idx ] = ( ( v1 == DBL_MAX ) | ( v2 == DBL_MAX ) ) ? DBL_MAX :
+              op( v1, v2 );
+          }
+        }
+      }
+
+      template< typename OperatorT >
+      void FusedUnaryKernel( const double* src, double* dst,
+        const unsigned int valuesNumber )
+      {
+        const OperatorT op = OperatorT();
+
+        for( unsigned int idx = 0 ; idx < valuesNumber ; ++idx )
+        {
+          const double v = src[ idx ];
+          dst[ idx ] = ( v == DBL_MAX ) ? DBL_MAX : op( v );
+        }
+      }
+    }
 
     ArithmeticOperations::InputParameters::InputParameters()
     {
@@ -64,6 +203,8 @@ namespace te
       m_normalize = false;
       m_enableProgress = false;
       m_interpMethod = te::rst::NearestNeighbor;
+      m_enableFusedExecution = true;
+      m_maxThreads = 0;
     }
 
     const ArithmeticOperations::InputParameters& ArithmeticOperations::InputParameters::operator=(
@@ -76,6 +217,8 @@ namespace te
       m_normalize = params.m_normalize;
       m_enableProgress = params.m_enableProgress;
       m_interpMethod = params.m_interpMethod;
+      m_enableFusedExecution = params.m_enableFusedExecution;
+      m_maxThreads = params.m_maxThreads;
 
       return *this;
     }
@@ -143,9 +286,47 @@ namespace te
         ArithmeticOperations::OutputParameters* >( &outputParams );
       TERP_TRUE_OR_THROW( outParamsPtr, "Invalid paramters" );
 
-      // Counting the number of operations to be done
       std::string arithmetic_string = m_inputParameters.m_arithmeticString;
 
+      // Fused execution
+
+      if( m_inputParameters.m_enableFusedExecution )
+      {
+        FusedProgram program;
+        TERP_TRUE_OR_RETURN_FALSE( compileString( arithmetic_string,
+          m_inputParameters.m_inputRasters, program ),
+          "Arithmetic string compilation error" );
+
+        // The bands of rasters with different grids must be interpolated
+        // by the operators execution below
+
+        bool sameGrid = true;
+
+        for( unsigned int inIdx = 1 ; inIdx < program.m_rasters.size() ; ++inIdx )
+        {
+          if( !( *program.m_rasters[ inIdx ]->getGrid() ==
+            *program.m_rasters[ 0 ]->getGrid() ) )
+          {
+            sameGrid = false;
+          }
+        }
+
+        if( sameGrid )
+        {
+          std::auto_ptr< te::common::TaskProgress > progressPtr;
+          if( m_inputParameters.m_enableProgress )
+          {
+            progressPtr.reset( new te::common::TaskProgress );
+
+            progressPtr->setMessage( "Arithmetic Operations" );
+          }
+
+          return executeFused( program, *outParamsPtr, progressPtr.get() );
+        }
+      }
+
+      // Counting the number of operations to be done
+
       unsigned int operationsNumber = 0;
       {
         for( unsigned sIdx = 0 ; sIdx < arithmetic_string.size() ; ++sIdx )
@@ -1122,5 +1303,662 @@ namespace te
         outTokens.push_back( bufferStr );
       }
     }
+
+    bool ArithmeticOperations::compileString( const std::string& aStr,
+      const std::vector< te::rst::Raster* >& inRasters,
+      FusedProgram& program ) const
+    {
+      program = FusedProgram();
+
+      std::vector< std::string > infixTokensVec;
+      getTokensStrs( aStr, infixTokensVec );
+      TERP_TRUE_OR_RETURN_FALSE( !infixTokensVec.empty(), "Arithmetic string is empty" );
+
+      std::vector< std::string > postfixTokensVec;
+      inFix2PostFix( infixTokensVec, postfixTokensVec );
+
+      unsigned int auxRasterIdx = 0;
+      unsigned int auxBandIdx = 0;
+      double auxRealValue = 0;
+      unsigned int tIdx = 0;
+      unsigned int inIdx = 0;
+
+      // The input band registers: each referenced band is loaded once
+
+      for( tIdx = 0 ; tIdx < postfixTokensVec.size() ; ++tIdx )
+      {
+        const std::string& curToken = postfixTokensVec[ tIdx ];
+
+        if( isRasterBandToken( curToken, auxRasterIdx, auxBandIdx ) )
+        {
+          TERP_TRUE_OR_RETURN_FALSE( auxRasterIdx < inRasters.size(),
+            "Invalid raster index found at " + curToken );
+
+          TERP_TRUE_OR_RETURN_FALSE( (std::size_t)auxBandIdx <
+            inRasters[auxRasterIdx]->getNumberOfBands(), "Invalid band index" );
+
+          for( inIdx = 0 ; inIdx < program.m_rasters.size() ; ++inIdx )
+          {
+            if( ( program.m_rasters[ inIdx ] == inRasters[ auxRasterIdx ] ) &&
+              ( program.m_bands[ inIdx ] == auxBandIdx ) )
+            {
+              break;
+            }
+          }
+
+          if( inIdx == program.m_rasters.size() )
+          {
+            program.m_rasters.push_back( inRasters[ auxRasterIdx ] );
+            program.m_bands.push_back( auxBandIdx );
+          }
+        }
+      }
+
+      const unsigned int inputsNumber = (unsigned int)program.m_rasters.size();
+      program.m_registersNumber = inputsNumber;
+
+      // Generating the instructions: the intermediate result at the stack
+      // position N is kept at the register inputsNumber + N. Each stack
+      // element is a register index or a real number (negative index).
+
+      std::vector< std::pair< int, double > > stack;
+
+      for( tIdx = 0 ; tIdx < postfixTokensVec.size() ; ++tIdx )
+      {
+        const std::string& curToken = postfixTokensVec[ tIdx ];
+
+        if( isRasterBandToken( curToken, auxRasterIdx, auxBandIdx ) )
+        {
+          for( inIdx = 0 ; inIdx < inputsNumber ; ++inIdx )
+          {
+            if( ( program.m_rasters[ inIdx ] == inRasters[ auxRasterIdx ] ) &&
+              ( program.m_bands[ inIdx ] == auxBandIdx ) )
+            {
+              break;
+            }
+          }
+
+          stack.push_back( std::pair< int, double >( (int)inIdx, 0.0 ) );
+        }
+        else if( isRealNumberToken( curToken, auxRealValue ) )
+        {
+          stack.push_back( std::pair< int, double >( -1, auxRealValue ) );
+        }
+        else if( isBinaryOperator( curToken ) )
+        {
+          TERP_TRUE_OR_RETURN_FALSE( stack.size() >= 2,
+            "Operator " + curToken + " execution error" );
+
+          const std::pair< int, double > rightElem = stack.back();
+          stack.pop_back();
+
+          const std::pair< int, double > leftElem = stack.back();
+          stack.pop_back();
+
+          FusedInstruction instruction;
+          BinOpFuncPtrT binOptFunctPtr = 0;
+
+          if( curToken == "+" )
+          {
+            instruction.m_opCode = FusedAdditionOp;
+            binOptFunctPtr = &ArithmeticOperations::additionBinOp;
+          }
+          else if( curToken == "-" )
+          {
+            instruction.m_opCode = FusedSubtractionOp;
+            binOptFunctPtr = &ArithmeticOperations::subtractionBinOp;
+          }
+          else if( curToken == "*" )
+          {
+            instruction.m_opCode = FusedMultiplicationOp;
+            binOptFunctPtr = &ArithmeticOperations::multiplicationBinOp;
+          }
+          else if( curToken == "/" )
+          {
+            instruction.m_opCode = FusedDivisionOp;
+            binOptFunctPtr = &ArithmeticOperations::divisionBinOp;
+          }
+          else
+          {
+            instruction.m_opCode = FusedExponencialOp;
+            binOptFunctPtr = &ArithmeticOperations::exponencialBinOp;
+          }
+
+          if( ( leftElem.first < 0 ) && ( rightElem.first < 0 ) )
+          {
+            // Real numbers only: evaluated once
+
+            double outValue = 0;
+            (this->*binOptFunctPtr)( leftElem.second, rightElem.second, outValue );
+
+            stack.push_back( std::pair< int, double >( -1, outValue ) );
+          }
+          else
+          {
+            instruction.m_src1 = leftElem.first;
+            instruction.m_src2 = rightElem.first;
+            instruction.m_realNumberValue = ( leftElem.first < 0 ) ?
+              leftElem.second : rightElem.second;
+            instruction.m_dst = inputsNumber + (unsigned int)stack.size();
+
+            program.m_instructions.push_back( instruction );
+            program.m_registersNumber = std::max( program.m_registersNumber,
+              instruction.m_dst + 1 );
+
+            stack.push_back( std::pair< int, double >( (int)instruction.m_dst, 0.0 ) );
+          }
+        }
+        else if( isUnaryOperator( curToken ) )
+        {
+          TERP_TRUE_OR_RETURN_FALSE( !stack.empty(),
+            "Operator " + curToken + " execution error" );
+
+          const std::pair< int, double > elem = stack.back();
+          stack.pop_back();
+
+          FusedInstruction instruction;
+          UnaryOpFuncPtrT unaryOptFunctPtr = 0;
+
+          if( curToken == "sqrt" )
+          {
+            instruction.m_opCode = FusedSqrtOp;
+            unaryOptFunctPtr = &ArithmeticOperations::sqrtUnaryOp;
+          }
+          else if( curToken == "sin" )
+          {
+            instruction.m_opCode = FusedSinOp;
+            unaryOptFunctPtr = &ArithmeticOperations::sinUnaryOp;
+          }
+          else if( curToken == "asin" )
+          {
+            instruction.m_opCode = FusedAsinOp;
+            unaryOptFunctPtr = &ArithmeticOperations::asinUnaryOp;
+          }
+          else if( curToken == "cos" )
+          {
+            instruction.m_opCode = FusedCosOp;
+            unaryOptFunctPtr = &ArithmeticOperations::cosUnaryOp;
+          }
+          else if( curToken == "acos" )
+          {
+            instruction.m_opCode = FusedAcosOp;
+            unaryOptFunctPtr = &ArithmeticOperations::acosUnaryOp;
+          }
+          else if( curToken == "log" )
+          {
+            instruction.m_opCode = FusedLogOp;
+            unaryOptFunctPtr = &ArithmeticOperations::logUnaryOp;
+          }
+          else if( curToken == "tan" )
+          {
+            instruction.m_opCode = FusedTanOp;
+            unaryOptFunctPtr = &ArithmeticOperations::tanUnaryOp;
+          }
+          else if( curToken == "atan" )
+          {
+            instruction.m_opCode = FusedAtanOp;
+            unaryOptFunctPtr = &ArithmeticOperations::atanUnaryOp;
+          }
+          else
+          {
+            instruction.m_opCode = FusedLnOp;
+            unaryOptFunctPtr = &ArithmeticOperations::lnUnaryOp;
+          }
+
+          if( elem.first < 0 )
+          {
+            double outValue = 0;
+            (this->*unaryOptFunctPtr)( elem.second, outValue );
+
+            stack.push_back( std::pair< int, double >( -1, outValue ) );
+          }
+          else
+          {
+            instruction.m_src1 = elem.first;
+            instruction.m_src2 = -1;
+            instruction.m_realNumberValue = 0;
+            instruction.m_dst = inputsNumber + (unsigned int)stack.size();
+
+            program.m_instructions.push_back( instruction );
+            program.m_registersNumber = std::max( program.m_registersNumber,
+              instruction.m_dst + 1 );
+
+            stack.push_back( std::pair< int, double >( (int)instruction.m_dst, 0.0 ) );
+          }
+        }
+        else
+        {
+          TERP_LOG_AND_RETURN_FALSE( "Invalid operator found: " + curToken );
+        }
+      }
+
+      TERP_TRUE_OR_RETURN_FALSE( stack.size() == 1, "Invalid stack size" );
+      TERP_TRUE_OR_RETURN_FALSE( stack.back().first >= 0, "Stack result error" );
+
+      program.m_resultRegister = (unsigned int)stack.back().first;
+
+      return true;
+    }
+
+    bool ArithmeticOperations::executeFused( const FusedProgram& program,
+      OutputParameters& outParams, te::common::TaskProgress* const progressPtr ) const
+    {
+      TERP_DEBUG_TRUE_OR_THROW( !program.m_rasters.empty(), "Internal error" );
+
+      const te::rst::Raster& firstRaster = *program.m_rasters[ 0 ];
+
+      // Initializing the output raster (the same properties generated by the
+      // operators execution)
+
+      std::vector< te::rst::BandProperty* > bandsProperties;
+      bandsProperties.push_back( new te::rst::BandProperty(
+        *( m_inputParameters.m_inputRasters[0]->getBand(0)->getProperty() ) ) );
+      if( !m_inputParameters.m_normalize )
+      {
+        bandsProperties[ 0 ]->m_type = te::dt::DOUBLE_TYPE;
+        bandsProperties[ 0 ]->m_noDataValue = std::numeric_limits< double >::max();
+      }
+
+      outParams.m_outputRasterPtr.reset(
+        te::rst::RasterFactory::make(
+          outParams.m_rType,
+          new te::rst::Grid( *( firstRaster.getGrid() ) ),
+          bandsProperties,
+          outParams.m_rInfo,
+          0,
+          0 ) );
+      TERP_TRUE_OR_RETURN_FALSE( outParams.m_outputRasterPtr.get(),
+        "Output raster creation error" );
+
+      te::rst::Band& outBand = *outParams.m_outputRasterPtr->getBand( 0 );
+
+      boost::mutex mutex;
+      boost::condition_variable condVar;
+
+      FusedThreadParams params;
+      params.m_programPtr = &program;
+      for( unsigned int inIdx = 0 ; inIdx < program.m_rasters.size() ; ++inIdx )
+      {
+        params.m_inBandsPtrs.push_back( program.m_rasters[ inIdx ]->getBand(
+          program.m_bands[ inIdx ] ) );
+      }
+      params.m_outBandPtr = 0;
+      params.m_nRows = (unsigned int)firstRaster.getNumberOfRows();
+      params.m_nCols = (unsigned int)firstRaster.getNumberOfColumns();
+      params.m_stripRowsNumber = 0;
+      params.m_normalize = m_inputParameters.m_normalize &&
+        ( outBand.getProperty()->getType() != te::dt::DOUBLE_TYPE );
+      params.m_outputOffset = 0;
+      params.m_outputGain = 1.0;
+      params.m_outNoDataValue = outBand.getProperty()->m_noDataValue;
+      GetDataTypeRange( outBand.getProperty()->getType(), params.m_outAllowedMin,
+        params.m_outAllowedMax );
+      params.m_resultMin = DBL_MAX;
+      params.m_resultMax = -1.0 * DBL_MAX;
+      params.m_mutexPtr = &mutex;
+      params.m_condVarPtr = &condVar;
+      params.m_progressPtr = progressPtr;
+      params.m_nextStripRow = 0;
+      params.m_processedRowsNumber = 0;
+      params.m_runningThreadsNumber = 0;
+      params.m_abort = false;
+      params.m_returnStatus = true;
+
+      if( progressPtr )
+      {
+        progressPtr->setTotalSteps( ( params.m_normalize ? 2 : 1 ) * params.m_nRows );
+      }
+
+      if( params.m_normalize )
+      {
+        // A first pass finds the results range used to calculate the
+        // output gain and offset
+
+        TERP_TRUE_OR_RETURN_FALSE( executeFusedPass( params ),
+          "Arithmetic string execution error" );
+
+        if( ( params.m_resultMin != DBL_MAX ) && ( params.m_resultMax !=
+          ( -1.0 * DBL_MAX ) ) && ( params.m_resultMax != params.m_resultMin ) )
+        {
+          params.m_outputOffset = -1.0 * params.m_resultMin;
+          params.m_outputGain = ( ( params.m_outAllowedMax - params.m_outAllowedMin ) /
+            ( params.m_resultMax - params.m_resultMin ) );
+        }
+      }
+
+      params.m_outBandPtr = &outBand;
+
+      TERP_TRUE_OR_RETURN_FALSE( executeFusedPass( params ),
+        "Arithmetic string execution error" );
+
+      return true;
+    }
+
+    bool ArithmeticOperations::executeFusedPass( FusedThreadParams& params ) const
+    {
+      // Defining the strips: a few strips for each thread keep the threads busy
+
+      unsigned int threadsNumber = m_inputParameters.m_maxThreads ?
+        m_inputParameters.m_maxThreads : te::common::GetPhysProcNumber();
+      threadsNumber = std::max( threadsNumber, 1u );
+
+      const unsigned int rowBuffersSize = std::max( params.m_nCols *
+        ( (unsigned int)params.m_inBandsPtrs.size() + 1 ), 1u );
+
+      params.m_stripRowsNumber = std::max( 16u, ( params.m_nRows /
+        ( 4 * threadsNumber ) ) + 1 );
+      params.m_stripRowsNumber = std::min( params.m_stripRowsNumber,
+        std::max( 1u, ( 4194304u / rowBuffersSize ) ) );
+
+      const unsigned int stripsNumber = ( params.m_nRows +
+        params.m_stripRowsNumber - 1 ) / params.m_stripRowsNumber;
+      threadsNumber = std::min( threadsNumber, std::max( stripsNumber, 1u ) );
+
+      params.m_nextStripRow = 0;
+
+      if( threadsNumber == 1 )
+      {
+        params.m_runningThreadsNumber = 1;
+
+        FusedThreadEntry( &params );
+      }
+      else
+      {
+        // the progress interface is only used by this thread
+
+        te::common::TaskProgress* const progressPtr = params.m_progressPtr;
+        params.m_progressPtr = 0;
+        params.m_runningThreadsNumber = threadsNumber;
+
+        boost::thread_group threads;
+
+        for( unsigned int threadIdx = 0 ; threadIdx < threadsNumber ;
+          ++threadIdx )
+        {
+          threads.add_thread( new boost::thread( FusedThreadEntry,
+             &params ) );
+        }
+
+        {
+          boost::unique_lock< boost::mutex > lock( *params.m_mutexPtr );
+
+          while( params.m_runningThreadsNumber )
+          {
+            params.m_condVarPtr->wait( lock );
+
+            if( progressPtr )
+            {
+              progressPtr->setCurrentStep( params.m_processedRowsNumber );
+
+              if( !progressPtr->isActive() )
+              {
+                params.m_abort = true;
+              }
+            }
+          }
+        }
+
+        threads.join_all();
+
+        params.m_progressPtr = progressPtr;
+      }
+
+      return params.m_returnStatus;
+    }
+
+    void ArithmeticOperations::FusedThreadEntry( FusedThreadParams* paramsPtr )
+    {
+      const FusedProgram& program = *paramsPtr->m_programPtr;
+      const unsigned int nCols = paramsPtr->m_nCols;
+      const unsigned int inputsNumber = (unsigned int)paramsPtr->m_inBandsPtrs.size();
+
+      std::vector< std::vector< double > > inBuffers( inputsNumber );
+      std::vector< double > outBuffer;
+      std::vector< double > resultsBuffer( ( program.m_registersNumber -
+        inputsNumber ) * FUSEDCHUNKSIZE );
+      std::vector< double* > registers( program.m_registersNumber );
+      double resultMin = DBL_MAX;
+      double resultMax = -1.0 * DBL_MAX;
+      unsigned int inIdx = 0;
+      unsigned int idx = 0;
+
+      for( idx = inputsNumber ; idx < program.m_registersNumber ; ++idx )
+      {
+        registers[ idx ] = &resultsBuffer[ ( idx - inputsNumber ) * FUSEDCHUNKSIZE ];
+      }
+
+      while( true )
+      {
+        unsigned int firstRow = 0;
+        unsigned int rowsNumber = 0;
+
+        // Taking the next strip and reading the input bands rows
+
+        {
+          boost::lock_guard< boost::mutex > lock( *( paramsPtr->m_mutexPtr ) );
+
+          if( paramsPtr->m_abort ||
+            ( paramsPtr->m_nextStripRow >= paramsPtr->m_nRows ) )
+          {
+            break;
+          }
+
+          firstRow = paramsPtr->m_nextStripRow;
+          rowsNumber = std::min( paramsPtr->m_stripRowsNumber,
+            paramsPtr->m_nRows - firstRow );
+          paramsPtr->m_nextStripRow += rowsNumber;
+
+          try
+          {
+            for( inIdx = 0 ; inIdx < inputsNumber ; ++inIdx )
+            {
+              inBuffers[ inIdx ].resize( rowsNumber * nCols );
+
+              paramsPtr->m_inBandsPtrs[ inIdx ]->getValues( 0, firstRow, nCols,
+                rowsNumber, &inBuffers[ inIdx ][ 0 ] );
+            }
+
+            outBuffer.resize( rowsNumber * nCols );
+          }
+          catch( ... )
+          {
+            paramsPtr->m_returnStatus = false;
+            paramsPtr->m_abort = true;
+            break;
+          }
+        }
+
+        const unsigned int valuesNumber = rowsNumber * nCols;
+
+        // The input no-data values are replaced by the no-data value of the
+        // intermediate results
+
+        for( inIdx = 0 ; inIdx < inputsNumber ; ++inIdx )
+        {
+          const double inNoData = paramsPtr->m_inBandsPtrs[ inIdx ]->getProperty()->m_noDataValue;
+
+          if( inNoData != DBL_MAX )
+          {
+            double* valuesPtr = &inBuffers[ inIdx ][ 0 ];
+
+            for( idx = 0 ; idx < valuesNumber ; ++idx )
+            {
+              valuesPtr[ idx ] = ( valuesPtr[ idx ] == inNoData ) ? DBL_MAX :
+                valuesPtr[ idx ];
+            }
+          }
+        }
+
+        // Evaluating the whole expression over chunks of values
+
+        for( unsigned int offset = 0 ; offset < valuesNumber ; offset += FUSEDCHUNKSIZE )
+        {
+          const unsigned int chunkSize = std::min( (unsigned int)FUSEDCHUNKSIZE,
+            valuesNumber - offset );
+
+          for( inIdx = 0 ; inIdx < inputsNumber ; ++inIdx )
+          {
+            registers[ inIdx ] = &inBuffers[ inIdx ][ offset ];
+          }
+
+          ExecuteFusedInstructions( program, &registers[ 0 ], chunkSize );
+
+          memcpy( &outBuffer[ offset ], registers[ program.m_resultRegister ],
+            chunkSize * sizeof( double ) );
+        }
+
+        if( paramsPtr->m_outBandPtr == 0 )
+        {
+          // Updating the results range
+
+          for( idx = 0 ; idx < valuesNumber ; ++idx )
+          {
+            const double value = outBuffer[ idx ];
+
+            if( value != DBL_MAX )
+            {
+              if( resultMin > value ) resultMin = value;
+              if( resultMax < value ) resultMax = value;
+            }
+          }
+        }
+        else if( paramsPtr->m_normalize )
+        {
+          for( idx = 0 ; idx < valuesNumber ; ++idx )
+          {
+            double& value = outBuffer[ idx ];
+
+            if( value == DBL_MAX )
+            {
+              value = paramsPtr->m_outNoDataValue;
+            }
+            else
+            {
+              value += paramsPtr->m_outputOffset;
+              value *= paramsPtr->m_outputGain;
+
+              value = MIN( value, paramsPtr->m_outAllowedMax );
+              value = MAX( value, paramsPtr->m_outAllowedMin );
+            }
+          }
+        }
+
+        // Writing the output rows
+
+        {
+          boost::lock_guard< boost::mutex > lock( *( paramsPtr->m_mutexPtr ) );
+
+          if( paramsPtr->m_outBandPtr )
+          {
+            try
+            {
+              paramsPtr->m_outBandPtr->setValues( 0, firstRow, nCols, rowsNumber,
+                &outBuffer[ 0 ] );
+            }
+            catch( ... )
+            {
+              paramsPtr->m_returnStatus = false;
+              paramsPtr->m_abort = true;
+              break;
+            }
+          }
+
+          paramsPtr->m_processedRowsNumber += rowsNumber;
+
+          if( paramsPtr->m_progressPtr )
+          {
+            paramsPtr->m_progressPtr->setCurrentStep(
+              paramsPtr->m_processedRowsNumber );
+
+            if( !paramsPtr->m_progressPtr->isActive() )
+            {
+              paramsPtr->m_abort = true;
+            }
+          }
+        }
+
+        paramsPtr->m_condVarPtr->notify_one();
+      }
+
+      {
+        boost::lock_guard< boost::mutex > lock( *( paramsPtr->m_mutexPtr ) );
+
+        if( paramsPtr->m_outBandPtr == 0 )
+        {
+          paramsPtr->m_resultMin = std::min( paramsPtr->m_resultMin, resultMin );
+          paramsPtr->m_resultMax = std::max( paramsPtr->m_resultMax, resultMax );
+        }
+
+        --( paramsPtr->m_runningThreadsNumber );
+
+        if( paramsPtr->m_abort )
+        {
+          paramsPtr->m_returnStatus = false;
+        }
+      }
+
+      paramsPtr->m_condVarPtr->notify_one();
+    }
+
+    void ArithmeticOperations::ExecuteFusedInstructions( const FusedProgram& program,
+      double* const* registers, const unsigned int valuesNumber )
+    {
+      const unsigned int instructionsNumber = (unsigned int)program.m_instructions.size();
+
+      for( unsigned int iIdx = 0 ; iIdx < instructionsNumber ; ++iIdx )
+      {
+        const FusedInstruction& instruction = program.m_instructions[ iIdx ];
+        const double* src1 = ( instruction.m_src1 < 0 ) ? 0 : registers[ instruction.m_src1 ];
+        const double* src2 = ( instruction.m_src2 < 0 ) ? 0 : registers[ instruction.m_src2 ];
+        double* dst = registers[ instruction.m_dst ];
+        const double realValue = instruction.m_realNumberValue;
+
+        switch( instruction.m_opCode )
+        {
+          case FusedAdditionOp :
+            FusedBinaryKernel< AdditionFunctor >( src1, src2, realValue, dst, valuesNumber );
+            break;
+          case FusedSubtractionOp :
+            FusedBinaryKernel< SubtractionFunctor >( src1, src2, realValue, dst, valuesNumber );
+            break;
+          case FusedMultiplicationOp :
+            FusedBinaryKernel< MultiplicationFunctor >( src1, src2, realValue, dst, valuesNumber );
+            break;
+          case FusedDivisionOp :
+            FusedBinaryKernel< DivisionFunctor >( src1, src2, realValue, dst, valuesNumber );
+            break;
+          case FusedExponencialOp :
+            FusedBinaryKernel< ExponencialFunctor >( src1, src2, realValue, dst, valuesNumber );
+            break;
+          case FusedSqrtOp :
+            FusedUnaryKernel< SqrtFunctor >( src1, dst, valuesNumber );
+            break;
+          case FusedSinOp :
+            FusedUnaryKernel< SinFunctor >( src1, dst, valuesNumber );
+            break;
+          case FusedAsinOp :
+            FusedUnaryKernel< AsinFunctor >( src1, dst, valuesNumber );
+            break;
+          case FusedCosOp :
+            FusedUnaryKernel< CosFunctor >( src1, dst, valuesNumber );
+            break;
+          case FusedAcosOp :
+            FusedUnaryKernel< AcosFunctor >( src1, dst, valuesNumber );
+            break;
+          case FusedLogOp :
+            FusedUnaryKernel< LogFunctor >( src1, dst, valuesNumber );
+            break;
+          case FusedTanOp :
+            FusedUnaryKernel< TanFunctor >( src1, dst, valuesNumber );
+            break;
+          case FusedAtanOp :
+            FusedUnaryKernel< AtanFunctor >( src1, dst, valuesNumber );
+            break;
+          default :
+            FusedUnaryKernel< LnFunctor >( src1, dst, valuesNumber );
+            break;
+        }
+      }
+    }
   }
 }
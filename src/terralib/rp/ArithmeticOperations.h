@@ -32,6 +32,7 @@
 
 //Boost
 #include <boost/math/constants/constants.hpp>
+#include <boost/thread.hpp>
 
 #include <map>
 #include <memory>
@@ -44,6 +45,7 @@ namespace te
 {
   namespace rst
   {
+    class Band;
     class Raster;
   }
 
@@ -62,6 +64,11 @@ namespace te
         Real Numbers (negative numbers must follow the form "-1.0")
 
         Raster bands: R0:1, R0:1, R1:0, .... (R0:1 is a reference to the first raster - with index 0 - from feeder, second band - with index 1).
+
+               By default, the expression is compiled into a program that evaluates all operators
+               over strips of rows, read once from each referenced band, using multiple threads.
+               Expressions over rasters with different grids are executed operator by operator,
+               interpolating the bands of the right terms.
       
       \note Reference: TerraLib 4 - Image Processing Module
       
@@ -88,6 +95,10 @@ namespace te
             bool m_enableProgress; //!< Enable/Disable the progress interface (default:false).
             
             te::rst::Interpolator::Method m_interpMethod; //!< The raster interpolator method (default:NearestNeighbor).
+
+            bool m_enableFusedExecution; //!< If true, the expression is compiled and evaluated in a single pass over strips of rows, without intermediate rasters, when all referenced rasters share the same grid (default:true).
+
+            unsigned int m_maxThreads; //!< The maximum number of threads used by the fused execution (0-auto, 1-single thread used, default:0).
             
             InputParameters();
             
@@ -221,6 +232,130 @@ namespace te
 
         typedef void (ArithmeticOperations::*UnaryOpFuncPtrT)(const double& inputValue1, double& outputValue) const;
 
+        /*!
+          \brief Fused program operation codes.
+         */
+        enum FusedOpCode
+        {
+          FusedAdditionOp,
+          FusedSubtractionOp,
+          FusedMultiplicationOp,
+          FusedDivisionOp,
+          FusedExponencialOp,
+          FusedSqrtOp,
+          FusedSinOp,
+          FusedAsinOp,
+          FusedCosOp,
+          FusedAcosOp,
+          FusedLogOp,
+          FusedTanOp,
+          FusedAtanOp,
+          FusedLnOp
+        };
+
+        /*!
+          \class FusedInstruction
+          \brief A fused program instruction (dst = src1 op src2 or dst = op src1).
+          \note A negative source register index refers to the instruction real number.
+         */
+        class FusedInstruction
+        {
+          public :
+
+            FusedOpCode m_opCode; //!< Operation code.
+
+            int m_src1; //!< First operand register index.
+
+            int m_src2; //!< Second operand register index (binary operators only).
+
+            unsigned int m_dst; //!< Result register index.
+
+            double m_realNumberValue; //!< The real number operand.
+        };
+
+        /*!
+          \class FusedProgram
+          \brief An arithmetic expression compiled into register instructions.
+          \details The first registers hold the values of the referenced raster bands, each
+                   band is loaded once even if it is referenced many times. The remaining
+                   registers hold the intermediate results.
+         */
+        class FusedProgram
+        {
+          public :
+
+            std::vector< te::rst::Raster* > m_rasters; //!< The raster of each input band register.
+
+            std::vector< unsigned int > m_bands; //!< The band index of each input band register.
+
+            std::vector< FusedInstruction > m_instructions; //!< Instructions.
+
+            unsigned int m_registersNumber; //!< The number of registers (input bands and intermediate results).
+
+            unsigned int m_resultRegister; //!< The register holding the expression result.
+
+            FusedProgram() : m_registersNumber( 0 ), m_resultRegister( 0 ) {};
+
+            ~FusedProgram() {};
+        };
+
+        /*!
+          \class FusedThreadParams
+          \brief The parameters shared by the threads executing a fused program.
+         */
+        class FusedThreadParams
+        {
+          public:
+
+            FusedProgram const* m_programPtr; //!< The program.
+
+            std::vector< te::rst::Band const* > m_inBandsPtrs; //!< The band of each input band register.
+
+            te::rst::Band* m_outBandPtr; //!< Output band (or null if the results are not written).
+
+            unsigned int m_nRows; //!< Raster rows number.
+
+            unsigned int m_nCols; //!< Raster columns number.
+
+            unsigned int m_stripRowsNumber; //!< The number of rows of each strip.
+
+            bool m_normalize; //!< true if the output values must be normalized.
+
+            double m_outputOffset; //!< Normalization offset.
+
+            double m_outputGain; //!< Normalization gain.
+
+            double m_outNoDataValue; //!< Output band no-data value.
+
+            double m_outAllowedMin; //!< Output band minimum allowed value.
+
+            double m_outAllowedMax; //!< Output band maximum allowed value.
+
+            double m_resultMin; //!< The minimum valid result value.
+
+            double m_resultMax; //!< The maximum valid result value.
+
+            boost::mutex* m_mutexPtr; //!< A pointer to the sync mutex (the access to the bands and the variables below).
+
+            boost::condition_variable* m_condVarPtr; //!< A pointer to the condition variable used to notify strips finishment.
+
+            te::common::TaskProgress* m_progressPtr; //!< The progress interface to be updated by the threads (or null).
+
+            unsigned int m_nextStripRow; //!< The first row of the next strip to be processed.
+
+            unsigned int m_processedRowsNumber; //!< The number of processed rows (including previous passes).
+
+            unsigned int m_runningThreadsNumber; //!< The number of running threads.
+
+            bool m_abort; //!< true if the threads must stop.
+
+            bool m_returnStatus; //!< false on errors.
+
+            FusedThreadParams() {};
+
+            ~FusedThreadParams() {};
+        };
+
         ArithmeticOperations::InputParameters m_inputParameters; //!< Input execution parameters.
 
         bool m_isInitialized; //!< Tells if this instance is initialized.
@@ -479,6 +614,53 @@ namespace te
         */         
         void getTokensStrs( const std::string& inputStr,
           std::vector< std::string >& outTokens ) const;
+
+        /*!
+          \brief Compile the given arithmetic string into a fused program.
+          \param aStr The input arithmetic expression string.
+          \param inRasters Input rasters pointers.
+          \param program The generated program.
+          \return true if OK, false on errors.
+          \note Operations over real numbers only are evaluated during the compilation.
+        */
+        bool compileString( const std::string& aStr,
+          const std::vector< te::rst::Raster* >& inRasters,
+          FusedProgram& program ) const;
+
+        /*!
+          \brief Execute a fused program, generating the output raster.
+          \param program The program.
+          \param outParams The output parameters.
+          \param progressPtr A pointer to a progress interface or a null pointer.
+          \return true if OK, false on errors.
+          \note The whole expression is evaluated for each strip of rows, the output is
+                 written without intermediate rasters. The normalization requires a first pass
+                 to find the results range.
+        */
+        bool executeFused( const FusedProgram& program, OutputParameters& outParams,
+          te::common::TaskProgress* const progressPtr ) const;
+
+        /*!
+          \brief Execute a pass over all rows with up to m_maxThreads threads.
+          \param params The shared parameters.
+          \return true if OK, false on errors.
+        */
+        bool executeFusedPass( FusedThreadParams& params ) const;
+
+        /*!
+          \brief The thread entry: the strips are read, evaluated and written (or used to update the results range) until all rows are done.
+          \param paramsPtr A pointer to the shared parameters.
+         */
+        static void FusedThreadEntry( FusedThreadParams* paramsPtr );
+
+        /*!
+          \brief Execute the program instructions over a sequence of values.
+          \param program The program.
+          \param registers The registers pointers (each one with room for valuesNumber values).
+          \param valuesNumber The number of values.
+         */
+        static void ExecuteFusedInstructions( const FusedProgram& program,
+          double* const* registers, const unsigned int valuesNumber );
     };
   } // end namespace rp
 }   // end namespace te
@@ -31,11 +31,13 @@
 #include "../raster/Grid.h"
 #include "../raster/Band.h"
 #include "../raster/BandIterator.h"
-#include "../raster/BandIteratorWindow.h"
 #include "../common/progress/TaskProgress.h"
+#include "../common/PlatformUtils.h"
 
+#include <algorithm>
 #include <memory>
 #include <cmath>
+#include <vector>
 
 namespace te
 {
@@ -68,6 +70,7 @@ namespace te
       m_windowW = 3;
       m_enableProgress = false;
       m_window.clear();
+      m_maxThreads = 0;
     }
 
     const Filter::InputParameters& Filter::InputParameters::operator=(
@@ -82,6 +85,7 @@ namespace te
       m_windowH = params.m_windowH;
       m_windowW = params.m_windowW;
       m_enableProgress = params.m_enableProgress;
+      m_maxThreads = params.m_maxThreads;
 
       if (m_filterType == InputParameters::UserDefinedWindowT)
         m_window = params.m_window;
@@ -140,17 +144,6 @@ namespace te
 
     Filter::~Filter()
     {
-      if (m_convBuffer != 0) {
-        for (unsigned int line = 0; line < m_convBufferLines; ++line) {
-          delete[] m_convBuffer[line];
-        }
-
-        delete[] m_convBuffer;
-
-        m_convBuffer = 0;
-        m_convBufferLines = 0;
-        m_convBufferColumns = 0;
-      }
     }
 
     bool Filter::execute( AlgorithmOutputParameters& outputParams )
@@ -245,56 +238,6 @@ namespace te
 
       // Filtering
 
-      FilterMethodPointerT filterPointer = 0;
-      switch( m_inputParameters.m_filterType )
-      {
-        case InputParameters::RobertsFilterT :
-        {
-          filterPointer = &Filter::RobertsFilter;
-          break;
-        }
-        case InputParameters::SobelFilterT :
-        {
-          filterPointer = &Filter::SobelFilter;
-          break;
-        }
-        case InputParameters::MeanFilterT :
-        {
-          filterPointer = &Filter::MeanFilter;
-          break;
-        }
-        case InputParameters::ModeFilterT :
-        {
-          filterPointer = &Filter::ModeFilter;
-          break;
-        }
-        case InputParameters::MedianFilterT :
-        {
-          filterPointer = &Filter::MedianFilter;
-          break;
-        }
-        case InputParameters::DilationFilterT :
-        {
-          filterPointer = &Filter::DilationFilter;
-          break;
-        }
-        case InputParameters::ErosionFilterT :
-        {
-          filterPointer = &Filter::ErosionFilter;
-          break;
-        }
-        case InputParameters::UserDefinedWindowT :
-        {
-          filterPointer = &Filter::UserDefinedFilter;
-          break;
-        }
-        default :
-        {
-          TERP_LOG_AND_THROW( "Invalid filter type" );
-          break;
-        }
-      }
-
       const bool useGlobalProgress = ( ( m_inputParameters.m_iterationsNumber *
         m_inputParameters.m_inRasterBands.size() ) != 1 );
 
@@ -352,7 +295,7 @@ namespace te
         for( unsigned int inRasterBandsIdx = 0 ; inRasterBandsIdx <
           m_inputParameters.m_inRasterBands.size() ; ++inRasterBandsIdx )
         {
-          if( (this->*(filterPointer))( *srcRasterPtr, ( iteration == 0 ) ?
+          if( FilterBand( *srcRasterPtr, ( iteration == 0 ) ?
             m_inputParameters.m_inRasterBands[ inRasterBandsIdx ] :
             inRasterBandsIdx, *dstRasterPtr, inRasterBandsIdx,
             ( m_inputParameters.m_enableProgress && (!useGlobalProgress) ) ) ==
@@ -371,10 +314,6 @@ namespace te
     {
       m_isInitialized = false;
       m_inputParameters.reset();
-
-      m_convBuffer = 0;
-      m_convBufferLines = 0;
-      m_convBufferColumns = 0;
     }
 
     bool Filter::initialize( const AlgorithmInputParameters& inputParams )
@@ -454,7 +393,7 @@ namespace te
       return m_isInitialized;
     }
 
-    bool Filter::RobertsFilter( const te::rst::Raster& srcRaster,
+    bool Filter::FilterBand( const te::rst::Raster& srcRaster,
       const unsigned int srcBandIdx, te::rst::Raster& dstRaster,
       const unsigned int dstBandIdx, const bool useProgress )
     {
@@ -467,795 +406,1111 @@ namespace te
       TERP_DEBUG_TRUE_OR_THROW( dstBandIdx < dstRaster.getNumberOfBands(),
         "Internal error" );
 
-      const unsigned int nRows = (unsigned int)( srcRaster.getNumberOfRows() );
-      const unsigned int rowsBound = (unsigned int)( nRows ?
-        ( nRows - 1 ) : 0 );
+      const te::rst::Band& srcBand = *( srcRaster.getBand( srcBandIdx ) );
+      te::rst::Band& dstBand = *( dstRaster.getBand( dstBandIdx ) );
+
+      boost::mutex mutex;
+      boost::condition_variable condVar;
+
+      FilterThreadParams params;
+      params.m_srcBandPtr = &srcBand;
+      params.m_dstBandPtr = &dstBand;
+      params.m_windowPtr = &m_inputParameters.m_window;
+      params.m_nRows = (unsigned int)srcRaster.getNumberOfRows();
+      params.m_nCols = (unsigned int)srcRaster.getNumberOfColumns();
+      params.m_windowH = m_inputParameters.m_windowH;
+      params.m_windowW = m_inputParameters.m_windowW;
+      params.m_rowsAbove = m_inputParameters.m_windowH / 2;
+      params.m_rowsBelow = m_inputParameters.m_windowH / 2;
+      params.m_outRowsNumber = params.m_nRows;
+      params.m_outColsNumber = params.m_nCols;
+      params.m_srcNoDataValue = srcBand.getProperty()->m_noDataValue;
+      params.m_dstNoDataValue = dstBand.getProperty()->m_noDataValue;
+      te::rp::GetDataTypeRange( dstBand.getProperty()->getType(),
+        params.m_dstAllowedMin, params.m_dstAllowedMax );
+      params.m_mutexPtr = &mutex;
+      params.m_condVarPtr = &condVar;
+      params.m_progressPtr = 0;
+      params.m_nextStripRow = 0;
+      params.m_processedRowsNumber = 0;
+      params.m_runningThreadsNumber = 0;
+      params.m_abort = false;
+      params.m_returnStatus = true;
+
+      // Integer data with up to 16 bits can be mapped to histogram bins
+
+      params.m_useHistogram = true;
+
+      switch( srcBand.getProperty()->getType() )
+      {
+        case te::dt::R1BIT_TYPE :
+        case te::dt::R2BITS_TYPE :
+        case te::dt::R4BITS_TYPE :
+        case te::dt::UCHAR_TYPE :
+        {
+          params.m_histogramMin = 0;
+          params.m_histogramSize = 256;
+          break;
+        }
+        case te::dt::CHAR_TYPE :
+        {
+          params.m_histogramMin = -128;
+          params.m_histogramSize = 256;
+          break;
+        }
+        case te::dt::UINT16_TYPE :
+        {
+          params.m_histogramMin = 0;
+          params.m_histogramSize = 65536;
+          break;
+        }
+        case te::dt::INT16_TYPE :
+        {
+          params.m_histogramMin = -32768;
+          params.m_histogramSize = 65536;
+          break;
+        }
+        default :
+        {
+          params.m_useHistogram = false;
+          params.m_histogramMin = 0;
+          params.m_histogramSize = 0;
+          break;
+        }
+      }
+
+      std::string taskName;
+
+      switch( m_inputParameters.m_filterType )
+      {
+        case InputParameters::RobertsFilterT :
+        {
+          params.m_stripFilterPtr = &Filter::RobertsStrip;
+          params.m_rowsAbove = 0;
+          params.m_rowsBelow = 1;
+          taskName = TE_TR("Roberts Filter");
+          break;
+        }
+        case InputParameters::SobelFilterT :
+        {
+          // The result of each 3x3 window is stored at its upper-left pixel
+
+          params.m_stripFilterPtr = &Filter::SobelStrip;
+          params.m_rowsAbove = 0;
+          params.m_rowsBelow = 2;
+          params.m_outRowsNumber = params.m_nRows - 2;
+          params.m_outColsNumber = params.m_nCols - 2;
+          taskName = TE_TR("Sobel Filter");
+          break;
+        }
+        case InputParameters::MeanFilterT :
+        {
+          params.m_stripFilterPtr = &Filter::MeanStrip;
+          taskName = TE_TR("Mean Filter");
+          break;
+        }
+        case InputParameters::ModeFilterT :
+        {
+          params.m_stripFilterPtr = &Filter::ModeStrip;
+          taskName = TE_TR("Mode Filter");
+          break;
+        }
+        case InputParameters::MedianFilterT :
+        {
+          params.m_stripFilterPtr = &Filter::MedianStrip;
+          taskName = TE_TR("Median Filter");
+          break;
+        }
+        case InputParameters::DilationFilterT :
+        {
+          params.m_stripFilterPtr = &Filter::DilationStrip;
+          taskName = TE_TR("Dilation Filter");
+          break;
+        }
+        case InputParameters::ErosionFilterT :
+        {
+          params.m_stripFilterPtr = &Filter::ErosionStrip;
+          taskName = TE_TR("Erosion Filter");
+          break;
+        }
+        case InputParameters::UserDefinedWindowT :
+        {
+          params.m_stripFilterPtr = &Filter::UserDefinedStrip;
+          taskName = TE_TR("User Defined Filter");
+          break;
+        }
+        default :
+        {
+          TERP_LOG_AND_THROW( "Invalid filter type" );
+          break;
+        }
+      }
+
+      // Defining the strips: a few strips for each thread keep the threads
+      // busy, the input rows shared by neighbour strips are read twice
+
+      unsigned int threadsNumber = m_inputParameters.m_maxThreads ?
+        m_inputParameters.m_maxThreads : te::common::GetPhysProcNumber();
+      threadsNumber = std::max( threadsNumber, 1u );
+
+      params.m_stripRowsNumber = std::max( 32u, ( params.m_outRowsNumber /
+        ( 4 * threadsNumber ) ) + 1 );
+      params.m_stripRowsNumber = std::min( params.m_stripRowsNumber, std::max( 1u,
+        ( 8388608u / std::max( params.m_nCols, 1u ) ) ) );
 
-      const unsigned int nCols = (unsigned int)( srcRaster.getNumberOfColumns() );
-      const unsigned int colsBound = (unsigned int)( nCols ?
-        ( nCols - 1 ) : 0 );
+      const unsigned int stripsNumber = ( params.m_outRowsNumber +
+        params.m_stripRowsNumber - 1 ) / params.m_stripRowsNumber;
+      threadsNumber = std::min( threadsNumber, std::max( stripsNumber, 1u ) );
 
       std::auto_ptr< te::common::TaskProgress > task;
       if( useProgress )
       {
-        task.reset( new te::common::TaskProgress(TE_TR("Mean Filter"),
-          te::common::TaskProgress::UNDEFINED,
-         srcRaster.getNumberOfRows() - 2) );
+        task.reset( new te::common::TaskProgress( taskName,
+          te::common::TaskProgress::UNDEFINED, params.m_outRowsNumber ) );
       }
 
-      const te::rst::Band& srcBand = *srcRaster.getBand( srcBandIdx );
-      te::rst::Band& dstBand = *dstRaster.getBand( dstBandIdx );
+      if( threadsNumber == 1 )
+      {
+        params.m_progressPtr = task.get();
+        params.m_runningThreadsNumber = 1;
 
-      const double srcNoDataValue = srcBand.getProperty()->m_noDataValue;
-      const double dstNoDataValue = dstBand.getProperty()->m_noDataValue;
+        FilterThreadEntry( &params );
+      }
+      else
+      {
+        params.m_runningThreadsNumber = threadsNumber;
 
-      double dstBandAllowedMin = 0;
-      double dstBandAllowedMax = 0;
-      te::rp::GetDataTypeRange( dstBand.getProperty()->getType(), dstBandAllowedMin,
-        dstBandAllowedMax );
+        boost::thread_group threads;
 
-      unsigned int col = 0;
-      double value1diag = 0;
-      double value2diag = 0;
-      double value1adiag = 0;
-      double value2adiag = 0;
-      double diagDiff = 0;
-      double adiagDiff = 0;
-      double outValue = 0;
+        for( unsigned int threadIdx = 0 ; threadIdx < threadsNumber ;
+          ++threadIdx )
+        {
+          threads.add_thread( new boost::thread( FilterThreadEntry,
+             &params ) );
+        }
+
+        // the progress interface is only used by this thread
 
-      for( unsigned int row = 0; row < nRows ; ++row )
-      {
-        for( col = 0 ; col < nCols ; ++col )
         {
-          if( ( row < rowsBound ) && ( col < colsBound ) )
+          boost::unique_lock< boost::mutex > lock( mutex );
+
+          while( params.m_runningThreadsNumber )
           {
-            srcBand.getValue( col, row, value1diag );
-            if( value1diag == srcNoDataValue )
-            {
-              dstBand.setValue( col, row, dstNoDataValue );
-              continue;
-            }
+            condVar.wait( lock );
 
-            srcBand.getValue( col + 1, row + 1, value2diag );
-            if( value2diag == srcNoDataValue )
+            if( useProgress )
             {
-              dstBand.setValue( col, row, dstNoDataValue );
-              continue;
-            }
+              task->setCurrentStep( params.m_processedRowsNumber );
 
-            srcBand.getValue( col, row + 1, value1adiag );
-            if( value1adiag == srcNoDataValue )
-            {
-              dstBand.setValue( col, row, dstNoDataValue );
-              continue;
+              if( !task->isActive() )
+              {
+                params.m_abort = true;
+              }
             }
+          }
+        }
 
-            srcBand.getValue( col + 1, row, value2adiag );
-            if( value2adiag == srcNoDataValue )
-            {
-              dstBand.setValue( col, row, dstNoDataValue );
-              continue;
-            }
+        threads.join_all();
+      }
+
+      return params.m_returnStatus;
+    }
+
+    void Filter::FilterThreadEntry( FilterThreadParams* paramsPtr )
+    {
+      const unsigned int nCols = paramsPtr->m_nCols;
+
+      FilterStrip strip;
+
+      while( true )
+      {
+        // Taking the next strip and reading its rows
 
-            diagDiff = value1diag - value2diag;
-            adiagDiff = value1adiag - value2adiag;
+        {
+          boost::lock_guard< boost::mutex > lock( *( paramsPtr->m_mutexPtr ) );
+
+          if( paramsPtr->m_abort ||
+            ( paramsPtr->m_nextStripRow >= paramsPtr->m_outRowsNumber ) )
+          {
+            break;
+          }
 
-            outValue = std::sqrt( ( diagDiff * diagDiff ) +
-              ( adiagDiff * adiagDiff ) );
-            outValue = std::max( outValue, dstBandAllowedMin );
-            outValue = std::min( outValue, dstBandAllowedMax );
+          strip.m_outFirstRow = paramsPtr->m_nextStripRow;
+          strip.m_outRowsNumber = std::min( paramsPtr->m_stripRowsNumber,
+            paramsPtr->m_outRowsNumber - strip.m_outFirstRow );
+          paramsPtr->m_nextStripRow += strip.m_outRowsNumber;
 
-            dstBand.setValue( col, row, outValue );
+          strip.m_inFirstRow = ( strip.m_outFirstRow > paramsPtr->m_rowsAbove ) ?
+            ( strip.m_outFirstRow - paramsPtr->m_rowsAbove ) : 0;
+          strip.m_inRowsNumber = std::min( paramsPtr->m_nRows, strip.m_outFirstRow +
+            strip.m_outRowsNumber + paramsPtr->m_rowsBelow ) - strip.m_inFirstRow;
+
+          try
+          {
+            strip.m_inBuffer.resize( strip.m_inRowsNumber * nCols );
+            strip.m_outBuffer.resize( strip.m_outRowsNumber *
+              paramsPtr->m_outColsNumber );
+
+            paramsPtr->m_srcBandPtr->getValues( 0, strip.m_inFirstRow, nCols,
+              strip.m_inRowsNumber, &strip.m_inBuffer[ 0 ] );
           }
-          else
+          catch( ... )
           {
-            dstBand.setValue( col, row, dstNoDataValue );
+            paramsPtr->m_returnStatus = false;
+            paramsPtr->m_abort = true;
+            break;
           }
         }
 
-        if( useProgress )
+        // Filtering
+
+        try
         {
-          task->pulse();
-          if( !task->isActive() ) return false;
+          paramsPtr->m_stripFilterPtr( *paramsPtr, strip );
         }
-      }
+        catch( ... )
+        {
+          boost::lock_guard< boost::mutex > lock( *( paramsPtr->m_mutexPtr ) );
 
-      return true;
-    }
+          paramsPtr->m_returnStatus = false;
+          paramsPtr->m_abort = true;
+          break;
+        }
 
-    bool Filter::SobelFilter( const te::rst::Raster& srcRaster,
-      const unsigned int srcBandIdx, te::rst::Raster& dstRaster,
-      const unsigned int dstBandIdx, const bool useProgress )
-    {
-      TERP_DEBUG_TRUE_OR_THROW( srcRaster.getNumberOfColumns() ==
-        dstRaster.getNumberOfColumns(), "Internal error" );
-      TERP_DEBUG_TRUE_OR_THROW( srcRaster.getNumberOfRows() ==
-        dstRaster.getNumberOfRows(), "Internal error" );
-      TERP_DEBUG_TRUE_OR_THROW( srcBandIdx < srcRaster.getNumberOfBands(),
-        "Internal error" );
-      TERP_DEBUG_TRUE_OR_THROW( dstBandIdx < dstRaster.getNumberOfBands(),
-        "Internal error" );
+        // Writing the output rows
 
-      const unsigned int nRows = (unsigned int)( srcRaster.getNumberOfRows() );
-      const unsigned int rowsBound = (unsigned int)( nRows - 2 );
+        {
+          boost::lock_guard< boost::mutex > lock( *( paramsPtr->m_mutexPtr ) );
 
-      const unsigned int nCols = (unsigned int)( srcRaster.getNumberOfColumns() );
-      const unsigned int colsBound = (unsigned int)( nCols - 2 );
+          try
+          {
+            paramsPtr->m_dstBandPtr->setValues( 0, strip.m_outFirstRow,
+              paramsPtr->m_outColsNumber, strip.m_outRowsNumber,
+              &strip.m_outBuffer[ 0 ] );
+          }
+          catch( ... )
+          {
+            paramsPtr->m_returnStatus = false;
+            paramsPtr->m_abort = true;
+            break;
+          }
 
-      ResetConvBuffer(3, nCols);
+          paramsPtr->m_processedRowsNumber += strip.m_outRowsNumber;
+
+          if( paramsPtr->m_progressPtr )
+          {
+            paramsPtr->m_progressPtr->setCurrentStep(
+              paramsPtr->m_processedRowsNumber );
+
+            if( !paramsPtr->m_progressPtr->isActive() )
+            {
+              paramsPtr->m_abort = true;
+            }
+          }
+        }
+
+        paramsPtr->m_condVarPtr->notify_one();
+      }
 
-      std::auto_ptr< te::common::TaskProgress > task;
-      if( useProgress )
       {
-        task.reset( new te::common::TaskProgress(TE_TR("Sobel Filter"),
-          te::common::TaskProgress::UNDEFINED,
-         srcRaster.getNumberOfRows() - 2) );
+        boost::lock_guard< boost::mutex > lock( *( paramsPtr->m_mutexPtr ) );
+
+        --( paramsPtr->m_runningThreadsNumber );
+
+        if( paramsPtr->m_abort )
+        {
+          paramsPtr->m_returnStatus = false;
+        }
       }
 
-      const te::rst::Band& srcBand = *srcRaster.getBand( srcBandIdx );
-      te::rst::Band& dstBand = *dstRaster.getBand( dstBandIdx );
+      paramsPtr->m_condVarPtr->notify_one();
+    }
 
-      double dstBandAllowedMin = 0;
-      double dstBandAllowedMax = 0;
-      te::rp::GetDataTypeRange( dstBand.getProperty()->getType(), dstBandAllowedMin,
-        dstBandAllowedMax );
+    void Filter::RobertsStrip( const FilterThreadParams& params, FilterStrip& strip )
+    {
+      const unsigned int nCols = params.m_nCols;
+      const unsigned int rowsBound = params.m_nRows - 1;
+      const unsigned int colsBound = nCols - 1;
+      const double srcNoDataValue = params.m_srcNoDataValue;
+      const double dstNoDataValue = params.m_dstNoDataValue;
 
-      unsigned int col = 0;
-      double gY = 0;
-      double gX = 0;
+      double value1diag = 0;
+      double value2diag = 0;
+      double value1adiag = 0;
+      double value2adiag = 0;
+      double diagDiff = 0;
+      double adiagDiff = 0;
       double outValue = 0;
 
-      /* Fills the convolution buffer with the first "mask_lines" from the raster */
+      /* The last column and row have no neighbors: they are kept as no-data values */
+
+      for( unsigned int stripRow = 0 ; stripRow < strip.m_outRowsNumber ; ++stripRow )
+      {
+        const unsigned int row = strip.m_outFirstRow + stripRow;
+        double* outRow = &strip.m_outBuffer[ stripRow * nCols ];
+
+        std::fill( outRow, outRow + nCols, dstNoDataValue );
+
+        if( row >= rowsBound ) continue;
+
+        const double* line0 = &strip.m_inBuffer[ ( row - strip.m_inFirstRow ) * nCols ];
+        const double* line1 = line0 + nCols;
+
+        for( unsigned int col = 0 ; col < colsBound ; ++col )
+        {
+          value1diag = line0[ col ];
+          value2diag = line1[ col + 1 ];
+          value1adiag = line1[ col ];
+          value2adiag = line0[ col + 1 ];
+
+          if( ( value1diag == srcNoDataValue ) || ( value2diag == srcNoDataValue ) ||
+            ( value1adiag == srcNoDataValue ) || ( value2adiag == srcNoDataValue ) )
+          {
+            continue;
+          }
 
-      for (unsigned int line = 0; line < 2; ++line) {
-        UpdateConvBuffer(srcBand, line);
+          diagDiff = value1diag - value2diag;
+          adiagDiff = value1adiag - value2adiag;
+
+          outValue = std::sqrt( ( diagDiff * diagDiff ) +
+            ( adiagDiff * adiagDiff ) );
+          outValue = std::max( outValue, params.m_dstAllowedMin );
+          outValue = std::min( outValue, params.m_dstAllowedMax );
+
+          outRow[ col ] = outValue;
+        }
       }
+    }
 
-      /* raster convolution */
+    void Filter::SobelStrip( const FilterThreadParams& params, FilterStrip& strip )
+    {
+      const unsigned int nCols = params.m_nCols;
+      const unsigned int colsBound = params.m_outColsNumber;
+
+      double gY = 0;
+      double gX = 0;
+      double outValue = 0;
 
-      for( unsigned int row = 0; row < rowsBound ; ++row )
+      for( unsigned int stripRow = 0 ; stripRow < strip.m_outRowsNumber ; ++stripRow )
       {
-        /* Getting one more line from the source raster and adding to buffer */
-        UpdateConvBuffer(srcBand, row + 2);
+        const unsigned int row = strip.m_outFirstRow + stripRow;
+        double* outRow = &strip.m_outBuffer[ stripRow * colsBound ];
+
+        const double* line0 = &strip.m_inBuffer[ ( row - strip.m_inFirstRow ) * nCols ];
+        const double* line1 = line0 + nCols;
+        const double* line2 = line1 + nCols;
 
-        for( col = 0 ; col < colsBound ; ++col )
+        for( unsigned int col = 0 ; col < colsBound ; ++col )
         {
-          gX = m_convBuffer[2][col] +
-            (2 * m_convBuffer[2][col + 1]) +
-            m_convBuffer[2][col + 2] -
-            m_convBuffer[0][col] -
-            (2 * m_convBuffer[0][col + 1]) -
-            m_convBuffer[0][col + 2];
-
-          gY = m_convBuffer[0][col + 2] +
-            (2 * m_convBuffer[1][col + 2]) +
-            m_convBuffer[2][col + 2] -
-            m_convBuffer[0][col] -
-            (2 * m_convBuffer[1][col]) -
-            m_convBuffer[2][col];
+          gX = line2[col] +
+            (2 * line2[col + 1]) +
+            line2[col + 2] -
+            line0[col] -
+            (2 * line0[col + 1]) -
+            line0[col + 2];
+
+          gY = line0[col + 2] +
+            (2 * line1[col + 2]) +
+            line2[col + 2] -
+            line0[col] -
+            (2 * line1[col]) -
+            line2[col];
 
           outValue = std::sqrt( ( gY * gY ) +
             ( gX * gX ) );
-          outValue = std::max( outValue, dstBandAllowedMin );
-          outValue = std::min( outValue, dstBandAllowedMax );
-
-          dstBand.setValue( col, row, outValue );
-        }
+          outValue = std::max( outValue, params.m_dstAllowedMin );
+          outValue = std::min( outValue, params.m_dstAllowedMax );
 
-        if( useProgress )
-        {
-          task->pulse();
-          if( !task->isActive() ) return false;
+          outRow[ col ] = outValue;
         }
       }
-
-      return true;
     }
 
-    bool Filter::MeanFilter( const te::rst::Raster& srcRaster,
-      const unsigned int srcBandIdx, te::rst::Raster& dstRaster,
-      const unsigned int dstBandIdx, const bool useProgress )
+    void Filter::MeanStrip( const FilterThreadParams& params, FilterStrip& strip )
     {
-      TERP_DEBUG_TRUE_OR_THROW( srcRaster.getNumberOfColumns() ==
-        dstRaster.getNumberOfColumns(), "Internal error" );
-      TERP_DEBUG_TRUE_OR_THROW( srcRaster.getNumberOfRows() ==
-        dstRaster.getNumberOfRows(), "Internal error" );
-      TERP_DEBUG_TRUE_OR_THROW( srcBandIdx < srcRaster.getNumberOfBands(),
-        "Internal error" );
-      TERP_DEBUG_TRUE_OR_THROW( dstBandIdx < dstRaster.getNumberOfBands(),
-        "Internal error" );
-
-      const unsigned int nRows = srcRaster.getNumberOfRows();
-      const unsigned int nCols = srcRaster.getNumberOfColumns();
-      const unsigned int windowHeight = m_inputParameters.m_windowH;
-      const unsigned int windowWidth = m_inputParameters.m_windowW;
+      const unsigned int nRows = params.m_nRows;
+      const unsigned int nCols = params.m_nCols;
+      const unsigned int windowHeight = params.m_windowH;
+      const unsigned int windowWidth = params.m_windowW;
       const unsigned int windowRowRadius = ( windowHeight / 2 );
       const unsigned int windowColRadius = ( windowWidth / 2 );
-      const unsigned int filterStartRowOffsetBound = nRows - windowHeight + 1;
-      const unsigned int filterStartColOffsetBound = nCols - windowWidth + 1;
       const unsigned int validDataRowsBound = nRows - windowRowRadius;
       const unsigned int validDataColsBound = nCols - windowColRadius;
-      unsigned int filterStartRow = 0;
-      unsigned int filterStartCol = 0;
-      unsigned int rowOffset = 0;
-      unsigned int colOffset = 0;
-      std::map< double , unsigned int > frequencies;
-      const te::rst::Band& srcBand = *( srcRaster.getBand( srcBandIdx ) );
-      te::rst::Band& dstBand = *( dstRaster.getBand( dstBandIdx ) );
-      const double srcNoDataValue = srcBand.getProperty()->m_noDataValue;
-      const double dstNoDataValue = dstBand.getProperty()->m_noDataValue;
+      const double srcNoDataValue = params.m_srcNoDataValue;
+      const double dstNoDataValue = params.m_dstNoDataValue;
+
+      /* The window columns sums and valid pixels counts are updated
+         by adding the entering row and removing the leaving one */
+
+      std::vector< double >& colSums = strip.m_auxBuffer1;
+      std::vector< double >& colCounts = strip.m_auxBuffer2;
+      colSums.assign( nCols, 0.0 );
+      colCounts.assign( nCols, 0.0 );
+
+      bool sumsInitialized = false;
       double value = 0;
-      unsigned int row = 0;
+      double windowSum = 0;
+      double windowCount = 0;
       unsigned int col = 0;
-      std::map< double , unsigned int >::iterator frequenciesIt;
-      std::map< double , unsigned int >::iterator frequenciesItEnd;
-      double meanValue = 0;
-      unsigned int meanValidPixelsNmb = 0;
-      
-      std::auto_ptr< te::common::TaskProgress > task;
-      if( useProgress )
-      {
-        task.reset( new te::common::TaskProgress(TE_TR("Mode Filter"),
-          te::common::TaskProgress::UNDEFINED, filterStartRowOffsetBound + nRows ) );
-      }      
-      
-      for( row = 0 ; row < nRows ; ++row )
+
+      for( unsigned int stripRow = 0 ; stripRow < strip.m_outRowsNumber ; ++stripRow )
       {
-        for( col = 0 ; col < nCols ; ++col )
+        const unsigned int row = strip.m_outFirstRow + stripRow;
+        double* outRow = &strip.m_outBuffer[ stripRow * nCols ];
+
+        /* The border rows and columns are kept as no-data values */
+
+        std::fill( outRow, outRow + nCols, dstNoDataValue );
+
+        if( ( row < windowRowRadius ) || ( row >= validDataRowsBound ) ) continue;
+
+        if( sumsInitialized )
         {
-          if( ( row < windowRowRadius ) || ( row >= validDataRowsBound ) ||
-            ( col < windowColRadius ) || ( col >= validDataColsBound ) )
+          const double* leavingLine = &strip.m_inBuffer[ ( row - windowRowRadius - 1 -
+            strip.m_inFirstRow ) * nCols ];
+          const double* enteringLine = &strip.m_inBuffer[ ( row + windowRowRadius -
+            strip.m_inFirstRow ) * nCols ];
+
+          for( col = 0 ; col < nCols ; ++col )
           {
-            dstBand.setValue( col, row, dstNoDataValue );
+            value = leavingLine[ col ];
+            if( value != srcNoDataValue )
+            {
+              colSums[ col ] -= value;
+              colCounts[ col ] -= 1.0;
+            }
+
+            value = enteringLine[ col ];
+            if( value != srcNoDataValue )
+            {
+              colSums[ col ] += value;
+              colCounts[ col ] += 1.0;
+            }
           }
         }
-        
-        if( useProgress )
-        {
-          task->pulse();
-          if( !task->isActive() ) return false;
-        }         
-      }
-      
-      for( filterStartRow = 0 ; filterStartRow < filterStartRowOffsetBound ; ++filterStartRow )
-      {
-        for( filterStartCol = 0 ; filterStartCol < filterStartColOffsetBound ; ++filterStartCol )
+        else
         {
-          meanValue = 0;
-          meanValidPixelsNmb = 0;
-          
-          for( rowOffset = 0 ; rowOffset < windowHeight ; ++rowOffset )
+          for( unsigned int rowOffset = 0 ; rowOffset < windowHeight ; ++rowOffset )
           {
-            row = filterStartRow + rowOffset;
-            
-            for( colOffset = 0 ; colOffset < windowWidth ; ++colOffset )
+            const double* line = &strip.m_inBuffer[ ( row - windowRowRadius +
+              rowOffset - strip.m_inFirstRow ) * nCols ];
+
+            for( col = 0 ; col < nCols ; ++col )
             {
-              col = filterStartCol + colOffset;
-              srcBand.getValue( col, row, value );
+              value = line[ col ];
               if( value != srcNoDataValue )
               {
-                meanValue += value;
-                ++meanValidPixelsNmb;
+                colSums[ col ] += value;
+                colCounts[ col ] += 1.0;
               }
             }
           }
-          
-          if( meanValidPixelsNmb )
+
+          sumsInitialized = true;
+        }
+
+        windowSum = 0;
+        windowCount = 0;
+
+        for( col = 0 ; col < windowWidth ; ++col )
+        {
+          windowSum += colSums[ col ];
+          windowCount += colCounts[ col ];
+        }
+
+        for( col = windowColRadius ; col < validDataColsBound ; ++col )
+        {
+          if( col > windowColRadius )
           {
-            meanValue /= (double)meanValidPixelsNmb;
-            dstBand.setValue( filterStartCol + windowColRadius, 
-              filterStartRow + windowRowRadius, meanValue );            
+            windowSum += colSums[ col + windowColRadius ] -
+              colSums[ col - windowColRadius - 1 ];
+            windowCount += colCounts[ col + windowColRadius ] -
+              colCounts[ col - windowColRadius - 1 ];
           }
-          else
+
+          if( windowCount > 0.0 )
           {
-            dstBand.setValue( filterStartCol + windowColRadius, 
-              filterStartRow + windowRowRadius, dstNoDataValue );
+            outRow[ col ] = windowSum / windowCount;
           }
         }
-        
-        if( useProgress )
-        {
-          task->pulse();
-          if( !task->isActive() ) return false;
-        }        
       }
-
-      return true;
     }
 
-    bool Filter::ModeFilter( const te::rst::Raster& srcRaster,
-      const unsigned int srcBandIdx, te::rst::Raster& dstRaster,
-      const unsigned int dstBandIdx, const bool useProgress )
+    void Filter::ModeStrip( const FilterThreadParams& params, FilterStrip& strip )
     {
-      TERP_DEBUG_TRUE_OR_THROW( srcRaster.getNumberOfColumns() ==
-        dstRaster.getNumberOfColumns(), "Internal error" );
-      TERP_DEBUG_TRUE_OR_THROW( srcRaster.getNumberOfRows() ==
-        dstRaster.getNumberOfRows(), "Internal error" );
-      TERP_DEBUG_TRUE_OR_THROW( srcBandIdx < srcRaster.getNumberOfBands(),
-        "Internal error" );
-      TERP_DEBUG_TRUE_OR_THROW( dstBandIdx < dstRaster.getNumberOfBands(),
-        "Internal error" );
-
-      const unsigned int nRows = srcRaster.getNumberOfRows();
-      const unsigned int nCols = srcRaster.getNumberOfColumns();
-      const unsigned int windowHeight = m_inputParameters.m_windowH;
-      const unsigned int windowWidth = m_inputParameters.m_windowW;
+      const unsigned int nRows = params.m_nRows;
+      const unsigned int nCols = params.m_nCols;
+      const unsigned int windowHeight = params.m_windowH;
+      const unsigned int windowWidth = params.m_windowW;
       const unsigned int windowRowRadius = ( windowHeight / 2 );
       const unsigned int windowColRadius = ( windowWidth / 2 );
-      const unsigned int filterStartRowOffsetBound = nRows - windowHeight + 1;
-      const unsigned int filterStartColOffsetBound = nCols - windowWidth + 1;
       const unsigned int validDataRowsBound = nRows - windowRowRadius;
       const unsigned int validDataColsBound = nCols - windowColRadius;
-      unsigned int filterStartRow = 0;
-      unsigned int filterStartCol = 0;
+      const double srcNoDataValue = params.m_srcNoDataValue;
+      const double dstNoDataValue = params.m_dstNoDataValue;
+      const double histogramMin = params.m_histogramMin;
+
+      std::vector< unsigned int >& histogram = strip.m_histogram;
+      if( params.m_useHistogram )
+      {
+        histogram.assign( params.m_histogramSize, 0 );
+      }
+
+      std::vector< double >& windowValues = strip.m_auxBuffer1;
+      windowValues.resize( windowHeight * windowWidth );
+
+      std::vector< const double* > lines( windowHeight );
       unsigned int rowOffset = 0;
-      unsigned int colOffset = 0;
-      std::map< double , unsigned int > frequencies;
-      const te::rst::Band& srcBand = *( srcRaster.getBand( srcBandIdx ) );
-      te::rst::Band& dstBand = *( dstRaster.getBand( dstBandIdx ) );
-      const double srcNoDataValue = srcBand.getProperty()->m_noDataValue;
-      const double dstNoDataValue = dstBand.getProperty()->m_noDataValue;
-      double value = 0;
-      unsigned int row = 0;
       unsigned int col = 0;
-      std::map< double , unsigned int >::iterator frequenciesIt;
-      std::map< double , unsigned int >::iterator frequenciesItEnd;
+      unsigned int bin = 0;
+      unsigned int validValuesNumber = 0;
       unsigned int higherFrequency = 0;
-      double higherFrequencyValue = 0;
-      
-      std::auto_ptr< te::common::TaskProgress > task;
-      if( useProgress )
-      {
-        task.reset( new te::common::TaskProgress(TE_TR("Mode Filter"),
-          te::common::TaskProgress::UNDEFINED, filterStartRowOffsetBound + nRows ) );
-      }      
-      
-      for( row = 0 ; row < nRows ; ++row )
+      unsigned int higherFrequencyBin = 0;
+      bool higherFrequencyOutdated = false;
+      double value = 0;
+
+      for( unsigned int stripRow = 0 ; stripRow < strip.m_outRowsNumber ; ++stripRow )
       {
-        for( col = 0 ; col < nCols ; ++col )
+        const unsigned int row = strip.m_outFirstRow + stripRow;
+        double* outRow = &strip.m_outBuffer[ stripRow * nCols ];
+
+        /* The border rows and columns are kept as no-data values */
+
+        std::fill( outRow, outRow + nCols, dstNoDataValue );
+
+        if( ( row < windowRowRadius ) || ( row >= validDataRowsBound ) ) continue;
+
+        for( rowOffset = 0 ; rowOffset < windowHeight ; ++rowOffset )
         {
-          if( ( row < windowRowRadius ) || ( row >= validDataRowsBound ) ||
-            ( col < windowColRadius ) || ( col >= validDataColsBound ) )
-          {
-            dstBand.setValue( col, row, dstNoDataValue );
-          }
+          lines[ rowOffset ] = &strip.m_inBuffer[ ( row - windowRowRadius +
+            rowOffset - strip.m_inFirstRow ) * nCols ];
         }
-        
-        if( useProgress )
-        {
-          task->pulse();
-          if( !task->isActive() ) return false;
-        }         
-      }
-      
-      for( filterStartRow = 0 ; filterStartRow < filterStartRowOffsetBound ; ++filterStartRow )
-      {
-        for( filterStartCol = 0 ; filterStartCol < filterStartColOffsetBound ; ++filterStartCol )
+
+        if( params.m_useHistogram )
         {
-          frequencies.clear();
-          
-          for( rowOffset = 0 ; rowOffset < windowHeight ; ++rowOffset )
+          /* Sliding histogram: the leaving column is removed and the entering one added.
+             When the mode looses a value it is searched again among the window values.
+             The lower value is the mode of multimodal windows. */
+
+          validValuesNumber = 0;
+          higherFrequency = 0;
+          higherFrequencyBin = 0;
+          higherFrequencyOutdated = false;
+
+          for( col = 0 ; col < nCols ; ++col )
           {
-            row = filterStartRow + rowOffset;
-            
-            for( colOffset = 0 ; colOffset < windowWidth ; ++colOffset )
+            if( col >= windowWidth )
+            {
+              for( rowOffset = 0 ; rowOffset < windowHeight ; ++rowOffset )
+              {
+                value = lines[ rowOffset ][ col - windowWidth ];
+                if( value != srcNoDataValue )
+                {
+                  bin = (unsigned int)( value - histogramMin );
+                  --histogram[ bin ];
+                  --validValuesNumber;
+                  if( bin == higherFrequencyBin ) higherFrequencyOutdated = true;
+                }
+              }
+            }
+
+            for( rowOffset = 0 ; rowOffset < windowHeight ; ++rowOffset )
             {
-              col = filterStartCol + colOffset;
-              srcBand.getValue( col, row, value );
+              value = lines[ rowOffset ][ col ];
               if( value != srcNoDataValue )
               {
-                ++frequencies[ value ];
+                bin = (unsigned int)( value - histogramMin );
+                ++histogram[ bin ];
+                ++validValuesNumber;
+
+                if( ( histogram[ bin ] > higherFrequency ) ||
+                  ( ( histogram[ bin ] == higherFrequency ) && ( bin < higherFrequencyBin ) ) )
+                {
+                  higherFrequency = histogram[ bin ];
+                  higherFrequencyBin = bin;
+                  higherFrequencyOutdated = false;
+                }
               }
             }
-          }
-          
-          frequenciesIt = frequencies.begin();
-          frequenciesItEnd = frequencies.end();
-          higherFrequency = 0;
-          while( frequenciesIt != frequenciesItEnd )
-          {
-            if( frequenciesIt->second > higherFrequency )
+
+            if( col + 1 < windowWidth ) continue;
+
+            if( validValuesNumber == 0 )
+            {
+              higherFrequency = 0;
+              higherFrequencyOutdated = false;
+              continue;
+            }
+
+            if( higherFrequencyOutdated )
             {
-              higherFrequency = frequenciesIt->second;
-              higherFrequencyValue = frequenciesIt->first;              
+              higherFrequency = 0;
+
+              for( rowOffset = 0 ; rowOffset < windowHeight ; ++rowOffset )
+              {
+                const double* line = lines[ rowOffset ] + col + 1 - windowWidth;
+
+                for( unsigned int colOffset = 0 ; colOffset < windowWidth ; ++colOffset )
+                {
+                  if( line[ colOffset ] != srcNoDataValue )
+                  {
+                    bin = (unsigned int)( line[ colOffset ] - histogramMin );
+
+                    if( ( histogram[ bin ] > higherFrequency ) ||
+                      ( ( histogram[ bin ] == higherFrequency ) && ( bin < higherFrequencyBin ) ) )
+                    {
+                      higherFrequency = histogram[ bin ];
+                      higherFrequencyBin = bin;
+                    }
+                  }
+                }
+              }
+
+              higherFrequencyOutdated = false;
             }
-            
-            ++frequenciesIt;
+
+            outRow[ col + 1 - windowWidth + windowColRadius ] =
+              ( (double)higherFrequencyBin ) + histogramMin;
           }
-          
-          if( higherFrequency == 0.0 )
+
+          /* Removing the last window values */
+
+          for( col = nCols - windowWidth ; col < nCols ; ++col )
           {
-            dstBand.setValue( filterStartCol + windowColRadius, 
-              filterStartRow + windowRowRadius, dstNoDataValue );
+            for( rowOffset = 0 ; rowOffset < windowHeight ; ++rowOffset )
+            {
+              value = lines[ rowOffset ][ col ];
+              if( value != srcNoDataValue )
+              {
+                --histogram[ (unsigned int)( value - histogramMin ) ];
+              }
+            }
           }
-          else
+        }
+        else
+        {
+          /* The sorted window values are scanned for the longest run */
+
+          for( col = windowColRadius ; col < validDataColsBound ; ++col )
           {
-            dstBand.setValue( filterStartCol + windowColRadius, 
-              filterStartRow + windowRowRadius, higherFrequencyValue );
+            validValuesNumber = 0;
+
+            for( rowOffset = 0 ; rowOffset < windowHeight ; ++rowOffset )
+            {
+              const double* line = lines[ rowOffset ] + col - windowColRadius;
+
+              for( unsigned int colOffset = 0 ; colOffset < windowWidth ; ++colOffset )
+              {
+                if( line[ colOffset ] != srcNoDataValue )
+                {
+                  windowValues[ validValuesNumber++ ] = line[ colOffset ];
+                }
+              }
+            }
+
+            if( validValuesNumber == 0 ) continue;
+
+            std::sort( windowValues.begin(), windowValues.begin() + validValuesNumber );
+
+            unsigned int runStart = 0;
+            higherFrequency = 0;
+
+            for( unsigned int valueIdx = 1 ; valueIdx <= validValuesNumber ; ++valueIdx )
+            {
+              if( ( valueIdx == validValuesNumber ) ||
+                ( windowValues[ valueIdx ] != windowValues[ runStart ] ) )
+              {
+                if( valueIdx - runStart > higherFrequency )
+                {
+                  higherFrequency = valueIdx - runStart;
+                  value = windowValues[ runStart ];
+                }
+
+                runStart = valueIdx;
+              }
+            }
+
+            outRow[ col ] = value;
           }
         }
-        
-        if( useProgress )
-        {
-          task->pulse();
-          if( !task->isActive() ) return false;
-        }        
       }
-
-      return true;
     }
 
-    bool Filter::MedianFilter( const te::rst::Raster& srcRaster,
-      const unsigned int srcBandIdx, te::rst::Raster& dstRaster,
-      const unsigned int dstBandIdx, const bool useProgress )
+    void Filter::MedianStrip( const FilterThreadParams& params, FilterStrip& strip )
     {
-      TERP_DEBUG_TRUE_OR_THROW( srcRaster.getNumberOfColumns() ==
-        dstRaster.getNumberOfColumns(), "Internal error" );
-      TERP_DEBUG_TRUE_OR_THROW( srcRaster.getNumberOfRows() ==
-        dstRaster.getNumberOfRows(), "Internal error" );
-      TERP_DEBUG_TRUE_OR_THROW( srcBandIdx < srcRaster.getNumberOfBands(),
-        "Internal error" );
-      TERP_DEBUG_TRUE_OR_THROW( dstBandIdx < dstRaster.getNumberOfBands(),
-        "Internal error" );
-
-      const unsigned int H = m_inputParameters.m_windowH;
-      const unsigned int W = m_inputParameters.m_windowW;
+      const unsigned int nRows = params.m_nRows;
+      const unsigned int nCols = params.m_nCols;
+      const unsigned int windowHeight = params.m_windowH;
+      const unsigned int windowWidth = params.m_windowW;
+      const unsigned int windowRowRadius = ( windowHeight / 2 );
+      const unsigned int windowColRadius = ( windowWidth / 2 );
+      const unsigned int validDataRowsBound = nRows - windowRowRadius;
+      const unsigned int validDataColsBound = nCols - windowColRadius;
+      const unsigned int medianRank = ( windowHeight * windowWidth ) / 2;
+      const double histogramMin = params.m_histogramMin;
 
-      std::auto_ptr< te::common::TaskProgress > task;
-      if( useProgress )
+      std::vector< unsigned int >& histogram = strip.m_histogram;
+      if( params.m_useHistogram )
       {
-        task.reset( new te::common::TaskProgress(TE_TR("Median Filter"),
-          te::common::TaskProgress::UNDEFINED, 100 ) );
+        histogram.assign( params.m_histogramSize, 0 );
       }
 
-      unsigned int R = 0;
-      unsigned int C = 0;
-      const unsigned int MR = srcRaster.getNumberOfRows();
-      const unsigned int MC = srcRaster.getNumberOfColumns();
-
-      double dstBandAllowedMin = 0;
-      double dstBandAllowedMax = 0;
-      te::rp::GetDataTypeRange( dstRaster.getBand( dstBandIdx )->getProperty()->getType(), dstBandAllowedMin,
-        dstBandAllowedMax );
-
-      std::vector<double> pixels_in_window;
-      double pixel_median = 0.0;
+      std::vector< double >& windowValues = strip.m_auxBuffer1;
+      windowValues.resize( windowHeight * windowWidth );
 
-      te::rst::Band const * const band = srcRaster.getBand(srcBandIdx);
-      te::rst::BandIteratorWindow<double> it = te::rst::BandIteratorWindow<double>::begin(band, W, H);
-      te::rst::BandIteratorWindow<double> itend = te::rst::BandIteratorWindow<double>::end(band, W, H);
+      std::vector< const double* > lines( windowHeight );
+      unsigned int rowOffset = 0;
+      unsigned int col = 0;
+      unsigned int bin = 0;
+      unsigned int medianBin = 0;
+      unsigned int lowerValuesNumber = 0;
+      double value = 0;
 
-      while (it != itend)
+      for( unsigned int stripRow = 0 ; stripRow < strip.m_outRowsNumber ; ++stripRow )
       {
-        R = it.getRow();
-        C = it.getColumn();
+        const unsigned int row = strip.m_outFirstRow + stripRow;
+        double* outRow = &strip.m_outBuffer[ stripRow * nCols ];
+        const double* inRow = &strip.m_inBuffer[ ( row - strip.m_inFirstRow ) * nCols ];
+
+        /* The border pixels keep the source values */
 
-        if ((R >= (unsigned)(H / 2) && R < MR - (H / 2)) &&
-            (C >= (unsigned)(W / 2) && C < MC - (W / 2)))
+        if( ( row < windowRowRadius ) || ( row >= validDataRowsBound ) )
         {
-          pixel_median = 0.0;
-          pixels_in_window.clear();
-          for (int r = -1 * (int) (H / 2); r <= (int) (H / 2); r++)
-            for (int c = -1 * (int) (W / 2); c <= (int) (W / 2); c++)
-              pixels_in_window.push_back(it.getValue(c, r));
-
-          std::sort(pixels_in_window.begin(), pixels_in_window.end(), OrderFunction);
-          pixel_median = pixels_in_window[pixels_in_window.size() / 2];
+          std::copy( inRow, inRow + nCols, outRow );
         }
         else
-          pixel_median = it.getValue();
-
-        pixel_median = std::max( pixel_median, dstBandAllowedMin );
-        pixel_median = std::min( pixel_median, dstBandAllowedMax );
-        dstRaster.setValue(C, R, pixel_median, dstBandIdx);
-
-        if( useProgress )
         {
-          task->setCurrentStep( R / srcRaster.getNumberOfRows() );
-          if( !task->isActive() ) return false;
-        }
+          std::copy( inRow, inRow + windowColRadius, outRow );
+          std::copy( inRow + validDataColsBound, inRow + nCols,
+            outRow + validDataColsBound );
 
-        ++it;
-      }
+          for( rowOffset = 0 ; rowOffset < windowHeight ; ++rowOffset )
+          {
+            lines[ rowOffset ] = &strip.m_inBuffer[ ( row - windowRowRadius +
+              rowOffset - strip.m_inFirstRow ) * nCols ];
+          }
 
-      return true;
-    }
+          if( params.m_useHistogram )
+          {
+            /* Sliding histogram (Huang): the median bin moves from the
+               previous one, lowerValuesNumber counts the values below it */
 
-    bool Filter::DilationFilter( const te::rst::Raster& srcRaster,
-      const unsigned int srcBandIdx, te::rst::Raster& dstRaster,
-      const unsigned int dstBandIdx, const bool useProgress )
-    {
-      TERP_DEBUG_TRUE_OR_THROW( srcRaster.getNumberOfColumns() ==
-        dstRaster.getNumberOfColumns(), "Internal error" );
-      TERP_DEBUG_TRUE_OR_THROW( srcRaster.getNumberOfRows() ==
-        dstRaster.getNumberOfRows(), "Internal error" );
-      TERP_DEBUG_TRUE_OR_THROW( srcBandIdx < srcRaster.getNumberOfBands(),
-        "Internal error" );
-      TERP_DEBUG_TRUE_OR_THROW( dstBandIdx < dstRaster.getNumberOfBands(),
-        "Internal error" );
+            medianBin = 0;
+            lowerValuesNumber = 0;
 
-      const unsigned int H = m_inputParameters.m_windowH;
-      const unsigned int W = m_inputParameters.m_windowW;
+            for( col = 0 ; col < nCols ; ++col )
+            {
+              if( col >= windowWidth )
+              {
+                for( rowOffset = 0 ; rowOffset < windowHeight ; ++rowOffset )
+                {
+                  bin = (unsigned int)( lines[ rowOffset ][ col - windowWidth ] - histogramMin );
+                  --histogram[ bin ];
+                  if( bin < medianBin ) --lowerValuesNumber;
+                }
+              }
 
-      std::auto_ptr< te::common::TaskProgress > task;
-      if( useProgress )
-      {
-        task.reset( new te::common::TaskProgress(TE_TR("Dilation Filter"),
-          te::common::TaskProgress::UNDEFINED, 100 ) );
-      }
+              for( rowOffset = 0 ; rowOffset < windowHeight ; ++rowOffset )
+              {
+                bin = (unsigned int)( lines[ rowOffset ][ col ] - histogramMin );
+                ++histogram[ bin ];
+                if( bin < medianBin ) ++lowerValuesNumber;
+              }
 
-      unsigned int R = 0;
-      unsigned int C = 0;
-      const unsigned int MR = srcRaster.getNumberOfRows();
-      const unsigned int MC = srcRaster.getNumberOfColumns();
+              if( col + 1 < windowWidth ) continue;
 
-      double dstBandAllowedMin = 0;
-      double dstBandAllowedMax = 0;
-      te::rp::GetDataTypeRange( dstRaster.getBand( dstBandIdx )->getProperty()->getType(), dstBandAllowedMin,
-        dstBandAllowedMax );
+              while( lowerValuesNumber > medianRank )
+              {
+                --medianBin;
+                lowerValuesNumber -= histogram[ medianBin ];
+              }
 
-      double pixel_dilation = 0;
-      double pixel = 0;
+              while( lowerValuesNumber + histogram[ medianBin ] <= medianRank )
+              {
+                lowerValuesNumber += histogram[ medianBin ];
+                ++medianBin;
+              }
 
-      te::rst::Band const * const band = srcRaster.getBand(srcBandIdx);
-      te::rst::BandIteratorWindow<double> it = te::rst::BandIteratorWindow<double>::begin(band, W, H);
-      te::rst::BandIteratorWindow<double> itend = te::rst::BandIteratorWindow<double>::end(band, W, H);
+              outRow[ col + 1 - windowWidth + windowColRadius ] =
+                ( (double)medianBin ) + histogramMin;
+            }
 
-      while (it != itend)
-      {
-        R = it.getRow();
-        C = it.getColumn();
+            /* Removing the last window values */
 
-        if ((R >= (unsigned)(H / 2) && R < MR - (H / 2)) &&
-            (C >= (unsigned)(W / 2) && C < MC - (W / 2)))
-        {
-          pixel_dilation = -1.0 * std::numeric_limits<double>::max();
-          for (int r = -1 * (int) (H / 2); r <= (int) (H / 2); r++)
-            for (int c = -1 * (int) (W / 2); c <= (int) (W / 2); c++)
+            for( col = nCols - windowWidth ; col < nCols ; ++col )
             {
-              pixel = it.getValue(c, r);
-              if (pixel > pixel_dilation)
-                pixel_dilation = pixel;
+              for( rowOffset = 0 ; rowOffset < windowHeight ; ++rowOffset )
+              {
+                --histogram[ (unsigned int)( lines[ rowOffset ][ col ] - histogramMin ) ];
+              }
             }
-        }
-        else
-          pixel_dilation = it.getValue();
+          }
+          else
+          {
+            for( col = windowColRadius ; col < validDataColsBound ; ++col )
+            {
+              double* windowValuePtr = &windowValues[ 0 ];
 
-        pixel_dilation = std::max( pixel_dilation, dstBandAllowedMin );
-        pixel_dilation = std::min( pixel_dilation, dstBandAllowedMax );
-        dstRaster.setValue(C, R, pixel_dilation, dstBandIdx);
+              for( rowOffset = 0 ; rowOffset < windowHeight ; ++rowOffset )
+              {
+                const double* line = lines[ rowOffset ] + col - windowColRadius;
 
-        if( useProgress )
-        {
-          task->setCurrentStep( R / srcRaster.getNumberOfRows() );
-          if( !task->isActive() ) return false;
+                windowValuePtr = std::copy( line, line + windowWidth, windowValuePtr );
+              }
+
+              std::nth_element( windowValues.begin(), windowValues.begin() + medianRank,
+                windowValues.end() );
+
+              outRow[ col ] = windowValues[ medianRank ];
+            }
+          }
         }
 
-        ++it;
+        for( col = 0 ; col < nCols ; ++col )
+        {
+          value = std::max( outRow[ col ], params.m_dstAllowedMin );
+          outRow[ col ] = std::min( value, params.m_dstAllowedMax );
+        }
       }
+    }
 
-      return true;
+    /*! \brief Selects the higher (or lower) value. */
+    template< bool SelectHigherValue >
+    inline double SelectValue( const double value1, const double value2 )
+    {
+      return SelectHigherValue ? ( ( value1 > value2 ) ? value1 : value2 ) :
+        ( ( value1 < value2 ) ? value1 : value2 );
     }
 
-    bool Filter::ErosionFilter( const te::rst::Raster& srcRaster,
-      const unsigned int srcBandIdx, te::rst::Raster& dstRaster,
-      const unsigned int dstBandIdx, const bool useProgress )
+    /*!
+      \brief The van Herk/Gil-Werman sliding window maximum (or minimum) with 3 comparisons per element.
+      \param input The input sequence of elements, each element is a vector of elementSize contiguous values.
+      \param elementsNumber The number of elements.
+      \param elementsStride The distance between two consecutive elements.
+      \param elementSize The number of values of each element.
+      \param windowSize The window size (number of elements).
+      \param prefix Auxiliary buffer with the same layout of input.
+      \param suffix Auxiliary buffer with the same layout of input.
+      \param output The ( elementsNumber - windowSize + 1 ) output elements (the output element i is the result for the input elements [i, i + windowSize - 1]), with the same layout of input.
+    */
+    template< bool SelectHigherValue >
+    void VanHerkGilWerman( const double* input, const unsigned int elementsNumber,
+      const unsigned int elementsStride, const unsigned int elementSize,
+      const unsigned int windowSize, double* prefix, double* suffix, double* output )
     {
-      TERP_DEBUG_TRUE_OR_THROW( srcRaster.getNumberOfColumns() ==
-        dstRaster.getNumberOfColumns(), "Internal error" );
-      TERP_DEBUG_TRUE_OR_THROW( srcRaster.getNumberOfRows() ==
-        dstRaster.getNumberOfRows(), "Internal error" );
-      TERP_DEBUG_TRUE_OR_THROW( srcBandIdx < srcRaster.getNumberOfBands(),
-        "Internal error" );
-      TERP_DEBUG_TRUE_OR_THROW( dstBandIdx < dstRaster.getNumberOfBands(),
-        "Internal error" );
+      unsigned int elementIdx = 0;
+      unsigned int valueIdx = 0;
 
-      const unsigned int H = m_inputParameters.m_windowH;
-      const unsigned int W = m_inputParameters.m_windowW;
+      /* The prefixes and suffixes are computed inside blocks of windowSize elements */
 
-      std::auto_ptr< te::common::TaskProgress > task;
-      if( useProgress )
+      for( elementIdx = 0 ; elementIdx < elementsNumber ; ++elementIdx )
       {
-        task.reset( new te::common::TaskProgress(TE_TR("Erosion Filter"),
-          te::common::TaskProgress::UNDEFINED, 100 ) );
-      }
-
-      unsigned int R = 0;
-      unsigned int C = 0;
-      const unsigned int MR = srcRaster.getNumberOfRows();
-      const unsigned int MC = srcRaster.getNumberOfColumns();
+        const double* in = input + elementIdx * elementsStride;
+        double* out = prefix + elementIdx * elementsStride;
 
-      double dstBandAllowedMin = 0;
-      double dstBandAllowedMax = 0;
-      te::rp::GetDataTypeRange( dstRaster.getBand( dstBandIdx )->getProperty()->getType(), dstBandAllowedMin,
-        dstBandAllowedMax );
-
-      double pixel_erosion = 0;
-      double pixel = 0;
+        if( elementIdx % windowSize )
+        {
+          const double* previous = out - elementsStride;
 
-      te::rst::Band const * const band = srcRaster.getBand(srcBandIdx);
-      te::rst::BandIteratorWindow<double> it = te::rst::BandIteratorWindow<double>::begin(band, W, H);
-      te::rst::BandIteratorWindow<double> itend = te::rst::BandIteratorWindow<double>::end(band, W, H);
+          for( valueIdx = 0 ; valueIdx < elementSize ; ++valueIdx )
+          {
+            out[ valueIdx ] = SelectValue< SelectHigherValue >( in[ valueIdx ],
+              previous[ valueIdx ] );
+          }
+        }
+        else
+        {
+          std::copy( in, in + elementSize, out );
+        }
+      }
 
-      while (it != itend)
+      for( elementIdx = elementsNumber ; elementIdx > 0 ; --elementIdx )
       {
-        R = it.getRow();
-        C = it.getColumn();
+        const double* in = input + ( elementIdx - 1 ) * elementsStride;
+        double* out = suffix + ( elementIdx - 1 ) * elementsStride;
 
-        if ((R >= (unsigned)(H / 2) && R < MR - (H / 2)) &&
-            (C >= (unsigned)(W / 2) && C < MC - (W / 2)))
+        if( ( elementIdx % windowSize ) && ( elementIdx < elementsNumber ) )
         {
-          pixel_erosion = std::numeric_limits<double>::max();
-          for (int r = -1 * (int) (H / 2); r <= (int) (H / 2); r++)
-            for (int c = -1 * (int) (W / 2); c <= (int) (W / 2); c++)
-            {
-              pixel = it.getValue(c, r);
-              if (pixel < pixel_erosion)
-                pixel_erosion = pixel;
-            }
+          const double* next = out + elementsStride;
+
+          for( valueIdx = 0 ; valueIdx < elementSize ; ++valueIdx )
+          {
+            out[ valueIdx ] = SelectValue< SelectHigherValue >( in[ valueIdx ],
+              next[ valueIdx ] );
+          }
         }
         else
-          pixel_erosion = it.getValue();
+        {
+          std::copy( in, in + elementSize, out );
+        }
+      }
 
-        pixel_erosion = std::max( pixel_erosion, dstBandAllowedMin );
-        pixel_erosion = std::min( pixel_erosion, dstBandAllowedMax );
-        dstRaster.setValue(C, R, pixel_erosion, dstBandIdx);
+      for( elementIdx = 0 ; elementIdx + windowSize <= elementsNumber ; ++elementIdx )
+      {
+        const double* suffixElement = suffix + elementIdx * elementsStride;
+        const double* prefixElement = prefix + ( elementIdx + windowSize - 1 ) *
+          elementsStride;
+        double* out = output + elementIdx * elementsStride;
 
-        if( useProgress )
+        for( valueIdx = 0 ; valueIdx < elementSize ; ++valueIdx )
         {
-          task->setCurrentStep( R / srcRaster.getNumberOfRows() );
-          if( !task->isActive() ) return false;
+          out[ valueIdx ] = SelectValue< SelectHigherValue >( suffixElement[ valueIdx ],
+            prefixElement[ valueIdx ] );
         }
-
-        ++it;
       }
-
-      return true;
     }
 
-    bool Filter::UserDefinedFilter( const te::rst::Raster& srcRaster,
-      const unsigned int srcBandIdx, te::rst::Raster& dstRaster,
-      const unsigned int dstBandIdx, const bool useProgress )
+    /*!
+      \brief Applies a dilation (or erosion) over the rows of a strip.
+      \param rowsResult, prefix, suffix Auxiliary buffers with at least the strip input buffer size.
+      \note The rectangular window is separable: each input row is filtered first and
+      the columns are filtered over the rows results.
+    */
+    template< bool SelectHigherValue >
+    void MorphologicalStrip( const unsigned int nRows, const unsigned int nCols,
+      const unsigned int windowHeight, const unsigned int windowWidth,
+      const double dstAllowedMin, const double dstAllowedMax,
+      const std::vector< double >& inBuffer, const unsigned int inFirstRow,
+      const unsigned int inRowsNumber, std::vector< double >& outBuffer,
+      const unsigned int outFirstRow, const unsigned int outRowsNumber,
+      std::vector< double >& rowsResult, std::vector< double >& prefix,
+      std::vector< double >& suffix )
     {
-      TERP_DEBUG_TRUE_OR_THROW( srcRaster.getNumberOfColumns() ==
-        dstRaster.getNumberOfColumns(), "Internal error" );
-      TERP_DEBUG_TRUE_OR_THROW( srcRaster.getNumberOfRows() ==
-        dstRaster.getNumberOfRows(), "Internal error" );
-      TERP_DEBUG_TRUE_OR_THROW( srcBandIdx < srcRaster.getNumberOfBands(),
-        "Internal error" );
-      TERP_DEBUG_TRUE_OR_THROW( dstBandIdx < dstRaster.getNumberOfBands(),
-        "Internal error" );
+      const unsigned int windowRowRadius = ( windowHeight / 2 );
+      const unsigned int windowColRadius = ( windowWidth / 2 );
+      const unsigned int validDataRowsBound = nRows - windowRowRadius;
+      const unsigned int validDataColsBound = nCols - windowColRadius;
+      const unsigned int rowResultSize = nCols - windowWidth + 1;
 
-      const unsigned int H = m_inputParameters.m_windowH;
-      const unsigned int W = m_inputParameters.m_windowW;
+      rowsResult.resize( inRowsNumber * nCols );
+      prefix.resize( inRowsNumber * nCols );
+      suffix.resize( inRowsNumber * nCols );
 
-      std::auto_ptr< te::common::TaskProgress > task;
-      if( useProgress )
+      unsigned int row = 0;
+      unsigned int col = 0;
+      double value = 0;
+
+      for( row = 0 ; row < inRowsNumber ; ++row )
       {
-        task.reset( new te::common::TaskProgress(TE_TR("User Defined Filter"),
-          te::common::TaskProgress::UNDEFINED, 100 ) );
+        VanHerkGilWerman< SelectHigherValue >( &inBuffer[ row * nCols ], nCols, 1, 1,
+          windowWidth, &prefix[ 0 ], &suffix[ 0 ], &rowsResult[ row * nCols ] );
       }
 
-      unsigned int R = 0;
-      unsigned int C = 0;
-      const unsigned int MR = srcRaster.getNumberOfRows();
-      const unsigned int MC = srcRaster.getNumberOfColumns();
-      double pixels_in_window = 0;
-
-      double dstBandAllowedMin = 0;
-      double dstBandAllowedMax = 0;
-      te::rp::GetDataTypeRange( dstRaster.getBand( dstBandIdx )->getProperty()->getType(), dstBandAllowedMin,
-        dstBandAllowedMax );
+      /* The columns results are stored over the input rows: the result for
+         a window centered at the strip row r is stored at the row r - windowRowRadius */
 
-      te::rst::Band const * const band = srcRaster.getBand(srcBandIdx);
-      te::rst::BandIteratorWindow<double> it = te::rst::BandIteratorWindow<double>::begin(band, W, H);
-      te::rst::BandIteratorWindow<double> itend = te::rst::BandIteratorWindow<double>::end(band, W, H);
+      if( inRowsNumber >= windowHeight )
+      {
+        VanHerkGilWerman< SelectHigherValue >( &rowsResult[ 0 ], inRowsNumber, nCols,
+          rowResultSize, windowHeight, &prefix[ 0 ], &suffix[ 0 ], &rowsResult[ 0 ] );
+      }
 
-      while (it != itend)
+      for( unsigned int stripRow = 0 ; stripRow < outRowsNumber ; ++stripRow )
       {
-        R = it.getRow();
-        C = it.getColumn();
-        if ((R >= (unsigned)(H / 2) && R < MR - (H / 2)) &&
-            (C >= (unsigned)(W / 2) && C < MC - (W / 2)))
+        row = outFirstRow + stripRow;
+        double* outRow = &outBuffer[ stripRow * nCols ];
+        const double* inRow = &inBuffer[ ( row - inFirstRow ) * nCols ];
+
+        /* The border pixels keep the source values */
+
+        if( ( row < windowRowRadius ) || ( row >= validDataRowsBound ) )
         {
-          pixels_in_window = 0.0;
-          for (int r = -1 * (int) (H / 2), rw = 0; r <= (int) (H / 2); r++, rw++)
-            for (int c = -1 * (int) (W / 2), cw = 0; c <= (int) (W / 2); c++, cw++)
-              pixels_in_window += m_inputParameters.m_window(rw, cw) * it.getValue(c, r);
+          std::copy( inRow, inRow + nCols, outRow );
         }
         else
-          pixels_in_window = it.getValue();
+        {
+          const double* resultRow = &rowsResult[ ( row - windowRowRadius - inFirstRow ) *
+            nCols ];
 
-        pixels_in_window = std::max( pixels_in_window, dstBandAllowedMin );
-        pixels_in_window = std::min( pixels_in_window, dstBandAllowedMax );
-        dstRaster.setValue(C, R, pixels_in_window, dstBandIdx);
+          std::copy( inRow, inRow + windowColRadius, outRow );
+          std::copy( resultRow, resultRow + rowResultSize, outRow + windowColRadius );
+          std::copy( inRow + validDataColsBound, inRow + nCols,
+            outRow + validDataColsBound );
+        }
 
-        if( useProgress )
+        for( col = 0 ; col < nCols ; ++col )
         {
-          task->setCurrentStep( R / srcRaster.getNumberOfRows() );
-          if( !task->isActive() ) return false;
+          value = std::max( outRow[ col ], dstAllowedMin );
+          outRow[ col ] = std::min( value, dstAllowedMax );
         }
-
-        ++it;
       }
-
-      return true;
     }
 
-    bool Filter::OrderFunction(double i, double j)
+    void Filter::DilationStrip( const FilterThreadParams& params, FilterStrip& strip )
     {
-      return (i < j);
+      MorphologicalStrip< true >( params.m_nRows, params.m_nCols, params.m_windowH,
+        params.m_windowW, params.m_dstAllowedMin, params.m_dstAllowedMax,
+        strip.m_inBuffer, strip.m_inFirstRow, strip.m_inRowsNumber, strip.m_outBuffer,
+        strip.m_outFirstRow, strip.m_outRowsNumber, strip.m_auxBuffer1,
+        strip.m_auxBuffer2, strip.m_auxBuffer3 );
     }
 
-    void Filter::ResetConvBuffer(unsigned int lines, unsigned int columns)
+    void Filter::ErosionStrip( const FilterThreadParams& params, FilterStrip& strip )
     {
-      if (m_convBuffer != 0) {
-        for (unsigned int line = 0; line < m_convBufferLines; ++line) {
-          delete[] m_convBuffer[line];
-        }
-
-        delete[] m_convBuffer;
-
-        m_convBuffer = 0;
-        m_convBufferLines = 0;
-        m_convBufferColumns = 0;
-      }
-
-      if ((lines > 0) && (columns > 0)) {
-        m_convBuffer = new double*[lines];
-
-        TERP_DEBUG_TRUE_OR_THROW(m_convBuffer != 0, "Memory allocation error");
-
-        for (unsigned int line = 0; line < lines; ++line) {
-          m_convBuffer[line] = new double[columns];
-
-          TERP_DEBUG_TRUE_OR_THROW(m_convBuffer[line] != 0, "Memory allocation error");
-        }
-
-        m_convBufferLines = lines;
-        m_convBufferColumns = columns;
-      }
+      MorphologicalStrip< false >( params.m_nRows, params.m_nCols, params.m_windowH,
+        params.m_windowW, params.m_dstAllowedMin, params.m_dstAllowedMax,
+        strip.m_inBuffer, strip.m_inFirstRow, strip.m_inRowsNumber, strip.m_outBuffer,
+        strip.m_outFirstRow, strip.m_outRowsNumber, strip.m_auxBuffer1,
+        strip.m_auxBuffer2, strip.m_auxBuffer3 );
     }
 
-    void Filter::UpdateConvBuffer(const te::rst::Band& inRaster, unsigned int line)
+    void Filter::UserDefinedStrip( const FilterThreadParams& params, FilterStrip& strip )
     {
-      TERP_DEBUG_TRUE_OR_THROW((inRaster.getRaster()->getNumberOfRows() > (int)line),
-        "Trying to get a non existent line from raster");
-      TERP_DEBUG_TRUE_OR_THROW((inRaster.getRaster()->getNumberOfColumns() ==
-        (int)m_convBufferColumns),
-        "Buffer columns number not equal to raster columns");
+      const unsigned int nRows = params.m_nRows;
+      const unsigned int nCols = params.m_nCols;
+      const unsigned int windowHeight = params.m_windowH;
+      const unsigned int windowWidth = params.m_windowW;
+      const unsigned int windowRowRadius = ( windowHeight / 2 );
+      const unsigned int windowColRadius = ( windowWidth / 2 );
+      const unsigned int validDataRowsBound = nRows - windowRowRadius;
+      const unsigned int rowResultSize = nCols - windowWidth + 1;
+      const boost::numeric::ublas::matrix<double>& window = *params.m_windowPtr;
 
+      unsigned int col = 0;
+      double value = 0;
 
-      /* Buffer roll up */
+      for( unsigned int stripRow = 0 ; stripRow < strip.m_outRowsNumber ; ++stripRow )
+      {
+        const unsigned int row = strip.m_outFirstRow + stripRow;
+        double* outRow = &strip.m_outBuffer[ stripRow * nCols ];
+        const double* inRow = &strip.m_inBuffer[ ( row - strip.m_inFirstRow ) * nCols ];
 
-      ConvBufferRoolup(1);
+        /* The border pixels keep the source values */
 
-      /* Updating the last line */
+        std::copy( inRow, inRow + nCols, outRow );
 
-      unsigned int convBufferLastLine = m_convBufferLines - 1;
+        if( ( row >= windowRowRadius ) && ( row < validDataRowsBound ) )
+        {
+          /* Each window weight is applied over a whole row: the inner loop
+             over the columns has no dependencies */
 
-      for (unsigned int bufcolumn = 0; bufcolumn < m_convBufferColumns; ++bufcolumn) {
-        inRaster.getValue(bufcolumn, line,
-          m_convBuffer[convBufferLastLine][bufcolumn]);
-      }
-    }
+          double* resultRow = outRow + windowColRadius;
 
-    void Filter::ConvBufferRoolup(unsigned int count)
-    {
-      TERP_DEBUG_TRUE_OR_THROW((m_convBufferLines > 0), "Invalid convolution buffer lines");
+          std::fill( resultRow, resultRow + rowResultSize, 0.0 );
 
-      double* firstBufferLinePtr;
-      unsigned int convBufferLastLine = m_convBufferLines - 1;
-      unsigned int bufline;
+          for( unsigned int rowOffset = 0 ; rowOffset < windowHeight ; ++rowOffset )
+          {
+            const double* line = &strip.m_inBuffer[ ( row - windowRowRadius +
+              rowOffset - strip.m_inFirstRow ) * nCols ];
 
-      for (unsigned int curCount = 0; curCount < count; ++curCount) {
-        firstBufferLinePtr = m_convBuffer[0];
+            for( unsigned int colOffset = 0 ; colOffset < windowWidth ; ++colOffset )
+            {
+              const double weight = window( rowOffset, colOffset );
+              const double* windowLine = line + colOffset;
 
-        for (bufline = 1; bufline < m_convBufferLines; ++bufline) {
-          m_convBuffer[bufline - 1] = m_convBuffer[bufline];
+              for( col = 0 ; col < rowResultSize ; ++col )
+              {
+                resultRow[ col ] += weight * windowLine[ col ];
+              }
+            }
+          }
         }
 
-        m_convBuffer[convBufferLastLine] = firstBufferLinePtr;
+        for( col = 0 ; col < nCols ; ++col )
+        {
+          value = std::max( outRow[ col ], params.m_dstAllowedMin );
+          outRow[ col ] = std::min( value, params.m_dstAllowedMax );
+        }
       }
     }
   } // end namespace rp
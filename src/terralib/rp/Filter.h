@@ -27,10 +27,12 @@
 
 #include "Algorithm.h"
 #include "../raster/Raster.h"
+#include "../common/progress/TaskProgress.h"
 
 // Boost
 #include <boost/numeric/ublas/io.hpp>
 #include <boost/numeric/ublas/matrix.hpp>
+#include <boost/thread.hpp>
 
 // STL
 #include <vector>
@@ -84,6 +86,8 @@ namespace te
 
             bool m_enableProgress; //!< Enable/Disable the progress interface (default:false).
 
+            unsigned int m_maxThreads; //!< The maximum number of threads to use (0-auto, 1-single thread used, default:0).
+
             boost::numeric::ublas::matrix<double> m_window; //!< User defined convolution window. (The size must be equal to m_windowH x m_windowW)
 
             InputParameters();
@@ -151,150 +155,198 @@ namespace te
       protected:
 
         /*!
-          \brief Type definition for a filter method pointer.
-          \param srcRaster Source raster.
-          \param srcBandIdx Source raster band index.
-          \param dstRaster Destination raster.
-          \param dstBandIdx Destination raster band index.
-          \param useProgress if true, the progress interface must be used.
-          \return true if ok, false on errors.
+          \class FilterStrip
+          \brief A strip of rows filtered by a thread.
          */
-        typedef bool (Filter::*FilterMethodPointerT)( const te::rst::Raster& srcRaster,
-          const unsigned int srcBandIdx, te::rst::Raster& dstRaster,
-          const unsigned int dstBandIdx, const bool useProgress );
+        class FilterStrip
+        {
+          public:
 
-        bool m_isInitialized; //!< Is this instance already initialized?
+            std::vector< double > m_inBuffer; //!< The input rows (including the rows above and below the output rows required by the filter window).
 
-        Filter::InputParameters m_inputParameters; //!< Input parameters.
+            unsigned int m_inFirstRow; //!< The raster row of the first input row.
 
-        double** m_convBuffer; //!< Convolution Buffer.
+            unsigned int m_inRowsNumber; //!< The number of input rows.
 
-        unsigned int m_convBufferLines; //!< Convolution Buffer lines.
+            std::vector< double > m_outBuffer; //!< The output rows.
 
-        unsigned int m_convBufferColumns; //!< Convolution Buffer columns.
+            unsigned int m_outFirstRow; //!< The raster row of the first output row.
 
-        /*!
-          \brief Applay the Roberts filter over the source raster band.
-          \param srcRaster Source raster.
-          \param srcBandIdx Source raster band index.
-          \param dstRaster Destination raster.
-          \param dstBandIdx Destination raster band index.
-          \param useProgress if true, the progress interface must be used.
-         */
-        bool RobertsFilter( const te::rst::Raster& srcRaster,
-          const unsigned int srcBandIdx, te::rst::Raster& dstRaster,
-          const unsigned int dstBandIdx, const bool useProgress  );
+            unsigned int m_outRowsNumber; //!< The number of output rows.
+
+            std::vector< double > m_auxBuffer1; //!< Auxiliary buffer.
+
+            std::vector< double > m_auxBuffer2; //!< Auxiliary buffer.
+
+            std::vector< double > m_auxBuffer3; //!< Auxiliary buffer.
+
+            std::vector< unsigned int > m_histogram; //!< Histogram used by the rank filters over integer data.
+
+            FilterStrip()
+              : m_inFirstRow( 0 ), m_inRowsNumber( 0 ), m_outFirstRow( 0 ),
+                m_outRowsNumber( 0 )
+            {
+            };
+
+            ~FilterStrip() {};
+        };
 
         /*!
-          \brief Applay the Sobel filter over the source raster band.
-          \param srcRaster Source raster.
-          \param srcBandIdx Source raster band index.
-          \param dstRaster Destination raster.
-          \param dstBandIdx Destination raster band index.
-          \param useProgress if true, the progress interface must be used.
+          \class FilterThreadParams
+          \brief The parameters shared by the threads filtering a band.
          */
-        bool SobelFilter( const te::rst::Raster& srcRaster,
-          const unsigned int srcBandIdx, te::rst::Raster& dstRaster,
-          const unsigned int dstBandIdx, const bool useProgress  );
+        class FilterThreadParams
+        {
+          public:
+
+            /*!
+              \brief Type definition for a strip filtering method pointer.
+              \param params The filter parameters.
+              \param strip The strip to be filtered (the output rows must be generated).
+             */
+            typedef void (*StripFilterPointerT)( const FilterThreadParams& params,
+              FilterStrip& strip );
+
+            StripFilterPointerT m_stripFilterPtr; //!< The strip filtering method.
+
+            te::rst::Band const* m_srcBandPtr; //!< Source band.
+
+            te::rst::Band* m_dstBandPtr; //!< Destination band.
+
+            boost::numeric::ublas::matrix<double> const* m_windowPtr; //!< User defined convolution window.
+
+            unsigned int m_nRows; //!< Source raster rows number.
+
+            unsigned int m_nCols; //!< Source raster columns number.
+
+            unsigned int m_windowH; //!< The height of the convolution window.
+
+            unsigned int m_windowW; //!< The width of the convolution window.
+
+            unsigned int m_rowsAbove; //!< The number of input rows above each output row required by the filter.
+
+            unsigned int m_rowsBelow; //!< The number of input rows below each output row required by the filter.
+
+            unsigned int m_outRowsNumber; //!< The number of output rows.
+
+            unsigned int m_outColsNumber; //!< The number of output columns.
+
+            unsigned int m_stripRowsNumber; //!< The number of output rows of each strip.
+
+            double m_srcNoDataValue; //!< Source band no-data value.
+
+            double m_dstNoDataValue; //!< Destination band no-data value.
+
+            double m_dstAllowedMin; //!< Destination band minimum allowed value.
+
+            double m_dstAllowedMax; //!< Destination band maximum allowed value.
+
+            bool m_useHistogram; //!< true if the source band data can be mapped to histogram bins.
+
+            double m_histogramMin; //!< The value of the first histogram bin.
+
+            unsigned int m_histogramSize; //!< The number of histogram bins.
+
+            boost::mutex* m_mutexPtr; //!< A pointer to the sync mutex (the access to the bands and the variables below).
+
+            boost::condition_variable* m_condVarPtr; //!< A pointer to the condition variable used to notify strips finishment.
+
+            te::common::TaskProgress* m_progressPtr; //!< The progress interface to be updated by the threads (or null).
+
+            unsigned int m_nextStripRow; //!< The first output row of the next strip to be processed.
+
+            unsigned int m_processedRowsNumber; //!< The number of output rows written.
+
+            unsigned int m_runningThreadsNumber; //!< The number of running threads.
+
+            bool m_abort; //!< true if the threads must stop.
+
+            bool m_returnStatus; //!< false on errors.
+
+            FilterThreadParams() {};
+
+            ~FilterThreadParams() {};
+        };
+
+        bool m_isInitialized; //!< Is this instance already initialized?
+
+        Filter::InputParameters m_inputParameters; //!< Input parameters.
 
         /*!
-          \brief Applay the mean filter over the source raster band.
+          \brief Applay the selected filter over the source raster band.
           \param srcRaster Source raster.
           \param srcBandIdx Source raster band index.
           \param dstRaster Destination raster.
           \param dstBandIdx Destination raster band index.
           \param useProgress if true, the progress interface must be used.
+          \return true if ok, false on errors.
+          \note The band is split into strips of rows filtered by up to m_maxThreads threads.
          */
-        bool MeanFilter( const te::rst::Raster& srcRaster,
+        bool FilterBand( const te::rst::Raster& srcRaster,
           const unsigned int srcBandIdx, te::rst::Raster& dstRaster,
-          const unsigned int dstBandIdx, const bool useProgress  );
+          const unsigned int dstBandIdx, const bool useProgress );
 
         /*!
-          \brief Applay the mode filter over the source raster band.
-          \param srcRaster Source raster.
-          \param srcBandIdx Source raster band index.
-          \param dstRaster Destination raster.
-          \param dstBandIdx Destination raster band index.
-          \param useProgress if true, the progress interface must be used.
+          \brief The thread entry: the strips are read, filtered and written until all band rows are done.
+          \param paramsPtr A pointer to the shared parameters.
          */
-        bool ModeFilter( const te::rst::Raster& srcRaster,
-          const unsigned int srcBandIdx, te::rst::Raster& dstRaster,
-          const unsigned int dstBandIdx, const bool useProgress  );
+        static void FilterThreadEntry( FilterThreadParams* paramsPtr );
 
         /*!
-          \brief Applay the median filter over the source raster band.
-          \param srcRaster Source raster.
-          \param srcBandIdx Source raster band index.
-          \param dstRaster Destination raster.
-          \param dstBandIdx Destination raster band index.
-          \param useProgress if true, the progress interface must be used.
+          \brief Applay the Roberts filter over a strip.
+          \param params The filter parameters.
+          \param strip The strip.
          */
-        bool MedianFilter( const te::rst::Raster& srcRaster,
-          const unsigned int srcBandIdx, te::rst::Raster& dstRaster,
-          const unsigned int dstBandIdx, const bool useProgress  );
+        static void RobertsStrip( const FilterThreadParams& params, FilterStrip& strip );
 
         /*!
-          \brief Applay the dilation filter over the source raster band.
-          \param srcRaster Source raster.
-          \param srcBandIdx Source raster band index.
-          \param dstRaster Destination raster.
-          \param dstBandIdx Destination raster band index.
-          \param useProgress if true, the progress interface must be used.
+          \brief Applay the Sobel filter over a strip.
+          \param params The filter parameters.
+          \param strip The strip.
          */
-        bool DilationFilter( const te::rst::Raster& srcRaster,
-          const unsigned int srcBandIdx, te::rst::Raster& dstRaster,
-          const unsigned int dstBandIdx, const bool useProgress  );
+        static void SobelStrip( const FilterThreadParams& params, FilterStrip& strip );
 
         /*!
-          \brief Applay the erosion filter over the source raster band.
-          \param srcRaster Source raster.
-          \param srcBandIdx Source raster band index.
-          \param dstRaster Destination raster.
-          \param dstBandIdx Destination raster band index.
-          \param useProgress if true, the progress interface must be used.
+          \brief Applay the mean filter over a strip (running window sums).
+          \param params The filter parameters.
+          \param strip The strip.
          */
-        bool ErosionFilter( const te::rst::Raster& srcRaster,
-          const unsigned int srcBandIdx, te::rst::Raster& dstRaster,
-          const unsigned int dstBandIdx, const bool useProgress  );
+        static void MeanStrip( const FilterThreadParams& params, FilterStrip& strip );
 
         /*!
-          \brief Applay the user defined filter over the source raster band.
-          \param srcRaster Source raster.
-          \param srcBandIdx Source raster band index.
-          \param dstRaster Destination raster.
-          \param dstBandIdx Destination raster band index.
-          \param useProgress if true, the progress interface must be used.
+          \brief Applay the mode filter over a strip (sliding histogram for integer data).
+          \param params The filter parameters.
+          \param strip The strip.
          */
-        bool UserDefinedFilter( const te::rst::Raster& srcRaster,
-          const unsigned int srcBandIdx, te::rst::Raster& dstRaster,
-          const unsigned int dstBandIdx, const bool useProgress  );
+        static void ModeStrip( const FilterThreadParams& params, FilterStrip& strip );
 
         /*!
-          \brief Returns true if i < j.
-          \return Returns true if i < j.
+          \brief Applay the median filter over a strip (sliding histogram for integer data).
+          \param params The filter parameters.
+          \param strip The strip.
          */
-        static bool OrderFunction(double i, double j);
+        static void MedianStrip( const FilterThreadParams& params, FilterStrip& strip );
 
         /*!
-        \brief Resets the convolution buffer.
-        \param lines Convolution buffer lines.
-        \param columns Convolution buffer columns.
-        */
-        void ResetConvBuffer(unsigned int lines, unsigned int columns);
+          \brief Applay the dilation filter over a strip (van Herk/Gil-Werman).
+          \param params The filter parameters.
+          \param strip The strip.
+         */
+        static void DilationStrip( const FilterThreadParams& params, FilterStrip& strip );
 
         /*!
-        \brief Updates the convolution buffer with a new raster line.
-        \param inBand Source raster band.
-        \param line Raster line.
-        \param band Raster band.
-        */
-        void UpdateConvBuffer(const te::rst::Band& inBand, unsigned int line);
+          \brief Applay the erosion filter over a strip (van Herk/Gil-Werman).
+          \param params The filter parameters.
+          \param strip The strip.
+         */
+        static void ErosionStrip( const FilterThreadParams& params, FilterStrip& strip );
 
         /*!
-        \brief Rools up the convolution buffer count lines.
-        \param count Count times to rool convolution buffer.
-        */
-        void ConvBufferRoolup(unsigned int count);
+          \brief Applay the user defined filter over a strip.
+          \param params The filter parameters.
+          \param strip The strip.
+         */
+        static void UserDefinedStrip( const FilterThreadParams& params, FilterStrip& strip );
     };
 
   } // end namespace rp
@@ -96,6 +96,17 @@ namespace te
       Relative_Sum
     };
     
+    /*!
+      \enum KernelAlgorithmType
+
+      \brief Defines how the kernel of a grid is evaluated.
+    */
+    enum KernelAlgorithmType
+    {
+      Cell_Evaluation,
+      Grid_Convolution
+    };
+
     /*!
       \enum KernelOutputType
 
@@ -66,6 +66,7 @@ void te::sa::GPMConstructorDistanceStrategy::constructStrategy()
 
   //create tree
   te::sam::rtree::Index<int> rtree;
+  std::vector<te::sam::rtree::Index<int>::ItemType> rtreeItems;
   std::map<int, te::gm::Geometry*> geomMap;
 
   dataSet->moveBeforeFirst();
@@ -79,11 +80,13 @@ void te::sa::GPMConstructorDistanceStrategy::constructStrategy()
     te::gm::Geometry* g = dataSet->getGeometry(geomPos).release();
     const te::gm::Envelope* box = g->getMBR();
 
-    rtree.insert(*box, id);
+    rtreeItems.push_back(te::sam::rtree::Index<int>::ItemType(*box, id));
 
     geomMap.insert(std::map<int, te::gm::Geometry*>::value_type(id, g));
   }
 
+  rtree.bulkLoad(rtreeItems);
+
   //create task
   te::common::TaskProgress task;
 
@@ -36,7 +36,7 @@
 #include "../../geometry/Point.h"
 #include "../../graph/core/Edge.h"
 #include "../../graph/core/Vertex.h"
-#include "../../sam/kdtree.h"
+#include "../../sam/rtree.h"
 #include "GeneralizedProximityMatrix.h"
 #include "GPMConstructorNearestNeighborStrategy.h"
 #include "Utils.h"
@@ -59,123 +59,89 @@ te::sa::GPMConstructorNearestNeighborStrategy::~GPMConstructorNearestNeighborStr
 
 void te::sa::GPMConstructorNearestNeighborStrategy::constructStrategy()
 {
-  ////get input information
-  //std::auto_ptr<te::da::DataSet> dataSet = m_ds->getDataSet(m_gpm->getDataSetName());
+  //get input information
+  std::auto_ptr<te::da::DataSet> dataSet = m_ds->getDataSet(m_gpm->getDataSetName());
 
-  //std::size_t geomPos = te::da::GetFirstSpatialPropertyPos(dataSet.get());
+  std::size_t geomPos = te::da::GetFirstSpatialPropertyPos(dataSet.get());
 
-  //std::auto_ptr<te::da::DataSetType> dsType = m_ds->getDataSetType(m_gpm->getDataSetName());
+  //create distance attribute
+  createDistanceAttribute(m_gpm);
 
-  //te::gm::GeometryProperty* gmProp = dynamic_cast<te::gm::GeometryProperty*>(dsType->getProperty(geomPos));
+  //create tree with the centroids of the geometries
+  te::sam::rtree::Index<int> rtree;
+  std::vector<te::sam::rtree::Index<int>::ItemType> rtreeItems;
+  std::map<int, te::gm::Coord2D> coordMap;
 
-  ////create distance attribute
-  //createDistanceAttribute(m_gpm);
+  dataSet->moveBeforeFirst();
 
-  ////create dataset of points
-  //te::gm::Envelope e;
-  //std::vector<std::pair<te::gm::Coord2D, te::gm::Point> > dataset;
-  //std::map<int, te::gm::Geometry*> geomMap;
+  while(dataSet->moveNext())
+  {
+    std::string strId = dataSet->getAsString(m_gpm->getAttributeName());
 
-  //dataSet->moveBeforeFirst();
+    int id = atoi(strId.c_str());
 
-  //while(dataSet->moveNext())
-  //{
-  //  std::string strId = dataSet->getAsString(m_gpm->getAttributeName());
+    std::auto_ptr<te::gm::Geometry> g = dataSet->getGeometry(geomPos);
 
-  //  int id = atoi(strId.c_str());
+    te::gm::Coord2D coord = te::sa::GetCentroidCoord(g.get());
 
-  //  te::gm::Geometry* g = dataSet->getGeometry(geomPos).release();
+    rtreeItems.push_back(te::sam::rtree::Index<int>::ItemType(te::gm::Envelope(coord.x, coord.y, coord.x, coord.y), id));
 
-  //  te::gm::Coord2D coord = te::sa::GetCentroidCoord(g);
-  //  te::gm::Point point = te::gm::Point(coord.x, coord.y, gmProp->getSRID());
+    coordMap.insert(std::map<int, te::gm::Coord2D>::value_type(id, coord));
+  }
 
-  //  e.Union(*point.getMBR());
+  rtree.bulkLoad(rtreeItems);
 
-  //  dataset.push_back(std::pair<te::gm::Coord2D, te::gm::Point>(coord, point));
+  //create task
+  te::common::TaskProgress task;
 
-  //  geomMap.insert(std::map<int, te::gm::Geometry*>::value_type(id, g));
-  //}
+  task.setTotalSteps(dataSet->size());
+  task.setMessage(TE_TR("Creating Edge Objects."));
 
-  //// K-d Tree
-  //typedef te::sam::kdtree::AdaptativeNode<te::gm::Coord2D, std::vector<te::gm::Point>, te::gm::Point> kdNode;
-  //typedef te::sam::kdtree::AdaptativeIndex<kdNode> kdTree;
+  //create edges objects
+  std::map<int, te::gm::Coord2D>::iterator itCoord = coordMap.begin();
 
-  //kdTree tree(e, m_nNeighbors);
-  //tree.build(dataset);
+  while(itCoord != coordMap.end())
+  {
+    int vFromId = itCoord->first;
 
-  ////create task
-  //te::common::TaskProgress task;
+    const te::gm::Coord2D& coord = itCoord->second;
 
-  //task.setTotalSteps(dataSet->size());
-  //task.setMessage(TE_TR("Creating Edge Objects."));
+    std::vector<int> results;
+    std::vector<double> distances;
 
-  ////create edges objects
-  //dataSet->moveBeforeFirst();
+    //the nearest object is the object itself
+    rtree.nearestNeighborSearch(te::gm::Envelope(coord.x, coord.y, coord.x, coord.y), m_nNeighbors + 1, results, distances);
 
-  //while(dataSet->moveNext())
-  //{
-  //  std::string strIdFrom = dataSet->getAsString(m_gpm->getAttributeName());
+    std::size_t nNeighbors = 0;
 
-  //  int vFromId = atoi(strIdFrom.c_str());
+    for(std::size_t t = 0; (t < results.size()) && (nNeighbors < m_nNeighbors); ++t)
+    {
+      int vToId = results[t];
 
-  //  std::auto_ptr<te::gm::Geometry> g = dataSet->getGeometry(geomPos);
+      if(vToId == vFromId)
+        continue;
 
-  //  te::gm::Coord2D coord = te::sa::GetCentroidCoord(g.get());
+      int edgeId = getEdgeId();
 
-  //  std::vector<double> distances;
+      te::graph::Edge* e = new te::graph::Edge(edgeId, vFromId, vToId);
 
-  //  std::vector<te::gm::Point> points;
+      te::dt::SimpleData<double, te::dt::DOUBLE_TYPE>* sd = new te::dt::SimpleData<double, te::dt::DOUBLE_TYPE>(distances[t]);
 
-  //  for(std::size_t t = 0; t < m_nNeighbors; ++t)
-  //    points.push_back(te::gm::Point(std::numeric_limits<double>::max(), std::numeric_limits<double>::max()));
+      e->setAttributeVecSize(1);
+      e->addAttribute(0, sd);
 
-  //  tree.nearestNeighborSearch(coord, points, distances, m_nNeighbors);
+      m_gpm->getGraph()->add(e);
 
-  //  for(size_t t = 0; t < points.size(); ++t)
-  //  {
-  //    int id;
+      ++nNeighbors;
+    }
 
-  //    std::map<int, te::gm::Geometry*>::iterator it = geomMap.find(id);
+    if(!task.isActive())
+    {
+      throw te::common::Exception(TE_TR("Operation canceled by the user."));
+    }
 
-  //    if(it != geomMap.end())
-  //    {
+    task.pulse();
 
-  //      int edgeId = getEdgeId();
-
-  //      int vToId = id;
-
-  //      te::graph::Edge* e = new te::graph::Edge(edgeId, vFromId, vToId);
-
-  //      //caculate distance
-  //      te::graph::Vertex* vFrom = m_gpm->getGraph()->getVertex(vFromId);
-  //      te::gm::Point* pFrom = dynamic_cast<te::gm::Point*>(vFrom->getAttributes()[0]);
-
-  //      te::graph::Vertex* vTo = m_gpm->getGraph()->getVertex(vToId);
-  //      te::gm::Point* pTo = dynamic_cast<te::gm::Point*>(vTo->getAttributes()[0]);
-
-  //      double dist = pFrom->distance(pTo);
-
-  //      te::dt::SimpleData<double, te::dt::DOUBLE_TYPE>* sd = new te::dt::SimpleData<double, te::dt::DOUBLE_TYPE>(dist);
-  //          
-  //      e->setAttributeVecSize(1);
-  //      e->addAttribute(0, sd);
-
-  //      m_gpm->getGraph()->add(e);
-  //    }
-  //  }
-
-  //  if(!task.isActive())
-  //  {
-  //    te::common::FreeContents(geomMap);
-  //    geomMap.clear();
-
-  //    throw te::common::Exception(TE_TR("Operation canceled by the user."));
-  //  }
-  //    
-
-  //  task.pulse();
-  //}
-
-  //te::common::FreeContents(geomMap);
-  //geomMap.clear();
+    ++itCoord;
+  }
 }
\ No newline at end of file
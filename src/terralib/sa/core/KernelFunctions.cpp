@@ -35,64 +35,79 @@
 #include "../../raster/Grid.h"
 #include "../../raster/Raster.h"
 #include "KernelFunctions.h"
+#include "KernelGridEstimator.h"
 #include "StatisticsFunctions.h"
 #include "Utils.h"
 
-void te::sa::GridStatRadiusKernel(te::sa::KernelInputParams* params, te::sa::KernelTree& kTree, te::sa::KernelMap& kMap, te::rst::Raster* raster, double radius)
-{
-  assert(params);
-  assert(raster);
+//STL
+#include <cmath>
+#include <limits>
 
-  double totKernel = 0.;
+namespace
+{
+  //the box of the events that may contribute to the kernel of a location
+  te::gm::Envelope GetKernelSearchBox(te::sa::KernelInputParams* params, te::sa::KernelTree& kTree, const te::gm::Coord2D& coord, double radius)
+  {
+    double support = te::sa::KernelSupport(params->m_functionType, radius, params->m_tolerance);
 
-  //create task
-  te::common::TaskProgress task;
+    //get all elements
+    if(support == std::numeric_limits<double>::max())
+      return kTree.getMBR();
 
-  task.setTotalSteps(raster->getNumberOfRows());
-  task.setMessage(TE_TR("Calculating Kernel."));
+    return te::gm::Envelope(coord.x - support, coord.y - support, coord.x + support, coord.y + support);
+  }
 
-  //fill raster
-  for(unsigned int i = 0; i < raster->getNumberOfRows(); ++i)
+  //copy the kernel values to the raster, returning their sum
+  double SetRasterValues(te::rst::Raster* raster, const std::vector<double>& values)
   {
-    for(unsigned int j = 0; j < raster->getNumberOfColumns(); ++j)
-    {
-      te::gm::Coord2D coord = raster->getGrid()->gridToGeo(j, i);
+    double totKernel = 0.;
 
-      //calculate box to search
-      te::gm::Envelope ext(coord.x, coord.y, coord.x, coord.y);
-
-      ext.m_llx -= radius;
-      ext.m_lly -= radius;
-      ext.m_urx += radius;
-      ext.m_ury += radius;
+    std::size_t cell = 0;
 
-      //get all elements
-      if(params->m_functionType == te::sa::Normal)
+    for(unsigned int i = 0; i < raster->getNumberOfRows(); ++i)
+    {
+      for(unsigned int j = 0; j < raster->getNumberOfColumns(); ++j)
       {
-        ext = kTree.getMBR();
+        totKernel += values[cell];
+
+        raster->setValue(j, i, values[cell++], 0);
       }
+    }
 
-      //search
-      std::vector<int> results;
-      kTree.search(ext, results);
+    return totKernel;
+  }
+}
 
-      //calculate kernel value
-      double val = KernelValue(params, kMap, radius, coord, results);
+void te::sa::GridStatRadiusKernel(te::sa::KernelInputParams* params, te::sa::KernelTree& /*kTree*/, te::sa::KernelMap& kMap, te::rst::Raster* raster, double radius)
+{
+  assert(params);
+  assert(raster);
 
-      totKernel += val;
+  te::sa::KernelGridEstimator estimator(*params, kMap, *raster->getGrid());
 
-      //set value
-      raster->setValue(j, i, val, 0);
-    }
+  //create task
+  te::common::TaskProgress task;
 
-    if(!task.isActive())
-    {
-      throw te::common::Exception(TE_TR("Operation canceled by the user."));
-    }
+  task.setMessage(TE_TR("Calculating Kernel."));
 
-    task.pulse();
+  //calculate the kernel of all cells
+  std::vector<double> values;
+
+  bool finished = false;
+
+  if(params->m_algorithm == te::sa::Grid_Convolution)
+    finished = estimator.convolutionKernel(radius, values, &task);
+  else
+    finished = estimator.cellKernel(radius, values, &task);
+
+  if(!finished)
+  {
+    throw te::common::Exception(TE_TR("Operation canceled by the user."));
   }
 
+  //fill raster
+  double totKernel = SetRasterValues(raster, values);
+
   //normalize output raster
   GridKernelNormalize(params, kMap, raster, totKernel);
 }
@@ -114,71 +129,38 @@ void te::sa::GridAdaptRadiusKernel(te::sa::KernelInputParams* params, te::sa::Ke
   if(meanKernel <= 0.)
     throw;
 
-  //create task
-  te::common::TaskProgress task;
-
-  task.setTotalSteps(raster->getNumberOfRows());
-  task.setMessage(TE_TR("Calculating Adaptative Kernel."));
-
-  //Reassign radius, evaluating final value for kernel
-  double totKernel = 0.;
+  //get the kernel values with the fixed radius
+  std::vector<double> prevValues;
+  prevValues.reserve(static_cast<std::size_t>(raster->getNumberOfRows()) * raster->getNumberOfColumns());
 
   for(unsigned int i = 0; i < raster->getNumberOfRows(); ++i)
   {
     for(unsigned int j = 0; j < raster->getNumberOfColumns(); ++j)
     {
-      te::gm::Coord2D coord = raster->getGrid()->gridToGeo(j, i);
-
-      //calculate box to search
-      te::gm::Envelope ext(coord.x, coord.y, coord.x, coord.y);
-
-      ext.m_llx -= radius;
-      ext.m_lly -= radius;
-      ext.m_urx += radius;
-      ext.m_ury += radius;
-
-      //get all elements
-      if(params->m_functionType == te::sa::Normal)
-      {
-        ext = kTree.getMBR();
-      }
-
-      //search
-      std::vector<int> results;
-      kTree.search(ext, results);
-
-      //calculate new kernel valeu from old kernel value
-      double newKernel = 0.;
       double prevKernel;
       raster->getValue(j, i, prevKernel);
 
-      if(prevKernel > 0.)
-      {
-        //set new radius value
-        double newRadius = radius * pow((meanKernel / prevKernel), 0.5);
-
-        //limit the radius
-        if(newRadius > sqArea / 4.)
-          newRadius = sqArea / 4.;
+      prevValues.push_back(prevKernel);
+    }
+  }
 
-        //calculate kernel value
-        newKernel = KernelValue(params, kMap, newRadius, coord, results);
-      }
+  te::sa::KernelGridEstimator estimator(*params, kMap, *raster->getGrid());
 
-      totKernel += newKernel;
+  //create task
+  te::common::TaskProgress task;
 
-      //set value
-      raster->setValue(j, i, newKernel, 0);
-    }
+  task.setMessage(TE_TR("Calculating Adaptative Kernel."));
 
-    if(!task.isActive())
-    {
-      throw te::common::Exception(TE_TR("Operation canceled by the user."));
-    }
+  //Reassign radius, evaluating final value for kernel
+  std::vector<double> values;
 
-    task.pulse();
+  if(!estimator.adaptiveCellKernel(radius, meanKernel, sqArea / 4., prevValues, values, &task))
+  {
+    throw te::common::Exception(TE_TR("Operation canceled by the user."));
   }
 
+  double totKernel = SetRasterValues(raster, values);
+
   //normalize output raster
   GridKernelNormalize(params, kMap, raster, totKernel);
 }
@@ -241,18 +223,7 @@ void te::sa::DataSetStatRadiusKernel(te::sa::KernelInputParams* params, te::sa::
     te::gm::Coord2D coord = te::sa::GetCentroidCoord(geom.get());
 
     //calculate box to search
-    te::gm::Envelope ext(coord.x, coord.y, coord.x, coord.y);
-
-    ext.m_llx -= radius;
-    ext.m_lly -= radius;
-    ext.m_urx += radius;
-    ext.m_ury += radius;
-
-    //get all elements
-    if(params->m_functionType == te::sa::Normal)
-    {
-      ext = kTree.getMBR();
-    }
+    te::gm::Envelope ext = GetKernelSearchBox(params, kTree, coord, radius);
 
     //search
     std::vector<int> results;
@@ -312,24 +283,6 @@ void te::sa::DataSetAdaptRadiusKernel(te::sa::KernelInputParams* params, te::sa:
 
     te::gm::Coord2D coord = te::sa::GetCentroidCoord(geom.get());
 
-    //calculate box to search
-    te::gm::Envelope ext(coord.x, coord.y, coord.x, coord.y);
-
-    ext.m_llx -= radius;
-    ext.m_lly -= radius;
-    ext.m_urx += radius;
-    ext.m_ury += radius;
-
-    //get all elements
-    if(params->m_functionType == te::sa::Normal)
-    {
-      ext = kTree.getMBR();
-    }
-
-    //search
-    std::vector<int> results;
-    kTree.search(ext, results);
-
     //calculate new kernel valeu from old kernel value
     double newKernel = 0.;
     double prevKernel = ds->getDouble(kernelIdx);
@@ -343,6 +296,13 @@ void te::sa::DataSetAdaptRadiusKernel(te::sa::KernelInputParams* params, te::sa:
       if(newRadius > sqArea / 4.)
         newRadius = sqArea / 4.;
 
+      //calculate box to search
+      te::gm::Envelope ext = GetKernelSearchBox(params, kTree, coord, newRadius);
+
+      //search
+      std::vector<int> results;
+      kTree.search(ext, results);
+
       //calculate kernel value
       newKernel = KernelValue(params, kMap, newRadius, coord, results);
     }
@@ -522,33 +482,52 @@ double te::sa::KernelValue(te::sa::KernelInputParams* params, te::sa::KernelMap&
     double distance = te::sa::CalculateDistance(g, coord);
 
     //calculate kernel value for this element
-    double localK = 0.;
+    double localK = KernelFunctionValue(params->m_functionType, radius, distance, intensity);
 
-    switch(params->m_functionType) 
-    {
-      case te::sa::Quartic:
-        localK = KernelQuartic(radius, distance, intensity);
-        break;
-      case te::sa::Normal:
-        localK = KernelNormal(radius, distance, intensity);
-        break;
-      case te::sa::Triangular:
-        localK = KernelTriangular(radius, distance, intensity);
-        break;
-      case te::sa::Negative_Exp:
-        localK = KernelNegExponential(radius, distance, intensity);
+    kernelValue += localK; 
+  }
+
+  return kernelValue;
+}
+
+double te::sa::KernelFunctionValue(te::sa::KernelFunctionType type, double tau, double distance, double intensity)
+{
+  double kernelValue = 0.;
+
+  switch(type)
+  {
+    case te::sa::Quartic:
+      kernelValue = KernelQuartic(tau, distance, intensity);
       break;
-        case te::sa::Uniform:
-        localK = KernelUniform(radius, distance, intensity);
+    case te::sa::Normal:
+      kernelValue = KernelNormal(tau, distance, intensity);
+      break;
+    case te::sa::Triangular:
+      kernelValue = KernelTriangular(tau, distance, intensity);
+      break;
+    case te::sa::Negative_Exp:
+      kernelValue = KernelNegExponential(tau, distance, intensity);
+      break;
+    case te::sa::Uniform:
+      kernelValue = KernelUniform(tau, distance, intensity);
       break;
-    }
-
-    kernelValue += localK; 
   }
 
   return kernelValue;
 }
 
+double te::sa::KernelSupport(te::sa::KernelFunctionType type, double tau, double tolerance)
+{
+  if(type != te::sa::Normal)
+    return tau;
+
+  if(tolerance <= 0.)
+    return std::numeric_limits<double>::max();
+
+  //exp(-d^2 / (2 tau^2)) < tolerance
+  return tau * std::sqrt(-2. * std::log(tolerance));
+}
+
 double te::sa::KernelRatioValue(te::sa::KernelOutputParams* params, double area, double kernelA, double kernelB)
 {
   double kernelValue = 0.;
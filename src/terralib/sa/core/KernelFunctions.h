@@ -162,6 +162,30 @@ namespace te
     */
     TESAEXPORT double KernelValue(te::sa::KernelInputParams* params, te::sa::KernelMap& kMap, double radius, te::gm::Coord2D& coord, std::vector<int> idxVec);
 
+    /*!
+      \brief Evaluates the kernel function of one event
+
+      \param type Kernel function type
+      \param tau spatial threshold to define neighboorhood
+      \param distance distance between event and region centroid
+      \param intensity attribute value for event
+
+      \return Kernel value
+    */
+    TESAEXPORT double KernelFunctionValue(te::sa::KernelFunctionType type, double tau, double distance, double intensity);
+
+    /*!
+      \brief Calculates the distance beyond which the kernel function is ignored
+
+      \param type Kernel function type
+      \param tau spatial threshold to define neighboorhood
+      \param tolerance Relative value, in [0, 1), of the kernel peak below which the Normal kernel is truncated (0: no truncation)
+
+      \return The radius for the kernels with a bounded support, the truncation distance for the Normal kernel or
+               std::numeric_limits<double>::max() if the Normal kernel is not truncated.
+    */
+    TESAEXPORT double KernelSupport(te::sa::KernelFunctionType type, double tau, double tolerance);
+
     /*!
       \brief Evaluates kernel ratio value
 
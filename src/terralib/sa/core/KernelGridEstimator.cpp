@@ -0,0 +1,677 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+  \file terralib/sa/core/KernelGridEstimator.cpp
+
+  \brief A multi-threaded engine that evaluates the kernel of the cells of a regular grid.
+*/
+
+// TerraLib
+#include "../../common/Exception.h"
+#include "../../common/PlatformUtils.h"
+#include "../../common/progress/TaskProgress.h"
+#include "../../core/translator/Translator.h"
+#include "../../geometry/Envelope.h"
+#include "../../geometry/Geometry.h"
+#include "KernelGridEstimator.h"
+#include "Utils.h"
+
+// STL
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+
+// Boost
+#include <boost/thread.hpp>
+
+namespace
+{
+  //the number of kernel samples on each side of the centre, bounded by the size of the binned grid
+  std::size_t GetHalfWidth(double support, double resolution, std::size_t size)
+  {
+    double halfWidth = std::floor(support / resolution);
+
+    if(halfWidth >= static_cast<double>(size))
+      return size;
+
+    return static_cast<std::size_t>(halfWidth);
+  }
+}
+
+struct te::sa::KernelGridEstimator::ThreadParams
+{
+  enum Pass
+  {
+    CELL_PASS,
+    ADAPTIVE_PASS,
+    HORIZONTAL_PASS,
+    VERTICAL_PASS,
+    STENCIL_PASS
+  };
+
+  ThreadParams();
+
+  const te::sa::KernelGridEstimator* m_estimator;
+  Pass m_pass;
+  std::size_t m_nRows;                      //!< The number of rows processed by the pass.
+  double m_radius;
+  double m_meanKernel;
+  double m_maxRadius;
+  const std::vector<double>* m_input;       //!< The previous values (adaptive pass), the binned grid or the horizontal pass output.
+  const std::vector<char>* m_binnedRows;    //!< True for the rows of the binned grid with events.
+  std::vector<double>* m_output;
+  std::vector<double> m_weightsX;           //!< The horizontal weights (separable kernel).
+  std::vector<double> m_weightsY;           //!< The vertical weights (separable kernel).
+  std::vector<double> m_stencil;            //!< The 2D stencil, in row order.
+  std::vector<std::size_t> m_stencilSpan;   //!< The first and last non-zero column of each stencil row.
+  std::size_t m_halfWidthX;
+  std::size_t m_halfWidthY;
+  double m_peak;                            //!< The kernel value at the distance zero (separable kernel).
+  std::size_t m_nStrips;
+  std::size_t m_nextStrip;
+  std::size_t m_processedStrips;
+  unsigned int m_runningThreads;
+  bool m_abort;
+  bool m_failed;
+  std::string m_errorMessage;
+  te::common::TaskProgress* m_task;         //!< The task, if it is pulsed by the pool thread.
+  boost::mutex m_mutex;                     //!< It protects the members above.
+  boost::condition_variable m_condVar;
+};
+
+te::sa::KernelGridEstimator::ThreadParams::ThreadParams()
+  : m_estimator(0),
+    m_pass(CELL_PASS),
+    m_nRows(0),
+    m_radius(0.),
+    m_meanKernel(0.),
+    m_maxRadius(0.),
+    m_input(0),
+    m_binnedRows(0),
+    m_output(0),
+    m_halfWidthX(0),
+    m_halfWidthY(0),
+    m_peak(0.),
+    m_nStrips(0),
+    m_nextStrip(0),
+    m_processedStrips(0),
+    m_runningThreads(0),
+    m_abort(false),
+    m_failed(false),
+    m_task(0)
+{
+}
+
+te::sa::KernelGridEstimator::KernelGridEstimator(const te::sa::KernelInputParams& params, te::sa::KernelMap& kMap, const te::rst::Grid& grid)
+  : m_grid(grid),
+    m_functionType(params.m_functionType),
+    m_tolerance(params.m_tolerance),
+    m_maxThreads(params.m_maxThreads)
+{
+  if(m_tolerance < 0. || m_tolerance >= 1.)
+    throw te::common::Exception(TE_TR("The kernel tolerance must be in the interval [0, 1)."));
+
+  m_x.reserve(kMap.size());
+  m_y.reserve(kMap.size());
+  m_intensity.reserve(kMap.size());
+
+  std::vector<te::sam::rtree::Index<std::size_t>::ItemType> items;
+  items.reserve(kMap.size());
+
+  for(te::sa::KernelMap::iterator it = kMap.begin(); it != kMap.end(); ++it)
+  {
+    te::gm::Geometry* g = it->second.first;
+
+    //the distance to other geometry types is not defined
+    if(!g || (g->getGeomTypeId() != te::gm::PointType && g->getGeomTypeId() != te::gm::PolygonType &&
+              g->getGeomTypeId() != te::gm::MultiPolygonType))
+      continue;
+
+    te::gm::Coord2D coord = te::sa::GetCentroidCoord(g);
+
+    items.push_back(te::sam::rtree::Index<std::size_t>::ItemType(te::gm::Envelope(coord.x, coord.y, coord.x, coord.y), m_x.size()));
+
+    m_x.push_back(coord.x);
+    m_y.push_back(coord.y);
+    m_intensity.push_back(it->second.second);
+  }
+
+  m_tree.bulkLoad(items);
+}
+
+te::sa::KernelGridEstimator::~KernelGridEstimator()
+{
+}
+
+bool te::sa::KernelGridEstimator::cellKernel(double radius, std::vector<double>& values, te::common::TaskProgress* task) const
+{
+  ThreadParams params;
+  params.m_estimator = this;
+  params.m_pass = ThreadParams::CELL_PASS;
+  params.m_nRows = m_grid.getNumberOfRows();
+  params.m_radius = radius;
+  params.m_output = &values;
+
+  values.assign(static_cast<std::size_t>(m_grid.getNumberOfRows()) * m_grid.getNumberOfColumns(), 0.);
+
+  if(task)
+    task->setTotalSteps(static_cast<int>((params.m_nRows + sm_stripSize - 1) / sm_stripSize));
+
+  return run(params, task);
+}
+
+bool te::sa::KernelGridEstimator::adaptiveCellKernel(double radius, double meanKernel, double maxRadius,
+                                                     const std::vector<double>& prevValues, std::vector<double>& values,
+                                                     te::common::TaskProgress* task) const
+{
+  const std::size_t nCells = static_cast<std::size_t>(m_grid.getNumberOfRows()) * m_grid.getNumberOfColumns();
+
+  if(prevValues.size() != nCells)
+    throw te::common::Exception(TE_TR("The number of kernel values must be the number of cells."));
+
+  ThreadParams params;
+  params.m_estimator = this;
+  params.m_pass = ThreadParams::ADAPTIVE_PASS;
+  params.m_nRows = m_grid.getNumberOfRows();
+  params.m_radius = radius;
+  params.m_meanKernel = meanKernel;
+  params.m_maxRadius = maxRadius;
+  params.m_input = &prevValues;
+  params.m_output = &values;
+
+  values.assign(nCells, 0.);
+
+  if(task)
+    task->setTotalSteps(static_cast<int>((params.m_nRows + sm_stripSize - 1) / sm_stripSize));
+
+  return run(params, task);
+}
+
+bool te::sa::KernelGridEstimator::convolutionKernel(double radius, std::vector<double>& values, te::common::TaskProgress* task) const
+{
+  const std::size_t nRows = m_grid.getNumberOfRows();
+  const std::size_t nCols = m_grid.getNumberOfColumns();
+
+  //the binned grid has a border of one cell, so every event of the grid extent has its four cell centres
+  const std::size_t nBinnedRows = nRows + 2;
+  const std::size_t nBinnedCols = nCols + 2;
+
+  values.assign(nRows * nCols, 0.);
+
+  if(nRows == 0 || nCols == 0)
+    return true;
+
+  //linear binning: the intensity of each event is split among its four nearest cell centres
+  std::vector<double> binned(nBinnedRows * nBinnedCols, 0.);
+  std::vector<char> binnedRows(nBinnedRows, 0);
+
+  for(std::size_t e = 0; e < m_x.size(); ++e)
+  {
+    double col = 0.;
+    double row = 0.;
+
+    m_grid.geoToGrid(m_x[e], m_y[e], col, row);
+
+    //the events outside the grid are moved to its border
+    col = std::min(std::max(col + 1., 0.), static_cast<double>(nBinnedCols - 1));
+    row = std::min(std::max(row + 1., 0.), static_cast<double>(nBinnedRows - 1));
+
+    std::size_t c0 = std::min(static_cast<std::size_t>(col), nBinnedCols - 2);
+    std::size_t r0 = std::min(static_cast<std::size_t>(row), nBinnedRows - 2);
+
+    double fx = col - static_cast<double>(c0);
+    double fy = row - static_cast<double>(r0);
+
+    double* first = &binned[r0 * nBinnedCols + c0];
+    double* second = first + nBinnedCols;
+
+    first[0] += m_intensity[e] * (1. - fx) * (1. - fy);
+    first[1] += m_intensity[e] * fx * (1. - fy);
+    second[0] += m_intensity[e] * (1. - fx) * fy;
+    second[1] += m_intensity[e] * fx * fy;
+
+    binnedRows[r0] = 1;
+    binnedRows[r0 + 1] = 1;
+  }
+
+  double support = te::sa::KernelSupport(m_functionType, radius, m_tolerance);
+
+  ThreadParams params;
+  params.m_estimator = this;
+  params.m_radius = radius;
+  params.m_binnedRows = &binnedRows;
+  params.m_halfWidthX = GetHalfWidth(support, m_grid.getResolutionX(), nBinnedCols);
+  params.m_halfWidthY = GetHalfWidth(support, m_grid.getResolutionY(), nBinnedRows);
+
+  const std::size_t nStrips = (nRows + sm_stripSize - 1) / sm_stripSize;
+
+  if(m_functionType == te::sa::Normal)
+  {
+    //the Normal kernel is the product of a horizontal and a vertical Gaussian
+    params.m_peak = te::sa::KernelNormal(radius, 0., 1.);
+
+    params.m_weightsX.resize(params.m_halfWidthX + 1);
+    params.m_weightsY.resize(params.m_halfWidthY + 1);
+
+    for(std::size_t b = 0; b <= params.m_halfWidthX; ++b)
+    {
+      double d = static_cast<double>(b) * m_grid.getResolutionX();
+
+      params.m_weightsX[b] = std::exp(-(d * d) / (2. * radius * radius));
+    }
+
+    for(std::size_t a = 0; a <= params.m_halfWidthY; ++a)
+    {
+      double d = static_cast<double>(a) * m_grid.getResolutionY();
+
+      params.m_weightsY[a] = std::exp(-(d * d) / (2. * radius * radius));
+    }
+
+    if(task)
+      task->setTotalSteps(static_cast<int>((nBinnedRows + sm_stripSize - 1) / sm_stripSize + nStrips));
+
+    //horizontal pass, over all rows of the binned grid
+    std::vector<double> horizontal(nBinnedRows * nCols, 0.);
+
+    params.m_pass = ThreadParams::HORIZONTAL_PASS;
+    params.m_nRows = nBinnedRows;
+    params.m_input = &binned;
+    params.m_output = &horizontal;
+
+    if(!run(params, task))
+      return false;
+
+    //vertical pass
+    params.m_pass = ThreadParams::VERTICAL_PASS;
+    params.m_nRows = nRows;
+    params.m_input = &horizontal;
+    params.m_output = &values;
+
+    return run(params, task);
+  }
+
+  //the other kernels are sampled in a 2D stencil over their support
+  const std::size_t stencilCols = 2 * params.m_halfWidthX + 1;
+  const std::size_t stencilRows = 2 * params.m_halfWidthY + 1;
+
+  params.m_stencil.resize(stencilRows * stencilCols, 0.);
+  params.m_stencilSpan.resize(2 * stencilRows, 0);
+
+  for(std::size_t a = 0; a < stencilRows; ++a)
+  {
+    double dy = (static_cast<double>(a) - static_cast<double>(params.m_halfWidthY)) * m_grid.getResolutionY();
+
+    std::size_t first = stencilCols;
+    std::size_t last = 0;
+
+    for(std::size_t b = 0; b < stencilCols; ++b)
+    {
+      double dx = (static_cast<double>(b) - static_cast<double>(params.m_halfWidthX)) * m_grid.getResolutionX();
+
+      double w = te::sa::KernelFunctionValue(m_functionType, radius, std::sqrt(dx * dx + dy * dy), 1.);
+
+      params.m_stencil[a * stencilCols + b] = w;
+
+      if(w != 0.)
+      {
+        first = std::min(first, b);
+        last = b;
+      }
+    }
+
+    params.m_stencilSpan[2 * a] = first;
+    params.m_stencilSpan[2 * a + 1] = last;
+  }
+
+  if(task)
+    task->setTotalSteps(static_cast<int>(nStrips));
+
+  params.m_pass = ThreadParams::STENCIL_PASS;
+  params.m_nRows = nRows;
+  params.m_input = &binned;
+  params.m_output = &values;
+
+  return run(params, task);
+}
+
+bool te::sa::KernelGridEstimator::run(ThreadParams& params, te::common::TaskProgress* task) const
+{
+  params.m_nStrips = (params.m_nRows + sm_stripSize - 1) / sm_stripSize;
+  params.m_nextStrip = 0;
+  params.m_processedStrips = 0;
+  params.m_task = 0;
+
+  if(params.m_nStrips == 0)
+    return true;
+
+  unsigned int threadsNumber = m_maxThreads ? m_maxThreads : te::common::GetPhysProcNumber();
+  threadsNumber = std::max(threadsNumber, 1u);
+  threadsNumber = static_cast<unsigned int>(std::min(static_cast<std::size_t>(threadsNumber), params.m_nStrips));
+
+  if(threadsNumber == 1)
+  {
+    params.m_task = task;
+    params.m_runningThreads = 1;
+
+    ThreadEntry(&params);
+  }
+  else
+  {
+    params.m_runningThreads = threadsNumber;
+
+    boost::thread_group threads;
+
+    for(unsigned int i = 0; i < threadsNumber; ++i)
+      threads.add_thread(new boost::thread(ThreadEntry, &params));
+
+    //the task is only used by this thread
+    {
+      boost::unique_lock<boost::mutex> lock(params.m_mutex);
+
+      std::size_t pulsedStrips = 0;
+
+      while(params.m_runningThreads)
+      {
+        params.m_condVar.wait(lock);
+
+        if(task)
+        {
+          for(; pulsedStrips < params.m_processedStrips; ++pulsedStrips)
+            task->pulse();
+
+          if(!task->isActive())
+            params.m_abort = true;
+        }
+      }
+    }
+
+    threads.join_all();
+  }
+
+  if(params.m_failed)
+    throw te::common::Exception(TE_TR("Could not calculate the kernel: ") + params.m_errorMessage);
+
+  return !params.m_abort;
+}
+
+void te::sa::KernelGridEstimator::ThreadEntry(ThreadParams* params)
+{
+  //the buffer of this thread
+  std::vector<std::size_t> results;
+
+  try
+  {
+    while(true)
+    {
+      std::size_t strip = 0;
+
+      {
+        boost::lock_guard<boost::mutex> lock(params->m_mutex);
+
+        if(params->m_task && !params->m_task->isActive())
+          params->m_abort = true;
+
+        if(params->m_abort || (params->m_nextStrip >= params->m_nStrips))
+          break;
+
+        strip = params->m_nextStrip++;
+      }
+
+      switch(params->m_pass)
+      {
+        case ThreadParams::CELL_PASS:
+        case ThreadParams::ADAPTIVE_PASS:
+          params->m_estimator->cellStrip(*params, strip, results);
+          break;
+
+        case ThreadParams::HORIZONTAL_PASS:
+          params->m_estimator->horizontalStrip(*params, strip);
+          break;
+
+        case ThreadParams::VERTICAL_PASS:
+          params->m_estimator->verticalStrip(*params, strip);
+          break;
+
+        case ThreadParams::STENCIL_PASS:
+          params->m_estimator->stencilStrip(*params, strip);
+          break;
+      }
+
+      {
+        boost::lock_guard<boost::mutex> lock(params->m_mutex);
+
+        ++params->m_processedStrips;
+
+        if(params->m_task)
+          params->m_task->pulse();
+      }
+
+      params->m_condVar.notify_one();
+    }
+  }
+  catch(const std::exception& e)
+  {
+    boost::lock_guard<boost::mutex> lock(params->m_mutex);
+
+    params->m_abort = true;
+    params->m_failed = true;
+    params->m_errorMessage = e.what();
+  }
+  catch(...)
+  {
+    boost::lock_guard<boost::mutex> lock(params->m_mutex);
+
+    params->m_abort = true;
+    params->m_failed = true;
+  }
+
+  {
+    boost::lock_guard<boost::mutex> lock(params->m_mutex);
+
+    --params->m_runningThreads;
+  }
+
+  params->m_condVar.notify_one();
+}
+
+void te::sa::KernelGridEstimator::cellStrip(ThreadParams& params, std::size_t strip, std::vector<std::size_t>& results) const
+{
+  const std::size_t nCols = m_grid.getNumberOfColumns();
+  const std::size_t firstRow = strip * sm_stripSize;
+  const std::size_t lastRow = std::min(firstRow + sm_stripSize, params.m_nRows);
+
+  std::vector<double>& values = *params.m_output;
+
+  for(std::size_t i = firstRow; i < lastRow; ++i)
+  {
+    for(std::size_t j = 0; j < nCols; ++j)
+    {
+      std::size_t cell = i * nCols + j;
+
+      double radius = params.m_radius;
+
+      if(params.m_pass == ThreadParams::ADAPTIVE_PASS)
+      {
+        double prevKernel = (*params.m_input)[cell];
+
+        if(prevKernel <= 0.)
+          continue;
+
+        //set new radius value
+        radius = params.m_radius * std::pow((params.m_meanKernel / prevKernel), 0.5);
+
+        //limit the radius
+        if(radius > params.m_maxRadius)
+          radius = params.m_maxRadius;
+      }
+
+      te::gm::Coord2D coord = m_grid.gridToGeo(static_cast<double>(j), static_cast<double>(i));
+
+      values[cell] = cellValue(coord.x, coord.y, radius, results);
+    }
+  }
+}
+
+void te::sa::KernelGridEstimator::horizontalStrip(ThreadParams& params, std::size_t strip) const
+{
+  const std::size_t nCols = m_grid.getNumberOfColumns();
+  const std::size_t nBinnedCols = nCols + 2;
+  const std::size_t firstRow = strip * sm_stripSize;
+  const std::size_t lastRow = std::min(firstRow + sm_stripSize, params.m_nRows);
+  const long halfWidth = static_cast<long>(params.m_halfWidthX);
+
+  for(std::size_t r = firstRow; r < lastRow; ++r)
+  {
+    if(!(*params.m_binnedRows)[r])
+      continue;
+
+    const double* in = &(*params.m_input)[r * nBinnedCols];
+    double* out = &(*params.m_output)[r * nCols];
+
+    //the output column j is centred on the binned column j + 1
+    for(long b = -halfWidth; b <= halfWidth; ++b)
+    {
+      double w = params.m_weightsX[static_cast<std::size_t>(b < 0 ? -b : b)];
+
+      long first = std::max(0L, -1L - b);
+      long last = std::min(static_cast<long>(nCols) - 1L, static_cast<long>(nBinnedCols) - 2L - b);
+
+      for(long j = first; j <= last; ++j)
+        out[j] += w * in[j + 1 + b];
+    }
+  }
+}
+
+void te::sa::KernelGridEstimator::verticalStrip(ThreadParams& params, std::size_t strip) const
+{
+  const std::size_t nCols = m_grid.getNumberOfColumns();
+  const long nBinnedRows = static_cast<long>(m_grid.getNumberOfRows()) + 2L;
+  const std::size_t firstRow = strip * sm_stripSize;
+  const std::size_t lastRow = std::min(firstRow + sm_stripSize, params.m_nRows);
+  const long halfWidth = static_cast<long>(params.m_halfWidthY);
+
+  for(std::size_t i = firstRow; i < lastRow; ++i)
+  {
+    double* out = &(*params.m_output)[i * nCols];
+
+    //the output row i is centred on the binned row i + 1
+    for(long a = -halfWidth; a <= halfWidth; ++a)
+    {
+      long r = static_cast<long>(i) + 1L + a;
+
+      if(r < 0 || r >= nBinnedRows || !(*params.m_binnedRows)[r])
+        continue;
+
+      double w = params.m_peak * params.m_weightsY[static_cast<std::size_t>(a < 0 ? -a : a)];
+
+      const double* in = &(*params.m_input)[static_cast<std::size_t>(r) * nCols];
+
+      for(std::size_t j = 0; j < nCols; ++j)
+        out[j] += w * in[j];
+    }
+  }
+}
+
+void te::sa::KernelGridEstimator::stencilStrip(ThreadParams& params, std::size_t strip) const
+{
+  const std::size_t nCols = m_grid.getNumberOfColumns();
+  const std::size_t nBinnedCols = nCols + 2;
+  const long nBinnedRows = static_cast<long>(m_grid.getNumberOfRows()) + 2L;
+  const std::size_t firstRow = strip * sm_stripSize;
+  const std::size_t lastRow = std::min(firstRow + sm_stripSize, params.m_nRows);
+  const long halfWidthX = static_cast<long>(params.m_halfWidthX);
+  const long halfWidthY = static_cast<long>(params.m_halfWidthY);
+  const std::size_t stencilCols = 2 * params.m_halfWidthX + 1;
+
+  for(std::size_t i = firstRow; i < lastRow; ++i)
+  {
+    double* out = &(*params.m_output)[i * nCols];
+
+    for(long a = -halfWidthY; a <= halfWidthY; ++a)
+    {
+      long r = static_cast<long>(i) + 1L + a;
+
+      if(r < 0 || r >= nBinnedRows || !(*params.m_binnedRows)[r])
+        continue;
+
+      std::size_t stencilRow = static_cast<std::size_t>(a + halfWidthY);
+
+      const double* in = &(*params.m_input)[static_cast<std::size_t>(r) * nBinnedCols];
+      const double* w = &params.m_stencil[stencilRow * stencilCols];
+
+      long firstB = static_cast<long>(params.m_stencilSpan[2 * stencilRow]) - halfWidthX;
+      long lastB = static_cast<long>(params.m_stencilSpan[2 * stencilRow + 1]) - halfWidthX;
+
+      for(long b = firstB; b <= lastB; ++b)
+      {
+        double wb = w[b + halfWidthX];
+
+        long first = std::max(0L, -1L - b);
+        long last = std::min(static_cast<long>(nCols) - 1L, static_cast<long>(nBinnedCols) - 2L - b);
+
+        for(long j = first; j <= last; ++j)
+          out[j] += wb * in[j + 1 + b];
+      }
+    }
+  }
+}
+
+double te::sa::KernelGridEstimator::cellValue(double x, double y, double radius, std::vector<std::size_t>& results) const
+{
+  double support = te::sa::KernelSupport(m_functionType, radius, m_tolerance);
+
+  double kernelValue = 0.;
+
+  if(support == std::numeric_limits<double>::max())
+  {
+    //the kernel is not truncated: all events are used
+    for(std::size_t e = 0; e < m_x.size(); ++e)
+    {
+      double dx = m_x[e] - x;
+      double dy = m_y[e] - y;
+
+      kernelValue += te::sa::KernelFunctionValue(m_functionType, radius, std::sqrt(dx * dx + dy * dy), m_intensity[e]);
+    }
+
+    return kernelValue;
+  }
+
+  results.clear();
+
+  m_tree.search(te::gm::Envelope(x - support, y - support, x + support, y + support), results);
+
+  for(std::size_t t = 0; t < results.size(); ++t)
+  {
+    std::size_t e = results[t];
+
+    double dx = m_x[e] - x;
+    double dy = m_y[e] - y;
+
+    double distance = std::sqrt(dx * dx + dy * dy);
+
+    if(distance > support)
+      continue;
+
+    kernelValue += te::sa::KernelFunctionValue(m_functionType, radius, distance, m_intensity[e]);
+  }
+
+  return kernelValue;
+}
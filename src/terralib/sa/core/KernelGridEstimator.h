@@ -0,0 +1,175 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+  \file terralib/sa/core/KernelGridEstimator.h
+
+  \brief A multi-threaded engine that evaluates the kernel of the cells of a regular grid.
+*/
+
+#ifndef __TERRALIB_SA_INTERNAL_KERNELGRIDESTIMATOR_H
+#define __TERRALIB_SA_INTERNAL_KERNELGRIDESTIMATOR_H
+
+// TerraLib
+#include "../../raster/Grid.h"
+#include "../../sam/rtree/Index.h"
+#include "../Config.h"
+#include "../Enums.h"
+#include "KernelFunctions.h"
+
+// STL
+#include <cstddef>
+#include <vector>
+
+// Boost
+#include <boost/noncopyable.hpp>
+
+namespace te
+{
+  namespace common { class TaskProgress; }
+
+  namespace sa
+  {
+    /*!
+      \class KernelGridEstimator
+
+      \brief A multi-threaded engine that evaluates the kernel of the cells of a regular grid.
+
+      The events are reduced, once, to the coordinates of their centroids and
+      their intensities, indexed by an R-tree. The grid rows are split in
+      strips of sm_stripSize rows that are processed by a pool of threads and
+      the kernel values are returned in a dense array, in row order, so
+      the raster is only written by the calling thread.
+
+      The cell evaluation computes the kernel of each cell from the events
+      inside the kernel support. The Normal kernel has an infinite support:
+      it is truncated where it falls below a tolerance of its peak value.
+
+      The grid convolution distributes the intensity of each event over the
+      four nearest cell centres (linear binning) and convolves the binned
+      grid with the kernel sampled at the cell centres. The Normal kernel is
+      separable, so it is applied as a horizontal and a vertical pass, with a
+      cost that does not depend on the number of events. The other kernels
+      are applied as a 2D stencil over the kernel support. The binning
+      moves each event by less than one cell, so the convolution is an
+      approximation of the cell evaluation that improves as the radius grows
+      compared with the cell size. It is best suited to the smooth kernels
+      (Normal and Quartic): the discontinuities of the other kernels are
+      smoothed by the binning.
+
+      \sa KernelFunctions.h, KernelOperation
+    */
+    class TESAEXPORT KernelGridEstimator : public boost::noncopyable
+    {
+      public:
+
+        /*!
+          \brief Constructor.
+
+          \param params The kernel input parameters (function type, tolerance and number of threads).
+          \param kMap   The kernel map with the events.
+          \param grid   The output grid.
+
+          \exception te::common::Exception It throws an exception if the tolerance is not in [0, 1).
+        */
+        KernelGridEstimator(const te::sa::KernelInputParams& params, te::sa::KernelMap& kMap, const te::rst::Grid& grid);
+
+        /*! \brief Destructor. */
+        ~KernelGridEstimator();
+
+        /*!
+          \brief It evaluates the kernel of each cell with a fixed radius.
+
+          \param radius The kernel radius.
+          \param values The kernel value of each cell, in row order.
+          \param task   An optional task: its total steps are set to the number of strips.
+
+          \return False if the task was canceled.
+        */
+        bool cellKernel(double radius, std::vector<double>& values, te::common::TaskProgress* task = 0) const;
+
+        /*!
+          \brief It evaluates the kernel of each cell with a radius adapted to a previous kernel value of the cell.
+
+          \param radius     The fixed kernel radius.
+          \param meanKernel The geometric mean of the event intensities.
+          \param maxRadius  The maximum adapted radius.
+          \param prevValues The previous kernel value of each cell, in row order.
+          \param values     The kernel value of each cell, in row order (zero if the previous value is not positive).
+          \param task       An optional task: its total steps are set to the number of strips.
+
+          \return False if the task was canceled.
+        */
+        bool adaptiveCellKernel(double radius, double meanKernel, double maxRadius,
+                                const std::vector<double>& prevValues, std::vector<double>& values,
+                                te::common::TaskProgress* task = 0) const;
+
+        /*!
+          \brief It evaluates the kernel of each cell with a fixed radius by a convolution of the binned events.
+
+          \param radius The kernel radius.
+          \param values The kernel value of each cell, in row order.
+          \param task   An optional task: its total steps are set to the number of strips of all passes.
+
+          \return False if the task was canceled.
+        */
+        bool convolutionKernel(double radius, std::vector<double>& values, te::common::TaskProgress* task = 0) const;
+
+        static const std::size_t sm_stripSize = 16;   //!< The number of rows of a strip.
+
+      private:
+
+        struct ThreadParams;
+
+        /*! \brief It processes the strips of a pass in the pool of threads. */
+        bool run(ThreadParams& params, te::common::TaskProgress* task) const;
+
+        static void ThreadEntry(ThreadParams* params);
+
+        /*! \brief It evaluates the kernel of the cells of a strip. */
+        void cellStrip(ThreadParams& params, std::size_t strip, std::vector<std::size_t>& results) const;
+
+        /*! \brief It convolves the binned rows of a strip with the horizontal weights. */
+        void horizontalStrip(ThreadParams& params, std::size_t strip) const;
+
+        /*! \brief It convolves the rows of a strip with the vertical weights. */
+        void verticalStrip(ThreadParams& params, std::size_t strip) const;
+
+        /*! \brief It convolves the rows of a strip with the 2D stencil. */
+        void stencilStrip(ThreadParams& params, std::size_t strip) const;
+
+        /*! \brief It returns the kernel value of a cell from the events inside the kernel support. */
+        double cellValue(double x, double y, double radius, std::vector<std::size_t>& results) const;
+
+      private:
+
+        te::rst::Grid m_grid;                       //!< The output grid.
+        te::sa::KernelFunctionType m_functionType;  //!< The kernel function type.
+        double m_tolerance;                         //!< The truncation tolerance of the Normal kernel.
+        unsigned int m_maxThreads;                  //!< The maximum number of threads.
+        std::vector<double> m_x;                    //!< The x coordinate of each event.
+        std::vector<double> m_y;                    //!< The y coordinate of each event.
+        std::vector<double> m_intensity;            //!< The intensity of each event.
+        te::sam::rtree::Index<std::size_t> m_tree;  //!< The events indexed by their coordinates.
+    };
+
+  } // end namespace sa
+}   // end namespace te
+
+#endif  // __TERRALIB_SA_INTERNAL_KERNELGRIDESTIMATOR_H
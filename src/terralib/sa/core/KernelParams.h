@@ -63,6 +63,9 @@ namespace te
           m_estimationType = te::sa::Density;
           m_useAdaptativeRadius = true;
           m_radiusPercentValue = 10;
+          m_algorithm = te::sa::Cell_Evaluation;
+          m_tolerance = 1.e-6;
+          m_maxThreads = 0;
         }
 
         /*! \brief Virtual destructor. */
@@ -82,6 +85,10 @@ namespace te
 
         bool m_useAdaptativeRadius;                       //!< Attribute to indicate if a an adaptative radius has to be used.
         int  m_radiusPercentValue;                        //!< Attribute with radius percent value (m_useAdaptativeRadius must be false)
+
+        te::sa::KernelAlgorithmType m_algorithm;          //!< Algorithm used to evaluate the kernel of a grid with a fixed radius (the adaptative radius is evaluated cell by cell)
+        double m_tolerance;                               //!< Relative value, in [0, 1), below which the Normal kernel is truncated (0: no truncation)
+        unsigned int m_maxThreads;                        //!< Maximum number of threads used to evaluate the kernel of a grid (0: the number of processors)
     };
 
     /*!
@@ -0,0 +1,455 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+  \file terralib/sa/core/PermutationTest.cpp
+
+  \brief A multi-threaded engine for the permutation tests of the Moran indexes.
+*/
+
+// TerraLib
+#include "../../common/Exception.h"
+#include "../../common/PlatformUtils.h"
+#include "../../common/progress/TaskProgress.h"
+#include "../../core/translator/Translator.h"
+#include "PermutationTest.h"
+#include "SpatialWeightsMatrix.h"
+
+// STL
+#include <algorithm>
+#include <string>
+
+// Boost
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_int_distribution.hpp>
+#include <boost/thread.hpp>
+
+namespace
+{
+  //the seed of the random stream of a block (a splitmix64 step of the engine seed and the block number)
+  boost::uint32_t StreamSeed(boost::uint32_t seed, std::size_t block)
+  {
+    boost::uint64_t z = (static_cast<boost::uint64_t>(seed) << 32) + static_cast<boost::uint64_t>(block);
+
+    z += 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z = z ^ (z >> 31);
+
+    return static_cast<boost::uint32_t>(z ^ (z >> 32));
+  }
+
+  void CheckValues(const std::vector<double>& values, std::size_t nVertices)
+  {
+    if(values.size() != nVertices)
+      throw te::common::Exception(TE_TR("The number of values must be the number of vertices of the spatial weights matrix."));
+
+    for(std::size_t i = 0; i < values.size(); ++i)
+    {
+      if(values[i] != values[i])
+        throw te::common::Exception(TE_TR("The permutation tests do not support missing values."));
+    }
+  }
+}
+
+struct te::sa::PermutationTest::ThreadParams
+{
+  ThreadParams();
+
+  const te::sa::PermutationTest* m_test;
+  bool m_local;                             //!< True for the local test.
+  const std::vector<double>* m_values;      //!< The centered values (global test) or the deviations (local test).
+  const std::vector<double>* m_lisa;        //!< The local indexes (local test).
+  double m_variance;
+  std::size_t m_permutationsNumber;
+  std::vector<double>* m_results;           //!< The index of each permutation (global test) or the significance of each vertex (local test).
+  std::size_t m_nBlocks;
+  std::size_t m_nextBlock;
+  std::size_t m_processedBlocks;
+  unsigned int m_runningThreads;
+  bool m_abort;
+  bool m_failed;
+  std::string m_errorMessage;
+  te::common::TaskProgress* m_task;         //!< The task, if it is pulsed by the pool thread.
+  boost::mutex m_mutex;                     //!< It protects the members above.
+  boost::condition_variable m_condVar;
+};
+
+te::sa::PermutationTest::ThreadParams::ThreadParams()
+  : m_test(0),
+    m_local(false),
+    m_values(0),
+    m_lisa(0),
+    m_variance(0.),
+    m_permutationsNumber(0),
+    m_results(0),
+    m_nBlocks(0),
+    m_nextBlock(0),
+    m_processedBlocks(0),
+    m_runningThreads(0),
+    m_abort(false),
+    m_failed(false),
+    m_task(0)
+{
+}
+
+te::sa::PermutationTest::PermutationTest(const SpatialWeightsMatrix& swm, boost::uint32_t seed, unsigned int maxThreads)
+  : m_swm(swm),
+    m_seed(seed),
+    m_maxThreads(maxThreads)
+{
+  if(!m_swm.hasWeights())
+    throw te::common::Exception(TE_TR("The gpm has no weight attribute."));
+
+  const std::vector<std::size_t>& offsets = m_swm.getOffsets();
+  const std::vector<double>& weights = m_swm.getWeights();
+
+  m_scaledWeights = weights;
+
+  for(std::size_t i = 0; i < m_swm.getNumberOfVertices(); ++i)
+  {
+    double weightSum = 0.;
+
+    for(std::size_t k = offsets[i]; k < offsets[i + 1]; ++k)
+      weightSum += weights[k];
+
+    if(weightSum == 0.)
+      continue;
+
+    for(std::size_t k = offsets[i]; k < offsets[i + 1]; ++k)
+      m_scaledWeights[k] /= weightSum;
+  }
+}
+
+te::sa::PermutationTest::~PermutationTest()
+{
+}
+
+bool te::sa::PermutationTest::globalMoran(const std::vector<double>& values, double mean, double variance,
+                                          int permutationsNumber, std::vector<double>& results,
+                                          te::common::TaskProgress* task) const
+{
+  CheckValues(values, m_swm.getNumberOfVertices());
+
+  std::vector<double> centered(values.size());
+
+  for(std::size_t i = 0; i < values.size(); ++i)
+    centered[i] = values[i] - mean;
+
+  results.assign(std::max(permutationsNumber, 0), 0.);
+
+  ThreadParams params;
+  params.m_test = this;
+  params.m_local = false;
+  params.m_values = &centered;
+  params.m_variance = variance;
+  params.m_permutationsNumber = results.size();
+  params.m_results = &results;
+  params.m_nBlocks = (results.size() + sm_blockSize - 1) / sm_blockSize;
+
+  return run(params, task);
+}
+
+bool te::sa::PermutationTest::lisaSignificance(const std::vector<double>& z, double variance,
+                                               const std::vector<double>& lisa, int permutationsNumber,
+                                               std::vector<double>& significance,
+                                               te::common::TaskProgress* task) const
+{
+  CheckValues(z, m_swm.getNumberOfVertices());
+  CheckValues(lisa, m_swm.getNumberOfVertices());
+
+  significance.assign(z.size(), 0.);
+
+  ThreadParams params;
+  params.m_test = this;
+  params.m_local = true;
+  params.m_values = &z;
+  params.m_lisa = &lisa;
+  params.m_variance = variance;
+  params.m_permutationsNumber = static_cast<std::size_t>(std::max(permutationsNumber, 0));
+  params.m_results = &significance;
+  params.m_nBlocks = (z.size() + sm_blockSize - 1) / sm_blockSize;
+
+  return run(params, task);
+}
+
+double te::sa::PermutationTest::GetGlobalSignificance(double moranIndex, const std::vector<double>& permutations)
+{
+  int permutationsNumber = static_cast<int>(permutations.size());
+  int position = 0;
+
+  for(int i = 0; i < permutationsNumber; i++)
+  {
+    if(moranIndex < permutations[i])
+      position++;
+  }
+
+  if(moranIndex >= 0)
+    return (double)(position+1)/(double)(permutationsNumber+1);
+  else
+    return (double)(permutationsNumber-position)/(double)(permutationsNumber+1);
+}
+
+bool te::sa::PermutationTest::run(ThreadParams& params, te::common::TaskProgress* task) const
+{
+  if(task)
+    task->setTotalSteps(static_cast<int>(params.m_nBlocks));
+
+  if(params.m_nBlocks == 0)
+    return true;
+
+  unsigned int threadsNumber = m_maxThreads ? m_maxThreads : te::common::GetPhysProcNumber();
+  threadsNumber = std::max(threadsNumber, 1u);
+  threadsNumber = static_cast<unsigned int>(std::min(static_cast<std::size_t>(threadsNumber), params.m_nBlocks));
+
+  if(threadsNumber == 1)
+  {
+    params.m_task = task;
+    params.m_runningThreads = 1;
+
+    ThreadEntry(&params);
+  }
+  else
+  {
+    params.m_runningThreads = threadsNumber;
+
+    boost::thread_group threads;
+
+    for(unsigned int i = 0; i < threadsNumber; ++i)
+      threads.add_thread(new boost::thread(ThreadEntry, &params));
+
+    //the task is only used by this thread
+    {
+      boost::unique_lock<boost::mutex> lock(params.m_mutex);
+
+      std::size_t pulsedBlocks = 0;
+
+      while(params.m_runningThreads)
+      {
+        params.m_condVar.wait(lock);
+
+        if(task)
+        {
+          for(; pulsedBlocks < params.m_processedBlocks; ++pulsedBlocks)
+            task->pulse();
+
+          if(!task->isActive())
+            params.m_abort = true;
+        }
+      }
+    }
+
+    threads.join_all();
+  }
+
+  if(params.m_failed)
+    throw te::common::Exception(TE_TR("Could not compute the permutations: ") + params.m_errorMessage);
+
+  return !params.m_abort;
+}
+
+void te::sa::PermutationTest::ThreadEntry(ThreadParams* params)
+{
+  //the buffers of this thread
+  std::vector<double> buffer;
+  std::vector<std::size_t> indexes;
+  std::vector<std::size_t> swaps;
+
+  try
+  {
+    while(true)
+    {
+      std::size_t block = 0;
+
+      {
+        boost::lock_guard<boost::mutex> lock(params->m_mutex);
+
+        if(params->m_task && !params->m_task->isActive())
+          params->m_abort = true;
+
+        if(params->m_abort || (params->m_nextBlock >= params->m_nBlocks))
+          break;
+
+        block = params->m_nextBlock++;
+      }
+
+      if(params->m_local)
+        params->m_test->lisaBlock(*params, block, indexes, swaps, buffer);
+      else
+        params->m_test->globalMoranBlock(*params, block, buffer);
+
+      {
+        boost::lock_guard<boost::mutex> lock(params->m_mutex);
+
+        ++params->m_processedBlocks;
+
+        if(params->m_task)
+          params->m_task->pulse();
+      }
+
+      params->m_condVar.notify_one();
+    }
+  }
+  catch(const std::exception& e)
+  {
+    boost::lock_guard<boost::mutex> lock(params->m_mutex);
+
+    params->m_abort = true;
+    params->m_failed = true;
+    params->m_errorMessage = e.what();
+  }
+  catch(...)
+  {
+    boost::lock_guard<boost::mutex> lock(params->m_mutex);
+
+    params->m_abort = true;
+    params->m_failed = true;
+  }
+
+  {
+    boost::lock_guard<boost::mutex> lock(params->m_mutex);
+
+    --params->m_runningThreads;
+  }
+
+  params->m_condVar.notify_one();
+}
+
+void te::sa::PermutationTest::globalMoranBlock(ThreadParams& params, std::size_t block, std::vector<double>& buffer) const
+{
+  const std::vector<std::size_t>& offsets = m_swm.getOffsets();
+  const std::vector<std::size_t>& neighbours = m_swm.getNeighbours();
+
+  const std::size_t n = params.m_values->size();
+
+  const double denominator = (n > 1) ? params.m_variance * (n - 1) : params.m_variance;
+
+  //each block shuffles the values from their original order, with its own random stream
+  boost::random::mt19937 gen(StreamSeed(m_seed, block));
+
+  buffer = *params.m_values;
+
+  const std::size_t first = block * sm_blockSize;
+  const std::size_t last = std::min(first + sm_blockSize, params.m_permutationsNumber);
+
+  for(std::size_t p = first; p < last; ++p)
+  {
+    //Fisher-Yates shuffle
+    for(std::size_t i = n; i > 1; --i)
+    {
+      boost::random::uniform_int_distribution<std::size_t> dist(0, i - 1);
+
+      std::swap(buffer[i - 1], buffer[dist(gen)]);
+    }
+
+    double moran = 0.;
+
+    for(std::size_t i = 0; i < n; ++i)
+    {
+      double wz = 0.;
+
+      for(std::size_t k = offsets[i]; k < offsets[i + 1]; ++k)
+        wz += m_scaledWeights[k] * buffer[neighbours[k]];
+
+      moran += buffer[i] * wz;
+    }
+
+    (*params.m_results)[p] = moran / denominator;
+  }
+}
+
+void te::sa::PermutationTest::lisaBlock(ThreadParams& params, std::size_t block, std::vector<std::size_t>& indexes,
+                                        std::vector<std::size_t>& swaps, std::vector<double>& buffer) const
+{
+  const std::vector<std::size_t>& offsets = m_swm.getOffsets();
+  const std::vector<double>& weights = m_swm.getWeights();
+
+  const std::vector<double>& z = *params.m_values;
+  const std::vector<double>& lisa = *params.m_lisa;
+  std::vector<double>& significance = *params.m_results;
+
+  const std::size_t n = z.size();
+  const std::size_t permutationsNumber = params.m_permutationsNumber;
+
+  //the indexes of the vertices, kept in order between the vertices
+  if(indexes.size() != n)
+  {
+    indexes.resize(n);
+
+    for(std::size_t i = 0; i < n; ++i)
+      indexes[i] = i;
+  }
+
+  buffer.resize(permutationsNumber);
+
+  boost::random::mt19937 gen(StreamSeed(m_seed, block));
+
+  const std::size_t first = block * sm_blockSize;
+  const std::size_t last = std::min(first + sm_blockSize, n);
+
+  for(std::size_t i = first; i < last; ++i)
+  {
+    //the neighbours are drawn from the first n-1 indexes: the vertex is moved to the end
+    std::swap(indexes[i], indexes[n - 1]);
+
+    const std::size_t nNeighbours = std::min(offsets[i + 1] - offsets[i], n - 1);
+    const double* w = nNeighbours ? &weights[offsets[i]] : 0;
+
+    swaps.resize(nNeighbours);
+
+    for(std::size_t p = 0; p < permutationsNumber; ++p)
+    {
+      double wz = 0.;
+
+      //partial Fisher-Yates shuffle of the other vertices
+      for(std::size_t t = 0; t < nNeighbours; ++t)
+      {
+        boost::random::uniform_int_distribution<std::size_t> dist(t, n - 2);
+
+        std::size_t j = dist(gen);
+
+        std::swap(indexes[t], indexes[j]);
+
+        swaps[t] = j;
+
+        wz += w[t] * z[indexes[t]];
+      }
+
+      for(std::size_t t = nNeighbours; t > 0; --t)
+        std::swap(indexes[t - 1], indexes[swaps[t - 1]]);
+
+      buffer[p] = (params.m_variance == 0.) ? 0. : z[i] * wz / params.m_variance;
+    }
+
+    std::swap(indexes[i], indexes[n - 1]);
+
+    std::size_t position = 0;
+
+    for(std::size_t p = 0; p < permutationsNumber; ++p)
+    {
+      if(lisa[i] > buffer[p])
+        ++position;
+    }
+
+    if(lisa[i] >= 0)
+      significance[i] = (double)(permutationsNumber - position) / (double)(permutationsNumber + 1);
+    else
+      significance[i] = (double)position / (double)(permutationsNumber + 1);
+  }
+}
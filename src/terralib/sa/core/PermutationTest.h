@@ -0,0 +1,166 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+  \file terralib/sa/core/PermutationTest.h
+
+  \brief A multi-threaded engine for the permutation tests of the Moran indexes.
+*/
+
+#ifndef __TERRALIB_SA_INTERNAL_PERMUTATIONTEST_H
+#define __TERRALIB_SA_INTERNAL_PERMUTATIONTEST_H
+
+// TerraLib
+#include "../Config.h"
+
+// STL
+#include <cstddef>
+#include <vector>
+
+// Boost
+#include <boost/cstdint.hpp>
+#include <boost/noncopyable.hpp>
+
+namespace te
+{
+  namespace common { class TaskProgress; }
+
+  namespace sa
+  {
+    // Forward declaration
+    class SpatialWeightsMatrix;
+
+    /*!
+      \class PermutationTest
+
+      \brief A multi-threaded engine for the permutation tests of the Moran indexes.
+
+      The permutations are split in blocks of sm_blockSize jobs (permutations
+      of the global index, vertices of the local index) that are processed by
+      a pool of threads. Each block draws its random numbers from its own
+      stream, seeded from the engine seed and the block number, so the
+      results only depend on the seed: they are the same for any number of
+      threads.
+
+      The global test shuffles a dense array of the centered values and
+      computes the index in a single pass over the CSR arrays, with the
+      weights of each row scaled by the row sum once.
+
+      The local test is conditional: the value of the vertex is fixed and
+      its neighbours are drawn, without repetition, from the values of the
+      other vertices.
+
+      \sa SpatialWeightsMatrix, SpatialStatisticsFunctions.h
+    */
+    class TESAEXPORT PermutationTest : public boost::noncopyable
+    {
+      public:
+
+        /*!
+          \brief Constructor.
+
+          \param swm        The spatial weights matrix, with weights. It must live while the engine is used.
+          \param seed       The seed of the random streams.
+          \param maxThreads The maximum number of threads (0: the number of processors).
+
+          \exception te::common::Exception It throws an exception if the matrix has no weights.
+        */
+        PermutationTest(const SpatialWeightsMatrix& swm, boost::uint32_t seed = sm_defaultSeed,
+                        unsigned int maxThreads = 0);
+
+        /*! \brief Destructor. */
+        ~PermutationTest();
+
+        /*!
+          \brief It computes the global Moran index of random permutations of a set of values.
+
+          \param values             One value for each vertex of the matrix.
+          \param mean               The mean of the values.
+          \param variance           The variance of the values.
+          \param permutationsNumber The number of permutations.
+          \param results            The index of each permutation.
+          \param task               An optional task: its total steps are set to the number of blocks.
+
+          \return False if the task was canceled.
+
+          \exception te::common::Exception It throws an exception if the values are not consistent with the matrix.
+        */
+        bool globalMoran(const std::vector<double>& values, double mean, double variance,
+                         int permutationsNumber, std::vector<double>& results,
+                         te::common::TaskProgress* task = 0) const;
+
+        /*!
+          \brief It computes the significance of the local Moran index of each vertex by conditional permutations.
+
+          \param z                  The deviation of the value of each vertex from the mean.
+          \param variance           The variance of the deviations.
+          \param lisa               The local Moran index of each vertex.
+          \param permutationsNumber The number of permutations of each vertex.
+          \param significance       The significance of each vertex.
+          \param task               An optional task: its total steps are set to the number of blocks.
+
+          \return False if the task was canceled.
+
+          \exception te::common::Exception It throws an exception if the values are not consistent with the matrix.
+        */
+        bool lisaSignificance(const std::vector<double>& z, double variance,
+                              const std::vector<double>& lisa, int permutationsNumber,
+                              std::vector<double>& significance,
+                              te::common::TaskProgress* task = 0) const;
+
+        /*!
+          \brief It returns the significance of an index from the indexes of the permutations.
+
+          \param moranIndex   The global Moran index.
+          \param permutations The indexes of the permutations.
+        */
+        static double GetGlobalSignificance(double moranIndex, const std::vector<double>& permutations);
+
+        static const boost::uint32_t sm_defaultSeed = 5489u;   //!< The default seed (the default of the Mersenne twister).
+
+        static const std::size_t sm_blockSize = 32;            //!< The number of permutations, or vertices, of a block.
+
+      private:
+
+        struct ThreadParams;
+
+        /*! \brief It processes the blocks in the pool of threads. */
+        bool run(ThreadParams& params, te::common::TaskProgress* task) const;
+
+        static void ThreadEntry(ThreadParams* params);
+
+        /*! \brief It computes the global indexes of the permutations of a block. */
+        void globalMoranBlock(ThreadParams& params, std::size_t block, std::vector<double>& buffer) const;
+
+        /*! \brief It computes the significance of the vertices of a block. */
+        void lisaBlock(ThreadParams& params, std::size_t block, std::vector<std::size_t>& indexes,
+                       std::vector<std::size_t>& swaps, std::vector<double>& buffer) const;
+
+      private:
+
+        const SpatialWeightsMatrix& m_swm;        //!< The spatial weights matrix.
+        boost::uint32_t m_seed;                   //!< The seed of the random streams.
+        unsigned int m_maxThreads;                //!< The maximum number of threads.
+        std::vector<double> m_scaledWeights;      //!< The weights divided by the sum of the weights of their rows.
+    };
+
+  } // end namespace sa
+}   // end namespace te
+
+#endif  // __TERRALIB_SA_INTERNAL_PERMUTATIONTEST_H
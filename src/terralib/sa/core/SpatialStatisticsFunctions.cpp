@@ -29,84 +29,98 @@
 #include "../../common/Exception.h"
 #include "../../core/translator/Translator.h"
 #include "../../common/progress/TaskProgress.h"
-#include "../../datatype/SimpleData.h"
-#include "../../graph/core/Edge.h"
-#include "../../graph/core/GraphMetadata.h"
-#include "../../graph/core/Vertex.h"
-#include "../../graph/iterator/MemoryIterator.h"
+#include "../../datatype/Enums.h"
+#include "../../graph/core/AbstractGraph.h"
 #include "GeneralizedProximityMatrix.h"
+#include "PermutationTest.h"
 #include "SpatialStatisticsFunctions.h"
-#include "StatisticsFunctions.h"
+#include "SpatialWeightsMatrix.h"
 #include "Utils.h"
 
 // STL
 #include <cassert>
+#include <vector>
 
-//BOOST
-#include <boost/random/mersenne_twister.hpp>
-#include <boost/random/uniform_int_distribution.hpp>
+namespace
+{
+  //it loads a vertex attribute of the gpm, searched by its name, as a column of the matrix
+  std::size_t LoadColumn(te::sa::SpatialWeightsMatrix& swm, te::sa::GeneralizedProximityMatrix* gpm, const std::string& attrName)
+  {
+    int attrIdx;
+    if(!te::sa::GetGraphVertexAttrIndex(gpm->getGraph(), attrName, attrIdx))
+      throw te::common::Exception(TE_TR("The gpm has no attribute: ") + attrName);
+
+    return swm.loadColumn(gpm, attrIdx);
+  }
 
+  //it searches a column of the matrix that must have been calculated by other function
+  std::size_t GetColumn(const te::sa::SpatialWeightsMatrix& swm, const std::string& name)
+  {
+    std::size_t idx;
+    if(!swm.getColumnIndex(name, idx))
+      throw te::common::Exception(TE_TR("The spatial weights matrix has no column: ") + name);
+
+    return idx;
+  }
+
+  void CheckWeights(const te::sa::SpatialWeightsMatrix& swm)
+  {
+    if(!swm.hasWeights())
+      throw te::common::Exception(TE_TR("The gpm has no weight attribute."));
+  }
+}
 
 void te::sa::GStatistics(te::sa::GeneralizedProximityMatrix* gpm, int attrIdx)
 {
   assert(gpm);
 
+  te::sa::SpatialWeightsMatrix swm;
+  swm.build(gpm);
+
+  te::sa::GStatistics(swm, swm.loadColumn(gpm, attrIdx));
+
+  swm.exportColumns(gpm);
+}
+
+void te::sa::GStatistics(te::sa::SpatialWeightsMatrix& swm, std::size_t column)
+{
+  //add G and G* columns into the matrix
+  std::size_t gColumn = swm.addColumn(TE_SA_G_ATTR_NAME, te::dt::DOUBLE_TYPE);
+  std::size_t gStarColumn = swm.addColumn(TE_SA_GSTAR_ATTR_NAME, te::dt::DOUBLE_TYPE);
+
   //calculate the sum of the selected attribute
-  double totalSum = te::sa::Sum(gpm, attrIdx);
+  double totalSum = swm.getSum(column);
 
-  te::graph::AbstractGraph* graph = gpm->getGraph();
+  const std::vector<double>& values = swm.getColumn(column);
+  std::vector<double>& gValues = swm.getColumn(gColumn);
+  std::vector<double>& gStarValues = swm.getColumn(gStarColumn);
 
-  //add G and G* attributes into gpm
-  int gAttrIdx = te::sa::AddGraphVertexAttribute(graph, TE_SA_G_ATTR_NAME, te::dt::DOUBLE_TYPE);
-  int gStarAttrIdx = te::sa::AddGraphVertexAttribute(graph, TE_SA_GSTAR_ATTR_NAME, te::dt::DOUBLE_TYPE);
-  int nAttrs = graph->getMetadata()->getVertexPropertySize();
+  const std::vector<std::size_t>& offsets = swm.getOffsets();
+  const std::vector<std::size_t>& neighbours = swm.getNeighbours();
 
-  //create graph vertex iterator
-  std::auto_ptr<te::graph::MemoryIterator> it(new te::graph::MemoryIterator(graph));
+  std::size_t nVertices = swm.getNumberOfVertices();
 
   //create task
   te::common::TaskProgress task;
 
-  task.setTotalSteps(it->getVertexInteratorCount());
+  task.setTotalSteps((int)nVertices);
   task.setMessage(TE_TR("Calculating G Statistics."));
 
-  te::graph::Vertex* v = it->getFirstVertex();
-
-  while(!it->isVertexIteratorAfterEnd())
+  for(std::size_t i = 0; i < nVertices; ++i)
   {
-    double attrValue = te::sa::GetDataValue(v->getAttributes()[attrIdx]);
+    double attrValue = values[i];
     double excludeSum = totalSum - attrValue;
     double G = 0.;
     double GStar = attrValue;
 
-    //get neighbours information
-    int id = v->getId();
-    std::set<int> neighbours = v->getSuccessors();
-    std::set<int>::iterator itNeighbours = neighbours.begin();
-    int nNeighbours = (int)neighbours.size();
+    int nNeighbours = (int)(offsets[i + 1] - offsets[i]);
 
-    while(itNeighbours != neighbours.end())
+    for(std::size_t k = offsets[i]; k < offsets[i + 1]; ++k)
     {
-      te::graph::Edge* e = graph->getEdge(*itNeighbours);
-      te::graph::Vertex* vTo = 0;
-
-      if(e)
-      {
-        if(e->getIdFrom() == id)
-          vTo = graph->getVertex(e->getIdTo());
-        else
-          vTo = graph->getVertex(e->getIdFrom());
-      }
-
-      if(vTo)
-      {
-        double attrValueTo = te::sa::GetDataValue(vTo->getAttributes()[attrIdx]);
-
-        G +=  attrValueTo;
-        GStar +=  attrValueTo;
-      }
+      double attrValueTo = values[neighbours[k]];
 
-      ++itNeighbours;
+      G +=  attrValueTo;
+      GStar +=  attrValueTo;
     }
 
     G /= nNeighbours;
@@ -115,9 +129,8 @@ void te::sa::GStatistics(te::sa::GeneralizedProximityMatrix* gpm, int attrIdx)
     G /= excludeSum; 
     GStar /= totalSum;
 
-    v->setAttributeVecSize(nAttrs);
-    v->addAttribute(gAttrIdx, new te::dt::SimpleData<double, te::dt::DOUBLE_TYPE>(G));
-    v->addAttribute(gStarAttrIdx, new te::dt::SimpleData<double, te::dt::DOUBLE_TYPE>(GStar));
+    gValues[i] = G;
+    gStarValues[i] = GStar;
 
     if(!task.isActive())
     {
@@ -125,8 +138,6 @@ void te::sa::GStatistics(te::sa::GeneralizedProximityMatrix* gpm, int attrIdx)
     }
 
     task.pulse();
-
-    v = it->getNextVertex();
   }
 }
 
@@ -134,75 +145,49 @@ void te::sa::LocalMean(te::sa::GeneralizedProximityMatrix* gpm, int attrIdx)
 {
   assert(gpm);
 
-  te::graph::AbstractGraph* graph = gpm->getGraph();
+  te::sa::SpatialWeightsMatrix swm;
+  swm.build(gpm);
+
+  te::sa::LocalMean(swm, swm.loadColumn(gpm, attrIdx));
+
+  swm.exportColumns(gpm);
+}
+
+void te::sa::LocalMean(te::sa::SpatialWeightsMatrix& swm, std::size_t column)
+{
+  //check if the gpm has the weight attribute
+  CheckWeights(swm);
 
-  //check if the graph has the weight attribute
-  int weightAttrIdx;
-  if(!te::sa::GetGraphEdgeAttrIndex(graph, TE_SA_WEIGHT_ATTR_NAME, weightAttrIdx))
-    throw;
+  //add local mean and number of neighbours columns into the matrix
+  std::size_t localMeanColumn = swm.addColumn(TE_SA_LOCALMEAN_ATTR_NAME, te::dt::DOUBLE_TYPE);
+  std::size_t nNeighboursColumn = swm.addColumn(TE_SA_NUMNEIGHBORS_ATTR_NAME, te::dt::INT32_TYPE);
 
-  bool normalized = true;
+  const std::vector<double>& values = swm.getColumn(column);
+  std::vector<double>& localMeanValues = swm.getColumn(localMeanColumn);
+  std::vector<double>& nNeighboursValues = swm.getColumn(nNeighboursColumn);
 
-  //add local mean and number of neighbours attributes into gpm
-  int localMeanAttrIdx = te::sa::AddGraphVertexAttribute(graph, TE_SA_LOCALMEAN_ATTR_NAME, te::dt::DOUBLE_TYPE);
-  int nNeighboursAttrIdx = te::sa::AddGraphVertexAttribute(graph, TE_SA_NUMNEIGHBORS_ATTR_NAME, te::dt::INT32_TYPE);
-  int nAttrs = graph->getMetadata()->getVertexPropertySize();
+  const std::vector<std::size_t>& offsets = swm.getOffsets();
+  const std::vector<std::size_t>& neighbours = swm.getNeighbours();
+  const std::vector<double>& weights = swm.getWeights();
 
-  //create graph vertex iterator
-  std::auto_ptr<te::graph::MemoryIterator> it(new te::graph::MemoryIterator(graph));
+  std::size_t nVertices = swm.getNumberOfVertices();
 
   //create task
   te::common::TaskProgress task;
 
-  task.setTotalSteps(it->getVertexInteratorCount());
+  task.setTotalSteps((int)nVertices);
   task.setMessage(TE_TR("Calculating Local Mean."));
 
-  te::graph::Vertex* v = it->getFirstVertex();
-
-  while(!it->isVertexIteratorAfterEnd())
+  for(std::size_t i = 0; i < nVertices; ++i)
   {
     double sum = 0.;
 
-    //get neighbours information
-    int id = v->getId();
-    std::set<int> neighbours = v->getSuccessors();
-    std::set<int>::iterator itNeighbours = neighbours.begin();
-    int nNeighbours = (int)neighbours.size();
-
-    while(itNeighbours != neighbours.end())
-    {
-      te::graph::Edge* e = graph->getEdge(*itNeighbours);
-      te::graph::Vertex* vTo = 0;
-
-      if(e)
-      {
-        if(e->getIdFrom() == id)
-          vTo = graph->getVertex(e->getIdTo());
-        else
-          vTo = graph->getVertex(e->getIdFrom());
-      }
-
-      if(vTo)
-      {
-        //retrieve the neighbor attribute value
-        double attrValue = te::sa::GetDataValue(vTo->getAttributes()[attrIdx]);
-
-        //retrieve the weight associated with the neighbor
-        double attrWeight = te::sa::GetDataValue(e->getAttributes()[weightAttrIdx]);
-
-        //verify if the weight is normalized by number of neighbours
-        if(!normalized)
-          attrWeight = attrWeight/nNeighbours;
-
-        sum +=  attrWeight * attrValue;
-      }
-
-      ++itNeighbours;
-    }
+    //the weights are normalized by the number of neighbours
+    for(std::size_t k = offsets[i]; k < offsets[i + 1]; ++k)
+      sum += weights[k] * values[neighbours[k]];
 
-    v->setAttributeVecSize(nAttrs);
-    v->addAttribute(localMeanAttrIdx, new te::dt::SimpleData<double, te::dt::DOUBLE_TYPE>(sum));
-    v->addAttribute(nNeighboursAttrIdx, new te::dt::SimpleData<int, te::dt::INT32_TYPE>(nNeighbours));
+    localMeanValues[i] = sum;
+    nNeighboursValues[i] = (double)(offsets[i + 1] - offsets[i]);
 
     if(!task.isActive())
     {
@@ -210,8 +195,6 @@ void te::sa::LocalMean(te::sa::GeneralizedProximityMatrix* gpm, int attrIdx)
     }
 
     task.pulse();
-
-    v = it->getNextVertex();
   }
 }
 
@@ -219,40 +202,46 @@ void te::sa::ZAndWZ(te::sa::GeneralizedProximityMatrix* gpm, int attrIdx)
 {
   assert(gpm);
 
-  te::graph::AbstractGraph* graph = gpm->getGraph();
+  te::sa::SpatialWeightsMatrix swm;
+  swm.build(gpm);
 
-  //check if the graph has the weight attribute
-  int weightAttrIdx;
-  if(!te::sa::GetGraphEdgeAttrIndex(graph, TE_SA_WEIGHT_ATTR_NAME, weightAttrIdx))
-    throw;
+  te::sa::ZAndWZ(swm, swm.loadColumn(gpm, attrIdx));
+
+  swm.exportColumns(gpm);
+}
+
+void te::sa::ZAndWZ(te::sa::SpatialWeightsMatrix& swm, std::size_t column)
+{
+  //check if the gpm has the weight attribute
+  CheckWeights(swm);
+
+  //add Z and WZ columns into the matrix
+  std::size_t zColumn = swm.addColumn(TE_SA_STDDEVZ_ATTR_NAME, te::dt::DOUBLE_TYPE);
+  std::size_t wzColumn = swm.addColumn(TE_SA_LOCALMEANWZ_ATTR_NAME, te::dt::DOUBLE_TYPE);
 
   // calculate the standard deviation Z
-  double mean = te::sa::FirstMoment(gpm, attrIdx);
+  double mean = swm.getFirstMoment(column);
+
+  const std::vector<double>& values = swm.getColumn(column);
+  std::vector<double>& zValues = swm.getColumn(zColumn);
+  std::vector<double>& wzValues = swm.getColumn(wzColumn);
 
-  //add Z attribute into gpm
-  int zAttrIdx = te::sa::AddGraphVertexAttribute(graph, TE_SA_STDDEVZ_ATTR_NAME, te::dt::DOUBLE_TYPE);
-  int nAttrs = graph->getMetadata()->getVertexPropertySize();
+  const std::vector<std::size_t>& offsets = swm.getOffsets();
+  const std::vector<std::size_t>& neighbours = swm.getNeighbours();
+  const std::vector<double>& weights = swm.getWeights();
 
- //create graph vertex iterator
-  std::auto_ptr<te::graph::MemoryIterator> it(new te::graph::MemoryIterator(graph));
+  std::size_t nVertices = swm.getNumberOfVertices();
 
   //create task
   {
     te::common::TaskProgress task;
 
-    task.setTotalSteps(it->getVertexInteratorCount());
+    task.setTotalSteps((int)nVertices);
     task.setMessage(TE_TR("Calculating Moran - Z Value."));
 
-    te::graph::Vertex* v = it->getFirstVertex();
-
-    while(!it->isVertexIteratorAfterEnd())
+    for(std::size_t i = 0; i < nVertices; ++i)
     {
-      double attrValue = te::sa::GetDataValue(v->getAttributes()[attrIdx]);
-
-      double stdDezZ = attrValue - mean;
-
-      v->setAttributeVecSize(nAttrs);
-      v->addAttribute(zAttrIdx, new te::dt::SimpleData<double, te::dt::DOUBLE_TYPE>(stdDezZ));
+      zValues[i] = values[i] - mean;
 
       if(!task.isActive())
       {
@@ -260,70 +249,25 @@ void te::sa::ZAndWZ(te::sa::GeneralizedProximityMatrix* gpm, int attrIdx)
       }
 
       task.pulse();
-
-      v = it->getNextVertex();
     }
   }
 
   //calculate the local mean of Z(WZ)
-  int wzAttrIdx = te::sa::AddGraphVertexAttribute(graph, TE_SA_LOCALMEANWZ_ATTR_NAME, te::dt::DOUBLE_TYPE);
-  nAttrs = graph->getMetadata()->getVertexPropertySize();
-
-  bool normalized = true;
-
-  //create task
   {
     te::common::TaskProgress task;
 
-    task.setTotalSteps(it->getVertexInteratorCount());
+    task.setTotalSteps((int)nVertices);
     task.setMessage(TE_TR("Calculating Moran - WZ Value."));
 
-    //vertex iterator
-    te::graph::Vertex* v = it->getFirstVertex();
-
-    while(!it->isVertexIteratorAfterEnd())
+    for(std::size_t i = 0; i < nVertices; ++i)
     {
       double sum = 0.;
 
-      //get neighbours information
-      int id = v->getId();
-      std::set<int> neighbours = v->getSuccessors();
-      std::set<int>::iterator itNeighbours = neighbours.begin();
-      int nNeighbours = (int)neighbours.size();
-
-      while(itNeighbours != neighbours.end())
-      {
-        te::graph::Edge* e = graph->getEdge(*itNeighbours);
-        te::graph::Vertex* vTo = 0;
-
-        if(e)
-        {
-          if(e->getIdFrom() == id)
-            vTo = graph->getVertex(e->getIdTo());
-          else
-            vTo = graph->getVertex(e->getIdFrom());
-        }
-
-        if(vTo)
-        {
-          //retrieve the neighbor attribute value
-          double attrValue = te::sa::GetDataValue(vTo->getAttributes()[zAttrIdx]);
-
-          //retrieve the weight associated with the neighbor
-          double attrWeight = te::sa::GetDataValue(e->getAttributes()[weightAttrIdx]);
-
-          //verify if the weight is normalized by number of neighbours
-          if(!normalized)
-            attrWeight = attrWeight/nNeighbours;
-
-          sum +=  attrWeight * attrValue;
-        }
+      //the weights are normalized by the number of neighbours
+      for(std::size_t k = offsets[i]; k < offsets[i + 1]; ++k)
+        sum += weights[k] * zValues[neighbours[k]];
 
-        ++itNeighbours;
-      }
-
-      v->setAttributeVecSize(nAttrs);
-      v->addAttribute(wzAttrIdx, new te::dt::SimpleData<double, te::dt::DOUBLE_TYPE>(sum));
+      wzValues[i] = sum;
 
       if(!task.isActive())
       {
@@ -331,8 +275,6 @@ void te::sa::ZAndWZ(te::sa::GeneralizedProximityMatrix* gpm, int attrIdx)
       }
 
       task.pulse();
-
-      v = it->getNextVertex();
     }
   }
 }
@@ -341,47 +283,51 @@ double te::sa::MoranIndex(te::sa::GeneralizedProximityMatrix* gpm)
 {
   assert(gpm);
 
-  te::graph::AbstractGraph* graph = gpm->getGraph();
+  te::sa::SpatialWeightsMatrix swm;
+  swm.build(gpm);
+
+  //check if the graph has the Z and WZ attributes
+  LoadColumn(swm, gpm, TE_SA_STDDEVZ_ATTR_NAME);
+  LoadColumn(swm, gpm, TE_SA_LOCALMEANWZ_ATTR_NAME);
+
+  double moran = te::sa::MoranIndex(swm);
+
+  swm.exportColumns(gpm);
 
-  //check if the graph has the Z attribute
-  int zAttrIdx;
-  if(!te::sa::GetGraphVertexAttrIndex(graph, TE_SA_STDDEVZ_ATTR_NAME, zAttrIdx))
-    throw;
+  return moran;
+}
+
+double te::sa::MoranIndex(te::sa::SpatialWeightsMatrix& swm)
+{
+  std::size_t zColumn = GetColumn(swm, TE_SA_STDDEVZ_ATTR_NAME);
+  std::size_t wzColumn = GetColumn(swm, TE_SA_LOCALMEANWZ_ATTR_NAME);
 
-  //check if the graph has the WZ attribute
-  int wzAttrIdx;
-  if(!te::sa::GetGraphVertexAttrIndex(graph, TE_SA_LOCALMEANWZ_ATTR_NAME, wzAttrIdx))
-    throw;
+  //add moran index column into the matrix
+  std::size_t moranColumn = swm.addColumn(TE_SA_MORANINDEX_ATTR_NAME, te::dt::DOUBLE_TYPE);
 
-  double variance = te::sa::SecondMoment(gpm, zAttrIdx, 0); // MEAN is 0 ??
+  double variance = swm.getSecondMoment(zColumn, 0); // MEAN is 0 ??
   double sum = 0.;
   int count = 0;
 
-  //add moran index attribute into gpm
-  int moranAttrIdx = te::sa::AddGraphVertexAttribute(graph, TE_SA_MORANINDEX_ATTR_NAME, te::dt::DOUBLE_TYPE);
-  int nAttrs = graph->getMetadata()->getVertexPropertySize();
+  const std::vector<double>& zValues = swm.getColumn(zColumn);
+  const std::vector<double>& wzValues = swm.getColumn(wzColumn);
+  std::vector<double>& moranValues = swm.getColumn(moranColumn);
 
-  //create graph vertex iterator
-  std::auto_ptr<te::graph::MemoryIterator> it(new te::graph::MemoryIterator(graph));
+  std::size_t nVertices = swm.getNumberOfVertices();
 
   te::common::TaskProgress task;
 
-  task.setTotalSteps(it->getVertexInteratorCount());
+  task.setTotalSteps((int)nVertices);
   task.setMessage(TE_TR("Calculating Moran Index."));
 
-  te::graph::Vertex* v = it->getFirstVertex();
-
-  while(!it->isVertexIteratorAfterEnd())
+  for(std::size_t i = 0; i < nVertices; ++i)
   {
-    double zValue  = te::sa::GetDataValue(v->getAttributes()[zAttrIdx]);
-    double wzValue = te::sa::GetDataValue(v->getAttributes()[wzAttrIdx]);
     double ZxWZ = 0.;
 
     if(variance != 0.)
-      ZxWZ = (zValue*wzValue)/variance; 
+      ZxWZ = (zValues[i]*wzValues[i])/variance; 
 
-    v->setAttributeVecSize(nAttrs);
-    v->addAttribute(moranAttrIdx, new te::dt::SimpleData<double, te::dt::DOUBLE_TYPE>(ZxWZ));
+    moranValues[i] = ZxWZ;
 
     sum += ZxWZ;
     ++count;
@@ -392,8 +338,6 @@ double te::sa::MoranIndex(te::sa::GeneralizedProximityMatrix* gpm)
     }
 
     task.pulse();
-
-    v = it->getNextVertex();
   }
 
   return sum /= count;
@@ -403,74 +347,49 @@ double te::sa::MoranIndex(te::sa::GeneralizedProximityMatrix* gpm, double mean,
 {
   assert(gpm);
 
-  double moran = 0.;
+  te::sa::SpatialWeightsMatrix swm;
+  swm.build(gpm);
 
-  te::graph::AbstractGraph* graph = gpm->getGraph();
+  std::size_t column = swm.loadColumn(gpm, attrIdx);
 
-  //check if the graph has the weight attribute
-  int weightAttrIdx;
-  if(!te::sa::GetGraphEdgeAttrIndex(graph, TE_SA_WEIGHT_ATTR_NAME, weightAttrIdx))
-    throw;
+  return te::sa::MoranIndex(swm, swm.getColumn(column), mean, variance);
+}
+
+double te::sa::MoranIndex(const te::sa::SpatialWeightsMatrix& swm, const std::vector<double>& values, double mean, double variance)
+{
+  //check if the gpm has the weight attribute
+  CheckWeights(swm);
 
-   bool normalized = true;
+  const std::vector<std::size_t>& offsets = swm.getOffsets();
+  const std::vector<std::size_t>& neighbours = swm.getNeighbours();
+  const std::vector<double>& weights = swm.getWeights();
 
-  //create graph vertex iterator
-  std::auto_ptr<te::graph::MemoryIterator> it(new te::graph::MemoryIterator(graph));
+  std::size_t numberObjs = swm.getNumberOfVertices();
 
-  te::graph::Vertex* v = it->getFirstVertex();
+  assert(values.size() == numberObjs);
 
-  std::size_t numberObjs = it->getVertexInteratorCount();
+  double moran = 0.;
 
-  while(!it->isVertexIteratorAfterEnd())
+  for(std::size_t i = 0; i < numberObjs; ++i)
   {
-    double normObjVal = te::sa::GetDataValue(v->getAttributes()[attrIdx]) - mean;
+    double normObjVal = values[i] - mean;
     double li = 0.;
     double weightSum = 0.;
 
-    //get neighbours information
-    int id = v->getId();
-    std::set<int> neighbours = v->getSuccessors();
-    std::set<int>::iterator itNeighbours = neighbours.begin();
-    int nNeighbours = (int)neighbours.size();
-
-    while(itNeighbours != neighbours.end())
+    //the weights are normalized by the number of neighbours
+    for(std::size_t k = offsets[i]; k < offsets[i + 1]; ++k)
     {
-      te::graph::Edge* e = graph->getEdge(*itNeighbours);
-      te::graph::Vertex* vTo = 0;
-
-      if(e)
-      {
-        if(e->getIdFrom() == id)
-          vTo = graph->getVertex(e->getIdTo());
-        else
-          vTo = graph->getVertex(e->getIdFrom());
-      }
-
-      if(vTo)
-      {
-        double normNeighVal = te::sa::GetDataValue(vTo->getAttributes()[attrIdx]) - mean;
-
-        //retrieve the weight associated with the neighbor
-        double attrWeight = te::sa::GetDataValue(e->getAttributes()[weightAttrIdx]);
-
-        //verify if the weight is normalized by number of neighbours
-        if(!normalized)
-          attrWeight = attrWeight/nNeighbours;
+      double normNeighVal = values[neighbours[k]] - mean;
 
-        li +=  attrWeight*(normNeighVal)*(normObjVal);
+      li += weights[k]*(normNeighVal)*(normObjVal);
 
-        weightSum += attrWeight;
-      }
-
-      ++itNeighbours;
+      weightSum += weights[k];
     }
 
     if (weightSum != 0.)
       li /= weightSum;
 
     moran += li;
-
-    v = it->getNextVertex();
   }
 
   if(numberObjs > 1)
@@ -483,263 +402,119 @@ double te::sa::GlobalMoranSignificance(te::sa::GeneralizedProximityMatrix* gpm,
 {
   assert(gpm);
 
-  te::graph::AbstractGraph* graph = gpm->getGraph();
-
-  //calculate statistics information
-  double mean = te::sa::FirstMoment(gpm, attrIdx);
-  double variance = te::sa::SecondMoment(gpm, attrIdx, mean);
-
-  //create deviation vector
-  std::vector<double> deviations;
+  te::sa::SpatialWeightsMatrix swm;
+  swm.build(gpm);
 
-  std::auto_ptr<te::graph::MemoryIterator> it(new te::graph::MemoryIterator(graph));
-  te::graph::Vertex* v = it->getFirstVertex();
-
-  while(!it->isVertexIteratorAfterEnd())
-  {
-    te::dt::AbstractData* ad = v->getAttributes()[attrIdx];
-
-    if(ad)
-      deviations.push_back(te::sa::GetDataValue(ad));
+  return te::sa::GlobalMoranSignificance(swm, swm.loadColumn(gpm, attrIdx), permutationsNumber, moranIndex);
+}
 
-    v = it->getNextVertex();
-  }
+double te::sa::GlobalMoranSignificance(const te::sa::SpatialWeightsMatrix& swm, std::size_t column, int permutationsNumber, double moranIndex, unsigned int maxThreads)
+{
+  //calculate statistics information
+  double mean = swm.getFirstMoment(column);
+  double variance = swm.getSecondMoment(column, mean);
 
-  //create permutation vector
-  std::vector<double> permutationsResults(permutationsNumber);
+  //calculate the moran index of each permutation
+  std::vector<double> permutationsResults;
 
-  boost::random::mt19937 gen;
-  boost::random::uniform_int_distribution<> dist(0, deviations.size() - 1);
+  te::sa::PermutationTest test(swm, te::sa::PermutationTest::sm_defaultSeed, maxThreads);
 
-    //create task
+  //create task
   te::common::TaskProgress task;
 
-  task.setTotalSteps(permutationsNumber);
   task.setMessage(TE_TR("Calculating Global Moran Significance."));
 
-  for(int i = 0; i < permutationsNumber; ++i)
+  if(!test.globalMoran(swm.getColumn(column), mean, variance, permutationsNumber, permutationsResults, &task))
   {
-    //shuffle the attribute value
-    te::graph::Vertex* v = it->getFirstVertex();
-
-    while(!it->isVertexIteratorAfterEnd())
-    {
-      double value = deviations[dist(gen)];
-
-      v->addAttribute(attrIdx, new te::dt::SimpleData<double, te::dt::DOUBLE_TYPE>(value));
-
-      v = it->getNextVertex();
-    }
-
-    permutationsResults[i] = MoranIndex(gpm, mean, variance, attrIdx);
-
-    if(!task.isActive())
-    {
-      throw te::common::Exception(TE_TR("Operation canceled by the user."));
-    }
-
-    task.pulse();
+    throw te::common::Exception(TE_TR("Operation canceled by the user."));
   }
 
-  //fix attribute values
-  int count = 0;
-  v = it->getFirstVertex();
-
-  while(!it->isVertexIteratorAfterEnd())
-  {
-    double value = deviations[count];
-
-    v->addAttribute(attrIdx, new te::dt::SimpleData<double, te::dt::DOUBLE_TYPE>(value));
-
-    ++count;
-
-    v = it->getNextVertex();
-  }
-  
   // verify the significance
-  int position = 0;
-  double significance = 0.;
-
-  for(int i = 0; i < permutationsNumber; i++)
-  {
-    if(moranIndex < permutationsResults[i])
-      position++;
-  }
-
-  if(moranIndex >= 0)
-    significance = (double)(position+1)/(double)(permutationsNumber+1);
-  else
-    significance = (double)(permutationsNumber-position)/(double)(permutationsNumber+1);
-
-  return significance;
+  return te::sa::PermutationTest::GetGlobalSignificance(moranIndex, permutationsResults);
 }
 
 void te::sa::LisaStatisticalSignificance(te::sa::GeneralizedProximityMatrix* gpm, int permutationsNumber)
 {
   assert(gpm);
 
-  te::graph::AbstractGraph* graph = gpm->getGraph();
-
-  //check if the graph has the Z attribute
-  int zAttrIdx;
-  if(!te::sa::GetGraphVertexAttrIndex(graph, TE_SA_STDDEVZ_ATTR_NAME, zAttrIdx))
-    throw;
-
-  //check if the graph has the local moran attribute
-  int lisaAttrIdx;
-  if(!te::sa::GetGraphVertexAttrIndex(graph, TE_SA_MORANINDEX_ATTR_NAME, lisaAttrIdx))
-    throw;
+  te::sa::SpatialWeightsMatrix swm;
+  swm.build(gpm);
 
-  //check if the graph has the number of neighbours attribute
-  int nNeighboursAttrIdx;
-  if(!te::sa::GetGraphVertexAttrIndex(graph, TE_SA_NUMNEIGHBORS_ATTR_NAME, nNeighboursAttrIdx))
-    throw;
+  //check if the graph has the Z and local moran attributes
+  LoadColumn(swm, gpm, TE_SA_STDDEVZ_ATTR_NAME);
+  LoadColumn(swm, gpm, TE_SA_MORANINDEX_ATTR_NAME);
 
-  //calculate variance
-  double variance = te::sa::SecondMoment(gpm, zAttrIdx, 0); // MEAN = 0 ??
-
-  //create deviation vector
-  std::vector<double> deviations;
-
-  std::auto_ptr<te::graph::MemoryIterator> it(new te::graph::MemoryIterator(graph));
-  te::graph::Vertex* v = it->getFirstVertex();
+  te::sa::LisaStatisticalSignificance(swm, permutationsNumber);
 
-  while(!it->isVertexIteratorAfterEnd())
-  {
-    te::dt::AbstractData* ad = v->getAttributes()[zAttrIdx];
-
-    if(ad)
-      deviations.push_back(te::sa::GetDataValue(ad));
+  swm.exportColumns(gpm);
+}
 
-    v = it->getNextVertex();
-  }
+void te::sa::LisaStatisticalSignificance(te::sa::SpatialWeightsMatrix& swm, int permutationsNumber, unsigned int maxThreads)
+{
+  std::size_t zColumn = GetColumn(swm, TE_SA_STDDEVZ_ATTR_NAME);
+  std::size_t lisaColumn = GetColumn(swm, TE_SA_MORANINDEX_ATTR_NAME);
 
-  //add lisa significance attribute into gpm
-  int lisaSigAttrIdx = te::sa::AddGraphVertexAttribute(graph, TE_SA_LISASIGNIFICANCE_ATTR_NAME, te::dt::DOUBLE_TYPE);
-  int nAttrs = graph->getMetadata()->getVertexPropertySize();
+  //add lisa significance column into the matrix
+  std::size_t lisaSigColumn = swm.addColumn(TE_SA_LISASIGNIFICANCE_ATTR_NAME, te::dt::DOUBLE_TYPE);
 
-  //calculate LISA Significance value
-  boost::random::mt19937 gen;
-  boost::random::uniform_int_distribution<> dist(0, deviations.size() - 1);
+  //calculate variance
+  double variance = swm.getSecondMoment(zColumn, 0); // MEAN = 0 ??
 
-  int index = 0;
+  //calculate LISA Significance value by conditional permutations
+  te::sa::PermutationTest test(swm, te::sa::PermutationTest::sm_defaultSeed, maxThreads);
 
   //create task
   te::common::TaskProgress task;
 
-  task.setTotalSteps(it->getVertexInteratorCount());
   task.setMessage(TE_TR("Calculating LISA Significance."));
 
-  v = it->getFirstVertex();
-
-  while(!it->isVertexIteratorAfterEnd())
+  if(!test.lisaSignificance(swm.getColumn(zColumn), variance, swm.getColumn(lisaColumn), permutationsNumber, swm.getColumn(lisaSigColumn), &task))
   {
-    int nNeighbours = (int)te::sa::GetDataValue(v->getAttributes()[nNeighboursAttrIdx]);
-
-    double lisaValue = te::sa::GetDataValue(v->getAttributes()[lisaAttrIdx]);
-
-    //create pertumation vector
-    std::vector<double> permut(permutationsNumber);
-
-    for(int i = 0; i < permutationsNumber; ++i)
-    {
-      double sum = 0.;
-
-      std::set<int> neighSet;
-
-      for(int j = 0; j < nNeighbours; ++j)
-      {
-        int pos = dist(gen);
-
-        if(index == pos || neighSet.find(pos) != neighSet.end())
-        {
-          j--;
-        }
-        else
-        {
-          neighSet.insert(pos);
-          sum += deviations[pos];
-        }
-      }
-
-      double WZperm = 0.;
-
-      if(nNeighbours != 0)
-        WZperm = sum/nNeighbours;
-
-      if(variance == 0)
-        permut[i] = 0.;
-      else
-        permut[i] = deviations[index] * WZperm / variance;
-    }
-
-    int position = 0;
-
-    for(int k = 0; k < permutationsNumber; k++)
-    {
-      if(lisaValue > permut[k])
-        position++;
-    }
-
-    //calculate significance
-    double significance = 0.;
+    throw te::common::Exception(TE_TR("Operation canceled by the user."));
+  }
+}
 
-    if(lisaValue >= 0)
-      significance = (double) (permutationsNumber-position)/(permutationsNumber+1);
-    else
-      significance = (double) position/( permutationsNumber + 1 );
 
-    v->setAttributeVecSize(nAttrs);
-    v->addAttribute(lisaSigAttrIdx, new te::dt::SimpleData<double, te::dt::DOUBLE_TYPE>(significance));
+void te::sa::BoxMap(te::sa::GeneralizedProximityMatrix* gpm, double mean)
+{
+  assert(gpm);
 
-    if(!task.isActive())
-    {
-      throw te::common::Exception(TE_TR("Operation canceled by the user."));
-    }
+  te::sa::SpatialWeightsMatrix swm;
+  swm.build(gpm);
 
-    task.pulse();
+  //check if the graph has the Z and WZ attributes
+  LoadColumn(swm, gpm, TE_SA_STDDEVZ_ATTR_NAME);
+  LoadColumn(swm, gpm, TE_SA_LOCALMEANWZ_ATTR_NAME);
 
-    ++index;
+  te::sa::BoxMap(swm, mean);
 
-    v = it->getNextVertex();
-  }
+  swm.exportColumns(gpm);
 }
 
-void te::sa::BoxMap(te::sa::GeneralizedProximityMatrix* gpm, double mean)
+void te::sa::BoxMap(te::sa::SpatialWeightsMatrix& swm, double mean)
 {
-  assert(gpm);
-
-  te::graph::AbstractGraph* graph = gpm->getGraph();
+  std::size_t zColumn = GetColumn(swm, TE_SA_STDDEVZ_ATTR_NAME);
+  std::size_t wzColumn = GetColumn(swm, TE_SA_LOCALMEANWZ_ATTR_NAME);
 
-  //check if the graph has the Z attribute
-  int zAttrIdx;
-  if(!te::sa::GetGraphVertexAttrIndex(graph, TE_SA_STDDEVZ_ATTR_NAME, zAttrIdx))
-    throw;
+  //add boxmap column into the matrix
+  std::size_t boxMapColumn = swm.addColumn(TE_SA_BOXMAP_ATTR_NAME, te::dt::INT32_TYPE);
 
-  //check if the graph has the WZ attribute
-  int wzAttrIdx;
-  if(!te::sa::GetGraphVertexAttrIndex(graph, TE_SA_LOCALMEANWZ_ATTR_NAME, wzAttrIdx))
-    throw;
+  const std::vector<double>& zValues = swm.getColumn(zColumn);
+  const std::vector<double>& wzValues = swm.getColumn(wzColumn);
+  std::vector<double>& boxMapValues = swm.getColumn(boxMapColumn);
 
-  //add boxmap attribute into gpm
-  int boxMapAttrIdx = te::sa::AddGraphVertexAttribute(graph, TE_SA_BOXMAP_ATTR_NAME, te::dt::INT32_TYPE);
-  int nAttrs = graph->getMetadata()->getVertexPropertySize();
-
- //create graph vertex iterator
-  std::auto_ptr<te::graph::MemoryIterator> it(new te::graph::MemoryIterator(graph));
+  std::size_t nVertices = swm.getNumberOfVertices();
 
   //create task
   te::common::TaskProgress task;
 
-  task.setTotalSteps(it->getVertexInteratorCount());
+  task.setTotalSteps((int)nVertices);
   task.setMessage(TE_TR("Calculating Box Map."));
 
-  te::graph::Vertex* v = it->getFirstVertex();
-
-  while(!it->isVertexIteratorAfterEnd())
+  for(std::size_t i = 0; i < nVertices; ++i)
   {
-    double zValue  = te::sa::GetDataValue(v->getAttributes()[zAttrIdx]);
-    double wzValue = te::sa::GetDataValue(v->getAttributes()[wzAttrIdx]);
+    double zValue  = zValues[i];
+    double wzValue = wzValues[i];
 
     int result = 0;
 
@@ -752,8 +527,7 @@ void te::sa::BoxMap(te::sa::GeneralizedProximityMatrix* gpm, double mean)
     else if(zValue >= mean && wzValue < mean)
       result = 3;
 
-    v->setAttributeVecSize(nAttrs);
-    v->addAttribute(boxMapAttrIdx, new te::dt::SimpleData<int, te::dt::INT32_TYPE>(result));
+    boxMapValues[i] = result;
 
     if(!task.isActive())
     {
@@ -761,8 +535,6 @@ void te::sa::BoxMap(te::sa::GeneralizedProximityMatrix* gpm, double mean)
     }
 
     task.pulse();
-
-    v = it->getNextVertex();
   }
 }
 
@@ -770,31 +542,38 @@ void te::sa::LISAMap(te::sa::GeneralizedProximityMatrix* gpm, int permutationsNu
 {
   assert(gpm);
 
-  te::graph::AbstractGraph* graph = gpm->getGraph();
+  te::sa::SpatialWeightsMatrix swm;
+  swm.build(gpm);
 
   //check if the graph has the LISASig attribute
-  int lisaSigAttrIdx;
-  if(!te::sa::GetGraphVertexAttrIndex(graph, TE_SA_LISASIGNIFICANCE_ATTR_NAME, lisaSigAttrIdx))
-    throw;
+  LoadColumn(swm, gpm, TE_SA_LISASIGNIFICANCE_ATTR_NAME);
+
+  te::sa::LISAMap(swm, permutationsNumber);
+
+  swm.exportColumns(gpm);
+}
 
-  //add boxmap attribute into gpm
-  int lisaMapAttrIdx = te::sa::AddGraphVertexAttribute(graph, TE_SA_LISAMAP_ATTR_NAME, te::dt::INT32_TYPE);
-  int nAttrs = graph->getMetadata()->getVertexPropertySize();
+void te::sa::LISAMap(te::sa::SpatialWeightsMatrix& swm, int /*permutationsNumber*/)
+{
+  std::size_t lisaSigColumn = GetColumn(swm, TE_SA_LISASIGNIFICANCE_ATTR_NAME);
+
+  //add lisa map column into the matrix
+  std::size_t lisaMapColumn = swm.addColumn(TE_SA_LISAMAP_ATTR_NAME, te::dt::INT32_TYPE);
+
+  const std::vector<double>& lisaSigValues = swm.getColumn(lisaSigColumn);
+  std::vector<double>& lisaMapValues = swm.getColumn(lisaMapColumn);
 
- //create graph vertex iterator
-  std::auto_ptr<te::graph::MemoryIterator> it(new te::graph::MemoryIterator(graph));
+  std::size_t nVertices = swm.getNumberOfVertices();
 
   //create task
   te::common::TaskProgress task;
 
-  task.setTotalSteps(it->getVertexInteratorCount());
+  task.setTotalSteps((int)nVertices);
   task.setMessage(TE_TR("Calculating LISA Map."));
 
-  te::graph::Vertex* v = it->getFirstVertex();
-
-  while(!it->isVertexIteratorAfterEnd())
+  for(std::size_t i = 0; i < nVertices; ++i)
   {
-    double lisaSigValue  = te::sa::GetDataValue(v->getAttributes()[lisaSigAttrIdx]);
+    double lisaSigValue  = lisaSigValues[i];
 
     int significanceClass = 0;
 
@@ -805,8 +584,7 @@ void te::sa::LISAMap(te::sa::GeneralizedProximityMatrix* gpm, int permutationsNu
     else if(lisaSigValue <= 0.05 && lisaSigValue > 0.01)
       significanceClass = 1;
 
-    v->setAttributeVecSize(nAttrs);
-    v->addAttribute(lisaMapAttrIdx, new te::dt::SimpleData<int, te::dt::INT32_TYPE>(significanceClass));
+    lisaMapValues[i] = significanceClass;
 
     if(!task.isActive())
     {
@@ -814,8 +592,6 @@ void te::sa::LISAMap(te::sa::GeneralizedProximityMatrix* gpm, int permutationsNu
     }
 
     task.pulse();
-
-    v = it->getNextVertex();
   }
 }
 
@@ -823,45 +599,49 @@ void te::sa::MoranMap(te::sa::GeneralizedProximityMatrix* gpm)
 {
   assert(gpm);
 
-  te::graph::AbstractGraph* graph = gpm->getGraph();
+  te::sa::SpatialWeightsMatrix swm;
+  swm.build(gpm);
+
+  //check if the graph has the LISAMap and BoxMap attributes
+  LoadColumn(swm, gpm, TE_SA_LISAMAP_ATTR_NAME);
+  LoadColumn(swm, gpm, TE_SA_BOXMAP_ATTR_NAME);
 
-  //check if the graph has the LISAMap attribute
-  int lisaMapAttrIdx;
-  if(!te::sa::GetGraphVertexAttrIndex(graph, TE_SA_LISAMAP_ATTR_NAME, lisaMapAttrIdx))
-    throw;
+  te::sa::MoranMap(swm);
 
-  //check if the graph has the BoxMap attribute
-  int boxMapAttrIdx;
-  if(!te::sa::GetGraphVertexAttrIndex(graph, TE_SA_BOXMAP_ATTR_NAME, boxMapAttrIdx))
-    throw;
+  swm.exportColumns(gpm);
+}
+
+void te::sa::MoranMap(te::sa::SpatialWeightsMatrix& swm)
+{
+  std::size_t lisaMapColumn = GetColumn(swm, TE_SA_LISAMAP_ATTR_NAME);
+  std::size_t boxMapColumn = GetColumn(swm, TE_SA_BOXMAP_ATTR_NAME);
 
-  //add boxmap attribute into gpm
-  int moranMapAttrIdx = te::sa::AddGraphVertexAttribute(graph, TE_SA_MORANMAP_ATTR_NAME, te::dt::INT32_TYPE);
-  int nAttrs = graph->getMetadata()->getVertexPropertySize();
+  //add moran map column into the matrix
+  std::size_t moranMapColumn = swm.addColumn(TE_SA_MORANMAP_ATTR_NAME, te::dt::INT32_TYPE);
 
-  //create graph vertex iterator
-  std::auto_ptr<te::graph::MemoryIterator> it(new te::graph::MemoryIterator(graph));
+  const std::vector<double>& lisaMapValues = swm.getColumn(lisaMapColumn);
+  const std::vector<double>& boxMapValues = swm.getColumn(boxMapColumn);
+  std::vector<double>& moranMapValues = swm.getColumn(moranMapColumn);
+
+  std::size_t nVertices = swm.getNumberOfVertices();
 
   //create task
   te::common::TaskProgress task;
 
-  task.setTotalSteps(it->getVertexInteratorCount());
+  task.setTotalSteps((int)nVertices);
   task.setMessage(TE_TR("Calculating Moran Map."));
 
-  te::graph::Vertex* v = it->getFirstVertex();
-
-  while(!it->isVertexIteratorAfterEnd())
+  for(std::size_t i = 0; i < nVertices; ++i)
   {
-    int lisaMapValue = (int) te::sa::GetDataValue(v->getAttributes()[lisaMapAttrIdx]);
-    int boxMapValue = (int) te::sa::GetDataValue(v->getAttributes()[boxMapAttrIdx]);
+    int lisaMapValue = (int) lisaMapValues[i];
+    int boxMapValue = (int) boxMapValues[i];
 
     int result = 0;
 
     if(lisaMapValue != 0)
       result = boxMapValue;
 
-    v->setAttributeVecSize(nAttrs);
-    v->addAttribute(moranMapAttrIdx, new te::dt::SimpleData<int, te::dt::INT32_TYPE>(result));
+    moranMapValues[i] = result;
 
     if(!task.isActive())
     {
@@ -869,7 +649,5 @@ void te::sa::MoranMap(te::sa::GeneralizedProximityMatrix* gpm)
     }
 
     task.pulse();
-
-    v = it->getNextVertex();
   }
 }
@@ -22,6 +22,9 @@
 
   \brief Functions used to calculate spatial statistics operations.
 
+  The gpm functions run on a SpatialWeightsMatrix built from the gpm: they
+  throw a te::common::Exception if a vertex has no value for the attribute.
+
   \reference Methods adapted from TerraLib4.
 */
 
@@ -32,7 +35,9 @@
 #include "../Config.h"
 
 // STL
+#include <cstddef>
 #include <string>
+#include <vector>
 
 namespace te
 {
@@ -40,6 +45,7 @@ namespace te
   {
     // Forward declaration
     class GeneralizedProximityMatrix;
+    class SpatialWeightsMatrix;
 
     /*!
       \brief The local spatial statistic G is calculated for each zone based on the spatial weights object used. 
@@ -53,6 +59,14 @@ namespace te
     */
     TESAEXPORT void GStatistics(te::sa::GeneralizedProximityMatrix* gpm, int attrIdx);
 
+    /*!
+      \brief Function used to calculate the G and G* statistics of each vertex from a spatial weights matrix.
+
+      \param swm    Reference to the spatial weights matrix, where the G and G* columns are added.
+      \param column Column index used to calculate the GStatistics.
+    */
+    TESAEXPORT void GStatistics(te::sa::SpatialWeightsMatrix& swm, std::size_t column);
+
     /*!
       \brief Function used to calculate the local mean of each vertex from gpm graph.
 
@@ -62,6 +76,14 @@ namespace te
     */
     TESAEXPORT void LocalMean(te::sa::GeneralizedProximityMatrix* gpm, int attrIdx);
 
+    /*!
+      \brief Function used to calculate the local mean of each vertex from a spatial weights matrix.
+
+      \param swm    Reference to the spatial weights matrix, where the local mean and number of neighbours columns are added.
+      \param column Column index used to calculate the local mean.
+    */
+    TESAEXPORT void LocalMean(te::sa::SpatialWeightsMatrix& swm, std::size_t column);
+
     /*!
       \brief Function used to calculate the standard deviation Z and local mean of the desviation Z (WZ).
              of each vertex from gpm graph.
@@ -72,6 +94,15 @@ namespace te
     */
     TESAEXPORT void ZAndWZ(te::sa::GeneralizedProximityMatrix* gpm, int attrIdx);
 
+    /*!
+      \brief Function used to calculate the standard deviation Z and local mean of the desviation Z (WZ)
+             of each vertex from a spatial weights matrix.
+
+      \param swm    Reference to the spatial weights matrix, where the Z and WZ columns are added.
+      \param column Column index used to calculate the Z and WZ.
+    */
+    TESAEXPORT void ZAndWZ(te::sa::SpatialWeightsMatrix& swm, std::size_t column);
+
     /*!
       \brief Function used to calculate the moran index, also calculates the local moran value.
 
@@ -83,6 +114,17 @@ namespace te
     */
     TESAEXPORT double MoranIndex(te::sa::GeneralizedProximityMatrix* gpm);
 
+    /*!
+      \brief Function used to calculate the moran index, also calculates the local moran column.
+
+      \param swm Reference to the spatial weights matrix.
+
+      \return Double value that represents the moran index.
+
+      \note This functions only works if the matrix has the Z and WZ columns calculated.
+    */
+    TESAEXPORT double MoranIndex(te::sa::SpatialWeightsMatrix& swm);
+
     /*!
       \brief Function used to calculate the moran index to calculate the significance of the global moran index
 
@@ -97,6 +139,20 @@ namespace te
     */
     TESAEXPORT double MoranIndex(te::sa::GeneralizedProximityMatrix* gpm, double mean, double variance, int attrIdx);
 
+    /*!
+      \brief Function used to calculate the moran index of a set of values, one for each vertex of a spatial weights matrix.
+
+      \param swm      Reference to the spatial weights matrix.
+      \param values   The value of each vertex.
+      \param mean     The mean of the original values.
+      \param variance The variance of the original values.
+
+      \return Double value that represents the moran index.
+
+      \note This is a internal function used in GlobalMoranSignificance method.
+    */
+    TESAEXPORT double MoranIndex(const te::sa::SpatialWeightsMatrix& swm, const std::vector<double>& values, double mean, double variance);
+
     /*!
       \brief Function used to calculate the global moran significance.
 
@@ -110,16 +166,44 @@ namespace te
     */
     TESAEXPORT double GlobalMoranSignificance(te::sa::GeneralizedProximityMatrix* gpm, int attrIdx, int permutationsNumber, double moranIndex);
 
+    /*!
+      \brief Function used to calculate the global moran significance from a spatial weights matrix.
+
+      \param swm                Reference to the spatial weights matrix.
+      \param column             Column index used to calculate the global moran significance.
+      \param permutationsNumber Value of pertumations.
+      \param moranIndex         The global moran index value.
+      \param maxThreads         The maximum number of threads (0: the number of processors).
+
+      \return Double value that represents the global moran significance.
+
+      \note The permutations are computed by PermutationTest, with its default seed.
+    */
+    TESAEXPORT double GlobalMoranSignificance(const te::sa::SpatialWeightsMatrix& swm, std::size_t column, int permutationsNumber, double moranIndex, unsigned int maxThreads = 0);
+
     /*!
       \brief Function used to calculate LISA Statical Significance for each gpm element.
 
       \param gpm  Pointer to the gpm.
       \param int The number of permutations.
 
-      \note This functions only works if the gpm has the Z, Local Moran and Number of Neighbours attributes calculated.
+      \note This functions only works if the gpm has the Z and Local Moran attributes calculated.
     */
     TESAEXPORT void LisaStatisticalSignificance(te::sa::GeneralizedProximityMatrix* gpm, int permutationsNumber);
 
+    /*!
+      \brief Function used to calculate LISA Statical Significance for each vertex from a spatial weights matrix.
+
+      \param swm                Reference to the spatial weights matrix.
+      \param permutationsNumber The number of permutations.
+      \param maxThreads         The maximum number of threads (0: the number of processors).
+
+      \note This functions only works if the matrix has the Z and Local Moran columns calculated.
+
+      \note The conditional permutations are computed by PermutationTest, with its default seed.
+    */
+    TESAEXPORT void LisaStatisticalSignificance(te::sa::SpatialWeightsMatrix& swm, int permutationsNumber, unsigned int maxThreads = 0);
+
     /*!
       \brief Function used to calculate the box map info for a gpm, classifies the objects in quadrants based in the scatterplot of moran index.
 
@@ -130,6 +214,16 @@ namespace te
     */
     TESAEXPORT void BoxMap(te::sa::GeneralizedProximityMatrix* gpm, double mean);
 
+    /*!
+      \brief Function used to calculate the box map column of a spatial weights matrix.
+
+      \param swm  Reference to the spatial weights matrix.
+      \param mean Mean value
+
+      \note This functions only works if the matrix has the Z and WZ columns calculated.
+    */
+    TESAEXPORT void BoxMap(te::sa::SpatialWeightsMatrix& swm, double mean);
+
     /*!
       \brief Function used to calculate the lisa map info for a gpm, classifies the objects based in the statistical significance
              of the moran local indexes (LISA).
@@ -141,6 +235,16 @@ namespace te
     */
     TESAEXPORT void LISAMap(te::sa::GeneralizedProximityMatrix* gpm, int permutationsNumber);
 
+    /*!
+      \brief Function used to calculate the lisa map column of a spatial weights matrix.
+
+      \param swm                Reference to the spatial weights matrix.
+      \param permutationsNumber The number of permutations.
+
+      \note This functions only works if the matrix has the LISASig column calculated.
+    */
+    TESAEXPORT void LISAMap(te::sa::SpatialWeightsMatrix& swm, int permutationsNumber);
+
     /*!
       \brief Function used to calculate the moran map info for a gpm, classifies the objects based in the 
              scatterplot of Moran index and its statistical significance
@@ -151,6 +255,15 @@ namespace te
     */
     TESAEXPORT void MoranMap(te::sa::GeneralizedProximityMatrix* gpm);
 
+    /*!
+      \brief Function used to calculate the moran map column of a spatial weights matrix.
+
+      \param swm Reference to the spatial weights matrix.
+
+      \note This functions only works if the matrix has the LisaMap and BoxMap columns calculated.
+    */
+    TESAEXPORT void MoranMap(te::sa::SpatialWeightsMatrix& swm);
+
   } // end namespace sa
 }   // end namespace te
 
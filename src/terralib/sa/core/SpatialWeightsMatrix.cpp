@@ -0,0 +1,387 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+  \file terralib/sa/core/SpatialWeightsMatrix.cpp
+
+  \brief A compressed sparse row representation of the spatial weights of a gpm.
+*/
+
+// TerraLib
+#include "../../common/Exception.h"
+#include "../../core/translator/Translator.h"
+#include "../../datatype/Enums.h"
+#include "../../datatype/Property.h"
+#include "../../datatype/SimpleData.h"
+#include "../../geometry/Enums.h"
+#include "../../graph/core/AbstractGraph.h"
+#include "../../graph/core/Edge.h"
+#include "../../graph/core/Vertex.h"
+#include "../../graph/iterator/MemoryIterator.h"
+#include "../../srs/Config.h"
+#include "GeneralizedProximityMatrix.h"
+#include "SpatialWeightsMatrix.h"
+#include "Utils.h"
+
+// STL
+#include <cassert>
+#include <map>
+#include <memory>
+#include <set>
+
+te::sa::SpatialWeightsMatrix::SpatialWeightsMatrix()
+  : m_hasWeights(false)
+{
+  m_offsets.push_back(0);
+}
+
+te::sa::SpatialWeightsMatrix::~SpatialWeightsMatrix()
+{
+}
+
+void te::sa::SpatialWeightsMatrix::build(te::sa::GeneralizedProximityMatrix* gpm)
+{
+  assert(gpm);
+
+  m_vertexIds.clear();
+  m_offsets.clear();
+  m_neighbours.clear();
+  m_weights.clear();
+  m_columns.clear();
+
+  te::graph::AbstractGraph* graph = gpm->getGraph();
+
+  int weightAttrIdx = 0;
+  m_hasWeights = te::sa::GetGraphEdgeAttrIndex(graph, TE_SA_WEIGHT_ATTR_NAME, weightAttrIdx);
+
+  std::auto_ptr<te::graph::MemoryIterator> it(new te::graph::MemoryIterator(graph));
+
+  //number the vertices in the iterator order
+  std::map<int, std::size_t> indexes;
+
+  m_vertexIds.reserve(it->getVertexInteratorCount());
+
+  te::graph::Vertex* v = it->getFirstVertex();
+
+  while(!it->isVertexIteratorAfterEnd())
+  {
+    indexes[v->getId()] = m_vertexIds.size();
+
+    m_vertexIds.push_back(v->getId());
+
+    v = it->getNextVertex();
+  }
+
+  //resolve the neighbours of each vertex
+  m_offsets.reserve(m_vertexIds.size() + 1);
+  m_offsets.push_back(0);
+
+  v = it->getFirstVertex();
+
+  while(!it->isVertexIteratorAfterEnd())
+  {
+    int id = v->getId();
+
+    std::set<int>& neighbours = v->getSuccessors();
+
+    for(std::set<int>::const_iterator itNeighbours = neighbours.begin(); itNeighbours != neighbours.end(); ++itNeighbours)
+    {
+      te::graph::Edge* e = graph->getEdge(*itNeighbours);
+
+      if(!e)
+        continue;
+
+      int idTo = (e->getIdFrom() == id) ? e->getIdTo() : e->getIdFrom();
+
+      std::map<int, std::size_t>::const_iterator itIdx = indexes.find(idTo);
+
+      if(itIdx == indexes.end())
+        continue;
+
+      m_neighbours.push_back(itIdx->second);
+
+      if(m_hasWeights)
+      {
+        te::dt::AbstractData* ad = e->getAttributes()[weightAttrIdx];
+
+        m_weights.push_back(ad ? te::sa::GetDataValue(ad) : 0.);
+      }
+    }
+
+    m_offsets.push_back(m_neighbours.size());
+
+    v = it->getNextVertex();
+  }
+}
+
+void te::sa::SpatialWeightsMatrix::build(const std::vector<std::size_t>& offsets,
+                                         const std::vector<std::size_t>& neighbours,
+                                         const std::vector<double>& weights)
+{
+  if(offsets.empty() || offsets.front() != 0 || offsets.back() != neighbours.size())
+    throw te::common::Exception(TE_TR("Invalid offsets of the spatial weights matrix."));
+
+  if(!weights.empty() && weights.size() != neighbours.size())
+    throw te::common::Exception(TE_TR("The number of weights must be the number of neighbours."));
+
+  const std::size_t nVertices = offsets.size() - 1;
+
+  for(std::size_t i = 0; i < nVertices; ++i)
+  {
+    if(offsets[i] > offsets[i + 1])
+      throw te::common::Exception(TE_TR("Invalid offsets of the spatial weights matrix."));
+  }
+
+  for(std::size_t k = 0; k < neighbours.size(); ++k)
+  {
+    if(neighbours[k] >= nVertices)
+      throw te::common::Exception(TE_TR("Invalid neighbour of the spatial weights matrix."));
+  }
+
+  m_vertexIds.resize(nVertices);
+
+  for(std::size_t i = 0; i < nVertices; ++i)
+    m_vertexIds[i] = static_cast<int>(i);
+
+  m_offsets = offsets;
+  m_neighbours = neighbours;
+  m_weights = weights;
+  m_hasWeights = !weights.empty() || neighbours.empty();
+  m_columns.clear();
+}
+
+std::size_t te::sa::SpatialWeightsMatrix::getNumberOfVertices() const
+{
+  return m_vertexIds.size();
+}
+
+std::size_t te::sa::SpatialWeightsMatrix::getNumberOfNeighbours(std::size_t i) const
+{
+  assert(i < m_vertexIds.size());
+
+  return m_offsets[i + 1] - m_offsets[i];
+}
+
+int te::sa::SpatialWeightsMatrix::getVertexId(std::size_t i) const
+{
+  assert(i < m_vertexIds.size());
+
+  return m_vertexIds[i];
+}
+
+const std::vector<std::size_t>& te::sa::SpatialWeightsMatrix::getOffsets() const
+{
+  return m_offsets;
+}
+
+const std::vector<std::size_t>& te::sa::SpatialWeightsMatrix::getNeighbours() const
+{
+  return m_neighbours;
+}
+
+bool te::sa::SpatialWeightsMatrix::hasWeights() const
+{
+  return m_hasWeights;
+}
+
+const std::vector<double>& te::sa::SpatialWeightsMatrix::getWeights() const
+{
+  return m_weights;
+}
+
+std::size_t te::sa::SpatialWeightsMatrix::loadColumn(te::sa::GeneralizedProximityMatrix* gpm, int attrIdx)
+{
+  assert(gpm);
+
+  te::graph::AbstractGraph* graph = gpm->getGraph();
+
+  Column c;
+  c.m_name = graph->getVertexProperty(attrIdx)->getName();
+  c.m_dataType = te::dt::DOUBLE_TYPE;
+  c.m_export = false;
+  c.m_values.reserve(m_vertexIds.size());
+
+  std::auto_ptr<te::graph::MemoryIterator> it(new te::graph::MemoryIterator(graph));
+
+  te::graph::Vertex* v = it->getFirstVertex();
+
+  while(!it->isVertexIteratorAfterEnd())
+  {
+    std::vector<te::dt::AbstractData*>& attrs = v->getAttributes();
+
+    te::dt::AbstractData* ad = (attrIdx < (int)attrs.size()) ? attrs[attrIdx] : 0;
+
+    if(!ad)
+      throw te::common::Exception(TE_TR("The gpm vertex has no value for the attribute: ") + c.m_name);
+
+    c.m_values.push_back(te::sa::GetDataValue(ad));
+
+    v = it->getNextVertex();
+  }
+
+  if(c.m_values.size() != m_vertexIds.size())
+    throw te::common::Exception(TE_TR("The gpm was changed after the spatial weights matrix was built."));
+
+  m_columns.push_back(c);
+
+  return m_columns.size() - 1;
+}
+
+std::size_t te::sa::SpatialWeightsMatrix::addColumn(const std::string& name, int dataType)
+{
+  std::size_t idx = 0;
+
+  if(getColumnIndex(name, idx))
+  {
+    m_columns[idx].m_dataType = dataType;
+    m_columns[idx].m_export = true;
+
+    return idx;
+  }
+
+  Column c;
+  c.m_name = name;
+  c.m_dataType = dataType;
+  c.m_export = true;
+  c.m_values.resize(m_vertexIds.size(), 0.);
+
+  m_columns.push_back(c);
+
+  return m_columns.size() - 1;
+}
+
+bool te::sa::SpatialWeightsMatrix::getColumnIndex(const std::string& name, std::size_t& idx) const
+{
+  for(std::size_t i = 0; i < m_columns.size(); ++i)
+  {
+    if(m_columns[i].m_name == name)
+    {
+      idx = i;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+std::vector<double>& te::sa::SpatialWeightsMatrix::getColumn(std::size_t idx)
+{
+  assert(idx < m_columns.size());
+
+  return m_columns[idx].m_values;
+}
+
+const std::vector<double>& te::sa::SpatialWeightsMatrix::getColumn(std::size_t idx) const
+{
+  assert(idx < m_columns.size());
+
+  return m_columns[idx].m_values;
+}
+
+double te::sa::SpatialWeightsMatrix::getSum(std::size_t idx) const
+{
+  const std::vector<double>& values = getColumn(idx);
+
+  double sum = 0.;
+
+  for(std::size_t i = 0; i < values.size(); ++i)
+    sum += values[i];
+
+  return sum;
+}
+
+double te::sa::SpatialWeightsMatrix::getFirstMoment(std::size_t idx) const
+{
+  const std::vector<double>& values = getColumn(idx);
+
+  double mean = 0.;
+
+  for(std::size_t i = 0; i < values.size(); ++i)
+    mean += values[i];
+
+  return mean /= (double)values.size();
+}
+
+double te::sa::SpatialWeightsMatrix::getSecondMoment(std::size_t idx, double mean) const
+{
+  const std::vector<double>& values = getColumn(idx);
+
+  double ssd = 0.; //sum of squares of desviation
+
+  for(std::size_t i = 0; i < values.size(); ++i)
+  {
+    double d = values[i] - mean;
+
+    ssd += d * d;
+  }
+
+  return ssd /= (double)values.size();
+}
+
+int te::sa::SpatialWeightsMatrix::exportColumn(te::sa::GeneralizedProximityMatrix* gpm, std::size_t idx) const
+{
+  assert(gpm);
+  assert(idx < m_columns.size());
+
+  const Column& c = m_columns[idx];
+
+  te::graph::AbstractGraph* graph = gpm->getGraph();
+
+  int attrIdx = 0;
+
+// the columns are never geometries: the default subtype would overflow an int
+  if(!te::sa::GetGraphVertexAttrIndex(graph, c.m_name, attrIdx))
+    attrIdx = te::sa::AddGraphVertexAttribute(graph, c.m_name, c.m_dataType, TE_UNKNOWN_SRS, te::gm::GeometryType);
+
+  int nAttrs = graph->getVertexPropertySize();
+
+  std::auto_ptr<te::graph::MemoryIterator> it(new te::graph::MemoryIterator(graph));
+
+  std::size_t i = 0;
+
+  te::graph::Vertex* v = it->getFirstVertex();
+
+  while(!it->isVertexIteratorAfterEnd())
+  {
+    if(i >= m_vertexIds.size() || v->getId() != m_vertexIds[i])
+      throw te::common::Exception(TE_TR("The gpm was changed after the spatial weights matrix was built."));
+
+    v->setAttributeVecSize(nAttrs);
+
+    if(c.m_dataType == te::dt::INT32_TYPE)
+      v->addAttribute(attrIdx, new te::dt::SimpleData<int, te::dt::INT32_TYPE>(static_cast<int>(c.m_values[i])));
+    else
+      v->addAttribute(attrIdx, new te::dt::SimpleData<double, te::dt::DOUBLE_TYPE>(c.m_values[i]));
+
+    ++i;
+
+    v = it->getNextVertex();
+  }
+
+  return attrIdx;
+}
+
+void te::sa::SpatialWeightsMatrix::exportColumns(te::sa::GeneralizedProximityMatrix* gpm) const
+{
+  for(std::size_t i = 0; i < m_columns.size(); ++i)
+  {
+    if(m_columns[i].m_export)
+      exportColumn(gpm, i);
+  }
+}
@@ -0,0 +1,213 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+  \file terralib/sa/core/SpatialWeightsMatrix.h
+
+  \brief A compressed sparse row representation of the spatial weights of a gpm.
+*/
+
+#ifndef __TERRALIB_SA_INTERNAL_SPATIALWEIGHTSMATRIX_H
+#define __TERRALIB_SA_INTERNAL_SPATIALWEIGHTSMATRIX_H
+
+// TerraLib
+#include "../Config.h"
+
+// STL
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Boost
+#include <boost/noncopyable.hpp>
+
+namespace te
+{
+  namespace sa
+  {
+    // Forward declaration
+    class GeneralizedProximityMatrix;
+
+    /*!
+      \class SpatialWeightsMatrix
+
+      \brief A compressed sparse row (CSR) representation of the spatial weights of a gpm.
+
+      The vertices of the gpm graph are numbered from 0 to N-1, in the order
+      of the graph iterator. The neighbours of the vertex i are the entries
+      from getOffsets()[i] to getOffsets()[i + 1] (exclusive) of the
+      neighbour and weight arrays, so the neighbourhood of all vertices is
+      stored in two contiguous arrays and each edge of the graph is resolved
+      only once, when the matrix is built.
+
+      The matrix also holds dense attribute columns, with one value for each
+      vertex: the input attributes are loaded from the gpm, the spatial
+      statistics functions add their results as new columns, which can be
+      exported back to the gpm as vertex attributes.
+
+      \sa GeneralizedProximityMatrix, SpatialStatisticsFunctions.h
+    */
+    class TESAEXPORT SpatialWeightsMatrix : public boost::noncopyable
+    {
+      public:
+
+        /*! \brief Default constructor. */
+        SpatialWeightsMatrix();
+
+        /*! \brief Destructor. */
+        ~SpatialWeightsMatrix();
+
+        /*!
+          \brief It builds the matrix from the graph of a gpm, discarding any previous content.
+
+          \param gpm Pointer to the gpm.
+
+          \note The weights are read from the edge attribute TE_SA_WEIGHT_ATTR_NAME, if the graph has it.
+        */
+        void build(te::sa::GeneralizedProximityMatrix* gpm);
+
+        /*!
+          \brief It builds the matrix from its CSR arrays, discarding any previous content.
+
+          The vertex ids are the vertex indexes.
+
+          \param offsets    The N+1 offsets of the rows in the neighbour and weight arrays.
+          \param neighbours The vertex indexes of the neighbours of all rows.
+          \param weights    The weights of the neighbours of all rows (empty if there are no weights).
+
+          \exception te::common::Exception It throws an exception if the arrays are not consistent.
+        */
+        void build(const std::vector<std::size_t>& offsets,
+                   const std::vector<std::size_t>& neighbours,
+                   const std::vector<double>& weights);
+
+        /*! \brief It returns the number of vertices (rows) of the matrix. */
+        std::size_t getNumberOfVertices() const;
+
+        /*! \brief It returns the number of neighbours of a vertex. */
+        std::size_t getNumberOfNeighbours(std::size_t i) const;
+
+        /*! \brief It returns the graph id of a vertex. */
+        int getVertexId(std::size_t i) const;
+
+        /*! \brief It returns the N+1 offsets of the rows in the neighbour and weight arrays. */
+        const std::vector<std::size_t>& getOffsets() const;
+
+        /*! \brief It returns the vertex indexes of the neighbours of all rows. */
+        const std::vector<std::size_t>& getNeighbours() const;
+
+        /*! \brief It returns true if the matrix has the weights of the neighbours. */
+        bool hasWeights() const;
+
+        /*! \brief It returns the weights of the neighbours of all rows (empty if the gpm has no weights). */
+        const std::vector<double>& getWeights() const;
+
+        /*!
+          \brief It loads a vertex attribute of the gpm as a column.
+
+          \param gpm     Pointer to the gpm used to build the matrix.
+          \param attrIdx The vertex attribute index.
+
+          \return The column index. The column is not exported back to the gpm.
+
+          \exception te::common::Exception It throws an exception if a vertex has no value for the attribute.
+        */
+        std::size_t loadColumn(te::sa::GeneralizedProximityMatrix* gpm, int attrIdx);
+
+        /*!
+          \brief It adds a column, filled with zeros, or returns the column with the same name.
+
+          \param name     The column name, that is also the name of the exported vertex attribute.
+          \param dataType The data type of the exported vertex attribute (te::dt::DOUBLE_TYPE or te::dt::INT32_TYPE).
+
+          \return The column index.
+        */
+        std::size_t addColumn(const std::string& name, int dataType);
+
+        /*!
+          \brief It searches a column by its name.
+
+          \param name The column name.
+          \param idx  The column index, if it was found.
+
+          \return True if the column was found.
+        */
+        bool getColumnIndex(const std::string& name, std::size_t& idx) const;
+
+        /*! \brief It returns the values of a column. */
+        std::vector<double>& getColumn(std::size_t idx);
+
+        /*! \brief It returns the values of a column. */
+        const std::vector<double>& getColumn(std::size_t idx) const;
+
+        /*! \brief It returns the sum of the values of a column. */
+        double getSum(std::size_t idx) const;
+
+        /*! \brief It returns the mean of the values of a column. */
+        double getFirstMoment(std::size_t idx) const;
+
+        /*! \brief It returns the mean of the squared deviations of the values of a column from a given mean. */
+        double getSecondMoment(std::size_t idx, double mean) const;
+
+        /*!
+          \brief It exports a column as a vertex attribute of the gpm.
+
+          \param gpm Pointer to the gpm used to build the matrix.
+          \param idx The column index.
+
+          \return The vertex attribute index.
+        */
+        int exportColumn(te::sa::GeneralizedProximityMatrix* gpm, std::size_t idx) const;
+
+        /*!
+          \brief It exports all the columns added to the matrix as vertex attributes of the gpm.
+
+          \param gpm Pointer to the gpm used to build the matrix.
+        */
+        void exportColumns(te::sa::GeneralizedProximityMatrix* gpm) const;
+
+      private:
+
+        /*!
+          \struct Column
+
+          \brief A dense attribute column.
+        */
+        struct Column
+        {
+          std::string m_name;              //!< The column name.
+          int m_dataType;                  //!< The data type of the exported vertex attribute.
+          bool m_export;                   //!< False for the columns loaded from the gpm.
+          std::vector<double> m_values;    //!< One value for each vertex.
+        };
+
+      private:
+
+        std::vector<int> m_vertexIds;              //!< The graph id of each vertex.
+        std::vector<std::size_t> m_offsets;        //!< The offsets of the rows (N+1 entries).
+        std::vector<std::size_t> m_neighbours;     //!< The vertex indexes of the neighbours.
+        std::vector<double> m_weights;             //!< The weights of the neighbours.
+        bool m_hasWeights;                         //!< True if the gpm has the weights of the edges.
+        std::vector<Column> m_columns;             //!< The attribute columns.
+    };
+
+  } // end namespace sa
+}   // end namespace te
+
+#endif  // __TERRALIB_SA_INTERNAL_SPATIALWEIGHTSMATRIX_H
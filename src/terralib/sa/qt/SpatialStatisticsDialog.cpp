@@ -39,6 +39,7 @@
 #include "../core/GPMWeightsNoWeightsStrategy.h"
 #include "../core/SpatialStatisticsFunctions.h"
 #include "../core/SpatialWeightsExchanger.h"
+#include "../core/SpatialWeightsMatrix.h"
 #include "../core/StatisticsFunctions.h"
 #include "../core/Utils.h"
 #include "../Exception.h"
@@ -238,6 +239,23 @@ void te::sa::SpatialStatisticsDialog::onOkPushButtonClicked()
   //associate the selected attribute to the GPM
   int attrIdx = te::sa::AssociateGPMVertexAttribute(gpm.get(), ds.get(), dsLayer->getDataSetName(), attrLink, attrName, type);
 
+  //the statistics are calculated over the sparse weights of the GPM and exported back to the GPM at the end
+  te::sa::SpatialWeightsMatrix swm;
+
+  std::size_t column = 0;
+
+  try
+  {
+    swm.build(gpm.get());
+
+    column = swm.loadColumn(gpm.get(), attrIdx);
+  }
+  catch(const std::exception& e)
+  {
+    QMessageBox::warning(this, tr("Warning"), e.what());
+    return;
+  }
+
   //start calculate the operations
   te::qt::widgets::ProgressViewerDialog v(this);
   int id = te::common::ProgressManager::getInstance().addViewer(&v);
@@ -249,7 +267,7 @@ void te::sa::SpatialStatisticsDialog::onOkPushButtonClicked()
   {
     try
     {
-      te::sa::GStatistics(gpm.get(), attrIdx); //this function calculates the g and g* statistics and adds the values as attribute in each vertex from gpm graph.
+      te::sa::GStatistics(swm, column); //this function calculates the g and g* statistics and adds the values as columns of the spatial weights matrix.
     }
     catch(const std::exception& e)
     {
@@ -278,7 +296,7 @@ void te::sa::SpatialStatisticsDialog::onOkPushButtonClicked()
   {
     try
     {
-      te::sa::LocalMean(gpm.get(), attrIdx); //this function calculates the local mean statistics and adds the values as attribute in each vertex from gpm graph.
+      te::sa::LocalMean(swm, column); //this function calculates the local mean statistics and adds the values as columns of the spatial weights matrix.
     }
     catch(const std::exception& e)
     {
@@ -307,9 +325,9 @@ void te::sa::SpatialStatisticsDialog::onOkPushButtonClicked()
   {
     try
     {
-      te::sa::ZAndWZ(gpm.get(), attrIdx); //this function calculates the standard deviation Z and local mean of the desviation Z (WZ).
+      te::sa::ZAndWZ(swm, column); //this function calculates the standard deviation Z and local mean of the desviation Z (WZ).
 
-      double globalMoranIndex = te::sa::MoranIndex(gpm.get()); //this function calculates the moran index, global and local.
+      double globalMoranIndex = te::sa::MoranIndex(swm); //this function calculates the moran index, global and local.
 
       //set the global moran index value
       if(m_ui->m_globalMoranIndexCheckBox->isChecked())
@@ -327,12 +345,12 @@ void te::sa::SpatialStatisticsDialog::onOkPushButtonClicked()
         else if(m_ui->m_globalEval999RadioButton->isChecked())
           permutValue = 999;
 
-        double globalMoranSignificance = te::sa::GlobalMoranSignificance(gpm.get(), attrIdx, permutValue, globalMoranIndex); //this function calculates the significance of the moran index.
+        double globalMoranSignificance = te::sa::GlobalMoranSignificance(swm, column, permutValue, globalMoranIndex); //this function calculates the significance of the moran index.
 
         m_ui->m_globalMoranIndexPValueLineEdit->setText(QString::number(globalMoranSignificance));
       }
 
-      te::sa::BoxMap(gpm.get(), 0); //this function calculates the box map information, needs Z and WZ information... MEAN = 0 ??
+      te::sa::BoxMap(swm, 0); //this function calculates the box map information, needs Z and WZ information... MEAN = 0 ??
 
       //evaluating the significance of LISA.
       if(m_ui->m_localMoranIndex->isChecked() && !m_ui->m_localEvalNotRadioButton->isChecked())
@@ -346,11 +364,11 @@ void te::sa::SpatialStatisticsDialog::onOkPushButtonClicked()
         else if(m_ui->m_localEval9999RadioButton->isChecked())
           permutValue = 9999;
 
-        te::sa::LisaStatisticalSignificance(gpm.get(), permutValue); //this function calculates the lisa (local moran index) significance, needs Z, Local Moran and Number of Neighbours attributes calculated.
+        te::sa::LisaStatisticalSignificance(swm, permutValue); //this function calculates the lisa (local moran index) significance, needs Z, Local Moran and Number of Neighbours attributes calculated.
 
-        te::sa::LISAMap(gpm.get(), permutValue); //this function calculates the lisa map, needs LISASig attribute calculated.
+        te::sa::LISAMap(swm, permutValue); //this function calculates the lisa map, needs LISASig attribute calculated.
 
-        te::sa::MoranMap(gpm.get()); //this function calculates the moran map, needs LISAMap and BoxMAP attributes calculated.
+        te::sa::MoranMap(swm); //this function calculates the moran map, needs LISAMap and BoxMAP attributes calculated.
       }
     }
     catch(const std::exception& e)
@@ -400,6 +418,8 @@ void te::sa::SpatialStatisticsDialog::onOkPushButtonClicked()
 
   try
   {
+    swm.exportColumns(gpm.get());
+
     gpm->toDataSource(outputDataSource, dataSetName);
   }
   catch(const std::exception& e)
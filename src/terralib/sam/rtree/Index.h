@@ -31,7 +31,12 @@
 #include "PartitionVars.h"
 
 // STL
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <limits>
+#include <queue>
+#include <utility>
 #include <vector>
 
 namespace te
@@ -51,7 +56,16 @@ namespace te
         
         and in his original source code.
 
-        \todo Implement nearest neighbour query.
+        \note This tree may be built by two ways:
+              1) Inserting each element in the tree. In this case the nodes are split using the Guttman's quadratic method.
+              2) Passing a container with pairs (mbr/data-item) to the method bulkLoad. In this case the tree
+                 is packed using the Sort-Tile-Recursive (STR) algorithm described in:
+                 <i>Scott T. Leutenegger, Mario A. Lopez, Jeffrey Edgington. STR: A Simple and Efficient Algorithm for R-Tree Packing. ICDE, 1997, pp. 497-506</i>.
+                 The resulting tree has almost full nodes with low overlapping and is built in time O(N log N).
+                 Items can still be inserted or removed after a bulk load.
+
+        \note Nearest neighbour and distance queries use the incremental best-first algorithm described in:
+              <i>Gisli R. Hjaltason, Hanan Samet. Distance Browsing in Spatial Databases. ACM TODS, 24(2), 1999, pp. 265-318</i>.
       */
       template<class DATATYPE, int MAXNODES = 8, int MINNODES = MAXNODES / 2> class Index
       {
@@ -60,6 +74,7 @@ namespace te
           typedef Node<DATATYPE, MAXNODES, MINNODES> NodeType;
           typedef typename NodeType::BranchType BranchType;
           typedef typename te::sam::rtree::PartitionVars<BranchType, MAXNODES> PartitionVarsType;
+          typedef std::pair<te::gm::Envelope, DATATYPE> ItemType;
 
           /*! \brief Constructor. */
           Index();
@@ -111,6 +126,15 @@ namespace te
           */
           bool remove(const te::gm::Envelope& mbr, const DATATYPE& data);
 
+          /*!
+            \brief It clears the tree and builds a packed tree with the given items using the Sort-Tile-Recursive algorithm.
+
+            \param items The items (object MBR and object) to be indexed.
+
+            \note The items vector will be reordered.
+          */
+          void bulkLoad(std::vector<ItemType>& items);
+
           /*!
             \brief Range search query.
 
@@ -121,6 +145,79 @@ namespace te
           */
           int search(const te::gm::Envelope& mbr, std::vector<DATATYPE>& report) const;
 
+          /*!
+            \brief Nearest neighbour query: it finds the k objects nearest to a given rectangle.
+
+            The distance between the query and an object is the minimum distance between
+            the query rectangle and the object MBR.
+
+            \param mbr       The query rectangle (a point may be represented by a degenerated rectangle).
+            \param k         The maximum number of objects to be reported.
+            \param report    A vector to output the found objects, sorted by their distance to the query.
+            \param distances A vector to output the distance of each found object.
+
+            \return The number of found objects.
+          */
+          int nearestNeighborSearch(const te::gm::Envelope& mbr, std::size_t k,
+                                    std::vector<DATATYPE>& report, std::vector<double>& distances) const;
+
+          /*!
+            \brief Nearest neighbour query: it finds the k objects nearest to a given rectangle.
+
+            \param mbr           The query rectangle.
+            \param k             The maximum number of objects to be reported.
+            \param report        A vector to output the found objects, sorted by their exact distance to the query.
+            \param distances     A vector to output the exact distance of each found object.
+            \param exactDistance A function object with the signature <i>double (const DATATYPE&)</i> returning
+                                  the exact distance between the query and an indexed object.
+
+            \note The exact distance of an object must never be less than the distance between the query and the object MBR.
+          */
+          template<class DistanceFunctor>
+          int nearestNeighborSearch(const te::gm::Envelope& mbr, std::size_t k,
+                                    std::vector<DATATYPE>& report, std::vector<double>& distances,
+                                    const DistanceFunctor& exactDistance) const;
+
+          /*!
+            \brief Distance query: it finds the objects within a given distance of a rectangle.
+
+            \param mbr       The query rectangle.
+            \param distance  The maximum distance between the query rectangle and the objects MBR.
+            \param report    A vector to output the found objects, sorted by their distance to the query.
+            \param distances A vector to output the distance of each found object.
+
+            \return The number of found objects.
+          */
+          int withinDistanceSearch(const te::gm::Envelope& mbr, double distance,
+                                   std::vector<DATATYPE>& report, std::vector<double>& distances) const;
+
+          /*!
+            \brief Distance query: it finds the objects within a given distance of a rectangle.
+
+            \param mbr           The query rectangle.
+            \param distance      The maximum exact distance between the query and the objects.
+            \param report        A vector to output the found objects, sorted by their exact distance to the query.
+            \param distances     A vector to output the exact distance of each found object.
+            \param exactDistance A function object with the signature <i>double (const DATATYPE&)</i> returning
+                                  the exact distance between the query and an indexed object.
+
+            \note The exact distance of an object must never be less than the distance between the query and the object MBR.
+          */
+          template<class DistanceFunctor>
+          int withinDistanceSearch(const te::gm::Envelope& mbr, double distance,
+                                   std::vector<DATATYPE>& report, std::vector<double>& distances,
+                                   const DistanceFunctor& exactDistance) const;
+
+          /*!
+            \brief It returns the minimum distance between two rectangles.
+
+            \param mbrA The first rectangle.
+            \param mbrB The second rectangle.
+
+            \return The minimum distance between the rectangles (zero if they intersect).
+          */
+          static double minDistance(const te::gm::Envelope& mbrA, const te::gm::Envelope& mbrB);
+
           /*!
             \brief It sets the bounding box of all elements in the tree.
 
@@ -137,6 +234,57 @@ namespace te
 
         protected:
 
+          /*! \brief The default distance function: the objects distance is the distance to their MBR. */
+          struct MBRDistance
+          {
+          };
+
+          /*! \brief An entry of the best-first search queue: a node or an object. */
+          struct DistanceEntry
+          {
+            double m_distance;        //!< The distance to the query.
+            const NodeType* m_node;   //!< The node or null if the entry is an object.
+            DATATYPE m_data;          //!< The object, if m_node is null.
+            bool m_refined;           //!< True if the object distance is exact.
+
+            bool operator<(const DistanceEntry& rhs) const
+            {
+// the priority queue returns the greatest entry: the nearest one, preferring exact objects on ties
+              if(m_distance != rhs.m_distance)
+                return m_distance > rhs.m_distance;
+
+              return (!m_refined && rhs.m_refined);
+            }
+          };
+
+          /*!
+            \brief Incremental best-first search.
+
+            \param mbr           The query rectangle.
+            \param k             The maximum number of objects to be reported.
+            \param maxDistance   The maximum distance of the reported objects.
+            \param report        A vector to output the found objects.
+            \param distances     A vector to output the distance of each found object.
+            \param exactDistance The function used to refine the objects distance.
+          */
+          template<class DistanceFunctor>
+          int bestFirstSearch(const te::gm::Envelope& mbr, std::size_t k, double maxDistance,
+                              std::vector<DATATYPE>& report, std::vector<double>& distances,
+                              const DistanceFunctor& exactDistance) const;
+
+          /*! \brief It refines the distance of an object using the given function. */
+          template<class DistanceFunctor>
+          static double refineDistance(const DistanceFunctor& exactDistance, const DATATYPE& data, double /*mbrDistance*/)
+          {
+            return exactDistance(data);
+          }
+
+          /*! \brief The default refinement keeps the MBR distance. */
+          static double refineDistance(const MBRDistance& /*exactDistance*/, const DATATYPE& /*data*/, double mbrDistance)
+          {
+            return mbrDistance;
+          }
+
           /*!
             \brief It inserts a data rectangle into an index structure.
 
@@ -220,6 +368,20 @@ namespace te
 
           void loadNodes(NodeType* n, NodeType* q, PartitionVarsType& p) const;
 
+          /*!
+            \brief It packs a level of branches into nodes, replacing the branches by the ones pointing to the new nodes.
+
+            \param branches The branches to be packed.
+            \param level    The level of the new nodes.
+          */
+          void packLevel(std::vector<BranchType>& branches, int level);
+
+          /*! \brief It returns true if the center of the first branch MBR is on the left of the second one. */
+          static bool lessCenterX(const BranchType& a, const BranchType& b);
+
+          /*! \brief It returns true if the center of the first branch MBR is below the second one. */
+          static bool lessCenterY(const BranchType& a, const BranchType& b);
+
           /*!
             \brief Erases a node from the tree and all nodes below it.
 
@@ -322,6 +484,42 @@ namespace te
         return remove(mbr, data, &m_root);
       }
 
+      template<class DATATYPE, int MAXNODES, int MINNODES> inline
+      void Index<DATATYPE, MAXNODES, MINNODES>::bulkLoad(std::vector<ItemType>& items)
+      {
+        clear();
+
+        m_mbr = te::gm::Envelope();
+
+        if(items.empty())
+          return;
+
+// the leaf level branches
+        std::vector<BranchType> branches(items.size());
+
+        for(std::size_t i = 0; i < items.size(); ++i)
+        {
+          branches[i].m_mbr = items[i].first;
+          branches[i].m_data = items[i].second;
+
+          m_mbr.Union(items[i].first);
+        }
+
+// pack each level until the remaining branches fit in the root node
+        int level = 0;
+
+        while(branches.size() > static_cast<std::size_t>(MAXNODES))
+        {
+          packLevel(branches, level);
+          ++level;
+        }
+
+        m_root->m_level = level;
+
+        for(std::size_t i = 0; i < branches.size(); ++i)
+          addBranch(&branches[i], m_root, 0);
+      }
+
       template<class DATATYPE, int MAXNODES, int MINNODES> inline
       int Index<DATATYPE, MAXNODES, MINNODES>::search(const te::gm::Envelope& mbr, std::vector<DATATYPE>& report) const
       {
@@ -333,6 +531,48 @@ namespace te
         return foundObjs;
       }
 
+      template<class DATATYPE, int MAXNODES, int MINNODES> inline
+      int Index<DATATYPE, MAXNODES, MINNODES>::nearestNeighborSearch(const te::gm::Envelope& mbr, std::size_t k,
+                                                                     std::vector<DATATYPE>& report, std::vector<double>& distances) const
+      {
+        return bestFirstSearch(mbr, k, std::numeric_limits<double>::max(), report, distances, MBRDistance());
+      }
+
+      template<class DATATYPE, int MAXNODES, int MINNODES> template<class DistanceFunctor> inline
+      int Index<DATATYPE, MAXNODES, MINNODES>::nearestNeighborSearch(const te::gm::Envelope& mbr, std::size_t k,
+                                                                     std::vector<DATATYPE>& report, std::vector<double>& distances,
+                                                                     const DistanceFunctor& exactDistance) const
+      {
+        return bestFirstSearch(mbr, k, std::numeric_limits<double>::max(), report, distances, exactDistance);
+      }
+
+      template<class DATATYPE, int MAXNODES, int MINNODES> inline
+      int Index<DATATYPE, MAXNODES, MINNODES>::withinDistanceSearch(const te::gm::Envelope& mbr, double distance,
+                                                                    std::vector<DATATYPE>& report, std::vector<double>& distances) const
+      {
+        return bestFirstSearch(mbr, std::numeric_limits<std::size_t>::max(), distance, report, distances, MBRDistance());
+      }
+
+      template<class DATATYPE, int MAXNODES, int MINNODES> template<class DistanceFunctor> inline
+      int Index<DATATYPE, MAXNODES, MINNODES>::withinDistanceSearch(const te::gm::Envelope& mbr, double distance,
+                                                                    std::vector<DATATYPE>& report, std::vector<double>& distances,
+                                                                    const DistanceFunctor& exactDistance) const
+      {
+        return bestFirstSearch(mbr, std::numeric_limits<std::size_t>::max(), distance, report, distances, exactDistance);
+      }
+
+      template<class DATATYPE, int MAXNODES, int MINNODES> inline
+      double Index<DATATYPE, MAXNODES, MINNODES>::minDistance(const te::gm::Envelope& mbrA, const te::gm::Envelope& mbrB)
+      {
+        double dx = std::max(mbrA.m_llx - mbrB.m_urx, mbrB.m_llx - mbrA.m_urx);
+        double dy = std::max(mbrA.m_lly - mbrB.m_ury, mbrB.m_lly - mbrA.m_ury);
+
+        dx = std::max(dx, 0.0);
+        dy = std::max(dy, 0.0);
+
+        return std::sqrt(dx * dx + dy * dy);
+      }
+
       template<class DATATYPE, int MAXNODES, int MINNODES> inline
       void Index<DATATYPE, MAXNODES, MINNODES>::setMBR(const te::gm::Envelope& mbr)
       {
@@ -558,6 +798,87 @@ namespace te
         return;
       }
 
+      template<class DATATYPE, int MAXNODES, int MINNODES> template<class DistanceFunctor>
+      int Index<DATATYPE, MAXNODES, MINNODES>::bestFirstSearch(const te::gm::Envelope& mbr, std::size_t k, double maxDistance,
+                                                               std::vector<DATATYPE>& report, std::vector<double>& distances,
+                                                               const DistanceFunctor& exactDistance) const
+      {
+        int foundObjs = 0;
+
+        if((m_root == 0) || (k == 0))
+          return foundObjs;
+
+        std::priority_queue<DistanceEntry> queue;
+
+        DistanceEntry entry;
+        entry.m_distance = 0.0;
+        entry.m_node = m_root;
+        entry.m_refined = false;
+
+        queue.push(entry);
+
+        while(!queue.empty())
+        {
+          const DistanceEntry top = queue.top();
+          queue.pop();
+
+          if(top.m_distance > maxDistance)
+            break;
+
+          if(top.m_node)
+          {
+// expand the node: its children are nodes or objects with unrefined distances
+            const NodeType* node = top.m_node;
+
+            for(int i = 0; i < node->m_count; ++i)
+            {
+              entry.m_distance = minDistance(mbr, node->m_branch[i].m_mbr);
+
+              if(entry.m_distance > maxDistance)
+                continue;
+
+              if(node->isInternalNode())
+              {
+                entry.m_node = node->m_branch[i].m_child;
+              }
+              else
+              {
+                entry.m_node = 0;
+                entry.m_data = node->m_branch[i].m_data;
+              }
+
+              entry.m_refined = false;
+
+              queue.push(entry);
+            }
+          }
+          else if(!top.m_refined)
+          {
+// compute the exact distance and put the object back in the queue
+            entry.m_distance = refineDistance(exactDistance, top.m_data, top.m_distance);
+            entry.m_node = 0;
+            entry.m_data = top.m_data;
+            entry.m_refined = true;
+
+            if(entry.m_distance <= maxDistance)
+              queue.push(entry);
+          }
+          else
+          {
+// no other entry can be nearer than this object
+            report.push_back(top.m_data);
+            distances.push_back(top.m_distance);
+
+            ++foundObjs;
+
+            if(static_cast<std::size_t>(foundObjs) >= k)
+              break;
+          }
+        }
+
+        return foundObjs;
+      }
+
       template<class DATATYPE, int MAXNODES, int MINNODES>
       te::gm::Envelope Index<DATATYPE, MAXNODES, MINNODES>::nodeCover(NodeType* n) const
       {
@@ -875,6 +1196,67 @@ namespace te
         }
       }
 
+      template<class DATATYPE, int MAXNODES, int MINNODES> inline
+      void Index<DATATYPE, MAXNODES, MINNODES>::packLevel(std::vector<BranchType>& branches, int level)
+      {
+        const std::size_t n = branches.size();
+
+// number of nodes and number of vertical slices
+        const std::size_t nnodes = (n + MAXNODES - 1) / MAXNODES;
+        const std::size_t nslices = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(nnodes))));
+        const std::size_t sliceCapacity = ((nnodes + nslices - 1) / nslices) * MAXNODES;
+
+        std::sort(branches.begin(), branches.end(), &Index::lessCenterX);
+
+        std::vector<BranchType> parents;
+        parents.reserve(nnodes);
+
+        for(std::size_t sliceBegin = 0; sliceBegin < n; sliceBegin += sliceCapacity)
+        {
+          const std::size_t sliceEnd = std::min(sliceBegin + sliceCapacity, n);
+
+          std::sort(branches.begin() + sliceBegin, branches.begin() + sliceEnd, &Index::lessCenterY);
+
+// distribute the slice branches evenly among its nodes
+          const std::size_t sliceSize = sliceEnd - sliceBegin;
+          const std::size_t sliceNodes = (sliceSize + MAXNODES - 1) / MAXNODES;
+
+          std::size_t b = sliceBegin;
+
+          for(std::size_t j = 0; j < sliceNodes; ++j)
+          {
+            const std::size_t count = (sliceSize / sliceNodes) + ((j < (sliceSize % sliceNodes)) ? 1 : 0);
+
+            ++m_size;
+            NodeType* node = new NodeType();
+            node->m_level = level;
+
+            for(std::size_t k = 0; k < count; ++k, ++b)
+              addBranch(&branches[b], node, 0);
+
+            BranchType parent;
+            parent.m_child = node;
+            parent.m_mbr = nodeCover(node);
+
+            parents.push_back(parent);
+          }
+        }
+
+        branches.swap(parents);
+      }
+
+      template<class DATATYPE, int MAXNODES, int MINNODES> inline
+      bool Index<DATATYPE, MAXNODES, MINNODES>::lessCenterX(const BranchType& a, const BranchType& b)
+      {
+        return (a.m_mbr.m_llx + a.m_mbr.m_urx) < (b.m_mbr.m_llx + b.m_mbr.m_urx);
+      }
+
+      template<class DATATYPE, int MAXNODES, int MINNODES> inline
+      bool Index<DATATYPE, MAXNODES, MINNODES>::lessCenterY(const BranchType& a, const BranchType& b)
+      {
+        return (a.m_mbr.m_lly + a.m_mbr.m_ury) < (b.m_mbr.m_lly + b.m_mbr.m_ury);
+      }
+
       template<class DATATYPE, int MAXNODES, int MINNODES> inline
       void Index<DATATYPE, MAXNODES, MINNODES>::erase(NodeType* node)
       {
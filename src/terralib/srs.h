@@ -28,6 +28,7 @@
 // TerraLib
 #include "srs/Config.h"
 #include "srs/Converter.h"
+#include "srs/ConverterCache.h"
 #include "srs/SpatialReferenceSystem.h"
 #include "srs/Datum.h"
 #include "srs/Ellipsoid.h"
@@ -37,16 +37,157 @@
 
 // STL
 #include <cassert>
+#include <cstdlib>
 #include <cstring>
+#include <map>
+#include <sstream>
 
 // Boost
 #include <boost/thread/mutex.hpp>
 
+namespace
+{
+  typedef std::map<std::string, std::string> P4Params;
+
+  //! It splits a PROJ4 description into its parameters, skipping the ones that don't change the coordinates.
+  void SplitP4Txt(const std::string& pj4txt, P4Params& params)
+  {
+    std::istringstream is(pj4txt);
+    std::string token;
+
+    while(is >> token)
+    {
+      if(token[0] == '+')
+        token.erase(0, 1);
+
+      if(token.empty())
+        continue;
+
+      std::string::size_type pos = token.find('=');
+      std::string key = token.substr(0, pos);
+      std::string value = (pos == std::string::npos) ? std::string() : token.substr(pos + 1);
+
+      if(key == "no_defs" || key == "wktext" || key == "type")
+        continue;
+
+      params[key] = value;
+    }
+  }
+
+  //! It parses a number, that may be written as a fraction (as in +to_meter=1/3).
+  bool ParseNumber(const std::string& txt, double& value)
+  {
+    if(txt.empty())
+      return false;
+
+    const char* begin = txt.c_str();
+    char* end = 0;
+    value = strtod(begin, &end);
+
+    if(end == begin)
+      return false;
+
+    if(*end == '/')
+    {
+      const char* denBegin = end + 1;
+      double den = strtod(denBegin, &end);
+
+      if(end == denBegin || den == 0.0)
+        return false;
+
+      value /= den;
+    }
+
+    return *end == '\0';
+  }
+
+  //! It returns the size in meters of a PROJ4 linear unit, or 0 if the unit is not known.
+  double GetUnitToMeter(const std::string& unit)
+  {
+    static const struct { const char* m_id; double m_toMeter; } units[] =
+    {
+      { "m", 1.0 },
+      { "km", 1000.0 },
+      { "dm", 0.1 },
+      { "cm", 0.01 },
+      { "mm", 0.001 },
+      { "kmi", 1852.0 },
+      { "in", 0.0254 },
+      { "ft", 0.3048 },
+      { "yd", 0.9144 },
+      { "mi", 1609.344 },
+      { "us-in", 1.0 / 39.37 },
+      { "us-ft", 0.304800609601219 },
+      { "us-yd", 0.914401828803658 },
+      { "us-mi", 1609.347218694437 }
+    };
+
+    for(std::size_t i = 0; i < sizeof(units) / sizeof(units[0]); ++i)
+      if(unit == units[i].m_id)
+        return units[i].m_toMeter;
+
+    return 0.0;
+  }
+
+  /*!
+    It removes the linear parameters (unit, false easting and false northing) of a
+    PROJ4 description, returning their values. It returns false if a value is not understood.
+  */
+  bool ExtractLinearParams(P4Params& params, double& toMeter, double& x0, double& y0)
+  {
+    toMeter = 1.0;
+    x0 = 0.0;
+    y0 = 0.0;
+
+    P4Params::iterator it = params.find("to_meter");
+
+    if(it != params.end())
+    {
+      if(!ParseNumber(it->second, toMeter) || toMeter <= 0.0)
+        return false;
+
+      params.erase(it);
+      params.erase("units");
+    }
+    else if((it = params.find("units")) != params.end())
+    {
+      toMeter = GetUnitToMeter(it->second);
+
+      if(toMeter == 0.0)
+        return false;
+
+      params.erase(it);
+    }
+
+    if((it = params.find("x_0")) != params.end())
+    {
+      if(!ParseNumber(it->second, x0))
+        return false;
+
+      params.erase(it);
+    }
+
+    if((it = params.find("y_0")) != params.end())
+    {
+      if(!ParseNumber(it->second, y0))
+        return false;
+
+      params.erase(it);
+    }
+
+    return true;
+  }
+}
+
 te::srs::Converter::Converter():
   m_targetSRID(TE_UNKNOWN_SRS),
   m_sourceSRID(TE_UNKNOWN_SRS),
   m_sourcePj4Handler(0),
-  m_targetPj4Handler(0)
+  m_targetPj4Handler(0),
+  m_fastPath(NoFastPath),
+  m_scale(1.0),
+  m_offsetX(0.0),
+  m_offsetY(0.0)
 {
 }
 
@@ -54,7 +195,11 @@ te::srs::Converter::Converter(int sourceSRID, int targetSRID):
   m_targetSRID(targetSRID),
   m_sourceSRID(sourceSRID),
   m_sourcePj4Handler(0),
-  m_targetPj4Handler(0)
+  m_targetPj4Handler(0),
+  m_fastPath(NoFastPath),
+  m_scale(1.0),
+  m_offsetX(0.0),
+  m_offsetY(0.0)
 {
 #ifdef TERRALIB_PROJ4_ENABLED  
   std::string description = te::srs::SpatialReferenceSystemManager::getInstance().getP4Txt(sourceSRID);
@@ -69,6 +214,8 @@ te::srs::Converter::Converter(int sourceSRID, int targetSRID):
     exceptionTxt += std::string(pjError);
     throw te::srs::Exception(exceptionTxt);
   }  
+
+  m_sourcePj4Txt = description;
   
   description = te::srs::SpatialReferenceSystemManager::getInstance().getP4Txt(targetSRID);
   if ( description.empty())
@@ -82,7 +229,11 @@ te::srs::Converter::Converter(int sourceSRID, int targetSRID):
     exceptionTxt += std::string(pjError);
     throw te::srs::Exception(exceptionTxt);
   }
+
+  m_targetPj4Txt = description;
 #endif
+
+  updateFastPath();
 }
 
 te::srs::Converter::~Converter()
@@ -113,6 +264,8 @@ te::srs::Converter::setSourceSRID(int sourceSRID)
     m_sourcePj4Handler = 0;
   }
 
+  m_sourcePj4Txt.clear();
+
   std::string description = te::srs::SpatialReferenceSystemManager::getInstance().getP4Txt(sourceSRID);
   if (description.empty())
   {
@@ -133,9 +286,13 @@ te::srs::Converter::setSourceSRID(int sourceSRID)
 
     throw te::srs::Exception(exceptionTxt);
   }
+
+  m_sourcePj4Txt = description;
 #endif
   m_sourceSRID = sourceSRID;
 
+  updateFastPath();
+
   lockGuard.release();
   getStaticMutex().unlock();
 }
@@ -150,6 +307,8 @@ void te::srs::Converter::setSourcePJ4txt(const std::string& pj4txt)
     pj_free(m_sourcePj4Handler);
     m_sourcePj4Handler = 0;
   }
+
+  m_sourcePj4Txt.clear();
   
   m_sourcePj4Handler = pj_init_plus(pj4txt.c_str());
   if (!m_sourcePj4Handler)
@@ -161,6 +320,9 @@ void te::srs::Converter::setSourcePJ4txt(const std::string& pj4txt)
   }
 #endif
   m_sourceSRID = TE_UNKNOWN_SRS;
+  m_sourcePj4Txt = pj4txt;
+
+  updateFastPath();
 }
 
 int 
@@ -181,6 +343,8 @@ te::srs::Converter::setTargetSRID(int targetSRID)
     m_targetPj4Handler = 0;
   }
 
+  m_targetPj4Txt.clear();
+
   std::string description = te::srs::SpatialReferenceSystemManager::getInstance().getP4Txt(targetSRID);
   if (description.empty())
   {
@@ -202,9 +366,13 @@ te::srs::Converter::setTargetSRID(int targetSRID)
 
     throw te::srs::Exception(exceptionTxt);
   }
+
+  m_targetPj4Txt = description;
 #endif
   m_targetSRID = targetSRID;  
 
+  updateFastPath();
+
   lockGuard.release();
   getStaticMutex().unlock();
 }
@@ -219,6 +387,8 @@ void te::srs::Converter::setTargetPJ4txt(const std::string& pj4txt)
     pj_free(m_targetPj4Handler);
     m_targetPj4Handler = 0;
   }
+
+  m_targetPj4Txt.clear();
   
   m_targetPj4Handler = pj_init_plus(pj4txt.c_str());
   if (!m_targetPj4Handler)
@@ -230,6 +400,9 @@ void te::srs::Converter::setTargetPJ4txt(const std::string& pj4txt)
   }
 #endif
   m_targetSRID = TE_UNKNOWN_SRS;
+  m_targetPj4Txt = pj4txt;
+
+  updateFastPath();
 }
 
 int 
@@ -241,12 +414,14 @@ te::srs::Converter::getTargetSRID() const
 bool
 te::srs::Converter::convert(double *xIn, double *yIn, double *xOut, double* yOut, long numCoord, int coordOffset) const
 {
+  if (convertFast(xIn, yIn, xOut, yOut, numCoord, coordOffset, false))
+    return true;
+
 #ifdef TERRALIB_PROJ4_ENABLED 
   assert(m_sourcePj4Handler);
   assert(m_targetPj4Handler);
 
-  memcpy(xOut, xIn, numCoord*sizeof(double));
-  memcpy(yOut, yIn, numCoord*sizeof(double));
+  for (long i=0; i<numCoord; xOut[i*coordOffset]=xIn[i*coordOffset], yOut[i*coordOffset]=yIn[i*coordOffset], ++i);
 
   if (pj_is_latlong(m_sourcePj4Handler))
     for (long i=0; i<numCoord; xOut[i*coordOffset]*=DEG_TO_RAD, yOut[i*coordOffset]*=DEG_TO_RAD,  ++i);
@@ -265,6 +440,9 @@ te::srs::Converter::convert(double *xIn, double *yIn, double *xOut, double* yOut
 bool
 te::srs::Converter::convert(double *x, double* y, long numCoord, int coordOffset) const
 {
+  if (convertFast(x, y, x, y, numCoord, coordOffset, false))
+    return true;
+
 #ifdef TERRALIB_PROJ4_ENABLED 
   assert(m_sourcePj4Handler);
   assert(m_targetPj4Handler);
@@ -286,6 +464,9 @@ te::srs::Converter::convert(double *x, double* y, long numCoord, int coordOffset
 bool
 te::srs::Converter::convert(const double xIn, const double yIn, double &xOut, double &yOut) const
 {
+  if (convertFast(&xIn, &yIn, &xOut, &yOut, 1, 1, false))
+    return true;
+
 #ifdef TERRALIB_PROJ4_ENABLED 
   assert(m_sourcePj4Handler);
   assert(m_targetPj4Handler);
@@ -315,6 +496,9 @@ te::srs::Converter::convert(const double xIn, const double yIn, double &xOut, do
 bool
 te::srs::Converter::convert(double &x, double &y) const
 {
+  if (convertFast(&x, &y, &x, &y, 1, 1, false))
+    return true;
+
 #ifdef TERRALIB_PROJ4_ENABLED 
   assert(m_sourcePj4Handler);
   assert(m_targetPj4Handler);
@@ -341,12 +525,14 @@ te::srs::Converter::convert(double &x, double &y) const
 bool
 te::srs::Converter::invert(double *xIn, double *yIn, double *xOut, double* yOut, long numCoord, int coordOffset) const
 {
+  if (convertFast(xIn, yIn, xOut, yOut, numCoord, coordOffset, true))
+    return true;
+
 #ifdef TERRALIB_PROJ4_ENABLED 
   assert(m_sourcePj4Handler);
   assert(m_targetPj4Handler);
 
-  memcpy(xOut, xIn, numCoord*sizeof(double));
-  memcpy(yOut, yIn, numCoord*sizeof(double));
+  for (long i=0; i<numCoord; xOut[i*coordOffset]=xIn[i*coordOffset], yOut[i*coordOffset]=yIn[i*coordOffset], ++i);
 
   if (pj_is_latlong(m_targetPj4Handler))
     for (long i=0; i<numCoord; xOut[i*coordOffset]*=DEG_TO_RAD, yOut[i*coordOffset]*=DEG_TO_RAD, ++i);
@@ -365,17 +551,20 @@ te::srs::Converter::invert(double *xIn, double *yIn, double *xOut, double* yOut,
 bool
 te::srs::Converter::invert(double *x, double* y, long numCoord, int coordOffset) const
 {
+  if (convertFast(x, y, x, y, numCoord, coordOffset, true))
+    return true;
+
 #ifdef TERRALIB_PROJ4_ENABLED 
   assert(m_sourcePj4Handler);
   assert(m_targetPj4Handler);
 
   if (pj_is_latlong(m_targetPj4Handler))
-    for (long i=0; i<numCoord; x[i*coordOffset]*=DEG_TO_RAD, y[i]*=DEG_TO_RAD, ++i);
+    for (long i=0; i<numCoord; x[i*coordOffset]*=DEG_TO_RAD, y[i*coordOffset]*=DEG_TO_RAD, ++i);
 
   int res = pj_transform(m_targetPj4Handler, m_sourcePj4Handler,  numCoord, coordOffset, x, y, 0);
 
   if (res==0 && pj_is_latlong(m_sourcePj4Handler))
-    for (long i=0; i<numCoord; x[i*coordOffset]*=RAD_TO_DEG, y[i]*=RAD_TO_DEG, ++i);
+    for (long i=0; i<numCoord; x[i*coordOffset]*=RAD_TO_DEG, y[i*coordOffset]*=RAD_TO_DEG, ++i);
 
   return (res == 0);
 #else
@@ -386,6 +575,9 @@ te::srs::Converter::invert(double *x, double* y, long numCoord, int coordOffset)
 bool
 te::srs::Converter::invert(const double xIn, const double yIn, double &xOut, double &yOut) const
 {
+  if (convertFast(&xIn, &yIn, &xOut, &yOut, 1, 1, true))
+    return true;
+
 #ifdef TERRALIB_PROJ4_ENABLED 
   assert(m_sourcePj4Handler);
   assert(m_targetPj4Handler);
@@ -416,6 +608,9 @@ te::srs::Converter::invert(const double xIn, const double yIn, double &xOut, dou
 bool
 te::srs::Converter::invert(double &x, double &y) const
 {
+  if (convertFast(&x, &y, &x, &y, 1, 1, true))
+    return true;
+
 #ifdef TERRALIB_PROJ4_ENABLED 
   assert(m_sourcePj4Handler);
   assert(m_targetPj4Handler);
@@ -513,3 +708,112 @@ bool te::srs::Converter::convertToProjected(double &lon, double &lat, int SRID)
 
 }
 
+bool te::srs::Converter::isIdentity() const
+{
+  return m_fastPath == IdentityFastPath;
+}
+
+bool te::srs::Converter::isAffine() const
+{
+  return m_fastPath == AffineFastPath;
+}
+
+void te::srs::Converter::updateFastPath()
+{
+  m_fastPath = NoFastPath;
+  m_scale = 1.0;
+  m_offsetX = 0.0;
+  m_offsetY = 0.0;
+
+  if (m_sourceSRID != TE_UNKNOWN_SRS && m_sourceSRID == m_targetSRID)
+  {
+    m_fastPath = IdentityFastPath;
+    return;
+  }
+
+  if (m_sourcePj4Txt.empty() || m_targetPj4Txt.empty())
+    return;
+
+  P4Params sourceParams;
+  P4Params targetParams;
+
+  SplitP4Txt(m_sourcePj4Txt, sourceParams);
+  SplitP4Txt(m_targetPj4Txt, targetParams);
+
+  double sourceToMeter, sourceX0, sourceY0;
+  double targetToMeter, targetX0, targetY0;
+
+  if (!ExtractLinearParams(sourceParams, sourceToMeter, sourceX0, sourceY0) ||
+      !ExtractLinearParams(targetParams, targetToMeter, targetX0, targetY0))
+    return;
+
+// the other parameters (projection, datum, ellipsoid, ...) must be the same
+  if (sourceParams != targetParams)
+    return;
+
+  const std::string& proj = sourceParams["proj"];
+
+// PROJ4 replaces the false easting and northing given to UTM
+  if (proj == "utm")
+  {
+    sourceX0 = targetX0 = 500000.0;
+    sourceY0 = targetY0 = (sourceParams.find("south") != sourceParams.end()) ? 10000000.0 : 0.0;
+  }
+
+  if (sourceToMeter == targetToMeter && sourceX0 == targetX0 && sourceY0 == targetY0)
+  {
+    m_fastPath = IdentityFastPath;
+    return;
+  }
+
+// the linear parameters only apply to the projected coordinates
+  if (proj.empty() || proj == "longlat" || proj == "latlong" || proj == "lonlat" ||
+      proj == "latlon" || proj == "geocent")
+    return;
+
+  m_scale = sourceToMeter / targetToMeter;
+  m_offsetX = (targetX0 - sourceX0) / targetToMeter;
+  m_offsetY = (targetY0 - sourceY0) / targetToMeter;
+
+  m_fastPath = AffineFastPath;
+}
+
+bool te::srs::Converter::convertFast(const double* xIn, const double* yIn, double* xOut, double* yOut,
+                                     long numCoord, int coordOffset, bool inverse) const
+{
+  if (m_fastPath == NoFastPath)
+    return false;
+
+  const long end = numCoord * coordOffset;
+
+  if (m_fastPath == IdentityFastPath)
+  {
+    if (xIn != xOut || yIn != yOut)
+      for (long i=0; i<end; i+=coordOffset)
+      {
+        xOut[i] = xIn[i];
+        yOut[i] = yIn[i];
+      }
+
+    return true;
+  }
+
+  double scale = m_scale;
+  double offsetX = m_offsetX;
+  double offsetY = m_offsetY;
+
+  if (inverse)
+  {
+    scale = 1.0 / m_scale;
+    offsetX = -m_offsetX * scale;
+    offsetY = -m_offsetY * scale;
+  }
+
+  for (long i=0; i<end; i+=coordOffset)
+  {
+    xOut[i] = xIn[i] * scale + offsetX;
+    yOut[i] = yIn[i] * scale + offsetY;
+  }
+
+  return true;
+}
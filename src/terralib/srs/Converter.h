@@ -209,13 +209,51 @@ namespace te
        */
       bool convertToProjected(double &lon, double &lat, int SRID) const;
 
+      /*!
+       \brief Returns true if the source and target SRS are the same, so the coordinates are copied without calling PROJ4.
+       */
+      bool isIdentity() const;
+
+      /*!
+       \brief Returns true if the target SRS only differs from the source SRS by its false easting/northing or its linear unit.
+
+       In this case the coordinates are converted by a scale and a translation, without calling PROJ4.
+       */
+      bool isAffine() const;
+
     private:
+
+      //! The conversions that don't need PROJ4.
+      enum FastPath
+      {
+        NoFastPath,       //!< The coordinates are converted by PROJ4.
+        IdentityFastPath, //!< The coordinates are only copied.
+        AffineFastPath    //!< The coordinates are scaled and translated.
+      };
+
+      //! Finds out if the conversion has a fast path, from the SRIDs and the PROJ4 descriptions.
+      void updateFastPath();
+
+      /*!
+       \brief Converts (or inverts) a vector of coordinates with the fast path.
+       \return false if there is no fast path.
+       */
+      bool convertFast(const double* xIn, const double* yIn, double* xOut, double* yOut,
+                       long numCoord, int coordOffset, bool inverse) const;
       
       int m_targetSRID;
       int m_sourceSRID;
       
       void* m_sourcePj4Handler;	// Proj4 handler to source SRS
       void* m_targetPj4Handler;	// Proj4 handler to target SRS
+
+      std::string m_sourcePj4Txt;  // PROJ4 description of the source SRS
+      std::string m_targetPj4Txt;  // PROJ4 description of the target SRS
+
+      FastPath m_fastPath;  // The fast path of the conversion
+      double m_scale;       // Affine fast path: target = source * m_scale + offset
+      double m_offsetX;     // Affine fast path: X offset
+      double m_offsetY;     // Affine fast path: Y offset
       
     };
 
@@ -0,0 +1,138 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+  \file terralib/srs/ConverterCache.cpp
+
+  \brief A process-wide cache of coordinate converters.
+*/
+
+// TerraLib
+#include "Converter.h"
+#include "ConverterCache.h"
+
+// STL
+#include <memory>
+
+// Boost
+#include <boost/bind.hpp>
+
+te::srs::ConverterCache::ConverterCache()
+  : m_maxIdle(16),
+    m_generation(0)
+{
+}
+
+te::srs::ConverterCache::~ConverterCache()
+{
+  clear();
+}
+
+boost::shared_ptr<te::srs::Converter> te::srs::ConverterCache::get(int sourceSRID, int targetSRID)
+{
+  std::size_t generation = 0;
+
+  {
+    boost::mutex::scoped_lock lock(m_mutex);
+
+    generation = m_generation;
+
+    IdleConverters::iterator it = m_idle.find(Key(sourceSRID, targetSRID));
+
+    if(it != m_idle.end() && !it->second.empty())
+    {
+      Converter* converter = it->second.back();
+      it->second.pop_back();
+
+      return boost::shared_ptr<Converter>(converter, boost::bind(&ConverterCache::release, this, _1, generation));
+    }
+  }
+
+// the projections are initialized out of the lock: it may take a while
+  std::auto_ptr<Converter> converter(new Converter());
+  converter->setSourceSRID(sourceSRID);
+  converter->setTargetSRID(targetSRID);
+
+  return boost::shared_ptr<Converter>(converter.release(), boost::bind(&ConverterCache::release, this, _1, generation));
+}
+
+void te::srs::ConverterCache::clear()
+{
+  std::vector<Converter*> converters;
+
+  {
+    boost::mutex::scoped_lock lock(m_mutex);
+
+    ++m_generation;
+
+    for(IdleConverters::iterator it = m_idle.begin(); it != m_idle.end(); ++it)
+      converters.insert(converters.end(), it->second.begin(), it->second.end());
+
+    m_idle.clear();
+  }
+
+  for(std::size_t i = 0; i < converters.size(); ++i)
+    delete converters[i];
+}
+
+void te::srs::ConverterCache::setMaxIdleConverters(std::size_t n)
+{
+  boost::mutex::scoped_lock lock(m_mutex);
+
+  m_maxIdle = n;
+}
+
+std::size_t te::srs::ConverterCache::getMaxIdleConverters() const
+{
+  boost::mutex::scoped_lock lock(m_mutex);
+
+  return m_maxIdle;
+}
+
+std::size_t te::srs::ConverterCache::getNumberOfIdleConverters() const
+{
+  boost::mutex::scoped_lock lock(m_mutex);
+
+  std::size_t n = 0;
+
+  for(IdleConverters::const_iterator it = m_idle.begin(); it != m_idle.end(); ++it)
+    n += it->second.size();
+
+  return n;
+}
+
+void te::srs::ConverterCache::release(Converter* converter, std::size_t generation)
+{
+  {
+    boost::mutex::scoped_lock lock(m_mutex);
+
+    if(generation == m_generation)
+    {
+      std::vector<Converter*>& idle = m_idle[Key(converter->getSourceSRID(), converter->getTargetSRID())];
+
+      if(idle.size() < m_maxIdle)
+      {
+        idle.push_back(converter);
+        return;
+      }
+    }
+  }
+
+  delete converter;
+}
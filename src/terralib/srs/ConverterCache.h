@@ -0,0 +1,130 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+ \file ConverterCache.h
+ 
+ \brief A process-wide cache of coordinate converters.
+ */
+
+#ifndef __TERRALIB_SRS_INTERNAL_CONVERTERCACHE_H
+#define __TERRALIB_SRS_INTERNAL_CONVERTERCACHE_H
+
+// TerraLib
+#include "../common/Singleton.h"
+#include "Config.h"
+
+// STL
+#include <cstddef>
+#include <map>
+#include <utility>
+#include <vector>
+
+// Boost
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+namespace te
+{
+  namespace srs
+  {
+// Forward declaration
+    class Converter;
+
+    /*!
+     \class ConverterCache
+     
+     \brief A process-wide, thread-safe cache of coordinate converters.
+     
+     Initializing the PROJ4 projections of a converter is much more expensive
+     than converting a few coordinates, and code that transforms geometries one
+     by one used to create a new converter for each geometry. This cache keeps
+     the initialized converters of each pair of source and target SRS.
+
+     A converter is lent to a single caller at a time, because the PROJ4
+     handlers are not thread safe. When the last copy of the returned pointer
+     is destroyed, the converter goes back to the cache, so that many threads
+     can work with the same pair of SRS, each one with its own converter.
+
+     \code
+     boost::shared_ptr<te::srs::Converter> converter = te::srs::ConverterCache::getInstance().get(4326, 32723);
+     converter->convert(x, y, n, 1);
+     \endcode
+
+     \ingroup srs
+
+     \sa Converter
+     */
+    class TESRSEXPORT ConverterCache : public te::common::Singleton<ConverterCache>
+    {
+      friend class te::common::Singleton<ConverterCache>;
+
+    public:
+
+      /*!
+       \brief Returns a converter between two SRS.
+       \param sourceSRID source SRS identifier (input).
+       \param targetSRID target SRS identifier (input).
+       \return A converter that is only used by the caller until the returned pointer is released.
+       \exception te::srs::Exception identifier not recognized.
+       */
+      boost::shared_ptr<Converter> get(int sourceSRID, int targetSRID);
+
+      /*!
+       \brief Removes all cached converters.
+
+       It must be called when a SRS description changes. The converters lent
+       at this moment are deleted when they are released.
+       */
+      void clear();
+
+      //! Sets the maximum number of idle converters kept for each pair of SRS.
+      void setMaxIdleConverters(std::size_t n);
+
+      //! Returns the maximum number of idle converters kept for each pair of SRS.
+      std::size_t getMaxIdleConverters() const;
+
+      //! Returns the number of idle converters in the cache.
+      std::size_t getNumberOfIdleConverters() const;
+
+    protected:
+
+      //! Constructor. A singleton constructor is not callable outside the class.
+      ConverterCache();
+
+      //! Destructor.
+      ~ConverterCache();
+
+    private:
+
+      //! Gives back a converter lent by get.
+      void release(Converter* converter, std::size_t generation);
+
+      typedef std::pair<int, int> Key;                               //!< The source and target SRID.
+      typedef std::map<Key, std::vector<Converter*> > IdleConverters;
+
+      IdleConverters m_idle;       //!< The idle converters of each pair of SRS.
+      std::size_t m_maxIdle;       //!< The maximum number of idle converters of each pair of SRS.
+      std::size_t m_generation;    //!< Incremented by clear, so that older converters are not cached again.
+      mutable boost::mutex m_mutex;
+    };
+  }
+} // end TerraLib
+
+#endif // __TERRALIB_SRS_INTERNAL_CONVERTERCACHE_H
@@ -28,6 +28,7 @@
 #include "../common/TerraLib.h"
 #include "../core/translator/Translator.h"
 #include "Config.h"
+#include "ConverterCache.h"
 #include "Module.h"
 #include "SpatialReferenceSystemManager.h"
 
@@ -63,6 +64,7 @@ void te::srs::Module::initialize()
 
 void te::srs::Module::finalize()
 {
+  te::srs::ConverterCache::getInstance().clear();
   te::srs::SpatialReferenceSystemManager::getInstance().clear();
   TE_LOG_TRACE(TE_TR("TerraLib SRS Finalized!"));
 }
@@ -27,6 +27,7 @@
 #include "../core/translator/Translator.h"
 #include "../core/utils/Platform.h"
 #include "../common/UnitsOfMeasureManager.h"
+#include "ConverterCache.h"
 #include "Exception.h"
 #include "SpatialReferenceSystemManager.h"
 #include "WKTReader.h"
@@ -112,6 +113,7 @@ void te::srs::SpatialReferenceSystemManager::init(const std::string& fileName)
   try
   {
     clear();
+    ConverterCache::getInstance().clear();
     LoadSpatialReferenceSystemManager(fileName, this);
   }
   catch(boost::property_tree::json_parser::json_parser_error &je)
@@ -290,6 +292,9 @@ void te::srs::SpatialReferenceSystemManager::remove(unsigned int id, const std::
   }
   else
     m_set.erase(it);
+
+// the cached converters may use the removed description
+  ConverterCache::getInstance().clear();
 }
 
 void te::srs::SpatialReferenceSystemManager::clear()
@@ -125,6 +125,20 @@ void te::st::PointCoverage::add(PointCoverageObservation& obs)
   m_rTree->insert(*env, p);
 }
 
+void te::st::PointCoverage::add(PointCoverageObservationSet& obs)
+{
+  m_observations.insert(m_observations.end(), obs.begin(), obs.end());
+
+  //rebuild the RTree with all observations
+  std::vector<te::sam::rtree::Index<std::size_t>::ItemType> items;
+  items.reserve(m_observations.size());
+
+  for(std::size_t p = 0; p < m_observations.size(); ++p)
+    items.push_back(te::sam::rtree::Index<std::size_t>::ItemType(*m_observations[p]->first.getMBR(), p));
+
+  m_rTree->bulkLoad(items);
+}
+
 te::st::Coverage* te::st::PointCoverage::clone() const
 {
   PointCoverage* result = new PointCoverage(m_interpolator, 
@@ -132,14 +146,19 @@ te::st::Coverage* te::st::PointCoverage::clone() const
                       static_cast<te::dt::DateTime*>(m_textent->clone()), m_np,
                       m_ptypes, m_pnames);
   
+  PointCoverageObservationSet observations;
+  observations.reserve(m_observations.size());
+
   PointCoverageObservationSet::const_iterator it = m_observations.begin();
   while(it!=m_observations.end())
   {
     PointCoverageItem* item = it->get();
     std::auto_ptr< boost::ptr_vector<te::dt::AbstractData> > data(item->second.clone()); 
-    result->add(item->first, *data.release()); 
+    observations.push_back(PointCoverageObservation(new PointCoverageItem(item->first, *data.release()))); 
     ++it;
   }
+
+  result->add(observations);
   return result;
 }
 
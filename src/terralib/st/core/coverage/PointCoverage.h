@@ -174,6 +174,16 @@ namespace te
           \note It will share the same observtion. 
         */
         void add(PointCoverageObservation& obs);
+
+        /*!
+          \brief It adds a set of observtions to the PointCoverage. 
+          
+          \param obs    The observations.
+
+          \note It will share the same observtions.
+          \note The internal RTree is rebuilt at once, so this method should be preferred when adding many observations. 
+        */
+        void add(PointCoverageObservationSet& obs);
         //@}
                 
         /*! \name Coverage inherited methods */
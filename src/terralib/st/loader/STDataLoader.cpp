@@ -328,6 +328,8 @@ te::st::STDataLoader::getCoverage(const PointCoverageDataSetInfo& info,
 
   std::auto_ptr<te::st::PointCoverage> result(new PointCoverage(interp, 0, dt.release(), vPropDS.size(), ptypes, pnames, tpCV));
   
+  PointCoverageObservationSet observations;
+
   while(dset->moveNext())
   {
     //get the point
@@ -338,8 +340,11 @@ te::st::STDataLoader::getCoverage(const PointCoverageDataSetInfo& info,
     for(unsigned int i=0; i<vPropDS.size(); ++i)
       values.push_back(dset->getValue(vPropDS[i]));
 
-    result->add(*static_cast<te::gm::Point*>(geom.release()), values); //values.release() ?????
+    observations.push_back(PointCoverageObservation(new PointCoverageItem(*static_cast<te::gm::Point*>(geom.release()), values))); //values.release() ?????
   }
+
+  //index all observations at once
+  result->add(observations);
   return result;
 }
 
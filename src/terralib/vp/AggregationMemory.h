@@ -52,6 +52,15 @@ namespace te
 {
   namespace vp
   {
+    /*!
+      \class AggregationMemory
+
+      \brief A concrete class to compute the aggregation operation in memory.
+
+      \note The features are grouped by attribute values, and a group may be
+             spread over the whole extent, so this operation can't be split in
+             spatial tiles as IntersectionMemory::setStreaming does.
+    */
     class TEVPEXPORT AggregationMemory : public AggregationOp
     {
     
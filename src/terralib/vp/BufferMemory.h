@@ -74,6 +74,10 @@ namespace te
         \brief It executes the operation.
 
         \return A Boolean value that means if the operation successfully completed or not.
+
+        \note Unlike IntersectionMemory, there is no tiled streaming mode: the input
+              is read one feature at a time, but the buffers are kept in memory
+              until the end, since the dissolve step, when enabled, merges them all.
       */
       bool run() throw(te::common::Exception);
 
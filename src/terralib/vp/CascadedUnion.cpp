@@ -0,0 +1,389 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+  \file terralib/vp/CascadedUnion.cpp
+
+  \brief A spatially ordered, cascaded and multi-threaded union of geometries.
+*/
+
+// TerraLib
+#include "../BuildConfig.h"
+#include "../common/Exception.h"
+#include "../common/PlatformUtils.h"
+#include "../core/translator/Translator.h"
+#include "../geometry/Coord2D.h"
+#include "../geometry/Envelope.h"
+#include "../geometry/Geometry.h"
+#include "../geometry/GEOSReader.h"
+#include "../geometry/GEOSWriter.h"
+#include "CascadedUnion.h"
+
+// STL
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+
+// Boost
+#include <boost/cstdint.hpp>
+#include <boost/thread.hpp>
+
+// GEOS
+#ifdef TERRALIB_GEOS_ENABLED
+#include <geos/geom/Geometry.h>
+
+namespace
+{
+  const unsigned int sg_hilbertOrder = 16;   // the Hilbert curve covers a grid of 2^16 x 2^16 cells
+
+// the index of a cell along the Hilbert curve
+  boost::uint64_t HilbertIndex(boost::uint32_t x, boost::uint32_t y)
+  {
+    const boost::uint32_t n = 1u << sg_hilbertOrder;
+
+    boost::uint64_t d = 0;
+
+    for(boost::uint32_t s = n / 2; s > 0; s /= 2)
+    {
+      const boost::uint32_t rx = (x & s) ? 1 : 0;
+      const boost::uint32_t ry = (y & s) ? 1 : 0;
+
+      d += static_cast<boost::uint64_t>(s) * s * ((3 * rx) ^ ry);
+
+      if(ry == 0)
+      {
+        if(rx == 1)
+        {
+          x = n - 1 - x;
+          y = n - 1 - y;
+        }
+
+        std::swap(x, y);
+      }
+    }
+
+    return d;
+  }
+
+// the cell of a coordinate in a grid of 2^16 cells along an interval
+  boost::uint32_t HilbertCell(double v, double vmin, double vmax)
+  {
+    if(!(vmax > vmin))
+      return 0;
+
+    const double maxCell = static_cast<double>((1u << sg_hilbertOrder) - 1);
+
+    double c = (v - vmin) / (vmax - vmin) * maxCell;
+
+    if(!(c > 0.0))
+      return 0;
+
+    if(c > maxCell)
+      c = maxCell;
+
+    return static_cast<boost::uint32_t>(c);
+  }
+
+// it computes the union of a sequence of neighbour geometries, in a balanced tree: the sequence entries are released as they are merged
+  geos::geom::Geometry* UnionAll(std::vector<geos::geom::Geometry*>& geoms)
+  {
+    while(geoms.size() > 1)
+    {
+      std::size_t n = 0;
+
+      for(std::size_t i = 0; i < geoms.size(); i += 2)
+      {
+        if(i + 1 == geoms.size())
+        {
+          geoms[n++] = geoms[i];
+          break;
+        }
+
+        std::auto_ptr<geos::geom::Geometry> g1(geoms[i]);
+        std::auto_ptr<geos::geom::Geometry> g2(geoms[i + 1]);
+
+        geoms[i] = 0;
+        geoms[i + 1] = 0;
+
+        geoms[n++] = g1->Union(g2.get());
+      }
+
+      geoms.resize(n);
+    }
+
+    geos::geom::Geometry* result = geoms.empty() ? 0 : geoms[0];
+
+    geoms.clear();
+
+    return result;
+  }
+
+  void FreeGeometries(std::vector<geos::geom::Geometry*>& geoms)
+  {
+    for(std::size_t i = 0; i < geoms.size(); ++i)
+      delete geoms[i];
+
+    geoms.clear();
+  }
+}
+
+struct te::vp::CascadedUnion::ThreadParams
+{
+  ThreadParams();
+
+  ~ThreadParams();
+
+  const std::vector<te::gm::Geometry*>* m_geoms;   //!< The input geometries.
+  std::vector<std::size_t> m_order;                //!< The input geometries in the Hilbert order.
+  std::vector<geos::geom::Geometry*> m_inputs;     //!< The results of the previous level (empty in the first level).
+  std::vector<geos::geom::Geometry*> m_outputs;    //!< The results of the current level.
+  bool m_skipInvalid;
+  std::size_t m_nextJob;
+  unsigned int m_runningThreads;
+  bool m_failed;
+  std::string m_errorMessage;
+  boost::mutex m_mutex;                            //!< It protects the members above.
+  boost::condition_variable m_condVar;
+};
+
+te::vp::CascadedUnion::ThreadParams::ThreadParams()
+  : m_geoms(0),
+    m_skipInvalid(false),
+    m_nextJob(0),
+    m_runningThreads(0),
+    m_failed(false)
+{
+}
+
+te::vp::CascadedUnion::ThreadParams::~ThreadParams()
+{
+  FreeGeometries(m_inputs);
+  FreeGeometries(m_outputs);
+}
+#endif  // TERRALIB_GEOS_ENABLED
+
+te::vp::CascadedUnion::CascadedUnion(bool skipInvalid, unsigned int maxThreads)
+  : m_skipInvalid(skipInvalid),
+    m_maxThreads(maxThreads)
+{
+}
+
+te::vp::CascadedUnion::~CascadedUnion()
+{
+}
+
+te::gm::Geometry* te::vp::CascadedUnion::compute(const std::vector<te::gm::Geometry*>& geoms) const
+{
+#ifdef TERRALIB_GEOS_ENABLED
+  if(geoms.empty())
+    return 0;
+
+  const int srid = geoms[0]->getSRID();
+
+// the geometries are sorted by the Hilbert index of the centers of their MBRs
+  te::gm::Envelope extent;
+
+  for(std::size_t i = 0; i < geoms.size(); ++i)
+  {
+    const te::gm::Envelope* mbr = geoms[i]->getMBR();
+
+    if(mbr->isValid())
+      extent.Union(*mbr);
+  }
+
+  std::vector<std::pair<boost::uint64_t, std::size_t> > keys(geoms.size());
+
+  for(std::size_t i = 0; i < geoms.size(); ++i)
+  {
+    const te::gm::Envelope* mbr = geoms[i]->getMBR();
+
+    boost::uint64_t key = 0;
+
+    if(mbr->isValid() && extent.isValid())
+    {
+      const te::gm::Coord2D center = mbr->getCenter();
+
+      key = HilbertIndex(HilbertCell(center.x, extent.m_llx, extent.m_urx),
+                         HilbertCell(center.y, extent.m_lly, extent.m_ury));
+    }
+
+    keys[i] = std::make_pair(key, i);
+  }
+
+  std::sort(keys.begin(), keys.end());
+
+  ThreadParams params;
+  params.m_geoms = &geoms;
+  params.m_skipInvalid = m_skipInvalid;
+  params.m_order.resize(keys.size());
+
+  for(std::size_t i = 0; i < keys.size(); ++i)
+    params.m_order[i] = keys[i].second;
+
+  keys.clear();
+
+// the first level unions the runs of neighbour geometries, the next ones union pairs of consecutive results
+  params.m_outputs.resize((geoms.size() + sm_leafSize - 1) / sm_leafSize, 0);
+
+  run(params);
+
+  while(params.m_outputs.size() > 1)
+  {
+    FreeGeometries(params.m_inputs);
+
+    params.m_inputs.swap(params.m_outputs);
+    params.m_outputs.resize((params.m_inputs.size() + 1) / 2, 0);
+
+    run(params);
+  }
+
+  std::auto_ptr<geos::geom::Geometry> result(params.m_outputs[0]);
+  params.m_outputs[0] = 0;
+
+  if(result.get() == 0)
+    return 0;
+
+  result->setSRID(srid);
+
+  return te::gm::GEOSReader::read(result.get());
+#else
+  throw te::common::Exception(TE_TR("Union routine is supported by GEOS! Please, enable the GEOS support."));
+#endif
+}
+
+#ifdef TERRALIB_GEOS_ENABLED
+void te::vp::CascadedUnion::run(ThreadParams& params) const
+{
+  params.m_nextJob = 0;
+  params.m_runningThreads = 0;
+  params.m_failed = false;
+
+  const std::size_t nJobs = params.m_outputs.size();
+
+  unsigned int threadsNumber = m_maxThreads ? m_maxThreads : te::common::GetPhysProcNumber();
+  threadsNumber = std::max(threadsNumber, 1u);
+  threadsNumber = static_cast<unsigned int>(std::min(static_cast<std::size_t>(threadsNumber), nJobs));
+
+  if(threadsNumber == 1)
+  {
+    params.m_runningThreads = 1;
+
+    ThreadEntry(&params);
+  }
+  else
+  {
+    params.m_runningThreads = threadsNumber;
+
+    boost::thread_group threads;
+
+    for(unsigned int i = 0; i < threadsNumber; ++i)
+      threads.add_thread(new boost::thread(ThreadEntry, &params));
+
+    {
+      boost::unique_lock<boost::mutex> lock(params.m_mutex);
+
+      while(params.m_runningThreads)
+        params.m_condVar.wait(lock);
+    }
+
+    threads.join_all();
+  }
+
+  if(params.m_failed)
+    throw te::common::Exception(TE_TR("Could not compute the union of the geometries: ") + params.m_errorMessage);
+}
+
+void te::vp::CascadedUnion::ThreadEntry(ThreadParams* params)
+{
+  const std::size_t nGeoms = params->m_order.size();
+
+  std::vector<geos::geom::Geometry*> geoms;
+
+  try
+  {
+    while(true)
+    {
+      std::size_t j = 0;
+
+      {
+        boost::lock_guard<boost::mutex> lock(params->m_mutex);
+
+        if(params->m_failed || (params->m_nextJob >= params->m_outputs.size()))
+          break;
+
+        j = params->m_nextJob++;
+      }
+
+      if(params->m_inputs.empty())
+      {
+// a run of neighbour geometries, converted to GEOS only now
+        const std::size_t last = std::min((j + 1) * sm_leafSize, nGeoms);
+
+        for(std::size_t i = j * sm_leafSize; i < last; ++i)
+        {
+          std::auto_ptr<geos::geom::Geometry> g(te::gm::GEOSWriter::write((*params->m_geoms)[params->m_order[i]]));
+
+          if(params->m_skipInvalid && !g->isValid())
+            continue;
+
+          geoms.push_back(g.release());
+        }
+      }
+      else
+      {
+// a pair of consecutive results of the previous level (the last one may be alone)
+        for(std::size_t i = 2 * j; i < std::min(2 * j + 2, params->m_inputs.size()); ++i)
+        {
+          if(params->m_inputs[i] == 0)
+            continue;
+
+          geoms.push_back(params->m_inputs[i]);
+          params->m_inputs[i] = 0;
+        }
+      }
+
+      params->m_outputs[j] = UnionAll(geoms);
+    }
+  }
+  catch(const std::exception& e)
+  {
+    boost::lock_guard<boost::mutex> lock(params->m_mutex);
+
+    params->m_failed = true;
+    params->m_errorMessage = e.what();
+  }
+  catch(...)
+  {
+    boost::lock_guard<boost::mutex> lock(params->m_mutex);
+
+    params->m_failed = true;
+  }
+
+  FreeGeometries(geoms);
+
+  {
+    boost::lock_guard<boost::mutex> lock(params->m_mutex);
+
+    --params->m_runningThreads;
+  }
+
+  params->m_condVar.notify_one();
+}
+#endif  // TERRALIB_GEOS_ENABLED
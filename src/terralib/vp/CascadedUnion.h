@@ -0,0 +1,116 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+  \file terralib/vp/CascadedUnion.h
+
+  \brief A spatially ordered, cascaded and multi-threaded union of geometries.
+*/
+
+#ifndef __TERRALIB_VP_INTERNAL_CASCADEDUNION_H
+#define __TERRALIB_VP_INTERNAL_CASCADEDUNION_H
+
+// TerraLib
+#include "Config.h"
+
+// STL
+#include <cstddef>
+#include <vector>
+
+// Boost
+#include <boost/noncopyable.hpp>
+
+namespace te
+{
+  namespace gm { class Geometry; }
+
+  namespace vp
+  {
+    /*!
+      \class CascadedUnion
+
+      \brief A spatially ordered, cascaded and multi-threaded union of geometries.
+
+      The geometries are sorted by the Hilbert curve index of the centers of
+      their MBRs, so that neighbour geometries are close in the sequence. The
+      sequence is split into runs of sm_leafSize geometries and the union is
+      computed level by level, in a balanced tree: each run is unioned, then
+      each pair of consecutive results, until a single geometry remains. Each
+      union only involves neighbour geometries, whose result is usually much
+      simpler than their sum.
+
+      The unions of a level are independent: they are computed by a pool of
+      threads, that take the next union of the level as soon as they finish
+      the previous one. A large group of geometries is then split in many
+      independent sub-tasks.
+
+      The input geometries are not cloned: each one is converted to GEOS only
+      when its run is unioned, and the partial results are released as soon
+      as they are merged.
+
+      \ingroup vp
+    */
+    class TEVPEXPORT CascadedUnion : public boost::noncopyable
+    {
+      public:
+
+        /*!
+          \brief Constructor.
+
+          \param skipInvalid If true, the invalid geometries are not included in the union.
+          \param maxThreads  The maximum number of threads (0: the number of processors).
+        */
+        CascadedUnion(bool skipInvalid = false, unsigned int maxThreads = 0);
+
+        /*! \brief Destructor. */
+        ~CascadedUnion();
+
+        /*!
+          \brief It computes the union of a set of geometries.
+
+          \param geoms The geometries, all in the same SRS. They are not changed.
+
+          \return The union, in the SRS of the geometries, or null if there
+                  is no geometry to be unioned. The caller takes its ownership.
+
+          \exception te::common::Exception It throws an exception if a union can not be computed.
+        */
+        te::gm::Geometry* compute(const std::vector<te::gm::Geometry*>& geoms) const;
+
+        static const std::size_t sm_leafSize = 16;   //!< The number of geometries of the runs unioned in the first level.
+
+      private:
+
+        struct ThreadParams;
+
+        /*! \brief It computes the unions of a level in the pool of threads. */
+        void run(ThreadParams& params) const;
+
+        static void ThreadEntry(ThreadParams* params);
+
+      private:
+
+        bool m_skipInvalid;          //!< If true, the invalid geometries are skipped.
+        unsigned int m_maxThreads;   //!< The maximum number of threads.
+    };
+
+  } // end namespace vp
+}   // end namespace te
+
+#endif  // __TERRALIB_VP_INTERNAL_CASCADEDUNION_H
@@ -62,6 +62,12 @@ namespace te
 
       virtual ~Difference() {}
 
+      /*!
+        \brief It computes the difference with the input datasets given in the parameters.
+
+        \note The input datasets are already loaded by the caller, so there is
+              no tiled streaming mode as in IntersectionMemory.
+      */
       bool executeMemory(te::vp::AlgorithmParams* mainParams);
 
       bool executeQuery(te::vp::AlgorithmParams* mainParams);
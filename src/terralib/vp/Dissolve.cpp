@@ -22,6 +22,7 @@
  */
 
 #include "../core/logger/Logger.h"
+#include "../common/PlatformUtils.h"
 #include "../common/progress/TaskProgress.h"
 #include "../common/StringUtils.h"
 #include "../common/STLUtils.h"
@@ -93,9 +94,15 @@
 #include <boost/thread.hpp>
 
 // STL 
+#include <algorithm>
 #include <iostream>
 #include <vector>
 
+namespace
+{
+  // The minimum number of items of a group unioned by all threads.
+  const std::size_t sg_largeGroupSize = 1024;
+}
 
 
 std::vector<std::string> te::vp::GetDissolveProps(const std::map<std::string, te::dt::AbstractData*>& specificParams)
@@ -679,8 +686,20 @@ bool te::vp::Dissolve::executeMemory(te::vp::AlgorithmParams* mainParams)
   boost::thread_group threadGroup;
   threadGroup.add_thread(new boost::thread(threadSave, manager));
 
-  std::size_t numProcs = 8;
-  for (std::size_t i = 0; i < numProcs; ++i)
+  unsigned int numProcs = std::max(te::common::GetPhysProcNumber(), 1u);
+
+  // The large groups come first: each one is unioned by all threads, split in independent sub-tasks.
+  std::size_t largeGroupSize = std::max(sg_largeGroupSize, static_cast<std::size_t>(dataSetPos) / numProcs);
+
+  std::vector<te::mem::DataSetItem*> largeGroup;
+
+  while (numProcs > 1 && manager->getNextGroup(largeGroup, largeGroupSize))
+  {
+    unionGroup(manager, largeGroup, numProcs);
+  }
+
+  // The other groups are unioned in parallel, each one by a single thread.
+  for (unsigned int i = 0; i < numProcs; ++i)
   {
     threadGroup.add_thread(new boost::thread(threadUnion, manager));
   }
@@ -1061,14 +1080,22 @@ bool te::vp::Dissolve::executeQuery(te::vp::AlgorithmParams* mainParams)
 
 void te::vp::Dissolve::threadUnion(GroupThreadManager* manager)
 {
+// Input vector itens
+  std::vector<te::mem::DataSetItem*> dsItemVec;
+
+  while (manager->getNextGroup(dsItemVec))
+  {
+    unionGroup(manager, dsItemVec, 1);
+  }
+}
+
+void te::vp::Dissolve::unionGroup(GroupThreadManager* manager, std::vector<te::mem::DataSetItem*>& dsItemVec, unsigned int maxThreads)
+{
 // Input
   te::da::DataSetType* dataSetType = manager->getDataSetType();
   te::gm::GeometryProperty* geomProp = te::da::GetFirstGeomProperty(dataSetType);
   std::size_t geomPos = dataSetType->getPropertyPosition(geomProp->getName());
 
-// Input vector itens
-  std::vector<te::mem::DataSetItem*> dsItemVec;
-
 // Output
   te::da::DataSetType* outputDataSetType = manager->getOutputDataSetType();
   te::gm::GeometryProperty* outputGeomProp = te::da::GetFirstGeomProperty(outputDataSetType);
@@ -1077,70 +1104,67 @@ void te::vp::Dissolve::threadUnion(GroupThreadManager* manager)
 // Specific Params
   std::map<std::string, te::dt::AbstractData*> specificParams = manager->getSpecificParameters();
 
-  while (manager->getNextGroup(dsItemVec))
-  {
-    std::vector<te::mem::DataSetItem*> outputItemVec;
+  std::vector<te::mem::DataSetItem*> outputItemVec;
 
-    std::vector<te::gm::Geometry*> geomVec;
-    for (std::size_t i = 0; i < dsItemVec.size(); ++i)
-    {
-      std::auto_ptr<te::gm::Geometry> geom = dsItemVec[i]->getGeometry(geomPos);
+  std::vector<te::gm::Geometry*> geomVec;
+  for (std::size_t i = 0; i < dsItemVec.size(); ++i)
+  {
+    std::auto_ptr<te::gm::Geometry> geom = dsItemVec[i]->getGeometry(geomPos);
 
-      if (geom->getGeomTypeId() == geomProp->getGeometryType())
-        geomVec.push_back(geom.release());
-    }
+    if (geom->getGeomTypeId() == geomProp->getGeometryType())
+      geomVec.push_back(geom.release());
+  }
 
-    // Output geometry.
-    std::auto_ptr<te::gm::Geometry> resultUnionGeometry;
+  // Output geometry.
+  std::auto_ptr<te::gm::Geometry> resultUnionGeometry;
 
-    try
-    {
-      resultUnionGeometry = te::vp::GetGeometryUnion(geomVec);
-      te::common::FreeContents(geomVec);
-      geomVec.clear();
-    }
-    catch (...)
-    {
-      te::common::FreeContents(geomVec);
-      geomVec.clear();
+  try
+  {
+    resultUnionGeometry = te::vp::GetGeometryUnion(geomVec, maxThreads);
+    te::common::FreeContents(geomVec);
+    geomVec.clear();
+  }
+  catch (...)
+  {
+    te::common::FreeContents(geomVec);
+    geomVec.clear();
 
-      std::string message = "GEOS Exception.";
-      manager->addWarning(message);
+    std::string message = "GEOS Exception.";
+    manager->addWarning(message);
 
-      manager->addOutput(outputItemVec);
+    manager->addOutput(outputItemVec);
 
-      continue;
-    }
+    return;
+  }
 
-    if (!resultUnionGeometry->isValid())
-    {
-      std::string message = "The operation generated invalid geometry.";
-      manager->addWarning(message);
+  if (!resultUnionGeometry->isValid())
+  {
+    std::string message = "The operation generated invalid geometry.";
+    manager->addWarning(message);
 
-      manager->addOutput(outputItemVec);
+    manager->addOutput(outputItemVec);
 
-      continue;
-    }
+    return;
+  }
 
-    //Extract geometry result.
-    std::vector<te::gm::Geometry*> extractGeometry = ExtractGeometry(resultUnionGeometry.release(), outputGeomProp->getGeometryType());
+  //Extract geometry result.
+  std::vector<te::gm::Geometry*> extractGeometry = ExtractGeometry(resultUnionGeometry.release(), outputGeomProp->getGeometryType());
 
-    // Ouput Item
-    for (std::size_t g = 0; g < extractGeometry.size(); ++g)
-    {
-      te::mem::DataSetItem* item = manager->createOutputItem();
+  // Ouput Item
+  for (std::size_t g = 0; g < extractGeometry.size(); ++g)
+  {
+    te::mem::DataSetItem* item = manager->createOutputItem();
 
-      item->setGeometry(outputGeomPos, extractGeometry[g]);
+    item->setGeometry(outputGeomPos, extractGeometry[g]);
 
-      outputItemVec.push_back(item);
-    }
+    outputItemVec.push_back(item);
+  }
 
-    PopulateItens(dataSetType, dsItemVec, specificParams, outputItemVec);
+  PopulateItens(dataSetType, dsItemVec, specificParams, outputItemVec);
 
-    manager->addOutput(outputItemVec);
+  manager->addOutput(outputItemVec);
 
-    geomVec.clear();
-  }
+  geomVec.clear();
 }
 
 void te::vp::Dissolve::threadSave(GroupThreadManager* manager)
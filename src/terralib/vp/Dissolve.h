@@ -89,6 +89,15 @@ namespace te
 
     private:
 
+      /*!
+        \brief It unions the geometries of a group and adds the output items to the manager.
+
+        \param manager    The manager of the groups.
+        \param dsItemVec  The items of the group.
+        \param maxThreads The maximum number of threads used by the union.
+      */
+      static void unionGroup(GroupThreadManager* manager, std::vector<te::mem::DataSetItem*>& dsItemVec, unsigned int maxThreads);
+
       typedef te::sam::rtree::Index<size_t, 8>* DataSetRTree;
 
     };
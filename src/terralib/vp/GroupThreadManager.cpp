@@ -40,6 +40,18 @@
 //Boost
 #include <boost/thread.hpp>
 
+// STL
+#include <algorithm>
+
+namespace
+{
+  bool LargerGroup(const std::map<std::string, std::vector<int> >::const_iterator& lhs,
+                   const std::map<std::string, std::vector<int> >::const_iterator& rhs)
+  {
+    return lhs->second.size() > rhs->second.size();
+  }
+}
+
 namespace te
 {
   namespace vp
@@ -59,25 +71,42 @@ namespace te
       , m_outputDataSetType(outputDataSetType)
       , m_outputDataSource(outputDataSource)
       , m_specificParams(specificParams)
+      , m_nextGroup(0)
     {
-      m_groupsIterator = m_groups.begin();
+      for (std::map<std::string, std::vector<int> >::const_iterator it = m_groups.begin(); it != m_groups.end(); ++it)
+        m_groupsOrder.push_back(it);
+
+      // the largest groups are processed first, to balance the work of the threads
+      std::stable_sort(m_groupsOrder.begin(), m_groupsOrder.end(), LargerGroup);
     }
 
 
     bool GroupThreadManager::getNextGroup(std::vector< te::mem::DataSetItem*>& nextGroup)
+    {
+      return getNextGroup(nextGroup, 0);
+    }
+
+    bool GroupThreadManager::getNextGroup(std::vector< te::mem::DataSetItem*>& nextGroup, std::size_t minSize)
     {
       boost::lock_guard<boost::mutex> lock(m_mtx);
       
-      if (m_groupsIterator == m_groups.end())
+      if (m_nextGroup == m_groupsOrder.size())
+      {
+        return false;
+      }
+
+      const std::vector<int>& positions = m_groupsOrder[m_nextGroup]->second;
+
+      if (positions.size() < minSize)
       {
         return false;
       }
       
       nextGroup.clear();
 
-      for (std::size_t i = 0; i < m_groupsIterator->second.size(); ++i)
+      for (std::size_t i = 0; i < positions.size(); ++i)
       {
-        m_dataSet->move(m_groupsIterator->second[i]);
+        m_dataSet->move(positions[i]);
         te::mem::DataSetItem* item = new te::mem::DataSetItem(m_dataSet);
 
         for (std::size_t j = 0; j < m_dataSetType->size(); ++j)
@@ -89,7 +118,7 @@ namespace te
         nextGroup.push_back(item);
       }
 
-      ++m_groupsIterator;
+      ++m_nextGroup;
 
       return true;
     }
@@ -31,7 +31,9 @@
 #include "Config.h"
 
 // STL
+#include <cstddef>
 #include <map>
+#include <string>
 #include <vector>
 
 // Boost
@@ -80,6 +82,13 @@ namespace te
       
       bool getNextGroup(std::vector< te::mem::DataSetItem*>& nextGroup);
 
+      /*!
+        \brief It returns the items of the next group, if it has at least minSize items.
+
+        The groups are returned from the largest to the smallest one.
+      */
+      bool getNextGroup(std::vector< te::mem::DataSetItem*>& nextGroup, std::size_t minSize);
+
       bool getNextOutput(std::vector< te::mem::DataSetItem*>& nextOutput);
 
       te::da::DataSetType* getDataSetType();
@@ -117,7 +126,8 @@ namespace te
 
       std::map<std::string, te::dt::AbstractData*> m_specificParams;
 
-      std::map<std::string, std::vector<int> >::iterator m_groupsIterator;
+      std::vector<std::map<std::string, std::vector<int> >::const_iterator> m_groupsOrder;   //!< The groups, from the largest to the smallest one.
+      std::size_t m_nextGroup;
 
       std::vector< std::vector<te::mem::DataSetItem*> > m_outputQueue;
       te::common::TaskProgress m_task;
@@ -26,6 +26,7 @@
 //Terralib
 
 #include "../BuildConfig.h"
+#include "../common/PlatformUtils.h"
 #include "../common/progress/TaskProgress.h"
 #include "../core/logger/Logger.h"
 #include "../core/translator/Translator.h"
@@ -41,6 +42,8 @@
 #include "../geometry/Geometry.h"
 #include "../geometry/GeometryCollection.h"
 #include "../geometry/GeometryProperty.h"
+#include "../geometry/GEOSReader.h"
+#include "../geometry/GEOSWriter.h"
 #include "../geometry/MultiLineString.h"
 #include "../geometry/MultiPoint.h"
 #include "../geometry/MultiPolygon.h"
@@ -57,6 +60,8 @@
 #include "Utils.h"
 
 // STL
+#include <algorithm>
+#include <cmath>
 #include <map>
 #include <math.h>
 #include <string>
@@ -65,17 +70,106 @@
 // BOOST
 #include <boost/lexical_cast.hpp>
 #include <boost/algorithm/string.hpp>
+#include <boost/ptr_container/ptr_vector.hpp>
+#include <boost/thread.hpp>
+
+// GEOS
+#ifdef TERRALIB_GEOS_ENABLED
+#include <geos/geom/Geometry.h>
+#include <geos/geom/prep/PreparedGeometry.h>
+#include <geos/geom/prep/PreparedGeometryFactory.h>
+#endif
+
+namespace
+{
+// the number of features of the first input refined at once
+  const std::size_t sg_chunkSize = 4096;
+}
+
+#ifdef TERRALIB_GEOS_ENABLED
+struct te::vp::IntersectionMemory::ThreadParams
+{
+  ThreadParams();
+
+  ~ThreadParams();
+
+  const boost::ptr_vector<te::gm::Geometry>* m_secondGeoms;   //!< The geometries of the second input, in the SRS of the first input.
+  std::vector<geos::geom::Geometry*> m_secondGeos;             //!< The GEOS geometries of the second input, converted once.
+  std::vector<char> m_secondValid;                             //!< The validity of the GEOS geometries of the second input.
+  const boost::ptr_vector<te::gm::Geometry>* m_firstGeoms;    //!< The geometries of the current chunk of the first input.
+  std::vector<std::vector<std::size_t> > m_candidates;         //!< The candidates of the second input for each feature of the chunk.
+  std::vector<std::vector<std::pair<std::size_t, te::gm::Geometry*> > > m_results;  //!< The intersections of each feature of the chunk, in the order of its candidates.
+  const Tiling* m_tiling;
+  bool m_refine;                                               //!< False while the second input is converted.
+  std::size_t m_nItems;
+  std::size_t m_nextItem;
+  std::size_t m_processedItems;
+  unsigned int m_runningThreads;
+  unsigned int m_maxThreads;
+  bool m_pulse;                                                //!< If true, the task is pulsed for each item.
+  bool m_abort;
+  bool m_failed;
+  std::string m_errorMessage;
+  te::common::TaskProgress* m_task;                            //!< Only informed when there is a single thread.
+  boost::mutex m_mutex;                                        //!< It protects the members above.
+  boost::condition_variable m_condVar;
+};
+
+te::vp::IntersectionMemory::ThreadParams::ThreadParams()
+  : m_secondGeoms(0),
+    m_firstGeoms(0),
+    m_tiling(0),
+    m_refine(false),
+    m_nItems(0),
+    m_nextItem(0),
+    m_processedItems(0),
+    m_runningThreads(0),
+    m_maxThreads(0),
+    m_pulse(false),
+    m_abort(false),
+    m_failed(false),
+    m_task(0)
+{
+}
+
+te::vp::IntersectionMemory::ThreadParams::~ThreadParams()
+{
+  for(std::size_t i = 0; i < m_secondGeos.size(); ++i)
+    delete m_secondGeos[i];
+
+  for(std::size_t i = 0; i < m_results.size(); ++i)
+  {
+    for(std::size_t j = 0; j < m_results[i].size(); ++j)
+      delete m_results[i][j].second;
+  }
+}
+#endif  // TERRALIB_GEOS_ENABLED
 
 
 te::vp::IntersectionMemory::IntersectionMemory()
+  : m_tileSize(0),
+    m_maxThreads(0)
 {}
 
 te::vp::IntersectionMemory::~IntersectionMemory()
 {}
 
 
+void te::vp::IntersectionMemory::setStreaming(std::size_t tileSize)
+{
+  m_tileSize = tileSize;
+}
+
+void te::vp::IntersectionMemory::setMaxThreads(unsigned int maxThreads)
+{
+  m_maxThreads = maxThreads;
+}
+
 bool te::vp::IntersectionMemory::run() throw(te::common::Exception)
 {
+  if (m_tileSize != 0 && m_firstOidSet == 0 && m_secondOidSet == 0 && !m_isFistQuery && !m_isSecondQuery)
+    return runStreaming();
+
   std::vector<te::dt::Property*> firstProps = getTabularProps(m_firstConverter->getResult());
 
   IntersectionMember firstMember;
@@ -126,36 +220,179 @@ bool te::vp::IntersectionMemory::run() throw(te::common::Exception)
 
 }
 
+bool te::vp::IntersectionMemory::runStreaming()
+{
+  IntersectionMember firstMember;
+  firstMember.dt = m_firstConverter->getResult();
+  firstMember.ds = 0;
+  firstMember.props = getTabularProps(firstMember.dt);
+
+  IntersectionMember secondMember;
+  secondMember.dt = m_secondConverter->getResult();
+  secondMember.ds = 0;
+  secondMember.props = getTabularProps(secondMember.dt);
+
+// the whole inputs are read tile by tile
+  m_firstDs.reset();
+  m_secondDs.reset();
+
+  te::gm::GeometryProperty* fiGeomProp = te::da::GetFirstGeomProperty(firstMember.dt);
+  int sridFirst = fiGeomProp->getSRID();
+
+  te::gm::GeometryProperty* secGeomProp = te::da::GetFirstGeomProperty(secondMember.dt);
+  size_t secGeomPropPos = secondMember.dt->getPropertyPosition(secGeomProp);
+  int sridSecond = secGeomProp->getSRID();
+
+// only the common extent of the inputs may have intersections
+  te::gm::Envelope firstExtent = te::vp::GetExtent(m_inFirstDsrc.get(), m_inFirstDsetName, m_firstDsType.get(), sridFirst);
+  te::gm::Envelope secondExtent = te::vp::GetExtent(m_inSecondDsrc.get(), m_inSecondDsetName, m_secondDsType.get(), sridFirst);
+
+  if(!firstExtent.intersects(secondExtent))
+    throw te::common::Exception(TE_TR("The Layers do not intersect!"));
+
+  te::gm::Envelope extent = firstExtent.intersection(secondExtent);
+
+// a square grid with about m_tileSize features of each input in each tile
+  std::size_t nItems = std::max(m_inFirstDsrc->getNumberOfItems(m_inFirstDsetName),
+                                m_inSecondDsrc->getNumberOfItems(m_inSecondDsetName));
+
+  std::size_t nCols = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(nItems / m_tileSize + 1))));
+  std::size_t nRows = nCols;
+
+  if(extent.getWidth() <= 0.0)
+    nCols = 1;
+
+  if(extent.getHeight() <= 0.0)
+    nRows = 1;
+
+  std::auto_ptr<te::da::DataSetType> outputDt(this->getOutputDsType());
+
+  te::common::TaskProgress task("Processing intersection...");
+  task.setTotalSteps(static_cast<int>(nCols * nRows));
+  task.useTimer(true);
+
+  int pk = 0;
+  std::size_t nResults = 0;
+
+  for(std::size_t row = 0; row < nRows; ++row)
+  {
+    for(std::size_t col = 0; col < nCols; ++col)
+    {
+      te::gm::Envelope tile = te::vp::GetTile(extent, nCols, nRows, col, row);
+
+// the features of the second input in the tile are kept in memory, in the SRS of the first input
+      std::auto_ptr<te::mem::DataSet> secondDs;
+
+      {
+        std::auto_ptr<te::da::DataSet> secondTile = te::vp::GetDataSetInTile(m_inSecondDsrc.get(), m_inSecondDsetName, m_secondDsType.get(),
+                                                                             m_secondConverter.get(), tile, sridFirst);
+        secondDs.reset(new te::mem::DataSet(*secondTile));
+      }
+
+      boost::ptr_vector<te::gm::Geometry> secondGeoms;
+      std::vector<te::sam::rtree::Index<size_t, 8>::ItemType> rtreeItems;
+
+      secondDs->moveBeforeFirst();
+
+      while(secondDs->moveNext())
+      {
+        std::auto_ptr<te::gm::Geometry> g = secondDs->getGeometry(secGeomPropPos);
+        g->setSRID(sridSecond);
+
+        if(g->getSRID() != sridFirst)
+          g->transform(sridFirst);
+
+        rtreeItems.push_back(te::sam::rtree::Index<size_t, 8>::ItemType(*g->getMBR(), secondGeoms.size()));
+        secondGeoms.push_back(g.release());
+      }
+
+      if(!secondGeoms.empty())
+      {
+        te::sam::rtree::Index<size_t, 8> rtree;
+        rtree.bulkLoad(rtreeItems);
+        rtreeItems.clear();
+
+        secondMember.ds = secondDs.get();
+
+// the features of the first input are only read once
+        std::auto_ptr<te::da::DataSet> firstDs = te::vp::GetDataSetInTile(m_inFirstDsrc.get(), m_inFirstDsetName, m_firstDsType.get(),
+                                                                          m_firstConverter.get(), tile, sridFirst);
+        firstMember.ds = firstDs.get();
+
+        std::auto_ptr<te::mem::DataSet> outputDs(new te::mem::DataSet(outputDt.get()));
+
+// a pair that crosses the tile borders is only intersected once
+        Tiling tiling;
+        tiling.m_extent = extent;
+        tiling.m_nCols = nCols;
+        tiling.m_nRows = nRows;
+        tiling.m_col = col;
+        tiling.m_row = row;
+
+        bool done = overlay(m_outDsetName, firstMember, secondMember, secondGeoms, rtree, &tiling,
+                            outputDt.get(), outputDs.get(), pk, &task, false);
+
+        firstMember.ds = 0;
+        secondMember.ds = 0;
+
+        if(!done)
+          throw te::common::Exception(TE_TR("Operation canceled!"));
+
+        if(!outputDs->isEmpty())
+        {
+          nResults += outputDs->size();
+
+          outputDs->moveBeforeFirst();
+          te::vp::Save(m_outDsrc.get(), outputDs.get(), outputDt.get());
+        }
+      }
+
+      if(task.isActive() == false)
+        throw te::common::Exception(TE_TR("Operation canceled!"));
+
+      task.pulse();
+    }
+  }
+
+  if(nResults == 0)
+    throw te::common::Exception(TE_TR("The Layers do not intersect!"));
+
+  return true;
+}
+
 std::pair<te::da::DataSetType*, te::da::DataSet*> te::vp::IntersectionMemory::pairwiseIntersection(std::string newName, 
                                                                                                   IntersectionMember firstMember, 
                                                                                                   IntersectionMember secondMember)
 {
 
-  //Creating the RTree with the secound layer geometries
-  DataSetRTree rtree(new te::sam::rtree::Index<size_t, 8>);
+  //Creating the RTree with the secound layer geometries, in the SRS of the first layer
+  te::sam::rtree::Index<size_t, 8> rtree;
   size_t secGeomPropPos = secondMember.dt->getPropertyPosition(secondMember.dt->findFirstPropertyOfType(te::dt::GEOMETRY_TYPE));
   te::gm::GeometryProperty* geomProp = te::da::GetFirstGeomProperty(secondMember.dt);
 
-  size_t secondDsCount = 0;
-  int sridSecond = -1;
+  int sridSecond = geomProp->getSRID();
+  int sridFirst = te::da::GetFirstGeomProperty(firstMember.dt)->getSRID();
+
+  boost::ptr_vector<te::gm::Geometry> secondGeoms;
+  std::vector<te::sam::rtree::Index<size_t, 8>::ItemType> rtreeItems;
 
   secondMember.ds->moveBeforeFirst();
   while(secondMember.ds->moveNext())
   {
     std::auto_ptr<te::gm::Geometry> g = secondMember.ds->getGeometry(secGeomPropPos);
-    
-    if(sridSecond == -1)
-      sridSecond = geomProp->getSRID();
+    g->setSRID(sridSecond);
 
-    rtree->insert(*g->getMBR(), secondDsCount);
+    if(g->getSRID() != sridFirst)
+      g->transform(sridFirst);
 
-    ++secondDsCount;
+    rtreeItems.push_back(te::sam::rtree::Index<size_t, 8>::ItemType(*g->getMBR(), secondGeoms.size()));
+    secondGeoms.push_back(g.release());
   }
 
-  firstMember.ds->moveBeforeFirst();
+  rtree.bulkLoad(rtreeItems);
+  rtreeItems.clear();
 
-  te::gm::GeometryProperty* fiGeomProp = te::da::GetFirstGeomProperty(firstMember.dt);
-  size_t fiGeomPropPos = firstMember.dt->getPropertyPosition(fiGeomProp);
+  firstMember.ds->moveBeforeFirst();
 
   // Create the DataSetType and DataSet
   te::da::DataSetType* outputDt = this->getOutputDsType();
@@ -169,175 +406,448 @@ std::pair<te::da::DataSetType*, te::da::DataSet*> te::vp::IntersectionMemory::pa
 
   int pk = 0;
 
-  while(firstMember.ds->moveNext())
+  try
+  {
+    if(!overlay(newName, firstMember, secondMember, secondGeoms, rtree, 0, outputDt, outputDs, pk, &task, true))
+      throw te::common::Exception(TE_TR("Operation canceled!"));
+  }
+  catch(...)
   {
-    std::auto_ptr<te::gm::Geometry> currGeom = firstMember.ds->getGeometry(fiGeomPropPos);
+    delete outputDt;
+    delete outputDs;
+
+    throw;
+  }
+
+  outputDs->moveBeforeFirst();
+
+  resultPair.first = outputDt;
+  resultPair.second = outputDs;
+  return resultPair;
+}
+
+bool te::vp::IntersectionMemory::overlay(const std::string& newName,
+                                         IntersectionMember& firstMember,
+                                         IntersectionMember& secondMember,
+                                         const boost::ptr_vector<te::gm::Geometry>& secondGeoms,
+                                         const te::sam::rtree::Index<size_t, 8>& rtree,
+                                         const Tiling* tiling,
+                                         te::da::DataSetType* outputDt,
+                                         te::mem::DataSet* outputDs,
+                                         int& pk,
+                                         te::common::TaskProgress* task,
+                                         bool pulse)
+{
+#ifdef TERRALIB_GEOS_ENABLED
+  te::gm::GeometryProperty* fiGeomProp = te::da::GetFirstGeomProperty(firstMember.dt);
+  std::size_t fiGeomPropPos = firstMember.dt->getPropertyPosition(fiGeomProp);
+  int sridFirst = fiGeomProp->getSRID();
+
+  const std::size_t nProps = firstMember.dt->size();
+
+  ThreadParams params;
+  params.m_secondGeoms = &secondGeoms;
+  params.m_tiling = tiling;
+  params.m_maxThreads = m_maxThreads;
 
-    if(currGeom->getSRID() != sridSecond)
-      currGeom->transform(sridSecond);
+// the geometries of the second input are converted to GEOS and validated only once
+  params.m_secondGeos.resize(secondGeoms.size(), 0);
+  params.m_secondValid.resize(secondGeoms.size(), 0);
+  params.m_refine = false;
+  params.m_pulse = false;
+  params.m_nItems = secondGeoms.size();
 
-    std::vector<size_t> report;
-    rtree->search(*currGeom->getMBR(), report);
+  if(!runThreads(params, task))
+    return false;
 
-    if(!report.empty())
-      currGeom->transform(fiGeomProp->getSRID());
+// the first input is refined in chunks, whose features are kept with their tabular attributes
+  params.m_refine = true;
+  params.m_pulse = pulse;
 
-    for(size_t i = 0; i < report.size(); ++i)
+  bool hasMore = true;
+
+  while(hasMore)
+  {
+    te::mem::DataSet chunk(firstMember.dt);
+    boost::ptr_vector<te::gm::Geometry> firstGeoms;
+
+    params.m_candidates.clear();
+
+    while(firstGeoms.size() < sg_chunkSize)
     {
-      secondMember.ds->move(report[i]);
-      std::auto_ptr<te::gm::Geometry> secGeom = secondMember.ds->getGeometry(secGeomPropPos);
-      secGeom->setSRID(sridSecond);
+      if(!firstMember.ds->moveNext())
+      {
+        hasMore = false;
+        break;
+      }
+
+      std::auto_ptr<te::gm::Geometry> currGeom = firstMember.ds->getGeometry(fiGeomPropPos);
+      currGeom->setSRID(sridFirst);
+
+      params.m_candidates.push_back(std::vector<std::size_t>());
+      rtree.search(*currGeom->getMBR(), params.m_candidates.back());
 
-      if (secGeom->getSRID() != fiGeomProp->getSRID())
-        secGeom->transform(fiGeomProp->getSRID());
+      te::mem::DataSetItem* item = new te::mem::DataSetItem(&chunk);
 
-      if(!currGeom->intersects(secGeom.get()))
+      for(std::size_t i = 0; i < nProps; ++i)
+      {
+        if(i != fiGeomPropPos && !firstMember.ds->isNull(i))
+          item->setValue(i, firstMember.ds->getValue(i).release());
+      }
+
+      chunk.add(item);
+
+      firstGeoms.push_back(currGeom.release());
+    }
+
+    params.m_firstGeoms = &firstGeoms;
+    params.m_results.clear();
+    params.m_results.resize(firstGeoms.size());
+    params.m_nItems = firstGeoms.size();
+
+    if(!runThreads(params, task))
+      return false;
+
+// the results are added in the order of the features and of their candidates, as in a serial execution
+    IntersectionMember chunkMember = firstMember;
+    chunkMember.ds = &chunk;
+
+    for(std::size_t k = 0; k < params.m_results.size(); ++k)
+    {
+      std::vector<std::pair<std::size_t, te::gm::Geometry*> >& results = params.m_results[k];
+
+      if(results.empty())
         continue;
 
-      te::mem::DataSetItem* item = new te::mem::DataSetItem(outputDs);
-      std::auto_ptr<te::gm::Geometry> resultGeom;
+      chunk.move(k);
 
-      if (currGeom->isValid() && secGeom->isValid())
-        resultGeom.reset(currGeom->intersection(secGeom.get()));
-      
-      if(resultGeom.get()!=0 && resultGeom->isValid())
+      for(std::size_t i = 0; i < results.size(); ++i)
       {
-        te::gm::GeometryProperty* fiGeomProp = (te::gm::GeometryProperty*)outputDt->findFirstPropertyOfType(te::dt::GEOMETRY_TYPE);
+        te::gm::Geometry* resultGeom = results[i].second;
+        results[i].second = 0;
 
-        if(fiGeomProp->getGeometryType() == te::gm::MultiPolygonType)
-        {
-          if((resultGeom->getGeomTypeId() == te::gm::MultiPolygonType)
-            || (resultGeom->getGeomTypeId() == te::gm::MultiPolygonMType)
-            || (resultGeom->getGeomTypeId() == te::gm::MultiPolygonZMType)
-            || (resultGeom->getGeomTypeId() == te::gm::MultiPolygonZType))
-          {
-            item->setGeometry("geom", resultGeom.release());
-          }
-          else if((resultGeom->getGeomTypeId() == te::gm::PolygonType)
-                  || (resultGeom->getGeomTypeId() == te::gm::PolygonMType)
-                  || (resultGeom->getGeomTypeId() == te::gm::PolygonZMType)
-                  || (resultGeom->getGeomTypeId() == te::gm::PolygonZType))
-          {
-            te::gm::MultiPolygon* newGeom = new te::gm::MultiPolygon(0, te::gm::GeomType(resultGeom->getGeomTypeId()+3), resultGeom->getSRID());
-            newGeom->add(resultGeom.release());
-            item->setGeometry("geom", newGeom);
-          }
-        }
-        else if(fiGeomProp->getGeometryType() == te::gm::MultiLineStringType)
-        {
-          if ((resultGeom->getGeomTypeId() == te::gm::MultiLineStringType)
-            || (resultGeom->getGeomTypeId() == te::gm::MultiLineStringZType)
-            || (resultGeom->getGeomTypeId() == te::gm::MultiLineStringMType)
-            || (resultGeom->getGeomTypeId() == te::gm::MultiLineStringZMType))
-          {
-            item->setGeometry("geom", resultGeom.release());
-          }
-          else if ((resultGeom->getGeomTypeId() == te::gm::LineStringType)
-                   || (resultGeom->getGeomTypeId() == te::gm::LineStringZType)
-                   || (resultGeom->getGeomTypeId() == te::gm::LineStringMType)
-                   || (resultGeom->getGeomTypeId() == te::gm::LineStringZMType))
-          {
-            te::gm::MultiLineString* newGeom = new te::gm::MultiLineString(0, te::gm::GeomType(resultGeom->getGeomTypeId()+3), resultGeom->getSRID());
-            newGeom->add(resultGeom.release());
-            item->setGeometry("geom", newGeom);
-          }
-        }
-        else if(fiGeomProp->getGeometryType() == te::gm::MultiPointType)
+        secondMember.ds->move(results[i].first);
+
+        addIntersection(newName, resultGeom, chunkMember, secondMember, outputDt, outputDs, pk);
+      }
+    }
+  }
+
+  return true;
+#else
+  throw te::common::Exception(TE_TR("The intersection is supported by GEOS! Please, enable the GEOS support."));
+#endif
+}
+
+#ifdef TERRALIB_GEOS_ENABLED
+bool te::vp::IntersectionMemory::runThreads(ThreadParams& params, te::common::TaskProgress* task) const
+{
+  params.m_nextItem = 0;
+  params.m_processedItems = 0;
+  params.m_runningThreads = 0;
+  params.m_abort = false;
+  params.m_failed = false;
+  params.m_task = 0;
+
+  if(params.m_nItems == 0)
+    return true;
+
+  unsigned int threadsNumber = params.m_maxThreads ? params.m_maxThreads : te::common::GetPhysProcNumber();
+  threadsNumber = std::max(threadsNumber, 1u);
+  threadsNumber = static_cast<unsigned int>(std::min(static_cast<std::size_t>(threadsNumber), params.m_nItems));
+
+  if(threadsNumber == 1)
+  {
+    params.m_task = task;
+    params.m_runningThreads = 1;
+
+    ThreadEntry(&params);
+  }
+  else
+  {
+    params.m_runningThreads = threadsNumber;
+
+    boost::thread_group threads;
+
+    for(unsigned int i = 0; i < threadsNumber; ++i)
+      threads.add_thread(new boost::thread(ThreadEntry, &params));
+
+// the task is only used by this thread
+    {
+      boost::unique_lock<boost::mutex> lock(params.m_mutex);
+
+      std::size_t pulsedItems = 0;
+
+      while(params.m_runningThreads)
+      {
+        params.m_condVar.wait(lock);
+
+        if(task)
         {
-          if((resultGeom->getGeomTypeId() == te::gm::MultiPointType)
-             || (resultGeom->getGeomTypeId() == te::gm::MultiPointMType)
-             || (resultGeom->getGeomTypeId() == te::gm::MultiPointZMType)
-             || (resultGeom->getGeomTypeId() == te::gm::MultiPointZType))
-          {
-            item->setGeometry("geom", resultGeom.release());
-          }
-          else if((resultGeom->getGeomTypeId() == te::gm::PointType)
-                  || (resultGeom->getGeomTypeId() == te::gm::PointKdType)
-                  || (resultGeom->getGeomTypeId() == te::gm::PointMType)
-                  || (resultGeom->getGeomTypeId() == te::gm::PointZMType)
-                  || (resultGeom->getGeomTypeId() == te::gm::PointZType))
-          {
-            te::gm::MultiPoint* newGeom = new te::gm::MultiPoint(0, te::gm::GeomType(resultGeom->getGeomTypeId()+3), resultGeom->getSRID());
-            newGeom->add(resultGeom.release());
-            item->setGeometry("geom", newGeom);
-          }
+          for(; params.m_pulse && (pulsedItems < params.m_processedItems); ++pulsedItems)
+            task->pulse();
+
+          if(!task->isActive())
+            params.m_abort = true;
         }
       }
-      else
+    }
+
+    threads.join_all();
+  }
+
+  if(params.m_failed)
+    throw te::common::Exception(TE_TR("Could not intersect the features: ") + params.m_errorMessage);
+
+  return !params.m_abort;
+}
+
+void te::vp::IntersectionMemory::ThreadEntry(ThreadParams* params)
+{
+  try
+  {
+    while(true)
+    {
+      std::size_t k = 0;
+
       {
-#ifdef TERRALIB_LOGGER_ENABLED
-        TE_CORE_LOG_DEBUG("vp", "Intersection - Invalid geometry found");
-#endif //TERRALIB_LOGGER_ENABLED
-        continue;
+        boost::lock_guard<boost::mutex> lock(params->m_mutex);
+
+        if(params->m_task && !params->m_task->isActive())
+          params->m_abort = true;
+
+        if(params->m_abort || (params->m_nextItem >= params->m_nItems))
+          break;
+
+        k = params->m_nextItem++;
       }
 
-      for(size_t j = 0; j < firstMember.props.size(); ++j)
+      if(!params->m_refine)
       {
-        std::string name = firstMember.props[j]->getName();
+        geos::geom::Geometry* secGeos = te::gm::GEOSWriter::write(&(*params->m_secondGeoms)[k]);
 
-        std::size_t inputPropPos = firstMember.dt->getPropertyPosition(name);
+// GEOS computes the envelope lazily: it is cached here, since the refine pass shares the geometry among the threads
+        secGeos->getEnvelopeInternal();
 
-        if (!m_inFirstDsetName.empty())
-          name = te::vp::GetSimpleTableName(m_inFirstDsetName) + "_" + name;
+        params->m_secondGeos[k] = secGeos;
+        params->m_secondValid[k] = secGeos->isValid() ? 1 : 0;
+      }
+      else if(!params->m_candidates[k].empty())
+      {
+        const te::gm::Geometry* currGeom = &(*params->m_firstGeoms)[k];
+        const std::vector<std::size_t>& candidates = params->m_candidates[k];
+        std::vector<std::pair<std::size_t, te::gm::Geometry*> >& results = params->m_results[k];
 
-        std::size_t outputPropPos = outputDt->getPropertyPosition(name);
+// the feature is tested against all its candidates: its prepared geometry is built once
+        std::auto_ptr<geos::geom::Geometry> currGeos(te::gm::GEOSWriter::write(currGeom));
+        std::auto_ptr<const geos::geom::prep::PreparedGeometry> prepGeom(geos::geom::prep::PreparedGeometryFactory::prepare(currGeos.get()));
 
-        if (outputPropPos >= outputDt->size())
-          continue;
+        const bool currValid = currGeos->isValid();
 
-        if (!firstMember.ds->isNull(inputPropPos))
+        for(std::size_t i = 0; i < candidates.size(); ++i)
         {
-          te::dt::AbstractData* ad = firstMember.ds->getValue(firstMember.props[j]->getName()).release();
-          item->setValue(name, ad);
-        }
-      }
+          const std::size_t c = candidates[i];
+          const geos::geom::Geometry* secGeos = params->m_secondGeos[c];
 
-      for(size_t j = 0; j < secondMember.props.size(); ++j)
-      {
-        std::string name = secondMember.props[j]->getName();
+          if(!prepGeom->intersects(secGeos))
+            continue;
+
+          const Tiling* tiling = params->m_tiling;
 
-        std::size_t inputPropPos = secondMember.dt->getPropertyPosition(name);
+          if(tiling && !te::vp::IsFirstCommonTile(currGeom, &(*params->m_secondGeoms)[c], tiling->m_extent,
+                                                  tiling->m_nCols, tiling->m_nRows, tiling->m_col, tiling->m_row))
+            continue;
 
-        if (!m_inSecondDsetName.empty())
-          name = te::vp::GetSimpleTableName(m_inSecondDsetName) + "_" + name;
+// an invalid pair is kept with a null result, to be reported in the output order
+          te::gm::Geometry* resultGeom = 0;
 
-        std::size_t outputPropPos = outputDt->getPropertyPosition(name);
+          if(currValid && params->m_secondValid[c])
+          {
+            std::auto_ptr<geos::geom::Geometry> resultGeos(currGeos->intersection(secGeos));
 
-        if (outputPropPos >= outputDt->size())
-          continue;
+            if(resultGeos->isValid())
+            {
+              resultGeos->setSRID(currGeom->getSRID());
+              resultGeom = te::gm::GEOSReader::read(resultGeos.get());
+            }
+          }
 
-        if (!secondMember.ds->isNull(inputPropPos))
-        {
-          te::dt::AbstractData* ad = secondMember.ds->getValue(secondMember.props[j]->getName()).release();
-          item->setValue(name, ad);
+          results.push_back(std::make_pair(c, resultGeom));
         }
       }
 
-      item->setInt32(newName + "_id", pk);
-      ++pk;
+      {
+        boost::lock_guard<boost::mutex> lock(params->m_mutex);
 
-      outputDs->moveNext();
+        ++params->m_processedItems;
 
-      std::size_t aux = te::da::GetFirstSpatialPropertyPos(outputDs);
+        if(params->m_task && params->m_pulse)
+          params->m_task->pulse();
+      }
 
-      if(!item->isNull(aux))
-        outputDs->add(item);
+      params->m_condVar.notify_one();
     }
+  }
+  catch(const std::exception& e)
+  {
+    boost::lock_guard<boost::mutex> lock(params->m_mutex);
+
+    params->m_abort = true;
+    params->m_failed = true;
+    params->m_errorMessage = e.what();
+  }
+  catch(...)
+  {
+    boost::lock_guard<boost::mutex> lock(params->m_mutex);
+
+    params->m_abort = true;
+    params->m_failed = true;
+  }
+
+  {
+    boost::lock_guard<boost::mutex> lock(params->m_mutex);
+
+    --params->m_runningThreads;
+  }
+
+  params->m_condVar.notify_one();
+}
+#endif  // TERRALIB_GEOS_ENABLED
+
+void te::vp::IntersectionMemory::addIntersection(const std::string& newName,
+                                                 te::gm::Geometry* intersectionGeom,
+                                                 IntersectionMember& firstMember,
+                                                 IntersectionMember& secondMember,
+                                                 te::da::DataSetType* outputDt,
+                                                 te::mem::DataSet* outputDs,
+                                                 int& pk)
+{
+  std::auto_ptr<te::gm::Geometry> resultGeom(intersectionGeom);
+  te::mem::DataSetItem* item = new te::mem::DataSetItem(outputDs);
+
+  if(resultGeom.get()!=0)
+  {
+    te::gm::GeometryProperty* fiGeomProp = (te::gm::GeometryProperty*)outputDt->findFirstPropertyOfType(te::dt::GEOMETRY_TYPE);
 
-    if(task.isActive() == false)
+    if(fiGeomProp->getGeometryType() == te::gm::MultiPolygonType)
+    {
+      if((resultGeom->getGeomTypeId() == te::gm::MultiPolygonType)
+        || (resultGeom->getGeomTypeId() == te::gm::MultiPolygonMType)
+        || (resultGeom->getGeomTypeId() == te::gm::MultiPolygonZMType)
+        || (resultGeom->getGeomTypeId() == te::gm::MultiPolygonZType))
+      {
+        item->setGeometry("geom", resultGeom.release());
+      }
+      else if((resultGeom->getGeomTypeId() == te::gm::PolygonType)
+              || (resultGeom->getGeomTypeId() == te::gm::PolygonMType)
+              || (resultGeom->getGeomTypeId() == te::gm::PolygonZMType)
+              || (resultGeom->getGeomTypeId() == te::gm::PolygonZType))
+      {
+        te::gm::MultiPolygon* newGeom = new te::gm::MultiPolygon(0, te::gm::GeomType(resultGeom->getGeomTypeId()+3), resultGeom->getSRID());
+        newGeom->add(resultGeom.release());
+        item->setGeometry("geom", newGeom);
+      }
+    }
+    else if(fiGeomProp->getGeometryType() == te::gm::MultiLineStringType)
+    {
+      if ((resultGeom->getGeomTypeId() == te::gm::MultiLineStringType)
+        || (resultGeom->getGeomTypeId() == te::gm::MultiLineStringZType)
+        || (resultGeom->getGeomTypeId() == te::gm::MultiLineStringMType)
+        || (resultGeom->getGeomTypeId() == te::gm::MultiLineStringZMType))
+      {
+        item->setGeometry("geom", resultGeom.release());
+      }
+      else if ((resultGeom->getGeomTypeId() == te::gm::LineStringType)
+               || (resultGeom->getGeomTypeId() == te::gm::LineStringZType)
+               || (resultGeom->getGeomTypeId() == te::gm::LineStringMType)
+               || (resultGeom->getGeomTypeId() == te::gm::LineStringZMType))
+      {
+        te::gm::MultiLineString* newGeom = new te::gm::MultiLineString(0, te::gm::GeomType(resultGeom->getGeomTypeId()+3), resultGeom->getSRID());
+        newGeom->add(resultGeom.release());
+        item->setGeometry("geom", newGeom);
+      }
+    }
+    else if(fiGeomProp->getGeometryType() == te::gm::MultiPointType)
     {
-      delete outputDt;
-      delete outputDs;
+      if((resultGeom->getGeomTypeId() == te::gm::MultiPointType)
+         || (resultGeom->getGeomTypeId() == te::gm::MultiPointMType)
+         || (resultGeom->getGeomTypeId() == te::gm::MultiPointZMType)
+         || (resultGeom->getGeomTypeId() == te::gm::MultiPointZType))
+      {
+        item->setGeometry("geom", resultGeom.release());
+      }
+      else if((resultGeom->getGeomTypeId() == te::gm::PointType)
+              || (resultGeom->getGeomTypeId() == te::gm::PointKdType)
+              || (resultGeom->getGeomTypeId() == te::gm::PointMType)
+              || (resultGeom->getGeomTypeId() == te::gm::PointZMType)
+              || (resultGeom->getGeomTypeId() == te::gm::PointZType))
+      {
+        te::gm::MultiPoint* newGeom = new te::gm::MultiPoint(0, te::gm::GeomType(resultGeom->getGeomTypeId()+3), resultGeom->getSRID());
+        newGeom->add(resultGeom.release());
+        item->setGeometry("geom", newGeom);
+      }
+    }
+  }
+  else
+  {
+#ifdef TERRALIB_LOGGER_ENABLED
+    TE_CORE_LOG_DEBUG("vp", "Intersection - Invalid geometry found");
+#endif //TERRALIB_LOGGER_ENABLED
+    delete item;
+    return;
+  }
 
-      throw te::common::Exception(TE_TR("Operation canceled!"));
+  for(size_t j = 0; j < firstMember.props.size(); ++j)
+  {
+    std::string name = firstMember.props[j]->getName();
+
+    std::size_t inputPropPos = firstMember.dt->getPropertyPosition(name);
+
+    if (!m_inFirstDsetName.empty())
+      name = te::vp::GetSimpleTableName(m_inFirstDsetName) + "_" + name;
+
+    std::size_t outputPropPos = outputDt->getPropertyPosition(name);
+
+    if (outputPropPos >= outputDt->size())
+      continue;
+
+    if (!firstMember.ds->isNull(inputPropPos))
+    {
+      te::dt::AbstractData* ad = firstMember.ds->getValue(firstMember.props[j]->getName()).release();
+      item->setValue(name, ad);
     }
+  }
+
+  for(size_t j = 0; j < secondMember.props.size(); ++j)
+  {
+    std::string name = secondMember.props[j]->getName();
+
+    std::size_t inputPropPos = secondMember.dt->getPropertyPosition(name);
 
-    task.pulse();
+    if (!m_inSecondDsetName.empty())
+      name = te::vp::GetSimpleTableName(m_inSecondDsetName) + "_" + name;
+
+    std::size_t outputPropPos = outputDt->getPropertyPosition(name);
+
+    if (outputPropPos >= outputDt->size())
+      continue;
+
+    if (!secondMember.ds->isNull(inputPropPos))
+    {
+      te::dt::AbstractData* ad = secondMember.ds->getValue(secondMember.props[j]->getName()).release();
+      item->setValue(name, ad);
+    }
   }
 
-  outputDs->moveBeforeFirst();
+  item->setInt32(newName + "_id", pk);
+  ++pk;
 
-  resultPair.first = outputDt;
-  resultPair.second = outputDs;
-  return resultPair;
+  outputDs->moveNext();
+
+  std::size_t aux = te::da::GetFirstSpatialPropertyPos(outputDs);
+
+  if(!item->isNull(aux))
+    outputDs->add(item);
+  else
+    delete item;
 }
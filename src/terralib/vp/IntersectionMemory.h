@@ -33,6 +33,7 @@
 #include "../common/STLUtils.h"
 #include "../datatype/Property.h"
 #include "../dataaccess/dataset/DataSetType.h"
+#include "../geometry/Envelope.h"
 #include "../geometry/Geometry.h"
 #include "../memory/DataSet.h"
 #include "../sam.h"
@@ -50,8 +51,13 @@
 #include <string>
 #include <vector>
 
+// Boost
+#include <boost/ptr_container/ptr_vector.hpp>
+
 namespace te
 {
+  namespace common { class TaskProgress; }
+
   namespace vp
   {
     class TEVPEXPORT IntersectionMemory : public IntersectionOp
@@ -64,6 +70,41 @@ namespace te
       ~IntersectionMemory();
       
       bool run() throw(te::common::Exception);
+
+      /*!
+        \brief It enables the streaming execution, for inputs that don't fit in memory.
+
+        The common extent of the inputs is split in a grid of tiles, that are
+        processed one at a time. Only the features of the second input that
+        intersect the current tile are kept in memory, the features of the
+        first input are read one by one, and the result of each tile is saved
+        in the output data source before the next tile is processed.
+
+        A pair of features that crosses the tile borders is found in many
+        tiles: it is only intersected in the first tile, in row order, that
+        both features intersect.
+
+        \param tileSize The approximate number of features of each input in a tile (0: disabled).
+
+        \note The inputs are read from their data sources with spatial filters,
+              so the inputs with selected objects or given by queries are
+              still loaded in memory.
+      */
+      void setStreaming(std::size_t tileSize = 50000);
+
+      /*!
+        \brief It sets the maximum number of threads used to intersect the features.
+
+        The candidate pairs of features, found with the R-tree of the second
+        input, are refined by a pool of threads: each thread takes the next
+        feature of the first input, prepares its geometry (a GEOS prepared
+        geometry) and tests it against all its candidates. The results are
+        added to the output in the order of the features, as in a serial
+        execution.
+
+        \param maxThreads The maximum number of threads (0: the number of processors).
+      */
+      void setMaxThreads(unsigned int maxThreads);
       
     private:
 
@@ -76,11 +117,71 @@ namespace te
 
       typedef te::sam::rtree::Index<size_t, 8>* DataSetRTree;
 
+      /*! \brief The tile of the streaming execution where the features are intersected. */
+      struct Tiling
+      {
+        te::gm::Envelope m_extent;   //!< The extent of the grid of tiles.
+        std::size_t m_nCols;         //!< The number of columns of the grid.
+        std::size_t m_nRows;         //!< The number of rows of the grid.
+        std::size_t m_col;           //!< The tile column.
+        std::size_t m_row;           //!< The tile row.
+      };
+
+      struct ThreadParams;
+
 
       std::pair<te::da::DataSetType*, te::da::DataSet*> pairwiseIntersection(std::string newName, 
                                                                              IntersectionMember firstMember, 
                                                                              IntersectionMember secondMember);
 
+      /*! \brief It runs the intersection tile by tile, saving the result of each tile. */
+      bool runStreaming();
+
+      /*!
+        \brief It intersects the remaining features of the first input with the features of the second input.
+
+        \param newName      The output dataset name.
+        \param firstMember  The first input, read from its current position.
+        \param secondMember The second input.
+        \param secondGeoms  The geometries of the second input, in the SRS of the first input and in the order of its dataset.
+        \param rtree        The index of secondGeoms.
+        \param tiling       The tile of the streaming execution, or null to intersect every pair.
+        \param outputDt     The output dataset type.
+        \param outputDs     The output dataset.
+        \param pk           The next output identifier.
+        \param task         The task used to cancel the execution.
+        \param pulse        If true, the task is pulsed for each feature of the first input.
+
+        \return False if the task was canceled.
+      */
+      bool overlay(const std::string& newName,
+                   IntersectionMember& firstMember,
+                   IntersectionMember& secondMember,
+                   const boost::ptr_vector<te::gm::Geometry>& secondGeoms,
+                   const te::sam::rtree::Index<size_t, 8>& rtree,
+                   const Tiling* tiling,
+                   te::da::DataSetType* outputDt,
+                   te::mem::DataSet* outputDs,
+                   int& pk,
+                   te::common::TaskProgress* task,
+                   bool pulse);
+
+      /*! \brief It runs the jobs of a phase of the overlay in the pool of threads. */
+      bool runThreads(ThreadParams& params, te::common::TaskProgress* task) const;
+
+      /*! \brief It adds the intersection of the current features of the inputs to the output (it takes the ownership of intersectionGeom, that may be null). */
+      void addIntersection(const std::string& newName,
+                           te::gm::Geometry* intersectionGeom,
+                           IntersectionMember& firstMember,
+                           IntersectionMember& secondMember,
+                           te::da::DataSetType* outputDt,
+                           te::mem::DataSet* outputDs,
+                           int& pk);
+
+      static void ThreadEntry(ThreadParams* params);
+
+      std::size_t m_tileSize;      //!< The number of features of each input in a tile of the streaming execution (0: disabled).
+      unsigned int m_maxThreads;   //!< The maximum number of threads.
 
     }; // end class
   } // end namespace vp
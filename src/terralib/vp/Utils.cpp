@@ -25,10 +25,12 @@
 
 // TerraLib
 
+#include "../common/STLUtils.h"
 #include "../common/StringUtils.h"
 
 #include "../core/translator/Translator.h"
 
+#include "../dataaccess/dataset/DataSetAdapter.h"
 #include "../dataaccess/dataset/DataSetTypeConverter.h"
 #include "../dataaccess/dataset/DataSetTypeCapabilities.h"
 #include "../dataaccess/datasource/DataSourceCapabilities.h"
@@ -45,6 +47,7 @@
 #include "../geometry/Point.h"
 
 #include "AlgorithmParams.h"
+#include "CascadedUnion.h"
 #include "Utils.h"
 
 //STL
@@ -59,7 +62,7 @@
 #include <boost/uuid/uuid_io.hpp>
 
 
-std::auto_ptr<te::gm::Geometry> te::vp::GetGeometryUnion(const std::vector<gm::Geometry*> &geomVec)
+std::auto_ptr<te::gm::Geometry> te::vp::GetGeometryUnion(const std::vector<gm::Geometry*> &geomVec, unsigned int maxThreads)
 {
   std::auto_ptr<te::gm::Geometry> geometry(0);
 
@@ -70,65 +73,17 @@ std::auto_ptr<te::gm::Geometry> te::vp::GetGeometryUnion(const std::vector<gm::G
   }
   else if (geomVec.size() > 1)
   {
-    te::gm::GeometryCollection* gc = new te::gm::GeometryCollection(0, te::gm::GeometryCollectionType, geomVec[0]->getSRID());
+    te::vp::CascadedUnion cascadedUnion(false, maxThreads);
 
-    for (std::size_t g = 0; g < geomVec.size(); ++g)
-    {
-      te::dt::AbstractData* c_abs = geomVec[g]->clone();
-      gc->add(static_cast<te::gm::Geometry*>(c_abs));
-    }
-
-    geometry.reset(te::gm::UnaryUnion(gc));
-
-    delete gc;
+    geometry.reset(cascadedUnion.compute(geomVec));
   }
 
   return geometry;
 }
 
-te::gm::Geometry* te::vp::GetGeometryUnion(const std::vector<te::mem::DataSetItem*>& items, size_t geomIdx, te::gm::GeomType outGeoType)
+te::gm::Geometry* te::vp::GetGeometryUnion(const std::vector<te::mem::DataSetItem*>& items, size_t geomIdx, te::gm::GeomType outGeoType, unsigned int maxThreads)
 {
-  te::gm::Geometry* resultGeometry(0); 
-
-  std::auto_ptr<te::gm::Geometry> seedGeometry = items[0]->getGeometry(geomIdx);
-
-  if(items.size() < 2)
-    resultGeometry = seedGeometry.release();
-
-  if(items.size() == 2)
-  {
-    std::auto_ptr<te::gm::Geometry> teGeom = items[1]->getGeometry(geomIdx);
-
-    if(teGeom->isValid())
-      resultGeometry = seedGeometry->Union(teGeom.release());
-    else
-      resultGeometry = seedGeometry.release();
-  }
-  if(items.size() > 2)
-  {
-    //te::gm::GeometryCollection* teGeomColl = new te::gm::GeometryCollection(0, te::gm::GeometryCollectionType, seedGeometry->getSRID());
-    
-    std::size_t pos = 1;
-    while (!seedGeometry->isValid())
-    {
-      seedGeometry = items[pos]->getGeometry(geomIdx);
-      ++pos;
-    }
-
-    for (std::size_t i = pos; i < items.size(); ++i)
-    {
-      std::auto_ptr<te::gm::Geometry> currentGeom = items[i]->getGeometry(geomIdx);
-
-      if(currentGeom->isValid())
-        resultGeometry = seedGeometry->Union(currentGeom.release());
-
-      seedGeometry.reset(resultGeometry);
-    }
-
-    resultGeometry = seedGeometry.release();
-    //resultGeometry = seedGeometry->Union(teGeomColl);
-
-  }
+  te::gm::Geometry* resultGeometry = GetGeometryUnion(items, geomIdx, maxThreads);
 
   if (resultGeometry->getGeomTypeId() != outGeoType)
   {
@@ -157,39 +112,41 @@ te::gm::Geometry* te::vp::GetGeometryUnion(const std::vector<te::mem::DataSetIte
     return resultGeometry;
 }
 
-te::gm::Geometry* te::vp::GetGeometryUnion(const std::vector<te::mem::DataSetItem*>& items, size_t geomIdx)
+te::gm::Geometry* te::vp::GetGeometryUnion(const std::vector<te::mem::DataSetItem*>& items, size_t geomIdx, unsigned int maxThreads)
 {
-  te::gm::Geometry* resultGeometry(0); 
+  if(items.size() < 2)
+    return items[0]->getGeometry(geomIdx).release();
 
-  std::auto_ptr<te::gm::Geometry> seedGeometry = items[0]->getGeometry(geomIdx);
+  std::vector<te::gm::Geometry*> geomVec;
+  geomVec.reserve(items.size());
 
-  if(items.size() < 2)
-    resultGeometry = seedGeometry.release();
+  for(std::size_t i = 0; i < items.size(); ++i)
+    geomVec.push_back(items[i]->getGeometry(geomIdx).release());
 
-  if(items.size() == 2)
+  te::gm::Geometry* resultGeometry(0);
+
+  try
   {
-    std::auto_ptr<te::gm::Geometry> teGeom = items[1]->getGeometry(geomIdx);
+    // the invalid geometries are not unioned
+    te::vp::CascadedUnion cascadedUnion(true, maxThreads);
 
-    if(teGeom->isValid())
-      resultGeometry = seedGeometry->Union(teGeom.release());
-    else
-      resultGeometry = seedGeometry.release();
+    resultGeometry = cascadedUnion.compute(geomVec);
   }
-  if(items.size() > 2)
+  catch(...)
   {
-    te::gm::GeometryCollection* teGeomColl = new te::gm::GeometryCollection(0, te::gm::GeometryCollectionType, seedGeometry->getSRID());
-
-    for(std::size_t i = 1; i < items.size(); ++i)
-    {
-      std::auto_ptr<te::gm::Geometry> currentGeom = items[i]->getGeometry(geomIdx);
+    te::common::FreeContents(geomVec);
+    throw;
+  }
 
-      if(currentGeom->isValid())
-        teGeomColl->add(currentGeom.release());
-    }
+  // if all geometries are invalid, the first one is returned
+  if(resultGeometry == 0)
+  {
+    resultGeometry = geomVec[0];
+    geomVec[0] = 0;
+  }
 
-    resultGeometry = seedGeometry->Union(teGeomColl);
+  te::common::FreeContents(geomVec);
 
-  }
   return resultGeometry;
 }
 
@@ -609,3 +566,113 @@ bool te::vp::IsPolygonType(const te::gm::GeomType& geomType)
 
   return false;
 }
+
+te::gm::Envelope te::vp::GetExtent(te::da::DataSource* source, const std::string& dsName, te::da::DataSetType* dt, int srid)
+{
+  te::gm::GeometryProperty* geomProp = te::da::GetFirstGeomProperty(dt);
+
+  std::auto_ptr<te::gm::Envelope> extent = source->getExtent(dsName, geomProp->getName());
+
+  if(geomProp->getSRID() != srid && geomProp->getSRID() != TE_UNKNOWN_SRS && srid != TE_UNKNOWN_SRS)
+    extent->transform(geomProp->getSRID(), srid);
+
+  return *extent;
+}
+
+te::gm::Envelope te::vp::GetTile(const te::gm::Envelope& extent, std::size_t nCols, std::size_t nRows, std::size_t col, std::size_t row)
+{
+  const double width = extent.getWidth();
+  const double height = extent.getHeight();
+
+  te::gm::Envelope tile;
+
+  tile.m_llx = extent.m_llx + width * static_cast<double>(col) / static_cast<double>(nCols);
+  tile.m_lly = extent.m_lly + height * static_cast<double>(row) / static_cast<double>(nRows);
+  tile.m_urx = (col + 1 == nCols) ? extent.m_urx : extent.m_llx + width * static_cast<double>(col + 1) / static_cast<double>(nCols);
+  tile.m_ury = (row + 1 == nRows) ? extent.m_ury : extent.m_lly + height * static_cast<double>(row + 1) / static_cast<double>(nRows);
+
+  return tile;
+}
+
+std::auto_ptr<te::da::DataSet> te::vp::GetDataSetInTile(te::da::DataSource* source, const std::string& dsName, te::da::DataSetType* dt,
+                                                         te::da::DataSetTypeConverter* converter, const te::gm::Envelope& tile, int srid)
+{
+  te::gm::GeometryProperty* geomProp = te::da::GetFirstGeomProperty(dt);
+
+  te::gm::Envelope e(tile);
+
+  if(geomProp->getSRID() != srid && geomProp->getSRID() != TE_UNKNOWN_SRS && srid != TE_UNKNOWN_SRS)
+  {
+    e.transform(srid, geomProp->getSRID());
+
+// only the corners are converted: a margin covers the curved borders of the tile
+    const double dx = 0.01 * e.getWidth();
+    const double dy = 0.01 * e.getHeight();
+
+    e.m_llx -= dx;
+    e.m_lly -= dy;
+    e.m_urx += dx;
+    e.m_ury += dy;
+  }
+
+  std::auto_ptr<te::da::DataSet> ds = source->getDataSet(dsName, geomProp->getName(), &e, te::gm::INTERSECTS);
+
+  if(converter == 0)
+    return ds;
+
+  return std::auto_ptr<te::da::DataSet>(te::da::CreateAdapter(ds.release(), converter, true));
+}
+
+bool te::vp::IsFirstCommonTile(const te::gm::Geometry* g1, const te::gm::Geometry* g2, const te::gm::Envelope& extent,
+                               std::size_t nCols, std::size_t nRows, std::size_t col, std::size_t row)
+{
+  const te::gm::Envelope common = g1->getMBR()->intersection(*g2->getMBR());
+
+  const double tileWidth = extent.getWidth() / static_cast<double>(nCols);
+  const double tileHeight = extent.getHeight() / static_cast<double>(nRows);
+
+// the first column and row of the tiles that the common MBR may intersect
+  std::size_t firstCol = 0;
+  std::size_t firstRow = 0;
+
+  if(tileWidth > 0.0 && common.m_llx > extent.m_llx)
+    firstCol = std::min(static_cast<std::size_t>((common.m_llx - extent.m_llx) / tileWidth), nCols - 1);
+
+  if(tileHeight > 0.0 && common.m_lly > extent.m_lly)
+    firstRow = std::min(static_cast<std::size_t>((common.m_lly - extent.m_lly) / tileHeight), nRows - 1);
+
+  std::size_t lastCol = nCols - 1;
+
+  if(tileWidth > 0.0 && common.m_urx < extent.m_urx)
+    lastCol = std::min(static_cast<std::size_t>((common.m_urx - extent.m_llx) / tileWidth), nCols - 1);
+
+// the rounding may miss a neighbour tile that touches the common MBR
+  if(firstCol > 0)
+    --firstCol;
+
+  if(firstRow > 0)
+    --firstRow;
+
+  lastCol = std::min(lastCol + 1, nCols - 1);
+
+  for(std::size_t r = firstRow; r <= row; ++r)
+  {
+    for(std::size_t c = firstCol; c <= lastCol; ++c)
+    {
+      if(r == row && c >= col)
+        break;
+
+      te::gm::Envelope tile = GetTile(extent, nCols, nRows, c, r);
+
+      if(!tile.intersects(common))
+        continue;
+
+      std::auto_ptr<te::gm::Geometry> tileGeom(te::gm::GetGeomFromEnvelope(&tile, g1->getSRID()));
+
+      if(g1->intersects(tileGeom.get()) && g2->intersects(tileGeom.get()))
+        return false;
+    }
+  }
+
+  return true;
+}
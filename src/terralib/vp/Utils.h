@@ -29,6 +29,7 @@
 // Terralib
 #include "../dataaccess/dataset/DataSet.h"
 #include "../dataaccess/dataset/DataSetType.h"
+#include "../dataaccess/dataset/DataSetTypeConverter.h"
 #include "../dataaccess/datasource/DataSource.h"
 
 #include "../geometry/Geometry.h"
@@ -60,18 +61,29 @@ namespace te
       QUERY
     };
 
-    TEVPEXPORT std::auto_ptr<te::gm::Geometry> GetGeometryUnion(const std::vector<te::gm::Geometry*>& geomVec);
+    /*!
+      \brief It returns the union of a geometry vector, computed by a CascadedUnion.
+
+      \param geomVec    The geometries. They are not cloned.
+      \param maxThreads The maximum number of threads (0: the number of processors).
+
+      \return Union of the geometries.
+    */
+    TEVPEXPORT std::auto_ptr<te::gm::Geometry> GetGeometryUnion(const std::vector<te::gm::Geometry*>& geomVec, unsigned int maxThreads = 0);
 
     /*!
       \brief It returns the union of a geometry vector.
 
-      \param items  Vector of itens that represents a group.
+      \param items      Vector of itens that represents a group.
+      \param maxThreads The maximum number of threads (0: the number of processors).
 
       \return Union of the geometry.
+
+      \note The invalid geometries are not included in the union.
     */
-    TEVPEXPORT te::gm::Geometry* GetGeometryUnion(const std::vector<te::mem::DataSetItem*>& items, size_t geomIdx, te::gm::GeomType outGeoType);
+    TEVPEXPORT te::gm::Geometry* GetGeometryUnion(const std::vector<te::mem::DataSetItem*>& items, size_t geomIdx, te::gm::GeomType outGeoType, unsigned int maxThreads = 0);
 
-    TEVPEXPORT te::gm::Geometry* GetGeometryUnion(const std::vector<te::mem::DataSetItem*>& items, size_t geomIdx);
+    TEVPEXPORT te::gm::Geometry* GetGeometryUnion(const std::vector<te::mem::DataSetItem*>& items, size_t geomIdx, unsigned int maxThreads = 0);
 
     TEVPEXPORT void SplitGeometryCollection(te::gm::GeometryCollection* geomIn, te::gm::GeometryCollection* gcOut);
 
@@ -103,6 +115,54 @@ namespace te
 
     TEVPEXPORT bool IsPolygonType(const te::gm::GeomType& geomType);
 
+    /*!
+      \brief It returns the extent of the first geometric property of a dataset.
+
+      \param source The data source.
+      \param dsName The dataset name.
+      \param dt     The dataset type, as stored in the data source.
+      \param srid   The SRS of the returned extent.
+    */
+    TEVPEXPORT te::gm::Envelope GetExtent(te::da::DataSource* source, const std::string& dsName, te::da::DataSetType* dt, int srid);
+
+    /*!
+      \brief It returns a tile of a regular grid over an extent.
+
+      \note The tiles of the last column and of the last row end exactly at the extent borders.
+    */
+    TEVPEXPORT te::gm::Envelope GetTile(const te::gm::Envelope& extent, std::size_t nCols, std::size_t nRows, std::size_t col, std::size_t row);
+
+    /*!
+      \brief It reads the features of a dataset that intersect a tile.
+
+      \param source    The data source.
+      \param dsName    The dataset name.
+      \param dt        The dataset type, as stored in the data source.
+      \param converter The converter applied to the features (it may be null).
+      \param tile      The tile.
+      \param srid      The SRS of the tile.
+
+      \return The features, adapted by the converter.
+    */
+    TEVPEXPORT std::auto_ptr<te::da::DataSet> GetDataSetInTile(te::da::DataSource* source, const std::string& dsName, te::da::DataSetType* dt,
+                                                              te::da::DataSetTypeConverter* converter, const te::gm::Envelope& tile, int srid);
+
+    /*!
+      \brief It checks if a tile is the first one, in row order, that two geometries intersect.
+
+      It is used to process a pair of geometries that crosses the tile borders only once.
+
+      \param g1     A geometry.
+      \param g2     Another geometry, in the same SRS, whose MBR intersects the MBR of g1.
+      \param extent The extent of the grid of tiles.
+      \param nCols  The number of columns of the grid.
+      \param nRows  The number of rows of the grid.
+      \param col    The tile column.
+      \param row    The tile row.
+    */
+    TEVPEXPORT bool IsFirstCommonTile(const te::gm::Geometry* g1, const te::gm::Geometry* g2, const te::gm::Envelope& extent,
+                                      std::size_t nCols, std::size_t nRows, std::size_t col, std::size_t row);
+
   } // end namespace vp
 }   // end namespace te
 
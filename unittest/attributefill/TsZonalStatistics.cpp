@@ -0,0 +1,316 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+  \file terralib/unittest/attributefill/TsZonalStatistics.cpp
+
+  \brief A test suit for the ZonalStatistics engine.
+
+  The statistics of each zone must be the ones computed by the
+  te::stat functions over the values of the cells whose centers
+  are inside the zone, for any number of threads.
+ */
+
+// TerraLib
+#include <terralib/attributefill/ZonalStatistics.h>
+#include <terralib/datatype/Enums.h>
+#include <terralib/geometry/Coord2D.h>
+#include <terralib/geometry/LinearRing.h>
+#include <terralib/geometry/MultiPolygon.h>
+#include <terralib/geometry/Polygon.h>
+#include <terralib/raster/BandProperty.h>
+#include <terralib/raster/Grid.h>
+#include <terralib/raster/Raster.h>
+#include <terralib/raster/RasterFactory.h>
+#include <terralib/statistics/core/NumericStatisticalSummary.h>
+#include <terralib/statistics/core/SummaryFunctions.h>
+#include "Config.h"
+
+// STL
+#include <cmath>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Boost
+#include <boost/test/unit_test.hpp>
+
+namespace
+{
+  const unsigned int sg_nCols = 150;
+  const unsigned int sg_nRows = 100;
+  const double sg_noDataValue = 255.0;
+
+  /*! \brief It creates a closed ring with the given vertices. */
+  te::gm::LinearRing* CreateRing(const double* xy, std::size_t nPoints)
+  {
+    te::gm::LinearRing* ring = new te::gm::LinearRing(nPoints + 1, te::gm::LineStringType);
+
+    for(std::size_t i = 0; i < nPoints; ++i)
+      ring->setPoint(i, xy[2 * i], xy[2 * i + 1]);
+
+    ring->setPoint(nPoints, xy[0], xy[1]);
+
+    return ring;
+  }
+
+  /*!
+    \brief It creates a raster of 150x100 cells of size 1, tiled in blocks of 32x16 cells.
+
+    Band 0 has small integers and some no-data cells, so that zones have modes.
+    Band 1 has real values.
+   */
+  std::auto_ptr<te::rst::Raster> CreateRaster()
+  {
+    std::vector<te::rst::BandProperty*> bandsProps;
+
+    for(unsigned int b = 0; b < 2; ++b)
+    {
+      te::rst::BandProperty* bp = new te::rst::BandProperty(b, te::dt::DOUBLE_TYPE);
+      bp->m_noDataValue = sg_noDataValue;
+      bp->m_blkw = 32;
+      bp->m_blkh = 16;
+      bp->m_nblocksx = (sg_nCols + 31) / 32;
+      bp->m_nblocksy = (sg_nRows + 15) / 16;
+      bandsProps.push_back(bp);
+    }
+
+    te::gm::Coord2D ulc(0.0, static_cast<double>(sg_nRows));
+
+    std::auto_ptr<te::rst::Raster> raster(te::rst::RasterFactory::make("MEM", new te::rst::Grid(sg_nCols, sg_nRows, 1.0, 1.0, &ulc, 0),
+                                                                       bandsProps, std::map<std::string, std::string>(), 0, 0));
+
+    for(unsigned int r = 0; r < sg_nRows; ++r)
+    {
+      for(unsigned int c = 0; c < sg_nCols; ++c)
+      {
+        const double v0 = ((c * 7 + r * 3) % 31 == 0) ? sg_noDataValue : static_cast<double>((c * c + 3 * r) % 10);
+        const double v1 = static_cast<double>((c * 37 + r * 101) % 1000) / 7.0;
+
+        raster->setValue(c, r, v0, 0);
+        raster->setValue(c, r, v1, 1);
+      }
+    }
+
+    return raster;
+  }
+
+  /*! \brief It returns true if the point is inside the polygon, by the even-odd rule over all its rings. */
+  bool IsInside(const te::gm::Polygon& polygon, double x, double y)
+  {
+    bool inside = false;
+
+    for(std::size_t r = 0; r < polygon.getNumRings(); ++r)
+    {
+      const te::gm::LinearRing* ring = static_cast<const te::gm::LinearRing*>(polygon.getRingN(r));
+
+      const std::size_t n = ring->getNPoints();
+
+      for(std::size_t i = 0, j = n - 1; i < n; j = i++)
+      {
+        const double xi = ring->getX(i);
+        const double yi = ring->getY(i);
+        const double xj = ring->getX(j);
+        const double yj = ring->getY(j);
+
+        if(((yi > y) != (yj > y)) && (x < (xj - xi) * (y - yi) / (yj - yi) + xi))
+          inside = !inside;
+      }
+    }
+
+    return inside;
+  }
+
+  /*! \brief It returns the values of the band cells whose centers are inside one of the polygons. */
+  std::vector<double> GetCoveredValues(const te::rst::Raster& raster, const std::vector<const te::gm::Polygon*>& polygons, unsigned int band)
+  {
+    std::vector<double> values;
+
+    for(unsigned int r = 0; r < sg_nRows; ++r)
+    {
+      for(unsigned int c = 0; c < sg_nCols; ++c)
+      {
+        const double x = c + 0.5;
+        const double y = sg_nRows - r - 0.5;
+
+        for(std::size_t p = 0; p < polygons.size(); ++p)
+        {
+          if(IsInside(*polygons[p], x, y))
+          {
+            double v;
+            raster.getValue(c, r, v, band);
+            values.push_back(v);
+            break;
+          }
+        }
+      }
+    }
+
+    return values;
+  }
+
+  /*!
+    \brief It returns the kurtosis of the values.
+
+    te::stat::GetNumericStatisticalSummary computes its correction factor with
+    integer divisions, so the expected kurtosis is computed here.
+   */
+  double GetKurtosis(const std::vector<double>& values, double mean)
+  {
+    const double n = static_cast<double>(values.size());
+
+    double m2 = 0.0;
+    double m4 = 0.0;
+
+    for(std::size_t i = 0; i < values.size(); ++i)
+    {
+      const double d = values[i] - mean;
+      m2 += d * d;
+      m4 += d * d * d * d;
+    }
+
+    return m4 / (m2 * m2) * (n * (n + 1.0) * (n - 1.0)) / ((n - 2.0) * (n - 3.0));
+  }
+
+  /*! \brief It checks the statistics of a zone against the te::stat functions. */
+  void CheckZone(const te::attributefill::ZonalStatistics& zs, std::size_t zone, unsigned int band, std::vector<double> values)
+  {
+    te::stat::NumericStatisticalSummary expected;
+    te::stat::GetNumericStatisticalSummary(values, expected);
+    te::stat::Mode(values, expected);
+
+    te::stat::NumericStatisticalSummary ss;
+    zs.getSummary(zone, band, ss);
+    zs.getMode(zone, band, ss);
+
+    BOOST_REQUIRE(expected.m_count > 3);
+
+    BOOST_CHECK_EQUAL(ss.m_count, expected.m_count);
+    BOOST_CHECK_EQUAL(ss.m_validCount, expected.m_validCount);
+    BOOST_CHECK_EQUAL(ss.m_minVal, expected.m_minVal);
+    BOOST_CHECK_EQUAL(ss.m_maxVal, expected.m_maxVal);
+    BOOST_CHECK_EQUAL(ss.m_amplitude, expected.m_amplitude);
+    BOOST_CHECK_EQUAL(ss.m_median, expected.m_median);
+    BOOST_CHECK_CLOSE(ss.m_sum, expected.m_sum, 1e-9);
+    BOOST_CHECK_CLOSE(ss.m_mean, expected.m_mean, 1e-9);
+    BOOST_CHECK_CLOSE(ss.m_variance, expected.m_variance, 1e-7);
+    BOOST_CHECK_CLOSE(ss.m_stdDeviation, expected.m_stdDeviation, 1e-7);
+    BOOST_CHECK_CLOSE(ss.m_varCoeff, expected.m_varCoeff, 1e-7);
+    BOOST_CHECK_CLOSE(ss.m_skewness, expected.m_skewness, 1e-6);
+    BOOST_CHECK_CLOSE(ss.m_kurtosis, GetKurtosis(values, expected.m_mean), 1e-6);
+
+    BOOST_CHECK_EQUAL_COLLECTIONS(ss.m_mode.begin(), ss.m_mode.end(), expected.m_mode.begin(), expected.m_mode.end());
+  }
+}
+
+BOOST_AUTO_TEST_SUITE( zonal_statistics_tests )
+
+BOOST_AUTO_TEST_CASE( summary_and_mode_test )
+{
+  std::auto_ptr<te::rst::Raster> raster(CreateRaster());
+
+// an irregular polygon, with vertices off the cell corners
+  const double outer0[] = { 10.37, 12.11, 61.73, 20.29, 70.13, 63.61, 35.53, 81.47, 5.19, 47.83 };
+
+  te::gm::Polygon polygon(0, te::gm::PolygonType);
+  polygon.push_back(CreateRing(outer0, 5));
+
+// a multipolygon whose first part has a hole
+  const double outer1[] = { 80.21, 5.43, 140.67, 5.43, 140.67, 45.31, 80.21, 45.31 };
+  const double hole1[] = { 95.13, 15.27, 120.89, 15.27, 120.89, 35.71, 95.13, 35.71 };
+  const double outer2[] = { 90.41, 60.17, 130.59, 55.83, 145.23, 95.37, 100.77, 90.61 };
+
+  te::gm::Polygon* part1 = new te::gm::Polygon(0, te::gm::PolygonType);
+  part1->push_back(CreateRing(outer1, 4));
+  part1->push_back(CreateRing(hole1, 4));
+
+  te::gm::Polygon* part2 = new te::gm::Polygon(0, te::gm::PolygonType);
+  part2->push_back(CreateRing(outer2, 4));
+
+  te::gm::MultiPolygon multiPolygon(0, te::gm::MultiPolygonType);
+  multiPolygon.add(part1);
+  multiPolygon.add(part2);
+
+// a polygon that crosses the raster border
+  const double outer3[] = { -20.43, 70.19, 30.77, 70.19, 30.77, 120.53, -20.43, 120.53 };
+
+  te::gm::Polygon border(0, te::gm::PolygonType);
+  border.push_back(CreateRing(outer3, 4));
+
+// a polygon smaller than a cell does not cover any cell
+  const double outer4[] = { 3.1, 3.1, 3.4, 3.1, 3.4, 3.4 };
+
+  te::gm::Polygon tiny(0, te::gm::PolygonType);
+  tiny.push_back(CreateRing(outer4, 3));
+
+  std::vector<std::vector<const te::gm::Polygon*> > zones(3);
+  zones[0].push_back(&polygon);
+  zones[1].push_back(part1);
+  zones[1].push_back(part2);
+  zones[2].push_back(&border);
+
+  std::vector<unsigned int> bands;
+  bands.push_back(0);
+  bands.push_back(1);
+
+  std::vector<std::vector<double> > values[2];
+
+  for(unsigned int b = 0; b < 2; ++b)
+    for(std::size_t z = 0; z < zones.size(); ++z)
+      values[b].push_back(GetCoveredValues(*raster, zones[z], b));
+
+// the first zone must have no-data cells, which are accumulated as any other value
+  std::size_t nNoData = 0;
+
+  for(std::size_t i = 0; i < values[0][0].size(); ++i)
+    nNoData += (values[0][0][i] == sg_noDataValue) ? 1 : 0;
+
+  BOOST_REQUIRE(nNoData > 0);
+
+  const unsigned int threads[] = { 1, 4, 8 };
+
+  for(std::size_t t = 0; t < 3; ++t)
+  {
+    BOOST_TEST_MESSAGE("Threads: " << threads[t]);
+
+    te::attributefill::ZonalStatistics zs(raster.get(), bands, true, threads[t]);
+
+    BOOST_CHECK_EQUAL(zs.addZone(&polygon), 0);
+    BOOST_CHECK_EQUAL(zs.addZone(&multiPolygon), 1);
+    BOOST_CHECK_EQUAL(zs.addZone(&border), 2);
+    BOOST_CHECK_EQUAL(zs.addZone(&tiny), 3);
+    BOOST_CHECK_EQUAL(zs.getNumberOfZones(), 4);
+
+    BOOST_REQUIRE(zs.compute());
+
+    for(unsigned int b = 0; b < 2; ++b)
+      for(std::size_t z = 0; z < zones.size(); ++z)
+        CheckZone(zs, z, b, values[b][z]);
+
+// the summary of an empty zone is not changed
+    te::stat::NumericStatisticalSummary ss;
+    zs.getSummary(3, 0, ss);
+
+    BOOST_CHECK_EQUAL(ss.m_count, 0);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
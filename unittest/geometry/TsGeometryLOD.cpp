@@ -0,0 +1,504 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+// Unit-Test TerraLib
+#include "TsGeometryLOD.h"
+
+// TerraLib
+#include <terralib/common.h>
+#include <terralib/dataaccess/dataset/DataSetType.h>
+#include <terralib/geometry.h>
+#include <terralib/maptools/AbstractLayer.h>
+#include <terralib/maptools/Canvas.h>
+#include <terralib/maptools/GeometryLODCache.h>
+#include <terralib/maptools/Utils.h>
+#include <terralib/memory/DataSet.h>
+#include <terralib/memory/DataSetItem.h>
+#include <terralib/srs/Config.h>
+
+// STL
+#include <memory>
+#include <string>
+#include <vector>
+
+// Boost
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/thread.hpp>
+
+CPPUNIT_TEST_SUITE_REGISTRATION( TsGeometryLOD );
+
+namespace
+{
+  /*! \brief A layer over an in-memory dataset of geometries. */
+  class LODTestLayer : public te::map::AbstractLayer
+  {
+    public:
+
+      LODTestLayer(te::da::DataSetType* schema, te::mem::DataSet* data)
+        : te::map::AbstractLayer("lod", "lod"),
+          m_schema(schema),
+          m_data(data)
+      {
+      }
+
+      std::auto_ptr<te::map::LayerSchema> getSchema() const
+      {
+        return std::auto_ptr<te::map::LayerSchema>(static_cast<te::map::LayerSchema*>(m_schema->clone()));
+      }
+
+      std::auto_ptr<te::da::DataSet> getData(te::common::TraverseType /*travType*/,
+                                             const te::common::AccessPolicy /*accessPolicy*/) const
+      {
+        return copyData();
+      }
+
+      std::auto_ptr<te::da::DataSet> getData(const std::string& /*propertyName*/,
+                                             const te::gm::Envelope* /*e*/,
+                                             te::gm::SpatialRelation /*r*/,
+                                             te::common::TraverseType /*travType*/,
+                                             const te::common::AccessPolicy /*accessPolicy*/) const
+      {
+        return copyData();
+      }
+
+      std::auto_ptr<te::da::DataSet> getData(const std::string& /*propertyName*/,
+                                             const te::gm::Geometry* /*g*/,
+                                             te::gm::SpatialRelation /*r*/,
+                                             te::common::TraverseType /*travType*/,
+                                             const te::common::AccessPolicy /*accessPolicy*/) const
+      {
+        return copyData();
+      }
+
+      std::auto_ptr<te::da::DataSet> getData(te::da::Expression* /*restriction*/,
+                                             te::common::TraverseType /*travType*/,
+                                             const te::common::AccessPolicy /*accessPolicy*/) const
+      {
+        return copyData();
+      }
+
+      std::auto_ptr<te::da::DataSet> getData(const te::da::ObjectIdSet* /*oids*/,
+                                             te::common::TraverseType /*travType*/,
+                                             const te::common::AccessPolicy /*accessPolicy*/) const
+      {
+        return copyData();
+      }
+
+      const std::string& getType() const
+      {
+        static const std::string type("LODTESTLAYER");
+        return type;
+      }
+
+      bool isValid() const
+      {
+        return true;
+      }
+
+      void draw(te::map::Canvas* /*canvas*/, const te::gm::Envelope& /*bbox*/, int /*srid*/, const double& /*scale*/, bool* /*cancel*/)
+      {
+      }
+
+    private:
+
+      std::auto_ptr<te::da::DataSet> copyData() const
+      {
+        return std::auto_ptr<te::da::DataSet>(new te::mem::DataSet(*m_data, true));
+      }
+
+      std::auto_ptr<te::da::DataSetType> m_schema;
+      std::auto_ptr<te::mem::DataSet> m_data;
+  };
+
+  /*! \brief A canvas that only counts the WKB views drawn and their coordinates. */
+  class CountingCanvas : public te::map::Canvas
+  {
+    public:
+
+      CountingCanvas()
+        : m_nViews(0),
+          m_nCoords(0)
+      {
+      }
+
+      void draw(const te::gm::WKBView& view)
+      {
+        ++m_nViews;
+        m_nCoords += view.getNumCoords();
+      }
+
+      void setWindow(const double& /*llx*/, const double& /*lly*/, const double& /*urx*/, const double& /*ury*/) { }
+      void calcAspectRatio(double& /*llx*/, double& /*lly*/, double& /*urx*/, double& /*ury*/, const te::map::AlignType /*hAlign*/, const te::map::AlignType /*vAlign*/) { }
+      void calcAspectRatio(te::gm::Envelope* /*envelope*/, const te::map::AlignType /*hAlign*/, const te::map::AlignType /*vAlign*/) { }
+      void setBackgroundColor(const te::color::RGBAColor& /*color*/) { }
+      te::color::RGBAColor getBackgroundColor() const { return te::color::RGBAColor(); }
+      void clear() { }
+      void resize(int /*w*/, int /*h*/) { }
+      int getWidth() const { return 0; }
+      int getHeight() const { return 0; }
+      void draw(const te::gm::Geometry* /*geom*/) { }
+      void draw(const te::gm::Point* /*point*/) { }
+      void draw(const te::gm::MultiPoint* /*mpoint*/) { }
+      void draw(const te::gm::LineString* /*line*/) { }
+      void draw(const te::gm::MultiLineString* /*mline*/) { }
+      void draw(const te::gm::Polygon* /*poly*/) { }
+      void draw(const te::gm::MultiPolygon* /*mpoly*/) { }
+      void draw(const te::gm::GeometryCollection* /*g*/) { }
+      void draw(const te::gm::MultiSurface* /*g*/) { }
+      void save(const char* /*fileName*/, te::map::ImageType /*t*/, int /*quality*/, int /*fg*/) const { }
+      char* getImage(te::map::ImageType /*t*/, std::size_t& /*size*/, int /*quality*/, int /*fg*/) const { return 0; }
+      te::color::RGBAColor** getImage(const int /*x*/, const int /*y*/, const int /*w*/, const int /*h*/) const { return 0; }
+      void freeImage(char* /*img*/) const { }
+      void drawImage(char* /*src*/, std::size_t /*size*/, te::map::ImageType /*t*/) { }
+      void drawImage(te::color::RGBAColor** /*src*/, int /*w*/, int /*h*/) { }
+      void drawImage(int /*x*/, int /*y*/, char* /*src*/, std::size_t /*size*/, te::map::ImageType /*t*/) { }
+      void drawImage(int /*x*/, int /*y*/, te::color::RGBAColor** /*src*/, int /*w*/, int /*h*/) { }
+      void drawImage(int /*x*/, int /*y*/, int /*w*/, int /*h*/, char* /*src*/, std::size_t /*size*/, te::map::ImageType /*t*/) { }
+      void drawImage(int /*x*/, int /*y*/, int /*w*/, int /*h*/, te::color::RGBAColor** /*src*/, int /*srcw*/, int /*srch*/) { }
+      void drawImage(int /*x*/, int /*y*/, int /*w*/, int /*h*/, char* /*src*/, std::size_t /*size*/, te::map::ImageType /*t*/, int /*sx*/, int /*sy*/, int /*sw*/, int /*sh*/) { }
+      void drawImage(int /*x*/, int /*y*/, int /*w*/, int /*h*/, te::color::RGBAColor** /*src*/, int /*sx*/, int /*sy*/, int /*sw*/, int /*sh*/) { }
+      void drawImage(int /*x*/, int /*y*/, te::rst::Raster* /*src*/, int /*opacity*/) { }
+      void drawImage(int /*x*/, int /*y*/, int /*w*/, int /*h*/, te::rst::Raster* /*src*/, int /*sx*/, int /*sy*/, int /*sw*/, int /*sh*/, int /*opacity*/) { }
+      void drawPixel(int /*x*/, int /*y*/) { }
+      void drawPixel(int /*x*/, int /*y*/, const te::color::RGBAColor& /*color*/) { }
+      void drawText(int /*x*/, int /*y*/, const std::string& /*txt*/, float /*angle*/, double /*anchorX*/, double /*anchorY*/, int /*displacementX*/, int /*displacementY*/) { }
+      void drawText(const te::gm::Point* /*p*/, const std::string& /*txt*/, float /*angle*/, double /*anchorX*/, double /*anchorY*/, int /*displacementX*/, int /*displacementY*/) { }
+      void drawText(const double& /*x*/, const double& /*y*/, const std::string& /*txt*/, float /*angle*/, double /*anchorX*/, double /*anchorY*/, int /*displacementX*/, int /*displacementY*/) { }
+      te::gm::Polygon* getTextBoundary(int /*x*/, int /*y*/, const std::string& /*txt*/, float /*angle*/, double /*anchorX*/, double /*anchorY*/, int /*displacementX*/, int /*displacementY*/) { return 0; }
+      te::gm::Polygon* getTextBoundary(const te::gm::Point* /*p*/, const std::string& /*txt*/, float /*angle*/, double /*anchorX*/, double /*anchorY*/, int /*displacementX*/, int /*displacementY*/) { return 0; }
+      te::gm::Polygon* getTextBoundary(const double& /*x*/, const double& /*y*/, const std::string& /*txt*/, float /*angle*/, double /*anchorX*/, double /*anchorY*/, int /*displacementX*/, int /*displacementY*/) { return 0; }
+      void setTextColor(const te::color::RGBAColor& /*color*/) { }
+      void setTextOpacity(int /*opacity*/) { }
+      void setFontFamily(const std::string& /*family*/) { }
+      void setTextPointSize(double /*size*/) { }
+      void setTextStyle(te::se::Font::FontStyleType /*style*/) { }
+      void setTextWeight(te::se::Font::FontWeightType /*weight*/) { }
+      void setTextStretch(std::size_t /*stretch*/) { }
+      void setTextUnderline(bool /*b*/) { }
+      void setTextOverline(bool /*b*/) { }
+      void setTextStrikeOut(bool /*b*/) { }
+      void setTextDecorationColor(const te::color::RGBAColor& /*color*/) { }
+      void setTextDecorationWidth(int /*width*/) { }
+      void setTextContourColor(const te::color::RGBAColor& /*color*/) { }
+      void setTextContourEnabled(bool /*b*/) { }
+      void setTextContourOpacity(int /*opacity*/) { }
+      void setTextContourWidth(int /*width*/) { }
+      void setTextJustification(int /*justType*/) { }
+      void setTextMultiLineSpacing(int /*spacing*/) { }
+      void setPointColor(const te::color::RGBAColor& /*color*/) { }
+      void setPointWidth(int /*w*/) { }
+      void setPointPattern(te::color::RGBAColor** /*pattern*/, int /*ncols*/, int /*nrows*/) { }
+      void setPointPattern(char* /*pattern*/, std::size_t /*size*/, te::map::ImageType /*t*/) { }
+      void setPointPatternRotation(const double& /*angle*/) { }
+      void setPointPatternOpacity(int /*opacity*/) { }
+      void setLineColor(const te::color::RGBAColor& /*color*/) { }
+      void setLinePattern(te::color::RGBAColor** /*pattern*/, int /*ncols*/, int /*nrows*/) { }
+      void setLinePattern(char* /*pattern*/, std::size_t /*size*/, te::map::ImageType /*t*/) { }
+      void setLinePatternRotation(const double& /*angle*/) { }
+      void setLinePatternOpacity(int /*opacity*/) { }
+      void setLineWidth(int /*w*/) { }
+      void setLineDashStyle(te::map::LineDashStyle /*style*/) { }
+      void setLineDashStyle(const std::vector<double>& /*style*/) { }
+      void setLineCapStyle(te::map::LineCapStyle /*style*/) { }
+      void setLineJoinStyle(te::map::LineJoinStyle /*style*/) { }
+      void setPolygonFillColor(const te::color::RGBAColor& /*color*/) { }
+      void setPolygonContourColor(const te::color::RGBAColor& /*color*/) { }
+      void setPolygonFillPattern(te::color::RGBAColor** /*pattern*/, int /*ncols*/, int /*nrows*/) { }
+      void setPolygonFillPattern(char* /*pattern*/, std::size_t /*size*/, te::map::ImageType /*t*/) { }
+      void setPolygonPatternWidth(int /*w*/) { }
+      void setPolygonPatternRotation(const double& /*angle*/) { }
+      void setPolygonPatternOpacity(int /*opacity*/) { }
+      void setPolygonContourPattern(te::color::RGBAColor** /*pattern*/, int /*ncols*/, int /*nrows*/) { }
+      void setPolygonContourPattern(char* /*pattern*/, std::size_t /*size*/, te::map::ImageType /*t*/) { }
+      void setPolygonContourWidth(int /*w*/) { }
+      void setPolygonContourPatternRotation(const double& /*angle*/) { }
+      void setPolygonContourPatternOpacity(int /*opacity*/) { }
+      void setPolygonContourDashStyle(te::map::LineDashStyle /*style*/) { }
+      void setPolygonContourDashStyle(const std::vector<double>& /*style*/) { }
+      void setPolygonContourCapStyle(te::map::LineCapStyle /*style*/) { }
+      void setPolygonContourJoinStyle(te::map::LineJoinStyle /*style*/) { }
+      void setEraseMode() { }
+      void setNormalMode() { }
+
+      std::size_t m_nViews;
+      std::size_t m_nCoords;
+  };
+
+  te::gm::Geometry* ReadWKT(const std::string& wkt)
+  {
+    return te::gm::WKTReader::read(wkt.c_str());
+  }
+
+  void ReadView(const std::string& wkt, std::vector<char>& wkb, te::gm::WKBView& view)
+  {
+    std::auto_ptr<te::gm::Geometry> g(ReadWKT(wkt));
+
+    wkb.resize(g->getWkbSize());
+    g->getWkb(&wkb[0], te::common::Globals::sm_machineByteOrder);
+
+    view.read(&wkb[0]);
+  }
+}
+
+void TsGeometryLOD::setUp()
+{
+}
+
+void TsGeometryLOD::tearDown()
+{
+}
+
+void TsGeometryLOD::tcDecimateCoords()
+{
+  te::gm::Coord2D line[] = { te::gm::Coord2D(0.0, 0.0), te::gm::Coord2D(0.5, 0.0), te::gm::Coord2D(1.0, 0.0),
+                             te::gm::Coord2D(1.2, 0.0), te::gm::Coord2D(3.0, 0.0), te::gm::Coord2D(3.1, 0.0) };
+
+// the last coordinate replaces the last kept one, that is too close to it
+  CPPUNIT_ASSERT(te::gm::Decimate(line, 6, 1.0) == 3);
+  CPPUNIT_ASSERT(line[0].x == 0.0);
+  CPPUNIT_ASSERT(line[1].x == 1.0);
+  CPPUNIT_ASSERT(line[2].x == 3.1);
+
+// two coordinates are always kept
+  te::gm::Coord2D segment[] = { te::gm::Coord2D(0.0, 0.0), te::gm::Coord2D(0.1, 0.0) };
+
+  CPPUNIT_ASSERT(te::gm::Decimate(segment, 2, 1.0) == 2);
+
+// a ring smaller than the tolerance remains closed
+  te::gm::Coord2D ring[] = { te::gm::Coord2D(0.0, 0.0), te::gm::Coord2D(0.1, 0.0), te::gm::Coord2D(0.1, 0.1),
+                             te::gm::Coord2D(0.0, 0.1), te::gm::Coord2D(0.0, 0.0) };
+
+  CPPUNIT_ASSERT(te::gm::Decimate(ring, 5, 1.0) == 2);
+  CPPUNIT_ASSERT(ring[0].x == ring[1].x && ring[0].y == ring[1].y);
+
+// nothing is removed with a null tolerance
+  te::gm::Coord2D same[] = { te::gm::Coord2D(0.0, 0.0), te::gm::Coord2D(0.5, 0.0), te::gm::Coord2D(1.0, 0.0) };
+
+  CPPUNIT_ASSERT(te::gm::Decimate(same, 3, 0.0) == 3);
+}
+
+void TsGeometryLOD::tcDecimateGeometry()
+{
+  std::auto_ptr<te::gm::Geometry> line(ReadWKT("LINESTRING(0 0,0.5 0,1 0,1.2 0,3 0,3.1 0)"));
+
+  te::gm::Decimate(line.get(), 1.0);
+
+  CPPUNIT_ASSERT(line->getNPoints() == 3);
+
+  std::auto_ptr<te::gm::Geometry> poly(ReadWKT("POLYGON((0 0,0.5 0,10 0,10 10,0 10,0 0),(2 2,2.5 2,4 2,4 4,2 2))"));
+
+  te::gm::Decimate(poly.get(), 1.0);
+
+  te::gm::Polygon* p = static_cast<te::gm::Polygon*>(poly.get());
+
+  CPPUNIT_ASSERT(p->getRingN(0)->getNPoints() == 5);
+  CPPUNIT_ASSERT(p->getRingN(1)->getNPoints() == 4);
+
+  std::auto_ptr<te::gm::Geometry> mline(ReadWKT("MULTILINESTRING((0 0,0.5 0,1 0),(5 5,5.5 5,6 5,6.5 5,7 5))"));
+
+  te::gm::Decimate(mline.get(), 1.0);
+
+  CPPUNIT_ASSERT(mline->getNPoints() == 5);
+
+// lines with z or m values are not changed
+  std::auto_ptr<te::gm::Geometry> linez(ReadWKT("LINESTRING Z(0 0 1,0.5 0 1,1 0 1,1.2 0 1,3 0 1)"));
+
+  te::gm::Decimate(linez.get(), 1.0);
+
+  CPPUNIT_ASSERT(linez->getNPoints() == 5);
+
+  std::auto_ptr<te::gm::Geometry> polym(ReadWKT("POLYGON M((0 0 1,0.5 0 1,10 0 1,10 10 1,0 0 1))"));
+
+  te::gm::Decimate(polym.get(), 1.0);
+
+  CPPUNIT_ASSERT(polym->getNPoints() == 5);
+}
+
+void TsGeometryLOD::tcDecimateView()
+{
+  std::vector<char> wkb;
+  te::gm::WKBView view;
+
+  ReadView("MULTIPOLYGON(((0 0,0.5 0,10 0,10 10,0 10,0 0),(2 2,2.5 2,4 2,4 4,2 2)),((20 20,20.5 20,30 20,20 20)))", wkb, view);
+
+  CPPUNIT_ASSERT(view.getNumCoords() == 15);
+
+  view.decimate(1.0);
+
+  CPPUNIT_ASSERT(view.getNumCoords() == 12);
+  CPPUNIT_ASSERT(view.getNumParts() == 2);
+  CPPUNIT_ASSERT(view.getNumRings(0) == 2);
+
+  std::size_t npts = 0;
+
+  const te::gm::Coord2D* r0 = view.getRing(0, 0, npts);
+
+  CPPUNIT_ASSERT(npts == 5);
+  CPPUNIT_ASSERT(r0[0].x == 0.0 && r0[1].x == 10.0 && r0[4].x == 0.0 && r0[4].y == 0.0);
+
+  const te::gm::Coord2D* r1 = view.getRing(0, 1, npts);
+
+  CPPUNIT_ASSERT(npts == 4);
+  CPPUNIT_ASSERT(r1 == r0 + 5);
+  CPPUNIT_ASSERT(r1[0].x == 2.0 && r1[1].x == 4.0 && r1[3].x == 2.0 && r1[3].y == 2.0);
+
+  const te::gm::Coord2D* r2 = view.getRing(1, 0, npts);
+
+  CPPUNIT_ASSERT(npts == 3);
+  CPPUNIT_ASSERT(r2 == r1 + 4);
+  CPPUNIT_ASSERT(r2[0].x == 20.0 && r2[1].x == 30.0 && r2[2].x == 20.0);
+}
+
+void TsGeometryLOD::tcGeneralizeGeometry()
+{
+// points are never left out
+  std::auto_ptr<te::gm::Geometry> point(ReadWKT("POINT(1 2)"));
+
+  CPPUNIT_ASSERT(te::map::Generalize(point.get(), 10.0));
+
+  std::auto_ptr<te::gm::Geometry> mpoint(ReadWKT("MULTIPOINT((1 2),(1.5 2))"));
+
+  CPPUNIT_ASSERT(te::map::Generalize(mpoint.get(), 10.0));
+  CPPUNIT_ASSERT(mpoint->getNPoints() == 2);
+
+// lines and polygons smaller than the tolerance are left out
+  std::auto_ptr<te::gm::Geometry> line(ReadWKT("LINESTRING(0 0,0.5 0.5)"));
+
+  CPPUNIT_ASSERT(!te::map::Generalize(line.get(), 1.0));
+
+  std::auto_ptr<te::gm::Geometry> poly(ReadWKT("POLYGON((0 0,0.5 0,0.5 0.5,0 0))"));
+
+  CPPUNIT_ASSERT(!te::map::Generalize(poly.get(), 1.0));
+
+// the others are decimated
+  std::auto_ptr<te::gm::Geometry> big(ReadWKT("LINESTRING(0 0,0.5 0,1 0,1.2 0,3 0,3.1 0)"));
+
+  CPPUNIT_ASSERT(te::map::Generalize(big.get(), 1.0));
+  CPPUNIT_ASSERT(big->getNPoints() == 3);
+}
+
+void TsGeometryLOD::tcGeneralizeView()
+{
+  std::vector<char> wkb;
+  te::gm::WKBView view;
+
+// points are never left out
+  ReadView("MULTIPOINT((1 2),(1.5 2))", wkb, view);
+
+  CPPUNIT_ASSERT(te::map::Generalize(view, 10.0));
+  CPPUNIT_ASSERT(view.getNumCoords() == 2);
+
+// lines and polygons smaller than the tolerance are left out
+  ReadView("LINESTRING(0 0,0.5 0.5)", wkb, view);
+
+  CPPUNIT_ASSERT(!te::map::Generalize(view, 1.0));
+
+  ReadView("POLYGON((0 0,0.5 0,0.5 0.5,0 0))", wkb, view);
+
+  CPPUNIT_ASSERT(!te::map::Generalize(view, 1.0));
+
+// a small collection is kept only if all its parts are points
+  ReadView("GEOMETRYCOLLECTION(POINT(0 0),POINT(0.5 0.5))", wkb, view);
+
+  CPPUNIT_ASSERT(te::map::Generalize(view, 1.0));
+
+  ReadView("GEOMETRYCOLLECTION(POINT(0 0),LINESTRING(0 0,0.5 0.5))", wkb, view);
+
+  CPPUNIT_ASSERT(!te::map::Generalize(view, 1.0));
+
+// the others are decimated
+  ReadView("LINESTRING(0 0,0.5 0,1 0,1.2 0,3 0,3.1 0)", wkb, view);
+
+  CPPUNIT_ASSERT(te::map::Generalize(view, 1.0));
+  CPPUNIT_ASSERT(view.getNumCoords() == 3);
+}
+
+void TsGeometryLOD::tcLODCache()
+{
+  te::da::DataSetType* schema = new te::da::DataSetType("lod");
+  schema->add(new te::gm::GeometryProperty("geom", 0, te::gm::GeometryType));
+
+  te::mem::DataSet* data = new te::mem::DataSet(schema);
+
+// the extent gives the levels the tolerances 1, 4, 16, 64 and 256
+  std::string line("LINESTRING(0 8000");
+
+  for(int x = 1; x <= 16384; ++x)
+    line += "," + boost::lexical_cast<std::string>(x) + " 8000";
+
+  line += ")";
+
+  const char* wkts[] = { "POLYGON((0 0,10000 0,10000 10000,0 10000,0 0))",   // in all levels
+                         "POLYGON((100 100,110 100,110 110,100 110,100 100))", // only in the levels 1 and 4
+                         "LINESTRING(200 200,202 200)",                        // only in the level 1
+                         "POINT(300 300)",                                     // in all levels
+                         line.c_str() };                                       // decimated in each level
+
+  for(std::size_t i = 0; i < 5; ++i)
+  {
+    te::mem::DataSetItem* item = new te::mem::DataSetItem(data);
+    item->setGeometry(0, ReadWKT(wkts[i]));
+    data->add(item);
+  }
+
+  te::map::AbstractLayerPtr layer(new LODTestLayer(schema, data));
+  layer->setSRID(TE_UNKNOWN_SRS);
+  layer->setExtent(te::gm::Envelope(0.0, 0.0, 16384.0, 16384.0));
+
+  te::map::GeometryLODCache cache(layer);
+
+  for(int i = 0; (i < 1000) && !cache.isReady(); ++i)
+    boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+
+  CPPUNIT_ASSERT(cache.isReady());
+
+  const te::gm::Envelope all(0.0, 0.0, 16384.0, 16384.0);
+
+// no level is fine enough
+  CountingCanvas canvas0;
+
+  CPPUNIT_ASSERT(!cache.draw(&canvas0, all, TE_UNKNOWN_SRS, 0.5, 0));
+  CPPUNIT_ASSERT(canvas0.m_nViews == 0);
+
+// the finest level has all the geometries
+  CountingCanvas canvas1;
+
+  CPPUNIT_ASSERT(cache.draw(&canvas1, all, TE_UNKNOWN_SRS, 1.0, 0));
+  CPPUNIT_ASSERT(canvas1.m_nViews == 5);
+
+// a tolerance between two levels uses the finer one
+  CountingCanvas canvas5;
+
+  CPPUNIT_ASSERT(cache.draw(&canvas5, all, TE_UNKNOWN_SRS, 5.0, 0));
+  CPPUNIT_ASSERT(canvas5.m_nViews == 4);
+
+// the coarsest level has the big polygon, the point and the decimated line
+  CountingCanvas canvas256;
+
+  CPPUNIT_ASSERT(cache.draw(&canvas256, all, TE_UNKNOWN_SRS, 1000.0, 0));
+  CPPUNIT_ASSERT(canvas256.m_nViews == 3);
+  CPPUNIT_ASSERT(canvas256.m_nCoords == 5 + 1 + 65);
+
+// only the geometries that intersect the box are drawn
+  CountingCanvas canvasBox;
+
+  CPPUNIT_ASSERT(cache.draw(&canvasBox, te::gm::Envelope(250.0, 250.0, 350.0, 350.0), TE_UNKNOWN_SRS, 1.0, 0));
+  CPPUNIT_ASSERT(canvasBox.m_nViews == 2);
+}
@@ -0,0 +1,91 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+  \file TsGeometryLOD.h
+
+  \brief Test suite for the geometry levels of detail used when drawing.
+ */
+
+#ifndef __TERRALIB_UNITTEST_GEOMETRY_INTERNAL_GEOMETRYLOD_H
+#define __TERRALIB_UNITTEST_GEOMETRY_INTERNAL_GEOMETRYLOD_H
+
+// cppUnit
+#include <cppunit/extensions/HelperMacros.h>
+
+/*!
+  \class TsGeometryLOD
+
+  \brief Test suite for the decimation and generalization of geometries.
+
+  This test suite will check the following:
+  <ul>
+  <li>te::gm::Decimate on coordinate sequences and on geometries;</li>
+  <li>WKBView::decimate on views with several parts and rings;</li>
+  <li>te::map::Generalize on geometries and on WKB views;</li>
+  <li>The levels of detail built by te::map::GeometryLODCache.</li>
+  </ul>
+ */
+class TsGeometryLOD : public CPPUNIT_NS::TestFixture
+{
+// It registers this class as a Test Suit
+  CPPUNIT_TEST_SUITE( TsGeometryLOD );
+
+// It registers the class methods as Test Cases belonging to the suit
+  CPPUNIT_TEST( tcDecimateCoords );
+  CPPUNIT_TEST( tcDecimateGeometry );
+  CPPUNIT_TEST( tcDecimateView );
+  CPPUNIT_TEST( tcGeneralizeGeometry );
+  CPPUNIT_TEST( tcGeneralizeView );
+  CPPUNIT_TEST( tcLODCache );
+
+  CPPUNIT_TEST_SUITE_END();
+
+  public:
+
+// It sets up context before running the test.
+    void setUp();
+
+// It cleann up after the test run.
+    void tearDown();
+
+  protected:
+
+// Test Cases:
+
+    /*! \brief Test Case: decimating sequences of coordinates, including closed rings. */
+    void tcDecimateCoords();
+
+    /*! \brief Test Case: decimating lines, polygons and collections in place. */
+    void tcDecimateGeometry();
+
+    /*! \brief Test Case: decimating a WKB view must compact the coordinates of its rings. */
+    void tcDecimateView();
+
+    /*! \brief Test Case: generalizing geometries, where points are kept and tiny lines and polygons are left out. */
+    void tcGeneralizeGeometry();
+
+    /*! \brief Test Case: generalizing WKB views, where points are kept and tiny lines and polygons are left out. */
+    void tcGeneralizeView();
+
+    /*! \brief Test Case: drawing the levels of detail of a layer. */
+    void tcLODCache();
+};
+
+#endif  // __TERRALIB_UNITTEST_GEOMETRY_INTERNAL_GEOMETRYLOD_H
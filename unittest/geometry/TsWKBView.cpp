@@ -0,0 +1,230 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+// Unit-Test TerraLib
+#include "TsWKBView.h"
+
+// TerraLib
+#include <terralib/common.h>
+#include <terralib/geometry.h>
+
+// STL
+#include <memory>
+#include <vector>
+
+// Boost
+#include <boost/scoped_array.hpp>
+
+CPPUNIT_TEST_SUITE_REGISTRATION( TsWKBView );
+
+void TsWKBView::setUp()
+{
+}
+
+void TsWKBView::tearDown()
+{
+}
+
+void TsWKBView::tcReadPolygon()
+{
+  const std::string wkt("POLYGON((10 18,15 18,15 22,10 22,10 18),(11 20,12 20,12 21,11 21,11 20))");
+
+  checkView(wkt, te::common::NDR);
+  checkView(wkt, te::common::XDR);
+
+  std::auto_ptr<te::gm::Geometry> g(te::gm::WKTReader::read(wkt.c_str()));
+
+  std::vector<char> wkb(g->getWkbSize());
+  g->getWkb(&wkb[0], te::common::Globals::sm_machineByteOrder);
+
+  te::gm::WKBView view;
+
+  CPPUNIT_ASSERT(view.read(&wkb[0]) == &wkb[0] + wkb.size());
+  CPPUNIT_ASSERT(view.getGeomTypeId() == te::gm::PolygonType);
+  CPPUNIT_ASSERT(view.getNumParts() == 1);
+  CPPUNIT_ASSERT(view.getPartType(0) == te::gm::PolygonType);
+  CPPUNIT_ASSERT(view.getNumRings(0) == 2);
+  CPPUNIT_ASSERT(view.getNumCoords() == 10);
+  CPPUNIT_ASSERT(view.getMBR() == *g->getMBR());
+}
+
+void TsWKBView::tcReadMultiGeometries()
+{
+  checkView("MULTIPOINT((1 2),(3 4))", te::common::NDR);
+  checkView("MULTILINESTRING((0 0,1 1,2 2),(5 5,6 6))", te::common::XDR);
+  checkView("MULTIPOLYGON(((0 0,10 0,10 10,0 10,0 0)),((20 20,30 20,30 30,20 20)))", te::common::NDR);
+  checkView("GEOMETRYCOLLECTION(POINT(1 2),LINESTRING(0 0,1 1),POLYGON((0 0,1 0,1 1,0 0)))", te::common::XDR);
+
+  std::auto_ptr<te::gm::Geometry> g(te::gm::WKTReader::read("GEOMETRYCOLLECTION(POINT(1 2),LINESTRING(0 0,1 1),POLYGON((0 0,1 0,1 1,0 0)))"));
+
+  std::vector<char> wkb(g->getWkbSize());
+  g->getWkb(&wkb[0], te::common::NDR);
+
+  te::gm::WKBView view;
+  view.read(&wkb[0]);
+
+  CPPUNIT_ASSERT(view.getGeomTypeId() == te::gm::GeometryCollectionType);
+  CPPUNIT_ASSERT(view.getNumParts() == 3);
+  CPPUNIT_ASSERT(view.getPartType(0) == te::gm::PointType);
+  CPPUNIT_ASSERT(view.getPartType(1) == te::gm::LineStringType);
+  CPPUNIT_ASSERT(view.getPartType(2) == te::gm::PolygonType);
+  CPPUNIT_ASSERT(view.getPartMBR(2) == te::gm::Envelope(0.0, 0.0, 1.0, 1.0));
+}
+
+void TsWKBView::tcReadEWKB()
+{
+// POINT(1 2) with SRID 4326 in PostGIS EWKB (little endian)
+  boost::scoped_array<char> ewkb1(te::common::Hex2Binary("0101000020E6100000000000000000F03F0000000000000040"));
+
+  te::gm::WKBView view;
+  view.read(ewkb1.get());
+
+  CPPUNIT_ASSERT(view.getSRID() == 4326);
+  CPPUNIT_ASSERT(view.getGeomTypeId() == te::gm::PointType);
+  CPPUNIT_ASSERT(view.getNumCoords() == 1);
+  CPPUNIT_ASSERT(view.getCoords()[0].x == 1.0);
+  CPPUNIT_ASSERT(view.getCoords()[0].y == 2.0);
+
+// LINESTRING Z(1 2 3, 4 5 6) with SRID 29193 in PostGIS EWKB (big endian)
+  boost::scoped_array<char> ewkb2(te::common::Hex2Binary("00A000000200007209000000023FF000000000000040000000000000004008000000000000401000000000000040140000000000004018000000000000"));
+
+  view.read(ewkb2.get());
+
+  CPPUNIT_ASSERT(view.getSRID() == 29193);
+  CPPUNIT_ASSERT(view.getGeomTypeId() == te::gm::LineStringZType);
+  CPPUNIT_ASSERT(view.getNumCoords() == 2);
+  CPPUNIT_ASSERT(view.getCoords()[1].x == 4.0);
+  CPPUNIT_ASSERT(view.getCoords()[1].y == 5.0);
+
+// OGC WKB with z and m values
+  checkView("POLYGON ZM((0 0 1 2,10 0 1 2,10 10 1 2,0 0 1 2))", te::common::NDR);
+}
+
+void TsWKBView::tcReuseView()
+{
+  te::gm::WKBView view;
+
+  checkView("POLYGON((0 0,10 0,10 10,0 10,0 0),(1 1,2 1,2 2,1 1))", te::common::NDR);
+
+  std::auto_ptr<te::gm::Geometry> big(te::gm::WKTReader::read("MULTIPOLYGON(((0 0,10 0,10 10,0 10,0 0)),((20 20,30 20,30 30,20 20)))"));
+  std::auto_ptr<te::gm::Geometry> small(te::gm::WKTReader::read("POINT(7 8)"));
+
+  std::vector<char> wkb1(big->getWkbSize());
+  big->getWkb(&wkb1[0], te::common::NDR);
+
+  std::vector<char> wkb2(small->getWkbSize());
+  small->getWkb(&wkb2[0], te::common::XDR);
+
+  view.read(&wkb1[0]);
+  CPPUNIT_ASSERT(view.getNumParts() == 2);
+
+  view.read(&wkb2[0]);
+  CPPUNIT_ASSERT(view.getNumParts() == 1);
+  CPPUNIT_ASSERT(view.getNumCoords() == 1);
+  CPPUNIT_ASSERT(view.getMBR() == te::gm::Envelope(7.0, 8.0, 7.0, 8.0));
+
+  view.clear();
+  CPPUNIT_ASSERT(view.isEmpty());
+  CPPUNIT_ASSERT(view.getNumParts() == 0);
+}
+
+void TsWKBView::tcUnsupportedType()
+{
+// CIRCULARSTRING(0 0,1 1,2 0)
+  boost::scoped_array<char> wkb(te::common::Hex2Binary("01080000000300000000000000000000000000000000000000000000000000F03F000000000000F03F00000000000000400000000000000000"));
+
+  te::gm::WKBView view;
+
+  CPPUNIT_ASSERT_THROW(view.read(wkb.get()), te::gm::Exception);
+}
+
+void TsWKBView::checkView(const std::string& wkt, int byteOrder) const
+{
+  std::auto_ptr<te::gm::Geometry> g(te::gm::WKTReader::read(wkt.c_str()));
+
+  std::vector<char> wkb(g->getWkbSize());
+  g->getWkb(&wkb[0], static_cast<te::common::MachineByteOrder>(byteOrder));
+
+  te::gm::WKBView view;
+
+  CPPUNIT_ASSERT(view.read(&wkb[0]) == &wkb[0] + wkb.size());
+  CPPUNIT_ASSERT(view.getGeomTypeId() == g->getGeomTypeId());
+  CPPUNIT_ASSERT(view.getNumCoords() == g->getNPoints());
+  CPPUNIT_ASSERT(view.getMBR() == *g->getMBR());
+
+// the arena must have the geometry coordinates in the same order
+  std::vector<te::gm::Coord2D> coords;
+
+  std::vector<te::gm::Geometry*> parts;
+
+  if(g->getGeomTypeId() % 1000 >= te::gm::MultiPointType && g->getGeomTypeId() % 1000 <= te::gm::GeometryCollectionType)
+  {
+    te::gm::GeometryCollection* col = static_cast<te::gm::GeometryCollection*>(g.get());
+
+    for(std::size_t i = 0; i < col->getNumGeometries(); ++i)
+      parts.push_back(col->getGeometryN(i));
+  }
+  else
+  {
+    parts.push_back(g.get());
+  }
+
+  for(std::size_t i = 0; i < parts.size(); ++i)
+  {
+    te::gm::Geometry* part = parts[i];
+
+    switch(part->getGeomTypeId() % 1000)
+    {
+      case te::gm::PointType:
+        {
+          te::gm::Point* p = static_cast<te::gm::Point*>(part);
+          coords.push_back(te::gm::Coord2D(p->getX(), p->getY()));
+        }
+      break;
+
+      case te::gm::LineStringType:
+        {
+          te::gm::LineString* l = static_cast<te::gm::LineString*>(part);
+          coords.insert(coords.end(), l->getCoordinates(), l->getCoordinates() + l->getNPoints());
+        }
+      break;
+
+      case te::gm::PolygonType:
+        {
+          te::gm::Polygon* poly = static_cast<te::gm::Polygon*>(part);
+
+          for(std::size_t r = 0; r < poly->getNumRings(); ++r)
+          {
+            te::gm::LineString* l = static_cast<te::gm::LineString*>(poly->getRingN(r));
+            coords.insert(coords.end(), l->getCoordinates(), l->getCoordinates() + l->getNPoints());
+          }
+        }
+      break;
+    }
+  }
+
+  CPPUNIT_ASSERT(view.getNumParts() == parts.size());
+  CPPUNIT_ASSERT(coords.size() == view.getNumCoords());
+
+  for(std::size_t i = 0; i < coords.size(); ++i)
+  {
+    CPPUNIT_ASSERT(coords[i].x == view.getCoords()[i].x);
+    CPPUNIT_ASSERT(coords[i].y == view.getCoords()[i].y);
+  }
+}
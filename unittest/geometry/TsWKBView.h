@@ -0,0 +1,100 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+  \file TsWKBView.h
+ 
+  \brief Test suite for the geometry WKB View.
+ */
+
+#ifndef __TERRALIB_UNITTEST_GEOMETRY_INTERNAL_WKBVIEW_H
+#define __TERRALIB_UNITTEST_GEOMETRY_INTERNAL_WKBVIEW_H
+
+// STL
+#include <string>
+
+// cppUnit
+#include <cppunit/extensions/HelperMacros.h>
+
+/*!
+  \class TsWKBView
+
+  \brief Test suite for the WKBView class.
+
+  This test suite will check the following:
+  <ul>
+  <li>Decoding of OGC WKB in both byte orders;</li>
+  <li>Decoding of PostGIS Extended-WKB (SRID, z and m values);</li>
+  <li>Flattening of multi-geometries and collections into parts;</li>
+  <li>Reuse of the same view for successive geometries.</li>
+  </ul>
+ */
+class TsWKBView : public CPPUNIT_NS::TestFixture
+{
+// It registers this class as a Test Suit
+  CPPUNIT_TEST_SUITE( TsWKBView );
+
+// It registers the class methods as Test Cases belonging to the suit 
+  CPPUNIT_TEST( tcReadPolygon );
+  CPPUNIT_TEST( tcReadMultiGeometries );
+  CPPUNIT_TEST( tcReadEWKB );
+  CPPUNIT_TEST( tcReuseView );
+  CPPUNIT_TEST( tcUnsupportedType );
+
+  CPPUNIT_TEST_SUITE_END();
+
+  public:
+
+// It sets up context before running the test.
+    void setUp();
+
+// It cleann up after the test run.
+    void tearDown();
+
+  protected:
+
+// Test Cases:
+
+    /*! \brief Test Case: reading a polygon with a hole in both byte orders. */
+    void tcReadPolygon();
+
+    /*! \brief Test Case: reading multi-geometries and collections. */
+    void tcReadMultiGeometries();
+
+    /*! \brief Test Case: reading PostGIS EWKB with SRID and z values. */
+    void tcReadEWKB();
+
+    /*! \brief Test Case: reading geometries of different sizes with the same view. */
+    void tcReuseView();
+
+    /*! \brief Test Case: reading a curve must throw an exception. */
+    void tcUnsupportedType();
+
+  private:
+
+    /*!
+      \brief Auxiliary method that checks if the view has the same coordinates of the geometry given by the WKT.
+
+      \param wkt       The geometry in WKT.
+      \param byteOrder The byte order used to encode the geometry.
+     */
+    void checkView(const std::string& wkt, int byteOrder) const;
+};
+
+#endif  // __TERRALIB_UNITTEST_GEOMETRY_INTERNAL_WKBVIEW_H
@@ -0,0 +1,340 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+  \file terralib/unittest/maptools/TsRasterTransform.cpp
+
+  \brief A test suit for the batched transformation of the RasterTransform class.
+
+  The colors computed for a sequence of pixels must be the same
+  of the ones computed pixel by pixel, for every transformation
+  and band data type.
+ */
+
+// TerraLib
+#include <terralib/color/ColorBar.h>
+#include <terralib/color/RGBAColor.h>
+#include <terralib/datatype/Enums.h>
+#include <terralib/maptools/RasterTransform.h>
+#include <terralib/raster/BandProperty.h>
+#include <terralib/raster/Grid.h>
+#include <terralib/raster/Raster.h>
+#include <terralib/raster/RasterFactory.h>
+#include "Config.h"
+
+// STL
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Boost
+#include <boost/lexical_cast.hpp>
+#include <boost/test/unit_test.hpp>
+
+namespace
+{
+  const unsigned int sg_nCols = 23;
+  const unsigned int sg_nRows = 7;
+  const unsigned int sg_nBands = 4;
+  const double sg_noDataValue = 7.0;
+
+  /*! \brief The minimum and maximum values written to a band of the given type. */
+  void GetValueRange(int type, double& minValue, double& maxValue)
+  {
+    switch(type)
+    {
+      case te::dt::CHAR_TYPE:
+        minValue = -128.0;
+        maxValue = 127.0;
+      break;
+
+      case te::dt::UCHAR_TYPE:
+        minValue = 0.0;
+        maxValue = 255.0;
+      break;
+
+      case te::dt::INT16_TYPE:
+        minValue = -32768.0;
+        maxValue = 32767.0;
+      break;
+
+      case te::dt::UINT16_TYPE:
+        minValue = 0.0;
+        maxValue = 65535.0;
+      break;
+
+      case te::dt::INT32_TYPE:
+        minValue = -100000.0;
+        maxValue = 100000.0;
+      break;
+
+      default:
+        minValue = -1000.5;
+        maxValue = 1000.5;
+    }
+  }
+
+  /*! \brief It creates a raster whose bands have the given type, with some no-data pixels. */
+  std::auto_ptr<te::rst::Raster> CreateRaster(int type)
+  {
+    std::vector<te::rst::BandProperty*> bandsProps;
+
+    for(unsigned int b = 0; b < sg_nBands; ++b)
+    {
+      te::rst::BandProperty* bp = new te::rst::BandProperty(b, type);
+      bp->m_noDataValue = sg_noDataValue;
+      bandsProps.push_back(bp);
+    }
+
+    std::auto_ptr<te::rst::Raster> raster(te::rst::RasterFactory::make("MEM", new te::rst::Grid(sg_nCols, sg_nRows), bandsProps,
+                                                                       std::map<std::string, std::string>(), 0, 0));
+
+    double minValue, maxValue;
+    GetValueRange(type, minValue, maxValue);
+
+    const double range = maxValue - minValue;
+
+    for(unsigned int b = 0; b < sg_nBands; ++b)
+    {
+      for(unsigned int r = 0; r < sg_nRows; ++r)
+      {
+        for(unsigned int c = 0; c < sg_nCols; ++c)
+        {
+// a pseudo-random walk over the whole range, with a fractional part for the real types
+          const unsigned int k = (c * 7919 + r * 104729 + b * 1299709) % 1009;
+
+          double value = minValue + range * k / 1008.0;
+
+          if((c + r + b) % 5 == 0)
+            value = sg_noDataValue;
+
+          raster->setValue(c, r, value, b);
+        }
+      }
+    }
+
+// the first band starts with the extreme values
+    raster->setValue(0, 0, minValue, 0);
+    raster->setValue(1, 0, maxValue, 0);
+
+    return raster;
+  }
+
+  /*!
+    \brief It compares the batched transformation with the pixel by pixel one.
+
+    The pixels are visited as a canvas row would: columns out of order, repeated,
+    outside the raster (negative) and crossing input lines.
+  */
+  void CheckBatch(te::map::RasterTransform& transform, const std::string& label)
+  {
+    std::vector<int> icols;
+    std::vector<int> ilins;
+
+    for(unsigned int r = 0; r < sg_nRows; ++r)
+    {
+      for(unsigned int c = 0; c < sg_nCols; ++c)
+      {
+        icols.push_back(static_cast<int>(c));
+        ilins.push_back(static_cast<int>(r));
+      }
+
+      icols.push_back(-1);
+      ilins.push_back(static_cast<int>(r));
+
+      for(unsigned int c = sg_nCols; c > 0; c -= 3)
+      {
+        icols.push_back(static_cast<int>(c - 1));
+        ilins.push_back(static_cast<int>(r));
+
+        if(c < 3)
+          break;
+      }
+    }
+
+// a rotated row: the line changes every other pixel
+    for(unsigned int c = 0; c < sg_nCols; ++c)
+    {
+      icols.push_back(static_cast<int>(c));
+      ilins.push_back(static_cast<int>((c / 2) % sg_nRows));
+    }
+
+    std::vector<te::color::RGBAColor> colors(icols.size());
+
+    transform.apply(&icols[0], &ilins[0], icols.size(), &colors[0]);
+
+    std::size_t nDifferences = 0;
+
+    for(std::size_t i = 0; i < icols.size(); ++i)
+    {
+      const te::color::RGBAColor expected = (icols[i] < 0) ? te::color::RGBAColor() : transform.apply(icols[i], ilins[i]);
+
+      if(!(colors[i] == expected))
+        ++nDifferences;
+    }
+
+    BOOST_CHECK_MESSAGE(nDifferences == 0, label << ": " << nDifferences << " pixels differ");
+  }
+
+  void SetRGBAMapping(te::map::RasterTransform& transform)
+  {
+    transform.setBChannelMapping(0, te::map::RasterTransform::RED_CHANNEL);
+    transform.setBChannelMapping(1, te::map::RasterTransform::GREEN_CHANNEL);
+    transform.setBChannelMapping(2, te::map::RasterTransform::BLUE_CHANNEL);
+    transform.setBChannelMapping(3, te::map::RasterTransform::ALPHA_CHANNEL);
+  }
+
+  std::vector<int> GetBandTypes()
+  {
+    std::vector<int> types;
+
+    types.push_back(te::dt::UCHAR_TYPE);
+    types.push_back(te::dt::CHAR_TYPE);
+    types.push_back(te::dt::UINT16_TYPE);
+    types.push_back(te::dt::INT16_TYPE);
+    types.push_back(te::dt::INT32_TYPE);
+    types.push_back(te::dt::FLOAT_TYPE);
+    types.push_back(te::dt::DOUBLE_TYPE);
+
+    return types;
+  }
+}
+
+BOOST_AUTO_TEST_SUITE( raster_transform_tests )
+
+BOOST_AUTO_TEST_CASE( linear_transformations_test )
+{
+  const te::map::RasterTransform::RasterTransfFunctions functions[] = {
+    te::map::RasterTransform::MONO2THREE_TRANSF,
+    te::map::RasterTransform::EXTRACT2RGB_TRANSF,
+    te::map::RasterTransform::EXTRACT2RGBA_TRANSF,
+    te::map::RasterTransform::RED2THREE_TRANSF,
+    te::map::RasterTransform::GREEN2THREE_TRANSF,
+    te::map::RasterTransform::BLUE2THREE_TRANSF
+  };
+
+  const std::vector<int> types = GetBandTypes();
+
+  for(std::size_t t = 0; t < types.size(); ++t)
+  {
+    std::auto_ptr<te::rst::Raster> raster = CreateRaster(types[t]);
+
+    double minValue, maxValue;
+    GetValueRange(types[t], minValue, maxValue);
+
+    for(std::size_t f = 0; f < sizeof(functions) / sizeof(functions[0]); ++f)
+    {
+      const std::string label = "type " + boost::lexical_cast<std::string>(types[t]) + ", function " + boost::lexical_cast<std::string>(functions[f]);
+
+      te::map::RasterTransform transform(raster.get(), 0);
+
+      transform.setTransfFunction(functions[f]);
+      SetRGBAMapping(transform);
+      transform.setSrcBand(1);
+      transform.setTransparency(200);
+      transform.setLinearTransfParameters(minValue, maxValue, 0, 255);
+      transform.setContrastR(0.9);
+      transform.setContrastG(1.1);
+      transform.setContrastB(1.3);
+      transform.setContrastM(0.7);
+
+      CheckBatch(transform, label);
+
+// the lookup tables must be rebuilt after a change of the parameters
+      transform.setGain(transform.getGain() * 2.0);
+      CheckBatch(transform, label + ", after setGain");
+
+      transform.setOffset(transform.getOffset() - 30.0);
+      CheckBatch(transform, label + ", after setOffset");
+
+      transform.setContrastM(1.2);
+      transform.setContrastR(1.2);
+      CheckBatch(transform, label + ", after setContrast");
+
+      transform.setBChannelMapping(2, te::map::RasterTransform::RED_CHANNEL);
+      transform.setSrcBand(2);
+      CheckBatch(transform, label + ", after a new band mapping");
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( classification_transformations_test )
+{
+  const std::vector<int> types = GetBandTypes();
+
+  for(std::size_t t = 0; t < types.size(); ++t)
+  {
+    std::auto_ptr<te::rst::Raster> raster = CreateRaster(types[t]);
+
+    double minValue, maxValue;
+    GetValueRange(types[t], minValue, maxValue);
+
+    const double step = (maxValue - minValue) / 4.0;
+
+    const std::string label = "type " + boost::lexical_cast<std::string>(types[t]);
+
+    te::map::RasterTransform transform(raster.get(), 0);
+
+    transform.setSrcBand(0);
+
+// categorize: the last quarter has no class
+    te::map::RasterTransform::CategorizedMap categorizedMap;
+    categorizedMap[te::map::RasterTransform::RasterThreshold(minValue, minValue + step)] = te::color::RGBAColor(255, 0, 0, 255);
+    categorizedMap[te::map::RasterTransform::RasterThreshold(minValue + step, minValue + 2 * step)] = te::color::RGBAColor(0, 255, 0, 255);
+    categorizedMap[te::map::RasterTransform::RasterThreshold(minValue + 2 * step, minValue + 3 * step)] = te::color::RGBAColor(0, 0, 255, 255);
+
+    transform.setTransfFunction(te::map::RasterTransform::CATEGORIZE_TRANSF);
+    transform.setCategorizedMap(categorizedMap);
+    CheckBatch(transform, label + ", categorize");
+
+// the map returned by getCategorizedMap may be changed by the caller
+    transform.getCategorizedMap().begin()->second = te::color::RGBAColor(10, 20, 30, 40);
+    CheckBatch(transform, label + ", categorize after getCategorizedMap");
+
+// interpolate: a color bar for each half of the range
+    te::map::RasterTransform::InterpolatedMap interpolatedMap;
+    interpolatedMap[te::map::RasterTransform::RasterThreshold(minValue, minValue + 2 * step)] =
+      te::color::ColorBar(te::color::RGBAColor(0, 0, 0, 255), te::color::RGBAColor(255, 255, 255, 255), 64);
+    interpolatedMap[te::map::RasterTransform::RasterThreshold(minValue + 2 * step, maxValue + 1)] =
+      te::color::ColorBar(te::color::RGBAColor(255, 0, 0, 255), te::color::RGBAColor(0, 0, 255, 255), 200);
+
+    transform.setTransfFunction(te::map::RasterTransform::INTERPOLATE_TRANSF);
+    transform.setInterpolatedMap(interpolatedMap);
+    CheckBatch(transform, label + ", interpolate");
+
+    transform.getInterpolatedMap().begin()->second = te::color::ColorBar(te::color::RGBAColor(0, 255, 0, 255), te::color::RGBAColor(0, 0, 0, 255), 16);
+    CheckBatch(transform, label + ", interpolate after getInterpolatedMap");
+
+// recode: only some values have a color
+    te::map::RasterTransform::RecodedMap recodedMap;
+    recodedMap[static_cast<int>(minValue)] = te::color::RGBAColor(1, 2, 3, 255);
+    recodedMap[static_cast<int>(maxValue)] = te::color::RGBAColor(4, 5, 6, 255);
+    recodedMap[0] = te::color::RGBAColor(7, 8, 9, 255);
+
+    transform.setTransfFunction(te::map::RasterTransform::RECODE_TRANSF);
+    transform.setRecodedMap(recodedMap);
+    CheckBatch(transform, label + ", recode");
+
+    transform.getRecodedMap()[0] = te::color::RGBAColor(90, 80, 70, 255);
+    CheckBatch(transform, label + ", recode after getRecodedMap");
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -158,3 +158,195 @@ void TsCachedRaster::ReadAheadTest()
         }
   }
 }
+
+void TsCachedRaster::WindowReadWriteTest()
+{
+  // create the input test raster
+  
+  const unsigned int nLines = 23;
+  const unsigned int nCols = 37;
+
+  boost::shared_ptr< te::rst::Raster > inputRasterPointer;
+  CreateTestRaster( 1, nLines, nCols, inputRasterPointer );
+  
+  const unsigned int winCol = 3;
+  const unsigned int winLine = 5;
+  const unsigned int winCols = 30;
+  const unsigned int winLines = 11;
+  
+  std::vector< double > values( winCols * winLines );
+  
+  unsigned int line = 0;
+  unsigned int col = 0;
+  double pixelValue = 0;
+  
+  // reading a window from the in-memory band
+  
+  inputRasterPointer->getBand( 0 )->getValues( winCol, winLine, winCols, 
+    winLines, &values[ 0 ] );
+    
+  for( line = 0 ; line < winLines ; ++line )
+    for( col = 0 ; col < winCols ; ++col )
+    {
+      inputRasterPointer->getValue( winCol + col, winLine + line, pixelValue, 0 );
+      CPPUNIT_ASSERT_DOUBLES_EQUAL( pixelValue, values[ col + line * winCols ], 
+        0.0000001 );
+    }
+    
+  // creating a tiled raster with 8x8 blocks
+  
+  te::rst::BandProperty* tiledBandProp = new te::rst::BandProperty( 0, 
+    te::dt::UINT32_TYPE );
+  tiledBandProp->m_blkw = 8;
+  tiledBandProp->m_blkh = 8;
+  tiledBandProp->m_nblocksx = ( nCols + 7 ) / 8;
+  tiledBandProp->m_nblocksy = ( nLines + 7 ) / 8;
+  
+  std::vector< te::rst::BandProperty * > tiledBandsProps;
+  tiledBandsProps.push_back( tiledBandProp );
+  
+  inputRasterPointer.reset( te::rst::RasterFactory::make( "MEM", 
+    new te::rst::Grid( nCols, nLines ), tiledBandsProps, 
+    std::map< std::string, std::string >(), 0, 0 ) );
+    
+  pixelValue = 0;
+  
+  for( line = 0 ; line < nLines ; ++line )
+    for( col = 0 ; col < nCols ; ++col )
+    {
+      inputRasterPointer->setValue( col, line, pixelValue, 0 );
+      ++pixelValue;
+    }
+  
+  // reading and writing a window spanning several blocks of the cached raster
+  
+  {
+    te::mem::CachedRaster cachedRaster( 2, *inputRasterPointer, 0 );
+    
+    std::fill( values.begin(), values.end(), 0.0 );
+    
+    cachedRaster.getBand( 0 )->getValues( winCol, winLine, winCols, 
+      winLines, &values[ 0 ] );
+      
+    for( line = 0 ; line < winLines ; ++line )
+      for( col = 0 ; col < winCols ; ++col )
+      {
+        cachedRaster.getValue( winCol + col, winLine + line, pixelValue, 0 );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( pixelValue, values[ col + line * winCols ], 
+          0.0000001 );
+        values[ col + line * winCols ] += 10.0;
+      }
+      
+    cachedRaster.getBand( 0 )->setValues( winCol, winLine, winCols, 
+      winLines, &values[ 0 ] );
+  }
+  
+  // Verifying the values: only the window was changed
+  
+  pixelValue = 0;
+  double readPixelValue = 0;
+  
+  for( line = 0 ; line < nLines ; ++line )
+    for( col = 0 ; col < nCols ; ++col )
+    {
+      inputRasterPointer->getValue( col, line, readPixelValue, 0 );
+      
+      if( ( line >= winLine ) && ( line < winLine + winLines ) &&
+        ( col >= winCol ) && ( col < winCol + winCols ) )
+      {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( pixelValue + 10.0, readPixelValue, 0.0000001 );
+      }
+      else
+      {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( pixelValue, readPixelValue, 0.0000001 );
+      }
+      
+      ++pixelValue;
+    }
+}
+
+void TsCachedRaster::IOSchedulerTest()
+{
+  // creating a tiled raster with 8x8 blocks of 8x8 pixels
+  
+  const unsigned int nLines = 64;
+  const unsigned int nCols = 64;
+  
+  te::rst::BandProperty* tiledBandProp = new te::rst::BandProperty( 0, 
+    te::dt::UINT32_TYPE );
+  tiledBandProp->m_blkw = 8;
+  tiledBandProp->m_blkh = 8;
+  tiledBandProp->m_nblocksx = 8;
+  tiledBandProp->m_nblocksy = 8;
+  
+  std::vector< te::rst::BandProperty * > tiledBandsProps;
+  tiledBandsProps.push_back( tiledBandProp );
+  
+  boost::shared_ptr< te::rst::Raster > inputRasterPointer( 
+    te::rst::RasterFactory::make( "MEM", new te::rst::Grid( nCols, nLines ), 
+    tiledBandsProps, std::map< std::string, std::string >(), 0, 0 ) );
+    
+  unsigned int line = 0;
+  unsigned int col = 0;
+  double pixelValue = 0;
+  
+  for( line = 0 ; line < nLines ; ++line )
+    for( col = 0 ; col < nCols ; ++col )
+    {
+      inputRasterPointer->setValue( col, line, pixelValue, 0 );
+      ++pixelValue;
+    }
+    
+  // synchronous reading: each block is read once and nothing is written back
+  
+  {
+    te::mem::CachedRaster cachedRaster( 20, *inputRasterPointer, 0 );
+    
+    for( line = 0 ; line < nLines ; ++line )
+      for( col = 0 ; col < nCols ; ++col )
+        cachedRaster.getValue( col, line, pixelValue, 0 );
+        
+    const te::mem::CachedBandBlocksManager& manager = cachedRaster.getBlocksManager();
+    
+    CPPUNIT_ASSERT( manager.getIOThreadsNumber() == 0 );
+    CPPUNIT_ASSERT( manager.getMissesCount() == 64 );
+    CPPUNIT_ASSERT( manager.getHitsCount() == ( nLines * nCols ) - 64 );
+    CPPUNIT_ASSERT( manager.getEvictionsCount() == 64 - 20 );
+    CPPUNIT_ASSERT( manager.getWriteBacksCount() == 0 );
+    CPPUNIT_ASSERT( manager.getPrefetchesCount() == 0 );
+  }
+  
+  // read-ahead and write-back by two I/O threads
+  
+  {
+    te::mem::CachedRaster cachedRaster( 20, *inputRasterPointer, 1, 2 );
+    
+    for( line = 0 ; line < nLines ; ++line )
+      for( col = 0 ; col < nCols ; ++col )
+      {
+        cachedRaster.getValue( col, line, pixelValue, 0 );
+        cachedRaster.setValue( col, line, pixelValue + 10.0, 0 );
+      }
+        
+    const te::mem::CachedBandBlocksManager& manager = cachedRaster.getBlocksManager();
+    
+    CPPUNIT_ASSERT( manager.getIOThreadsNumber() == 2 );
+    CPPUNIT_ASSERT( manager.getPrefetchesCount() > 0 );
+    CPPUNIT_ASSERT( manager.getPrefetchHitsCount() > 0 );
+    CPPUNIT_ASSERT( manager.getMissesCount() + manager.getPrefetchHitsCount() <= 64 );
+    CPPUNIT_ASSERT( manager.getWriteBacksCount() > 0 );
+  }
+  
+  // Verifying the values
+  
+  pixelValue = 0;
+  double readPixelValue = 0;
+  
+  for( line = 0 ; line < nLines ; ++line )
+    for( col = 0 ; col < nCols ; ++col )
+    {
+      inputRasterPointer->getValue( col, line, readPixelValue, 0 );
+      CPPUNIT_ASSERT_DOUBLES_EQUAL( pixelValue + 10.0, readPixelValue, 0.0000001 );
+      ++pixelValue;
+    }
+}
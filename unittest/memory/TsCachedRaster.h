@@ -51,6 +51,10 @@ class TsCachedRaster : public CPPUNIT_NS::TestFixture
   CPPUNIT_TEST( ReadWriteTest );
   
   CPPUNIT_TEST( ReadAheadTest );
+  
+  CPPUNIT_TEST( WindowReadWriteTest );
+  
+  CPPUNIT_TEST( IOSchedulerTest );
 
   CPPUNIT_TEST_SUITE_END();
 
@@ -62,6 +66,10 @@ class TsCachedRaster : public CPPUNIT_NS::TestFixture
     void ReadWriteTest();
     
     void ReadAheadTest();
+    
+    void WindowReadWriteTest();
+    
+    void IOSchedulerTest();
 };
 
 #endif  // __TERRALIB_UNITTEST_MEMORY_CACHEDRASTER_INTERNAL_H
@@ -0,0 +1,252 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+  \file TsColumnarDataSet.cpp
+ 
+  \brief A test suit for the Columnar DataSet class interface.
+ */
+
+#include "TsColumnarDataSet.h"
+#include "../Config.h"
+
+#include <terralib/common/StringUtils.h>
+#include <terralib/dataaccess.h>
+#include <terralib/datatype.h>
+#include <terralib/geometry.h>
+
+// STL
+#include <memory>
+#include <vector>
+
+CPPUNIT_TEST_SUITE_REGISTRATION( TsColumnarDataSet );
+
+namespace
+{
+  te::da::DataSetType* CreateDataSetType()
+  {
+    te::da::DataSetType* dt = new te::da::DataSetType("columnar");
+
+    dt->add(new te::dt::SimpleProperty("id", te::dt::INT32_TYPE));
+    dt->add(new te::dt::SimpleProperty("value", te::dt::DOUBLE_TYPE));
+    dt->add(new te::dt::SimpleProperty("flag", te::dt::BOOLEAN_TYPE));
+    dt->add(new te::dt::StringProperty("name", te::dt::STRING));
+    dt->add(new te::gm::GeometryProperty("geom", 4326, te::gm::PointType));
+
+    return dt;
+  }
+
+  void Fill(te::da::DataSet& ds, std::size_t nitems)
+  {
+    for(std::size_t i = 0; i != nitems; ++i)
+    {
+      if(te::mem::ColumnarDataSet* cds = dynamic_cast<te::mem::ColumnarDataSet*>(&ds))
+      {
+        cds->add();
+        cds->setInt32(0, static_cast<boost::int32_t>(i));
+        cds->setDouble(1, static_cast<double>(i) * 0.5);
+        cds->setBool(2, (i % 2) == 0);
+        cds->setString(3, "item " + te::common::Convert2String(static_cast<unsigned int>(i)));
+        cds->setGeometry(4, new te::gm::Point(static_cast<double>(i), static_cast<double>(i) * 2.0, 4326));
+      }
+      else
+      {
+        te::mem::DataSet* mds = static_cast<te::mem::DataSet*>(&ds);
+
+        te::mem::DataSetItem* item = new te::mem::DataSetItem(mds);
+        item->setInt32(0, static_cast<boost::int32_t>(i));
+        item->setDouble(1, static_cast<double>(i) * 0.5);
+        item->setBool(2, (i % 2) == 0);
+        item->setString(3, "item " + te::common::Convert2String(static_cast<unsigned int>(i)));
+        item->setGeometry(4, new te::gm::Point(static_cast<double>(i), static_cast<double>(i) * 2.0, 4326));
+
+        mds->add(item);
+      }
+    }
+  }
+}
+
+void TsColumnarDataSet::readWriteTest()
+{
+  std::auto_ptr<te::da::DataSetType> dt(CreateDataSetType());
+
+  te::mem::ColumnarDataSet ds(dt.get());
+
+  CPPUNIT_ASSERT( ds.isEmpty() );
+  CPPUNIT_ASSERT( ds.getNumProperties() == 5 );
+  CPPUNIT_ASSERT( ds.getPropertyDataType(4) == te::dt::GEOMETRY_TYPE );
+  CPPUNIT_ASSERT( ds.getPropertyName(3) == "name" );
+
+  Fill(ds, 100);
+
+  CPPUNIT_ASSERT( ds.size() == 100 );
+
+  std::size_t i = 0;
+
+  ds.moveBeforeFirst();
+
+  while(ds.moveNext())
+  {
+    CPPUNIT_ASSERT( ds.getInt32(0) == static_cast<boost::int32_t>(i) );
+    CPPUNIT_ASSERT( ds.getDouble(1) == static_cast<double>(i) * 0.5 );
+    CPPUNIT_ASSERT( ds.getBool(2) == ((i % 2) == 0) );
+    CPPUNIT_ASSERT( ds.getString(3) == "item " + te::common::Convert2String(static_cast<unsigned int>(i)) );
+
+    std::auto_ptr<te::gm::Geometry> g(ds.getGeometry(4));
+    CPPUNIT_ASSERT( g->getSRID() == 4326 );
+    CPPUNIT_ASSERT( static_cast<te::gm::Point*>(g.get())->getY() == static_cast<double>(i) * 2.0 );
+
+// numeric values are converted to the requested type
+    CPPUNIT_ASSERT( ds.getInt64(0) == static_cast<boost::int64_t>(i) );
+    CPPUNIT_ASSERT( ds.getFloat(1) == static_cast<float>(i) * 0.5f );
+
+    std::auto_ptr<te::dt::AbstractData> v(ds.getValue(0));
+    CPPUNIT_ASSERT( v->getTypeCode() == te::dt::INT32_TYPE );
+
+    ++i;
+  }
+
+  CPPUNIT_ASSERT( i == 100 );
+
+// replacing a string keeps the other values
+  ds.move(10);
+  ds.setString(3, "a longer name for item ten");
+  ds.setValue(1, new te::dt::Int32(7));
+
+  ds.move(11);
+  CPPUNIT_ASSERT( ds.getString(3) == "item 11" );
+
+  ds.move(10);
+  CPPUNIT_ASSERT( ds.getString(3) == "a longer name for item ten" );
+  CPPUNIT_ASSERT( ds.getDouble(1) == 7.0 );
+
+  ds.clear();
+  CPPUNIT_ASSERT( ds.isEmpty() );
+}
+
+void TsColumnarDataSet::nullValuesTest()
+{
+  std::auto_ptr<te::da::DataSetType> dt(CreateDataSetType());
+
+  te::mem::ColumnarDataSet ds(dt.get());
+
+  ds.add();
+
+  for(std::size_t i = 0; i != ds.getNumProperties(); ++i)
+    CPPUNIT_ASSERT( ds.isNull(i) );
+
+  CPPUNIT_ASSERT( ds.getGeometry(4).get() == 0 );
+
+  ds.setDouble(1, 3.0);
+  ds.setString(3, "");
+
+  CPPUNIT_ASSERT( !ds.isNull(1) );
+  CPPUNIT_ASSERT( !ds.isNull(3) );
+  CPPUNIT_ASSERT( ds.getString(3).empty() );
+
+  ds.setNull(1);
+  ds.setValue(3, 0);
+
+  CPPUNIT_ASSERT( ds.isNull(1) );
+  CPPUNIT_ASSERT( ds.isNull(3) );
+}
+
+void TsColumnarDataSet::copyTest()
+{
+  std::auto_ptr<te::da::DataSetType> dt(CreateDataSetType());
+
+  te::mem::DataSet mds(dt.get());
+
+  Fill(mds, 50);
+
+  mds.moveBeforeFirst();
+
+  te::mem::ColumnarDataSet cds(mds);
+
+  CPPUNIT_ASSERT( cds.size() == 50 );
+
+  mds.moveBeforeFirst();
+  cds.moveBeforeFirst();
+
+  while(mds.moveNext())
+  {
+    CPPUNIT_ASSERT( cds.moveNext() );
+
+    for(std::size_t i = 0; i != mds.getNumProperties(); ++i)
+      CPPUNIT_ASSERT( mds.getAsString(i) == cds.getAsString(i) );
+  }
+
+  CPPUNIT_ASSERT( !cds.moveNext() );
+}
+
+void TsColumnarDataSet::sharedColumnsTest()
+{
+  std::auto_ptr<te::da::DataSetType> dt(CreateDataSetType());
+
+  te::mem::ColumnarDataSet ds(dt.get());
+
+  Fill(ds, 10);
+
+// a new cursor over the same columns
+  te::mem::ColumnarDataSet shared(ds);
+
+  CPPUNIT_ASSERT( shared.size() == 10 );
+  CPPUNIT_ASSERT( shared.isBeforeBegin() );
+
+// a projection of two properties
+  std::vector<std::size_t> properties;
+  properties.push_back(3);
+  properties.push_back(0);
+
+  te::mem::ColumnarDataSet projection(ds, properties);
+
+  CPPUNIT_ASSERT( projection.getNumProperties() == 2 );
+  CPPUNIT_ASSERT( projection.getPropertyName(0) == "name" );
+  CPPUNIT_ASSERT( projection.getPropertyDataType(1) == te::dt::INT32_TYPE );
+
+  projection.move(4);
+  CPPUNIT_ASSERT( projection.getInt32(1) == 4 );
+  CPPUNIT_ASSERT( projection.getString(0) == "item 4" );
+
+// changes are seen by all datasets
+  ds.move(4);
+  ds.setInt32(0, 40);
+
+  CPPUNIT_ASSERT( projection.getInt32(1) == 40 );
+
+  Fill(ds, 1);
+
+  CPPUNIT_ASSERT( shared.size() == 11 );
+  CPPUNIT_ASSERT( projection.size() == 11 );
+}
+
+void TsColumnarDataSet::extentTest()
+{
+  std::auto_ptr<te::da::DataSetType> dt(CreateDataSetType());
+
+  te::mem::ColumnarDataSet ds(dt.get());
+
+  Fill(ds, 20);
+
+  ds.add();
+
+  std::auto_ptr<te::gm::Envelope> mbr(ds.getExtent(4));
+
+  CPPUNIT_ASSERT( *mbr == te::gm::Envelope(0.0, 0.0, 19.0, 38.0) );
+}
@@ -0,0 +1,77 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+  \file TsColumnarDataSet.h
+ 
+  \brief A test suit for the Columnar DataSet class.
+ */
+
+#ifndef __TERRALIB_UNITTEST_MEMORY_COLUMNARDATASET_INTERNAL_H
+#define __TERRALIB_UNITTEST_MEMORY_COLUMNARDATASET_INTERNAL_H
+
+#include <terralib/memory.h>
+
+// cppUnit
+#include <cppunit/extensions/HelperMacros.h>
+
+/*!
+  \class TsColumnarDataSet
+
+  \brief A test suit for the Columnar DataSet class interface.
+
+  This test suite will check:
+  <ul>
+  <li>reading and writing values of each column storage;</li>
+  <li>null values;</li>
+  <li>copying from another dataset;</li>
+  <li>sharing the columns between datasets;</li>
+  <li>the geometry extent.</li>
+  </ul>
+ */
+class TsColumnarDataSet : public CPPUNIT_NS::TestFixture 
+{
+  CPPUNIT_TEST_SUITE( TsColumnarDataSet );
+  
+  CPPUNIT_TEST( readWriteTest );
+  
+  CPPUNIT_TEST( nullValuesTest );
+  
+  CPPUNIT_TEST( copyTest );
+  
+  CPPUNIT_TEST( sharedColumnsTest );
+  
+  CPPUNIT_TEST( extentTest );
+  
+  CPPUNIT_TEST_SUITE_END();
+
+  protected :
+
+    void readWriteTest();
+
+    void nullValuesTest();
+
+    void copyTest();
+
+    void sharedColumnsTest();
+
+    void extentTest();
+};
+
+#endif  // __TERRALIB_UNITTEST_MEMORY_COLUMNARDATASET_INTERNAL_H
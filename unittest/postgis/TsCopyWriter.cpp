@@ -0,0 +1,405 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+  \file terralib/unittest/postgis/TsCopyWriter.cpp
+
+  \brief A test suite for the PostGIS binary COPY writer.
+
+  The encoder tests don't need a server. The round trip tests run against
+  the database informed by the TE_PGIS_UNITTEST_URI environment variable
+  and are skipped when it is not set.
+ */
+
+// libpq
+#include <libpq-fe.h>
+
+// TerraLib
+#include <terralib/dataaccess/dataset/DataSetType.h>
+#include <terralib/dataaccess/datasource/DataSource.h>
+#include <terralib/dataaccess/datasource/DataSourceFactory.h>
+#include <terralib/dataaccess/datasource/DataSourceTransactor.h>
+#include <terralib/datatype/ByteArray.h>
+#include <terralib/datatype/SimpleProperty.h>
+#include <terralib/datatype/StringProperty.h>
+#include <terralib/geometry/GeometryProperty.h>
+#include <terralib/geometry/Point.h>
+#include <terralib/memory/DataSet.h>
+#include <terralib/memory/DataSetItem.h>
+#include <terralib/postgis/CopyWriter.h>
+#include <terralib/postgis/EWKBReader.h>
+#include "Config.h"
+
+// STL
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Boost
+#include <boost/cstdint.hpp>
+#include <boost/test/unit_test.hpp>
+
+namespace
+{
+// any value works as the geometry type OID while no server is involved
+  const unsigned int sg_geomTypeOid = 99999;
+
+  /*! \brief A reader of the big-endian fields of a binary COPY tuple. */
+  class TupleReader
+  {
+    public:
+
+      TupleReader(const std::vector<char>& buffer)
+        : m_buffer(buffer),
+          m_pos(0)
+      {
+      }
+
+      boost::uint64_t readBE(std::size_t nbytes)
+      {
+        boost::uint64_t value = 0;
+
+        for(std::size_t i = 0; i != nbytes; ++i)
+          value = (value << 8) | static_cast<unsigned char>(m_buffer.at(m_pos++));
+
+        return value;
+      }
+
+      boost::int16_t readInt16() { return static_cast<boost::int16_t>(readBE(2)); }
+
+      boost::int32_t readInt32() { return static_cast<boost::int32_t>(readBE(4)); }
+
+      boost::int64_t readInt64() { return static_cast<boost::int64_t>(readBE(8)); }
+
+      float readFloat()
+      {
+        boost::uint32_t ivalue = static_cast<boost::uint32_t>(readBE(4));
+        float value;
+        memcpy(&value, &ivalue, sizeof(float));
+        return value;
+      }
+
+      double readDouble()
+      {
+        boost::uint64_t ivalue = readBE(8);
+        double value;
+        memcpy(&value, &ivalue, sizeof(double));
+        return value;
+      }
+
+      std::string readBytes(std::size_t nbytes)
+      {
+        std::string value(&m_buffer.at(m_pos), nbytes);
+        m_pos += nbytes;
+        return value;
+      }
+
+      const char* current() const { return &m_buffer[m_pos]; }
+
+      bool atEnd() const { return m_pos == m_buffer.size(); }
+
+    private:
+
+      const std::vector<char>& m_buffer;
+      std::size_t m_pos;
+  };
+
+  std::auto_ptr<te::da::DataSetType> CreateDataSetType(const std::string& name)
+  {
+    std::auto_ptr<te::da::DataSetType> dt(new te::da::DataSetType(name));
+
+    dt->add(new te::dt::SimpleProperty("id", te::dt::INT32_TYPE));
+    dt->add(new te::dt::SimpleProperty("small", te::dt::INT16_TYPE));
+    dt->add(new te::dt::SimpleProperty("big", te::dt::INT64_TYPE));
+    dt->add(new te::dt::SimpleProperty("ratio", te::dt::FLOAT_TYPE));
+    dt->add(new te::dt::SimpleProperty("value", te::dt::DOUBLE_TYPE));
+    dt->add(new te::dt::StringProperty("name", te::dt::VAR_STRING));
+    dt->add(new te::dt::SimpleProperty("flag", te::dt::BOOLEAN_TYPE));
+    dt->add(new te::dt::SimpleProperty("data", te::dt::BYTE_ARRAY_TYPE));
+    dt->add(new te::gm::GeometryProperty("geom", 4326, te::gm::PointType));
+
+    return dt;
+  }
+
+  /*! \brief It creates a dataset with a complete row and a row where every value is null. */
+  std::auto_ptr<te::mem::DataSet> CreateDataSet(const te::da::DataSetType* dt)
+  {
+    std::auto_ptr<te::mem::DataSet> d(new te::mem::DataSet(dt));
+
+    te::mem::DataSetItem* item = new te::mem::DataSetItem(d.get());
+
+    char* bytes = new char[3];
+    bytes[0] = 0;
+    bytes[1] = '\xff';
+    bytes[2] = 'x';
+
+    item->setInt32(0, -123456);
+    item->setInt16(1, -2);
+    item->setInt64(2, 1234567890123LL);
+    item->setFloat(3, 0.5f);
+    item->setDouble(4, -3.25);
+    item->setString(5, "S\xc3\xa3o Jos\xc3\xa9");
+    item->setBool(6, true);
+    item->setByteArray(7, new te::dt::ByteArray(bytes, 3));
+    item->setGeometry(8, new te::gm::Point(-45.5, -23.25, 4326));
+
+    d->add(item);
+
+    d->add(new te::mem::DataSetItem(d.get()));
+
+    d->moveBeforeFirst();
+
+    return d;
+  }
+
+  std::vector<unsigned int> GetColumnTypes()
+  {
+    std::vector<unsigned int> columnTypes;
+
+    columnTypes.push_back(PG_INT4_TYPE);
+    columnTypes.push_back(PG_INT2_TYPE);
+    columnTypes.push_back(PG_INT8_TYPE);
+    columnTypes.push_back(PG_FLOAT4_TYPE);
+    columnTypes.push_back(PG_FLOAT8_TYPE);
+    columnTypes.push_back(PG_VARCHAR_TYPE);
+    columnTypes.push_back(PG_BOOL_TYPE);
+    columnTypes.push_back(PG_BYTEA_TYPE);
+    columnTypes.push_back(sg_geomTypeOid);
+
+    return columnTypes;
+  }
+}
+
+BOOST_AUTO_TEST_SUITE( copy_writer_tests )
+
+BOOST_AUTO_TEST_CASE( encode_test )
+{
+  std::auto_ptr<te::da::DataSetType> dt = CreateDataSetType("te_copy_test");
+  std::auto_ptr<te::mem::DataSet> d = CreateDataSet(dt.get());
+
+  std::vector<unsigned int> columnTypes = GetColumnTypes();
+
+  BOOST_REQUIRE(te::pgis::CopyWriter::isSupported(d.get(), columnTypes, sg_geomTypeOid));
+
+  std::vector<char> buffer;
+
+  BOOST_REQUIRE(d->moveNext());
+  te::pgis::CopyWriter::encode(d.get(), columnTypes, sg_geomTypeOid, buffer);
+
+  TupleReader reader(buffer);
+
+  BOOST_CHECK_EQUAL(reader.readInt16(), 9);
+
+  BOOST_CHECK_EQUAL(reader.readInt32(), 4);
+  BOOST_CHECK_EQUAL(reader.readInt32(), -123456);
+
+  BOOST_CHECK_EQUAL(reader.readInt32(), 2);
+  BOOST_CHECK_EQUAL(reader.readInt16(), -2);
+
+  BOOST_CHECK_EQUAL(reader.readInt32(), 8);
+  BOOST_CHECK_EQUAL(reader.readInt64(), 1234567890123LL);
+
+  BOOST_CHECK_EQUAL(reader.readInt32(), 4);
+  BOOST_CHECK_EQUAL(reader.readFloat(), 0.5f);
+
+  BOOST_CHECK_EQUAL(reader.readInt32(), 8);
+  BOOST_CHECK_EQUAL(reader.readDouble(), -3.25);
+
+  BOOST_CHECK_EQUAL(reader.readInt32(), 10);
+  BOOST_CHECK_EQUAL(reader.readBytes(10), "S\xc3\xa3o Jos\xc3\xa9");
+
+  BOOST_CHECK_EQUAL(reader.readInt32(), 1);
+  BOOST_CHECK_EQUAL(reader.readBytes(1), std::string(1, '\1'));
+
+  BOOST_CHECK_EQUAL(reader.readInt32(), 3);
+  BOOST_CHECK_EQUAL(reader.readBytes(3), std::string("\0\xffx", 3));
+
+// EWKB point: byte order, type, SRID and two coordinates
+  BOOST_REQUIRE_EQUAL(reader.readInt32(), 25);
+
+  std::auto_ptr<te::gm::Geometry> geom(te::pgis::EWKBReader::read(reader.current()));
+  reader.readBytes(25);
+
+  te::gm::Point* pt = dynamic_cast<te::gm::Point*>(geom.get());
+
+  BOOST_REQUIRE(pt != 0);
+  BOOST_CHECK_EQUAL(pt->getSRID(), 4326);
+  BOOST_CHECK_EQUAL(pt->getX(), -45.5);
+  BOOST_CHECK_EQUAL(pt->getY(), -23.25);
+
+  BOOST_CHECK(reader.atEnd());
+}
+
+BOOST_AUTO_TEST_CASE( encode_null_test )
+{
+  std::auto_ptr<te::da::DataSetType> dt = CreateDataSetType("te_copy_test");
+  std::auto_ptr<te::mem::DataSet> d = CreateDataSet(dt.get());
+
+  std::vector<unsigned int> columnTypes = GetColumnTypes();
+
+  std::vector<char> buffer;
+
+  BOOST_REQUIRE(d->moveNext());
+  BOOST_REQUIRE(d->moveNext());
+  te::pgis::CopyWriter::encode(d.get(), columnTypes, sg_geomTypeOid, buffer);
+
+  TupleReader reader(buffer);
+
+  BOOST_CHECK_EQUAL(reader.readInt16(), 9);
+
+  for(std::size_t i = 0; i != columnTypes.size(); ++i)
+    BOOST_CHECK_EQUAL(reader.readInt32(), -1);
+
+  BOOST_CHECK(reader.atEnd());
+}
+
+BOOST_AUTO_TEST_CASE( encode_widening_test )
+{
+  std::auto_ptr<te::da::DataSetType> dt = CreateDataSetType("te_copy_test");
+  std::auto_ptr<te::mem::DataSet> d = CreateDataSet(dt.get());
+
+// the integer and float properties are written to wider columns
+  std::vector<unsigned int> columnTypes = GetColumnTypes();
+  columnTypes[0] = PG_INT8_TYPE;
+  columnTypes[1] = PG_FLOAT8_TYPE;
+  columnTypes[3] = PG_FLOAT8_TYPE;
+  columnTypes[5] = PG_TEXT_TYPE;
+
+  BOOST_REQUIRE(te::pgis::CopyWriter::isSupported(d.get(), columnTypes, sg_geomTypeOid));
+
+  std::vector<char> buffer;
+
+  BOOST_REQUIRE(d->moveNext());
+  te::pgis::CopyWriter::encode(d.get(), columnTypes, sg_geomTypeOid, buffer);
+
+  TupleReader reader(buffer);
+
+  BOOST_CHECK_EQUAL(reader.readInt16(), 9);
+
+  BOOST_CHECK_EQUAL(reader.readInt32(), 8);
+  BOOST_CHECK_EQUAL(reader.readInt64(), -123456);
+
+  BOOST_CHECK_EQUAL(reader.readInt32(), 8);
+  BOOST_CHECK_EQUAL(reader.readDouble(), -2.0);
+
+  BOOST_CHECK_EQUAL(reader.readInt32(), 8);
+  BOOST_CHECK_EQUAL(reader.readInt64(), 1234567890123LL);
+
+  BOOST_CHECK_EQUAL(reader.readInt32(), 8);
+  BOOST_CHECK_EQUAL(reader.readDouble(), 0.5);
+}
+
+BOOST_AUTO_TEST_CASE( text_fallback_test )
+{
+  std::auto_ptr<te::da::DataSetType> dt = CreateDataSetType("te_copy_test");
+  std::auto_ptr<te::mem::DataSet> d = CreateDataSet(dt.get());
+
+  std::vector<unsigned int> columnTypes = GetColumnTypes();
+
+// these datasets must go through the INSERT path
+  std::vector<unsigned int> wrongCount(columnTypes.begin(), columnTypes.end() - 1);
+  BOOST_CHECK(!te::pgis::CopyWriter::isSupported(d.get(), wrongCount, sg_geomTypeOid));
+
+  std::vector<unsigned int> numeric(columnTypes);
+  numeric[4] = PG_NUMERIC_TYPE;
+  BOOST_CHECK(!te::pgis::CopyWriter::isSupported(d.get(), numeric, sg_geomTypeOid));
+
+  std::vector<unsigned int> narrowing(columnTypes);
+  narrowing[4] = PG_INT4_TYPE;
+  BOOST_CHECK(!te::pgis::CopyWriter::isSupported(d.get(), narrowing, sg_geomTypeOid));
+
+  std::vector<unsigned int> stringToInt(columnTypes);
+  stringToInt[5] = PG_INT4_TYPE;
+  BOOST_CHECK(!te::pgis::CopyWriter::isSupported(d.get(), stringToInt, sg_geomTypeOid));
+
+  std::vector<unsigned int> timestamp(columnTypes);
+  timestamp[5] = PG_TIMESTAMP_TYPE;
+  BOOST_CHECK(!te::pgis::CopyWriter::isSupported(d.get(), timestamp, sg_geomTypeOid));
+
+  BOOST_CHECK(!te::pgis::CopyWriter::isSupported(d.get(), columnTypes, sg_geomTypeOid + 1));
+}
+
+BOOST_AUTO_TEST_CASE( round_trip_test )
+{
+  const char* uri = std::getenv(TE_UNITTEST_PGIS_URI_ENV);
+
+  if(uri == 0 || *uri == '\0')
+  {
+    BOOST_TEST_MESSAGE("Skipping: " TE_UNITTEST_PGIS_URI_ENV " is not set.");
+    return;
+  }
+
+  std::unique_ptr<te::da::DataSource> ds = te::da::DataSourceFactory::make("POSTGIS", uri);
+
+  ds->open();
+
+  std::auto_ptr<te::da::DataSourceTransactor> t = ds->getTransactor();
+
+// the value column is NUMERIC in the second table, so its rows take the INSERT path
+  const char* const valueTypes[] = { "DOUBLE PRECISION", "NUMERIC" };
+
+  for(std::size_t k = 0; k != 2; ++k)
+  {
+    t->execute("DROP TABLE IF EXISTS pg_temp.te_copy_test");
+    t->execute(std::string("CREATE TEMP TABLE te_copy_test (id INTEGER, small SMALLINT, big BIGINT, ratio REAL, value ") +
+               valueTypes[k] + ", name VARCHAR, flag BOOLEAN, data BYTEA, geom GEOMETRY)");
+
+    std::auto_ptr<te::da::DataSetType> dt = CreateDataSetType("te_copy_test");
+    std::auto_ptr<te::mem::DataSet> d = CreateDataSet(dt.get());
+
+    std::map<std::string, std::string> options;
+    options["BULK_INSERT"] = "TRUE";
+
+    t->add("te_copy_test", d.get(), options);
+
+    std::auto_ptr<te::da::DataSet> result = t->query("SELECT id, small, big, ratio, value::DOUBLE PRECISION, name, flag, data, geom FROM te_copy_test ORDER BY id NULLS LAST",
+                                                     te::common::RANDOM);
+
+    BOOST_REQUIRE_EQUAL(result->size(), 2u);
+
+    BOOST_REQUIRE(result->moveNext());
+    BOOST_CHECK_EQUAL(result->getInt32(0), -123456);
+    BOOST_CHECK_EQUAL(result->getInt16(1), -2);
+    BOOST_CHECK_EQUAL(result->getInt64(2), 1234567890123LL);
+    BOOST_CHECK_EQUAL(result->getFloat(3), 0.5f);
+    BOOST_CHECK_EQUAL(result->getDouble(4), -3.25);
+    BOOST_CHECK_EQUAL(result->getString(5), "S\xc3\xa3o Jos\xc3\xa9");
+    BOOST_CHECK(result->getBool(6));
+
+    std::auto_ptr<te::dt::ByteArray> ba(result->getByteArray(7));
+    BOOST_CHECK_EQUAL(std::string(ba->getData(), ba->bytesUsed()), std::string("\0\xffx", 3));
+
+    std::auto_ptr<te::gm::Geometry> geom(result->getGeometry(8));
+    te::gm::Point* pt = dynamic_cast<te::gm::Point*>(geom.get());
+    BOOST_REQUIRE(pt != 0);
+    BOOST_CHECK_EQUAL(pt->getSRID(), 4326);
+    BOOST_CHECK_EQUAL(pt->getX(), -45.5);
+    BOOST_CHECK_EQUAL(pt->getY(), -23.25);
+
+    BOOST_REQUIRE(result->moveNext());
+
+    for(std::size_t i = 0; i != result->getNumProperties(); ++i)
+      BOOST_CHECK(result->isNull(i));
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
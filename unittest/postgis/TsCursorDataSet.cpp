@@ -0,0 +1,198 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+  \file terralib/unittest/postgis/TsCursorDataSet.cpp
+
+  \brief A test suite for the PostGIS cursor dataset.
+
+  The tests run against the database informed by the TE_PGIS_UNITTEST_URI
+  environment variable and are skipped when it is not set.
+ */
+
+// libpq
+#include <libpq-fe.h>
+
+// TerraLib
+#include <terralib/dataaccess/dataset/DataSet.h>
+#include <terralib/dataaccess/datasource/DataSourceFactory.h>
+#include <terralib/dataaccess/datasource/DataSourceTransactor.h>
+#include <terralib/geometry/Envelope.h>
+#include <terralib/postgis/CursorDataSet.h>
+#include <terralib/postgis/DataSource.h>
+#include "Config.h"
+
+// STL
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+// Boost
+#include <boost/test/unit_test.hpp>
+
+namespace
+{
+  const char* const sg_query = "SELECT g AS id, ST_MakePoint(g, g) AS geom FROM generate_series(1, 25000) AS g";
+
+  const int sg_nrows = 25000;
+
+  std::unique_ptr<te::da::DataSource> OpenTestDataSource()
+  {
+    const char* uri = std::getenv(TE_UNITTEST_PGIS_URI_ENV);
+
+    if(uri == 0 || *uri == '\0')
+      return std::unique_ptr<te::da::DataSource>();
+
+    std::unique_ptr<te::da::DataSource> ds = te::da::DataSourceFactory::make("POSTGIS", uri);
+
+    ds->open();
+
+    return ds;
+  }
+
+  int ConsumeIds(te::da::DataSet* dataset)
+  {
+    int expected = 1;
+
+    while(dataset->moveNext())
+    {
+      if(dataset->getInt32(0) != expected)
+        break;
+
+      ++expected;
+    }
+
+    return expected - 1;
+  }
+}
+
+BOOST_AUTO_TEST_SUITE( cursor_dataset_tests )
+
+BOOST_AUTO_TEST_CASE( default_fetch_size_test )
+{
+  std::unique_ptr<te::da::DataSource> ds = OpenTestDataSource();
+
+  if(ds.get() == 0)
+  {
+    BOOST_TEST_MESSAGE("Skipping: " TE_UNITTEST_PGIS_URI_ENV " is not set.");
+    return;
+  }
+
+  std::auto_ptr<te::da::DataSourceTransactor> t = ds->getTransactor();
+
+  std::auto_ptr<te::da::DataSet> streamed = t->query(sg_query, te::common::FORWARDONLY);
+
+  BOOST_CHECK(dynamic_cast<te::pgis::CursorDataSet*>(streamed.get()) != 0);
+  BOOST_CHECK_EQUAL(ConsumeIds(streamed.get()), sg_nrows);
+  BOOST_CHECK(streamed->isAfterEnd());
+
+  std::auto_ptr<te::da::DataSet> materialized = t->query(sg_query, te::common::RANDOM);
+
+  BOOST_CHECK(dynamic_cast<te::pgis::CursorDataSet*>(materialized.get()) == 0);
+  BOOST_CHECK_EQUAL(materialized->size(), static_cast<std::size_t>(sg_nrows));
+  BOOST_CHECK_EQUAL(ConsumeIds(materialized.get()), sg_nrows);
+}
+
+BOOST_AUTO_TEST_CASE( size_extent_and_rewind_test )
+{
+  std::unique_ptr<te::da::DataSource> ds = OpenTestDataSource();
+
+  if(ds.get() == 0)
+  {
+    BOOST_TEST_MESSAGE("Skipping: " TE_UNITTEST_PGIS_URI_ENV " is not set.");
+    return;
+  }
+
+  static_cast<te::pgis::DataSource*>(ds.get())->setCursorFetchSize(1000);
+
+  std::auto_ptr<te::da::DataSourceTransactor> t = ds->getTransactor();
+
+  std::auto_ptr<te::da::DataSet> dataset = t->query(sg_query, te::common::FORWARDONLY);
+
+  BOOST_REQUIRE(dynamic_cast<te::pgis::CursorDataSet*>(dataset.get()) != 0);
+  BOOST_CHECK_EQUAL(dataset->size(), static_cast<std::size_t>(sg_nrows));
+
+  std::auto_ptr<te::gm::Envelope> extent = dataset->getExtent(1);
+
+  BOOST_REQUIRE(extent.get() != 0);
+  BOOST_CHECK_CLOSE(extent->getLowerLeftX(), 1.0, 1e-9);
+  BOOST_CHECK_CLOSE(extent->getLowerLeftY(), 1.0, 1e-9);
+  BOOST_CHECK_CLOSE(extent->getUpperRightX(), static_cast<double>(sg_nrows), 1e-9);
+  BOOST_CHECK_CLOSE(extent->getUpperRightY(), static_cast<double>(sg_nrows), 1e-9);
+
+// the size and the extent must not disturb the rows being streamed
+  BOOST_CHECK_EQUAL(ConsumeIds(dataset.get()), sg_nrows);
+
+  BOOST_CHECK(dataset->moveBeforeFirst());
+  BOOST_CHECK_EQUAL(ConsumeIds(dataset.get()), sg_nrows);
+
+  BOOST_CHECK(dataset->moveFirst());
+  BOOST_CHECK_EQUAL(dataset->getInt32(0), 1);
+}
+
+BOOST_AUTO_TEST_CASE( transaction_cursor_test )
+{
+  std::unique_ptr<te::da::DataSource> ds = OpenTestDataSource();
+
+  if(ds.get() == 0)
+  {
+    BOOST_TEST_MESSAGE("Skipping: " TE_UNITTEST_PGIS_URI_ENV " is not set.");
+    return;
+  }
+
+  static_cast<te::pgis::DataSource*>(ds.get())->setCursorFetchSize(1000);
+
+  std::auto_ptr<te::da::DataSourceTransactor> t = ds->getTransactor();
+
+  t->begin();
+
+  {
+    std::auto_ptr<te::da::DataSet> dataset = t->query(sg_query, te::common::FORWARDONLY);
+
+    BOOST_REQUIRE(dynamic_cast<te::pgis::CursorDataSet*>(dataset.get()) != 0);
+    BOOST_CHECK_EQUAL(ConsumeIds(dataset.get()), sg_nrows);
+  }
+
+  t->commit();
+
+  BOOST_CHECK(!t->isInTransaction());
+}
+
+BOOST_AUTO_TEST_CASE( disabled_cursor_test )
+{
+  std::unique_ptr<te::da::DataSource> ds = OpenTestDataSource();
+
+  if(ds.get() == 0)
+  {
+    BOOST_TEST_MESSAGE("Skipping: " TE_UNITTEST_PGIS_URI_ENV " is not set.");
+    return;
+  }
+
+  static_cast<te::pgis::DataSource*>(ds.get())->setCursorFetchSize(0);
+
+  std::auto_ptr<te::da::DataSourceTransactor> t = ds->getTransactor();
+
+  std::auto_ptr<te::da::DataSet> dataset = t->query(sg_query, te::common::FORWARDONLY);
+
+  BOOST_CHECK(dynamic_cast<te::pgis::CursorDataSet*>(dataset.get()) == 0);
+  BOOST_CHECK_EQUAL(dataset->size(), static_cast<std::size_t>(sg_nrows));
+  BOOST_CHECK_EQUAL(ConsumeIds(dataset.get()), sg_nrows);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,220 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+  \file TsTileCache.cpp
+ 
+  \brief Test suite for the cache of rendered layer tiles.
+ */
+
+// Unit-Test TerraLib
+#include "TsTileCache.h"
+
+// TerraLib
+#include <terralib/qt/widgets/canvas/TileCache.h>
+
+// Qt
+#include <QColor>
+#include <QImage>
+
+// Boost
+#include <boost/filesystem.hpp>
+
+CPPUNIT_TEST_SUITE_REGISTRATION( TsTileCache );
+
+namespace
+{
+  te::qt::widgets::TileKey MakeKey(const std::string& layerId, int x, int y)
+  {
+    te::qt::widgets::TileKey key;
+    key.m_layerId = layerId;
+    key.m_styleHash = 42;
+    key.m_srid = 4326;
+    key.m_zoom = te::qt::widgets::TileCache::GetZoomLevel(0.001);
+    key.m_x = x;
+    key.m_y = y;
+
+    return key;
+  }
+
+// each tile is filled with a color that identifies it
+  QImage MakeTile(int id)
+  {
+    const int tileSize = te::qt::widgets::TileCache::GetTileSize();
+
+    QImage tile(tileSize, tileSize, QImage::Format_ARGB32_Premultiplied);
+    tile.fill(QColor(id % 256, (id / 256) % 256, 128, 255).rgba());
+
+    return tile;
+  }
+
+  bool HasTile(te::qt::widgets::TileCache& cache, const te::qt::widgets::TileKey& key, int id)
+  {
+    QImage tile;
+
+    if(!cache.get(key, tile))
+      return false;
+
+    return tile.pixel(0, 0) == MakeTile(id).pixel(0, 0);
+  }
+
+  bool IsEquivalent(const te::qt::widgets::TileKey& a, const te::qt::widgets::TileKey& b)
+  {
+    return !(a < b) && !(b < a);
+  }
+}
+
+void TsTileCache::setUp()
+{
+  m_dir = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("te_tilecache_%%%%-%%%%")).string();
+}
+
+void TsTileCache::tearDown()
+{
+  boost::system::error_code ec;
+
+  boost::filesystem::remove_all(m_dir, ec);
+}
+
+void TsTileCache::tcKey()
+{
+  const te::qt::widgets::TileKey key = MakeKey("layer", 10, -3);
+
+  CPPUNIT_ASSERT(IsEquivalent(key, MakeKey("layer", 10, -3)));
+
+  te::qt::widgets::TileKey other = key;
+  other.m_layerId = "layer2";
+  CPPUNIT_ASSERT(!IsEquivalent(key, other));
+
+  other = key;
+  other.m_styleHash = 43;
+  CPPUNIT_ASSERT(!IsEquivalent(key, other));
+
+  other = key;
+  other.m_srid = 3857;
+  CPPUNIT_ASSERT(!IsEquivalent(key, other));
+
+  other = key;
+  other.m_zoom = key.m_zoom + 1;
+  CPPUNIT_ASSERT(!IsEquivalent(key, other));
+
+  other = key;
+  other.m_x = 11;
+  CPPUNIT_ASSERT(!IsEquivalent(key, other));
+
+  other = key;
+  other.m_y = -2;
+  CPPUNIT_ASSERT(!IsEquivalent(key, other));
+
+// the ordering is antisymmetric
+  CPPUNIT_ASSERT((key < other) != (other < key));
+}
+
+void TsTileCache::tcZoomLevel()
+{
+  const int zoom = te::qt::widgets::TileCache::GetZoomLevel(0.001);
+
+  CPPUNIT_ASSERT_EQUAL(zoom, te::qt::widgets::TileCache::GetZoomLevel(te::qt::widgets::TileCache::GetResolution(zoom)));
+
+// a resolution twice as large is one binary order of magnitude above
+  CPPUNIT_ASSERT_EQUAL(zoom + 65536, te::qt::widgets::TileCache::GetZoomLevel(0.002));
+
+// virtually the same resolution has the same zoom level
+  CPPUNIT_ASSERT_EQUAL(zoom, te::qt::widgets::TileCache::GetZoomLevel(0.001 * (1.0 + 1.0e-7)));
+
+  CPPUNIT_ASSERT(zoom != te::qt::widgets::TileCache::GetZoomLevel(0.001 * 1.001));
+}
+
+void TsTileCache::tcLRU()
+{
+  te::qt::widgets::TileCache cache("", 3);
+
+  cache.put(MakeKey("layer", 0, 0), MakeTile(0));
+  cache.put(MakeKey("layer", 1, 0), MakeTile(1));
+  cache.put(MakeKey("layer", 2, 0), MakeTile(2));
+
+// the access to the first tile makes the second one the least recently used
+  CPPUNIT_ASSERT(HasTile(cache, MakeKey("layer", 0, 0), 0));
+
+  cache.put(MakeKey("layer", 3, 0), MakeTile(3));
+
+  CPPUNIT_ASSERT(HasTile(cache, MakeKey("layer", 0, 0), 0));
+  CPPUNIT_ASSERT(!HasTile(cache, MakeKey("layer", 1, 0), 1));
+  CPPUNIT_ASSERT(HasTile(cache, MakeKey("layer", 2, 0), 2));
+  CPPUNIT_ASSERT(HasTile(cache, MakeKey("layer", 3, 0), 3));
+
+// replacing a tile doesn't evict other tiles
+  cache.put(MakeKey("layer", 2, 0), MakeTile(20));
+
+  CPPUNIT_ASSERT(HasTile(cache, MakeKey("layer", 2, 0), 20));
+  CPPUNIT_ASSERT(HasTile(cache, MakeKey("layer", 0, 0), 0));
+  CPPUNIT_ASSERT(HasTile(cache, MakeKey("layer", 3, 0), 3));
+}
+
+void TsTileCache::tcInvalidate()
+{
+  te::qt::widgets::TileCache cache;
+
+  cache.put(MakeKey("a", 0, 0), MakeTile(1));
+  cache.put(MakeKey("a", 1, 0), MakeTile(2));
+  cache.put(MakeKey("b", 0, 0), MakeTile(3));
+
+  cache.invalidate("a");
+
+  CPPUNIT_ASSERT(!HasTile(cache, MakeKey("a", 0, 0), 1));
+  CPPUNIT_ASSERT(!HasTile(cache, MakeKey("a", 1, 0), 2));
+  CPPUNIT_ASSERT(HasTile(cache, MakeKey("b", 0, 0), 3));
+
+  cache.clear();
+
+  CPPUNIT_ASSERT(!HasTile(cache, MakeKey("b", 0, 0), 3));
+}
+
+void TsTileCache::tcDisk()
+{
+  {
+    te::qt::widgets::TileCache cache(m_dir, 1);
+
+    cache.put(MakeKey("a", 0, 0), MakeTile(1));
+    cache.put(MakeKey("a", 1, 0), MakeTile(2));
+    cache.put(MakeKey("b", 0, 0), MakeTile(3));
+
+// the evicted tiles are read back from disk
+    CPPUNIT_ASSERT(HasTile(cache, MakeKey("a", 0, 0), 1));
+  }
+
+// a new cache finds the tiles of the previous one
+  te::qt::widgets::TileCache cache(m_dir, 16);
+
+  CPPUNIT_ASSERT(HasTile(cache, MakeKey("a", 0, 0), 1));
+  CPPUNIT_ASSERT(HasTile(cache, MakeKey("a", 1, 0), 2));
+  CPPUNIT_ASSERT(HasTile(cache, MakeKey("b", 0, 0), 3));
+
+  cache.invalidate("a");
+
+  CPPUNIT_ASSERT(!HasTile(cache, MakeKey("a", 0, 0), 1));
+  CPPUNIT_ASSERT(!HasTile(cache, MakeKey("a", 1, 0), 2));
+  CPPUNIT_ASSERT(HasTile(cache, MakeKey("b", 0, 0), 3));
+
+// the invalidated tiles are removed from disk too
+  te::qt::widgets::TileCache other(m_dir, 16);
+
+  CPPUNIT_ASSERT(!HasTile(other, MakeKey("a", 0, 0), 1));
+  CPPUNIT_ASSERT(HasTile(other, MakeKey("b", 0, 0), 3));
+}
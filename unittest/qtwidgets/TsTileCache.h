@@ -0,0 +1,90 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+  \file TsTileCache.h
+ 
+  \brief Test suite for the cache of rendered layer tiles.
+ */
+
+#ifndef __TERRALIB_UNITTEST_QTWIDGETS_INTERNAL_TILECACHE_H
+#define __TERRALIB_UNITTEST_QTWIDGETS_INTERNAL_TILECACHE_H
+
+// cppUnit
+#include <cppunit/extensions/HelperMacros.h>
+
+/*!
+  \class TsTileCache
+
+  \brief Test suite for the cache of rendered layer tiles.
+
+  This test suite will check the following:
+  <ul>
+  <li>the tile keys ordering and the zoom levels;</li>
+  <li>the eviction of the least recently used tiles;</li>
+  <li>the invalidation of the tiles of a layer, in memory and on disk.</li>
+  </ul>
+ */
+class TsTileCache : public CPPUNIT_NS::TestFixture
+{
+// It registers this class as a Test Suit
+  CPPUNIT_TEST_SUITE( TsTileCache );
+
+// It registers the class methods as Test Cases belonging to the suit 
+  CPPUNIT_TEST( tcKey );
+  CPPUNIT_TEST( tcZoomLevel );
+  CPPUNIT_TEST( tcLRU );
+  CPPUNIT_TEST( tcInvalidate );
+  CPPUNIT_TEST( tcDisk );
+
+  CPPUNIT_TEST_SUITE_END();    
+  
+  public:
+
+// It sets up context before running the test.
+    void setUp();
+
+// It cleann up after the test run.
+    void tearDown();
+
+  protected:
+
+// Test Cases:
+
+    /*! \brief Test Case: keys that differ in any field are different tiles. */
+    void tcKey();
+
+    /*! \brief Test Case: the zoom level of a resolution and the resolution of a zoom level. */
+    void tcZoomLevel();
+
+    /*! \brief Test Case: the least recently used tiles are evicted from memory. */
+    void tcLRU();
+
+    /*! \brief Test Case: only the tiles of the invalidated layer are removed. */
+    void tcInvalidate();
+
+    /*! \brief Test Case: the tiles are persisted and invalidated on disk. */
+    void tcDisk();
+
+  private:
+
+    std::string m_dir;    //!< A temporary cache directory.
+};
+
+#endif  // __TERRALIB_UNITTEST_QTWIDGETS_INTERNAL_TILECACHE_H
@@ -0,0 +1,164 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+  \file terralib/unittest/raster/rasterizer/TsRasterizer.cpp
+ 
+  \brief A test suit for the Rasterizer class.
+ */
+
+// TerraLib
+#include <terralib/geometry.h>
+#include <terralib/raster.h>
+#include "../Config.h"
+
+// STL
+#include <cmath>
+#include <memory>
+#include <vector>
+
+// Boost
+#include <boost/test/unit_test.hpp>
+
+namespace
+{
+  te::gm::Polygon* CreateRectangle(double llx, double lly, double urx, double ury)
+  {
+    te::gm::LinearRing* ring = new te::gm::LinearRing(5, te::gm::LineStringType);
+    ring->setPoint(0, llx, lly);
+    ring->setPoint(1, llx, ury);
+    ring->setPoint(2, urx, ury);
+    ring->setPoint(3, urx, lly);
+    ring->setPoint(4, llx, lly);
+
+    te::gm::Polygon* poly = new te::gm::Polygon(1, te::gm::PolygonType);
+    poly->setRingN(0, ring);
+
+    return poly;
+  }
+}
+
+BOOST_AUTO_TEST_SUITE ( rasterizer_tests )
+
+BOOST_AUTO_TEST_CASE (rasterizer_center_test)
+{
+  /* A 100 x 100 grid with unit cells and its upper-left corner at (0, 100) */
+
+  te::gm::Coord2D ulc(0.0, 100.0);
+  te::rst::Grid grid(100, 100, 1.0, 1.0, &ulc);
+
+  std::auto_ptr<te::gm::Polygon> poly1(CreateRectangle(10.0, 10.0, 30.0, 30.0));
+  std::auto_ptr<te::gm::Polygon> poly2(CreateRectangle(20.0, 20.0, 40.0, 40.0));
+
+  te::rst::Rasterizer rasterizer(grid, te::rst::Rasterizer::MergeCount);
+  rasterizer.add(poly1.get(), 1.0);
+  rasterizer.add(poly2.get(), 1.0);
+
+  std::vector<double> values(100 * 100);
+  std::vector<double*> buffers(1, &values[0]);
+
+  BOOST_CHECK( rasterizer.rasterize(0, 100, buffers) );
+
+  /* Each polygon covers 400 cell centers and they share 100 of them */
+
+  unsigned int covered = 0;
+  unsigned int shared = 0;
+
+  for(std::size_t i = 0; i < values.size(); ++i)
+  {
+    if(values[i] > 0.0) ++covered;
+    if(values[i] > 1.0) ++shared;
+  }
+
+  BOOST_CHECK_EQUAL( covered, 700u );
+  BOOST_CHECK_EQUAL( shared, 100u );
+
+  /* The cell (col 25, row 75) has its center at (25.5, 24.5) */
+
+  BOOST_CHECK_EQUAL( values[75 * 100 + 25], 2.0 );
+}
+
+BOOST_AUTO_TEST_CASE (rasterizer_area_fraction_test)
+{
+  te::gm::Coord2D ulc(0.0, 100.0);
+  te::rst::Grid grid(100, 100, 1.0, 1.0, &ulc);
+
+  /* A 10 x 10 square not aligned to the cells */
+
+  std::auto_ptr<te::gm::Polygon> poly(CreateRectangle(10.25, 10.25, 20.25, 20.25));
+
+  te::rst::Rasterizer rasterizer(grid, te::rst::Rasterizer::MergeAreaFraction);
+  rasterizer.add(poly.get(), 1.0);
+
+  std::vector<double> values(100 * 100);
+  std::vector<double*> buffers(1, &values[0]);
+
+  BOOST_CHECK( rasterizer.rasterize(0, 100, buffers) );
+
+  double area = 0.0;
+
+  for(std::size_t i = 0; i < values.size(); ++i)
+    area += values[i];
+
+  BOOST_CHECK_CLOSE( area, 100.0, 1e-6 );
+
+  /* A corner cell is covered by a quarter: 0.75 x 0.75 */
+
+  BOOST_CHECK_CLOSE( values[89 * 100 + 10], 0.5625, 1e-6 );
+}
+
+BOOST_AUTO_TEST_CASE (rasterizer_threads_test)
+{
+  te::gm::Coord2D ulc(0.0, 1000.0);
+  te::rst::Grid grid(1000, 1000, 1.0, 1.0, &ulc);
+
+  std::vector<te::gm::Geometry*> geoms;
+
+  for(unsigned int i = 0; i < 50; ++i)
+  {
+    const double x = std::fmod(i * 137.3, 900.0);
+    const double y = std::fmod(i * 241.7, 900.0);
+
+    geoms.push_back(CreateRectangle(x, y, x + 10.0 + i * 3.1, y + 5.0 + i * 2.3));
+  }
+
+  /* The result must not depend on the number of threads */
+
+  te::rst::Rasterizer serial(grid, te::rst::Rasterizer::MergeLast, true, 1);
+  te::rst::Rasterizer parallel(grid, te::rst::Rasterizer::MergeLast, true, 4);
+
+  for(std::size_t i = 0; i < geoms.size(); ++i)
+  {
+    serial.add(geoms[i], static_cast<double>(i + 1));
+    parallel.add(geoms[i], static_cast<double>(i + 1));
+  }
+
+  std::vector<double> serialValues(1000 * 1000);
+  std::vector<double> parallelValues(1000 * 1000);
+
+  BOOST_CHECK( serial.rasterize(0, 1000, std::vector<double*>(1, &serialValues[0])) );
+  BOOST_CHECK( parallel.rasterize(0, 1000, std::vector<double*>(1, &parallelValues[0])) );
+
+  BOOST_CHECK( serialValues == parallelValues );
+
+  for(std::size_t i = 0; i < geoms.size(); ++i)
+    delete geoms[i];
+}
+
+BOOST_AUTO_TEST_SUITE_END()
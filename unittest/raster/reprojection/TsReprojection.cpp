@@ -54,6 +54,53 @@ BOOST_AUTO_TEST_CASE (reprojection1_test)
 
 BOOST_AUTO_TEST_CASE (reprojectin2_test)
 {
+  /* Openning input raster */
+
+  std::map<std::string, std::string> auxRasterInfo;
+
+  auxRasterInfo["URI"] = TERRALIB_DATA_DIR "/geotiff/cbers_rgb342_crop1.tif";
+  boost::shared_ptr< te::rst::Raster > inputRasterPtr ( te::rst::RasterFactory::open(
+    auxRasterInfo ) );
+  BOOST_CHECK( inputRasterPtr.get() );
+
+  /* Reprojecting using the serial and the multi-threaded paths */
+
+  auxRasterInfo["URI"] = "TsReprojection_tcReprojection2_serial.tif";
+  boost::shared_ptr< te::rst::Raster > serialRasterPtr( te::rst::Reproject(
+    inputRasterPtr.get(), 32621, auxRasterInfo, te::rst::NearestNeighbor, 1 ) );
+  BOOST_CHECK( serialRasterPtr.get() );
+
+  auxRasterInfo["URI"] = "TsReprojection_tcReprojection2_parallel.tif";
+  boost::shared_ptr< te::rst::Raster > parallelRasterPtr( te::rst::Reproject(
+    inputRasterPtr.get(), 32621, auxRasterInfo, te::rst::NearestNeighbor, 0 ) );
+  BOOST_CHECK( parallelRasterPtr.get() );
+
+  /* Comparing the results */
+
+  BOOST_CHECK_EQUAL( serialRasterPtr->getNumberOfRows(), parallelRasterPtr->getNumberOfRows() );
+  BOOST_CHECK_EQUAL( serialRasterPtr->getNumberOfColumns(), parallelRasterPtr->getNumberOfColumns() );
+  BOOST_CHECK_EQUAL( serialRasterPtr->getNumberOfBands(), parallelRasterPtr->getNumberOfBands() );
+  BOOST_CHECK( *serialRasterPtr->getGrid() == *parallelRasterPtr->getGrid() );
+
+  double serialValue = 0;
+  double parallelValue = 0;
+  unsigned int differentPixels = 0;
+
+  for( unsigned int band = 0 ; band < serialRasterPtr->getNumberOfBands() ; ++band )
+  {
+    for( unsigned int row = 0 ; row < serialRasterPtr->getNumberOfRows() ; ++row )
+    {
+      for( unsigned int col = 0 ; col < serialRasterPtr->getNumberOfColumns() ; ++col )
+      {
+        serialRasterPtr->getValue( col, row, serialValue, band );
+        parallelRasterPtr->getValue( col, row, parallelValue, band );
+
+        if( serialValue != parallelValue ) ++differentPixels;
+      }
+    }
+  }
+
+  BOOST_CHECK_EQUAL( differentPixels, 0u );
 }
 
 BOOST_AUTO_TEST_CASE (reprojection3_test)
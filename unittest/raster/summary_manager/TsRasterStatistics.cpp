@@ -0,0 +1,158 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+  \file terralib/unittest/raster/TsRasterStatistics.cpp
+ 
+  \brief A test suit for the Raster Statistics class.
+ */
+
+// TerraLib
+#include <terralib/raster.h>
+#include "../Config.h"
+
+// STL
+#include <complex>
+#include <map>
+#include <vector>
+
+// Boost
+#include <boost/test/unit_test.hpp>
+#include <boost/shared_ptr.hpp>
+
+namespace
+{
+  void CreateStatisticsTestRaster( const int dataType, const double noData,
+    boost::shared_ptr< te::rst::Raster >& rasterPointer )
+  {
+    std::vector< te::rst::BandProperty * > bandsProps;
+
+    for( unsigned int band = 0 ; band < 2 ; ++band )
+    {
+      bandsProps.push_back( new te::rst::BandProperty( band, dataType ) );
+      bandsProps.back()->m_noDataValue = noData;
+    }
+
+    rasterPointer.reset( te::rst::RasterFactory::make( "MEM",
+      new te::rst::Grid( 300, 200 ), bandsProps,
+      std::map< std::string, std::string >(), 0, 0 ) );
+
+    for( unsigned int band = 0 ; band < 2 ; ++band )
+      for( unsigned int line = 0 ; line < 200 ; ++line )
+        for( unsigned int col = 0 ; col < 300 ; ++col )
+        {
+          double value = (double)( ( line * 7 + col * 13 + band ) % 200 );
+
+          if( ( line + col ) % 37 == 0 )
+            value = noData;
+
+          rasterPointer->setValue( col, line, value, band );
+        }
+  }
+
+  void CheckStatistics( const te::rst::Raster& raster, const unsigned int maxThreads )
+  {
+    te::rst::RasterStatistics statistics( &raster, te::rst::SUMMARY_ALL, false, maxThreads );
+
+    BOOST_CHECK( statistics.compute() );
+
+    std::auto_ptr< te::rst::RasterSummary > summary( statistics.getSummary() );
+
+    BOOST_CHECK_EQUAL( summary->size(), raster.getNumberOfBands() );
+
+    for( unsigned int band = 0 ; band < raster.getNumberOfBands() ; ++band )
+    {
+      const te::rst::Band& rasterBand = *raster.getBand( band );
+      const te::rst::BandSummary& bs = summary->at( band );
+
+      BOOST_CHECK_EQUAL( bs.m_minVal->real(), rasterBand.getMinValue( true ).real() );
+      BOOST_CHECK_EQUAL( bs.m_maxVal->real(), rasterBand.getMaxValue( true ).real() );
+      BOOST_CHECK_CLOSE( bs.m_meanVal->real(), rasterBand.getMeanValue().real(), 0.0000001 );
+      BOOST_CHECK_CLOSE( bs.m_stdVal->real(), rasterBand.getStdValue().real(), 0.0000001 );
+      BOOST_CHECK( *bs.m_histogramR == rasterBand.getHistogramR() );
+      BOOST_CHECK( *bs.m_histogramI == rasterBand.getHistogramI() );
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE ( rasterStatistics_tests )
+
+BOOST_AUTO_TEST_CASE (arrayHistogram_test)
+{
+  boost::shared_ptr< te::rst::Raster > rasterPointer;
+  CreateStatisticsTestRaster( te::dt::UCHAR_TYPE, 255.0, rasterPointer );
+
+  CheckStatistics( *rasterPointer, 1 );
+  CheckStatistics( *rasterPointer, 4 );
+}
+
+BOOST_AUTO_TEST_CASE (mapHistogram_test)
+{
+  boost::shared_ptr< te::rst::Raster > rasterPointer;
+  CreateStatisticsTestRaster( te::dt::DOUBLE_TYPE, -1.0, rasterPointer );
+
+  CheckStatistics( *rasterPointer, 1 );
+  CheckStatistics( *rasterPointer, 4 );
+}
+
+BOOST_AUTO_TEST_CASE (merge_test)
+{
+  boost::shared_ptr< te::rst::Raster > rasterPointer;
+  CreateStatisticsTestRaster( te::dt::INT16_TYPE, -9999.0, rasterPointer );
+
+  const te::rst::Band& band = *rasterPointer->getBand( 0 );
+
+  std::vector< double > values( 300 * 200 );
+  band.getValues( 0, 0, 300, 200, &values[ 0 ] );
+
+  /* The partial states of the two halves of the band are merged */
+
+  te::rst::RasterStatistics::BandState whole;
+  whole.reset( *band.getProperty(), te::rst::SUMMARY_ALL );
+  whole.add( &values[ 0 ], 0, values.size() );
+  whole.flush();
+
+  te::rst::RasterStatistics::BandState first;
+  first.reset( *band.getProperty(), te::rst::SUMMARY_ALL );
+  first.add( &values[ 0 ], 0, 300 * 50 );
+  first.flush();
+
+  te::rst::RasterStatistics::BandState second;
+  second.reset( *band.getProperty(), te::rst::SUMMARY_ALL );
+  second.add( &values[ 300 * 50 ], 0, 300 * 150 );
+  second.flush();
+
+  first.merge( second );
+
+  te::rst::BandSummary wholeSummary;
+  whole.fill( te::rst::SUMMARY_ALL, wholeSummary );
+
+  te::rst::BandSummary mergedSummary;
+  first.fill( te::rst::SUMMARY_ALL, mergedSummary );
+
+  BOOST_CHECK_EQUAL( first.m_count, whole.m_count );
+  BOOST_CHECK_EQUAL( first.m_validCount, whole.m_validCount );
+  BOOST_CHECK_EQUAL( mergedSummary.m_minVal->real(), wholeSummary.m_minVal->real() );
+  BOOST_CHECK_EQUAL( mergedSummary.m_maxVal->real(), wholeSummary.m_maxVal->real() );
+  BOOST_CHECK_CLOSE( mergedSummary.m_meanVal->real(), wholeSummary.m_meanVal->real(), 0.0000001 );
+  BOOST_CHECK_CLOSE( mergedSummary.m_stdVal->real(), wholeSummary.m_stdVal->real(), 0.0000001 );
+  BOOST_CHECK( *mergedSummary.m_histogramR == *wholeSummary.m_histogramR );
+}
+
+BOOST_AUTO_TEST_SUITE_END ()
@@ -1023,4 +1023,60 @@ BOOST_AUTO_TEST_CASE(ln_test)
     }
 }
 
+BOOST_AUTO_TEST_CASE(fusedExecution_test)
+{
+  /* Load input raster as a doubles raster */
+
+  std::auto_ptr< te::rst::Raster > rin;
+  loadDoubleRaster(TERRALIB_DATA_DIR"/geotiff/cbers2b_rgb342_crop.tif",
+    rin);
+
+  /* The same expression executed by operators and by the fused program */
+
+  te::rp::ArithmeticOperations::InputParameters inputParams;
+  inputParams.m_arithmeticString = "2.5 * ( R0:2 - R0:1 ) / ( R0:2 + 6 * R0:1 - 7.5 * R0:0 + 1 )";
+  inputParams.m_normalize = true;
+  inputParams.m_inputRasters.push_back(rin.get());
+
+  std::map<std::string, std::string> orinfo;
+  orinfo["URI"] = "terralib_unittest_arithmetic_operators.tif";
+
+  te::rp::ArithmeticOperations::OutputParameters operatorsOutputParams;
+  operatorsOutputParams.m_rInfo = orinfo;
+  operatorsOutputParams.m_rType = "GDAL";
+
+  inputParams.m_enableFusedExecution = false;
+
+  te::rp::ArithmeticOperations operatorsInstance;
+
+  BOOST_CHECK(operatorsInstance.initialize(inputParams));
+  BOOST_CHECK(operatorsInstance.execute(operatorsOutputParams));
+
+  orinfo["URI"] = "terralib_unittest_arithmetic_fused.tif";
+
+  te::rp::ArithmeticOperations::OutputParameters fusedOutputParams;
+  fusedOutputParams.m_rInfo = orinfo;
+  fusedOutputParams.m_rType = "GDAL";
+
+  inputParams.m_enableFusedExecution = true;
+  inputParams.m_maxThreads = 0;
+
+  te::rp::ArithmeticOperations fusedInstance;
+
+  BOOST_CHECK(fusedInstance.initialize(inputParams));
+  BOOST_CHECK(fusedInstance.execute(fusedOutputParams));
+
+  /* Comparing the results */
+
+  double operatorsValue = 0;
+  double fusedValue = 0;
+  for (unsigned int r = 0; r < rin->getNumberOfRows(); r++)
+    for (unsigned int c = 0; c < rin->getNumberOfColumns(); c++)
+    {
+      operatorsOutputParams.m_outputRasterPtr->getValue(c, r, operatorsValue, 0);
+      fusedOutputParams.m_outputRasterPtr->getValue(c, r, fusedValue, 0);
+      BOOST_CHECK_EQUAL(operatorsValue, fusedValue);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -354,4 +354,80 @@ BOOST_AUTO_TEST_CASE(userDefinedWindow_test)
   BOOST_CHECK( algorithmInstance.execute( algoOutputParams ) );
 }
 
+BOOST_AUTO_TEST_CASE(multiThreadFilter_test)
+{
+  /* Openning input raster */
+
+  std::map<std::string, std::string> auxRasterInfo;
+
+  auxRasterInfo["URI"] = TERRALIB_DATA_DIR "/geotiff/cbers_rgb342_crop1.tif";
+  boost::shared_ptr< te::rst::Raster > inputRasterPtrPointer ( te::rst::RasterFactory::open(
+    auxRasterInfo ) );
+  BOOST_CHECK( inputRasterPtrPointer.get() );
+
+  /* Creating the algorithm parameters */
+
+  te::rp::Filter::InputParameters algoInputParams;
+
+  algoInputParams.m_filterType = te::rp::Filter::InputParameters::MedianFilterT;
+
+  algoInputParams.m_inRasterPtr = inputRasterPtrPointer.get();
+
+  algoInputParams.m_inRasterBands.push_back( 0 );
+
+  algoInputParams.m_iterationsNumber = 2;
+
+  algoInputParams.m_windowH = 5;
+  algoInputParams.m_windowW = 5;
+
+  /* Executing the algorithm with a single thread and with many threads */
+
+  algoInputParams.m_maxThreads = 1;
+
+  te::rp::Filter::OutputParameters singleThreadOutputParams;
+
+  singleThreadOutputParams.m_rType = "MEM";
+
+  te::rp::Filter singleThreadInstance;
+
+  BOOST_CHECK( singleThreadInstance.initialize( algoInputParams ) );
+  BOOST_CHECK( singleThreadInstance.execute( singleThreadOutputParams ) );
+
+  algoInputParams.m_maxThreads = 4;
+
+  te::rp::Filter::OutputParameters multiThreadOutputParams;
+
+  multiThreadOutputParams.m_rType = "MEM";
+
+  te::rp::Filter multiThreadInstance;
+
+  BOOST_CHECK( multiThreadInstance.initialize( algoInputParams ) );
+  BOOST_CHECK( multiThreadInstance.execute( multiThreadOutputParams ) );
+
+  /* The results must be the same */
+
+  const te::rst::Band& singleThreadBand =
+    *singleThreadOutputParams.m_outputRasterPtr->getBand( 0 );
+  const te::rst::Band& multiThreadBand =
+    *multiThreadOutputParams.m_outputRasterPtr->getBand( 0 );
+  const unsigned int nRows = inputRasterPtrPointer->getNumberOfRows();
+  const unsigned int nCols = inputRasterPtrPointer->getNumberOfColumns();
+  double singleThreadValue = 0;
+  double multiThreadValue = 0;
+  unsigned int differentValues = 0;
+
+  for( unsigned int row = 0 ; row < nRows ; ++row )
+  {
+    for( unsigned int col = 0 ; col < nCols ; ++col )
+    {
+      singleThreadBand.getValue( col, row, singleThreadValue );
+      multiThreadBand.getValue( col, row, multiThreadValue );
+
+      if( singleThreadValue != multiThreadValue ) ++differentValues;
+    }
+  }
+
+  BOOST_CHECK_EQUAL( differentValues, 0u );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,283 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+  \file terralib/unittest/sa/TsKernelGridEstimator.cpp
+
+  \brief A test suit for the KernelGridEstimator engine.
+
+  The truncated Normal kernel must stay within the error bound given by
+  its tolerance, the bounded kernels must use all the events of their
+  support, and the results must not depend on the number of threads.
+ */
+
+// TerraLib
+#include <terralib/common/Exception.h>
+#include <terralib/geometry/Envelope.h>
+#include <terralib/geometry/Point.h>
+#include <terralib/raster/Grid.h>
+#include <terralib/sa/core/KernelFunctions.h>
+#include <terralib/sa/core/KernelGridEstimator.h>
+#include <terralib/sa/core/KernelParams.h>
+#include "Config.h"
+
+// STL
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+// Boost
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/normal_distribution.hpp>
+#include <boost/random/uniform_real_distribution.hpp>
+#include <boost/test/unit_test.hpp>
+
+namespace
+{
+  /*!
+    \brief Clustered events, from a fixed seed, over a grid of 60x50 cells of size 10.
+
+    The grid has 50 rows, which is not a multiple of the strip size of the engine.
+   */
+  struct EventsFixture
+  {
+    te::sa::KernelMap m_kMap;
+    te::rst::Grid m_grid;
+    double m_totalIntensity;
+
+    EventsFixture()
+      : m_grid(10., 10., new te::gm::Envelope(0., 0., 600., 500.)),
+        m_totalIntensity(0.)
+    {
+      boost::random::mt19937 gen(42);
+      boost::random::uniform_real_distribution<> x(0., 600.);
+      boost::random::uniform_real_distribution<> y(0., 500.);
+      boost::random::normal_distribution<> spread(0., 30.);
+
+      for(int i = 0; i < 500; ++i)
+      {
+        te::gm::Point* p = 0;
+
+        if(i % 2)
+          p = new te::gm::Point(std::min(std::max(200. + spread(gen), 0.), 600.), std::min(std::max(250. + spread(gen), 0.), 500.));
+        else
+          p = new te::gm::Point(x(gen), y(gen));
+
+        double intensity = 1. + static_cast<double>(i % 3);
+
+        m_kMap[i] = std::pair<te::gm::Geometry*, double>(p, intensity);
+
+        m_totalIntensity += intensity;
+      }
+    }
+
+    ~EventsFixture()
+    {
+      for(te::sa::KernelMap::iterator it = m_kMap.begin(); it != m_kMap.end(); ++it)
+        delete it->second.first;
+    }
+
+    void cellKernel(te::sa::KernelFunctionType type, double tolerance, unsigned int maxThreads, double radius, std::vector<double>& values)
+    {
+      te::sa::KernelInputParams params;
+      params.m_functionType = type;
+      params.m_tolerance = tolerance;
+      params.m_maxThreads = maxThreads;
+
+      te::sa::KernelGridEstimator estimator(params, m_kMap, m_grid);
+
+      BOOST_REQUIRE(estimator.cellKernel(radius, values));
+      BOOST_REQUIRE_EQUAL(values.size(), static_cast<std::size_t>(m_grid.getNumberOfColumns() * m_grid.getNumberOfRows()));
+    }
+
+    void convolutionKernel(te::sa::KernelFunctionType type, unsigned int maxThreads, double radius, std::vector<double>& values)
+    {
+      te::sa::KernelInputParams params;
+      params.m_functionType = type;
+      params.m_maxThreads = maxThreads;
+
+      te::sa::KernelGridEstimator estimator(params, m_kMap, m_grid);
+
+      BOOST_REQUIRE(estimator.convolutionKernel(radius, values));
+      BOOST_REQUIRE_EQUAL(values.size(), static_cast<std::size_t>(m_grid.getNumberOfColumns() * m_grid.getNumberOfRows()));
+    }
+  };
+}
+
+BOOST_FIXTURE_TEST_SUITE( kernel_grid_estimator_tests, EventsFixture )
+
+BOOST_AUTO_TEST_CASE( support_test )
+{
+  const double radius = 20.;
+
+  BOOST_CHECK_EQUAL(te::sa::KernelSupport(te::sa::Quartic, radius, 1.e-6), radius);
+  BOOST_CHECK_EQUAL(te::sa::KernelSupport(te::sa::Uniform, radius, 0.), radius);
+  BOOST_CHECK_EQUAL(te::sa::KernelSupport(te::sa::Normal, radius, 0.), std::numeric_limits<double>::max());
+
+// the Normal kernel is truncated where it falls to the tolerance of its peak
+  const double tolerances[] = { 1.e-2, 1.e-6, 1.e-12 };
+
+  double peak = te::sa::KernelFunctionValue(te::sa::Normal, radius, 0., 1.);
+
+  for(std::size_t t = 0; t < 3; ++t)
+  {
+    double support = te::sa::KernelSupport(te::sa::Normal, radius, tolerances[t]);
+
+    BOOST_CHECK_CLOSE(te::sa::KernelFunctionValue(te::sa::Normal, radius, support, 1.) / peak, tolerances[t], 1e-6);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( tolerance_test )
+{
+  std::vector<double> reference;
+  cellKernel(te::sa::Normal, 0., 1, 20., reference);
+
+  double peak = te::sa::KernelFunctionValue(te::sa::Normal, 20., 0., 1.);
+
+// each dropped event adds less than the tolerance of its peak to a cell
+  const double tolerances[] = { 1.e-2, 1.e-6 };
+
+  for(std::size_t t = 0; t < 2; ++t)
+  {
+    std::vector<double> truncated;
+    cellKernel(te::sa::Normal, tolerances[t], 1, 20., truncated);
+
+    double bound = tolerances[t] * peak * m_totalIntensity;
+    double maxDifference = 0.;
+
+    for(std::size_t i = 0; i < reference.size(); ++i)
+    {
+      BOOST_CHECK_LE(truncated[i], reference[i] * (1. + 1.e-12));
+
+      maxDifference = std::max(maxDifference, reference[i] - truncated[i]);
+    }
+
+    BOOST_CHECK_LE(maxDifference, bound);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( bounded_kernel_test )
+{
+  const double radius = 25.;
+
+  const te::sa::KernelFunctionType types[] = { te::sa::Quartic, te::sa::Triangular, te::sa::Uniform, te::sa::Negative_Exp };
+
+  for(std::size_t t = 0; t < 4; ++t)
+  {
+    std::vector<double> values;
+    cellKernel(types[t], 1.e-6, 1, radius, values);
+
+// the kernel of each cell must be the sum over all the events, up to the order of the sum
+    std::size_t cell = 0;
+    double maxValue = 0.;
+    double maxDifference = 0.;
+
+    for(unsigned int i = 0; i < m_grid.getNumberOfRows(); ++i)
+    {
+      for(unsigned int j = 0; j < m_grid.getNumberOfColumns(); ++j, ++cell)
+      {
+        te::gm::Coord2D coord = m_grid.gridToGeo(static_cast<double>(j), static_cast<double>(i));
+
+        double expected = 0.;
+
+        for(te::sa::KernelMap::iterator it = m_kMap.begin(); it != m_kMap.end(); ++it)
+        {
+          const te::gm::Point* p = static_cast<const te::gm::Point*>(it->second.first);
+
+          double dx = p->getX() - coord.x;
+          double dy = p->getY() - coord.y;
+
+          expected += te::sa::KernelFunctionValue(types[t], radius, std::sqrt(dx * dx + dy * dy), it->second.second);
+        }
+
+        maxValue = std::max(maxValue, expected);
+        maxDifference = std::max(maxDifference, std::fabs(values[cell] - expected));
+      }
+    }
+
+    BOOST_CHECK_GT(maxValue, 0.);
+    BOOST_CHECK_LE(maxDifference, 1.e-12 * maxValue);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( convolution_test )
+{
+  const double radius = 30.;
+
+  std::vector<double> reference;
+  cellKernel(te::sa::Normal, 0., 1, radius, reference);
+
+  std::vector<double> convolution;
+  convolutionKernel(te::sa::Normal, 1, radius, convolution);
+
+// the binning moves each event by less than one cell
+  double maxValue = 0.;
+  double maxDifference = 0.;
+  double referenceSum = 0.;
+  double convolutionSum = 0.;
+
+  for(std::size_t i = 0; i < reference.size(); ++i)
+  {
+    maxValue = std::max(maxValue, reference[i]);
+    maxDifference = std::max(maxDifference, std::fabs(reference[i] - convolution[i]));
+    referenceSum += reference[i];
+    convolutionSum += convolution[i];
+  }
+
+  BOOST_CHECK_LT(maxDifference / maxValue, 1.e-2);
+  BOOST_CHECK_CLOSE(convolutionSum, referenceSum, 1.);
+}
+
+BOOST_AUTO_TEST_CASE( threads_test )
+{
+  std::vector<double> serialCells;
+  std::vector<double> serialConvolution;
+
+  cellKernel(te::sa::Normal, 1.e-6, 1, 20., serialCells);
+  convolutionKernel(te::sa::Quartic, 1, 20., serialConvolution);
+
+  const unsigned int threads[] = { 2, 4, 0 };
+
+  for(std::size_t t = 0; t < 3; ++t)
+  {
+    std::vector<double> cells;
+    std::vector<double> convolution;
+
+    cellKernel(te::sa::Normal, 1.e-6, threads[t], 20., cells);
+    convolutionKernel(te::sa::Quartic, threads[t], 20., convolution);
+
+    BOOST_CHECK(cells == serialCells);
+    BOOST_CHECK(convolution == serialConvolution);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( invalid_tolerance_test )
+{
+  te::sa::KernelInputParams params;
+
+  params.m_tolerance = 1.;
+  BOOST_CHECK_THROW(te::sa::KernelGridEstimator estimator(params, m_kMap, m_grid), te::common::Exception);
+
+  params.m_tolerance = -1.e-6;
+  BOOST_CHECK_THROW(te::sa::KernelGridEstimator estimator(params, m_kMap, m_grid), te::common::Exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
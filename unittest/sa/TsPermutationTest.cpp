@@ -0,0 +1,232 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+  \file terralib/unittest/sa/TsPermutationTest.cpp
+
+  \brief A test suit for the PermutationTest engine.
+
+  The permutations of the Moran and LISA tests must only depend on the
+  seed: the results must be the same for any number of threads.
+ */
+
+// TerraLib
+#include <terralib/sa/core/PermutationTest.h>
+#include <terralib/sa/core/SpatialWeightsMatrix.h>
+#include "Config.h"
+
+// STL
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+// Boost
+#include <boost/test/unit_test.hpp>
+
+namespace
+{
+  /*!
+    \brief The values of a grid of 20x20 vertices and their Moran indexes.
+
+    The grid has 400 vertices and the tests use 99 permutations, so that
+    neither is a multiple of the block size of the engine.
+   */
+  struct GridFixture
+  {
+    static const std::size_t sm_side = 20;
+    static const int sm_permutationsNumber = 99;
+
+    te::sa::SpatialWeightsMatrix m_swm;
+    std::vector<double> m_values;
+    std::vector<double> m_z;
+    std::vector<double> m_lisa;
+    double m_mean;
+    double m_variance;
+    double m_moranIndex;
+
+    GridFixture()
+      : m_mean(0.),
+        m_variance(0.),
+        m_moranIndex(0.)
+    {
+      const std::size_t n = sm_side * sm_side;
+
+// the row standardized rook contiguity weights
+      std::vector<std::size_t> offsets(1, 0);
+      std::vector<std::size_t> neighbours;
+      std::vector<double> weights;
+
+      for(std::size_t r = 0; r < sm_side; ++r)
+      {
+        for(std::size_t c = 0; c < sm_side; ++c)
+        {
+          std::size_t first = neighbours.size();
+
+          if(r > 0)
+            neighbours.push_back((r - 1) * sm_side + c);
+
+          if(r + 1 < sm_side)
+            neighbours.push_back((r + 1) * sm_side + c);
+
+          if(c > 0)
+            neighbours.push_back(r * sm_side + c - 1);
+
+          if(c + 1 < sm_side)
+            neighbours.push_back(r * sm_side + c + 1);
+
+          std::size_t nNeighbours = neighbours.size() - first;
+
+          weights.insert(weights.end(), nNeighbours, 1.0 / static_cast<double>(nNeighbours));
+
+          offsets.push_back(neighbours.size());
+        }
+      }
+
+      m_swm.build(offsets, neighbours, weights);
+
+// a smooth surface with a small deterministic noise: it has a strong positive autocorrelation
+      m_values.resize(n);
+
+      for(std::size_t i = 0; i < n; ++i)
+        m_values[i] = std::sin(static_cast<double>(i / sm_side) * 0.3) + std::cos(static_cast<double>(i % sm_side) * 0.3) + 0.1 * std::sin(static_cast<double>(i) * 7.7);
+
+      for(std::size_t i = 0; i < n; ++i)
+        m_mean += m_values[i];
+
+      m_mean /= static_cast<double>(n);
+
+      m_z.resize(n);
+
+      for(std::size_t i = 0; i < n; ++i)
+      {
+        m_z[i] = m_values[i] - m_mean;
+        m_variance += m_z[i] * m_z[i];
+      }
+
+      m_variance /= static_cast<double>(n);
+
+      m_lisa.resize(n);
+
+      for(std::size_t i = 0; i < n; ++i)
+      {
+        double wz = 0.;
+
+        for(std::size_t k = offsets[i]; k < offsets[i + 1]; ++k)
+          wz += weights[k] * m_z[neighbours[k]];
+
+        m_lisa[i] = m_z[i] * wz / m_variance;
+
+        m_moranIndex += m_z[i] * wz;
+      }
+
+      m_moranIndex /= m_variance * static_cast<double>(n - 1);
+    }
+
+    void globalMoran(boost::uint32_t seed, unsigned int maxThreads, std::vector<double>& results) const
+    {
+      te::sa::PermutationTest test(m_swm, seed, maxThreads);
+
+      BOOST_REQUIRE(test.globalMoran(m_values, m_mean, m_variance, sm_permutationsNumber, results));
+    }
+
+    void lisaSignificance(boost::uint32_t seed, unsigned int maxThreads, std::vector<double>& significance) const
+    {
+      te::sa::PermutationTest test(m_swm, seed, maxThreads);
+
+      BOOST_REQUIRE(test.lisaSignificance(m_z, m_variance, m_lisa, sm_permutationsNumber, significance));
+    }
+  };
+}
+
+BOOST_FIXTURE_TEST_SUITE( permutation_test_tests, GridFixture )
+
+BOOST_AUTO_TEST_CASE( global_moran_test )
+{
+  std::vector<double> results;
+  globalMoran(te::sa::PermutationTest::sm_defaultSeed, 1, results);
+
+  BOOST_REQUIRE_EQUAL(results.size(), static_cast<std::size_t>(sm_permutationsNumber));
+
+// the surface is smooth: no permutation may have an index as large as the observed one
+  BOOST_CHECK_GT(m_moranIndex, 0.5);
+
+  for(std::size_t i = 0; i < results.size(); ++i)
+    BOOST_CHECK_LT(results[i], m_moranIndex);
+
+  BOOST_CHECK_CLOSE(te::sa::PermutationTest::GetGlobalSignificance(m_moranIndex, results), 1. / (sm_permutationsNumber + 1), 1e-9);
+}
+
+BOOST_AUTO_TEST_CASE( seed_test )
+{
+  std::vector<double> first;
+  std::vector<double> second;
+  std::vector<double> other;
+
+  globalMoran(te::sa::PermutationTest::sm_defaultSeed, 1, first);
+  globalMoran(te::sa::PermutationTest::sm_defaultSeed, 1, second);
+  globalMoran(te::sa::PermutationTest::sm_defaultSeed + 1, 1, other);
+
+  BOOST_CHECK(first == second);
+  BOOST_CHECK(first != other);
+
+  std::vector<double> firstLisa;
+  std::vector<double> secondLisa;
+  std::vector<double> otherLisa;
+
+  lisaSignificance(te::sa::PermutationTest::sm_defaultSeed, 1, firstLisa);
+  lisaSignificance(te::sa::PermutationTest::sm_defaultSeed, 1, secondLisa);
+  lisaSignificance(te::sa::PermutationTest::sm_defaultSeed + 1, 1, otherLisa);
+
+  BOOST_CHECK(firstLisa == secondLisa);
+  BOOST_CHECK(firstLisa != otherLisa);
+}
+
+BOOST_AUTO_TEST_CASE( threads_test )
+{
+  std::vector<double> serial;
+  std::vector<double> serialLisa;
+
+  globalMoran(te::sa::PermutationTest::sm_defaultSeed, 1, serial);
+  lisaSignificance(te::sa::PermutationTest::sm_defaultSeed, 1, serialLisa);
+
+  BOOST_REQUIRE_EQUAL(serialLisa.size(), m_values.size());
+
+  for(std::size_t i = 0; i < serialLisa.size(); ++i)
+  {
+    BOOST_CHECK_GE(serialLisa[i], 0.);
+    BOOST_CHECK_LE(serialLisa[i], 1.);
+  }
+
+// the results must be bitwise identical, whatever the number of threads
+  const unsigned int threads[] = { 2, 3, 4, 8, 0 };
+
+  for(std::size_t t = 0; t < sizeof(threads) / sizeof(threads[0]); ++t)
+  {
+    std::vector<double> parallel;
+    std::vector<double> parallelLisa;
+
+    globalMoran(te::sa::PermutationTest::sm_defaultSeed, threads[t], parallel);
+    lisaSignificance(te::sa::PermutationTest::sm_defaultSeed, threads[t], parallelLisa);
+
+    BOOST_CHECK_EQUAL_COLLECTIONS(parallel.begin(), parallel.end(), serial.begin(), serial.end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(parallelLisa.begin(), parallelLisa.end(), serialLisa.begin(), serialLisa.end());
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
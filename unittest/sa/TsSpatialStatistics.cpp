@@ -0,0 +1,230 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+  \file terralib/unittest/sa/TsSpatialStatistics.cpp
+
+  \brief A test suit for the spatial statistics functions of a gpm.
+
+  The gpm is a path of four vertices, 0-1-2-3, with the values 1, 3, 2 and 6
+  and the weights normalized by the number of neighbours. The expected
+  results were computed by hand with the formulas of the gpm functions:
+
+  - mean = 3, Z = (-2, 0, -1, 3) and the variance of Z is 14 / 4 = 3.5;
+  - WZ = (0, (-2 - 1) / 2, (0 + 3) / 2, -1) = (0, -1.5, 1.5, -1);
+  - the local Moran of a vertex is Z * WZ / 3.5 and the Moran index is their mean.
+ */
+
+// TerraLib
+#include <terralib/common/Exception.h>
+#include <terralib/datatype/Enums.h>
+#include <terralib/datatype/SimpleData.h>
+#include <terralib/graph/Globals.h>
+#include <terralib/graph/core/AbstractGraph.h>
+#include <terralib/graph/core/AbstractGraphFactory.h>
+#include <terralib/graph/core/Edge.h>
+#include <terralib/graph/core/Vertex.h>
+#include <terralib/sa/Config.h>
+#include <terralib/sa/core/GeneralizedProximityMatrix.h>
+#include <terralib/sa/core/SpatialStatisticsFunctions.h>
+#include <terralib/sa/core/Utils.h>
+#include "Config.h"
+
+// STL
+#include <cstddef>
+#include <map>
+#include <string>
+
+// Boost
+#include <boost/test/unit_test.hpp>
+
+namespace
+{
+  /*! \brief A gpm with the path of four vertices. */
+  struct PathFixture
+  {
+    static const int sm_nVertices = 4;
+
+    te::sa::GeneralizedProximityMatrix m_gpm;
+    int m_attrIdx;
+
+    PathFixture()
+      : m_attrIdx(0)
+    {
+      std::map<std::string, std::string> graphInfo;
+      graphInfo["GRAPH_DATA_SOURCE_TYPE"] = "MEM";
+      graphInfo["GRAPH_NAME"] = "path_graph";
+      graphInfo["GRAPH_DESCRIPTION"] = "Spatial statistics unit test.";
+
+      m_gpm.setGraph(te::graph::AbstractGraphFactory::make(te::graph::Globals::sm_factoryGraphTypeDirectedGraph, "memory:", graphInfo));
+
+      te::graph::AbstractGraph* graph = m_gpm.getGraph();
+
+      m_attrIdx = te::sa::AddGraphVertexAttribute(graph, "value", te::dt::DOUBLE_TYPE);
+
+      int weightIdx = te::sa::AddGraphEdgeAttribute(graph, TE_SA_WEIGHT_ATTR_NAME, te::dt::DOUBLE_TYPE);
+
+      const double values[sm_nVertices] = { 1., 3., 2., 6. };
+
+      for(int i = 0; i < sm_nVertices; ++i)
+      {
+        te::graph::Vertex* v = new te::graph::Vertex(i);
+        v->setAttributeVecSize(1);
+        v->addAttribute(m_attrIdx, new te::dt::SimpleData<double, te::dt::DOUBLE_TYPE>(values[i]));
+
+        graph->add(v);
+      }
+
+// one edge in each direction, as the gpm constructors do
+      int edgeId = 0;
+
+      for(int i = 0; i < sm_nVertices; ++i)
+      {
+        int nNeighbours = ((i > 0) ? 1 : 0) + ((i < sm_nVertices - 1) ? 1 : 0);
+
+        for(int j = i - 1; j <= i + 1; j += 2)
+        {
+          if(j < 0 || j >= sm_nVertices)
+            continue;
+
+          te::graph::Edge* e = new te::graph::Edge(edgeId++, i, j);
+          e->setAttributeVecSize(1);
+          e->addAttribute(weightIdx, new te::dt::SimpleData<double, te::dt::DOUBLE_TYPE>(1. / nNeighbours));
+
+          graph->add(e);
+        }
+      }
+    }
+
+    /*! \brief It returns the value of a vertex attribute, searched by its name. */
+    double getValue(const std::string& attrName, int id)
+    {
+      te::graph::AbstractGraph* graph = m_gpm.getGraph();
+
+      int attrIdx = 0;
+      BOOST_REQUIRE(te::sa::GetGraphVertexAttrIndex(graph, attrName, attrIdx));
+
+      te::graph::Vertex* v = graph->getVertex(id);
+      BOOST_REQUIRE(v);
+      BOOST_REQUIRE(v->getAttributes()[attrIdx]);
+
+      return te::sa::GetDataValue(v->getAttributes()[attrIdx]);
+    }
+  };
+
+  const double sg_tolerance = 1.0e-10;
+}
+
+BOOST_FIXTURE_TEST_SUITE(spatial_statistics_tests, PathFixture)
+
+BOOST_AUTO_TEST_CASE(z_and_wz_test)
+{
+  te::sa::ZAndWZ(&m_gpm, m_attrIdx);
+
+  const double z[sm_nVertices] = { -2., 0., -1., 3. };
+  const double wz[sm_nVertices] = { 0., -1.5, 1.5, -1. };
+
+  for(int i = 0; i < sm_nVertices; ++i)
+  {
+    BOOST_CHECK_SMALL(getValue(TE_SA_STDDEVZ_ATTR_NAME, i) - z[i], sg_tolerance);
+    BOOST_CHECK_SMALL(getValue(TE_SA_LOCALMEANWZ_ATTR_NAME, i) - wz[i], sg_tolerance);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(moran_index_test)
+{
+  te::sa::ZAndWZ(&m_gpm, m_attrIdx);
+
+  double moranIndex = te::sa::MoranIndex(&m_gpm);
+
+// the sum of Z * WZ is -1.5 - 3
+  BOOST_CHECK_SMALL(moranIndex - (-4.5 / 3.5 / 4.), sg_tolerance);
+
+  const double lisa[sm_nVertices] = { 0., 0., -1.5 / 3.5, -3. / 3.5 };
+
+  for(int i = 0; i < sm_nVertices; ++i)
+    BOOST_CHECK_SMALL(getValue(TE_SA_MORANINDEX_ATTR_NAME, i) - lisa[i], sg_tolerance);
+
+// the number of neighbours is calculated before the significance, as in the spatial statistics dialog
+  te::sa::LocalMean(&m_gpm, m_attrIdx);
+  te::sa::LisaStatisticalSignificance(&m_gpm, 99);
+
+  for(int i = 0; i < sm_nVertices; ++i)
+  {
+    double significance = getValue(TE_SA_LISASIGNIFICANCE_ATTR_NAME, i);
+
+    BOOST_CHECK_GE(significance, 0.);
+    BOOST_CHECK_LE(significance, 1.);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(global_moran_test)
+{
+// the weighted deviation products are 0, 0, -1.5 and -3, divided by the variance times n - 1
+  double moranIndex = te::sa::MoranIndex(&m_gpm, 3., 3.5, m_attrIdx);
+
+  BOOST_CHECK_SMALL(moranIndex - (-4.5 / (3.5 * 3.)), sg_tolerance);
+
+  double significance = te::sa::GlobalMoranSignificance(&m_gpm, m_attrIdx, 99, moranIndex);
+
+  BOOST_CHECK_GE(significance, 0.);
+  BOOST_CHECK_LE(significance, 1.);
+}
+
+BOOST_AUTO_TEST_CASE(g_statistics_test)
+{
+  te::sa::GStatistics(&m_gpm, m_attrIdx);
+
+// G: the mean of the neighbours over the sum of the other values (the total is 12)
+  const double g[sm_nVertices] = { 3. / 11., 1.5 / 9., 4.5 / 10., 2. / 6. };
+
+// G*: the mean of the vertex and its neighbours over the total
+  const double gStar[sm_nVertices] = { 2. / 12., 2. / 12., (11. / 3.) / 12., 4. / 12. };
+
+  for(int i = 0; i < sm_nVertices; ++i)
+  {
+    BOOST_CHECK_SMALL(getValue(TE_SA_G_ATTR_NAME, i) - g[i], sg_tolerance);
+    BOOST_CHECK_SMALL(getValue(TE_SA_GSTAR_ATTR_NAME, i) - gStar[i], sg_tolerance);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(local_mean_test)
+{
+  te::sa::LocalMean(&m_gpm, m_attrIdx);
+
+  const double localMean[sm_nVertices] = { 3., 1.5, 4.5, 2. };
+  const double nNeighbours[sm_nVertices] = { 1., 2., 2., 1. };
+
+  for(int i = 0; i < sm_nVertices; ++i)
+  {
+    BOOST_CHECK_SMALL(getValue(TE_SA_LOCALMEAN_ATTR_NAME, i) - localMean[i], sg_tolerance);
+    BOOST_CHECK_EQUAL(getValue(TE_SA_NUMNEIGHBORS_ATTR_NAME, i), nNeighbours[i]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(missing_attribute_test)
+{
+  m_gpm.getGraph()->getVertex(2)->addAttribute(m_attrIdx, 0);
+
+  BOOST_CHECK_THROW(te::sa::GStatistics(&m_gpm, m_attrIdx), te::common::Exception);
+  BOOST_CHECK_THROW(te::sa::LocalMean(&m_gpm, m_attrIdx), te::common::Exception);
+  BOOST_CHECK_THROW(te::sa::ZAndWZ(&m_gpm, m_attrIdx), te::common::Exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -650,3 +650,132 @@ void TsRTree::tcRTreeBox_2()
 
 //#endif
 }
+
+void TsRTree::tcRTreeBulkLoad()
+{
+  std::vector<te::sam::rtree::Index<int, 4>::ItemType> items;
+  te::sam::rtree::Index<int, 4> incrementalTree;
+  te::sam::rtree::Index<int, 4> bulkTree;
+
+// a grid of unitary boxes
+  int k = 0;
+
+  for(int i = 0; i < 50; ++i)
+  {
+    for(int j = 0; j < 50; ++j)
+    {
+      te::gm::Envelope box(i, j, i + 1.0, j + 1.0);
+      incrementalTree.insert(box, k);
+      items.push_back(te::sam::rtree::Index<int, 4>::ItemType(box, k));
+      ++k;
+    }
+  }
+
+  bulkTree.bulkLoad(items);
+
+  CPPUNIT_ASSERT(bulkTree.getMBR().equals(incrementalTree.getMBR()));
+  CPPUNIT_ASSERT(bulkTree.size() <= incrementalTree.size());
+
+  for(int i = 0; i < 50; i += 7)
+  {
+    te::gm::Envelope box(i + 0.5, i + 0.5, i + 3.2, i + 10.5);
+
+    std::vector<int> report1;
+    std::vector<int> report2;
+
+    incrementalTree.search(box, report1);
+    bulkTree.search(box, report2);
+
+    std::sort(report1.begin(), report1.end());
+    std::sort(report2.begin(), report2.end());
+
+    CPPUNIT_ASSERT(report1 == report2);
+  }
+
+// the tree must remain updatable after a bulk load
+  te::gm::Envelope box(0, 0, 1, 1);
+  CPPUNIT_ASSERT(bulkTree.remove(box, 0));
+
+  std::vector<int> report;
+  CPPUNIT_ASSERT(bulkTree.search(te::gm::Envelope(0.2, 0.2, 0.8, 0.8), report) == 0);
+
+  bulkTree.insert(box, 0);
+  CPPUNIT_ASSERT(bulkTree.search(te::gm::Envelope(0.2, 0.2, 0.8, 0.8), report) == 1);
+
+// an empty bulk load must leave an empty tree
+  items.clear();
+  bulkTree.bulkLoad(items);
+  CPPUNIT_ASSERT(bulkTree.isEmpty());
+}
+
+namespace
+{
+  /*! \brief Distance between the center of a unitary grid cell and a query point. */
+  struct CellCenterDistance
+  {
+    double m_x;
+    double m_y;
+
+    double operator()(const int& id) const
+    {
+      double dx = (id / 20) + 0.5 - m_x;
+      double dy = (id % 20) + 0.5 - m_y;
+
+      return std::sqrt(dx * dx + dy * dy);
+    }
+  };
+}
+
+void TsRTree::tcRTreeNearestNeighbor()
+{
+  te::sam::rtree::Index<int, 4> rtree;
+
+// a gride of unitary boxes: id = 20 * column + row
+  for(int i = 0; i < 20; ++i)
+    for(int j = 0; j < 20; ++j)
+      rtree.insert(te::gm::Envelope(i, j, i + 1.0, j + 1.0), 20 * i + j);
+
+  std::vector<int> report;
+  std::vector<double> distances;
+
+// the query point is inside the box 5 x 5 and touches no other box
+  te::gm::Envelope query(5.4, 5.3, 5.4, 5.3);
+
+  CPPUNIT_ASSERT(rtree.nearestNeighborSearch(query, 1, report, distances) == 1);
+  CPPUNIT_ASSERT(report[0] == 105);
+  CPPUNIT_ASSERT(distances[0] == 0.0);
+
+// using the distance to the boxes centers: the nearest ones are (5,5), (5,4), (4,5) and (6,5)
+  CellCenterDistance exactDistance;
+  exactDistance.m_x = 5.4;
+  exactDistance.m_y = 5.3;
+
+  report.clear();
+  distances.clear();
+
+  CPPUNIT_ASSERT(rtree.nearestNeighborSearch(query, 4, report, distances, exactDistance) == 4);
+  CPPUNIT_ASSERT(report[0] == 105);
+  CPPUNIT_ASSERT(report[1] == 104);
+  CPPUNIT_ASSERT(report[2] == 85);
+  CPPUNIT_ASSERT(report[3] == 125);
+
+  for(std::size_t i = 1; i < distances.size(); ++i)
+    CPPUNIT_ASSERT(distances[i - 1] <= distances[i]);
+
+// all boxes centers within distance 1.5
+  report.clear();
+  distances.clear();
+
+  rtree.withinDistanceSearch(query, 1.5, report, distances, exactDistance);
+
+  std::size_t expected = 0;
+
+  for(int id = 0; id < 400; ++id)
+    if(exactDistance(id) <= 1.5)
+      ++expected;
+
+  CPPUNIT_ASSERT(report.size() == expected);
+
+  for(std::size_t i = 0; i < report.size(); ++i)
+    CPPUNIT_ASSERT(distances[i] == exactDistance(report[i]));
+}
@@ -27,6 +27,8 @@
 #define __TERRALIB_UNITTEST_SAM_INTERNAL_RTREE_H
 
 // STL
+#include <algorithm>
+#include <cmath>
 #include <string>
 #include <vector>
 
@@ -73,6 +75,8 @@ class TsRTree : public CPPUNIT_NS::TestFixture
   CPPUNIT_TEST( tcRTreeBox_4 );
   CPPUNIT_TEST( tcRTreeBox_3 );
   CPPUNIT_TEST( tcRTreeBox_2 );
+  CPPUNIT_TEST( tcRTreeBulkLoad );
+  CPPUNIT_TEST( tcRTreeNearestNeighbor );
  
   CPPUNIT_TEST_SUITE_END();    
   
@@ -104,6 +108,10 @@ class TsRTree : public CPPUNIT_NS::TestFixture
     void tcRTreeBox_3();
    /*! \brief Test Case: Constructs an RTree (MAXNODE = 2) inserting the defined rectangles and search the RTree. */
     void tcRTreeBox_2();
+   /*! \brief Test Case: Constructs an RTree using bulk load and compares its search results with an incrementally built one. */
+    void tcRTreeBulkLoad();
+   /*! \brief Test Case: Runs k-nearest neighbour and distance queries on a gride of points. */
+    void tcRTreeNearestNeighbor();
 
 // Boxes to be inserted in a RTree in the last 3 test cases
     te::gm::Envelope* r15;  // new te::gm::Envelope(1.0,1.0, 2.5,2.5);
@@ -24,9 +24,41 @@
 
  */
 
+// TerraLib
+#include <terralib/srs/Converter.h>
+
+// STL
+#include <cstddef>
+#include <string>
+#include <vector>
+
 // Boost
 #include <boost/test/unit_test.hpp>
 
+namespace
+{
+  const std::string sg_geographic("+proj=longlat +ellps=WGS84 +datum=WGS84 +no_defs");
+  const std::string sg_utm("+proj=utm +zone=23 +south +ellps=WGS84 +datum=WGS84 +units=m +no_defs");
+  const std::string sg_utmKm("+proj=utm +zone=23 +south +ellps=WGS84 +datum=WGS84 +units=km +no_defs");
+
+  const std::size_t sg_nCoords = 5;
+
+  /*! \brief It returns the coordinates x0, y0, x1, y1, ... of some geographic points in the UTM zone 23 south. */
+  std::vector<double> GetGeographicCoords()
+  {
+    const double lonLat[] = { -45.0, -23.0, -45.5, -22.7, -44.2, -23.9, -46.1, -21.3, -43.8, -24.4 };
+
+    return std::vector<double>(lonLat, lonLat + 2 * sg_nCoords);
+  }
+
+  /*! \brief It creates a converter between two PROJ4 descriptions. */
+  void SetUp(te::srs::Converter& converter, const std::string& source, const std::string& target)
+  {
+    converter.setSourcePJ4txt(source);
+    converter.setTargetPJ4txt(target);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE( srs_tests )
 
 BOOST_AUTO_TEST_CASE( createSrs_test )
@@ -34,4 +66,126 @@ BOOST_AUTO_TEST_CASE( createSrs_test )
   /* Create tests here */
 }
 
+BOOST_AUTO_TEST_CASE( convert_interleaved_coords_test )
+{
+  te::srs::Converter converter;
+  SetUp(converter, sg_geographic, sg_utm);
+
+  BOOST_CHECK(!converter.isIdentity());
+  BOOST_CHECK(!converter.isAffine());
+
+  std::vector<double> xy = GetGeographicCoords();
+  std::vector<double> out(2 * sg_nCoords, 0.0);
+
+// the coordinates must be read and written with the offset
+  BOOST_REQUIRE(converter.convert(&xy[0], &xy[1], &out[0], &out[1], static_cast<long>(sg_nCoords), 2));
+
+  std::vector<double> inPlace = GetGeographicCoords();
+
+  BOOST_REQUIRE(converter.convert(&inPlace[0], &inPlace[1], static_cast<long>(sg_nCoords), 2));
+
+  for(std::size_t i = 0; i < sg_nCoords; ++i)
+  {
+    double x, y;
+    BOOST_REQUIRE(converter.convert(xy[2 * i], xy[2 * i + 1], x, y));
+
+    BOOST_CHECK_CLOSE(out[2 * i], x, 1e-9);
+    BOOST_CHECK_CLOSE(out[2 * i + 1], y, 1e-9);
+    BOOST_CHECK_CLOSE(inPlace[2 * i], x, 1e-9);
+    BOOST_CHECK_CLOSE(inPlace[2 * i + 1], y, 1e-9);
+  }
+
+// the input must not be changed
+  BOOST_CHECK(xy == GetGeographicCoords());
+}
+
+BOOST_AUTO_TEST_CASE( invert_interleaved_coords_test )
+{
+  te::srs::Converter converter;
+  SetUp(converter, sg_geographic, sg_utm);
+
+  const std::vector<double> lonLat = GetGeographicCoords();
+
+  std::vector<double> xy(2 * sg_nCoords);
+
+  for(std::size_t i = 0; i < sg_nCoords; ++i)
+    BOOST_REQUIRE(converter.convert(lonLat[2 * i], lonLat[2 * i + 1], xy[2 * i], xy[2 * i + 1]));
+
+  std::vector<double> in(xy);
+  std::vector<double> out(2 * sg_nCoords, 0.0);
+
+// the copy must be read and written with the offset
+  BOOST_REQUIRE(converter.invert(&in[0], &in[1], &out[0], &out[1], static_cast<long>(sg_nCoords), 2));
+
+  BOOST_CHECK(in == xy);
+
+// the y values must be converted from radians at their offset, not at their index
+  std::vector<double> inPlace(xy);
+
+  BOOST_REQUIRE(converter.invert(&inPlace[0], &inPlace[1], static_cast<long>(sg_nCoords), 2));
+
+  for(std::size_t i = 0; i < 2 * sg_nCoords; ++i)
+  {
+    BOOST_CHECK_CLOSE(out[i], lonLat[i], 1e-7);
+    BOOST_CHECK_CLOSE(inPlace[i], lonLat[i], 1e-7);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( identity_conversion_test )
+{
+  te::srs::Converter converter;
+  SetUp(converter, sg_utm, sg_utm);
+
+  BOOST_CHECK(converter.isIdentity());
+
+  const std::vector<double> xy = GetGeographicCoords();
+
+  std::vector<double> out(2 * sg_nCoords, 0.0);
+
+  BOOST_REQUIRE(converter.convert(const_cast<double*>(&xy[0]), const_cast<double*>(&xy[1]), &out[0], &out[1], static_cast<long>(sg_nCoords), 2));
+  BOOST_CHECK(out == xy);
+
+  out.assign(2 * sg_nCoords, 0.0);
+
+  BOOST_REQUIRE(converter.invert(const_cast<double*>(&xy[0]), const_cast<double*>(&xy[1]), &out[0], &out[1], static_cast<long>(sg_nCoords), 2));
+  BOOST_CHECK(out == xy);
+}
+
+BOOST_AUTO_TEST_CASE( affine_conversion_test )
+{
+  te::srs::Converter converter;
+  SetUp(converter, sg_utm, sg_utmKm);
+
+  BOOST_CHECK(!converter.isIdentity());
+  BOOST_CHECK(converter.isAffine());
+
+  const double coords[] = { 320000.0, 7450000.0, 330500.0, 7461250.0, 290125.0, 7420500.0 };
+
+  std::vector<double> xy(coords, coords + 6);
+
+  BOOST_REQUIRE(converter.convert(&xy[0], &xy[1], 3, 2));
+
+  for(std::size_t i = 0; i < 6; ++i)
+    BOOST_CHECK_CLOSE(xy[i], coords[i] / 1000.0, 1e-12);
+
+  BOOST_REQUIRE(converter.invert(&xy[0], &xy[1], 3, 2));
+
+  for(std::size_t i = 0; i < 6; ++i)
+    BOOST_CHECK_CLOSE(xy[i], coords[i], 1e-12);
+
+// a different false easting and northing is only a translation
+  te::srs::Converter shifted;
+  SetUp(shifted, "+proj=tmerc +lat_0=0 +lon_0=-45 +k=0.9996 +x_0=500000 +y_0=10000000 +ellps=GRS80 +units=m +no_defs",
+                 "+proj=tmerc +lat_0=0 +lon_0=-45 +k=0.9996 +x_0=0 +y_0=0 +ellps=GRS80 +units=m +no_defs");
+
+  BOOST_CHECK(shifted.isAffine());
+
+  double x = 320000.0;
+  double y = 7450000.0;
+
+  BOOST_REQUIRE(shifted.convert(x, y));
+  BOOST_CHECK_CLOSE(x, 320000.0 - 500000.0, 1e-12);
+  BOOST_CHECK_CLOSE(y, 7450000.0 - 10000000.0, 1e-12);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,122 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+// Unit-Test TerraLib
+#include "TsCascadedUnion.h"
+
+// TerraLib
+#include <terralib/common/STLUtils.h>
+#include <terralib/geometry/Geometry.h>
+#include <terralib/geometry/WKTReader.h>
+#include <terralib/vp/CascadedUnion.h>
+
+// STL
+#include <memory>
+#include <sstream>
+#include <vector>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TsCascadedUnion);
+
+namespace
+{
+  te::gm::Geometry* Square(int x, int y)
+  {
+    std::ostringstream wkt;
+
+    wkt << "POLYGON((" << x << " " << y << "," << x + 1 << " " << y << "," << x + 1 << " " << y + 1 << ","
+        << x << " " << y + 1 << "," << x << " " << y << "))";
+
+    te::gm::Geometry* g = te::gm::WKTReader::read(wkt.str().c_str());
+    g->setSRID(4326);
+
+    return g;
+  }
+}
+
+void TsCascadedUnion::setUp()
+{
+}
+
+void TsCascadedUnion::tearDown()
+{
+}
+
+void TsCascadedUnion::tcGridOfSquares()
+{
+// the squares of a 20 x 20 grid, row by row in alternated directions
+  std::vector<te::gm::Geometry*> geoms;
+
+  for(int y = 0; y < 20; ++y)
+  {
+    for(int x = 0; x < 20; ++x)
+      geoms.push_back(Square((y % 2) ? 19 - x : x, y));
+  }
+
+  std::auto_ptr<te::gm::Geometry> expected(te::gm::WKTReader::read("POLYGON((0 0,20 0,20 20,0 20,0 0))"));
+  expected->setSRID(4326);
+
+  te::vp::CascadedUnion serialUnion(false, 1);
+  std::auto_ptr<te::gm::Geometry> serialResult(serialUnion.compute(geoms));
+
+  CPPUNIT_ASSERT(serialResult.get() != 0);
+  CPPUNIT_ASSERT(serialResult->getSRID() == 4326);
+  CPPUNIT_ASSERT(serialResult->equals(expected.get()));
+
+  te::vp::CascadedUnion parallelUnion(false, 4);
+  std::auto_ptr<te::gm::Geometry> parallelResult(parallelUnion.compute(geoms));
+
+  CPPUNIT_ASSERT(parallelResult.get() != 0);
+  CPPUNIT_ASSERT(parallelResult->equals(expected.get()));
+
+// the inputs are not changed
+  CPPUNIT_ASSERT(geoms.size() == 400);
+  CPPUNIT_ASSERT(geoms[0]->getNPoints() == 5);
+
+  te::common::FreeContents(geoms);
+}
+
+void TsCascadedUnion::tcSkipInvalid()
+{
+  std::vector<te::gm::Geometry*> geoms;
+
+  geoms.push_back(Square(0, 0));
+  geoms.push_back(te::gm::WKTReader::read("POLYGON((0 0,2 2,2 0,0 2,0 0))"));  // a bowtie
+  geoms.back()->setSRID(4326);
+  geoms.push_back(Square(1, 0));
+
+  std::auto_ptr<te::gm::Geometry> expected(te::gm::WKTReader::read("POLYGON((0 0,2 0,2 1,0 1,0 0))"));
+  expected->setSRID(4326);
+
+  te::vp::CascadedUnion cascadedUnion(true, 2);
+  std::auto_ptr<te::gm::Geometry> result(cascadedUnion.compute(geoms));
+
+  CPPUNIT_ASSERT(result.get() != 0);
+  CPPUNIT_ASSERT(result->equals(expected.get()));
+
+  te::common::FreeContents(geoms);
+}
+
+void TsCascadedUnion::tcEmpty()
+{
+  std::vector<te::gm::Geometry*> geoms;
+
+  te::vp::CascadedUnion cascadedUnion;
+
+  CPPUNIT_ASSERT(cascadedUnion.compute(geoms) == 0);
+}
@@ -0,0 +1,78 @@
+/*  Copyright (C) 2008 National Institute For Space Research (INPE) - Brazil.
+
+    This file is part of the TerraLib - a Framework for building GIS enabled applications.
+
+    TerraLib is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License,
+    or (at your option) any later version.
+
+    TerraLib is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with TerraLib. See COPYING. If not, write to
+    TerraLib Team at <terralib-team@terralib.org>.
+ */
+
+/*!
+  \file TsCascadedUnion.h
+
+  \brief Test suite for the CascadedUnion class.
+ */
+
+#ifndef __TERRALIB_UNITTEST_VP_INTERNAL_CASCADEDUNION_H
+#define __TERRALIB_UNITTEST_VP_INTERNAL_CASCADEDUNION_H
+
+// cppUnit
+#include <cppunit/extensions/HelperMacros.h>
+
+/*!
+  \class TsCascadedUnion
+
+  \brief Test suite for the CascadedUnion class.
+
+  This test suite will check the following:
+  <ul>
+  <li>The union of many neighbour geometries, with one and many threads;</li>
+  <li>The invalid geometries that are skipped;</li>
+  <li>The union of an empty set of geometries.</li>
+  </ul>
+ */
+class TsCascadedUnion : public CPPUNIT_NS::TestFixture
+{
+// It registers this class as a Test Suit
+  CPPUNIT_TEST_SUITE(TsCascadedUnion);
+
+// It registers the class methods as Test Cases belonging to the suit 
+  CPPUNIT_TEST(tcGridOfSquares);
+  CPPUNIT_TEST(tcSkipInvalid);
+  CPPUNIT_TEST(tcEmpty);
+
+  CPPUNIT_TEST_SUITE_END();
+  
+  public:
+
+// It sets up context before running the test.
+    void setUp();
+
+// It cleann up after the test run.
+    void tearDown();
+
+  protected:
+
+// Test Cases:
+
+    /*! \brief Test Case: The union of a grid of adjacent squares, given out of order, is a single square. */
+    void tcGridOfSquares();
+
+    /*! \brief Test Case: The invalid geometries are not included in the union. */
+    void tcSkipInvalid();
+
+    /*! \brief Test Case: The union of an empty set of geometries is null. */
+    void tcEmpty();
+};
+
+#endif  // __TERRALIB_UNITTEST_VP_INTERNAL_CASCADEDUNION_H
@@ -25,14 +25,198 @@
 #include <terralib/dataaccess/datasource/DataSourceInfo.h>
 #include <terralib/dataaccess/datasource/DataSourceManager.h>
 
+#include <terralib/dataaccess/dataset/DataSetTypeConverter.h>
+#include <terralib/dataaccess/utils/Utils.h>
+#include <terralib/memory/DataSet.h>
+#include <terralib/memory/DataSetItem.h>
+#include <terralib/vp/IntersectionMemory.h>
 #include <terralib/vp/Utils.h>
 
+// STL
+#include <algorithm>
+#include <memory>
+
 // BOOST
 #include <boost/uuid/random_generator.hpp>
 #include <boost/uuid/uuid_io.hpp>
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TsIntersection);
 
+namespace
+{
+  /*! \brief A feature of the intersection result. */
+  struct IntersectionResult
+  {
+    std::string m_ids;                          //!< The ids of the intersected features.
+    std::shared_ptr<te::gm::Geometry> m_geom;   //!< The intersection.
+
+    bool operator<(const IntersectionResult& rhs) const
+    {
+      return m_ids < rhs.m_ids;
+    }
+  };
+
+  void RemoveShapefile(const std::string& name)
+  {
+    std::remove((name + ".dbf").c_str());
+    std::remove((name + ".prj").c_str());
+    std::remove((name + ".shp").c_str());
+    std::remove((name + ".shx").c_str());
+  }
+
+  te::gm::Geometry* CreateBox(double llx, double lly, double urx, double ury)
+  {
+    te::gm::Envelope e(llx, lly, urx, ury);
+
+    return te::gm::GetGeomFromEnvelope(&e, 4326);
+  }
+
+  void CreateShapefile(const std::string& name, const std::string& idName, const std::vector<int>& ids, const std::vector<te::gm::Geometry*>& geoms)
+  {
+    RemoveShapefile(name);
+
+    std::auto_ptr<te::da::DataSetType> dt(new te::da::DataSetType(name));
+    dt->add(new te::dt::SimpleProperty(idName, te::dt::INT32_TYPE, true));
+    dt->add(new te::gm::GeometryProperty("geom", 4326, te::gm::PolygonType, true));
+
+    std::auto_ptr<te::da::DataSetType> outDt(new te::da::DataSetType(*dt));
+
+    std::auto_ptr<te::mem::DataSet> ds(new te::mem::DataSet(dt.get()));
+
+    for(std::size_t i = 0; i < geoms.size(); ++i)
+    {
+      te::mem::DataSetItem* item = new te::mem::DataSetItem(ds.get());
+      item->setInt32(0, ids[i]);
+      item->setGeometry(1, geoms[i]);
+      ds->add(item);
+    }
+
+    std::unique_ptr<te::da::DataSource> dsOGR(te::da::DataSourceFactory::make("OGR", "file://" + name + ".shp"));
+    dsOGR->open();
+
+    ds->moveBeforeFirst();
+
+    te::da::Create(dsOGR.get(), outDt.get(), ds.get());
+
+    dsOGR->close();
+  }
+
+/*
+  The first input is a grid of 6 x 6 squares and a triangle over all of them.
+  The second input is a grid of 5 x 5 larger squares, shifted from the first
+  grid, and two strips that cross the whole extent. The tiles of the streaming
+  execution split most of these features, and some borders of the squares lie
+  on the borders of the tiles.
+*/
+  void CreateInputs()
+  {
+    std::vector<int> firstIds;
+    std::vector<te::gm::Geometry*> firstGeoms;
+
+    for(int j = 0; j < 6; ++j)
+    {
+      for(int i = 0; i < 6; ++i)
+      {
+        firstIds.push_back(j * 6 + i);
+        firstGeoms.push_back(CreateBox(i * 10.0, j * 10.0, (i + 1) * 10.0, (j + 1) * 10.0));
+      }
+    }
+
+    te::gm::LinearRing* ring = new te::gm::LinearRing(4, te::gm::LineStringType, 4326);
+    ring->setPoint(0, 0.0, 0.0);
+    ring->setPoint(1, 60.0, 5.0);
+    ring->setPoint(2, 5.0, 60.0);
+    ring->setPoint(3, 0.0, 0.0);
+
+    te::gm::Polygon* triangle = new te::gm::Polygon(0, te::gm::PolygonType, 4326);
+    triangle->push_back(ring);
+
+    firstIds.push_back(100);
+    firstGeoms.push_back(triangle);
+
+    CreateShapefile("first", "fid", firstIds, firstGeoms);
+
+    std::vector<int> secondIds;
+    std::vector<te::gm::Geometry*> secondGeoms;
+
+    for(int j = 0; j < 5; ++j)
+    {
+      for(int i = 0; i < 5; ++i)
+      {
+        secondIds.push_back(j * 5 + i);
+        secondGeoms.push_back(CreateBox(3.0 + i * 11.0, 3.0 + j * 11.0, 16.0 + i * 11.0, 16.0 + j * 11.0));
+      }
+    }
+
+    secondIds.push_back(100);
+    secondGeoms.push_back(CreateBox(0.0, 28.0, 60.0, 32.0));
+
+    secondIds.push_back(101);
+    secondGeoms.push_back(CreateBox(29.0, 0.0, 31.0, 60.0));
+
+    CreateShapefile("second", "sid", secondIds, secondGeoms);
+  }
+
+  void RunIntersection(const std::string& outName, std::size_t tileSize, unsigned int maxThreads)
+  {
+    RemoveShapefile(outName);
+
+    te::da::DataSourcePtr first(te::da::DataSourceFactory::make("OGR", "file://first.shp").release());
+    first->open();
+
+    te::da::DataSourcePtr second(te::da::DataSourceFactory::make("OGR", "file://second.shp").release());
+    second->open();
+
+    te::da::DataSourcePtr out(te::da::DataSourceFactory::make("OGR", "file://" + outName + ".shp").release());
+    out->open();
+
+    std::auto_ptr<te::da::DataSetType> firstType = first->getDataSetType("first");
+    std::auto_ptr<te::da::DataSetType> secondType = second->getDataSetType("second");
+
+    std::auto_ptr<te::da::DataSetTypeConverter> firstConverter(new te::da::DataSetTypeConverter(firstType.get(), out->getCapabilities(), out->getEncoding()));
+    std::auto_ptr<te::da::DataSetTypeConverter> secondConverter(new te::da::DataSetTypeConverter(secondType.get(), out->getCapabilities(), out->getEncoding()));
+
+    std::vector<std::pair<std::string, std::string> > attributes;
+    attributes.push_back(std::make_pair(std::string("first"), std::string("fid")));
+    attributes.push_back(std::make_pair(std::string("second"), std::string("sid")));
+
+    te::vp::IntersectionMemory intersection;
+    intersection.setInput(first, "first", firstType, first->getDataSet("first"), firstConverter,
+                          second, "second", secondType, second->getDataSet("second"), secondConverter);
+    intersection.setOutput(out, outName);
+    intersection.setParams(attributes);
+    intersection.setStreaming(tileSize);
+    intersection.setMaxThreads(maxThreads);
+
+    CPPUNIT_ASSERT(intersection.paramsAreValid());
+    CPPUNIT_ASSERT(intersection.run());
+
+    out->close();
+  }
+
+  std::vector<IntersectionResult> ReadResult(const std::string& outName)
+  {
+    te::da::DataSourcePtr out(te::da::DataSourceFactory::make("OGR", "file://" + outName + ".shp").release());
+    out->open();
+
+    std::auto_ptr<te::da::DataSet> ds = out->getDataSet(outName);
+    std::size_t geomPos = te::da::GetFirstSpatialPropertyPos(ds.get());
+
+    std::vector<IntersectionResult> result;
+
+    while(ds->moveNext())
+    {
+      IntersectionResult r;
+      r.m_ids = ds->getAsString("first_fid") + "/" + ds->getAsString("second_sid");
+      r.m_geom.reset(ds->getGeometry(geomPos).release());
+
+      result.push_back(r);
+    }
+
+    return result;
+  }
+}
+
 void TsIntersection::setUp()
 {
   m_params = new te::vp::AlgorithmParams();
@@ -377,4 +561,69 @@ void TsIntersection::tcIntersectionMemory1()
 //    te::vp::Intersection intersection;
 //    bool result = intersection.executeMemory(m_params, dSetTile[0]);
 //  }
-}
\ No newline at end of file
+}
+
+void TsIntersection::tcIntersectionMemoryStreaming()
+{
+  CreateInputs();
+
+  RunIntersection("ism", 0, 1);
+  std::vector<IntersectionResult> memory = ReadResult("ism");
+
+  CPPUNIT_ASSERT(!memory.empty());
+
+  std::sort(memory.begin(), memory.end());
+
+// a 4 x 4 grid, whose borders lie on some borders of the squares, and a 7 x 7 grid
+  const std::size_t tileSizes[] = { 4, 1 };
+
+  for(std::size_t t = 0; t < 2; ++t)
+  {
+    RunIntersection("iss", tileSizes[t], 1);
+    std::vector<IntersectionResult> streaming = ReadResult("iss");
+
+    std::sort(streaming.begin(), streaming.end());
+
+// each pair of features must be intersected once, even if it is found in many tiles
+    CPPUNIT_ASSERT_EQUAL(memory.size(), streaming.size());
+
+    for(std::size_t i = 0; i < memory.size(); ++i)
+    {
+      CPPUNIT_ASSERT_EQUAL(memory[i].m_ids, streaming[i].m_ids);
+      CPPUNIT_ASSERT_MESSAGE("Different intersection of " + memory[i].m_ids, memory[i].m_geom->equals(streaming[i].m_geom.get()));
+    }
+  }
+
+  RemoveShapefile("first");
+  RemoveShapefile("second");
+  RemoveShapefile("ism");
+  RemoveShapefile("iss");
+}
+
+void TsIntersection::tcIntersectionMemoryThreads()
+{
+  CreateInputs();
+
+  RunIntersection("im1", 0, 1);
+  std::vector<IntersectionResult> serial = ReadResult("im1");
+
+// more threads than features: each feature of both passes gets its own thread,
+// so the second input geometries are shared by as many threads as possible
+  RunIntersection("im64", 0, 64);
+  std::vector<IntersectionResult> parallel = ReadResult("im64");
+
+  CPPUNIT_ASSERT(!serial.empty());
+  CPPUNIT_ASSERT_EQUAL(serial.size(), parallel.size());
+
+// the results are not sorted: the order of the features must not depend on the threads
+  for(std::size_t i = 0; i < serial.size(); ++i)
+  {
+    CPPUNIT_ASSERT_EQUAL(serial[i].m_ids, parallel[i].m_ids);
+    CPPUNIT_ASSERT_EQUAL(serial[i].m_geom->toString(), parallel[i].m_geom->toString());
+  }
+
+  RemoveShapefile("first");
+  RemoveShapefile("second");
+  RemoveShapefile("im1");
+  RemoveShapefile("im64");
+}
@@ -65,6 +65,8 @@ class TsIntersection : public CPPUNIT_NS::TestFixture
   //CPPUNIT_TEST(tcIntersectionQuery1);
   //CPPUNIT_TEST(tcIntersectionQuery2);
   CPPUNIT_TEST(tcIntersectionMemory1);
+  CPPUNIT_TEST(tcIntersectionMemoryStreaming);
+  CPPUNIT_TEST(tcIntersectionMemoryThreads);
 
   CPPUNIT_TEST_SUITE_END();
   
@@ -89,6 +91,12 @@ class TsIntersection : public CPPUNIT_NS::TestFixture
     /*! \brief Test Case: Intersection memory with partitioning*/
     void tcIntersectionMemory1();
 
+    /*! \brief Test Case: the streaming intersection, tile by tile, must give the same result as the intersection in memory*/
+    void tcIntersectionMemoryStreaming();
+
+    /*! \brief Test Case: the intersection with many threads must give the same features, in the same order, as with one thread*/
+    void tcIntersectionMemoryThreads();
+
   private:
 
     std::vector<te::vp::InputParams> m_inputParams;